@@ -1,8 +1,19 @@
+#include <unistd.h>
+
 #include "CompactedDBG.hpp"
 #include "ColoredCDBG.hpp"
+#include "numa_policy.h"
 
 using namespace std;
 
+#ifdef BFG_KMER_SIZES
+
+// Maximum k-mer sizes (MAX_KMER_SIZE) of the Bifrost binaries built alongside this one, in increasing order
+static const size_t kmer_sizes[] = {BFG_KMER_SIZES};
+static const size_t nb_kmer_sizes = sizeof(kmer_sizes) / sizeof(size_t);
+
+#endif
+
 void PrintVersion() {
 
     cout << BFG_VERSION << endl;
@@ -20,7 +31,9 @@ void PrintUsage() {
 
     cout << "   build                   Build a compacted de Bruijn graph, with or without colors" << endl;
     cout << "   update                  Update a compacted (possible colored) de Bruijn graph with new sequences" << endl;
-    cout << "   query                   Query a compacted (possible colored) de Bruijn graph" << endl << endl;
+    cout << "   query                   Query a compacted (possible colored) de Bruijn graph" << endl;
+    cout << "   remove                  Remove the k-mers of sequences from a compacted (possible colored) de Bruijn graph" << endl;
+    cout << "   stats                   Print statistics of a compacted de Bruijn graph" << endl << endl;
 
     cout << "[PARAMETERS]: build" << endl << endl;
 
@@ -47,10 +60,13 @@ void PrintUsage() {
     cout << "   > Optional with no argument:" << endl << endl;
 
     cout << "   -c, --colors             Color the compacted de Bruijn graph (default is no coloring)" << endl;
+    cout << "   -M, --auto-min-length    Estimate the length of minimizers from a sample of the input files" << endl;
     cout << "   -y, --keep-mercy         Keep low coverage k-mers connecting tips" << endl;
     cout << "   -i, --clip-tips          Clip tips shorter than k k-mers in length" << endl;
     cout << "   -d, --del-isolated       Delete isolated contigs shorter than k k-mers in length" << endl;
+    cout << "   -P, --pop-bubbles        Pop bubbles created by sequencing errors, using coverage in the input sequence files" << endl;
     cout << "   -a, --fasta              Output file is in FASTA format (only sequences) instead of GFA" << endl;
+    cout << "   -N, --numa-interleave    Interleave memory over all NUMA nodes (multi-socket machines with 2+ threads)" << endl;
     cout << "   -v, --verbose            Print information messages during execution" << endl << endl;
 
     cout << "[PARAMETERS]: update" << endl << endl;
@@ -71,12 +87,15 @@ void PrintUsage() {
     cout << "   -f, --input-color-file   Input color file associated with the input graph file to update" << endl;
     cout << "   -t, --threads            Number of threads (default is 1)" << endl;
     cout << "   -k, --kmer-length        Length of k-mers (default is read from input graph file if built with Bifrost or 31)" << endl;
-    cout << "   -m, --min-length         Length of minimizers (default is read from input graph file if built with Bifrost or automatically chosen)" << endl << endl;
+    cout << "   -m, --min-length         Length of minimizers (default is read from input graph file if built with Bifrost or automatically chosen)" << endl;
+    cout << "   -b, --bloom-bits         Number of Bloom filter bits per k-mer with 1+ occurrences in the input sequence files (default is 14)" << endl << endl;
 
     cout << "   > Optional with no argument:" << endl << endl;
 
+    cout << "   -y, --keep-mercy         Keep low coverage k-mers connecting tips" << endl;
     cout << "   -i, --clip-tips          Clip tips shorter than k k-mers in length" << endl;
     cout << "   -d, --del-isolated       Delete isolated contigs shorter than k k-mers in length" << endl;
+    cout << "   -N, --numa-interleave    Interleave memory over all NUMA nodes (multi-socket machines with 2+ threads)" << endl;
     cout << "   -v, --verbose            Print information messages during execution" << endl << endl;
 
     cout << "[PARAMETERS]: query" << endl << endl;
@@ -100,6 +119,50 @@ void PrintUsage() {
     cout << "   > Optional with no argument:" << endl << endl;
 
     cout << "   -n, --inexact            Graph is searched with exact and inexact k-mers (1 substitution or indel) from queries" << endl;
+    cout << "   -S, --sparse-index       Use a sparse minimizer index: slower queries for an index about 25% smaller" << endl;
+    cout << "                            (the sampling is fixed, there is no density parameter)" << endl;
+    cout << "   -N, --numa-interleave    Interleave memory over all NUMA nodes (multi-socket machines with 2+ threads)" << endl;
+    cout << "   -v, --verbose            Print information messages during execution" << endl << endl;
+
+    cout << "[PARAMETERS]: remove" << endl << endl;
+
+    cout << "  > Mandatory with required argument:" << endl << endl;
+
+    cout << "   -g, --input-graph-file   Input graph file to remove k-mers from (GFA format)" << endl;
+    cout << "   -r, --input-ref-file     Input sequence file (FASTA/FASTQ possibly gzipped and GFA)" << endl;
+    cout << "                            Multiple files can be provided as a list in a TXT file (one file per line)" << endl;
+    cout << "                            All k-mers of the input files are removed from the graph" << endl;
+    cout << "   -o, --output-file        Prefix for output file(s)" << endl << endl;
+
+    cout << "   > Optional with required argument:" << endl << endl;
+
+    cout << "   -f, --input-color-file   Input color file associated with the input graph file" << endl;
+    cout << "   -t, --threads            Number of threads (default is 1)" << endl;
+    cout << "   -k, --kmer-length        Length of k-mers (default is read from input graph file if built with Bifrost or 31)" << endl;
+    cout << "   -m, --min-length         Length of minimizers (default is read from input graph file if built with Bifrost or automatically chosen)" << endl << endl;
+
+    cout << "   > Optional with no argument:" << endl << endl;
+
+    cout << "   -i, --clip-tips          Clip tips shorter than k k-mers in length" << endl;
+    cout << "   -d, --del-isolated       Delete isolated contigs shorter than k k-mers in length" << endl;
+    cout << "   -a, --fasta              Output file is in FASTA format (only sequences) instead of GFA" << endl;
+    cout << "   -N, --numa-interleave    Interleave memory over all NUMA nodes (multi-socket machines with 2+ threads)" << endl;
+    cout << "   -v, --verbose            Print information messages during execution" << endl << endl;
+
+    cout << "[PARAMETERS]: stats" << endl << endl;
+
+    cout << "  > Mandatory with required argument:" << endl << endl;
+
+    cout << "   -g, --input-graph-file   Input graph file (GFA format)" << endl << endl;
+
+    cout << "   > Optional with required argument:" << endl << endl;
+
+    cout << "   -t, --threads            Number of threads (default is 1)" << endl;
+    cout << "   -k, --kmer-length        Length of k-mers (default is read from input graph file if built with Bifrost or 31)" << endl;
+    cout << "   -m, --min-length         Length of minimizers (default is read from input graph file if built with Bifrost or automatically chosen)" << endl << endl;
+
+    cout << "   > Optional with no argument:" << endl << endl;
+
     cout << "   -v, --verbose            Print information messages during execution" << endl << endl;
 }
 
@@ -107,7 +170,7 @@ int parse_ProgramOptions(int argc, char **argv, CCDBG_Build_opt& opt) {
 
     int option_index = 0, c;
 
-    const char* opt_string = "s:r:q:g:f:o:t:k:m:e:b:B:l:w:nidvcya";
+    const char* opt_string = "s:r:q:g:f:o:t:k:m:e:b:B:l:w:MnSidPvcyaN";
 
     static struct option long_options[] = {
 
@@ -120,18 +183,22 @@ int parse_ProgramOptions(int argc, char **argv, CCDBG_Build_opt& opt) {
         {"threads",             required_argument,  0, 't'},
         {"kmer-length",         required_argument,  0, 'k'},
         {"min-length",          required_argument,  0, 'm'},
+        {"auto-min-length",     no_argument,        0, 'M'},
         {"ratio-kmers",         required_argument,  0, 'e'},
         {"bloom-bits",          required_argument,  0, 'b'},
         {"bloom-bits2",         required_argument,  0, 'B'},
         {"load-mbbf",           required_argument,  0, 'l'},
         {"write-mbbf",          required_argument,  0, 'w'},
         {"inexact_search",      no_argument,        0, 'n'},
+        {"sparse-index",        no_argument,        0, 'S'},
         {"clip-tips",           no_argument,        0, 'i'},
         {"del-isolated",        no_argument,        0, 'd'},
+        {"pop-bubbles",         no_argument,        0, 'P'},
         {"verbose",             no_argument,        0, 'v'},
         {"colors",              no_argument,        0, 'c'},
         {"keep-mercy",          no_argument,        0, 'y'},
         {"fasta",               no_argument,        0, 'a'},
+        {"numa-interleave",     no_argument,        0, 'N'},
         {0,                     0,                  0,  0 }
     };
 
@@ -141,8 +208,10 @@ int parse_ProgramOptions(int argc, char **argv, CCDBG_Build_opt& opt) {
     if (strcmp(argv[1], "build") == 0) opt.build = true;
     else if (strcmp(argv[1], "update") == 0) opt.update = true;
     else if (strcmp(argv[1], "query") == 0) opt.query = true;
+    else if (strcmp(argv[1], "stats") == 0) opt.stats = true;
+    else if (strcmp(argv[1], "remove") == 0) opt.remove = true;
 
-    if (opt.build || opt.update || opt.query){
+    if (opt.build || opt.update || opt.query || opt.stats || opt.remove){
 
         while ((c = getopt_long(argc, argv, opt_string, long_options, &option_index)) != -1) {
 
@@ -175,6 +244,9 @@ int parse_ProgramOptions(int argc, char **argv, CCDBG_Build_opt& opt) {
                 case 'm':
                     opt.g = atoi(optarg);
                     break;
+                case 'M':
+                    opt.auto_g = true;
+                    break;
                 case 'e':
                     opt.ratio_kmers = atof(optarg);
                     break;
@@ -193,12 +265,18 @@ int parse_ProgramOptions(int argc, char **argv, CCDBG_Build_opt& opt) {
                 case 'n':
                     opt.inexact_search = true;
                     break;
+                case 'S':
+                    opt.sparse_index = true;
+                    break;
                 case 'i':
                     opt.clipTips = true;
                     break;
                 case 'd':
                     opt.deleteIsolated = true;
                     break;
+                case 'P':
+                    opt.popBubbles = true;
+                    break;
                 case 'v':
                     opt.verbose = true;
                     break;
@@ -211,6 +289,9 @@ int parse_ProgramOptions(int argc, char **argv, CCDBG_Build_opt& opt) {
                 case 'a':
                     opt.outputGFA = false;
                     break;
+                case 'N':
+                    opt.numa_interleave = true;
+                    break;
                 default: break;
             }
         }
@@ -300,9 +381,9 @@ bool check_ProgramOptions(CCDBG_Build_opt& opt) {
 
     // Check general parameters
 
-    if (!opt.build && !opt.update && !opt.query){
+    if (!opt.build && !opt.update && !opt.query && !opt.stats && !opt.remove){
 
-        cerr << "Error: No command selected (can be 'build' or 'update' or 'query')." << endl;
+        cerr << "Error: No command selected (can be 'build' or 'update' or 'query' or 'stats' or 'remove')." << endl;
         ret = false;
     }
 
@@ -324,10 +405,16 @@ bool check_ProgramOptions(CCDBG_Build_opt& opt) {
         ret = false;
     }
 
+    // dispatch_KmerSize() already replaced this process by a wider binary if one fits k: validate against this binary's width
     if (opt.k >= MAX_KMER_SIZE){
 
+        #ifdef BFG_KMER_SIZES
+        cerr << "Error: Length k of k-mers cannot exceed " << (kmer_sizes[nb_kmer_sizes - 1] - 1) << "." << endl;
+        cerr << "To enable a larger k, recompile Bifrost with the appropriate MAX_KMER_SIZE or EXTRA_KMER_SIZES variable." << endl;
+        #else
         cerr << "Error: Length k of k-mers cannot exceed " << (MAX_KMER_SIZE - 1) << "." << endl;
         cerr << "To enable a larger k, recompile Bifrost with the appropriate MAX_KMER_SIZE variable." << endl;
+        #endif
         ret = false;
     }
 
@@ -343,6 +430,30 @@ bool check_ProgramOptions(CCDBG_Build_opt& opt) {
         ret = false;
     }
 
+    if (opt.auto_g && !opt.build){
+
+        cerr << "Error: Estimation of the length of minimizers (-M) can only be used with command build." << endl;
+        ret = false;
+    }
+
+    if (opt.popBubbles && !opt.build){
+
+        cerr << "Error: Popping bubbles (-P) can only be used with command build." << endl;
+        ret = false;
+    }
+
+    if (opt.popBubbles && opt.filename_seq_in.empty()){
+
+        cerr << "Error: Popping bubbles (-P) requires input sequence files (-s) to compute the coverage of bubbles." << endl;
+        ret = false;
+    }
+
+    if (opt.auto_g && (opt.g > 0)){
+
+        cerr << "Error: Length m of minimizers (-m) and its estimation (-M) cannot be used together." << endl;
+        ret = false;
+    }
+
     if (opt.query){  // Check param. command build
 
         if (opt.prefixFilenameOut.length() == 0) {
@@ -387,7 +498,7 @@ bool check_ProgramOptions(CCDBG_Build_opt& opt) {
             ret = false;
         }
     }
-    else {
+    else if (!opt.stats) {
 
         if (opt.prefixFilenameOut.length() == 0) {
 
@@ -467,7 +578,7 @@ bool check_ProgramOptions(CCDBG_Build_opt& opt) {
         }
     }
 
-    if (opt.update || opt.query){
+    if (opt.update || opt.query || opt.stats || opt.remove){
 
         if (opt.filename_graph_in.length() == 0){
 
@@ -515,6 +626,95 @@ bool check_ProgramOptions(CCDBG_Build_opt& opt) {
     return ret;
 }
 
+#ifdef BFG_KMER_SIZES
+
+// Returns the k-mer length stored in the header of a GFA graph file, 0 if not available
+size_t getGraphK(const string& filename) {
+
+    ifstream graphfile_in(filename);
+
+    if (!graphfile_in.good()) return 0;
+
+    string header;
+
+    getline(graphfile_in, header);
+
+    if ((header.length() < 2) || (header[0] != 'H')) return 0;
+
+    stringstream hs(header.substr(2)); // Skip the first 2 char. of the line "H\t"
+    string sub;
+
+    size_t k = 0;
+
+    while (hs.good()){ // Split line based on tabulation
+
+        getline(hs, sub, '\t');
+
+        if (sub.substr(0, 5) == "KL:Z:") k = atoi(sub.c_str() + 5);
+    }
+
+    return k;
+}
+
+// Replaces the current process by the Bifrost binary compiled with the smallest MAX_KMER_SIZE fitting the k-mer length.
+// Returns only if this binary is the best fit or if no binary fits. Exits if the other binary could not be executed.
+void dispatch_KmerSize(char** argv_cpy, const CCDBG_Build_opt& opt) {
+
+    size_t k = opt.k;
+
+    if (opt.update || opt.query || opt.stats || opt.remove) { // k-mer length of an input graph prevails over the one provided in parameter
+
+        const size_t graph_k = getGraphK(opt.filename_graph_in);
+
+        if (graph_k != 0) k = graph_k;
+    }
+
+    size_t i = 0;
+
+    while ((i < nb_kmer_sizes) && (k >= kmer_sizes[i])) ++i;
+
+    if ((i == nb_kmer_sizes) || (kmer_sizes[i] == MAX_KMER_SIZE)) return;
+
+    const string name = "Bifrost_k" + to_string(kmer_sizes[i]);
+
+    vector<string> dirs;
+
+    {
+        char path[4096];
+
+        const ssize_t len = readlink("/proc/self/exe", path, sizeof(path) - 1);
+
+        if (len > 0) {
+
+            const string exe(path, len);
+
+            dirs.push_back(exe.substr(0, exe.find_last_of('/') + 1));
+        }
+
+        const string arg0(argv_cpy[0]);
+        const size_t pos_slash = arg0.find_last_of('/');
+
+        if (pos_slash != string::npos) dirs.push_back(arg0.substr(0, pos_slash + 1));
+    }
+
+    if (opt.verbose) cout << "Bifrost: Using " << name << " for k-mer length " << k << "." << endl;
+
+    for (const auto& dir : dirs) {
+
+        const string path = dir + name;
+
+        if (access(path.c_str(), X_OK) == 0) execv(path.c_str(), argv_cpy);
+    }
+
+    execvp(name.c_str(), argv_cpy); // Search PATH if not found next to this binary
+
+    cerr << "Error: Could not execute " << name << " required for k-mer length " << k << "." << endl;
+
+    exit(1);
+}
+
+#endif
+
 int main(int argc, char **argv){
 
     if (argc < 2) PrintUsage();
@@ -524,14 +724,30 @@ int main(int argc, char **argv){
 
         opt.outputColors = false; // We dont know yet if we want colors or not
 
+        #ifdef BFG_KMER_SIZES
+        vector<char*> argv_cpy(argv, argv + argc); // getopt_long() permutes argv
+
+        argv_cpy.push_back(nullptr);
+        #endif
+
         const int print = parse_ProgramOptions(argc, argv, opt); // Parse input parameters
 
+        #ifdef BFG_KMER_SIZES
+        if (print == 0) dispatch_KmerSize(argv_cpy.data(), opt);
+        #endif
+
         if (print == 1) PrintVersion();
         else if (print == 2) PrintUsage();
         else if (check_ProgramOptions(opt)) {
 
             bool success = true; // Abort if any operation goes wrong
 
+            // Must be set before any table is allocated and any worker thread is started
+            if (opt.numa_interleave && !setInterleavedNUMA() && opt.verbose) {
+
+                cout << "Bifrost: Memory is not interleaved, system has a single NUMA node or does not support memory policies." << endl;
+            }
+
             if (opt.build){ // Build the graph
 
                 if (opt.outputColors){
@@ -541,6 +757,7 @@ int main(int argc, char **argv){
                     success = ccdbg.buildGraph(opt);
 
                     if (success) success = ccdbg.simplify(opt.deleteIsolated, opt.clipTips, opt.verbose);
+                    if (success && opt.popBubbles) success = ccdbg.popBubbles(opt.filename_seq_in, DEFAULT_BUBBLE_RATIO_COV, opt.nb_threads, opt.verbose);
                     if (success) success = ccdbg.buildColors(opt);
                     if (success) success = ccdbg.write(opt.prefixFilenameOut, opt.nb_threads, opt.verbose);
                 }
@@ -551,6 +768,7 @@ int main(int argc, char **argv){
                     success = cdbg.build(opt);
 
                     if (success) success = cdbg.simplify(opt.deleteIsolated, opt.clipTips, opt.verbose);
+                    if (success && opt.popBubbles) success = cdbg.popBubbles(opt.filename_seq_in, DEFAULT_BUBBLE_RATIO_COV, opt.nb_threads, opt.verbose);
                     if (success) success = cdbg.write(opt.prefixFilenameOut, opt.nb_threads, opt.outputGFA, opt.verbose);
                 }
             }
@@ -560,70 +778,56 @@ int main(int argc, char **argv){
 
                 if (l_opt.filename_colors_in.size() != 0){ // If colors in or out
 
-                    ColoredCDBG<> ccdbg1(l_opt.k, l_opt.g);
-
-                    success = ccdbg1.read(l_opt.filename_graph_in, l_opt.filename_colors_in, l_opt.nb_threads, l_opt.verbose);
-
-                    if (success) {
-
-                        l_opt.k = ccdbg1.getK();
-                        l_opt.g = ccdbg1.getG();
-
-                        ColoredCDBG<> ccdbg2(l_opt.k, l_opt.g);
-
-                        if (success) success = ccdbg2.buildGraph(l_opt);
-                        if (success) success = ccdbg2.buildColors(l_opt);
+                    ColoredCDBG<> ccdbg(l_opt.k, l_opt.g);
 
-                        if (success) {
+                    success = ccdbg.read(l_opt.filename_graph_in, l_opt.filename_colors_in, l_opt.nb_threads, l_opt.verbose);
 
-                            const size_t ccdbg1_len = ccdbg1.length();
-                            const size_t ccdbg2_len = ccdbg2.length();
-
-                            ColoredCDBG<>& ccdbg_a = (ccdbg1_len > ccdbg2_len) ? ccdbg1 : ccdbg2;
-                            ColoredCDBG<>& ccdbg_b = (ccdbg1_len > ccdbg2_len) ? ccdbg2 : ccdbg1;
-
-                            if (success) success = ccdbg_a.merge(move(ccdbg_b), l_opt.nb_threads, l_opt.verbose);
-
-                            if (success) success = ccdbg_a.simplify(l_opt.deleteIsolated, l_opt.clipTips, l_opt.verbose);
-                            if (success) success = ccdbg_a.write(l_opt.prefixFilenameOut, l_opt.nb_threads, l_opt.verbose);
-                        }
-                    }
+                    // New colors are added in place: no second graph is built and merged
+                    if (success) success = ccdbg.update(l_opt);
+                    if (success) success = ccdbg.simplify(l_opt.deleteIsolated, l_opt.clipTips, l_opt.verbose);
+                    if (success) success = ccdbg.write(l_opt.prefixFilenameOut, l_opt.nb_threads, l_opt.verbose);
                 }
                 else {
 
-                    CompactedDBG<> cdbg1(l_opt.k, l_opt.g);
+                    CompactedDBG<> cdbg(l_opt.k, l_opt.g);
 
-                    success = cdbg1.read(l_opt.filename_graph_in, l_opt.nb_threads, l_opt.verbose);
+                    success = cdbg.read(l_opt.filename_graph_in, l_opt.nb_threads, l_opt.verbose);
 
-                    if (success) {
+                    // Only the k-mers which are not in the graph yet are inserted: no second graph is built and merged
+                    if (success) success = cdbg.update(l_opt);
+                    if (success) success = cdbg.simplify(l_opt.deleteIsolated, l_opt.clipTips, l_opt.verbose);
+                    if (success) success = cdbg.write(l_opt.prefixFilenameOut, l_opt.nb_threads, l_opt.outputGFA, l_opt.verbose);
+                }
+            }
+            else if (opt.query){
 
-                        l_opt.k = cdbg1.getK();
-                        l_opt.g = cdbg1.getG();
+                if (opt.filename_colors_in.size() != 0){
 
-                        CompactedDBG<> cdbg2(l_opt.k, l_opt.g);
+                    ColoredCDBG<> ccdbg(opt.k, opt.g);
 
-                        if (success) success = cdbg2.build(l_opt);
-                        if (success) {
+                    success = ccdbg.setSparseIndex(opt.sparse_index);
 
-                            const size_t cdbg1_len = cdbg1.length();
-                            const size_t cdbg2_len = cdbg2.length();
+                    if (success) success = ccdbg.read(opt.filename_graph_in, opt.filename_colors_in, opt.nb_threads, opt.verbose);
+                    if (success) success = ccdbg.search(opt.filename_query_in, opt.prefixFilenameOut, opt.ratio_kmers, opt.inexact_search, opt.nb_threads, opt.verbose);
+                }
+                else {
 
-                            CompactedDBG<>& cdbg_a = (cdbg1_len > cdbg2_len) ? cdbg1 : cdbg2;
-                            CompactedDBG<>& cdbg_b = (cdbg1_len > cdbg2_len) ? cdbg2 : cdbg1;
+                    CompactedDBG<> cdbg(opt.k, opt.g);
 
-                            if (success) {
+                    success = cdbg.setSparseIndex(opt.sparse_index);
 
-                                success = cdbg_a.merge(cdbg_b, l_opt.nb_threads, l_opt.verbose);
-                                cdbg_b.clear();
-                            }
+                    if (success) success = cdbg.read(opt.filename_graph_in, opt.nb_threads, opt.verbose);
 
-                            if (success) success = cdbg_a.simplify(l_opt.deleteIsolated, l_opt.clipTips, l_opt.verbose);
-                            if (success) success = cdbg_a.write(l_opt.prefixFilenameOut, l_opt.nb_threads, l_opt.outputGFA, l_opt.verbose);
-                        }
+                    if (success){
+                        success = cdbg.search(opt.filename_query_in, opt.prefixFilenameOut, opt.ratio_kmers, opt.inexact_search, opt.nb_threads, opt.verbose);
                     }
                 }
             }
-            else if (opt.query){
+            else if (opt.remove){
+
+                vector<string> v_files(opt.filename_seq_in);
+
+                v_files.insert(v_files.end(), opt.filename_ref_in.begin(), opt.filename_ref_in.end());
 
                 if (opt.filename_colors_in.size() != 0){
 
@@ -631,7 +835,9 @@ int main(int argc, char **argv){
 
                     success = ccdbg.read(opt.filename_graph_in, opt.filename_colors_in, opt.nb_threads, opt.verbose);
 
-                    if (success) success = ccdbg.search(opt.filename_query_in, opt.prefixFilenameOut, opt.ratio_kmers, opt.inexact_search, opt.nb_threads, opt.verbose);
+                    if (success) success = ccdbg.removeFromFiles(v_files, opt.nb_threads, opt.verbose);
+                    if (success) success = ccdbg.simplify(opt.deleteIsolated, opt.clipTips, opt.verbose);
+                    if (success) success = ccdbg.write(opt.prefixFilenameOut, opt.nb_threads, opt.verbose);
                 }
                 else {
 
@@ -639,8 +845,41 @@ int main(int argc, char **argv){
 
                     success = cdbg.read(opt.filename_graph_in, opt.nb_threads, opt.verbose);
 
-                    if (success){
-                        success = cdbg.search(opt.filename_query_in, opt.prefixFilenameOut, opt.ratio_kmers, opt.inexact_search, opt.nb_threads, opt.verbose);
+                    if (success) success = cdbg.removeFromFiles(v_files, opt.nb_threads, opt.verbose);
+                    if (success) success = cdbg.simplify(opt.deleteIsolated, opt.clipTips, opt.verbose);
+                    if (success) success = cdbg.write(opt.prefixFilenameOut, opt.nb_threads, opt.outputGFA, opt.verbose);
+                }
+            }
+            else if (opt.stats){
+
+                CompactedDBG<> cdbg(opt.k, opt.g);
+                CDBG_Stats stats;
+
+                success = cdbg.read(opt.filename_graph_in, opt.nb_threads, opt.verbose);
+
+                if (success) success = cdbg.getStats(stats, opt.nb_threads);
+
+                if (success) {
+
+                    cout << "nb_unitigs\t" << stats.nb_unitigs << endl;
+                    cout << "nb_kmers\t" << stats.nb_kmers << endl;
+                    cout << "total_length\t" << stats.total_length << endl;
+                    cout << "min_length\t" << stats.min_length << endl;
+                    cout << "max_length\t" << stats.max_length << endl;
+                    cout << "mean_length\t" << stats.mean_length << endl;
+                    cout << "n50\t" << stats.n50 << endl;
+                    cout << "nb_components\t" << stats.nb_components << endl;
+                    cout << "max_component_nb_unitigs\t" << stats.max_component_nb_unitigs << endl;
+                    cout << "max_component_nb_kmers\t" << stats.max_component_nb_kmers << endl;
+                    cout << "nb_isolated\t" << stats.nb_isolated << endl;
+                    cout << "nb_tips\t" << stats.nb_tips << endl;
+                    cout << "nb_bubbles\t" << stats.nb_bubbles << endl;
+
+                    for (size_t i = 0; i < 5; ++i) cout << "nb_ends_degree_" << i << "\t" << stats.degree_hist[i] << endl;
+
+                    for (size_t i = 0; i < stats.length_hist.size(); ++i){
+
+                        cout << "nb_unitigs_length_" << (1ULL << i) << "_" << ((2ULL << i) - 1) << "\t" << stats.length_hist[i] << endl;
                     }
                 }
             }
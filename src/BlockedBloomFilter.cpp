@@ -140,7 +140,7 @@ void BlockedBloomFilter::clear() {
 
     if (table_ != nullptr){
 
-        delete[] table_;
+        deleteHugePagesArray(table_, blocks_);
         table_ = nullptr;
     }
 
@@ -163,7 +163,7 @@ void BlockedBloomFilter::clear() {
 void BlockedBloomFilter::init_table(){
 
     fast_div_ = libdivide::divider<uint64_t>(blocks_);
-    table_ = new BBF_Block[blocks_];
+    table_ = newHugePagesArray<BBF_Block>(blocks_);
 }
 
 int BlockedBloomFilter::contains(const uint64_t (&kmh)[4], const uint64_t minh, bool (&pres)[4], const int limit) const {
@@ -893,13 +893,16 @@ BlockedBloomFilter& BlockedBloomFilter::operator=(const BlockedBloomFilter& o) {
     seed2 = o.seed2;
     ush = o.ush;
 
-    init_table();
+    if (blocks_ != 0){
 
-    for (uint64_t i = 0; i != blocks_; ++i){
+        init_table();
 
-        memcpy(&(table_[i].block), &(o.table_[i].block), NB_ELEM_BLOCK * sizeof(uint64_t));
+        for (uint64_t i = 0; i != blocks_; ++i){
 
-        table_[i].bits_occupancy = o.table_[i].bits_occupancy;
+            memcpy(&(table_[i].block), &(o.table_[i].block), NB_ELEM_BLOCK * sizeof(uint64_t));
+
+            table_[i].bits_occupancy = o.table_[i].bits_occupancy;
+        }
     }
 
     return *this;
@@ -932,7 +935,7 @@ void BlockedBloomFilter::clear() {
 
     if (table_ != nullptr){
 
-        delete[] table_;
+        deleteHugePagesArray(table_, blocks_);
         table_ = nullptr;
     }
 
@@ -949,7 +952,7 @@ void BlockedBloomFilter::clear() {
 void BlockedBloomFilter::init_table(){
 
     fast_div_ = libdivide::divider<uint64_t>(blocks_);
-    table_ = new BBF_Block[blocks_];
+    table_ = newHugePagesArray<BBF_Block>(blocks_);
 }
 
 int BlockedBloomFilter::contains(const uint64_t (&kmh)[4], const uint64_t minh, bool (&pres)[4], const int limit) const {
@@ -1409,4 +1412,47 @@ bool BlockedBloomFilter::insert_unpar(const uint64_t kmh, const uint64_t minh) {
     return false;
 }
 
+size_t BlockedBloomFilter::insert(const uint64_t* kmh, const uint64_t* minh, const size_t nb, bool* is_new, const bool multi_threaded) {
+
+    const size_t prefetch_dist = 8; // Nb insertions between the prefetch of a block and its use
+
+    size_t nb_new = 0;
+
+    for (size_t i = 0; i < std::min(nb, prefetch_dist); ++i) {
+
+        if ((i == 0) || (minh[i] != minh[i-1])) prefetch(minh[i]);
+    }
+
+    for (size_t i = 0; i < nb; ++i) {
+
+        const size_t j = i + prefetch_dist;
+
+        // Consecutive k-mers often share their minimizer, so their blocks are already in cache
+        if ((j < nb) && (minh[j] != minh[j-1])) prefetch(minh[j]);
+
+        const bool ins = insert(kmh[i], minh[i], multi_threaded);
+
+        nb_new += static_cast<size_t>(ins);
+
+        if (is_new != nullptr) is_new[i] = ins;
+    }
+
+    return nb_new;
+}
+
+void BlockedBloomFilter::prefetch(const uint64_t minh) const {
+
+    const uint64_t minh1 = wyhash(&minh, sizeof(uint64_t), seed1, _wyp);
+    const uint64_t minh2 = minh1 + wyhash(&minh, sizeof(uint64_t), seed2, _wyp);
+
+    const char* block1 = reinterpret_cast<const char*>(table_[minh1 - (minh1 / fast_div_) * blocks_].block);
+    const char* block2 = reinterpret_cast<const char*>(table_[minh2 - (minh2 / fast_div_) * blocks_].block);
+
+    for (size_t i = 0; i < NB_ELEM_BLOCK * sizeof(uint64_t); i += 64) {
+
+        __builtin_prefetch(block1 + i);
+        __builtin_prefetch(block2 + i);
+    }
+}
+
 //#endif
@@ -10,6 +10,7 @@
 #include <random>
 #include <unordered_set>
 
+#include "HugePages.hpp"
 #include "libdivide.h"
 #include "libpopcnt.h"
 #include "wyhash.h"
@@ -50,6 +51,11 @@ class BlockedBloomFilter {
             return (multi_threaded ? insert_par(kmh, minh) : insert_unpar(kmh, minh));
         }
 
+        // Insert nb k-mer hashes kmh[i] with their minimizer hashes minh[i], in this order. The blocks of the
+        // next insertions are prefetched while inserting the current one. If is_new is not nullptr, is_new[i]
+        // is set to the result of insert(kmh[i], minh[i]). Returns the number of k-mers which were inserted.
+        size_t insert(const uint64_t* kmh, const uint64_t* minh, const size_t nb, bool* is_new, const bool multi_threaded = false);
+
         bool WriteBloomFilter(FILE *fp) const;
         bool ReadBloomFilter(FILE *fp);
 
@@ -236,6 +242,8 @@ class BlockedBloomFilter {
             return pow(1-exp(-((double)k)/((double)bits)),(double)k);
         }
 
+        void prefetch(const uint64_t min_hash) const;
+
         bool insert_par(const uint64_t kmer_hash, const uint64_t min_hash);
         bool insert_unpar(const uint64_t kmer_hash, const uint64_t min_hash);
 };
@@ -167,8 +167,9 @@ class ColoredCDBG : public CompactedDBG<DataAccessor<Unitig_data_t>, DataStorage
         ColoredCDBG(int kmer_length = DEFAULT_K, int minimizer_length = -1);
 
         /** Copy constructor (copy a colored cdBG).
-        * This function is expensive in terms of time and memory as the content of a colored and compacted
-        * de Bruijn graph is copied. After the call to this function, the same graph exists twice in memory.
+        * This function is expensive in terms of time and memory: only the unitig sequences, the minimizer index and
+        * the short unitigs are shared with o (see CompactedDBG<U, G>::CompactedDBG(const CompactedDBG<U, G>&)). The
+        * color sets, which are usually the largest structure of a colored graph, are copied entirely.
         * @param o is a constant reference to the colored and compacted de Bruijn graph to copy.
         */
         ColoredCDBG(const ColoredCDBG& o);
@@ -181,8 +182,9 @@ class ColoredCDBG : public CompactedDBG<DataAccessor<Unitig_data_t>, DataStorage
         ColoredCDBG(ColoredCDBG&& o);
 
         /** Copy assignment operator (copy a colored cdBG).
-        * This function is expensive in terms of time and memory as the content of a colored and compacted
-        * de Bruijn graph is copied.  After the call to this function, the same graph exists twice in memory.
+        * This function is expensive in terms of time and memory: only the unitig sequences, the minimizer index and
+        * the short unitigs are shared with o (see CompactedDBG<U, G>::CompactedDBG(const CompactedDBG<U, G>&)). The
+        * color sets, which are usually the largest structure of a colored graph, are copied entirely.
         * @param o is a constant reference to the colored and compacted de Bruijn graph to copy.
         * @return a reference to the colored and compacted de Bruijn which is the copy.
         */
@@ -305,8 +307,10 @@ class ColoredCDBG : public CompactedDBG<DataAccessor<Unitig_data_t>, DataStorage
 
         /** Merge and clear multiple colored and compacted de Bruijn graphs.
         * After merging, all unitigs and colors of the input colored and compacted de Bruijn graphs have been added to and
-        * compacted with the current colored and compacted de Bruijn graph (this). The input graphs are cleared before the
-        * function returns. If the input unitigs had data of type "MyUnitigData" associated, they have been added to the
+        * compacted with the current colored and compacted de Bruijn graph (this). The graphs of v are first merged pairwise in a
+        * tree reduction (log2(v.size()) rounds) in which disjoint pairs of consecutive graphs are merged concurrently, each pair
+        * by its own group of threads, before the result is merged in the current graph. The colors are added in the order of v.
+        * The input graphs are cleared as soon as they are merged, which releases their memory. If the input unitigs had data of type "MyUnitigData" associated, they have been added to the
         * current colored and compacted de Bruijn graph using the functions of the class MyUnitigData which are also present
         * in its base class CCDBG_Data_t<MyUnitigData>.
         * @param v is a reference on a reference to a vector of colored and compacted de Bruijn graphs to merge.  It can be
@@ -317,6 +321,37 @@ class ColoredCDBG : public CompactedDBG<DataAccessor<Unitig_data_t>, DataStorage
         */
         bool merge(vector<ColoredCDBG>&& v, const size_t nb_threads = 1, const bool verbose = false);
 
+        /** Merge colored and compacted de Bruijn graphs stored on disk, one at a time.
+        * Each graph (GFA file and its color file) is read, merged in the current colored and compacted de Bruijn graph (this)
+        * with ColoredCDBG::merge(ColoredCDBG&&, const size_t, const bool) and released before the next graph is read: the peak
+        * memory is the one of the current graph plus the largest input graph instead of the one of all input graphs. The color
+        * ids of an input graph are offset by the number of colors of the current graph as it is merged, so the colors are added
+        * in the order of the input files. If the current graph is empty (no unitigs and no colors), the first input graph is
+        * read in it directly.
+        * @param graph_filenames is a vector of GFA filenames, one per graph to merge.
+        * @param colors_filenames is a vector of color filenames, such that colors_filenames[i] is the color file of the graph
+        * graph_filenames[i].
+        * @param nb_threads is an integer indicating how many threads can be used during the merging.
+        * @param verbose is a boolean indicating if information messages must be printed during the execution of the function.
+        * @return a boolean indicating if the graphs have been successfully merged.
+        */
+        bool mergeFromFiles(const vector<string>& graph_filenames, const vector<string>& colors_filenames,
+                            const size_t nb_threads = 1, const bool verbose = false);
+
+        /** Add new colors to the colored and compacted de Bruijn graph in place, one color per input file.
+        * The k-mers of the input files which are not in the graph yet are inserted, only the unitigs they touch are split or
+        * joined (their colors are split and concatenated accordingly) and the new colors are then mapped from the input files
+        * only: the color sets of the unitigs which are not touched are neither moved nor rebuilt. The new colors are appended
+        * after the colors of the graph, input sequence files first and input reference files second. K-mers occurring exactly
+        * once in the input sequence files (opt.filename_seq_in) are not inserted while all k-mers of the input reference files
+        * (opt.filename_ref_in) are inserted. As in CompactedDBG<U, G>::update, the k-mers occurring once are discarded with a
+        * Blocked Bloom filter of opt.nb_bits_unique_kmers_bf bits per k-mer and, if opt.useMercyKmers is true, those connecting
+        * tips of the updated graph are inserted. If the graph is empty (no unitigs and no colors), it is built from the input files.
+        * @param opt is a structure from which the members are parameters of this function. See CCDBG_Build_opt.
+        * @return a boolean indicating if the graph has been successfully updated.
+        */
+        bool update(const CCDBG_Build_opt& opt);
+
         /** Get the name of a color. As colors match the input files, the color names match the input filenames.
         * @return a string which is either a color name or an empty string if the color ID is invalid or if the
         * colors have not yet been mapped to the unitigs.
@@ -343,7 +378,7 @@ class ColoredCDBG : public CompactedDBG<DataAccessor<Unitig_data_t>, DataStorage
         void checkColors(const vector<string>& filename_seq_in) const;
 
         void initUnitigColors(const CCDBG_Build_opt& opt, const size_t max_nb_hash = 31);
-        void buildUnitigColors(const size_t nb_threads);
+        void buildUnitigColors(const size_t nb_threads, const size_t color_id_start = 0);
         //void buildUnitigColors2(const size_t nb_threads);
 
         void resizeDataUC(const size_t sz, const size_t nb_threads = 1, const size_t max_nb_hash = 31);
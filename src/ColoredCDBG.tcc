@@ -158,7 +158,11 @@ bool ColoredCDBG<U>::merge(const ColoredCDBG& o, const size_t nb_threads, const
 
             for (size_t i = 0; i < o.getNbColors(); ++i) this->getData()->color_names.push_back(o.getColorName(i));
 
-            return CompactedDBG<DataAccessor<U>, DataStorage<U>>::mergeData(o, nb_threads, verbose);
+            const bool ret = CompactedDBG<DataAccessor<U>, DataStorage<U>>::mergeData(o, nb_threads, verbose);
+
+            this->reindexOvercrowdedKmers(nb_threads);
+
+            return ret;
         }
     }
 
@@ -226,6 +230,8 @@ bool ColoredCDBG<U>::merge(ColoredCDBG&& o, const size_t nb_threads, const bool
 
             o.clear();
 
+            this->reindexOvercrowdedKmers(nb_threads);
+
             return ret;
         }
     }
@@ -303,6 +309,8 @@ bool ColoredCDBG<U>::merge(const vector<ColoredCDBG>& v, const size_t nb_threads
                 if (!CompactedDBG<DataAccessor<U>, DataStorage<U>>::mergeData(ccdbg, nb_threads, verbose)) return false;
             }
 
+            this->reindexOvercrowdedKmers(nb_threads);
+
             return true;
         }
     }
@@ -342,51 +350,163 @@ bool ColoredCDBG<U>::merge(vector<ColoredCDBG>&& v, const size_t nb_threads, con
         }
     }
 
-    if (ret){
+    if (ret && !v.empty()){
 
-        const size_t sz_before = this->size();
+        // Pairs of consecutive graphs are merged so the colors remain in the order of v
+        const size_t pos = CompactedDBG<DataAccessor<U>, DataStorage<U>>::mergeTree(v, nb_threads, true, verbose,
 
-        for (auto& unitig : *this) unitig.setFullCoverage();
+            [](ColoredCDBG<U>& a, ColoredCDBG<U>& b, const size_t nb_threads_pair){
 
-        for (const auto& ccdbg : v){
+                return a.merge(move(b), nb_threads_pair, false);
+            }
+        );
 
-            ret = CompactedDBG<DataAccessor<U>, DataStorage<U>>::annotateSplitUnitigs(ccdbg, nb_threads, verbose);
+        ret = (pos != v.size()) && merge(move(v[pos]), nb_threads, verbose);
 
-            if (!ret) break;
+        for (auto& ccdbg : v) ccdbg.clear();
+    }
+
+    return ret;
+}
+
+template<typename U>
+bool ColoredCDBG<U>::mergeFromFiles(const vector<string>& graph_filenames, const vector<string>& colors_filenames,
+                                    const size_t nb_threads, const bool verbose){
+
+    if (invalid){
+
+        cerr << "ColoredCDBG::mergeFromFiles(): Current graph is invalid." << endl;
+        return false;
+    }
+
+    if (graph_filenames.size() != colors_filenames.size()){
+
+        cerr << "ColoredCDBG::mergeFromFiles(): The number of graph files and the number of color files differ." << endl;
+        return false;
+    }
+
+    for (size_t i = 0; i < graph_filenames.size(); ++i){
+
+        if (verbose){
+
+            cout << "ColoredCDBG::mergeFromFiles(): Merging graph " << (i + 1) << "/" << graph_filenames.size();
+            cout << " (" << graph_filenames[i] << ")." << endl;
         }
 
-        if (ret){
+        if ((this->size() == 0) && (getNbColors() == 0)){
 
-            const size_t sz_after = this->size();
-            const pair<size_t, size_t> p1 = CompactedDBG<DataAccessor<U>, DataStorage<U>>::getSplitInfoAllUnitigs();
+            if (!read(graph_filenames[i], colors_filenames[i], nb_threads, verbose)) return false;
+        }
+        else {
 
-            resizeDataUC(sz_after + (p1.second - p1.first), nb_threads);
+            ColoredCDBG<U> ccdbg(this->getK(), this->getG());
 
-            const pair<size_t, size_t> p2 = CompactedDBG<DataAccessor<U>, DataStorage<U>>::splitAllUnitigs();
-            const size_t joined = (p1.second != 0) ? CompactedDBG<DataAccessor<U>, DataStorage<U>>::joinUnitigs() : 0;
+            if (!ccdbg.read(graph_filenames[i], colors_filenames[i], nb_threads, verbose)) return false;
 
-            if (verbose){
+            // The input graph is cleared once merged, its memory is released before the next graph is read
+            if (!merge(move(ccdbg), nb_threads, verbose)) return false;
+        }
+    }
 
-                cout << "CompactedDBG::merge(): Added " << (sz_after - sz_before) << " new unitigs." << endl;
-                cout << "CompactedDBG::merge(): Split " << p1.first << " unitigs into " << p1.second << " new unitigs." << endl;
-                cout << "CompactedDBG::merge(): Joined " << joined << " unitigs." << endl;
-                cout << "CompactedDBG::merge(): " << this->size() << " unitigs after merging." << endl;
-            }
+    return true;
+}
+
+template<typename U>
+bool ColoredCDBG<U>::update(const CCDBG_Build_opt& opt){
 
-            for (auto& ccdbg : v){
+    if (invalid){
 
-                for (size_t i = 0; i < ccdbg.getNbColors(); ++i) this->getData()->color_names.push_back(ccdbg.getColorName(i));
+        cerr << "ColoredCDBG::update(): Graph is invalid and cannot be updated." << endl;
+        return false;
+    }
 
-                if (!CompactedDBG<DataAccessor<U>, DataStorage<U>>::mergeData(move(ccdbg), nb_threads, verbose)) return false;
+    if (opt.nb_threads == 0){
 
-                ccdbg.clear();
-            }
+        cerr << "ColoredCDBG::update(): Number of threads cannot be less than or equal to 0." << endl;
+        return false;
+    }
 
-            return true;
+    if (opt.filename_seq_in.size() + opt.filename_ref_in.size() == 0){
+
+        cerr << "ColoredCDBG::update(): Missing input files." << endl;
+        return false;
+    }
+
+    if ((this->size() == 0) && (getNbColors() == 0)) return buildGraph(opt) && buildColors(opt);
+
+    DataStorage<U>* ds = this->getData();
+
+    const size_t nb_colors = ds->getNbColors();
+
+    vector<vector<Kmer>> v_v_km;
+
+    BlockedBloomFilter bf_uniq; // K-mers of the input sequence files which are not in the graph
+
+    if (opt.filename_seq_in.size() != 0){
+
+        if (opt.verbose) cout << "ColoredCDBG::update(): Searching the k-mers of the input sequence files." << endl;
+
+        bf_uniq = this->createUniqueKmersFilter(opt.filename_seq_in, opt.nb_bits_unique_kmers_bf, opt.nb_threads, opt.verbose);
+
+        this->findNewKmers(opt.filename_seq_in, &bf_uniq, opt.nb_threads, v_v_km);
+    }
+
+    if (opt.filename_ref_in.size() != 0){
+
+        if (opt.verbose) cout << "ColoredCDBG::update(): Searching the k-mers of the input reference files." << endl;
+
+        this->findNewKmers(opt.filename_ref_in, nullptr, opt.nb_threads, v_v_km);
+    }
+
+    const bool use_mercy = opt.useMercyKmers && (opt.filename_seq_in.size() != 0);
+    const bool inserted = (this->insertNewKmers(v_v_km, opt.nb_threads, opt.verbose) != 0);
+
+    if (inserted){
+
+        vector<vector<Kmer>>().swap(v_v_km);
+
+        // The color storage is not rebuilt: the UnitigColors of split and joined unitigs are inserted in the free slots of the
+        // storage (which grows if needed) and all other UnitigColors stay where they are
+        const pair<size_t, size_t> p = this->splitAllUnitigs();
+        const size_t joined = this->joinUnitigs();
+
+        if (opt.verbose){
+
+            cout << "ColoredCDBG::update(): Split " << p.first << " unitigs into " << p.second << " new unitigs." << endl;
+            cout << "ColoredCDBG::update(): Joined " << joined << " unitigs." << endl;
         }
     }
 
-    return false;
+    // Mercy k-mers are inserted before the new color sets are created so they get one like the other new k-mers
+    if (use_mercy) this->joinTips(bf_uniq, opt.nb_threads, opt.verbose);
+
+    if (inserted || use_mercy){
+
+        size_t nb_new_cs = 0;
+
+        // Unitigs made of new k-mers only have no UnitigColors yet. Insertion is sequential as the storage might be resized.
+        for (auto& unitig : *this){
+
+            if (ds->getUnitigColors(unitig) == nullptr){
+
+                *(unitig.getData()) = ds->insert(unitig).first;
+                ++nb_new_cs;
+            }
+        }
+
+        if (opt.verbose) cout << "ColoredCDBG::update(): Inserted " << nb_new_cs << " new color sets." << endl;
+    }
+
+    ds->color_names.insert(ds->color_names.end(), opt.filename_seq_in.begin(), opt.filename_seq_in.end());
+    ds->color_names.insert(ds->color_names.end(), opt.filename_ref_in.begin(), opt.filename_ref_in.end());
+
+    if (opt.verbose) cout << "ColoredCDBG::update(): Mapping " << (ds->getNbColors() - nb_colors) << " new colors." << endl;
+
+    buildUnitigColors(opt.nb_threads, nb_colors);
+
+    this->reindexOvercrowdedKmers(opt.nb_threads);
+
+    return true;
 }
 
 template<typename U>
@@ -801,8 +921,9 @@ inline void ColoredCDBG<void>::resizeDataUC(const size_t sz, const size_t nb_thr
     //cout << "Number of unitigs not hashed is " << ds->overflow.size() << " on " << ds->nb_cs << " unitigs." << endl;
 }
 
+// Map the colors of the input files ds->color_names[color_id_start..] to the unitigs. Color id of a file is its position in ds->color_names.
 template<typename U>
-void ColoredCDBG<U>::buildUnitigColors(const size_t nb_threads){
+void ColoredCDBG<U>::buildUnitigColors(const size_t nb_threads, const size_t color_id_start){
 
     DataStorage<U>* ds = this->getData();
 
@@ -823,7 +944,7 @@ void ColoredCDBG<U>::buildUnitigColors(const size_t nb_threads){
 
     string s;
 
-    FileParser fp(ds->color_names);
+    FileParser fp(vector<string>(ds->color_names.begin() + color_id_start, ds->color_names.end()));
 
     std::atomic_flag* cs_locks = new std::atomic_flag[nb_locks];
 
@@ -872,7 +993,7 @@ void ColoredCDBG<U>::buildUnitigColors(const size_t nb_threads){
 
                         while (cs_locks[id_lock].test_and_set(std::memory_order_acquire)); // Set the corresponding lock
 
-                        uc->add(um, col_buf[c_id]);
+                        uc->add(um, color_id_start + col_buf[c_id]);
 
                         cs_locks[id_lock].clear(std::memory_order_release);
                     }
@@ -1743,9 +1864,9 @@ void ColoredCDBG<U>::checkColors(const vector<string>& filename_seq_in) const {
 
     while (FQ.read_next(s, file_id) >= 0){
 
-        for (KmerIterator it_km(s.c_str()), it_km_end; it_km != it_km_end; ++it_km) {
+        for (KmerRepIterator it_km(s.c_str()), it_km_end; it_km != it_km_end; ++it_km) {
 
-            pair<KmerHashTable<tiny_vector<size_t, 1>>::iterator, bool> it = km_h.insert(it_km->first.rep(), tiny_vector<size_t, 1>());
+            pair<KmerHashTable<tiny_vector<size_t, 1>>::iterator, bool> it = km_h.insert(it_km->first, tiny_vector<size_t, 1>());
 
             tiny_vector<size_t, 1>& tv = *(it.first);
 
@@ -36,6 +36,7 @@
 #include "Lock.hpp"
 #include "minHashIterator.hpp"
 #include "MinimizerIndex.hpp"
+#include "MinimizerOrder.hpp"
 #include "RepHash.hpp"
 #include "TinyVector.hpp"
 #include "Unitig.hpp"
@@ -54,6 +55,10 @@
 #define DEFAULT_G_DEC1 8
 #define DEFAULT_G_DEC2 4
 
+#define DEFAULT_G_SAMPLE_NB_BASES 8000000
+
+#define DEFAULT_BUBBLE_RATIO_COV 0.25
+
 /** @file src/CompactedDBG.hpp
 * Interface for the Compacted de Bruijn graph API.
 * Code snippets using this interface are provided in snippets/test.cpp.
@@ -111,11 +116,21 @@ using namespace std;
 * @var CDBG_Build_opt::update
 * Boolean indicating if the graph must be updated. This parameter is not used by any function of
 * CompactedDBG<U, G> but is used by the Bifrost CLI. Default is false.
+* @var CDBG_Build_opt::stats
+* Boolean indicating if statistics of the graph must be computed (see CompactedDBG<U, G>::getStats). This parameter
+* is not used by any function of CompactedDBG<U, G> but is used by the Bifrost CLI. Default is false.
+* @var CDBG_Build_opt::remove
+* Boolean indicating if k-mers must be removed from the graph (see CompactedDBG<U, G>::removeFromFiles). This parameter
+* is not used by any function of CompactedDBG<U, G> but is used by the Bifrost CLI. Default is false.
 * @var CDBG_Build_opt::clipTips
 * Clip short tips (length < 2k) of the graph (not used by CompactedDBG<U, G>::build). Default is false.
 * @var CDBG_Build_opt::deleteIsolated
 * Remove short isolated unitigs (length < 2k) of the graph (not used by CompactedDBG<U, G>::build).
 * Default is false.
+* @var CDBG_Build_opt::popBubbles
+* Pop the simple bubbles of the graph created by sequencing errors, using the coverage of the bubbles in the files
+* of CDBG_Build_opt::filename_seq_in (not used by CompactedDBG<U, G>::build, see CompactedDBG<U, G>::popBubbles).
+* Default is false.
 * @var CDBG_Build_opt::useMercyKmers
 * Keep in the graph low coverage k-mers (cov=1) connecting tips of the graph. Default is false.
 * @var CDBG_Build_opt::filename_graph_in
@@ -124,6 +139,17 @@ using namespace std;
 * @var CDBG_Build_opt::outputGFA
 * Boolean indicating if the graph is written to a GFA file (true) or if the unitigs are written to a
 * FASTA file (false). Default is true.
+* @var CDBG_Build_opt::auto_g
+* Boolean indicating if CompactedDBG<U, G>::build replaces the length g of minimizers of the graph by the length estimated
+* from a sample of the input files (see CompactedDBG<U, G>::estimateMinimizerLength). Default is false.
+* @var CDBG_Build_opt::sparse_index
+* Boolean indicating if the graph uses a sparse minimizer index (see CompactedDBG<U, G>::setSparseIndex).
+* This parameter is not used by any function of CompactedDBG<U, G> but is used by the Bifrost CLI.
+* Default is false.
+* @var CDBG_Build_opt::numa_interleave
+* Boolean indicating if the memory is interleaved over all the NUMA nodes of the machine (see setInterleavedNUMA() in
+* numa_policy.h). This parameter is not used by any function of CompactedDBG<U, G> but is used by the Bifrost CLI.
+* Default is false.
 */
 struct CDBG_Build_opt {
 
@@ -140,6 +166,8 @@ struct CDBG_Build_opt {
     vector<string> filename_seq_in;
     vector<string> filename_ref_in;
 
+    bool auto_g;
+
     // The following members are NOT used by CompactedDBG<U, G>::build
     // but you can set them to use them as parameters for other functions
     // such as CompactedDBG<U, G>::simplify, CompactedDBG<U, G>::read or
@@ -150,13 +178,18 @@ struct CDBG_Build_opt {
     bool build;
     bool update;
     bool query;
+    bool stats;
+    bool remove;
 
     bool clipTips;
     bool deleteIsolated;
+    bool popBubbles;
     bool useMercyKmers;
 
     bool outputGFA;
     bool inexact_search;
+    bool sparse_index;
+    bool numa_interleave;
 
     double ratio_kmers;
 
@@ -167,9 +200,72 @@ struct CDBG_Build_opt {
     vector<string> filename_query_in;
 
     CDBG_Build_opt() :  nb_threads(1), k(DEFAULT_K), g(-1), nb_bits_unique_kmers_bf(14),
-                        nb_bits_non_unique_kmers_bf(14), ratio_kmers(0.8),
-                        build(false), update(false), query(false), clipTips(false), deleteIsolated(false),
-                        inexact_search(false), useMercyKmers(false), outputGFA(true), verbose(false) {}
+                        nb_bits_non_unique_kmers_bf(14), ratio_kmers(0.8), auto_g(false),
+                        build(false), update(false), query(false), stats(false), remove(false), clipTips(false), deleteIsolated(false), popBubbles(false),
+                        inexact_search(false), sparse_index(false), numa_interleave(false), useMercyKmers(false), outputGFA(true), verbose(false) {}
+};
+
+/** @struct CDBG_Stats
+* @brief Statistics of a compacted de Bruijn graph, computed by CompactedDBG<U, G>::getStats. The ends of a
+* unitig are its head (first k-mer) and its tail (last k-mer).
+* @var CDBG_Stats::nb_unitigs
+* Number of unitigs.
+* @var CDBG_Stats::nb_kmers
+* Number of k-mers.
+* @var CDBG_Stats::total_length
+* Sum of the unitigs length.
+* @var CDBG_Stats::min_length
+* Length of the shortest unitig (0 if the graph is empty).
+* @var CDBG_Stats::max_length
+* Length of the longest unitig.
+* @var CDBG_Stats::mean_length
+* Mean length of the unitigs.
+* @var CDBG_Stats::n50
+* N50 of the unitigs length: largest length L such that the unitigs of length >= L account for at least half of
+* CDBG_Stats::total_length.
+* @var CDBG_Stats::length_hist
+* Histogram of the unitigs length: length_hist[i] is the number of unitigs whose length is in [2^i, 2^(i+1)).
+* @var CDBG_Stats::degree_hist
+* Histogram of the unitig ends degree: degree_hist[d] is the number of unitig ends with exactly d neighbors.
+* @var CDBG_Stats::nb_components
+* Number of connected components (the orientation of the edges is ignored).
+* @var CDBG_Stats::max_component_nb_unitigs
+* Number of unitigs in the largest (in k-mers) connected component.
+* @var CDBG_Stats::max_component_nb_kmers
+* Number of k-mers in the largest (in k-mers) connected component.
+* @var CDBG_Stats::nb_isolated
+* Number of isolated unitigs (no predecessor and no successor).
+* @var CDBG_Stats::nb_tips
+* Number of tips: unitigs of less than k k-mers with neighbors on exactly one end.
+* @var CDBG_Stats::nb_bubbles
+* Number of simple bubbles: groups of at least 2 unitigs having each exactly one predecessor and one successor,
+* the same for all unitigs of the group.
+*/
+struct CDBG_Stats {
+
+    size_t nb_unitigs;
+    size_t nb_kmers;
+
+    size_t total_length;
+    size_t min_length;
+    size_t max_length;
+    double mean_length;
+    size_t n50;
+
+    vector<size_t> length_hist;
+    size_t degree_hist[5];
+
+    size_t nb_components;
+    size_t max_component_nb_unitigs;
+    size_t max_component_nb_kmers;
+
+    size_t nb_isolated;
+    size_t nb_tips;
+    size_t nb_bubbles;
+
+    CDBG_Stats() :  nb_unitigs(0), nb_kmers(0), total_length(0), min_length(0), max_length(0), mean_length(0), n50(0),
+                    degree_hist{0, 0, 0, 0, 0}, nb_components(0), max_component_nb_unitigs(0), max_component_nb_kmers(0),
+                    nb_isolated(0), nb_tips(0), nb_bubbles(0) {}
 };
 
 /** @typedef const_UnitigMap
@@ -315,12 +411,16 @@ class CompactedDBG {
         template<typename U, typename G, bool is_const> friend class UnitigMap;
         template<typename U, typename G, bool is_const> friend class unitigIterator;
         template<typename U, typename G, bool is_const> friend class neighborIterator;
+        template<typename U, typename G, bool is_const> friend class unitigRange;
 
         template<typename X, typename Y> friend class CompactedDBG;
 
         typedef unitigIterator<U, G, false> iterator; /**< An iterator for the unitigs of the graph. No specific order is assumed. */
         typedef unitigIterator<U, G, true> const_iterator; /**< A constant iterator for the unitigs of the graph. No specific order is assumed. */
 
+        typedef unitigRange<U, G, false> range; /**< A splittable range of unitigs of the graph, in the order of CompactedDBG::iterator. */
+        typedef unitigRange<U, G, true> const_range; /**< A constant splittable range of unitigs of the graph, in the order of CompactedDBG::const_iterator. */
+
         /** Constructor (set up an empty compacted dBG).
         * @param kmer_length is the length k of k-mers used in the graph (each unitig is of length at least k).
         * @param minimizer_length is the length g of minimizers (g < k) used in the graph.
@@ -328,8 +428,11 @@ class CompactedDBG {
         CompactedDBG(const int kmer_length = DEFAULT_K, const int minimizer_length = -1);
 
         /** Copy constructor (copy a compacted de Bruijn graph).
-        * This function is expensive in terms of time and memory as the content of a compacted
-        * de Bruijn graph is copied.  After the call to this function, the same graph exists twice in memory.
+        * The sequences of the unitigs, the minimizer index and the short unitigs (k-mer, coverage and data) are
+        * shared with o until either graph modifies them (copy-on-write). The minimizer index and the short unitigs
+        * are shared by blocks: a modification duplicates only the blocks it changes. Everything else is copied: each
+        * unitig object with its coverage and data and the abundant unitigs. Hence, the copy is O(number of unitigs)
+        * in time and memory.
         * @param o is a constant reference to the compacted de Bruijn graph to copy.
         */
         CompactedDBG(const CompactedDBG<U, G>& o); // Copy constructor
@@ -346,8 +449,11 @@ class CompactedDBG {
         virtual ~CompactedDBG();
 
         /** Copy assignment operator (copy a compacted de Bruijn graph).
-        * This function is expensive in terms of time and memory as the content of a compacted
-        * de Bruijn graph is copied.  After the call to this function, the same graph exists twice in memory.
+        * The sequences of the unitigs, the minimizer index and the short unitigs (k-mer, coverage and data) are
+        * shared with o until either graph modifies them (copy-on-write). The minimizer index and the short unitigs
+        * are shared by blocks: a modification duplicates only the blocks it changes. Everything else is copied: each
+        * unitig object with its coverage and data and the abundant unitigs. Hence, the copy is O(number of unitigs)
+        * in time and memory.
         * @param o is a constant reference to the compacted de Bruijn graph to copy.
         * @return a reference to the compacted de Bruijn which is the copy.
         */
@@ -404,6 +510,26 @@ class CompactedDBG {
         */
         bool simplify(const bool delete_short_isolated_unitigs = true, const bool clip_short_tips = true, const bool verbose = false);
 
+        /** Pop the simple bubbles of the Compacted de Bruijn graph created by sequencing errors. A simple bubble is made of at
+        * least 2 short (< 2k length) unitigs, the branches of the bubble, having each exactly one predecessor and one successor,
+        * the same for all branches. The coverage of each branch, the mean number of occurrences of its k-mers in the input
+        * files, is computed by streaming the input files. In each bubble, the branches with a coverage lower than ratio_cov
+        * times the coverage of the most covered branch are removed and the remaining unitigs are joined. The bubbles are
+        * detected and the input files are streamed in parallel. Only bubbles whose branches are each a single unitig are
+        * detected: a branch spanning several unitigs or of length 2k or more, such as those created by two sequencing errors
+        * less than k bases apart, by an error within a branch of another bubble or by an insertion, is left in the graph.
+        * Such a bubble might become simple and be popped by a subsequent call once the bubbles it contains are popped.
+        * @param input_filenames is a vector of strings, each string is the name of a FASTA/FASTQ/GFA file (possibly gzipped)
+        * from which the coverage of the branches is computed, usually the sequencing reads the graph was built from.
+        * @param ratio_cov is the minimum ratio between the coverage of a branch and the coverage of the most covered branch
+        * of its bubble for the branch to be kept in the graph.
+        * @param nb_threads is the number of threads that can be used.
+        * @param verbose is a boolean indicating if information messages must be printed during the function execution.
+        * @return boolean indicating if the bubbles have been popped successfully.
+        */
+        bool popBubbles(const vector<string>& input_filenames, const double ratio_cov = DEFAULT_BUBBLE_RATIO_COV,
+                        const size_t nb_threads = 1, const bool verbose = false);
+
         /** Write the Compacted de Bruijn graph to disk (GFA1 format).
         * @param output_filename is a string containing the name of the file in which the graph will be written.
         * @param nb_threads is a number indicating how many threads can be used to write the graph to disk.
@@ -494,20 +620,78 @@ class CompactedDBG {
 
         /** Add a sequence to the Compacted de Bruijn graph. Non-{A,C,G,T} characters such as Ns are discarded.
         * The function automatically breaks the sequence into unitig(s). Those unitigs can be stored as the reverse-complement
-        * of the input sequence.
+        * of the input sequence. The index of overcrowded k-mers is discarded and not rebuilt by this function (see
+        * CompactedDBG<U, G>::indexOvercrowdedKmers).
         * @param seq is a string containing the sequence to insert.
         * @param verbose is a boolean indicating if information messages must be printed during the function execution.
         * @return a boolean indicating if the sequence was successfully inserted in the graph.
         */
         bool add(const string& seq, const bool verbose = false);
 
-        /** Remove a unitig from the Compacted de Bruijn graph.
+        /** Add multiple sequences to the Compacted de Bruijn graph, in parallel. Non-{A,C,G,T} characters such as Ns are discarded.
+        * Unlike adding the sequences one by one with CompactedDBG<U, G>::add(const string&, const bool), the k-mers of the
+        * sequences which are not in the graph are collected first, the new unitigs they form are then created concurrently and
+        * the unitigs of the graph are split and joined only once, at the end.
+        * @param v_seq is a vector of strings, each string is a sequence to insert.
+        * @param nb_threads is the number of threads that can be used.
+        * @param verbose is a boolean indicating if information messages must be printed during the function execution.
+        * @return a boolean indicating if the sequences were successfully inserted in the graph.
+        */
+        bool add(const vector<string>& v_seq, const size_t nb_threads = 1, const bool verbose = false);
+
+        /** Add the sequences of FASTA/FASTQ/GFA files (possibly gzipped) to the Compacted de Bruijn graph, in parallel
+        * (see CompactedDBG<U, G>::add(const vector<string>&, const size_t, const bool)). All k-mers of the files are inserted,
+        * no filtering is performed. The files are streamed: the sequences are not kept in memory.
+        * @param input_filenames is a vector of strings, each string is the name of a FASTA/FASTQ/GFA file.
+        * @param nb_threads is the number of threads that can be used.
+        * @param verbose is a boolean indicating if information messages must be printed during the function execution.
+        * @return a boolean indicating if the sequences were successfully inserted in the graph.
+        */
+        bool addFromFiles(const vector<string>& input_filenames, const size_t nb_threads = 1, const bool verbose = false);
+
+        /** Update the Compacted de Bruijn graph in place with the k-mers of the files of CDBG_Build_opt::filename_seq_in and
+        * CDBG_Build_opt::filename_ref_in. Only the k-mers of the files which are not already in the graph are kept in memory and
+        * inserted (see CompactedDBG<U, G>::addFromFiles): no second graph is built. As in CompactedDBG<U, G>::build, k-mers
+        * occurring exactly once in the files of CDBG_Build_opt::filename_seq_in are discarded while all k-mers of the files of
+        * CDBG_Build_opt::filename_ref_in are used. The k-mers occurring once are discarded with a Blocked Bloom filter of
+        * CDBG_Build_opt::nb_bits_unique_kmers_bf bits per k-mer of the files of CDBG_Build_opt::filename_seq_in, as in
+        * CompactedDBG<U, G>::build: memory used by the update is this filter plus the k-mers occurring twice or more which are
+        * not in the graph. If CDBG_Build_opt::useMercyKmers is true, k-mers occurring once which connect tips of the updated
+        * graph are inserted too. Parameters CDBG_Build_opt::nb_threads and CDBG_Build_opt::verbose are also used.
+        * @param opt is a structure from which the members are parameters of this function. See CDBG_Build_opt.
+        * @return a boolean indicating if the graph was successfully updated.
+        */
+        bool update(const CDBG_Build_opt& opt);
+
+        /** Remove a unitig from the Compacted de Bruijn graph. The index of overcrowded k-mers is discarded and not rebuilt
+        * by this function (see CompactedDBG<U, G>::indexOvercrowdedKmers).
         * @param um is a UnitigMap object containing the information of the unitig to remove from the graph.
         * @param verbose is a boolean indicating if information messages must be printed during the execution of the function.
         * @return a boolean indicating if the unitig was successfully removed from the graph.
         */
         bool remove(const const_UnitigMap<U, G>& um, const bool verbose = false);
 
+        /** Remove multiple k-mers from the Compacted de Bruijn graph, in parallel. K-mers which are not in the graph are ignored.
+        * Unlike removing unitigs one by one with CompactedDBG<U, G>::remove(const const_UnitigMap<U, G>&, const bool), the
+        * k-mers to remove are marked first, the unitigs are then split at (or deleted with) the marked k-mers and joined
+        * only once, at the end. Data associated with deleted unitigs is cleared. A unitig can be removed by removing all its k-mers.
+        * @param v_km is a vector of k-mers to remove.
+        * @param nb_threads is the number of threads that can be used.
+        * @param verbose is a boolean indicating if information messages must be printed during the function execution.
+        * @return a boolean indicating if the k-mers were successfully removed from the graph.
+        */
+        bool remove(const vector<Kmer>& v_km, const size_t nb_threads = 1, const bool verbose = false);
+
+        /** Remove all k-mers of the sequences of FASTA/FASTQ/GFA files (possibly gzipped) from the Compacted de Bruijn graph,
+        * in parallel (see CompactedDBG<U, G>::remove(const vector<Kmer>&, const size_t, const bool)). The files are streamed:
+        * the sequences are not kept in memory.
+        * @param input_filenames is a vector of strings, each string is the name of a FASTA/FASTQ/GFA file.
+        * @param nb_threads is the number of threads that can be used.
+        * @param verbose is a boolean indicating if information messages must be printed during the function execution.
+        * @return a boolean indicating if the k-mers were successfully removed from the graph.
+        */
+        bool removeFromFiles(const vector<string>& input_filenames, const size_t nb_threads = 1, const bool verbose = false);
+
         /** Merge a compacted de Bruijn graph.
         * After merging, all unitigs of o have been added to and compacted with the current compacted de Bruijn graph (this).
         * If the unitigs of o had data of type "MyUnitigData" associated, they have been added to the current compacted
@@ -534,6 +718,21 @@ class CompactedDBG {
         */
         bool merge(const vector<CompactedDBG>& v, const size_t nb_threads = 1, const bool verbose = false);
 
+        /** Merge and clear multiple compacted de Bruijn graphs.
+        * After merging, all unitigs of the compacted de Bruijn graphs have been added to and compacted with the current
+        * compacted de Bruijn graph (this). The graphs of v are first merged pairwise in a tree reduction (log2(v.size()) rounds)
+        * in which disjoint pairs are merged concurrently, each pair by its own group of threads, before the result is merged
+        * in the current graph. The input graphs are cleared as soon as they are merged, which releases their memory. If the
+        * unitigs had data of type "MyUnitigData" associated, they have been added to the current compacted de Bruijn graph
+        * using the functions of the class MyUnitigData which are also present in its base class CCDBG_Data_t<MyUnitigData>.
+        * @param v is a reference on a reference to a vector of compacted de Bruijn graphs to merge. It can be obtained using
+        * std::move(). After merging, the graphs in v are cleared.
+        * @param nb_threads is an integer indicating how many threads can be used during the merging.
+        * @param verbose is a boolean indicating if information messages must be printed during the execution of the function.
+        * @return a boolean indicating if the graphs have been successfully merged.
+        */
+        bool merge(vector<CompactedDBG>&& v, const size_t nb_threads = 1, const bool verbose = false);
+
         /** Create an iterator to the first unitig of the Compacted de Bruijn graph (unitigs are NOT sorted lexicographically).
         * @return an iterator to the first unitig of the graph.
         */
@@ -554,6 +753,43 @@ class CompactedDBG {
         */
         const_iterator end() const;
 
+        /** Create a splittable range containing all the unitigs of the graph (see unitigRange). The graph must not be modified
+        * while the range exists.
+        * @return a range containing all the unitigs of the graph.
+        */
+        range getUnitigRange();
+
+        /** Create a constant splittable range containing all the unitigs of the graph (see unitigRange). The graph must not be
+        * modified while the range exists.
+        * @return a constant range containing all the unitigs of the graph.
+        */
+        const_range getUnitigRange() const;
+
+        /** Call a function on each unitig of the graph, in parallel. The unitigs are split into chunks with about the same number
+        * of k-mers (whether the unitigs are of length k or longer) which are processed by the threads as they become available.
+        * The function is called as f(um) where um is a UnitigMap of a unitig. It can be called concurrently on different unitigs
+        * so it must be thread-safe, but the data of each unitig can be modified safely from um. The graph must not be modified.
+        * \code{.cpp}
+        * CompactedDBG<MyUnitigData> cdbg;
+        * ... // Some more code, cdbg construction
+        * cdbg.parallel_for_each(nb_threads, [](const UnitigMap<MyUnitigData>& um){ um.getData()->annotate(um.referenceUnitigToString()); });
+        * \endcode
+        * @param nb_threads is the number of threads to use.
+        * @param f is the function to call on each unitig.
+        * @return a boolean indicating if the function was called on all the unitigs.
+        */
+        template<typename F>
+        bool parallel_for_each(const size_t nb_threads, F f);
+
+        /** Call a function on each unitig of the graph, in parallel (see CompactedDBG<U, G>::parallel_for_each). The function is
+        * called as f(um) where um is a const_UnitigMap of a unitig.
+        * @param nb_threads is the number of threads to use.
+        * @param f is the function to call on each unitig.
+        * @return a boolean indicating if the function was called on all the unitigs.
+        */
+        template<typename F>
+        bool parallel_for_each(const size_t nb_threads, F f) const;
+
         /** Return the sum of the unitigs length.
         * @return An integer which corresponds to the sum of the unitigs length.
         */
@@ -579,6 +815,78 @@ class CompactedDBG {
         */
         inline int getG() const { return g_; }
 
+        /** Return a boolean indicating if the minimizer index of the graph is sparse (see CompactedDBG<U, G>::setSparseIndex).
+        * @return A boolean indicating if the minimizer index of the graph is sparse.
+        */
+        inline bool isSparseIndex() const { return sparse_index; }
+
+        /** Set the minimizer index of the graph to be sparse or complete. A complete index (default) contains every minimizer
+        * occurrence of every unitig. A sparse index contains, for the unitigs longer than k, only the minimizers of the last k-mer
+        * and of the k-mers which do not contain an already indexed g-mer of the unitig. Each k-mer of a unitig still contains at
+        * least one indexed g-mer. The minimizers which were skipped are recorded in a small Bloom filter and a k-mer which is not
+        * found from its minimizers is searched from all its g-mers (k-g+1 lookups) only if its minimizer is in this filter. The
+        * filter is built by CompactedDBG<U, G>::build and CompactedDBG<U, G>::read: in a graph which was not built or read, every
+        * k-mer not found from its minimizers is searched from all its g-mers. A sparse index is slower to search, mostly for the
+        * k-mers inside the unitigs, and its memory saving is modest: the sampling is fixed (there is no density parameter) and the
+        * index has about 25% fewer entries than a complete index (for example, 483,629 instead of 630,297 entries for a test
+        * graph with k=31 and g=23), not the several-fold reduction of a sampling of every s-th position. The index mode can only
+        * be changed while the graph is empty, for example before CompactedDBG<U, G>::build or CompactedDBG<U, G>::read, and it is
+        * not reset by CompactedDBG<U, G>::clear.
+        * @param sparse is a boolean indicating if the minimizer index must be sparse (true) or complete (false).
+        * @return a boolean indicating if the index mode was set.
+        */
+        bool setSparseIndex(const bool sparse);
+
+        /** Index the k-mers of the unitigs which have an overcrowded minimizer (a minimizer occurring in too many unitigs).
+        * Without this index, such k-mers are searched through a chain of alternative minimizers which is much slower than
+        * a regular search, so searches in repeated and low-complexity regions of the graph are slow. The index is built by
+        * CompactedDBG<U, G>::read and CompactedDBG<U, G>::build. It is rebuilt at the end of the functions modifying the
+        * graph as a whole: add and remove for multiple sequences or k-mers, addFromFiles, removeFromFiles, update, merge,
+        * simplify, popBubbles and their ColoredCDBG<U> counterparts. CompactedDBG<U, G>::add(const string&, const bool) and
+        * CompactedDBG<U, G>::remove(const const_UnitigMap<U, G>&, const bool) discard the index without rebuilding it, since
+        * rebuilding costs a scan of the whole graph: call this function after a series of such calls.
+        * @param nb_threads is the number of threads that can be used to build the index.
+        */
+        void indexOvercrowdedKmers(const size_t nb_threads = 1);
+
+        /** Index the neighbors (predecessors and successors) of all unitigs. Without this index, each iteration over the neighbors
+        * of a unitig (UnitigMap::getPredecessors, UnitigMap::getSuccessors) searches the graph for the 4 possible neighbors of
+        * the unitig. With this index, the neighbors are read from a table storing, for each end of each unitig, the id and the
+        * orientation of the (up to) 4 neighbors. The index is discarded as soon as the graph is modified: call this function
+        * again after modifying the graph.
+        * @param nb_threads is the number of threads that can be used to build the index.
+        */
+        void indexNeighbors(const size_t nb_threads = 1);
+
+        /** Return a boolean indicating if the neighbors of the unitigs are indexed (see CompactedDBG<U, G>::indexNeighbors).
+        * @return a boolean indicating if the neighbors of the unitigs are indexed.
+        */
+        inline bool isNeighborIndexed() const { return neighbors_indexed; }
+
+        /** Compute statistics of the graph (see CDBG_Stats): number of unitigs and k-mers, length distribution and N50,
+        * degree histogram, connected components, tips and simple bubbles. The unitigs are processed in parallel and the
+        * connected components are computed with a lock-free union-find over the unitigs, merging each unitig with its
+        * neighbors. The neighbors are read from the neighbor index if it exists (see CompactedDBG<U, G>::indexNeighbors).
+        * @param stats is a CDBG_Stats object in which the statistics are stored.
+        * @param nb_threads is the number of threads that can be used to compute the statistics.
+        * @return a boolean indicating if the statistics were computed successfully.
+        */
+        bool getStats(CDBG_Stats& stats, const size_t nb_threads = 1) const;
+
+        /** Estimate the length g of minimizers giving the best trade-off between memory and search speed for the k-mers
+        * of input files. The estimation uses a sample made of the first DEFAULT_G_SAMPLE_NB_BASES bases of the input files.
+        * For each candidate length (every other length from k-2 down to k/2), the numbers of distinct k-mers, of distinct
+        * minimizers and of super k-mers of the sample are estimated with the streaming counters of KmerStream. These counts
+        * are extrapolated to the size of the input files to predict the memory of the minimizer index and its average bucket
+        * occupancy (number of unitig positions to check per k-mer lookup). The length minimizing the product of the two is
+        * returned. The graph is not modified: the estimation can be used with a graph constructor or CDBG_Build_opt::auto_g.
+        * @param input_filenames is a vector of FASTA/FASTQ/GFA filenames (the same as for CompactedDBG<U, G>::build).
+        * @param nb_threads is the number of threads that can be used to evaluate the candidate lengths.
+        * @param verbose is a boolean indicating if information messages must be printed during the execution of the function.
+        * @return the estimated length of minimizers, or -1 if the estimation failed.
+        */
+        int estimateMinimizerLength(const vector<string>& input_filenames, const size_t nb_threads = 1, const bool verbose = false) const;
+
         /** Return the number of unitigs in the graph.
         * @return Number of unitigs in the graph.
         */
@@ -610,9 +918,25 @@ class CompactedDBG {
             return joinUnitigs_<is_void<U>::value>(v_joins, nb_threads);
         }
 
+        BlockedBloomFilter createUniqueKmersFilter(const vector<string>& input_filenames, const size_t nb_bits_kmer,
+                                                   const size_t nb_threads, const bool verbose) const;
+        void findNewKmers(const vector<string>& input_filenames, BlockedBloomFilter* bf_uniq, const size_t nb_threads, vector<vector<Kmer>>& v_v_km);
+        size_t insertNewKmers(const vector<vector<Kmer>>& v_v_km, const size_t nb_threads, const bool verbose);
+        size_t joinTips(BlockedBloomFilter& bf_uniq_km, const size_t nb_threads = 1, const bool verbose = false);
+
         bool mergeData(const CompactedDBG<U, G>& o, const size_t nb_threads = 1, const bool verbose = false);
         bool mergeData(CompactedDBG<U, G>&& o, const size_t nb_threads = 1, const bool verbose = false);
 
+        // Rebuild the index of overcrowded k-mers if a modification of the graph discarded it
+        inline void reindexOvercrowdedKmers(const size_t nb_threads = 1) {
+
+            if (!invalid && !overcrowded_kmers_indexed) indexOvercrowdedKmers(nb_threads);
+        }
+
+        template<typename Graph, typename MergeFunction>
+        static size_t mergeTree(vector<Graph>& v, const size_t nb_threads, const bool keep_order,
+                                const bool verbose, MergeFunction merge_pair);
+
     private:
 
         CompactedDBG<U, G>& toDataGraph(CompactedDBG<void, void>&& o, const size_t nb_threads = 1);
@@ -626,16 +950,78 @@ class CompactedDBG {
         bool bwStepBBF(const Kmer km, Kmer& front, char& c, bool& has_no_neighbor, vector<Kmer>& l_ignored_km_tip, const bool check_fp_cand = true) const;
         bool fwStepBBF(const Kmer km, Kmer& end, char& c, bool& has_no_neighbor, vector<Kmer>& l_ignored_km_tip, const bool check_fp_cand = true) const;
 
-        inline size_t find(const preAllocMinHashIterator<RepHash>& it_min_h) const {
+        inline size_t find(const preAllocMinHashIterator<MinimizerOrderHash>& it_min_h) const {
 
             const int pos = it_min_h.getPosition();
-            return (hmap_min_unitigs.find(Minimizer(it_min_h.s + pos).rep()) != hmap_min_unitigs.end() ? 0 : pos - it_min_h.p);
+            return (sparse_index || (hmap_min_unitigs.find(Minimizer(it_min_h.s + pos).rep()) != hmap_min_unitigs.end()) ? 0 : pos - it_min_h.p);
+        }
+
+        UnitigMap<U, G> find(const char* s, const size_t pos_km, const minHashIterator<MinimizerOrderHash>& it_min, const bool extremities_only = false);
+        const_UnitigMap<U, G> find(const char* s, const size_t pos_km, const minHashIterator<MinimizerOrderHash>& it_min, const bool extremities_only = false) const;
+
+        UnitigMap<U, G> find(const Kmer& km, const preAllocMinHashIterator<MinimizerOrderHash>& it_min_h);
+
+        UnitigMap<U, G> findSparse(const Kmer& km, const bool extremities_only);
+        const_UnitigMap<U, G> findSparse(const Kmer& km, const bool extremities_only) const;
+        size_t findSparse(  const Kmer (&km)[4], const bool (&search)[4], const int pos_diff, const size_t limit,
+                            const bool extremities_only, const_UnitigMap<U, G> (&um)[4]) const;
+
+        // With a sparse index, a k-mer not found from its minimizer can only be in a unitig longer than k whose sampling skipped this
+        // minimizer: return false if the minimizer minz (hash min_h) was never skipped, true if it was or if it might have been
+        inline bool isSparseSkipped(const Minimizer& minz, const uint64_t min_h) const {
+
+            return (bf_sparse_skipped.getNbBlocks() == 0) || bf_sparse_skipped.contains(minz.rep().hash(), min_h);
+        }
+
+        void setSparseSkipped(const char* s, const vector<minHashResult>& v_min, const bool multi_threaded = false);
+        void initSparseSkipped(const size_t nb_minimizers);
+
+        UnitigMap<U, G> findOvercrowded(const Kmer& km, const bool extremities_only);
+        const_UnitigMap<U, G> findOvercrowded(const Kmer& km, const bool extremities_only) const;
+
+        inline void clearOvercrowdedKmers() {
+
+            if (overcrowded_kmers_indexed){
+
+                h_kmers_overcrowded.clear_tables();
+                overcrowded_kmers_indexed = false;
+            }
+        }
+
+        inline size_t getNeighborRow(const size_t pos_unitig, const bool isShort, const bool isAbundant) const {
+
+            if (isShort) return v_unitigs.size() + pos_unitig;
+            if (isAbundant) return v_unitigs.size() + km_unitigs.size() + pos_unitig;
+
+            return pos_unitig;
+        }
+
+        // Number of rows of the neighbor index, i.e, one more than the largest row returned by getNeighborRow()
+        inline size_t getNbNeighborRows() const {
+
+            size_t nb_rows = v_unitigs.size() + km_unitigs.size();
+
+            // Abundant unitigs are identified by their slot in h_kmers_ccov
+            for (typename h_kmers_ccov_t::const_iterator it = h_kmers_ccov.begin(); it != h_kmers_ccov.end(); ++it) {
+
+                nb_rows = max(nb_rows, v_unitigs.size() + km_unitigs.size() + it.getHash() + 1);
+            }
+
+            return nb_rows;
         }
 
-        UnitigMap<U, G> find(const char* s, const size_t pos_km, const minHashIterator<RepHash>& it_min, const bool extremities_only = false);
-        const_UnitigMap<U, G> find(const char* s, const size_t pos_km, const minHashIterator<RepHash>& it_min, const bool extremities_only = false) const;
+        const_UnitigMap<U, G> getIndexedNeighbor(const size_t row, const bool strand, const bool is_forward, const int i) const;
 
-        UnitigMap<U, G> find(const Kmer& km, const preAllocMinHashIterator<RepHash>& it_min_h);
+        inline void clearNeighbors() {
+
+            if (neighbors_indexed){
+
+                vector<uint32_t>().swap(v_neighbors_id);
+                vector<uint32_t>().swap(v_neighbors_info);
+
+                neighbors_indexed = false;
+            }
+        }
 
         //vector<const_UnitigMap<U, G>> find(const Minimizer& minz) const;
 
@@ -646,10 +1032,10 @@ class CompactedDBG {
         vector<UnitigMap<U, G>> findSuccessors(const Kmer& km, const size_t limit = 4, const bool extremities_only = false);
 
         UnitigMap<U, G> findUnitig(const Kmer& km, const char* s, const size_t pos);
-        UnitigMap<U, G> findUnitig(const Kmer& km, const char* s, const size_t pos, const preAllocMinHashIterator<RepHash>& it_min_h);
+        UnitigMap<U, G> findUnitig(const Kmer& km, const char* s, const size_t pos, const preAllocMinHashIterator<MinimizerOrderHash>& it_min_h);
 
-        UnitigMap<U, G> findUnitig(const char* s, const size_t pos, const size_t len, const minHashIterator<RepHash>& it_min);
-        const_UnitigMap<U, G> findUnitig(const char* s, const size_t pos, const size_t len, const minHashIterator<RepHash>& it_min) const;
+        UnitigMap<U, G> findUnitig(const char* s, const size_t pos, const size_t len, const minHashIterator<MinimizerOrderHash>& it_min);
+        const_UnitigMap<U, G> findUnitig(const char* s, const size_t pos, const size_t len, const minHashIterator<MinimizerOrderHash>& it_min) const;
 
         bool addUnitig(const string& str_unitig, const size_t id_unitig);
         bool addUnitig(const string& str_unitig, const size_t id_unitig, const size_t id_unitig_r, const size_t is_short_r);
@@ -658,6 +1044,10 @@ class CompactedDBG {
 
         bool mergeUnitig(const string& seq, const bool verbose = false);
         bool annotateSplitUnitig(const string& seq, const bool verbose = false);
+
+        void findNewKmers(const string& seq, vector<Kmer>& v_km, BlockedBloomFilter* bf_uniq = nullptr, const bool multi_threaded = false);
+        bool addNewKmers(const vector<vector<Kmer>>& v_v_km, const size_t nb_threads, const bool verbose, BlockedBloomFilter* bf_mercy = nullptr);
+        bool removeMarkedKmers(const vector<vector<Kmer>>& v_v_km_bound, const size_t nb_threads, const bool verbose);
         bool annotateSplitUnitig(const string& seq, LockGraph& lck_g, const bool verbose = false);
 
         template<bool is_void>
@@ -737,6 +1127,9 @@ class CompactedDBG {
         int g_;
 
         bool invalid;
+        bool sparse_index;
+        bool overcrowded_kmers_indexed;
+        bool neighbors_indexed;
 
         static const int tiny_vector_sz = 2;
         static const int min_abundance_lim = 15;
@@ -749,8 +1142,21 @@ class CompactedDBG {
         KmerCovIndex<U> km_unitigs;
         MinimizerIndex hmap_min_unitigs;
 
+        // Sparse index only: minimizers of the k-mers of unitigs longer than k which were skipped by the sampling. A k-mer
+        // not found from its minimizers is searched from its other g-mers only if its minimizer is in this filter. If the
+        // filter is empty, the skipped minimizers were not recorded since the graph was empty and all k-mers are searched.
+        BlockedBloomFilter bf_sparse_skipped;
+
         h_kmers_ccov_t h_kmers_ccov;
 
+        // K-mers of the unitigs longer than k with an overcrowded minimizer: <unitig id (32 bits), is not canonical (1 bit), position (31 bits)>
+        KmerHashTable<uint64_t> h_kmers_overcrowded;
+
+        // Neighbor index: 8 ids per unitig (4 predecessors of the head, 4 successors of the tail) and 8 x 3 bits of info per
+        // unitig (2 bits for the unitig type: 0 = no neighbor, 1 = long, 2 = short, 3 = abundant, 1 bit for the strand)
+        vector<uint32_t> v_neighbors_id;
+        vector<uint32_t> v_neighbors_info;
+
         BlockedBloomFilter bf;
 
         wrapperData<G> data;
@@ -21,16 +21,18 @@ static const uint8_t bits[256] = {
 };
 
 template<typename U, typename G>
-CompactedDBG<U, G>::CompactedDBG(const int kmer_length, const int minimizer_length) : invalid(false) {
+CompactedDBG<U, G>::CompactedDBG(const int kmer_length, const int minimizer_length) : invalid(false), sparse_index(false), overcrowded_kmers_indexed(false), neighbors_indexed(false) {
 
     setKmerGmerLength(kmer_length, minimizer_length);
 }
 
 template<typename U, typename G>
-CompactedDBG<U, G>::CompactedDBG(const CompactedDBG<U, G>& o) : k_(o.k_), g_(o.g_), invalid(o.invalid),
+CompactedDBG<U, G>::CompactedDBG(const CompactedDBG<U, G>& o) : k_(o.k_), g_(o.g_), invalid(o.invalid), sparse_index(o.sparse_index),
+                                                                overcrowded_kmers_indexed(o.overcrowded_kmers_indexed), neighbors_indexed(o.neighbors_indexed),
                                                                 bf(o.bf), km_unitigs(o.km_unitigs), v_unitigs(o.v_unitigs.size(), nullptr),
-                                                                data(o.data), h_kmers_ccov(o.h_kmers_ccov),
-                                                                hmap_min_unitigs(o.hmap_min_unitigs){
+                                                                data(o.data), h_kmers_ccov(o.h_kmers_ccov), h_kmers_overcrowded(o.h_kmers_overcrowded),
+                                                                v_neighbors_id(o.v_neighbors_id), v_neighbors_info(o.v_neighbors_info),
+                                                                hmap_min_unitigs(o.hmap_min_unitigs), bf_sparse_skipped(o.bf_sparse_skipped){
 
     for (size_t i = 0; i < o.v_unitigs.size(); ++i){
 
@@ -40,10 +42,13 @@ CompactedDBG<U, G>::CompactedDBG(const CompactedDBG<U, G>& o) : k_(o.k_), g_(o.g
 }
 
 template<typename U, typename G>
-CompactedDBG<U, G>::CompactedDBG(CompactedDBG<U, G>&& o) :  k_(o.k_), g_(o.g_), invalid(o.invalid),
+CompactedDBG<U, G>::CompactedDBG(CompactedDBG<U, G>&& o) :  k_(o.k_), g_(o.g_), invalid(o.invalid), sparse_index(o.sparse_index),
+                                                            overcrowded_kmers_indexed(o.overcrowded_kmers_indexed), neighbors_indexed(o.neighbors_indexed),
                                                             bf(std::move(o.bf)), km_unitigs(std::move(o.km_unitigs)), data(std::move(o.data)),
                                                             v_unitigs(std::move(o.v_unitigs)), h_kmers_ccov(std::move(o.h_kmers_ccov)),
-                                                            hmap_min_unitigs(std::move(o.hmap_min_unitigs)){
+                                                            h_kmers_overcrowded(std::move(o.h_kmers_overcrowded)),
+                                                            v_neighbors_id(std::move(o.v_neighbors_id)), v_neighbors_info(std::move(o.v_neighbors_info)),
+                                                            hmap_min_unitigs(std::move(o.hmap_min_unitigs)), bf_sparse_skipped(std::move(o.bf_sparse_skipped)){
 
     o.clear();
 }
@@ -63,11 +68,19 @@ CompactedDBG<U, G>& CompactedDBG<U, G>::operator=(const CompactedDBG<U, G>& o){
     g_ = o.g_;
 
     invalid = o.invalid;
+    sparse_index = o.sparse_index;
+    overcrowded_kmers_indexed = o.overcrowded_kmers_indexed;
+    neighbors_indexed = o.neighbors_indexed;
 
     km_unitigs = o.km_unitigs;
 
     h_kmers_ccov = o.h_kmers_ccov;
+    h_kmers_overcrowded = o.h_kmers_overcrowded;
+
+    v_neighbors_id = o.v_neighbors_id;
+    v_neighbors_info = o.v_neighbors_info;
     hmap_min_unitigs = o.hmap_min_unitigs;
+    bf_sparse_skipped = o.bf_sparse_skipped;
 
     bf = o.bf;
 
@@ -92,10 +105,12 @@ CompactedDBG<U, G>& CompactedDBG<U, G>::toDataGraph(CompactedDBG<void, void>&& o
     k_ = o.k_;
     g_ = o.g_;
     invalid = o.invalid;
+    sparse_index = o.sparse_index;
 
     km_unitigs.toData(std::move(o.km_unitigs), nb_threads);
 
     hmap_min_unitigs = std::move(o.hmap_min_unitigs);
+    bf_sparse_skipped = std::move(o.bf_sparse_skipped);
     bf = std::move(o.bf);
 
     data = wrapperData<G>();
@@ -169,12 +184,20 @@ CompactedDBG<U, G>& CompactedDBG<U, G>::operator=(CompactedDBG<U, G>&& o){
         g_ = o.g_;
 
         invalid = o.invalid;
+        sparse_index = o.sparse_index;
+        overcrowded_kmers_indexed = o.overcrowded_kmers_indexed;
+        neighbors_indexed = o.neighbors_indexed;
 
         km_unitigs = std::move(o.km_unitigs);
         v_unitigs = std::move(o.v_unitigs);
 
         h_kmers_ccov = std::move(o.h_kmers_ccov);
+        h_kmers_overcrowded = std::move(o.h_kmers_overcrowded);
+
+        v_neighbors_id = std::move(o.v_neighbors_id);
+        v_neighbors_info = std::move(o.v_neighbors_info);
         hmap_min_unitigs = std::move(o.hmap_min_unitigs);
+        bf_sparse_skipped = std::move(o.bf_sparse_skipped);
 
         bf = std::move(o.bf);
 
@@ -235,12 +258,16 @@ void CompactedDBG<U, G>::clear(){
 
     invalid = true;
 
+    clearOvercrowdedKmers();
+    clearNeighbors();
+
     for (auto unitig : v_unitigs) delete unitig;
 
     v_unitigs.clear();
     km_unitigs.clear();
     hmap_min_unitigs.clear();
     h_kmers_ccov.clear();
+    bf_sparse_skipped.clear();
     bf.clear();
 }
 
@@ -609,6 +636,19 @@ bool CompactedDBG<U, G>::build(CDBG_Build_opt& opt){
     g_ = g_cpy;
     invalid = invalid_cpy;
 
+    if (construct_finished && opt.auto_g){
+
+        vector<string> v_files(opt.filename_ref_in);
+
+        v_files.insert(v_files.end(), opt.filename_seq_in.begin(), opt.filename_seq_in.end());
+
+        const int g = estimateMinimizerLength(v_files, opt.nb_threads, opt.verbose);
+
+        if (g > 0) setKmerGmerLength(k_, g);
+
+        construct_finished = !invalid;
+    }
+
     if (construct_finished){
 
         if ((opt.filename_seq_in.size() != 0) && (opt.filename_ref_in.size() != 0)){
@@ -622,6 +662,9 @@ bool CompactedDBG<U, G>::build(CDBG_Build_opt& opt){
             opt_seq.filename_ref_in.clear();
             opt_ref.filename_seq_in.clear();
 
+            opt_seq.auto_g = false;
+            opt_ref.auto_g = false;
+
             construct_finished = graph_seq.build(opt_seq);
 
             if (construct_finished) construct_finished = graph_ref.build(opt_ref);
@@ -648,7 +691,11 @@ bool CompactedDBG<U, G>::build(CDBG_Build_opt& opt){
 
             CompactedDBG<void, void> graph(k_, g_);
 
-            construct_finished = graph.build(opt);
+            CDBG_Build_opt opt_void(opt);
+
+            opt_void.auto_g = false;
+
+            construct_finished = graph.build(opt_void);
 
             if (construct_finished) toDataGraph(std::move(graph), opt.nb_threads);
         }
@@ -738,6 +785,8 @@ bool CompactedDBG<U, G>::build(CDBG_Build_opt& opt){
         }
     }
 
+    if (construct_finished) reindexOvercrowdedKmers(opt.nb_threads);
+
     return construct_finished;
 }
 
@@ -769,8 +818,300 @@ bool CompactedDBG<U, G>::simplify(const bool delete_short_isolated_unitigs, cons
             cout << "CompactedDBG::simplify(): Removed " << removed << " unitigs" << endl;
             cout << "CompactedDBG::simplify(): Joined " << joined << " unitigs" << endl;
         }
+
+        reindexOvercrowdedKmers();
+    }
+
+    return true;
+}
+
+template<typename U, typename G>
+bool CompactedDBG<U, G>::popBubbles(const vector<string>& input_filenames, const double ratio_cov, const size_t nb_threads, const bool verbose){
+
+    if (invalid){
+
+        cerr << "CompactedDBG::popBubbles(): Graph is invalid and cannot be simplified" << endl;
+        return false;
+    }
+
+    if (nb_threads == 0){
+
+        cerr << "CompactedDBG::popBubbles(): Number of threads cannot be less than or equal to 0" << endl;
+        return false;
+    }
+
+    if (input_filenames.size() == 0){
+
+        cerr << "CompactedDBG::popBubbles(): Missing input files" << endl;
+        return false;
+    }
+
+    if ((ratio_cov < 0.0) || (ratio_cov > 1.0)){
+
+        cerr << "CompactedDBG::popBubbles(): Ratio of coverage cannot be less than 0.0 or more than 1.0" << endl;
+        return false;
+    }
+
+    if (verbose) cout << endl << "CompactedDBG::popBubbles(): Detecting bubbles" << endl;
+
+    struct Branch {
+
+        pair<uint64_t, uint64_t> key; // (predecessor, successor) of the branch, identical for all branches of a bubble
+
+        size_t pos_unitig;
+        bool isShort;
+        bool isAbundant;
+
+        Kmer head, tail;
+        size_t nb_km;
+
+        bool operator<(const Branch& o) const { return key < o.key; }
+    };
+
+    vector<Branch> v_branches;
+
+    // Detect the branches of simple bubbles in parallel
+    {
+        const CompactedDBG<U, G>& cdbg = *this;
+
+        const vector<const_range> v_r = cdbg.getUnitigRange().split(nb_threads * 16);
+
+        vector<vector<Branch>> v_l_branches(nb_threads);
+
+        atomic<size_t> next_r(0);
+
+        auto worker_function = [&](const size_t t){
+
+            for (size_t i = next_r++; i < v_r.size(); i = next_r++){
+
+                for (const auto& um : v_r[i]){
+
+                    if (um.size >= 2 * k_) continue;
+
+                    uint64_t pred = 0, succ = 0;
+                    size_t nb_pred = 0, nb_succ = 0;
+
+                    for (const auto& um_pred : um.getPredecessors()){
+
+                        pred = (static_cast<uint64_t>(getNeighborRow(um_pred.pos_unitig, um_pred.isShort, um_pred.isAbundant)) << 1);
+                        pred |= static_cast<uint64_t>(um_pred.strand);
+
+                        if (++nb_pred > 1) break;
+                    }
+
+                    if (nb_pred != 1) continue;
+
+                    for (const auto& um_succ : um.getSuccessors()){
+
+                        succ = (static_cast<uint64_t>(getNeighborRow(um_succ.pos_unitig, um_succ.isShort, um_succ.isAbundant)) << 1);
+                        succ |= static_cast<uint64_t>(um_succ.strand);
+
+                        if (++nb_succ > 1) break;
+                    }
+
+                    if (nb_succ != 1) continue;
+
+                    // On the reverse-complement of the unitig, the predecessor is the reverse-complemented successor and conversely
+                    const pair<uint64_t, uint64_t> p_fw(pred, succ), p_rev(succ ^ 0x1, pred ^ 0x1);
+
+                    Branch b;
+
+                    b.key = min(p_fw, p_rev);
+                    b.pos_unitig = um.pos_unitig;
+                    b.isShort = um.isShort;
+                    b.isAbundant = um.isAbundant;
+                    b.head = um.getUnitigHead();
+                    b.tail = um.getUnitigTail();
+                    b.nb_km = um.size - k_ + 1;
+
+                    v_l_branches[t].push_back(b);
+                }
+            }
+        };
+
+        if (nb_threads == 1) worker_function(0);
+        else {
+
+            vector<thread> workers;
+
+            for (size_t t = 0; t < nb_threads; ++t) workers.emplace_back(worker_function, t);
+            for (auto& t : workers) t.join();
+        }
+
+        for (const auto& v : v_l_branches) v_branches.insert(v_branches.end(), v.begin(), v.end());
+
+        sort(v_branches.begin(), v_branches.end());
+
+        // Keep only the branches sharing their predecessor and successor with another branch
+        size_t nb_branches = 0;
+
+        for (size_t i = 0, j = 0; i < v_branches.size(); i = j){
+
+            while ((j < v_branches.size()) && (v_branches[j].key == v_branches[i].key)) ++j;
+
+            if (j - i >= 2){
+
+                for (size_t l = i; l < j; ++l) v_branches[nb_branches++] = v_branches[l];
+            }
+        }
+
+        v_branches.resize(nb_branches);
+    }
+
+    if (verbose) cout << "CompactedDBG::popBubbles(): Found " << v_branches.size() << " bubble branches" << endl;
+
+    if (v_branches.empty()) return true;
+
+    if (verbose) cout << "CompactedDBG::popBubbles(): Computing coverage of the branches" << endl;
+
+    atomic<size_t>* cov_branches = new atomic<size_t>[v_branches.size()];
+
+    // Count the occurrences of the branch k-mers in the input files
+    {
+        KmerHashTable<size_t> h_km_branches;
+
+        for (size_t i = 0; i < v_branches.size(); ++i){
+
+            const Branch& b = v_branches[i];
+            const const_UnitigMap<U, G> um = find(b.head, true);
+
+            const string unitig_str = um.referenceUnitigToString();
+
+            for (KmerRepIterator it_km(unitig_str.c_str()), it_km_end; it_km != it_km_end; ++it_km) h_km_branches.insert(it_km->first, i);
+
+            cov_branches[i] = 0;
+        }
+
+        const size_t nb_seq_batch = 4096;
+
+        FileParser fp(input_filenames);
+
+        mutex mutex_file;
+
+        auto worker_function = [&]{
+
+            vector<string> v_seq;
+
+            string seq;
+
+            size_t file_id = 0;
+
+            while (true) {
+
+                {
+                    unique_lock<mutex> lock(mutex_file);
+
+                    v_seq.clear();
+
+                    while ((v_seq.size() < nb_seq_batch) && fp.read(seq, file_id)) v_seq.push_back(seq);
+                }
+
+                if (v_seq.empty()) return;
+
+                for (auto& s : v_seq){
+
+                    std::transform(s.begin(), s.end(), s.begin(), ::toupper);
+
+                    for (KmerRepIterator it_km(s.c_str()), it_km_end; it_km != it_km_end; ++it_km) {
+
+                        const KmerHashTable<size_t>::const_iterator it = h_km_branches.find(it_km->first);
+
+                        if (it != h_km_branches.end()) ++cov_branches[*it];
+                    }
+                }
+            }
+        };
+
+        if (nb_threads == 1) worker_function();
+        else {
+
+            vector<thread> workers;
+
+            for (size_t t = 0; t < nb_threads; ++t) workers.emplace_back(worker_function);
+            for (auto& t : workers) t.join();
+        }
+
+        fp.close();
+    }
+
+    vector<Kmer> v_joins;
+
+    vector<size_t> v_rm_long, v_rm_short, v_rm_abundant;
+
+    // In each bubble, select the branches with a low coverage compared to the most covered branch
+    for (size_t i = 0, j = 0; i < v_branches.size(); i = j){
+
+        double max_cov = 0;
+
+        while ((j < v_branches.size()) && (v_branches[j].key == v_branches[i].key)){
+
+            max_cov = max(max_cov, static_cast<double>(cov_branches[j]) / v_branches[j].nb_km);
+            ++j;
+        }
+
+        for (size_t l = i; l < j; ++l){
+
+            const Branch& b = v_branches[l];
+
+            if (static_cast<double>(cov_branches[l]) / b.nb_km < ratio_cov * max_cov){
+
+                if (b.isShort) v_rm_short.push_back(b.pos_unitig);
+                else if (b.isAbundant) v_rm_abundant.push_back(b.pos_unitig);
+                else v_rm_long.push_back(b.pos_unitig);
+
+                // Predecessor and successor of the branch might be joined once the branch is removed
+                for (size_t c = 0; c < 4; ++c){
+
+                    const Kmer km_pred = b.head.backwardBase(alpha[c]);
+                    const Kmer km_succ = b.tail.forwardBase(alpha[c]);
+
+                    if (!find(km_pred, true).isEmpty) v_joins.push_back(km_pred);
+                    if (!find(km_succ, true).isEmpty) v_joins.push_back(km_succ);
+                }
+            }
+        }
+    }
+
+    delete[] cov_branches;
+
+    const size_t removed = v_rm_long.size() + v_rm_short.size() + v_rm_abundant.size();
+
+    // Unitigs are removed from the end of their storage so that the ids of the unitigs left to remove remain valid
+    sort(v_rm_long.begin(), v_rm_long.end(), greater<size_t>());
+    sort(v_rm_short.begin(), v_rm_short.end(), greater<size_t>());
+
+    size_t v_unitigs_sz = v_unitigs.size();
+    size_t v_kmers_sz = km_unitigs.size();
+
+    for (const size_t id : v_rm_long){
+
+        if (id != --v_unitigs_sz) swapUnitigs(false, id, v_unitigs_sz);
+    }
+
+    for (const size_t id : v_rm_short){
+
+        if (id != --v_kmers_sz) swapUnitigs(true, id, v_kmers_sz);
+    }
+
+    for (size_t i = v_unitigs_sz; i < v_unitigs.size(); ++i) deleteUnitig_<is_void<U>::value>(false, false, i);
+    v_unitigs.resize(v_unitigs_sz);
+
+    for (size_t i = v_kmers_sz; i < km_unitigs.size(); ++i) deleteUnitig_<is_void<U>::value>(true, false, i);
+    km_unitigs.resize(v_kmers_sz);
+
+    for (const size_t id : v_rm_abundant) deleteUnitig_<is_void<U>::value>(false, true, id);
+
+    const size_t joined = (removed != 0) ? joinUnitigs_<is_void<U>::value>(&v_joins, nb_threads) : 0;
+
+    if (verbose){
+
+        cout << "CompactedDBG::popBubbles(): After: " << size() << " unitigs" << endl;
+        cout << "CompactedDBG::popBubbles(): Removed " << removed << " unitigs" << endl;
+        cout << "CompactedDBG::popBubbles(): Joined " << joined << " unitigs" << endl;
     }
 
+    reindexOvercrowdedKmers(nb_threads);
+
     return true;
 }
 
@@ -879,6 +1220,11 @@ bool CompactedDBG<U, G>::read(const string& input_filename, const size_t nb_thre
 
             if (tag == "KL:Z:") k = atoi(sub.c_str() + 5);
             else if (tag == "ML:Z:") g = atoi(sub.c_str() + 5);
+            else if ((tag == "MO:Z:") && verbose && (sub.substr(5) != MINIMIZER_ORDER_NAME)) {
+
+                cout << "CompactedDBG::read(): Graph was built with the " << sub.substr(5) << " minimizer order, the minimizer index " <<
+                "is rebuilt with the " << MINIMIZER_ORDER_NAME << " order" << endl;
+            }
         }
 
         clear();
@@ -898,11 +1244,14 @@ bool CompactedDBG<U, G>::read(const string& input_filename, const size_t nb_thre
 
             MinimizerIndex hmap_min_unitigs_tmp(max(1UL, kms.MinimizerF0()) * 1.05);
             hmap_min_unitigs = std::move(hmap_min_unitigs_tmp);
+
+            initSparseSkipped(max(1UL, kms.MinimizerF0()));
         }
 
         setKmerGmerLength(k, g);
 
         if (!invalid) readGFA(input_filename, nb_threads);
+        if (!invalid) indexOvercrowdedKmers(nb_threads);
 
         if (verbose) cout << endl << "CompactedDBG::read(): Finished reading graph from disk" << endl;
 
@@ -931,6 +1280,8 @@ bool CompactedDBG<U, G>::read(const string& input_filename, const size_t nb_thre
             MinimizerIndex hmap_min_unitigs_tmp(max(1UL, kms.MinimizerF0()) * 1.05);
 
             hmap_min_unitigs = std::move(hmap_min_unitigs_tmp);
+
+            initSparseSkipped(max(1UL, kms.MinimizerF0()));
         }
 
         setKmerGmerLength(k, g);
@@ -944,13 +1295,15 @@ bool CompactedDBG<U, G>::read(const string& input_filename, const size_t nb_thre
 
     invalid = false;
 
+    indexOvercrowdedKmers(nb_threads);
+
     if (verbose) cout << endl << "CompactedDBG::read(): Finished reading graph from disk" << endl;
 
     return true;
 }
 
 template<typename U, typename G>
-const_UnitigMap<U, G> CompactedDBG<U, G>::find(const char* s, const size_t pos_km, const minHashIterator<RepHash>& it_min, const bool extremities_only) const {
+const_UnitigMap<U, G> CompactedDBG<U, G>::find(const char* s, const size_t pos_km, const minHashIterator<MinimizerOrderHash>& it_min, const bool extremities_only) const {
 
     if (invalid){
 
@@ -970,7 +1323,7 @@ const_UnitigMap<U, G> CompactedDBG<U, G>::find(const char* s, const size_t pos_k
 
     const int diff = k_ - g_;
 
-    minHashResultIterator<RepHash> it_it_min = *it_min, it_it_min_end;
+    minHashResultIterator<MinimizerOrderHash> it_it_min = *it_min, it_it_min_end;
     minHashResult mhr, mhr_tmp;
 
     while (it_it_min != it_it_min_end){
@@ -1006,6 +1359,8 @@ const_UnitigMap<U, G> CompactedDBG<U, G>::find(const char* s, const size_t pos_k
 
                     if ((unitig_id_pos & MASK_CONTIG_TYPE) == MASK_CONTIG_TYPE){ //This minimizer is unitig overcrowded
 
+                        if (overcrowded_kmers_indexed) return findOvercrowded(km, extremities_only);
+
                         mhr_tmp = it_min.getNewMin(mhr);
 
                         if (mhr_tmp.hash != mhr.hash){
@@ -1069,11 +1424,11 @@ const_UnitigMap<U, G> CompactedDBG<U, G>::find(const char* s, const size_t pos_k
         ++it_it_min;
     }
 
-    return const_UnitigMap<U, G>();
+    return (sparse_index && isSparseSkipped(Minimizer(s + it_min.getPosition()), it_min.getHash())) ? findSparse(km, extremities_only) : const_UnitigMap<U, G>();
 }
 
 template<typename U, typename G>
-UnitigMap<U, G> CompactedDBG<U, G>::find(const char* s, const size_t pos_km, const minHashIterator<RepHash>& it_min, const bool extremities_only) {
+UnitigMap<U, G> CompactedDBG<U, G>::find(const char* s, const size_t pos_km, const minHashIterator<MinimizerOrderHash>& it_min, const bool extremities_only) {
 
     if (invalid){
 
@@ -1093,7 +1448,7 @@ UnitigMap<U, G> CompactedDBG<U, G>::find(const char* s, const size_t pos_km, con
 
     const int diff = k_ - g_;
 
-    minHashResultIterator<RepHash> it_it_min = *it_min, it_it_min_end;
+    minHashResultIterator<MinimizerOrderHash> it_it_min = *it_min, it_it_min_end;
     minHashResult mhr, mhr_tmp;
 
     while (it_it_min != it_it_min_end){
@@ -1129,6 +1484,8 @@ UnitigMap<U, G> CompactedDBG<U, G>::find(const char* s, const size_t pos_km, con
 
                     if ((unitig_id_pos & MASK_CONTIG_TYPE) == MASK_CONTIG_TYPE){ //This minimizer is unitig overcrowded
 
+                        if (overcrowded_kmers_indexed) return findOvercrowded(km, extremities_only);
+
                         mhr_tmp = it_min.getNewMin(mhr);
 
                         if (mhr_tmp.hash != mhr.hash){
@@ -1192,7 +1549,7 @@ UnitigMap<U, G> CompactedDBG<U, G>::find(const char* s, const size_t pos_km, con
         ++it_it_min;
     }
 
-    return UnitigMap<U, G>();
+    return (sparse_index && isSparseSkipped(Minimizer(s + it_min.getPosition()), it_min.getHash())) ? findSparse(km, extremities_only) : UnitigMap<U, G>();
 }
 
 template<typename U, typename G>
@@ -1215,15 +1572,15 @@ const_UnitigMap<U, G> CompactedDBG<U, G>::find(const Kmer& km, const bool extrem
 
     const int diff = k_ - g_;
 
-    char km_tmp[MAX_KMER_SIZE];
-    km.toString(km_tmp); // Set k-mer to look-up in string version
+    minHashKmer<MinimizerOrderHash> it_min(km, k_, g_, MinimizerOrderHash(), true), it_min2, it_min_end;
 
-    minHashKmer<RepHash> it_min(km_tmp, k_, g_, RepHash(), true), it_min2, it_min_end;
+    const int min_h_pos_km = it_min.getPosition(); // Minimizer of the k-mer, checked if the k-mer is not found in a sparse index
+    const uint64_t min_h_km = it_min.getHash();
 
     while (it_min != it_min_end){
 
         int mhr_pos = it_min.getPosition();
-        Minimizer minz(Minimizer(km_tmp + mhr_pos).rep());
+        Minimizer minz(Minimizer(km, mhr_pos).rep());
         MinimizerIndex::const_iterator it = hmap_min_unitigs.find(minz);
 
         it_min2 = it_min;
@@ -1252,11 +1609,13 @@ const_UnitigMap<U, G> CompactedDBG<U, G>::find(const Kmer& km, const bool extrem
 
                     if ((unitig_id_pos & MASK_CONTIG_TYPE) == MASK_CONTIG_TYPE){ //This minimizer is unitig overcrowded
 
+                        if (overcrowded_kmers_indexed) return findOvercrowded(km, extremities_only);
+
                         it_min2.getNewMin();
 
                         if (it_min2 != it_min_end){
 
-                            minz = Minimizer(km_tmp + it_min2.getPosition()).rep();
+                            minz = Minimizer(km, it_min2.getPosition()).rep();
                             it = hmap_min_unitigs.find(minz);
                         }
                     }
@@ -1314,7 +1673,7 @@ const_UnitigMap<U, G> CompactedDBG<U, G>::find(const Kmer& km, const bool extrem
         ++it_min;
     }
 
-    return const_UnitigMap<U, G>();
+    return (sparse_index && isSparseSkipped(Minimizer(km, min_h_pos_km), min_h_km)) ? findSparse(km, extremities_only) : const_UnitigMap<U, G>();
 }
 
 /*template<typename U, typename G>
@@ -1365,8 +1724,8 @@ vector<const_UnitigMap<U, G>> CompactedDBG<U, G>::find(const Minimizer& minz) co
                     size_t l_pos_s = 0xffffffffffffffffULL;
                     size_t l_pos_e = 0;
 
-                    minHashIterator<RepHash> mhi_s = minHashIterator<RepHash>(subseq_str, pos_e - pos_s, k_, g_, RepHash(), true), mhi_e;
-                    minHashResultIterator<RepHash> mhrit_s, mhrit_e;
+                    minHashIterator<MinimizerOrderHash> mhi_s = minHashIterator<MinimizerOrderHash>(subseq_str, pos_e - pos_s, k_, g_, MinimizerOrderHash(), true), mhi_e;
+                    minHashResultIterator<MinimizerOrderHash> mhrit_s, mhrit_e;
 
                     while (mhi_s != mhi_e) {
 
@@ -1417,16 +1776,16 @@ UnitigMap<U, G> CompactedDBG<U, G>::find(const Kmer& km, const bool extremities_
 
     const int diff = k_ - g_;
 
-    char km_tmp[MAX_KMER_SIZE];
-    km.toString(km_tmp); // Set k-mer to look-up in string version
+    minHashKmer<MinimizerOrderHash> it_min(km, k_, g_, MinimizerOrderHash(), true), it_min2, it_min_end;
 
-    minHashKmer<RepHash> it_min(km_tmp, k_, g_, RepHash(), true), it_min2, it_min_end;
+    const int min_h_pos_km = it_min.getPosition(); // Minimizer of the k-mer, checked if the k-mer is not found in a sparse index
+    const uint64_t min_h_km = it_min.getHash();
 
     while (it_min != it_min_end){
 
         int mhr_pos = it_min.getPosition();
 
-        Minimizer minz(Minimizer(km_tmp + mhr_pos).rep());
+        Minimizer minz(Minimizer(km, mhr_pos).rep());
         MinimizerIndex::const_iterator it = hmap_min_unitigs.find(minz);
 
         it_min2 = it_min;
@@ -1455,11 +1814,13 @@ UnitigMap<U, G> CompactedDBG<U, G>::find(const Kmer& km, const bool extremities_
 
                     if ((unitig_id_pos & MASK_CONTIG_TYPE) == MASK_CONTIG_TYPE){ //This minimizer is unitig overcrowded
 
+                        if (overcrowded_kmers_indexed) return findOvercrowded(km, extremities_only);
+
                         it_min2.getNewMin();
 
                         if (it_min2 != it_min_end){
 
-                            minz = Minimizer(km_tmp + it_min2.getPosition()).rep();
+                            minz = Minimizer(km, it_min2.getPosition()).rep();
                             it = hmap_min_unitigs.find(minz);
                         }
                     }
@@ -1517,115 +1878,306 @@ UnitigMap<U, G> CompactedDBG<U, G>::find(const Kmer& km, const bool extremities_
         ++it_min;
     }
 
-    return UnitigMap<U, G>();
+    return (sparse_index && isSparseSkipped(Minimizer(km, min_h_pos_km), min_h_km)) ? findSparse(km, extremities_only) : UnitigMap<U, G>();
 }
 
 template<typename U, typename G>
-vector<const_UnitigMap<U, G>> CompactedDBG<U, G>::findPredecessors(const Kmer& km, const bool extremities_only) const {
+const_UnitigMap<U, G> CompactedDBG<U, G>::findSparse(const Kmer& km, const bool extremities_only) const {
 
-    const Kmer km_pred[4] = {km.backwardBase('A'), km.backwardBase('C'), km.backwardBase('G'), km.backwardBase('T')};
-    const Kmer km_rep[4] = {km_pred[0].rep(), km_pred[1].rep(), km_pred[2].rep(), km_pred[3].rep()};
+    // Short and abundant unitigs have all their minimizers indexed, even in a sparse index, so the k-mer is
+    // searched only in the unitigs longer than k. Those have at least one indexed g-mer per k-mer and the
+    // position recorded in the index is the position of that g-mer: every g-mer of the k-mer is looked up.
+    const Kmer km_twin = km.twin();
 
-    const Kmer km_twin_a = km_pred[0].twin();
+    const int diff = k_ - g_;
 
-    bool isShort;
+    for (int min_h_pos = 0; min_h_pos <= diff; ++min_h_pos){
 
-    size_t unitig_id_pos, unitig_id, len;
+        const MinimizerIndex::const_iterator it = hmap_min_unitigs.find(Minimizer(km, min_h_pos).rep());
 
-    int64_t pos_match;
+        if (it == hmap_min_unitigs.end()) continue;
 
-    const int diff = k_ - g_;
+        const packed_tiny_vector& v = it.getVector();
+        const uint8_t flag_v = it.getVectorSize();
+        const int v_sz = v.size(flag_v);
 
-    char km_tmp[MAX_KMER_SIZE];
-    km_pred[0].toString(km_tmp); // Set k-mer to look-up in string version
+        for (int i = 0; i < v_sz; ++i){
 
-    preAllocMinHashIterator<RepHash> it_min(km_tmp, k_, k_, g_, RepHash(), true);
-    preAllocMinHashResultIterator<RepHash> it_it_min = *it_min, it_it_min_end;
+            const size_t unitig_id_pos = v(i, flag_v);
+            const size_t unitig_id = unitig_id_pos >> 32;
 
-    minHashResult mhr, mhr_tmp;
+            if ((unitig_id != RESERVED_ID) && ((unitig_id_pos & MASK_CONTIG_TYPE) == 0)){
 
-    vector<const_UnitigMap<U, G>> v_um(4, const_UnitigMap<U, G>(1, this));
+                const int64_t len = v_unitigs[unitig_id]->length() - k_;
 
-    while (it_it_min != it_it_min_end){
+                int64_t pos_match = (unitig_id_pos & MASK_CONTIG_POS) - min_h_pos;
 
-        const minHashResult& min_h_res = *it_it_min;
-        Minimizer minz(Minimizer(km_tmp + min_h_res.pos).rep());
-        MinimizerIndex::const_iterator it = hmap_min_unitigs.find(minz);
+                if ((pos_match >= 0) && (pos_match <= len) && (!extremities_only || (pos_match == 0) || (pos_match == len)) &&
+                    v_unitigs[unitig_id]->getSeq().compareKmer(pos_match, k_, km)){
 
-        mhr = min_h_res;
+                    return const_UnitigMap<U, G>(unitig_id, pos_match, 1, len + k_, false, false, true, this);
+                }
 
-        while (it != hmap_min_unitigs.end()){ // If the minimizer is found
+                pos_match = (unitig_id_pos & MASK_CONTIG_POS) - diff + min_h_pos;
 
-            const packed_tiny_vector& v = it.getVector();
-            const uint8_t flag_v = it.getVectorSize();
-            const int v_sz = v.size(flag_v);
+                if ((pos_match >= 0) && (pos_match <= len) && (!extremities_only || (pos_match == 0) || (pos_match == len)) &&
+                    v_unitigs[unitig_id]->getSeq().compareKmer(pos_match, k_, km_twin)){
 
-            it = hmap_min_unitigs.end();
+                    return const_UnitigMap<U, G>(unitig_id, pos_match, 1, len + k_, false, false, false, this);
+                }
+            }
+        }
+    }
 
-            for (size_t i = 0; i < v_sz; ++i){
+    return const_UnitigMap<U, G>();
+}
 
-                unitig_id_pos = v(i, flag_v);
-                unitig_id = unitig_id_pos >> 32;
+template<typename U, typename G>
+UnitigMap<U, G> CompactedDBG<U, G>::findSparse(const Kmer& km, const bool extremities_only) {
 
-                if (unitig_id == RESERVED_ID){
+    const const_UnitigMap<U, G> um = static_cast<const CompactedDBG<U, G>*>(this)->findSparse(km, extremities_only);
 
-                    if ((unitig_id_pos & RESERVED_ID) != 0){ //This minimizer has abundant k-mers
+    if (um.isEmpty) return UnitigMap<U, G>();
 
-                        typename h_kmers_ccov_t::const_iterator it_km;
+    return UnitigMap<U, G>(um.pos_unitig, um.dist, um.len, um.size, um.isShort, um.isAbundant, um.strand, this);
+}
 
-                        for (size_t j = 0; j != 4; ++j){
+template<typename U, typename G>
+size_t CompactedDBG<U, G>::findSparse(  const Kmer (&km)[4], const bool (&search)[4], const int pos_diff, const size_t limit,
+                                        const bool extremities_only, const_UnitigMap<U, G> (&um)[4]) const {
 
-                            if ((it_km = h_kmers_ccov.find(km_rep[j])) != h_kmers_ccov.end()){
+    // The 4 k-mers are the predecessors (pos_diff = 0) or the successors (pos_diff = k-g) of a same k-mer so they share all
+    // their g-mers but the one starting at position pos_diff: the shared g-mers are looked up once for all the k-mers.
+    const int diff = k_ - g_;
 
-                                v_um[j].partialCopy(const_UnitigMap<U, G>(it_km.getHash(), 0, 1, k_, false, true, km_pred[j] == km_rep[j], this));
-                            }
-                        }
-                    }
+    const Kmer km_twin[4] = {km[0].twin(), km[1].twin(), km[2].twin(), km[3].twin()};
 
-                    if ((unitig_id_pos & MASK_CONTIG_TYPE) == MASK_CONTIG_TYPE){ //This minimizer is unitig overcrowded
+    size_t nb_found = 0;
 
-                        mhr_tmp = it_min.getNewMin(mhr);
+    for (int min_h_pos = 0; (min_h_pos <= diff) && (nb_found != limit); ++min_h_pos){
 
-                        if (mhr_tmp.hash != mhr.hash){
+        for (size_t i = 0; (i != 4) && (nb_found != limit); ++i){
 
-                            mhr = mhr_tmp;
-                            minz = Minimizer(km_tmp + mhr.pos).rep();
-                            it = hmap_min_unitigs.find(minz);
-                        }
-                    }
-                }
-                else {
+            if (!search[i] || !um[i].isEmpty) continue;
 
-                    isShort = (unitig_id_pos & MASK_CONTIG_TYPE) != 0;
-                    unitig_id_pos &= MASK_CONTIG_POS;
+            const MinimizerIndex::const_iterator it = hmap_min_unitigs.find(Minimizer(km[i], min_h_pos).rep());
 
-                    if (isShort){
+            if (it != hmap_min_unitigs.end()){
 
-                        if ((min_h_res.pos == unitig_id_pos) || (min_h_res.pos == diff - unitig_id_pos)){
+                const packed_tiny_vector& v = it.getVector();
+                const uint8_t flag_v = it.getVectorSize();
+                const int v_sz = v.size(flag_v);
 
-                            const Kmer km_unitig = km_unitigs.getKmer(unitig_id);
+                const size_t j_start = (min_h_pos == pos_diff) ? i : 0;
+                const size_t j_end = (min_h_pos == pos_diff) ? i + 1 : 4;
 
-                            uint8_t idx = bits[km_unitig.getChar(0)];
+                for (int l = 0; (l < v_sz) && (nb_found != limit); ++l){
 
-                            if (km_unitig == km_rep[idx]) {
+                    const size_t unitig_id_pos = v(l, flag_v);
+                    const size_t unitig_id = unitig_id_pos >> 32;
 
-                                v_um[idx].partialCopy(const_UnitigMap<U, G>(unitig_id, 0, 1, k_, true, false, km_pred[idx] == km_rep[idx], this));
-                            }
-                            else {
+                    if ((unitig_id == RESERVED_ID) || ((unitig_id_pos & MASK_CONTIG_TYPE) != 0)) continue;
 
-                                idx = 0x3 - bits[km_unitig.getChar(k_ - 1)];
+                    const int64_t len = v_unitigs[unitig_id]->length() - k_;
+                    const int64_t pos_match_fw = (unitig_id_pos & MASK_CONTIG_POS) - min_h_pos;
+                    const int64_t pos_match_bw = (unitig_id_pos & MASK_CONTIG_POS) - diff + min_h_pos;
 
-                                if (km_unitig == km_rep[idx]) {
+                    for (size_t j = j_start; (j != j_end) && (nb_found != limit); ++j){
 
-                                    v_um[idx].partialCopy(const_UnitigMap<U, G>(unitig_id, 0, 1, k_, true, false, km_pred[idx] == km_rep[idx], this));
-                                }
+                        if (!search[j] || !um[j].isEmpty) continue;
+
+                        if ((pos_match_fw >= 0) && (pos_match_fw <= len) && (!extremities_only || (pos_match_fw == 0) || (pos_match_fw == len)) &&
+                            v_unitigs[unitig_id]->getSeq().compareKmer(pos_match_fw, k_, km[j])){
+
+                            um[j] = const_UnitigMap<U, G>(unitig_id, pos_match_fw, 1, len + k_, false, false, true, this);
+                            ++nb_found;
+                        }
+                        else if ((pos_match_bw >= 0) && (pos_match_bw <= len) && (!extremities_only || (pos_match_bw == 0) || (pos_match_bw == len)) &&
+                                v_unitigs[unitig_id]->getSeq().compareKmer(pos_match_bw, k_, km_twin[j])){
+
+                            um[j] = const_UnitigMap<U, G>(unitig_id, pos_match_bw, 1, len + k_, false, false, false, this);
+                            ++nb_found;
+                        }
+                    }
+                }
+            }
+
+            if (min_h_pos != pos_diff) break; // The g-mer was shared by all the k-mers
+        }
+    }
+
+    return nb_found;
+}
+
+template<typename U, typename G>
+void CompactedDBG<U, G>::setSparseSkipped(const char* s, const vector<minHashResult>& v_min, const bool multi_threaded) {
+
+    if (bf_sparse_skipped.getNbBlocks() == 0) return;
+
+    for (const auto& min_h_res : v_min) bf_sparse_skipped.insert(Minimizer(s + min_h_res.pos).rep().hash(), min_h_res.hash, multi_threaded);
+}
+
+template<typename U, typename G>
+void CompactedDBG<U, G>::initSparseSkipped(const size_t nb_minimizers) {
+
+    // Only a fraction of the minimizers are skipped so a few bits per minimizer of the graph are enough
+    if (sparse_index && (size() == 0)) bf_sparse_skipped = BlockedBloomFilter(nb_minimizers, 4);
+    else bf_sparse_skipped.clear();
+}
+
+template<typename U, typename G>
+const_UnitigMap<U, G> CompactedDBG<U, G>::findOvercrowded(const Kmer& km, const bool extremities_only) const {
+
+    const Kmer km_twin = km.twin();
+    const bool km_is_rep = !(km_twin < km);
+
+    const KmerHashTable<uint64_t>::const_iterator it = h_kmers_overcrowded.find(km_is_rep ? km : km_twin);
+
+    if (it == h_kmers_overcrowded.end()) return const_UnitigMap<U, G>();
+
+    const size_t unitig_id = *it >> 32;
+    const size_t pos = *it & MASK_CONTIG_POS;
+    const size_t len = v_unitigs[unitig_id]->length() - k_;
+
+    if (extremities_only && (pos != 0) && (pos != len)) return const_UnitigMap<U, G>();
+
+    // The k-mer of the unitig is the queried k-mer if both are canonical or both are not
+    return const_UnitigMap<U, G>(unitig_id, pos, 1, len + k_, false, false, km_is_rep == ((*it & MASK_CONTIG_TYPE) == 0), this);
+}
+
+template<typename U, typename G>
+UnitigMap<U, G> CompactedDBG<U, G>::findOvercrowded(const Kmer& km, const bool extremities_only) {
+
+    const const_UnitigMap<U, G> um = static_cast<const CompactedDBG<U, G>*>(this)->findOvercrowded(km, extremities_only);
+
+    if (um.isEmpty) return UnitigMap<U, G>();
+
+    return UnitigMap<U, G>(um.pos_unitig, um.dist, um.len, um.size, um.isShort, um.isAbundant, um.strand, this);
+}
+
+template<typename U, typename G>
+vector<const_UnitigMap<U, G>> CompactedDBG<U, G>::findPredecessors(const Kmer& km, const bool extremities_only) const {
+
+    const Kmer km_pred[4] = {km.backwardBase('A'), km.backwardBase('C'), km.backwardBase('G'), km.backwardBase('T')};
+    const Kmer km_tw = km.twin(); // twin(b + km[0..k-2]) = twin(km)[1..k-1] + twin(b)
+    const Kmer km_pred_tw[4] = {km_tw.forwardBase('T'), km_tw.forwardBase('G'), km_tw.forwardBase('C'), km_tw.forwardBase('A')};
+
+    const Kmer km_rep[4] = {
+        (km_pred_tw[0] < km_pred[0]) ? km_pred_tw[0] : km_pred[0], (km_pred_tw[1] < km_pred[1]) ? km_pred_tw[1] : km_pred[1],
+        (km_pred_tw[2] < km_pred[2]) ? km_pred_tw[2] : km_pred[2], (km_pred_tw[3] < km_pred[3]) ? km_pred_tw[3] : km_pred[3]
+    };
+
+    const Kmer& km_twin_a = km_pred_tw[0];
+
+    bool isShort;
+
+    size_t unitig_id_pos, unitig_id, len;
+
+    int64_t pos_match;
+
+    const int diff = k_ - g_;
+
+    minHashKmer<MinimizerOrderHash> it_min(km_pred[0], k_, g_, MinimizerOrderHash(), true), it_min2, it_min_end;
+
+    const int min_h_pos_km = it_min.getPosition(); // Minimizer of the k-mer, checked if the k-mer is not found in a sparse index
+    const uint64_t min_h_km = it_min.getHash();
+
+    vector<const_UnitigMap<U, G>> v_um(4, const_UnitigMap<U, G>(1, this));
+
+    while (it_min != it_min_end){
+
+        const int min_h_pos = it_min.getPosition();
+        Minimizer minz(Minimizer(km_pred[0], min_h_pos).rep());
+        MinimizerIndex::const_iterator it = hmap_min_unitigs.find(minz);
+
+        it_min2 = it_min;
+
+        while (it != hmap_min_unitigs.end()){ // If the minimizer is found
+
+            const packed_tiny_vector& v = it.getVector();
+            const uint8_t flag_v = it.getVectorSize();
+            const int v_sz = v.size(flag_v);
+
+            it = hmap_min_unitigs.end();
+
+            for (size_t i = 0; i < v_sz; ++i){
+
+                unitig_id_pos = v(i, flag_v);
+                unitig_id = unitig_id_pos >> 32;
+
+                if (unitig_id == RESERVED_ID){
+
+                    if ((unitig_id_pos & RESERVED_ID) != 0){ //This minimizer has abundant k-mers
+
+                        typename h_kmers_ccov_t::const_iterator it_km;
+
+                        for (size_t j = 0; j != 4; ++j){
+
+                            if ((it_km = h_kmers_ccov.find(km_rep[j])) != h_kmers_ccov.end()){
+
+                                v_um[j].partialCopy(const_UnitigMap<U, G>(it_km.getHash(), 0, 1, k_, false, true, km_pred[j] == km_rep[j], this));
+                            }
+                        }
+                    }
+
+                    if ((unitig_id_pos & MASK_CONTIG_TYPE) == MASK_CONTIG_TYPE){ //This minimizer is unitig overcrowded
+
+                        if (overcrowded_kmers_indexed){ // Neighbors not found yet are in the index of overcrowded k-mers, if present
+
+                            for (size_t j = 0; j != 4; ++j){
+
+                                if (v_um[j].isEmpty){
+
+                                    const const_UnitigMap<U, G> um = findOvercrowded(km_pred[j], extremities_only);
+
+                                    if (!um.isEmpty) v_um[j].partialCopy(um);
+                                }
+                            }
+
+                            continue;
+                        }
+
+                        it_min2.getNewMin();
+
+                        if (it_min2 != it_min_end){
+
+                            minz = Minimizer(km_pred[0], it_min2.getPosition()).rep();
+                            it = hmap_min_unitigs.find(minz);
+                        }
+                    }
+                }
+                else {
+
+                    isShort = (unitig_id_pos & MASK_CONTIG_TYPE) != 0;
+                    unitig_id_pos &= MASK_CONTIG_POS;
+
+                    if (isShort){
+
+                        if ((min_h_pos == unitig_id_pos) || (min_h_pos == diff - unitig_id_pos)){
+
+                            const Kmer km_unitig = km_unitigs.getKmer(unitig_id);
+
+                            uint8_t idx = bits[km_unitig.getChar(0)];
+
+                            if (km_unitig == km_rep[idx]) {
+
+                                v_um[idx].partialCopy(const_UnitigMap<U, G>(unitig_id, 0, 1, k_, true, false, km_pred[idx] == km_rep[idx], this));
+                            }
+                            else {
+
+                                idx = 0x3 - bits[km_unitig.getChar(k_ - 1)];
+
+                                if (km_unitig == km_rep[idx]) {
+
+                                    v_um[idx].partialCopy(const_UnitigMap<U, G>(unitig_id, 0, 1, k_, true, false, km_pred[idx] == km_rep[idx], this));
+                                }
                             }
                         }
                     }
                     else {
 
                         len = v_unitigs[unitig_id]->length() - k_;
-                        pos_match = unitig_id_pos - min_h_res.pos;
+                        pos_match = unitig_id_pos - min_h_pos;
 
                         if (extremities_only){
 
@@ -1635,7 +2187,7 @@ vector<const_UnitigMap<U, G>> CompactedDBG<U, G>::findPredecessors(const Kmer& k
                                 v_um[idx].partialCopy(const_UnitigMap<U, G>(unitig_id, pos_match, 1, len + k_, false, false, true, this));
                             }
 
-                            pos_match = unitig_id_pos - diff + min_h_res.pos;
+                            pos_match = unitig_id_pos - diff + min_h_pos;
 
                             if (((pos_match == 0) || (pos_match == len)) && v_unitigs[unitig_id]->getSeq().compareKmer(pos_match, k_ - 1, km_twin_a)){
 
@@ -1651,7 +2203,7 @@ vector<const_UnitigMap<U, G>> CompactedDBG<U, G>::findPredecessors(const Kmer& k
                                 v_um[idx].partialCopy(const_UnitigMap<U, G>(unitig_id, pos_match, 1, len + k_, false, false, true, this));
                             }
 
-                            pos_match = unitig_id_pos - diff + min_h_res.pos;
+                            pos_match = unitig_id_pos - diff + min_h_pos;
 
                             if ((pos_match >= 0) && (pos_match <= len) && v_unitigs[unitig_id]->getSeq().compareKmer(pos_match, k_ - 1, km_twin_a)){
 
@@ -1664,7 +2216,21 @@ vector<const_UnitigMap<U, G>> CompactedDBG<U, G>::findPredecessors(const Kmer& k
             }
         }
 
-        ++it_it_min;
+        ++it_min;
+    }
+
+    if (sparse_index && isSparseSkipped(Minimizer(km_pred[0], min_h_pos_km), min_h_km)){ // Search the predecessors which were not found from their minimizers
+
+        const bool search[4] = {v_um[0].isEmpty, v_um[1].isEmpty, v_um[2].isEmpty, v_um[3].isEmpty};
+
+        const_UnitigMap<U, G> um_sparse[4];
+
+        findSparse(km_pred, search, 0, 4, extremities_only, um_sparse);
+
+        for (size_t i = 0; i != 4; ++i){
+
+            if (!um_sparse[i].isEmpty) v_um[i].partialCopy(um_sparse[i]);
+        }
     }
 
     return v_um;
@@ -1674,9 +2240,15 @@ template<typename U, typename G>
 vector<UnitigMap<U, G>> CompactedDBG<U, G>::findPredecessors(const Kmer& km, const bool extremities_only) {
 
     const Kmer km_pred[4] = {km.backwardBase('A'), km.backwardBase('C'), km.backwardBase('G'), km.backwardBase('T')};
-    const Kmer km_rep[4] = {km_pred[0].rep(), km_pred[1].rep(), km_pred[2].rep(), km_pred[3].rep()};
+    const Kmer km_tw = km.twin(); // twin(b + km[0..k-2]) = twin(km)[1..k-1] + twin(b)
+    const Kmer km_pred_tw[4] = {km_tw.forwardBase('T'), km_tw.forwardBase('G'), km_tw.forwardBase('C'), km_tw.forwardBase('A')};
+
+    const Kmer km_rep[4] = {
+        (km_pred_tw[0] < km_pred[0]) ? km_pred_tw[0] : km_pred[0], (km_pred_tw[1] < km_pred[1]) ? km_pred_tw[1] : km_pred[1],
+        (km_pred_tw[2] < km_pred[2]) ? km_pred_tw[2] : km_pred[2], (km_pred_tw[3] < km_pred[3]) ? km_pred_tw[3] : km_pred[3]
+    };
 
-    const Kmer km_twin_a = km_pred[0].twin();
+    const Kmer& km_twin_a = km_pred_tw[0];
 
     bool isShort;
 
@@ -1686,23 +2258,20 @@ vector<UnitigMap<U, G>> CompactedDBG<U, G>::findPredecessors(const Kmer& km, con
 
     const int diff = k_ - g_;
 
-    char km_tmp[MAX_KMER_SIZE];
-    km_pred[0].toString(km_tmp); // Set k-mer to look-up in string version
-
-    preAllocMinHashIterator<RepHash> it_min(km_tmp, k_, k_, g_, RepHash(), true);
-    preAllocMinHashResultIterator<RepHash> it_it_min = *it_min, it_it_min_end;
+    minHashKmer<MinimizerOrderHash> it_min(km_pred[0], k_, g_, MinimizerOrderHash(), true), it_min2, it_min_end;
 
-    minHashResult mhr, mhr_tmp;
+    const int min_h_pos_km = it_min.getPosition(); // Minimizer of the k-mer, checked if the k-mer is not found in a sparse index
+    const uint64_t min_h_km = it_min.getHash();
 
     vector<UnitigMap<U, G>> v_um(4, UnitigMap<U, G>(1, this));
 
-    while (it_it_min != it_it_min_end){
+    while (it_min != it_min_end){
 
-        const minHashResult& min_h_res = *it_it_min;
-        Minimizer minz(Minimizer(km_tmp + min_h_res.pos).rep());
+        const int min_h_pos = it_min.getPosition();
+        Minimizer minz(Minimizer(km_pred[0], min_h_pos).rep());
         MinimizerIndex::const_iterator it = hmap_min_unitigs.find(minz);
 
-        mhr = min_h_res;
+        it_min2 = it_min;
 
         while (it != hmap_min_unitigs.end()){ // If the minimizer is found
 
@@ -1734,12 +2303,26 @@ vector<UnitigMap<U, G>> CompactedDBG<U, G>::findPredecessors(const Kmer& km, con
 
                     if ((unitig_id_pos & MASK_CONTIG_TYPE) == MASK_CONTIG_TYPE){ //This minimizer is unitig overcrowded
 
-                        mhr_tmp = it_min.getNewMin(mhr);
+                        if (overcrowded_kmers_indexed){ // Neighbors not found yet are in the index of overcrowded k-mers, if present
 
-                        if (mhr_tmp.hash != mhr.hash){
+                            for (size_t j = 0; j != 4; ++j){
 
-                            mhr = mhr_tmp;
-                            minz = Minimizer(km_tmp + mhr.pos).rep();
+                                if (v_um[j].isEmpty){
+
+                                    const UnitigMap<U, G> um = findOvercrowded(km_pred[j], extremities_only);
+
+                                    if (!um.isEmpty) v_um[j].partialCopy(um);
+                                }
+                            }
+
+                            continue;
+                        }
+
+                        it_min2.getNewMin();
+
+                        if (it_min2 != it_min_end){
+
+                            minz = Minimizer(km_pred[0], it_min2.getPosition()).rep();
                             it = hmap_min_unitigs.find(minz);
                         }
                     }
@@ -1751,7 +2334,7 @@ vector<UnitigMap<U, G>> CompactedDBG<U, G>::findPredecessors(const Kmer& km, con
 
                     if (isShort){
 
-                        if ((min_h_res.pos == unitig_id_pos) || (min_h_res.pos == diff - unitig_id_pos)){
+                        if ((min_h_pos == unitig_id_pos) || (min_h_pos == diff - unitig_id_pos)){
 
                             const Kmer km_unitig = km_unitigs.getKmer(unitig_id);
 
@@ -1775,7 +2358,7 @@ vector<UnitigMap<U, G>> CompactedDBG<U, G>::findPredecessors(const Kmer& km, con
                     else {
 
                         len = v_unitigs[unitig_id]->length() - k_;
-                        pos_match = unitig_id_pos - min_h_res.pos;
+                        pos_match = unitig_id_pos - min_h_pos;
 
                         if (extremities_only){
 
@@ -1785,7 +2368,7 @@ vector<UnitigMap<U, G>> CompactedDBG<U, G>::findPredecessors(const Kmer& km, con
                                 v_um[idx] = UnitigMap<U, G>(unitig_id, pos_match, 1, len + k_, false, false, true, this);
                             }
 
-                            pos_match = unitig_id_pos - diff + min_h_res.pos;
+                            pos_match = unitig_id_pos - diff + min_h_pos;
 
                             if (((pos_match == 0) || (pos_match == len)) && v_unitigs[unitig_id]->getSeq().compareKmer(pos_match, k_ - 1, km_twin_a)){
 
@@ -1801,7 +2384,7 @@ vector<UnitigMap<U, G>> CompactedDBG<U, G>::findPredecessors(const Kmer& km, con
                                 v_um[idx] = UnitigMap<U, G>(unitig_id, pos_match, 1, len + k_, false, false, true, this);
                             }
 
-                            pos_match = unitig_id_pos - diff + min_h_res.pos;
+                            pos_match = unitig_id_pos - diff + min_h_pos;
 
                             if ((pos_match >= 0) && (pos_match <= len) && v_unitigs[unitig_id]->getSeq().compareKmer(pos_match, k_ - 1, km_twin_a)){
 
@@ -1814,7 +2397,21 @@ vector<UnitigMap<U, G>> CompactedDBG<U, G>::findPredecessors(const Kmer& km, con
             }
         }
 
-        ++it_it_min;
+        ++it_min;
+    }
+
+    if (sparse_index && isSparseSkipped(Minimizer(km_pred[0], min_h_pos_km), min_h_km)){ // Search the predecessors which were not found from their minimizers
+
+        const bool search[4] = {v_um[0].isEmpty, v_um[1].isEmpty, v_um[2].isEmpty, v_um[3].isEmpty};
+
+        const_UnitigMap<U, G> um_sparse[4];
+
+        findSparse(km_pred, search, 0, 4, extremities_only, um_sparse);
+
+        for (size_t i = 0; i != 4; ++i){
+
+            if (!um_sparse[i].isEmpty) v_um[i].partialCopy(UnitigMap<U, G>(um_sparse[i].pos_unitig, um_sparse[i].dist, um_sparse[i].len, um_sparse[i].size, um_sparse[i].isShort, um_sparse[i].isAbundant, um_sparse[i].strand, this));
+        }
     }
 
     return v_um;
@@ -1828,9 +2425,15 @@ vector<const_UnitigMap<U, G>> CompactedDBG<U, G>::findSuccessors(const Kmer& km,
     if (limit == 0) return v_um;
 
     const Kmer km_succ[4] = {km.forwardBase('A'), km.forwardBase('C'), km.forwardBase('G'), km.forwardBase('T')};
-    const Kmer km_rep[4] = {km_succ[0].rep(), km_succ[1].rep(), km_succ[2].rep(), km_succ[3].rep()};
+    const Kmer km_tw = km.twin(); // twin(km[1..k-1] + b) = twin(b) + twin(km)[0..k-2]
+    const Kmer km_succ_tw[4] = {km_tw.backwardBase('T'), km_tw.backwardBase('G'), km_tw.backwardBase('C'), km_tw.backwardBase('A')};
 
-    const Kmer km_twin_a = km_succ[0].twin().forwardBase('A');
+    const Kmer km_rep[4] = {
+        (km_succ_tw[0] < km_succ[0]) ? km_succ_tw[0] : km_succ[0], (km_succ_tw[1] < km_succ[1]) ? km_succ_tw[1] : km_succ[1],
+        (km_succ_tw[2] < km_succ[2]) ? km_succ_tw[2] : km_succ[2], (km_succ_tw[3] < km_succ[3]) ? km_succ_tw[3] : km_succ[3]
+    };
+
+    const Kmer km_twin_a = km_succ_tw[0].forwardBase('A');
 
     bool isShort;
 
@@ -1842,21 +2445,18 @@ vector<const_UnitigMap<U, G>> CompactedDBG<U, G>::findSuccessors(const Kmer& km,
 
     const int diff = k_ - g_;
 
-    char km_tmp[MAX_KMER_SIZE];
-    km_succ[0].toString(km_tmp); // Set k-mer to look-up in string version
-
-    preAllocMinHashIterator<RepHash> it_min(km_tmp, k_, k_, g_, RepHash(), true);
-    preAllocMinHashResultIterator<RepHash> it_it_min = *it_min, it_it_min_end;
+    minHashKmer<MinimizerOrderHash> it_min(km_succ[0], k_, g_, MinimizerOrderHash(), true), it_min2, it_min_end;
 
-    minHashResult mhr, mhr_tmp;
+    const int min_h_pos_km = it_min.getPosition(); // Minimizer of the k-mer, checked if the k-mer is not found in a sparse index
+    const uint64_t min_h_km = it_min.getHash();
 
-    while (it_it_min != it_it_min_end){
+    while (it_min != it_min_end){
 
-        const minHashResult& min_h_res = *it_it_min;
-        Minimizer minz(Minimizer(km_tmp + min_h_res.pos).rep());
+        const int min_h_pos = it_min.getPosition();
+        Minimizer minz(Minimizer(km_succ[0], min_h_pos).rep());
         MinimizerIndex::const_iterator it = hmap_min_unitigs.find(minz);
 
-        mhr = min_h_res;
+        it_min2 = it_min;
 
         while (it != hmap_min_unitigs.end()){ // If the minimizer is found
 
@@ -1890,12 +2490,31 @@ vector<const_UnitigMap<U, G>> CompactedDBG<U, G>::findSuccessors(const Kmer& km,
 
                     if ((unitig_id_pos & MASK_CONTIG_TYPE) == MASK_CONTIG_TYPE){ //This minimizer is unitig overcrowded
 
-                        mhr_tmp = it_min.getNewMin(mhr);
+                        if (overcrowded_kmers_indexed){ // Neighbors not found yet are in the index of overcrowded k-mers, if present
 
-                        if (mhr_tmp.hash != mhr.hash){
+                            for (size_t j = 0; j != 4; ++j){
 
-                            mhr = mhr_tmp;
-                            minz = Minimizer(km_tmp + mhr.pos).rep();
+                                if (v_um[j].isEmpty){
+
+                                    const const_UnitigMap<U, G> um = findOvercrowded(km_succ[j], extremities_only);
+
+                                    if (!um.isEmpty){
+
+                                        v_um[j].partialCopy(um);
+
+                                        if (++nb_found == limit) return v_um;
+                                    }
+                                }
+                            }
+
+                            continue;
+                        }
+
+                        it_min2.getNewMin();
+
+                        if (it_min2 != it_min_end){
+
+                            minz = Minimizer(km_succ[0], it_min2.getPosition()).rep();
                             it = hmap_min_unitigs.find(minz);
                         }
                     }
@@ -1907,7 +2526,7 @@ vector<const_UnitigMap<U, G>> CompactedDBG<U, G>::findSuccessors(const Kmer& km,
 
                     if (isShort){
 
-                        if ((min_h_res.pos == unitig_id_pos) || (min_h_res.pos == diff - unitig_id_pos)){
+                        if ((min_h_pos == unitig_id_pos) || (min_h_pos == diff - unitig_id_pos)){
 
                             const Kmer km_unitig = km_unitigs.getKmer(unitig_id);
 
@@ -1935,7 +2554,7 @@ vector<const_UnitigMap<U, G>> CompactedDBG<U, G>::findSuccessors(const Kmer& km,
                     else {
 
                         len = v_unitigs[unitig_id]->length() - k_;
-                        pos_match = unitig_id_pos - min_h_res.pos;
+                        pos_match = unitig_id_pos - min_h_pos;
 
                         if (extremities_only){
 
@@ -1951,7 +2570,7 @@ vector<const_UnitigMap<U, G>> CompactedDBG<U, G>::findSuccessors(const Kmer& km,
                                 }
                             }
 
-                            pos_match = unitig_id_pos - diff + min_h_res.pos;
+                            pos_match = unitig_id_pos - diff + min_h_pos;
 
                             if (((pos_match == 0) || (pos_match == len)) && v_unitigs[unitig_id]->getSeq().compareKmer(pos_match + 1, k_ - 1, km_twin_a)){
 
@@ -1980,7 +2599,7 @@ vector<const_UnitigMap<U, G>> CompactedDBG<U, G>::findSuccessors(const Kmer& km,
 
                             }
 
-                            pos_match = unitig_id_pos - diff + min_h_res.pos;
+                            pos_match = unitig_id_pos - diff + min_h_pos;
 
                             if ((pos_match >= 0) && (pos_match <= len) && v_unitigs[unitig_id]->getSeq().compareKmer(pos_match + 1, k_ - 1, km_twin_a)){
 
@@ -1999,7 +2618,21 @@ vector<const_UnitigMap<U, G>> CompactedDBG<U, G>::findSuccessors(const Kmer& km,
             }
         }
 
-        ++it_it_min;
+        ++it_min;
+    }
+
+    if (sparse_index && (nb_found != limit) && isSparseSkipped(Minimizer(km_succ[0], min_h_pos_km), min_h_km)){ // Search the successors which were not found from their minimizers
+
+        const bool search[4] = {v_um[0].isEmpty, v_um[1].isEmpty, v_um[2].isEmpty, v_um[3].isEmpty};
+
+        const_UnitigMap<U, G> um_sparse[4];
+
+        findSparse(km_succ, search, k_ - g_, limit - nb_found, extremities_only, um_sparse);
+
+        for (size_t i = 0; i != 4; ++i){
+
+            if (!um_sparse[i].isEmpty) v_um[i].partialCopy(um_sparse[i]);
+        }
     }
 
     return v_um;
@@ -2013,9 +2646,15 @@ vector<UnitigMap<U, G>> CompactedDBG<U, G>::findSuccessors(const Kmer& km, const
     if (limit == 0) return v_um;
 
     const Kmer km_succ[4] = {km.forwardBase('A'), km.forwardBase('C'), km.forwardBase('G'), km.forwardBase('T')};
-    const Kmer km_rep[4] = {km_succ[0].rep(), km_succ[1].rep(), km_succ[2].rep(), km_succ[3].rep()};
+    const Kmer km_tw = km.twin(); // twin(km[1..k-1] + b) = twin(b) + twin(km)[0..k-2]
+    const Kmer km_succ_tw[4] = {km_tw.backwardBase('T'), km_tw.backwardBase('G'), km_tw.backwardBase('C'), km_tw.backwardBase('A')};
+
+    const Kmer km_rep[4] = {
+        (km_succ_tw[0] < km_succ[0]) ? km_succ_tw[0] : km_succ[0], (km_succ_tw[1] < km_succ[1]) ? km_succ_tw[1] : km_succ[1],
+        (km_succ_tw[2] < km_succ[2]) ? km_succ_tw[2] : km_succ[2], (km_succ_tw[3] < km_succ[3]) ? km_succ_tw[3] : km_succ[3]
+    };
 
-    const Kmer km_twin_a = km_succ[0].twin().forwardBase('A');
+    const Kmer km_twin_a = km_succ_tw[0].forwardBase('A');
 
     bool isShort;
 
@@ -2027,21 +2666,18 @@ vector<UnitigMap<U, G>> CompactedDBG<U, G>::findSuccessors(const Kmer& km, const
 
     const int diff = k_ - g_;
 
-    char km_tmp[MAX_KMER_SIZE];
-    km_succ[0].toString(km_tmp); // Set k-mer to look-up in string version
-
-    preAllocMinHashIterator<RepHash> it_min(km_tmp, k_, k_, g_, RepHash(), true);
-    preAllocMinHashResultIterator<RepHash> it_it_min = *it_min, it_it_min_end;
+    minHashKmer<MinimizerOrderHash> it_min(km_succ[0], k_, g_, MinimizerOrderHash(), true), it_min2, it_min_end;
 
-    minHashResult mhr, mhr_tmp;
+    const int min_h_pos_km = it_min.getPosition(); // Minimizer of the k-mer, checked if the k-mer is not found in a sparse index
+    const uint64_t min_h_km = it_min.getHash();
 
-    while (it_it_min != it_it_min_end){
+    while (it_min != it_min_end){
 
-        const minHashResult& min_h_res = *it_it_min;
-        Minimizer minz(Minimizer(km_tmp + min_h_res.pos).rep());
+        const int min_h_pos = it_min.getPosition();
+        Minimizer minz(Minimizer(km_succ[0], min_h_pos).rep());
         MinimizerIndex::const_iterator it = hmap_min_unitigs.find(minz);
 
-        mhr = min_h_res;
+        it_min2 = it_min;
 
         while (it != hmap_min_unitigs.end()){ // If the minimizer is found
 
@@ -2075,12 +2711,31 @@ vector<UnitigMap<U, G>> CompactedDBG<U, G>::findSuccessors(const Kmer& km, const
 
                     if ((unitig_id_pos & MASK_CONTIG_TYPE) == MASK_CONTIG_TYPE){ //This minimizer is unitig overcrowded
 
-                        mhr_tmp = it_min.getNewMin(mhr);
+                        if (overcrowded_kmers_indexed){ // Neighbors not found yet are in the index of overcrowded k-mers, if present
 
-                        if (mhr_tmp.hash != mhr.hash){
+                            for (size_t j = 0; j != 4; ++j){
 
-                            mhr = mhr_tmp;
-                            minz = Minimizer(km_tmp + mhr.pos).rep();
+                                if (v_um[j].isEmpty){
+
+                                    const UnitigMap<U, G> um = findOvercrowded(km_succ[j], extremities_only);
+
+                                    if (!um.isEmpty){
+
+                                        v_um[j].partialCopy(um);
+
+                                        if (++nb_found == limit) return v_um;
+                                    }
+                                }
+                            }
+
+                            continue;
+                        }
+
+                        it_min2.getNewMin();
+
+                        if (it_min2 != it_min_end){
+
+                            minz = Minimizer(km_succ[0], it_min2.getPosition()).rep();
                             it = hmap_min_unitigs.find(minz);
                         }
                     }
@@ -2092,7 +2747,7 @@ vector<UnitigMap<U, G>> CompactedDBG<U, G>::findSuccessors(const Kmer& km, const
 
                     if (isShort){
 
-                        if ((min_h_res.pos == unitig_id_pos) || (min_h_res.pos == diff - unitig_id_pos)){
+                        if ((min_h_pos == unitig_id_pos) || (min_h_pos == diff - unitig_id_pos)){
 
                             const Kmer km_unitig = km_unitigs.getKmer(unitig_id);
 
@@ -2120,7 +2775,7 @@ vector<UnitigMap<U, G>> CompactedDBG<U, G>::findSuccessors(const Kmer& km, const
                     else {
 
                         len = v_unitigs[unitig_id]->length() - k_;
-                        pos_match = unitig_id_pos - min_h_res.pos;
+                        pos_match = unitig_id_pos - min_h_pos;
 
                         if (extremities_only){
 
@@ -2136,7 +2791,7 @@ vector<UnitigMap<U, G>> CompactedDBG<U, G>::findSuccessors(const Kmer& km, const
                                 }
                             }
 
-                            pos_match = unitig_id_pos - diff + min_h_res.pos;
+                            pos_match = unitig_id_pos - diff + min_h_pos;
 
                             if (((pos_match == 0) || (pos_match == len)) && v_unitigs[unitig_id]->getSeq().compareKmer(pos_match + 1, k_ - 1, km_twin_a)){
 
@@ -2165,7 +2820,7 @@ vector<UnitigMap<U, G>> CompactedDBG<U, G>::findSuccessors(const Kmer& km, const
 
                             }
 
-                            pos_match = unitig_id_pos - diff + min_h_res.pos;
+                            pos_match = unitig_id_pos - diff + min_h_pos;
 
                             if ((pos_match >= 0) && (pos_match <= len) && v_unitigs[unitig_id]->getSeq().compareKmer(pos_match + 1, k_ - 1, km_twin_a)){
 
@@ -2184,7 +2839,21 @@ vector<UnitigMap<U, G>> CompactedDBG<U, G>::findSuccessors(const Kmer& km, const
             }
         }
 
-        ++it_it_min;
+        ++it_min;
+    }
+
+    if (sparse_index && (nb_found != limit) && isSparseSkipped(Minimizer(km_succ[0], min_h_pos_km), min_h_km)){ // Search the successors which were not found from their minimizers
+
+        const bool search[4] = {v_um[0].isEmpty, v_um[1].isEmpty, v_um[2].isEmpty, v_um[3].isEmpty};
+
+        const_UnitigMap<U, G> um_sparse[4];
+
+        findSparse(km_succ, search, k_ - g_, limit - nb_found, extremities_only, um_sparse);
+
+        for (size_t i = 0; i != 4; ++i){
+
+            if (!um_sparse[i].isEmpty) v_um[i].partialCopy(UnitigMap<U, G>(um_sparse[i].pos_unitig, um_sparse[i].dist, um_sparse[i].len, um_sparse[i].size, um_sparse[i].isShort, um_sparse[i].isAbundant, um_sparse[i].strand, this));
+        }
     }
 
     return v_um;
@@ -2213,11 +2882,11 @@ bool CompactedDBG<U, G>::add(const string& seq, const bool verbose){
 
     size_t last_start_pos = 0;
 
-    for (KmerIterator it_km(str_seq), it_km_end; it_km != it_km_end; ++it_km) { //non-ACGT char. are discarded
+    for (KmerRepIterator it_km(str_seq), it_km_end; it_km != it_km_end; ++it_km) { //non-ACGT char. are discarded
 
         const std::pair<Kmer, int>& p = *it_km;
 
-        if (!km_seen.insert(p.first.rep()).second){
+        if (!km_seen.insert(p.first).second){
 
             no_dup_km_seq = seq.substr(last_start_pos, p.second - last_start_pos + k_ - 1);
             last_start_pos = p.second;
@@ -2239,6163 +2908,7938 @@ bool CompactedDBG<U, G>::add(const string& seq, const bool verbose){
 }
 
 template<typename U, typename G>
-bool CompactedDBG<U, G>::remove(const const_UnitigMap<U, G>& um, const bool verbose){
+bool CompactedDBG<U, G>::add(const vector<string>& v_seq, const size_t nb_threads, const bool verbose){
 
     if (invalid){
 
-        cerr << "CompactedDBG::remove(): Graph is invalid and no unitig can be removed from it" << endl;
+        cerr << "CompactedDBG::add(): Graph is invalid and no sequence can be added to it" << endl;
         return false;
     }
 
-    if (um.isEmpty) return false;
+    if (nb_threads == 0){
 
-    vector<Kmer> v_km;
+        cerr << "CompactedDBG::add(): Number of threads cannot be less than or equal to 0" << endl;
+        return false;
+    }
 
-    const Kmer head(um.getUnitigHead());
-    const Kmer tail(um.getUnitigTail());
+    if (verbose) cout << "CompactedDBG::add(): Searching the k-mers of " << v_seq.size() << " sequences" << endl;
 
-    for (size_t i = 0; i != 4; ++i){
+    const size_t chunk = 64;
 
-        const Kmer bw(head.backwardBase(alpha[i]));
+    vector<vector<Kmer>> v_v_km(nb_threads);
 
-        if (!find(bw, true).isEmpty) v_km.push_back(bw);
-    }
+    atomic<size_t> next_seq(0);
 
-    for (size_t i = 0; i != 4; ++i){
+    auto worker_function = [&](const size_t t){
 
-        const Kmer fw(tail.forwardBase(alpha[i]));
+        string seq;
 
-        if (!find(fw, true).isEmpty) v_km.push_back(fw);
-    }
+        for (size_t i = next_seq.fetch_add(chunk); i < v_seq.size(); i = next_seq.fetch_add(chunk)){
 
-    if (um.isAbundant){
+            const size_t i_end = min(i + chunk, v_seq.size());
 
-        deleteUnitig_<is_void<U>::value>(um.isShort, um.isAbundant, um.pos_unitig);
-    }
-    else {
+            for (size_t j = i; j < i_end; ++j){
 
-        const size_t swap_position = (um.isShort ? km_unitigs.size() : v_unitigs.size()) - 1;
+                if (v_seq[j].length() < k_) continue;
 
-        if (um.pos_unitig != swap_position) swapUnitigs(um.isShort, um.pos_unitig, swap_position);
+                seq = v_seq[j];
 
-        deleteUnitig_<is_void<U>::value>(um.isShort, um.isAbundant, swap_position);
+                std::transform(seq.begin(), seq.end(), seq.begin(), ::toupper);
 
-        if (um.isShort) km_unitigs.resize(swap_position);
-        else v_unitigs.resize(swap_position);
-    }
+                findNewKmers(seq, v_v_km[t]);
+            }
+        }
+    };
 
-    joinUnitigs_<is_void<U>::value>(&v_km);
+    if (nb_threads == 1) worker_function(0);
+    else {
 
-    return true;
+        vector<thread> workers;
+
+        for (size_t t = 0; t < nb_threads; ++t) workers.emplace_back(worker_function, t);
+        for (auto& t : workers) t.join();
+    }
+
+    return addNewKmers(v_v_km, nb_threads, verbose);
 }
 
 template<typename U, typename G>
-bool CompactedDBG<U, G>::merge(const CompactedDBG& o, const size_t nb_threads, const bool verbose){
-
-    bool ret = true;
+bool CompactedDBG<U, G>::addFromFiles(const vector<string>& input_filenames, const size_t nb_threads, const bool verbose){
 
     if (invalid){
 
-         if (verbose) cerr << "CompactedDBG::merge(): Current graph is invalid." << endl;
-         ret = false;
+        cerr << "CompactedDBG::addFromFiles(): Graph is invalid and no sequence can be added to it" << endl;
+        return false;
     }
 
-    if (o.invalid){
+    if (nb_threads == 0){
 
-         if (verbose) cerr << "CompactedDBG::merge(): Graph to merge is invalid." << endl;
-         ret = false;
+        cerr << "CompactedDBG::addFromFiles(): Number of threads cannot be less than or equal to 0" << endl;
+        return false;
     }
 
-    if (k_ != o.k_){
+    if (input_filenames.size() == 0){
 
-         if (verbose) cerr << "CompactedDBG::merge(): The graphs to merge do not have the same k-mer length." << endl;
-         ret = false;
+        cerr << "CompactedDBG::addFromFiles(): Missing input files" << endl;
+        return false;
     }
 
-    if (g_ != o.g_){
+    if (verbose) cout << "CompactedDBG::addFromFiles(): Searching the k-mers of the input files" << endl;
 
-         if (verbose) cerr << "CompactedDBG::merge(): The graphs to merge do not have the same minimizer length." << endl;
-         ret = false;
+    vector<vector<Kmer>> v_v_km;
+
+    findNewKmers(input_filenames, nullptr, nb_threads, v_v_km);
+
+    return addNewKmers(v_v_km, nb_threads, verbose);
+}
+
+template<typename U, typename G>
+bool CompactedDBG<U, G>::update(const CDBG_Build_opt& opt){
+
+    if (invalid){
+
+        cerr << "CompactedDBG::update(): Graph is invalid and cannot be updated" << endl;
+        return false;
     }
 
-    if (this == &o){
+    if (opt.nb_threads == 0){
 
-         if (verbose) cerr << "CompactedDBG::merge(): Cannot merge graph with itself." << endl;
-         ret = false;
+        cerr << "CompactedDBG::update(): Number of threads cannot be less than or equal to 0" << endl;
+        return false;
     }
 
-    if (ret){
+    if (opt.filename_seq_in.size() + opt.filename_ref_in.size() == 0){
 
-        const size_t sz_before = size();
+        cerr << "CompactedDBG::update(): Missing input files" << endl;
+        return false;
+    }
 
-        for (auto& unitig : *this) unitig.setFullCoverage();
+    vector<vector<Kmer>> v_v_km;
 
-        if (annotateSplitUnitigs(o, nb_threads, verbose)){
+    BlockedBloomFilter bf_uniq; // K-mers of the input sequence files which are not in the graph
 
-            const size_t sz_after = size();
-            const pair<size_t, size_t> p = splitAllUnitigs();
-            const size_t joined = (p.second != 0) ? joinUnitigs_<is_void<U>::value>() : 0;
+    if (opt.filename_seq_in.size() != 0){
 
-            if (verbose){
+        if (opt.verbose) cout << "CompactedDBG::update(): Searching the k-mers of the input sequence files" << endl;
 
-                cout << "CompactedDBG::merge(): Added " << (sz_after - sz_before) << " new unitigs." << endl;
-                cout << "CompactedDBG::merge(): Split " << p.first << " unitigs into " << p.second << " new unitigs." << endl;
-                cout << "CompactedDBG::merge(): Joined " << joined << " unitigs." << endl;
-                cout << "CompactedDBG::merge(): " << size() << " unitigs after merging." << endl;
-            }
+        bf_uniq = createUniqueKmersFilter(opt.filename_seq_in, opt.nb_bits_unique_kmers_bf, opt.nb_threads, opt.verbose);
 
-            if (!is_void<U>::value) mergeData(o, nb_threads, verbose);
+        findNewKmers(opt.filename_seq_in, &bf_uniq, opt.nb_threads, v_v_km);
+    }
 
-            return true;
-        }
+    if (opt.filename_ref_in.size() != 0){
+
+        if (opt.verbose) cout << "CompactedDBG::update(): Searching the k-mers of the input reference files" << endl;
+
+        findNewKmers(opt.filename_ref_in, nullptr, opt.nb_threads, v_v_km);
     }
 
-    return false;
+    const bool use_mercy = opt.useMercyKmers && (opt.filename_seq_in.size() != 0);
+
+    return addNewKmers(v_v_km, opt.nb_threads, opt.verbose, use_mercy ? &bf_uniq : nullptr);
 }
 
+// Blocked Bloom filter with nb_bits_kmer bits per k-mer of the input files, for the k-mers occurring once in the input files
+// as built by CompactedDBG::filter() (see CompactedDBG::findNewKmers()). The number of k-mers is estimated with KmerStream.
 template<typename U, typename G>
-bool CompactedDBG<U, G>::merge(const vector<CompactedDBG>& v, const size_t nb_threads, const bool verbose){
-
-    bool ret = true;
+BlockedBloomFilter CompactedDBG<U, G>::createUniqueKmersFilter(const vector<string>& input_filenames, const size_t nb_bits_kmer,
+                                                               const size_t nb_threads, const bool verbose) const {
 
-    if (invalid){
+    KmerStream_Build_opt kms_opt;
 
-         if (verbose) cerr << "CompactedDBG::merge(): Current graph is invalid." << endl;
-         ret = false;
-    }
+    kms_opt.threads = nb_threads;
+    kms_opt.verbose = verbose;
+    kms_opt.k = k_;
+    kms_opt.g = g_;
+    kms_opt.q = 0;
 
-    for (const auto& cdbg : v){
+    for (const auto& s : input_filenames) kms_opt.files.push_back(s);
 
-        if (cdbg.invalid){
+    KmerStream kms(kms_opt);
 
-             if (verbose) cerr << "CompactedDBG::merge(): One of the graph to merge is invalid." << endl;
-             ret = false;
-        }
+    const size_t nb_kmers = max(1UL, kms.KmerF0());
 
-        if (k_ != cdbg.k_){
+    if (verbose) cout << "CompactedDBG::createUniqueKmersFilter(): Estimated number of k-mers occurring at least once: " << nb_kmers << endl;
 
-             if (verbose) cerr << "CompactedDBG::merge(): The graphs to merge do not have the same k-mer length." << endl;
-             ret = false;
-        }
+    return BlockedBloomFilter(nb_kmers, nb_bits_kmer);
+}
 
-        if (g_ != cdbg.g_){
+// Append to v_v_km the canonical k-mers of the input files which are not in the graph, possibly more than once. If bf_uniq is
+// not nullptr, the k-mers which are not in the graph are inserted in bf_uniq (see CompactedDBG::createUniqueKmersFilter()) and
+// only the ones already in bf_uniq are appended: the k-mers occurring exactly once in the input files (false positives aside)
+// are discarded without being stored.
+template<typename U, typename G>
+void CompactedDBG<U, G>::findNewKmers(const vector<string>& input_filenames, BlockedBloomFilter* bf_uniq,
+                                      const size_t nb_threads, vector<vector<Kmer>>& v_v_km) {
 
-             if (verbose) cerr << "CompactedDBG::merge(): The graphs to merge do not have the same minimizer length." << endl;
-             ret = false;
-        }
+    const size_t nb_seq_batch = 1024;
 
-        if (this == &cdbg){
+    const bool multi_threaded = (nb_threads != 1);
 
-             if (verbose) cerr << "CompactedDBG::merge(): Cannot merge graph with itself." << endl;
-             ret = false;
-        }
-    }
+    vector<vector<Kmer>> l_v_v_km(nb_threads);
 
-    if (ret){
+    FileParser fp(input_filenames);
 
-        const size_t sz_before = size();
+    mutex mutex_file;
 
-        for (auto& unitig : *this) unitig.setFullCoverage();
+    auto worker_function = [&](const size_t t){
 
-        for (const auto& cdbg : v){
+        vector<Kmer>& v_km = l_v_v_km[t];
+        vector<string> v_seq;
 
-            ret = annotateSplitUnitigs(cdbg, nb_threads, verbose);
+        string seq;
 
-            if (!ret) break;
-        }
+        size_t file_id = 0;
+        size_t nb_km_uniq = 0;
 
-        if (ret){
+        while (true) {
 
-            const size_t sz_after = size();
-            const pair<size_t, size_t> p = splitAllUnitigs();
-            const size_t joined = (p.second != 0) ? joinUnitigs_<is_void<U>::value>() : 0;
+            {
+                unique_lock<mutex> lock(mutex_file);
 
-            if (verbose){
+                v_seq.clear();
 
-                cout << "CompactedDBG::merge(): Added " << (sz_after - sz_before) << " new unitigs." << endl;
-                cout << "CompactedDBG::merge(): Split " << p.first << " unitigs into " << p.second << " new unitigs." << endl;
-                cout << "CompactedDBG::merge(): Joined " << joined << " unitigs." << endl;
-                cout << "CompactedDBG::merge(): " << size() << " unitigs after merging." << endl;
+                while ((v_seq.size() < nb_seq_batch) && fp.read(seq, file_id)) v_seq.push_back(seq);
             }
 
-            if (!is_void<U>::value){
-
-                for (const auto& cdbg : v) mergeData(cdbg, nb_threads, verbose);
-            }
+            if (v_seq.empty()) return;
 
-            return true;
-        }
-    }
+            for (auto& s : v_seq){
 
-    return false;
-}
+                if (s.length() < k_) continue;
 
-template<typename U, typename G>
-bool CompactedDBG<U, G>::annotateSplitUnitigs(const CompactedDBG<U, G>& o, const size_t nb_threads, const bool verbose){
+                std::transform(s.begin(), s.end(), s.begin(), ::toupper);
 
-    if ((this != &o) && !invalid && !o.invalid) { // TODO: Check if k_ and g_ are the same
+                findNewKmers(s, v_km, bf_uniq, multi_threaded);
+            }
 
-        if (verbose){
+            // Redundant input (such as reads) produces many copies of the same new k-mers
+            if (v_km.size() > 2 * nb_km_uniq + 1048576){
 
-            cout << "CompactedDBG::annotateSplitUnitigs(): Current graph has " << size() << " unitigs." << endl;
-            cout << "CompactedDBG::annotateSplitUnitigs(): Graph to merge has " << o.size() << " unitigs." << endl;
-            cout << "CompactedDBG::annotateSplitUnitigs(): Start unitigs merging." << endl;
-        }
+                sort(v_km.begin(), v_km.end());
 
-        if (nb_threads == 1){
+                v_km.erase(unique(v_km.begin(), v_km.end()), v_km.end());
 
-            for (const auto& unitig : o) annotateSplitUnitig(unitig.referenceUnitigToString(), false);
+                nb_km_uniq = v_km.size();
+            }
         }
-        else {
-
-            const size_t chunk = 100;
-            const size_t nb_locks = nb_threads * 1024;
+    };
 
-            vector<thread> workers; // need to keep track of threads so we can join them
+    if (nb_threads == 1) worker_function(0);
+    else {
 
-            typename CompactedDBG<U, G>::const_iterator g_a(o.begin());
-            typename CompactedDBG<U, G>::const_iterator g_b(o.end());
+        vector<thread> workers;
 
-            LockGraph lck_g(nb_locks);
+        for (size_t t = 0; t < nb_threads; ++t) workers.emplace_back(worker_function, t);
+        for (auto& t : workers) t.join();
+    }
 
-            mutex mutex_o_unitig;
+    fp.close();
 
-            for (size_t t = 0; t < nb_threads; ++t){
+    for (auto& v : l_v_v_km) v_v_km.push_back(move(v));
+}
 
-                workers.emplace_back(
+template<typename U, typename G>
+void CompactedDBG<U, G>::findNewKmers(const string& seq, vector<Kmer>& v_km, BlockedBloomFilter* bf_uniq, const bool multi_threaded) {
 
-                    [&/*, t*/]{
+    const char* str_seq = seq.c_str();
 
-                        typename CompactedDBG<U, G>::const_iterator l_a, l_b;
+    RepHash rep_h(k_);
 
-                        while (true) {
+    for (KmerIterator it_km(str_seq), it_km_end; it_km != it_km_end;) { //non-ACGT char. are discarded
 
-                            {
-                                unique_lock<mutex> lock(mutex_o_unitig);
+        const std::pair<Kmer, int>& p = *it_km;
 
-                                if (g_a == g_b) return;
+        const UnitigMap<U, G> um = findUnitig(p.first, str_seq, p.second);
 
-                                l_a = g_a;
-                                l_b = g_a;
+        if (um.isEmpty){
 
-                                for (size_t cpt = 0; (cpt < chunk) && (l_b != g_b); ++cpt, ++l_b){}
+            if (bf_uniq == nullptr) v_km.push_back(p.first.rep());
+            else {
 
-                                g_a = l_b;
-                            }
+                // Same hashes as in CompactedDBG::filter() so the filter can be used to find mercy k-mers
+                const minHashKmer<MinimizerOrderHash> it_min(p.first, k_, g_, MinimizerOrderHash(), true);
 
-                            for (auto& it_unitig = l_a; it_unitig != l_b; ++it_unitig) {
+                rep_h.init(str_seq + p.second);
 
-                                annotateSplitUnitig(it_unitig->referenceUnitigToString(), lck_g/*, t*/, false);
-                            }
-                        }
-                    }
-                );
+                // First occurrence of the k-mer only sets its bits in the filter
+                if (!bf_uniq->insert(rep_h.hash(), it_min.getHash(), multi_threaded)) v_km.push_back(p.first.rep());
             }
 
-            for (auto& t : workers) t.join();
+            ++it_km;
         }
+        else it_km += um.len;
+    }
+}
 
-        if (verbose) cout << "CompactedDBG::annotateSplitUnitigs(): Merging unitigs finished." << endl;
+// Insert the k-mers of v_v_km (canonical k-mers absent from the graph, possibly duplicated) in the graph. The new k-mers are
+// assembled into maximal non-branching paths of new k-mers, given all new k-mers and the k-mers of the graph, in parallel.
+// Such a path is found from both of its ends and it is inserted from the end with the smallest k-mer only. Paths are inserted
+// concurrently under the write lock of a LockGraph. Unitigs of the graph with a new neighbor in their middle are annotated,
+// then all unitigs are split and joined once.
+template<typename U, typename G>
+bool CompactedDBG<U, G>::addNewKmers(const vector<vector<Kmer>>& v_v_km, const size_t nb_threads, const bool verbose, BlockedBloomFilter* bf_mercy){
 
-        return true;
+    if (insertNewKmers(v_v_km, nb_threads, verbose) != 0){
+
+        const pair<size_t, size_t> p = splitAllUnitigs();
+        const size_t joined = joinUnitigs_<is_void<U>::value>(nullptr, nb_threads);
+
+        if (verbose){
+
+            cout << "CompactedDBG::addNewKmers(): Split " << p.first << " unitigs into " << p.second << " new unitigs." << endl;
+            cout << "CompactedDBG::addNewKmers(): Joined " << joined << " unitigs." << endl;
+            cout << "CompactedDBG::addNewKmers(): " << size() << " unitigs after adding." << endl;
+        }
     }
 
-    return false;
+    if (bf_mercy != nullptr) joinTips(*bf_mercy, nb_threads, verbose);
+
+    reindexOvercrowdedKmers(nb_threads);
+
+    return true;
 }
 
+// Insert the paths of new k-mers of v_v_km as new unitigs and annotate the unitigs of the graph to split (see addNewKmers()).
+// Unitigs are neither split nor joined. Returns the number of unitigs inserted.
 template<typename U, typename G>
-bool CompactedDBG<U, G>::mergeData(const CompactedDBG<U, G>& o, const size_t nb_threads, const bool verbose){
+size_t CompactedDBG<U, G>::insertNewKmers(const vector<vector<Kmer>>& v_v_km, const size_t nb_threads, const bool verbose){
 
-    if ((this != &o) && !invalid && !o.invalid){ // TODO: Check if k_ and g_ are the same
+    // Neighbors of a new k-mer on its forward (successors) and backward (predecessors) sides: number of neighbors (up to 2)
+    // among the new k-mers and the graph and, if the neighbor is unique and new, its id and if it is the twin of the new k-mer
+    struct NewKmerNeighbors {
 
-        if (verbose) cout << "CompactedDBG::mergeData(): Merging data started." << endl;
+        size_t id[2];
+        uint8_t nb[2];
+        bool twin[2];
+        bool palindrome;
+    };
 
-        const size_t nb_locks = nb_threads * 1024;
+    const size_t chunk = 1024;
+    const size_t no_id = 0xffffffffffffffffULL;
 
-        std::atomic_flag* locks_unitig = new std::atomic_flag[nb_locks];
+    KmerHashTable<size_t> h_km; // New k-mer -> id of the new k-mer
 
-        for (size_t i = 0; i < nb_locks; ++i) locks_unitig[i].clear();
+    vector<Kmer> v_km;
 
-        auto worker_function = [&](typename CompactedDBG<U, G>::const_iterator it_a, typename CompactedDBG<U, G>::const_iterator it_b) {
+    size_t nb_km = 0;
 
-            while (it_a != it_b) {
+    for (const auto& v : v_v_km) nb_km += v.size();
 
-                const string str(it_a->referenceUnitigToString());
-                const char* str_seq = str.c_str();
+    // Most neighbor lookups are misses: keep the table at most half full so probing stays short
+    h_km.reserve(2 * nb_km);
+    v_km.reserve(nb_km);
 
-                for (KmerIterator it_km(str_seq), it_km_end; it_km != it_km_end;) { //non-ACGT char. are discarded
+    for (const auto& v : v_v_km){
 
-                    const std::pair<Kmer, int>& p = *it_km;
+        for (const auto& km : v){
 
-                    const UnitigMap<U, G> um_dest = findUnitig(p.first, str_seq, p.second);
+            if (h_km.insert(km, v_km.size()).second) v_km.push_back(km);
+        }
+    }
 
-                    if (um_dest.isEmpty) ++it_km;
-                    else {
+    if (verbose) cout << "CompactedDBG::addNewKmers(): " << v_km.size() << " new k-mers to insert" << endl;
 
-                        const_UnitigMap<U, G> um_src(*it_a);
+    if (v_km.empty()) return 0;
 
-                        um_src.dist = p.second;
-                        um_src.len = um_dest.len;
+    const size_t sz_before = size();
 
-                        const uint64_t id_lock = um_dest.pos_unitig % nb_locks;
+    vector<NewKmerNeighbors> v_nb(v_km.size());
+    vector<char> visited(v_km.size(), 0);
 
-                        while (locks_unitig[id_lock].test_and_set(std::memory_order_acquire));
+    auto run = [&](const std::function<void(const size_t)>& f){
 
-                        mergeData_<is_void<U>::value>(um_dest, um_src);
+        atomic<size_t> next_id(0);
 
-                        locks_unitig[id_lock].clear(std::memory_order_release);
+        auto worker_function = [&]{
 
-                        it_km += um_dest.len;
-                    }
-                }
+            for (size_t i = next_id.fetch_add(chunk); i < v_km.size(); i = next_id.fetch_add(chunk)){
 
-                ++it_a;
+                const size_t i_end = min(i + chunk, v_km.size());
+
+                for (size_t j = i; j < i_end; ++j) f(j);
             }
         };
 
-        const size_t chunk = 100;
+        if (nb_threads == 1) worker_function();
+        else {
 
-        vector<thread> workers; // need to keep track of threads so we can join them
+            vector<thread> workers;
 
-        typename CompactedDBG<U, G>::const_iterator g_a = o.begin();
-        typename CompactedDBG<U, G>::const_iterator g_b = o.end();
+            for (size_t t = 0; t < nb_threads; ++t) workers.emplace_back(worker_function);
+            for (auto& t : workers) t.join();
+        }
+    };
 
-        mutex mutex_it;
+    // The graph is not modified yet: neighbors are searched without locking
+    run([&](const size_t i){
 
-        for (size_t t = 0; t < nb_threads; ++t){
+        NewKmerNeighbors& nb = v_nb[i];
 
-            workers.emplace_back(
+        nb.palindrome = (v_km[i] == v_km[i].twin());
 
-                [&]{
+        for (size_t side = 0; side != 2; ++side){
 
-                    typename CompactedDBG<U, G>::const_iterator l_a, l_b;
-
-                    while (true) {
+            nb.id[side] = no_id;
+            nb.nb[side] = 0;
+            nb.twin[side] = false;
 
-                        {
-                            unique_lock<mutex> lock(mutex_it);
+            for (size_t j = 0; (j != 4) && (nb.nb[side] < 2); ++j){
 
-                            if (g_a == g_b) return;
+                const Kmer km = (side == 0) ? v_km[i].forwardBase(alpha[j]) : v_km[i].backwardBase(alpha[j]);
+                const Kmer km_rep = km.rep();
 
-                            l_a = g_a;
-                            l_b = g_a;
+                const KmerHashTable<size_t>::const_iterator it = h_km.find(km_rep);
 
-                            for (size_t cpt = 0; (cpt < chunk) && (l_b != g_b); ++cpt, ++l_b){}
+                if (it != h_km.end()){
 
-                            g_a = l_b;
-                        }
+                    nb.id[side] = *it;
+                    nb.twin[side] = (km != km_rep);
+                    ++nb.nb[side];
+                }
+                else if (!find(km).isEmpty){
 
-                        worker_function(l_a, l_b);
-                    }
+                    nb.id[side] = no_id;
+                    ++nb.nb[side];
                 }
-            );
+            }
         }
+    });
 
-        for (auto& t : workers) t.join();
-
-        if (verbose) cout << "CompactedDBG::mergeData(): Merging data finished." << endl;
+    // Next k-mer of k-mer id (on its twin if twin) in a path: unique successor, new and with a unique predecessor.
+    // Paths do not go through palindromic k-mers so that a path never contains a k-mer and its twin.
+    auto getNext = [&](const size_t id, const bool twin, size_t& id_next, bool& twin_next){
 
-        delete[] locks_unitig;
+        const NewKmerNeighbors& nb = v_nb[id];
+        const size_t side = twin ? 1 : 0; // Successors of the twin are the twins of the predecessors
 
-        return true;
-    }
+        if (nb.palindrome || (nb.nb[side] != 1) || (nb.id[side] == no_id) || (nb.id[side] == id)) return false;
 
-    return false;
-}
+        id_next = nb.id[side];
+        twin_next = (nb.twin[side] != twin);
 
-template<typename U, typename G>
-bool CompactedDBG<U, G>::mergeData(CompactedDBG<U, G>&& o, const size_t nb_threads, const bool verbose){
+        return !v_nb[id_next].palindrome && (v_nb[id_next].nb[twin_next ? 0 : 1] == 1);
+    };
 
-    if ((this != &o) && !invalid && !o.invalid){ // TODO: Check if k_ and g_ are the same
+    // K-mer id (its twin if twin) starts a path if it is not the next k-mer of its unique predecessor
+    auto isStart = [&](const size_t id, const bool twin){
 
-        if (verbose) cout << "CompactedDBG::mergeData(): Merging data started." << endl;
+        const NewKmerNeighbors& nb = v_nb[id];
+        const size_t side = twin ? 0 : 1;
 
-        const size_t nb_locks = nb_threads * 1024;
+        if (nb.palindrome || (nb.nb[side] != 1) || (nb.id[side] == no_id) || (nb.id[side] == id)) return true;
 
-        std::atomic_flag* locks_unitig = new std::atomic_flag[nb_locks];
+        const bool twin_prev = (nb.twin[side] != twin);
 
-        for (size_t i = 0; i < nb_locks; ++i) locks_unitig[i].clear();
+        return v_nb[nb.id[side]].palindrome || (v_nb[nb.id[side]].nb[twin_prev ? 1 : 0] != 1);
+    };
 
-        auto worker_function = [&](typename CompactedDBG<U, G>::iterator it_a, typename CompactedDBG<U, G>::iterator it_b) {
+    auto getKmer = [&](const size_t id, const bool twin){
 
-            while (it_a != it_b) {
+        return twin ? v_km[id].twin() : v_km[id];
+    };
 
-                const string str(it_a->referenceUnitigToString());
-                const char* str_seq = str.c_str();
+    for (auto& unitig : *this) unitig.setFullCoverage();
 
-                for (KmerIterator it_km(str_seq), it_km_end; it_km != it_km_end;) { //non-ACGT char. are discarded
+    LockGraph lck_g(nb_threads * 1024);
 
-                    const std::pair<Kmer, int>& p = *it_km;
+    auto add_graph_function = [&](const string& unitig){
 
-                    const UnitigMap<U, G> um_dest = findUnitig(p.first, str_seq, p.second);
+        const char* str_unitig = unitig.c_str();
+        const size_t len_unitig = unitig.length();
 
-                    if (um_dest.isEmpty) ++it_km;
-                    else {
+        const Kmer head(str_unitig);
+        const Kmer tail(str_unitig + len_unitig - k_);
 
-                        const_UnitigMap<U, G> um_src(*it_a);
+        lck_g.acquire_reader();
 
-                        um_src.dist = p.second;
-                        um_src.len = um_dest.len;
+        // Unitigs of the graph with a new neighbor in their middle must be split
+        for (auto& um : findPredecessors(head)){
 
-                        const uint64_t id_lock = um_dest.pos_unitig % nb_locks;
+            if (!um.isEmpty && !um.isAbundant && !um.isShort){
 
-                        while (locks_unitig[id_lock].test_and_set(std::memory_order_acquire));
+                um.dist += um.strand;
 
-                        mergeData_<is_void<U>::value>(um_dest, um_src);
+                if ((um.dist != 0) && (um.dist != um.size - k_ + 1)) unmapRead(um, lck_g);
+            }
+        }
 
-                        locks_unitig[id_lock].clear(std::memory_order_release);
+        for (auto& um : findSuccessors(tail)){
 
-                        it_km += um_dest.len;
-                    }
-                }
+            if (!um.isEmpty && !um.isAbundant && !um.isShort){
 
-                it_a->getData()->clear(*it_a);
+                um.dist += !um.strand;
 
-                ++it_a;
+                if ((um.dist != 0) && (um.dist != um.size - k_ + 1)) unmapRead(um, lck_g);
             }
-        };
+        }
 
-        const size_t chunk = 100;
+        lck_g.release_reader();
+        lck_g.acquire_writer();
 
-        vector<thread> workers; // need to keep track of threads so we can join them
+        if (len_unitig == k_){
 
-        typename CompactedDBG<U, G>::iterator g_a = o.begin();
-        typename CompactedDBG<U, G>::iterator g_b = o.end();
+            if (!addUnitig(str_unitig, km_unitigs.size())) km_unitigs.setFull(km_unitigs.size() - 1);
+            else h_kmers_ccov.find(head.rep())->ccov.setFull();
+        }
+        else {
 
-        mutex mutex_it;
+            addUnitig(str_unitig, v_unitigs.size());
 
-        for (size_t t = 0; t < nb_threads; ++t){
+            v_unitigs[v_unitigs.size() - 1]->getCov().setFull();
+        }
 
-            workers.emplace_back(
+        lck_g.release_writer();
+    };
 
-                [&, t]{
+    // A path is a sequence of next k-mers from a start k-mer. Since a k-mer is the next k-mer of at most one k-mer and a start
+    // k-mer is the next k-mer of none, a path cannot contain twice the same k-mer.
+    run([&](const size_t i){
 
-                    typename CompactedDBG<U, G>::iterator l_a, l_b;
+        string unitig;
 
-                    while (true) {
+        vector<size_t> v_id;
 
-                        {
-                            unique_lock<mutex> lock(mutex_it);
+        for (size_t l = 0; l < (v_nb[i].palindrome ? 1 : 2); ++l){
 
-                            if (g_a == g_b) return;
+            const bool twin_start = (l != 0);
 
-                            l_a = g_a;
-                            l_b = g_a;
+            if (!isStart(i, twin_start)) continue;
 
-                            for (size_t cpt = 0; (cpt < chunk) && (l_b != g_b); ++cpt, ++l_b){}
+            size_t id_curr = i, id_next;
+            bool twin_curr = twin_start, twin_next;
 
-                            g_a = l_b;
-                        }
+            unitig = getKmer(i, twin_start).toString();
 
-                        worker_function(l_a, l_b);
-                    }
-                }
-            );
+            v_id.assign(1, i);
+
+            while (getNext(id_curr, twin_curr, id_next, twin_next)){
+
+                unitig.push_back(getKmer(id_next, twin_next).getChar(k_ - 1));
+                v_id.push_back(id_next);
+
+                id_curr = id_next;
+                twin_curr = twin_next;
+            }
+
+            if (!(getKmer(id_curr, !twin_curr) < getKmer(i, twin_start))){
+
+                for (const size_t id : v_id) visited[id] = 1;
+
+                add_graph_function(unitig);
+            }
         }
+    });
 
-        for (auto& t : workers) t.join();
+    // New k-mers not inserted yet are in cycles of new k-mers
+    for (size_t i = 0; i < v_km.size(); ++i){
 
-        if (verbose) cout << "CompactedDBG::mergeData(): Merging data finished." << endl;
+        if (visited[i] == 0){
 
-        delete[] locks_unitig;
+            size_t id_curr = i, id_next;
+            bool twin_curr = false, twin_next;
 
-        return true;
-    }
+            string unitig = v_km[i].toString();
 
-    return false;
-}
+            visited[i] = 1;
 
-template<typename U, typename G>
-typename CompactedDBG<U, G>::iterator CompactedDBG<U, G>::begin() {
+            while (getNext(id_curr, twin_curr, id_next, twin_next) && (visited[id_next] == 0)){
 
-    if (invalid) return iterator();
+                visited[id_next] = 1;
 
-    iterator it(this);
-    ++it;
+                unitig.push_back(getKmer(id_next, twin_next).getChar(k_ - 1));
 
-    return it;
-}
+                id_curr = id_next;
+                twin_curr = twin_next;
+            }
 
-template<typename U, typename G>
-typename CompactedDBG<U, G>::const_iterator CompactedDBG<U, G>::begin() const {
+            add_graph_function(unitig);
+        }
+    }
 
-    if (invalid) return const_iterator();
+    const size_t nb_added = size() - sz_before;
 
-    const_iterator it(this);
-    ++it;
+    if (verbose) cout << "CompactedDBG::addNewKmers(): Added " << nb_added << " new unitigs." << endl;
 
-    return it;
+    return nb_added;
 }
 
 template<typename U, typename G>
-typename CompactedDBG<U, G>::iterator CompactedDBG<U, G>::end() { return iterator(); }
+bool CompactedDBG<U, G>::remove(const const_UnitigMap<U, G>& um, const bool verbose){
 
-template<typename U, typename G>
-typename CompactedDBG<U, G>::const_iterator CompactedDBG<U, G>::end() const { return const_iterator(); }
+    if (invalid){
 
-template<typename U, typename G>
-size_t CompactedDBG<U, G>::length() const {
+        cerr << "CompactedDBG::remove(): Graph is invalid and no unitig can be removed from it" << endl;
+        return false;
+    }
 
-    size_t len = 0;
+    if (um.isEmpty) return false;
 
-    if (!invalid){
+    vector<Kmer> v_km;
 
-        len = (km_unitigs.size() + h_kmers_ccov.size()) * k_;
+    const Kmer head(um.getUnitigHead());
+    const Kmer tail(um.getUnitigTail());
 
-        for (const auto& unitig : v_unitigs) len += unitig->length();
+    for (size_t i = 0; i != 4; ++i){
+
+        const Kmer bw(head.backwardBase(alpha[i]));
+
+        if (!find(bw, true).isEmpty) v_km.push_back(bw);
     }
 
-    return len;
-}
+    for (size_t i = 0; i != 4; ++i){
 
-template<typename U, typename G>
-size_t CompactedDBG<U, G>::nbKmers() const {
+        const Kmer fw(tail.forwardBase(alpha[i]));
 
-    size_t nb = 0;
+        if (!find(fw, true).isEmpty) v_km.push_back(fw);
+    }
 
-    if (!invalid){
+    if (um.isAbundant){
 
-        nb = (km_unitigs.size() + h_kmers_ccov.size());
+        deleteUnitig_<is_void<U>::value>(um.isShort, um.isAbundant, um.pos_unitig);
+    }
+    else {
 
-        for (const auto& unitig : v_unitigs) nb += unitig->length() - k_ + 1;
+        const size_t swap_position = (um.isShort ? km_unitigs.size() : v_unitigs.size()) - 1;
+
+        if (um.pos_unitig != swap_position) swapUnitigs(um.isShort, um.pos_unitig, swap_position);
+
+        deleteUnitig_<is_void<U>::value>(um.isShort, um.isAbundant, swap_position);
+
+        if (um.isShort) km_unitigs.resize(swap_position);
+        else v_unitigs.resize(swap_position);
     }
 
-    return nb;
+    joinUnitigs_<is_void<U>::value>(&v_km);
+
+    return true;
 }
 
 template<typename U, typename G>
-bool CompactedDBG<U, G>::filter(const CDBG_Build_opt& opt, const size_t nb_unique_kmers, const size_t nb_non_unique_kmers) {
+bool CompactedDBG<U, G>::remove(const vector<Kmer>& v_km, const size_t nb_threads, const bool verbose){
 
     if (invalid){
 
-        cerr << "CompactedDBG::filter(): Graph is invalid and it cannot be built" << endl;
+        cerr << "CompactedDBG::remove(): Graph is invalid and no k-mer can be removed from it" << endl;
         return false;
     }
 
-    BlockedBloomFilter bf_tmp;
+    if (nb_threads == 0){
 
-    const bool reference_mode = (opt.filename_ref_in.size() != 0);
+        cerr << "CompactedDBG::remove(): Number of threads cannot be less than or equal to 0" << endl;
+        return false;
+    }
 
-    if (reference_mode){
+    if (verbose) cout << "CompactedDBG::remove(): Marking " << v_km.size() << " k-mers to remove" << endl;
 
-        BlockedBloomFilter tmp(nb_unique_kmers, opt.nb_bits_unique_kmers_bf);
-        bf = std::move(tmp);
-    }
-    else {
+    for (auto& unitig : *this) unitig.setFullCoverage();
 
-        {
-            BlockedBloomFilter tmp(nb_unique_kmers, opt.nb_bits_unique_kmers_bf);
-            bf_tmp = std::move(tmp);
-        }
+    const size_t chunk = 1024;
 
-        {
-            BlockedBloomFilter tmp(nb_non_unique_kmers, opt.nb_bits_non_unique_kmers_bf);
-            bf = std::move(tmp);
-        }
-    }
+    const CompactedDBG<U, G>& cdbg = *this;
 
-    string s;
+    vector<vector<Kmer>> v_v_km_bound(nb_threads);
 
-    size_t len_read = 0;
-    size_t pos_read = 0;
-    size_t nb_seq = 0;
+    LockGraph lck_g(nb_threads * 1024);
 
-    //const size_t max_len_seq = 1024;
-    //const size_t thread_seq_buf_sz = 64 * max_len_seq;
-    const size_t max_len_seq = rndup(static_cast<size_t>(1024 + k_ - 1));
-    const size_t thread_seq_buf_sz = BUFFER_SIZE;
+    atomic<size_t> next_km(0);
 
-    const bool multi_threaded = (opt.nb_threads != 1);
+    auto worker_function = [&](const size_t t){
 
-    atomic<uint64_t> num_kmers(0), num_ins(0);
+        for (size_t i = next_km.fetch_add(chunk); i < v_km.size(); i = next_km.fetch_add(chunk)){
 
-    const vector<string>& filename_in = reference_mode ? opt.filename_ref_in : opt.filename_seq_in;
+            const size_t i_end = min(i + chunk, v_km.size());
 
-    FileParser fp(filename_in);
+            for (size_t j = i; j < i_end; ++j){
 
-    // Main worker thread
-    auto worker_function = [&](char* seq_buf, const size_t seq_buf_sz) {
+                const const_UnitigMap<U, G> um = cdbg.find(v_km[j]);
 
-        uint64_t l_num_kmers = 0, l_num_ins = 0;
+                if (!um.isEmpty){
 
-        char* str = seq_buf;
-        const char* str_end = &seq_buf[seq_buf_sz];
+                    unmapRead(um, lck_g);
+                    v_v_km_bound[t].push_back(v_km[j]);
+                }
+            }
+        }
+    };
 
-        while (str < str_end) { // for each input
+    if (nb_threads == 1) worker_function(0);
+    else {
 
-            const int len = strlen(str);
+        vector<thread> workers;
 
-            for (char* s = str; s != str + len; ++s) *s &= 0xDF; // Put characters in upper case
+        for (size_t t = 0; t < nb_threads; ++t) workers.emplace_back(worker_function, t);
+        for (auto& t : workers) t.join();
+    }
 
-            KmerHashIterator<RepHash> it_kmer_h(str, len, k_), it_kmer_h_end;
-            minHashIterator<RepHash> it_min(str, len, k_, g_, RepHash(), true);
+    return removeMarkedKmers(v_v_km_bound, nb_threads, verbose);
+}
 
-            if (reference_mode){
+template<typename U, typename G>
+bool CompactedDBG<U, G>::removeFromFiles(const vector<string>& input_filenames, const size_t nb_threads, const bool verbose){
 
-                for (; it_kmer_h != it_kmer_h_end; ++it_kmer_h, ++l_num_kmers) {
+    if (invalid){
 
-                    const pair<uint64_t, int> p_ = *it_kmer_h; // <k-mer hash, k-mer position in sequence>
+        cerr << "CompactedDBG::removeFromFiles(): Graph is invalid and no k-mer can be removed from it" << endl;
+        return false;
+    }
 
-                    it_min += (p_.second - it_min.getKmerPosition()); //If one or more k-mer were jumped because contained non-ACGT char.
-                    l_num_ins += bf.insert(p_.first, it_min.getHash(), multi_threaded);
-                }
-            }
-            else {
+    if (nb_threads == 0){
 
-                for (; it_kmer_h != it_kmer_h_end; ++it_kmer_h, ++l_num_kmers) {
+        cerr << "CompactedDBG::removeFromFiles(): Number of threads cannot be less than or equal to 0" << endl;
+        return false;
+    }
 
-                    const pair<uint64_t, int> p_ = *it_kmer_h; // <k-mer hash, k-mer position in sequence>
+    if (input_filenames.size() == 0){
 
-                    it_min += (p_.second - it_min.getKmerPosition()); //If one or more k-mer were jumped because contained non-ACGT char.
+        cerr << "CompactedDBG::removeFromFiles(): Missing input files" << endl;
+        return false;
+    }
 
-                    const uint64_t min_hr = it_min.getHash();
+    if (verbose) cout << "CompactedDBG::removeFromFiles(): Marking the k-mers of the input files to remove" << endl;
 
-                    if (bf_tmp.insert(p_.first, min_hr, multi_threaded)) ++l_num_ins;
-                    else bf.insert(p_.first, min_hr, multi_threaded);
-                }
-            }
+    for (auto& unitig : *this) unitig.setFullCoverage();
 
-            str += len + 1;
-        }
+    const size_t nb_seq_batch = 1024;
 
-        // atomic adds
-        num_kmers += l_num_kmers;
-        num_ins += l_num_ins;
-    };
+    vector<vector<Kmer>> v_v_km_bound(nb_threads);
 
-    auto reading_function = [&](char* seq_buf, size_t& seq_buf_sz) {
+    LockGraph lck_g(nb_threads * 1024);
 
-        size_t file_id = 0;
+    FileParser fp(input_filenames);
 
-        const size_t sz_buf = thread_seq_buf_sz - k_;
+    mutex mutex_file;
 
-        const char* s_str = s.c_str();
+    auto worker_function = [&](const size_t t){
 
-        seq_buf_sz = 0;
+        vector<Kmer>& v_km_bound = v_v_km_bound[t];
+        vector<string> v_seq;
 
-        while (seq_buf_sz < sz_buf) {
+        string seq;
 
-            const bool new_reading = (pos_read >= len_read);
+        size_t file_id = 0;
 
-            if (!new_reading || fp.read(s, file_id)) {
+        while (true) {
 
-                nb_seq += new_reading;
+            {
+                unique_lock<mutex> lock(mutex_file);
 
-                //pos_read = (new_reading ? 0 : pos_read);
-                pos_read &= static_cast<size_t>(new_reading) - 1;
+                v_seq.clear();
 
-                len_read = s.length();
-                s_str = s.c_str();
+                while ((v_seq.size() < nb_seq_batch) && fp.read(seq, file_id)) v_seq.push_back(seq);
+            }
 
-                if (len_read >= k_){
+            if (v_seq.empty()) return;
 
-                    if ((thread_seq_buf_sz - seq_buf_sz - 1) < (len_read - pos_read)){
+            for (auto& s : v_seq){
 
-                        strncpy(&seq_buf[seq_buf_sz], &s_str[pos_read], thread_seq_buf_sz - seq_buf_sz - 1);
+                if (s.length() < k_) continue;
 
-                        seq_buf[thread_seq_buf_sz - 1] = '\0';
+                std::transform(s.begin(), s.end(), s.begin(), ::toupper);
 
-                        pos_read += sz_buf - seq_buf_sz;
-                        seq_buf_sz = thread_seq_buf_sz;
+                const char* str_seq = s.c_str();
 
-                        break;
-                    }
+                for (KmerIterator it_km(str_seq), it_km_end; it_km != it_km_end;) { //non-ACGT char. are discarded
+
+                    const std::pair<Kmer, int>& p = *it_km;
+
+                    const UnitigMap<U, G> um = findUnitig(p.first, str_seq, p.second);
+
+                    if (um.isEmpty) ++it_km;
                     else {
 
-                        strcpy(&seq_buf[seq_buf_sz], &s_str[pos_read]);
+                        // Only the first and last k-mers of a mapping can have neighbors outside of it
+                        unmapRead(um, lck_g);
 
-                        seq_buf_sz += (len_read - pos_read) + 1;
-                        pos_read = len_read;
+                        v_km_bound.push_back(um.getMappedHead());
+                        if (um.len > 1) v_km_bound.push_back(um.getMappedTail());
+
+                        it_km += um.len;
                     }
                 }
-                else pos_read = len_read;
             }
-            else return true;
         }
-
-        return false;
     };
 
-    {
-        bool stop = false;
+    if (nb_threads == 1) worker_function(0);
+    else {
 
-        vector<thread> workers; // need to keep track of threads so we can join them
+        vector<thread> workers;
 
-        mutex mutex_file;
+        for (size_t t = 0; t < nb_threads; ++t) workers.emplace_back(worker_function, t);
+        for (auto& t : workers) t.join();
+    }
 
-        for (size_t t = 0; t < opt.nb_threads; ++t){
+    fp.close();
 
-            workers.emplace_back(
+    return removeMarkedKmers(v_v_km_bound, nb_threads, verbose);
+}
 
-                [&]{
+// pre: The k-mers to remove have a coverage lower than CompressedCoverage::getFullCoverage(), all other k-mers are
+//      fully covered. v_v_km_bound contains the removed k-mers which can have a neighbor which is not removed.
+// post: Unitigs are split at the removed k-mers which are discarded, data of the deleted unitigs is cleared. Unitigs
+//       which were neighbors of the removed k-mers are joined.
+template<typename U, typename G>
+bool CompactedDBG<U, G>::removeMarkedKmers(const vector<vector<Kmer>>& v_v_km_bound, const size_t nb_threads, const bool verbose){
 
-                    char* buffer_seq = new char[thread_seq_buf_sz]();
+    const size_t chunk = 1024;
+    const size_t sz_before = size();
+    const size_t nb_km_before = verbose ? nbKmers() : 0;
 
-                    size_t buffer_seq_sz = 0;
+    const pair<size_t, size_t> p = extractAllUnitigs();
 
-                    while (true) {
+    const CompactedDBG<U, G>& cdbg = *this;
 
-                        {
-                            unique_lock<mutex> lock(mutex_file);
+    vector<Kmer> v_km_bound;
+    vector<vector<Kmer>> v_v_joins(nb_threads);
 
-                            if (stop) {
+    for (const auto& v : v_v_km_bound) v_km_bound.insert(v_km_bound.end(), v.begin(), v.end());
 
-                                delete[] buffer_seq;
-                                return;
-                            }
+    atomic<size_t> next_km(0);
 
-                            stop = reading_function(buffer_seq, buffer_seq_sz);
-                        }
+    // Neighbors of removed k-mers which are still in the graph are now unitig heads or tails
+    auto worker_function = [&](const size_t t){
 
-                        worker_function(buffer_seq, buffer_seq_sz);
-                    }
+        for (size_t i = next_km.fetch_add(chunk); i < v_km_bound.size(); i = next_km.fetch_add(chunk)){
 
-                    delete[] buffer_seq;
+            const size_t i_end = min(i + chunk, v_km_bound.size());
+
+            for (size_t j = i; j < i_end; ++j){
+
+                for (size_t k = 0; k != 4; ++k){
+
+                    const Kmer bw(v_km_bound[j].backwardBase(alpha[k]));
+                    const Kmer fw(v_km_bound[j].forwardBase(alpha[k]));
+
+                    if (!cdbg.find(bw, true).isEmpty) v_v_joins[t].push_back(bw);
+                    if (!cdbg.find(fw, true).isEmpty) v_v_joins[t].push_back(fw);
                 }
-            );
+            }
         }
+    };
 
-        for (auto& t : workers) t.join();
-    }
-
-    fp.close();
+    if (nb_threads == 1) worker_function(0);
+    else {
 
-    if (opt.verbose) {
+        vector<thread> workers;
 
-        cout << "CompactedDBG::filter(): Closed all fasta/fastq files" << endl;
-        cout << "CompactedDBG::filter(): Processed " << num_kmers << " k-mers in " << nb_seq  << " reads" << endl;
-        cout << "CompactedDBG::filter(): Found " << num_ins << " unique k-mers" << endl;
-        cout << "CompactedDBG::filter(): Number of blocks in Bloom filter is " << bf.getNbBlocks() << endl;
+        for (size_t t = 0; t < nb_threads; ++t) workers.emplace_back(worker_function, t);
+        for (auto& t : workers) t.join();
     }
 
-    if (opt.useMercyKmers && !reference_mode){
-
-        const string mbbf_uniq_filename(opt.prefixFilenameOut + "_uniq");
+    vector<Kmer> v_joins;
 
-        FILE* f_mbbf = fopen(mbbf_uniq_filename.c_str(), "wb");
+    for (auto& v : v_v_joins){
 
-        if (f_mbbf == NULL){
+        v_joins.insert(v_joins.end(), v.begin(), v.end());
+        v.clear();
+    }
 
-            cerr << "CompactedDBG::filter(): Minimizer Blocked Bloom filter of unique k-mers cannot be written to disk" << endl;
-            return false;
-        }
+    const size_t joined = v_joins.empty() ? 0 : joinUnitigs_<is_void<U>::value>(&v_joins, nb_threads);
 
-        bf_tmp.WriteBloomFilter(f_mbbf);
+    if (verbose){
 
-        fclose(f_mbbf);
+        cout << "CompactedDBG::remove(): Removed " << (nb_km_before - nbKmers()) << " k-mers." << endl;
+        cout << "CompactedDBG::remove(): Split " << p.first << " unitigs and deleted " << p.second << " unitigs." << endl;
+        cout << "CompactedDBG::remove(): Joined " << joined << " unitigs." << endl;
+        cout << "CompactedDBG::remove(): " << size() << " unitigs after removing (" << sz_before << " before)." << endl;
     }
 
+    reindexOvercrowdedKmers(nb_threads);
+
     return true;
 }
 
 template<typename U, typename G>
-bool CompactedDBG<U, G>::construct(const CDBG_Build_opt& opt, const size_t nb_unique_minimizers, const size_t nb_non_unique_minimizers){
+bool CompactedDBG<U, G>::merge(const CompactedDBG& o, const size_t nb_threads, const bool verbose){
+
+    bool ret = true;
 
     if (invalid){
 
-        cerr << "CompactedDBG::construct(): Graph is invalid and cannot be built" << endl;
-        return false;
+         if (verbose) cerr << "CompactedDBG::merge(): Current graph is invalid." << endl;
+         ret = false;
     }
 
-    const bool reference_mode = (opt.filename_ref_in.size() != 0);
+    if (o.invalid){
 
-    const vector<string>& filename_in = reference_mode ? opt.filename_ref_in : opt.filename_seq_in;
+         if (verbose) cerr << "CompactedDBG::merge(): Graph to merge is invalid." << endl;
+         ret = false;
+    }
 
-    FileParser fp(filename_in);
+    if (k_ != o.k_){
 
-    string s;
+         if (verbose) cerr << "CompactedDBG::merge(): The graphs to merge do not have the same k-mer length." << endl;
+         ret = false;
+    }
 
-    size_t len_read = 0;
-    size_t pos_read = 0;
+    if (g_ != o.g_){
 
-    //const size_t max_len_seq = 1024;
-    //const size_t thread_seq_buf_sz = 64 * max_len_seq;
-    const size_t max_len_seq = rndup(static_cast<size_t>(1024 + k_ - 1));
-    const size_t thread_seq_buf_sz = BUFFER_SIZE;
+         if (verbose) cerr << "CompactedDBG::merge(): The graphs to merge do not have the same minimizer length." << endl;
+         ret = false;
+    }
 
-    tiny_vector<Kmer, 2>* fp_candidate = nullptr;
+    if (this == &o){
 
-    KmerHashTable<bool> ignored_km_tips;
+         if (verbose) cerr << "CompactedDBG::merge(): Cannot merge graph with itself." << endl;
+         ret = false;
+    }
 
-    const size_t nb_locks = opt.nb_threads * 1024;
+    if (ret){
 
-    std::atomic_flag lock_ignored_km_tips = ATOMIC_FLAG_INIT;
+        const size_t sz_before = size();
 
-    vector<SpinLock> locks_fp;
+        for (auto& unitig : *this) unitig.setFullCoverage();
 
-    LockGraph lck_g(nb_locks);
+        if (annotateSplitUnitigs(o, nb_threads, verbose)){
 
-    if (!reference_mode){
+            const size_t sz_after = size();
+            const pair<size_t, size_t> p = splitAllUnitigs();
+            const size_t joined = (p.second != 0) ? joinUnitigs_<is_void<U>::value>() : 0;
 
-        fp_candidate = new tiny_vector<Kmer, 2>[bf.getNbBlocks()];
-        locks_fp = vector<SpinLock>(nb_locks);
+            if (verbose){
 
-        MinimizerIndex hmap_min_unitigs_tmp(nb_non_unique_minimizers * 1.05);
+                cout << "CompactedDBG::merge(): Added " << (sz_after - sz_before) << " new unitigs." << endl;
+                cout << "CompactedDBG::merge(): Split " << p.first << " unitigs into " << p.second << " new unitigs." << endl;
+                cout << "CompactedDBG::merge(): Joined " << joined << " unitigs." << endl;
+                cout << "CompactedDBG::merge(): " << size() << " unitigs after merging." << endl;
+            }
 
-        hmap_min_unitigs = std::move(hmap_min_unitigs_tmp);
-    }
-    else {
+            if (!is_void<U>::value) mergeData(o, nb_threads, verbose);
 
-        MinimizerIndex hmap_min_unitigs_tmp(nb_unique_minimizers * 1.05);
+            reindexOvercrowdedKmers(nb_threads);
 
-        hmap_min_unitigs = std::move(hmap_min_unitigs_tmp);
+            return true;
+        }
     }
 
-    auto worker_function = [&](char* seq_buf, const size_t seq_buf_sz) {
+    return false;
+}
 
-        vector<Kmer> l_ignored_km_tips;
+template<typename U, typename G>
+bool CompactedDBG<U, G>::merge(const vector<CompactedDBG>& v, const size_t nb_threads, const bool verbose){
 
-        Kmer km;
-        RepHash rep;
+    bool ret = true;
 
-        char* str = seq_buf;
-        const char* str_end = &seq_buf[seq_buf_sz];
+    if (invalid){
 
-        while (str < str_end) { // for each input
+         if (verbose) cerr << "CompactedDBG::merge(): Current graph is invalid." << endl;
+         ret = false;
+    }
 
-            const int len = strlen(str);
+    for (const auto& cdbg : v){
 
-            for (char* s = str; s != &str[len]; ++s) *s &= 0xDF;
+        if (cdbg.invalid){
 
-            for (size_t i = 0; i < len - k_ + 1; i += max_len_seq - k_ + 1){
+             if (verbose) cerr << "CompactedDBG::merge(): One of the graph to merge is invalid." << endl;
+             ret = false;
+        }
 
-                const int curr_len = min(len - i, max_len_seq);
-                const char saved_char = str[i + curr_len];
-                const char* str_tmp = &str[i];
+        if (k_ != cdbg.k_){
 
-                str[i + curr_len] = '\0';
+             if (verbose) cerr << "CompactedDBG::merge(): The graphs to merge do not have the same k-mer length." << endl;
+             ret = false;
+        }
 
-                KmerHashIterator<RepHash> it_kmer_h(str_tmp, curr_len, k_), it_kmer_h_end;
-                minHashIterator<RepHash> it_min(str_tmp, curr_len, k_, g_, rep, true);
+        if (g_ != cdbg.g_){
 
-                for (; it_kmer_h != it_kmer_h_end; ++it_kmer_h) {
+             if (verbose) cerr << "CompactedDBG::merge(): The graphs to merge do not have the same minimizer length." << endl;
+             ret = false;
+        }
 
-                    const std::pair<uint64_t, int> p_ = *it_kmer_h; // <k-mer hash, k-mer position in sequence>
+        if (this == &cdbg){
 
-                    it_min += (p_.second - it_min.getKmerPosition());
+             if (verbose) cerr << "CompactedDBG::merge(): Cannot merge graph with itself." << endl;
+             ret = false;
+        }
+    }
 
-                    const uint64_t it_min_h = it_min.getHash();
-                    const int bid = bf.contains_bids(p_.first, it_min_h);
+    if (ret){
 
-                    if (bid != -1){
+        const size_t sz_before = size();
 
-                        km = Kmer(str_tmp + p_.second);
+        for (auto& unitig : *this) unitig.setFullCoverage();
 
-                        lck_g.acquire_reader();
+        for (const auto& cdbg : v){
 
-                        const UnitigMap<U, G> um = findUnitig(km, str_tmp, p_.second);
+            ret = annotateSplitUnitigs(cdbg, nb_threads, verbose);
 
-                        if (um.isEmpty) { // kmer did not map, push into queue for next unitig generation round
+            if (!ret) break;
+        }
 
-                            lck_g.release_reader();
+        if (ret){
 
-                            string newseq;
+            const size_t sz_after = size();
+            const pair<size_t, size_t> p = splitAllUnitigs();
+            const size_t joined = (p.second != 0) ? joinUnitigs_<is_void<U>::value>() : 0;
 
-                            bool isIsolated = false;
+            if (verbose){
 
-                            const size_t pos_match = findUnitigSequenceBBF(km, newseq, isIsolated, l_ignored_km_tips); //Build unitig from Bloom filter
+                cout << "CompactedDBG::merge(): Added " << (sz_after - sz_before) << " new unitigs." << endl;
+                cout << "CompactedDBG::merge(): Split " << p.first << " unitigs into " << p.second << " new unitigs." << endl;
+                cout << "CompactedDBG::merge(): Joined " << joined << " unitigs." << endl;
+                cout << "CompactedDBG::merge(): " << size() << " unitigs after merging." << endl;
+            }
 
-                            if (!reference_mode && isIsolated){ // According to the BF, k-mer is isolated in the graph and is a potential false positive
+            if (!is_void<U>::value){
 
-                                const uint64_t id_lock = bid % nb_locks;
-                                const Kmer km_rep(km.rep());
+                for (const auto& cdbg : v) mergeData(cdbg, nb_threads, verbose);
+            }
 
-                                tiny_vector<Kmer, 2>& v = fp_candidate[bid];
+            reindexOvercrowdedKmers(nb_threads);
 
-                                size_t i = 0;
+            return true;
+        }
+    }
 
-                                locks_fp[id_lock].acquire();
+    return false;
+}
 
-                                for (; i < v.size(); ++i){ // Search list of fp candidate for k-mer
+template<typename U, typename G>
+bool CompactedDBG<U, G>::merge(vector<CompactedDBG>&& v, const size_t nb_threads, const bool verbose){
 
-                                    if (v[i] == km_rep) break;
-                                }
+    bool ret = true;
 
-                                if (i >= v.size()){
+    if (invalid){
 
-                                    v.push_back(km_rep);
+         if (verbose) cerr << "CompactedDBG::merge(): Current graph is invalid." << endl;
+         ret = false;
+    }
 
-                                    locks_fp[id_lock].release();
-                                }
-                                else {
-
-                                    v.remove(i);
-
-                                    locks_fp[id_lock].release();
-
-                                    addUnitigSequenceBBF(km, newseq, pos_match, 1, lck_g);
-                                    addUnitigSequenceBBF(km, newseq, pos_match, 1, lck_g);
-                                }
-                            }
-                            else {
+    for (const auto& cdbg : v){
 
-                                const size_t len_match_km = 1 + cstrMatch(&str_tmp[p_.second + k_], &(newseq.c_str()[pos_match + k_]));
+        if (cdbg.invalid){
 
-                                addUnitigSequenceBBF(km, newseq, pos_match, len_match_km, lck_g);
+             if (verbose) cerr << "CompactedDBG::merge(): One of the graph to merge is invalid." << endl;
+             ret = false;
+        }
 
-                                it_kmer_h += len_match_km - 1;
-                            }
-                        }
-                        else {
+        if (k_ != cdbg.k_){
 
-                            mapRead(um, lck_g);
+             if (verbose) cerr << "CompactedDBG::merge(): The graphs to merge do not have the same k-mer length." << endl;
+             ret = false;
+        }
 
-                            lck_g.release_reader();
+        if (g_ != cdbg.g_){
 
-                            it_kmer_h += um.len - 1;
-                        }
-                    }
-                }
+             if (verbose) cerr << "CompactedDBG::merge(): The graphs to merge do not have the same minimizer length." << endl;
+             ret = false;
+        }
 
-                str[i + curr_len] = saved_char;
-            }
+        if (this == &cdbg){
 
-            str += len + 1;
+             if (verbose) cerr << "CompactedDBG::merge(): Cannot merge graph with itself." << endl;
+             ret = false;
         }
+    }
 
-        while (lock_ignored_km_tips.test_and_set(std::memory_order_acquire));
+    if (ret && !v.empty()){
 
-        for (const auto& km_tip : l_ignored_km_tips) ignored_km_tips.insert(km_tip, false);
+        // Without data, the order in which the graphs are merged does not matter
+        const size_t pos = mergeTree(v, nb_threads, !is_void<U>::value, verbose,
 
-        lock_ignored_km_tips.clear(std::memory_order_release);
-    };
+            [](CompactedDBG<U, G>& a, CompactedDBG<U, G>& b, const size_t nb_threads_pair){
 
-    auto reading_function = [&](char* seq_buf, size_t& seq_buf_sz) {
+                const bool ret = a.merge(b, nb_threads_pair, false);
 
-        size_t file_id = 0;
+                b.clear();
 
-        const size_t sz_buf = thread_seq_buf_sz - k_;
+                return ret;
+            }
+        );
 
-        const char* s_str = s.c_str();
+        ret = (pos != v.size()) && merge(v[pos], nb_threads, verbose);
 
-        seq_buf_sz = 0;
+        for (auto& cdbg : v) cdbg.clear();
+    }
 
-        while (seq_buf_sz < sz_buf) {
+    return ret;
+}
 
-            const bool new_reading = (pos_read >= len_read);
+// Merge the graphs of v pairwise, in rounds, until one graph remains. In a round, disjoint pairs of graphs are merged
+// concurrently by groups of threads, merge_pair(a, b, nb_threads_pair) merging graph b into graph a and clearing b.
+// If keep_order is true (graphs with data, such as colors), only consecutive graphs are paired and the left one absorbs the
+// right one, so the data of the merged graph is in the order of v. Otherwise, the smallest graphs are paired first and the
+// largest graph of a pair absorbs the smallest one: large graphs are merged only in the last rounds, when few graphs remain
+// in memory. In a round, the largest pairs are merged first so they do not delay the end of the round.
+// Return the position in v of the merged graph, v.size() if a merge failed.
+template<typename U, typename G>
+template<typename Graph, typename MergeFunction>
+size_t CompactedDBG<U, G>::mergeTree(vector<Graph>& v, const size_t nb_threads, const bool keep_order,
+                                     const bool verbose, MergeFunction merge_pair){
 
-            if (!new_reading || fp.read(s, file_id)) {
+    vector<size_t> v_pos(v.size()); // Positions in v of the graphs which were not merged in another graph yet
+    vector<size_t> v_len(v.size());
 
-                pos_read &= static_cast<size_t>(new_reading) - 1;
+    for (size_t i = 0; i < v.size(); ++i) v_pos[i] = i;
 
-                len_read = s.length();
-                s_str = s.c_str();
+    size_t round = 0;
 
-                if (len_read >= k_){
+    while (v_pos.size() > 1){
 
-                    if ((thread_seq_buf_sz - seq_buf_sz - 1) < (len_read - pos_read)){
+        vector<pair<size_t, size_t>> v_pairs; // Pairs (graph merged into, graph merged from)
+        vector<size_t> v_pos_next;
 
-                        strncpy(&seq_buf[seq_buf_sz], &s_str[pos_read], thread_seq_buf_sz - seq_buf_sz - 1);
+        for (const size_t pos : v_pos) v_len[pos] = v[pos].length();
 
-                        seq_buf[thread_seq_buf_sz - 1] = '\0';
+        if (!keep_order) sort(v_pos.begin(), v_pos.end(), [&](const size_t a, const size_t b){ return v_len[a] < v_len[b]; });
 
-                        pos_read += sz_buf - seq_buf_sz;
-                        seq_buf_sz = thread_seq_buf_sz;
+        for (size_t i = 0; i + 1 < v_pos.size(); i += 2){
 
-                        break;
-                    }
-                    else {
+            const size_t a = v_pos[i], b = v_pos[i + 1];
 
-                        strcpy(&seq_buf[seq_buf_sz], &s_str[pos_read]);
+            if (keep_order || (v_len[a] >= v_len[b])) v_pairs.push_back({a, b});
+            else v_pairs.push_back({b, a});
 
-                        seq_buf_sz += (len_read - pos_read) + 1;
-                        pos_read = len_read;
-                    }
-                }
-                else pos_read = len_read;
-            }
-            else return true;
+            v_pos_next.push_back(v_pairs.back().first);
         }
 
-        return false;
-    };
-
-    {
-        bool stop = false;
+        if ((v_pos.size() & 0x1) != 0) v_pos_next.push_back(v_pos.back());
 
-        vector<thread> workers; // need to keep track of threads so we can join them
+        sort(v_pairs.begin(), v_pairs.end(), [&](const pair<size_t, size_t>& a, const pair<size_t, size_t>& b){
 
-        mutex mutex_file;
+            return (v_len[a.first] + v_len[a.second]) > (v_len[b.first] + v_len[b.second]);
+        });
 
-        if (opt.verbose) cout << "CompactedDBG::construct(): Extract approximate unitigs" << endl;
+        const size_t nb_groups = min(v_pairs.size(), nb_threads);
 
-        for (size_t t = 0; t < opt.nb_threads; ++t){
+        atomic<size_t> next_pair(0);
+        atomic<bool> ret(true);
 
-            workers.emplace_back(
+        auto worker_function = [&](const size_t nb_threads_pair){
 
-                [&]{
+            for (size_t i = next_pair++; i < v_pairs.size(); i = next_pair++){
 
-                    char* buffer_seq = new char[thread_seq_buf_sz];
+                if (!merge_pair(v[v_pairs[i].first], v[v_pairs[i].second], nb_threads_pair)) ret = false;
+            }
+        };
 
-                    size_t buffer_seq_sz = 0;
+        if (nb_groups <= 1) worker_function(nb_threads);
+        else {
 
-                    while (true) {
+            vector<thread> workers;
 
-                        {
-                            unique_lock<mutex> lock(mutex_file);
+            for (size_t t = 0; t < nb_groups; ++t) workers.emplace_back(worker_function, nb_threads / nb_groups + static_cast<size_t>(t < nb_threads % nb_groups));
+            for (auto& t : workers) t.join();
+        }
 
-                            if (stop) {
+        if (!ret) return v.size();
 
-                                delete[] buffer_seq;
-                                return;
-                            }
+        if (verbose) cout << "CompactedDBG::merge(): Round " << ++round << ", merged " << v_pairs.size() << " pairs of graphs." << endl;
 
-                            stop = reading_function(buffer_seq, buffer_seq_sz);
-                        }
+        v_pos = move(v_pos_next);
+    }
 
-                        worker_function(buffer_seq, buffer_seq_sz);
-                    }
+    return v_pos.empty() ? v.size() : v_pos[0];
+}
 
-                    delete[] buffer_seq;
-                }
-            );
-        }
+template<typename U, typename G>
+bool CompactedDBG<U, G>::annotateSplitUnitigs(const CompactedDBG<U, G>& o, const size_t nb_threads, const bool verbose){
 
-        for (auto& t : workers) t.join();
-    }
+    if ((this != &o) && !invalid && !o.invalid) { // TODO: Check if k_ and g_ are the same
 
-    fp.close();
+        if (verbose){
 
-    bf.clear();
-    lck_g.clear();
-    locks_fp.clear();
+            cout << "CompactedDBG::annotateSplitUnitigs(): Current graph has " << size() << " unitigs." << endl;
+            cout << "CompactedDBG::annotateSplitUnitigs(): Graph to merge has " << o.size() << " unitigs." << endl;
+            cout << "CompactedDBG::annotateSplitUnitigs(): Start unitigs merging." << endl;
+        }
 
-    if (fp_candidate != nullptr) delete[] fp_candidate;
+        if (nb_threads == 1){
 
-    if (opt.verbose) cout << "CompactedDBG::construct(): Closed all input files" << endl;
+            for (const auto& unitig : o) annotateSplitUnitig(unitig.referenceUnitigToString(), false);
+        }
+        else {
 
-    const size_t unitigsBefore = size();
+            const size_t chunk = 100;
+            const size_t nb_locks = nb_threads * 1024;
 
-    if (opt.verbose) cout << endl << "CompactedDBG::construct(): Splitting unitigs (1/2)" << endl;
+            vector<thread> workers; // need to keep track of threads so we can join them
 
-    pair<size_t, size_t> unitigSplit = extractAllUnitigs();
+            typename CompactedDBG<U, G>::const_iterator g_a(o.begin());
+            typename CompactedDBG<U, G>::const_iterator g_b(o.end());
 
-    const int unitigsAfter1 = size();
+            LockGraph lck_g(nb_locks);
 
-    if (opt.verbose) cout << endl << "CompactedDBG::construct(): Splitting unitigs (2/2)" << endl;
+            mutex mutex_o_unitig;
 
-    check_fp_tips(ignored_km_tips);
-    ignored_km_tips.clear_tables();
+            for (size_t t = 0; t < nb_threads; ++t){
 
-    const int unitigsAfter2 = size();
+                workers.emplace_back(
 
-    if (opt.verbose) {
+                    [&/*, t*/]{
 
-        cout << "CompactedDBG::construct(): Before split: " << unitigsBefore << " unitigs" << endl;
-        cout << "CompactedDBG::construct(): After split (1/" << (reference_mode ? "1" : "2" ) << "): " << unitigsAfter1 << " unitigs" <<  endl;
-        if (!reference_mode) cout << "CompactedDBG::construct(): After split (2/2): " << unitigsAfter2 << " unitigs" <<  endl;
-        cout << "CompactedDBG::construct(): Unitigs split: " << unitigSplit.first << endl;
-        cout << "CompactedDBG::construct(): Unitigs deleted: " << unitigSplit.second << endl;
+                        typename CompactedDBG<U, G>::const_iterator l_a, l_b;
 
-        cout << endl << "CompactedDBG::construct(): Joining unitigs" << endl;
-    }
+                        while (true) {
 
-    const size_t joined = joinUnitigs_<is_void<U>::value>(nullptr, opt.nb_threads);
+                            {
+                                unique_lock<mutex> lock(mutex_o_unitig);
 
-    const int unitigsAfter3 = size();
+                                if (g_a == g_b) return;
 
-    if (opt.verbose) {
+                                l_a = g_a;
+                                l_b = g_a;
 
-        cout << "CompactedDBG::construct(): After join: " << unitigsAfter3 << " unitigs" << endl;
-        cout << "CompactedDBG::construct(): Joined " << joined << " unitigs" << endl;
-    }
+                                for (size_t cpt = 0; (cpt < chunk) && (l_b != g_b); ++cpt, ++l_b){}
 
-    if (opt.useMercyKmers && !reference_mode){
+                                g_a = l_b;
+                            }
 
-        string filename_mbbf_uniq_km = opt.prefixFilenameOut + "_uniq";
+                            for (auto& it_unitig = l_a; it_unitig != l_b; ++it_unitig) {
 
-        joinTips(filename_mbbf_uniq_km, opt.nb_threads, opt.verbose);
+                                annotateSplitUnitig(it_unitig->referenceUnitigToString(), lck_g/*, t*/, false);
+                            }
+                        }
+                    }
+                );
+            }
 
-        if (opt.verbose) cout << "CompactedDBG::construct(): After join tips using mercy k-mers: " << size() << " unitigs" << endl;
+            for (auto& t : workers) t.join();
+        }
 
-        if (std::remove(filename_mbbf_uniq_km.c_str()) != 0) {
+        if (verbose) cout << "CompactedDBG::annotateSplitUnitigs(): Merging unitigs finished." << endl;
 
-            cerr << "CompactedDBG::construct(): Minimizer Blocked Bloom filter file of unique k-mers cannot be removed from disk" << endl;
-        }
+        return true;
     }
 
-    return true;
+    return false;
 }
 
 template<typename U, typename G>
-bool CompactedDBG<U, G>::addUnitigSequenceBBF(const Kmer km, const string& seq, const size_t pos_match_km, const size_t len_match_km, LockGraph& lck_g) {
+bool CompactedDBG<U, G>::mergeData(const CompactedDBG<U, G>& o, const size_t nb_threads, const bool verbose){
 
-    bool isAbundant = false;
+    if ((this != &o) && !invalid && !o.invalid){ // TODO: Check if k_ and g_ are the same
 
-    const bool isShort = (seq.length() == k_);
+        if (verbose) cout << "CompactedDBG::mergeData(): Merging data started." << endl;
 
-    lck_g.acquire_writer();
+        const size_t nb_locks = nb_threads * 1024;
 
-    const size_t id_unitig = isShort ? km_unitigs.size() : v_unitigs.size();
+        std::atomic_flag* locks_unitig = new std::atomic_flag[nb_locks];
 
-    UnitigMap<U, G> um = find(km); // Look if unitig was already inserted
+        for (size_t i = 0; i < nb_locks; ++i) locks_unitig[i].clear();
 
-    if (um.isEmpty) isAbundant = addUnitig(seq, id_unitig); // If it wasn't already inserted, does it
+        auto worker_function = [&](typename CompactedDBG<U, G>::const_iterator it_a, typename CompactedDBG<U, G>::const_iterator it_b) {
 
-    lck_g.release_writer();
-    lck_g.acquire_reader();
+            while (it_a != it_b) {
 
-    um = find(km);
-    um.len = len_match_km; // Prepare read mapping
+                const string str(it_a->referenceUnitigToString());
+                const char* str_seq = str.c_str();
 
-    if (!um.isShort && !um.isAbundant && !um.strand) um.dist -= um.len - 1;
+                for (KmerIterator it_km(str_seq), it_km_end; it_km != it_km_end;) { //non-ACGT char. are discarded
 
-    if (um.dist + um.len > um.size - k_){ // This is a self loop
+                    const std::pair<Kmer, int>& p = *it_km;
 
-        KmerIterator it(&(seq.c_str()[pos_match_km]));
+                    const UnitigMap<U, G> um_dest = findUnitig(p.first, str_seq, p.second);
 
-        for (size_t i = 0; i != len_match_km; ++it, ++i){
+                    if (um_dest.isEmpty) ++it_km;
+                    else {
 
-            um = find(it->first);
+                        const_UnitigMap<U, G> um_src(*it_a);
 
-            mapRead(um, lck_g);
-        }
-    }
-    else mapRead(um, lck_g);
+                        um_src.dist = p.second;
+                        um_src.len = um_dest.len;
 
-    lck_g.release_reader();
+                        const uint64_t id_lock = um_dest.pos_unitig % nb_locks;
 
-    return !um.isEmpty;
-}
+                        while (locks_unitig[id_lock].test_and_set(std::memory_order_acquire));
 
-// use:  cm.findUnitigSequenceBBF(km, s, selfLoop)
-// pre:  km is in the bloom filter
-// post: s is the unitig containing the kmer km
-//       and the first k-mer in s is smaller (wrt. < operator)
-//       than the last kmer
-//       selfLoop is true of the unitig is a loop or hairpin
-template<typename U, typename G>
-size_t CompactedDBG<U, G>::findUnitigSequenceBBF(Kmer km, string& s, bool& isIsolated, vector<Kmer>& l_ignored_km_tip) {
+                        mergeData_<is_void<U>::value>(um_dest, um_src);
 
-    string fw_s, bw_s;
+                        locks_unitig[id_lock].clear(std::memory_order_release);
 
-    Kmer end(km);
-    Kmer last(end);
+                        it_km += um_dest.len;
+                    }
+                }
 
-    const Kmer twin(km.twin());
-
-    char c;
+                ++it_a;
+            }
+        };
 
-    size_t j = 0;
+        const size_t chunk = 100;
 
-    bool has_no_neighbor;
-    bool self_loop = false;
+        vector<thread> workers; // need to keep track of threads so we can join them
 
-    isIsolated = false;
+        typename CompactedDBG<U, G>::const_iterator g_a = o.begin();
+        typename CompactedDBG<U, G>::const_iterator g_b = o.end();
 
-    while (fwStepBBF(end, end, c, has_no_neighbor, l_ignored_km_tip)) {
+        mutex mutex_it;
 
-        ++j;
+        for (size_t t = 0; t < nb_threads; ++t){
 
-        self_loop = (end == km);
+            workers.emplace_back(
 
-        if (self_loop || (end == twin) || (end == last.twin())) break;
+                [&]{
 
-        fw_s.push_back(c);
-        last = end;
-    }
+                    typename CompactedDBG<U, G>::const_iterator l_a, l_b;
 
-    if (!self_loop) {
+                    while (true) {
 
-        Kmer front(km);
-        Kmer first(front);
+                        {
+                            unique_lock<mutex> lock(mutex_it);
 
-        isIsolated = (j == 0) && has_no_neighbor;
-        j = 0;
+                            if (g_a == g_b) return;
 
-        while (bwStepBBF(front, front, c, has_no_neighbor, l_ignored_km_tip)) {
+                            l_a = g_a;
+                            l_b = g_a;
 
-            ++j;
+                            for (size_t cpt = 0; (cpt < chunk) && (l_b != g_b); ++cpt, ++l_b){}
 
-            if ((front == km) || (front == twin) || (front == first.twin())) break;
+                            g_a = l_b;
+                        }
 
-            bw_s.push_back(c);
-            first = front;
+                        worker_function(l_a, l_b);
+                    }
+                }
+            );
         }
 
-        isIsolated = isIsolated && (j == 0) && has_no_neighbor;
-
-        reverse(bw_s.begin(), bw_s.end());
-    }
+        for (auto& t : workers) t.join();
 
-    char tmp[MAX_KMER_SIZE];
+        if (verbose) cout << "CompactedDBG::mergeData(): Merging data finished." << endl;
 
-    km.toString(tmp);
+        delete[] locks_unitig;
 
-    s.reserve(k_ + fw_s.size() + bw_s.size());
-    s.append(bw_s);
-    s.append(tmp);
-    s.append(fw_s);
+        return true;
+    }
 
-    return bw_s.size();
+    return false;
 }
 
 template<typename U, typename G>
-bool CompactedDBG<U, G>::bwStepBBF(const Kmer km, Kmer& front, char& c, bool& has_no_neighbor, vector<Kmer>& l_ignored_km_tip, const bool check_fp_cand) const {
-
-    char km_tmp[MAX_KMER_SIZE];
-
-    int found_fp_bw = 0;
+bool CompactedDBG<U, G>::mergeData(CompactedDBG<U, G>&& o, const size_t nb_threads, const bool verbose){
 
-    bool neigh_bw[4] = {false, false, false, false};
-    uint64_t hashes_bw[4];
+    if ((this != &o) && !invalid && !o.invalid){ // TODO: Check if k_ and g_ are the same
 
-    RepHash rep_h(k_), rep_h_cpy;
+        if (verbose) cout << "CompactedDBG::mergeData(): Merging data started." << endl;
 
-    front.toString(km_tmp);
-    rep_h.init(km_tmp);
+        const size_t nb_locks = nb_threads * 1024;
 
-    rep_h_cpy = rep_h;
-    rep_h_cpy.updateBW(km_tmp[k_ - 1], alpha[0]);
-    hashes_bw[0] = rep_h_cpy.hash();
+        std::atomic_flag* locks_unitig = new std::atomic_flag[nb_locks];
 
-    rep_h_cpy = rep_h;
-    rep_h_cpy.updateBW(km_tmp[k_ - 1], alpha[1]);
-    hashes_bw[1] = rep_h_cpy.hash();
+        for (size_t i = 0; i < nb_locks; ++i) locks_unitig[i].clear();
 
-    rep_h_cpy = rep_h;
-    rep_h_cpy.updateBW(km_tmp[k_ - 1], alpha[2]);
-    hashes_bw[2] = rep_h_cpy.hash();
+        auto worker_function = [&](typename CompactedDBG<U, G>::iterator it_a, typename CompactedDBG<U, G>::iterator it_b) {
 
-    rep_h_cpy = rep_h;
-    rep_h_cpy.updateBW(km_tmp[k_ - 1], alpha[3]);
-    hashes_bw[3] = rep_h_cpy.hash();
+            while (it_a != it_b) {
 
-    std::memmove(km_tmp + 1, km_tmp, (k_ - 1) * sizeof(char));
+                const string str(it_a->referenceUnitigToString());
+                const char* str_seq = str.c_str();
 
-    const uint64_t it_min_h_bw = minHashKmer<RepHash>(km_tmp, k_, g_, RepHash(), true).getHash();
+                for (KmerIterator it_km(str_seq), it_km_end; it_km != it_km_end;) { //non-ACGT char. are discarded
 
-    size_t nb_neigh = bf.contains(hashes_bw, it_min_h_bw, neigh_bw, 2 * (static_cast<size_t>(check_fp_cand) + 1));
-    size_t j = static_cast<size_t>(neigh_bw[1]) + (2ULL & (static_cast<size_t>(!neigh_bw[2]) - 1)) + (3ULL & (static_cast<size_t>(!neigh_bw[3]) - 1));
+                    const std::pair<Kmer, int>& p = *it_km;
 
-    if (check_fp_cand && (nb_neigh >= 2)){
+                    const UnitigMap<U, G> um_dest = findUnitig(p.first, str_seq, p.second);
 
-        size_t j_tmp = 0;
+                    if (um_dest.isEmpty) ++it_km;
+                    else {
 
-        for (size_t i = 0; i < 4; ++i) {
+                        const_UnitigMap<U, G> um_src(*it_a);
 
-            if (neigh_bw[i]){
+                        um_src.dist = p.second;
+                        um_src.len = um_dest.len;
 
-                char dummy;
-                bool has_no_neighbor_tmp = false;
+                        const uint64_t id_lock = um_dest.pos_unitig % nb_locks;
 
-                Kmer km_fp(front.backwardBase(alpha[i]));
+                        while (locks_unitig[id_lock].test_and_set(std::memory_order_acquire));
 
-                bwStepBBF(km_fp, km_fp, dummy, has_no_neighbor_tmp, l_ignored_km_tip, false);
+                        mergeData_<is_void<U>::value>(um_dest, um_src);
 
-                neigh_bw[i] = has_no_neighbor_tmp && fwStepBBF(km_fp, km_fp, dummy, has_no_neighbor_tmp, l_ignored_km_tip, false);
-                found_fp_bw += neigh_bw[i];
-                j_tmp += (i - j_tmp) & (static_cast<size_t>(neigh_bw[i]) - 1);
-            }
-        }
+                        locks_unitig[id_lock].clear(std::memory_order_release);
 
-        if (found_fp_bw != 0){
+                        it_km += um_dest.len;
+                    }
+                }
 
-            if ((nb_neigh - found_fp_bw) != 0){
+                it_a->getData()->clear(*it_a);
 
-                j = j_tmp;
-                nb_neigh -= found_fp_bw;
+                ++it_a;
             }
-            else found_fp_bw = 0;
-        }
-    }
-
-    if (nb_neigh != 1) {
+        };
 
-        has_no_neighbor = (nb_neigh == 0);
-        return false;
-    }
-    else has_no_neighbor = false;
+        const size_t chunk = 100;
 
-    if (check_fp_cand){
+        vector<thread> workers; // need to keep track of threads so we can join them
 
-        int found_fp_fw = 0;
+        typename CompactedDBG<U, G>::iterator g_a = o.begin();
+        typename CompactedDBG<U, G>::iterator g_b = o.end();
 
-        bool neigh_fw[4] = {false, false, false, false};
-        uint64_t hashes_fw[4];
+        mutex mutex_it;
 
-        const Kmer bw(front.backwardBase(alpha[j]));
+        for (size_t t = 0; t < nb_threads; ++t){
 
-        bw.toString(km_tmp);
-        rep_h.init(km_tmp);
+            workers.emplace_back(
 
-        rep_h_cpy = rep_h;
-        rep_h_cpy.updateFW(km_tmp[0], alpha[0]);
-        hashes_fw[0] = rep_h_cpy.hash();
+                [&, t]{
 
-        rep_h_cpy = rep_h;
-        rep_h_cpy.updateFW(km_tmp[0], alpha[1]);
-        hashes_fw[1] = rep_h_cpy.hash();
+                    typename CompactedDBG<U, G>::iterator l_a, l_b;
 
-        rep_h_cpy = rep_h;
-        rep_h_cpy.updateFW(km_tmp[0], alpha[2]);
-        hashes_fw[2] = rep_h_cpy.hash();
+                    while (true) {
 
-        rep_h_cpy = rep_h;
-        rep_h_cpy.updateFW(km_tmp[0], alpha[3]);
-        hashes_fw[3] = rep_h_cpy.hash();
+                        {
+                            unique_lock<mutex> lock(mutex_it);
 
-        std::memmove(km_tmp, km_tmp + 1, (k_ - 1) * sizeof(char));
+                            if (g_a == g_b) return;
 
-        const uint64_t it_min_h_fw = minHashKmer<RepHash>(km_tmp, k_, g_, RepHash(), true).getHash();
+                            l_a = g_a;
+                            l_b = g_a;
 
-        nb_neigh = bf.contains(hashes_fw, it_min_h_fw, neigh_fw, 4);
+                            for (size_t cpt = 0; (cpt < chunk) && (l_b != g_b); ++cpt, ++l_b){}
 
-        if (nb_neigh >= 2){
+                            g_a = l_b;
+                        }
 
-            for (size_t i = 0; i < 4; ++i) {
+                        worker_function(l_a, l_b);
+                    }
+                }
+            );
+        }
 
-                if (neigh_fw[i]){
+        for (auto& t : workers) t.join();
 
-                    char dummy;
-                    bool has_no_neighbor_tmp = false;
+        if (verbose) cout << "CompactedDBG::mergeData(): Merging data finished." << endl;
 
-                    Kmer km_fp(bw.forwardBase(alpha[i]));
+        delete[] locks_unitig;
 
-                    fwStepBBF(km_fp, km_fp, dummy, has_no_neighbor_tmp, l_ignored_km_tip, false);
+        return true;
+    }
 
-                    neigh_fw[i] = has_no_neighbor_tmp && bwStepBBF(km_fp, km_fp, dummy, has_no_neighbor_tmp, l_ignored_km_tip, false);
+    return false;
+}
 
-                    if (neigh_fw[i] && (km_fp == km)){
+template<typename U, typename G>
+typename CompactedDBG<U, G>::iterator CompactedDBG<U, G>::begin() {
 
-                        found_fp_fw = 0;
-                        break;
-                    }
-                    else found_fp_fw += (neigh_fw[i] && (km_fp != km));
-                }
-            }
+    if (invalid) return iterator();
 
-            if (found_fp_fw){
+    iterator it(this);
+    ++it;
 
-                if (nb_neigh - found_fp_fw) nb_neigh -= found_fp_fw;
-                else found_fp_fw = 0;
-            }
-        }
+    return it;
+}
 
-        if (nb_neigh != 1) return false;
+template<typename U, typename G>
+typename CompactedDBG<U, G>::const_iterator CompactedDBG<U, G>::begin() const {
 
-        if (bw != km) {
-            // exactly one k-mer in bw, character used is c
+    if (invalid) return const_iterator();
 
-            for (size_t i = 0; (i < 4) && (found_fp_fw != 0); ++i) {
+    const_iterator it(this);
+    ++it;
 
-                if (neigh_fw[i]){
+    return it;
+}
 
-                    l_ignored_km_tip.push_back(bw.forwardBase(alpha[i]).rep());
+template<typename U, typename G>
+typename CompactedDBG<U, G>::iterator CompactedDBG<U, G>::end() { return iterator(); }
 
-                    --found_fp_fw;
-                }
-            }
+template<typename U, typename G>
+typename CompactedDBG<U, G>::const_iterator CompactedDBG<U, G>::end() const { return const_iterator(); }
 
-             for (size_t i = 0; (i < 4) && (found_fp_bw != 0); ++i) {
+template<typename U, typename G>
+typename CompactedDBG<U, G>::range CompactedDBG<U, G>::getUnitigRange() { return range(this); }
 
-                if (neigh_bw[i]){
+template<typename U, typename G>
+typename CompactedDBG<U, G>::const_range CompactedDBG<U, G>::getUnitigRange() const { return const_range(this); }
 
-                    l_ignored_km_tip.push_back(front.backwardBase(alpha[i]).rep());
+template<typename U, typename G>
+template<typename F>
+bool CompactedDBG<U, G>::parallel_for_each(const size_t nb_threads, F f) {
 
-                    --found_fp_bw;
-                }
-            }
+    if (invalid){
 
-            front = bw;
-            c = alpha[j];
+        cerr << "CompactedDBG::parallel_for_each(): Graph is invalid" << endl;
+        return false;
+    }
 
-            return true;
-        }
+    if (nb_threads == 0){
 
+        cerr << "CompactedDBG::parallel_for_each(): Number of threads cannot be less than or equal to 0" << endl;
         return false;
     }
 
+    getUnitigRange().parallel_for_each(nb_threads, f);
+
     return true;
 }
 
 template<typename U, typename G>
-bool CompactedDBG<U, G>::fwStepBBF(const Kmer km, Kmer& end, char& c, bool& has_no_neighbor, vector<Kmer>& l_ignored_km_tip, const bool check_fp_cand) const {
-
-    char km_tmp[MAX_KMER_SIZE];
+template<typename F>
+bool CompactedDBG<U, G>::parallel_for_each(const size_t nb_threads, F f) const {
 
-    int found_fp_fw = 0;
+    if (invalid){
 
-    bool neigh_fw[4] = {false, false, false, false};
-    uint64_t hashes_fw[4];
+        cerr << "CompactedDBG::parallel_for_each(): Graph is invalid" << endl;
+        return false;
+    }
 
-    RepHash rep_h(k_), rep_h_cpy;
+    if (nb_threads == 0){
 
-    end.toString(km_tmp);
-    rep_h.init(km_tmp);
+        cerr << "CompactedDBG::parallel_for_each(): Number of threads cannot be less than or equal to 0" << endl;
+        return false;
+    }
 
-    rep_h_cpy = rep_h;
-    rep_h_cpy.updateFW(km_tmp[0], alpha[0]);
-    hashes_fw[0] = rep_h_cpy.hash();
+    getUnitigRange().parallel_for_each(nb_threads, f);
 
-    rep_h_cpy = rep_h;
-    rep_h_cpy.updateFW(km_tmp[0], alpha[1]);
-    hashes_fw[1] = rep_h_cpy.hash();
+    return true;
+}
 
-    rep_h_cpy = rep_h;
-    rep_h_cpy.updateFW(km_tmp[0], alpha[2]);
-    hashes_fw[2] = rep_h_cpy.hash();
+template<typename U, typename G>
+size_t CompactedDBG<U, G>::length() const {
 
-    rep_h_cpy = rep_h;
-    rep_h_cpy.updateFW(km_tmp[0], alpha[3]);
-    hashes_fw[3] = rep_h_cpy.hash();
+    size_t len = 0;
 
-    std::memmove(km_tmp, km_tmp + 1, (k_ - 1) * sizeof(char));
+    if (!invalid){
 
-    const uint64_t it_min_h_fw = minHashKmer<RepHash>(km_tmp, k_, g_, RepHash(), true).getHash();
+        len = (km_unitigs.size() + h_kmers_ccov.size()) * k_;
 
-    size_t nb_neigh = bf.contains(hashes_fw, it_min_h_fw, neigh_fw, 2 * (static_cast<size_t>(check_fp_cand) + 1));
-    size_t j = static_cast<size_t>(neigh_fw[1]) + (2ULL & (static_cast<size_t>(!neigh_fw[2]) - 1)) + (3ULL & (static_cast<size_t>(!neigh_fw[3]) - 1));
+        for (const auto& unitig : v_unitigs) len += unitig->length();
+    }
 
-    if (check_fp_cand && (nb_neigh >= 2)){
+    return len;
+}
 
-        size_t j_tmp = 0;
+template<typename U, typename G>
+size_t CompactedDBG<U, G>::nbKmers() const {
 
-        for (size_t i = 0; i < 4; ++i) {
+    size_t nb = 0;
 
-            if (neigh_fw[i]){
+    if (!invalid){
 
-                char dummy;
-                bool has_no_neighbor_tmp = false;
+        nb = (km_unitigs.size() + h_kmers_ccov.size());
 
-                Kmer km_fp(end.forwardBase(alpha[i]));
+        for (const auto& unitig : v_unitigs) nb += unitig->length() - k_ + 1;
+    }
 
-                fwStepBBF(km_fp, km_fp, dummy, has_no_neighbor_tmp, l_ignored_km_tip, false);
+    return nb;
+}
 
-                neigh_fw[i] = has_no_neighbor_tmp && bwStepBBF(km_fp, km_fp, dummy, has_no_neighbor_tmp, l_ignored_km_tip, false);
+template<typename U, typename G>
+bool CompactedDBG<U, G>::filter(const CDBG_Build_opt& opt, const size_t nb_unique_kmers, const size_t nb_non_unique_kmers) {
 
-                found_fp_fw += neigh_fw[i];
-                j_tmp += (i - j_tmp) & (static_cast<size_t>(neigh_fw[i]) - 1);
-            }
-        }
+    if (invalid){
 
-        if (found_fp_fw){
+        cerr << "CompactedDBG::filter(): Graph is invalid and it cannot be built" << endl;
+        return false;
+    }
 
-            if (nb_neigh - found_fp_fw){
+    BlockedBloomFilter bf_tmp;
 
-                j = j_tmp;
-                nb_neigh -= found_fp_fw;
-            }
-            else found_fp_fw = 0;
-        }
-    }
+    const bool reference_mode = (opt.filename_ref_in.size() != 0);
 
-    if (nb_neigh != 1) {
+    if (reference_mode){
 
-        has_no_neighbor = (nb_neigh == 0);
-        return false;
+        BlockedBloomFilter tmp(nb_unique_kmers, opt.nb_bits_unique_kmers_bf);
+        bf = std::move(tmp);
     }
-    else has_no_neighbor = false;
+    else {
 
-    if (check_fp_cand){
+        {
+            BlockedBloomFilter tmp(nb_unique_kmers, opt.nb_bits_unique_kmers_bf);
+            bf_tmp = std::move(tmp);
+        }
 
-        int found_fp_bw = 0;
+        {
+            BlockedBloomFilter tmp(nb_non_unique_kmers, opt.nb_bits_non_unique_kmers_bf);
+            bf = std::move(tmp);
+        }
+    }
 
-        bool neigh_bw[4] = {false, false, false, false};
-        uint64_t hashes_bw[4];
+    string s;
 
-        const Kmer fw(end.forwardBase(alpha[j]));
+    size_t len_read = 0;
+    size_t pos_read = 0;
+    size_t nb_seq = 0;
 
-        fw.toString(km_tmp);
-        rep_h.init(km_tmp);
+    //const size_t max_len_seq = 1024;
+    //const size_t thread_seq_buf_sz = 64 * max_len_seq;
+    const size_t max_len_seq = rndup(static_cast<size_t>(1024 + k_ - 1));
+    const size_t thread_seq_buf_sz = BUFFER_SIZE;
 
-        rep_h_cpy = rep_h;
-        rep_h_cpy.updateBW(km_tmp[k_ - 1], alpha[0]);
-        hashes_bw[0] = rep_h_cpy.hash();
+    const bool multi_threaded = (opt.nb_threads != 1);
 
-        rep_h_cpy = rep_h;
-        rep_h_cpy.updateBW(km_tmp[k_ - 1], alpha[1]);
-        hashes_bw[1] = rep_h_cpy.hash();
+    atomic<uint64_t> num_kmers(0), num_ins(0);
 
-        rep_h_cpy = rep_h;
-        rep_h_cpy.updateBW(km_tmp[k_ - 1], alpha[2]);
-        hashes_bw[2] = rep_h_cpy.hash();
+    const vector<string>& filename_in = reference_mode ? opt.filename_ref_in : opt.filename_seq_in;
 
-        rep_h_cpy = rep_h;
-        rep_h_cpy.updateBW(km_tmp[k_ - 1], alpha[3]);
-        hashes_bw[3] = rep_h_cpy.hash();
+    FileParser fp(filename_in);
 
-        std::memmove(km_tmp + 1, km_tmp, (k_ - 1) * sizeof(char));
+    // Main worker thread
+    auto worker_function = [&](char* seq_buf, const size_t seq_buf_sz) {
 
-        const uint64_t it_min_h_bw = minHashKmer<RepHash>(km_tmp, k_, g_, RepHash(), true).getHash();
+        uint64_t l_num_kmers = 0, l_num_ins = 0;
 
-        nb_neigh = bf.contains(hashes_bw, it_min_h_bw, neigh_bw, 4);
+        minHashBatch<MinimizerOrderHash, RepHash> mhb(k_, g_, true); // K-mer and minimizer hashes of a sequence chunk
 
-        if (nb_neigh >= 2){
+        bool* is_new = new bool[max_len_seq];
+        uint64_t* km_h_bf = new uint64_t[max_len_seq];
+        uint64_t* min_h_bf = new uint64_t[max_len_seq];
 
-            for (size_t i = 0; i < 4; ++i) {
+        char* str = seq_buf;
+        const char* str_end = &seq_buf[seq_buf_sz];
 
-                if (neigh_bw[i]){
+        while (str < str_end) { // for each input
 
-                    char dummy;
-                    bool has_no_neighbor_tmp = false;
+            const int len = strlen(str);
 
-                    Kmer km_fp(fw.backwardBase(alpha[i]));
+            for (char* s = str; s != str + len; ++s) *s &= 0xDF; // Put characters in upper case
 
-                    bwStepBBF(km_fp, km_fp, dummy, has_no_neighbor_tmp, l_ignored_km_tip, false);
+            for (int i = 0; i <= len - k_; i += max_len_seq - k_ + 1){
 
-                    neigh_bw[i] = has_no_neighbor_tmp && fwStepBBF(km_fp, km_fp, dummy, has_no_neighbor_tmp, l_ignored_km_tip, false);
+                const int curr_len = min(len - i, static_cast<int>(max_len_seq));
 
-                    if (neigh_bw[i] && (km_fp == km)){
+                mhb.compute(&str[i], curr_len);
 
-                        found_fp_bw = 0;
-                        break;
-                    }
-                    else found_fp_bw += (neigh_bw[i] && (km_fp != km));
-                }
-            }
+                const size_t nb_km = mhb.size();
 
-            if (found_fp_bw){
+                const uint64_t* km_h = mhb.getKmerHashes();
+                const uint64_t* min_h = mhb.getMinHashes();
 
-                if (nb_neigh - found_fp_bw) nb_neigh -= found_fp_bw;
-                else found_fp_bw = 0;
-            }
-        }
+                if (reference_mode) l_num_ins += bf.insert(km_h, min_h, nb_km, nullptr, multi_threaded);
+                else {
 
-        if (nb_neigh != 1) return false;
+                    size_t nb_km_bf = 0;
 
-        if (fw != km) {
+                    l_num_ins += bf_tmp.insert(km_h, min_h, nb_km, is_new, multi_threaded);
 
-            for (size_t i = 0; (i < 4) && (found_fp_bw != 0); ++i) {
+                    for (size_t j = 0; j < nb_km; ++j) { // K-mers already in bf_tmp are inserted in bf
 
-                if (neigh_bw[i]){
+                        km_h_bf[nb_km_bf] = km_h[j];
+                        min_h_bf[nb_km_bf] = min_h[j];
 
-                    l_ignored_km_tip.push_back(fw.backwardBase(alpha[i]).rep());
+                        nb_km_bf += static_cast<size_t>(!is_new[j]);
+                    }
 
-                    --found_fp_bw;
+                    bf.insert(km_h_bf, min_h_bf, nb_km_bf, nullptr, multi_threaded);
                 }
-            }
 
-            for (size_t i = 0; (i < 4) && (found_fp_fw != 0); ++i) {
+                l_num_kmers += nb_km;
+            }
 
-                if (neigh_fw[i]){
+            str += len + 1;
+        }
 
-                    l_ignored_km_tip.push_back(end.forwardBase(alpha[i]).rep());
+        delete[] is_new;
+        delete[] km_h_bf;
+        delete[] min_h_bf;
 
-                    --found_fp_fw;
-                }
-            }
+        // atomic adds
+        num_kmers += l_num_kmers;
+        num_ins += l_num_ins;
+    };
 
-            end = fw;
-            c = alpha[j];
+    auto reading_function = [&](char* seq_buf, size_t& seq_buf_sz) {
 
-            return true;
-        }
+        size_t file_id = 0;
 
-        return false;
-    }
+        const size_t sz_buf = thread_seq_buf_sz - k_;
 
-    return true;
-}
+        const char* s_str = s.c_str();
 
-// use:  cc = cm.findUnitig(km,s,pos)
-// pre:  s[pos,pos+k-1] is the kmer km
-// post: cc contains either the reference to the unitig position
-//       or empty if none found
-template<typename U, typename G>
-UnitigMap<U, G> CompactedDBG<U, G>::findUnitig(const Kmer& km, const char* s, const size_t pos) {
+        seq_buf_sz = 0;
 
-    // need to check if we find it right away, need to treat this common case
-    UnitigMap<U, G> um = find(km);
+        while (seq_buf_sz < sz_buf) {
 
-    if (!um.isEmpty && !um.isShort && !um.isAbundant){
+            const bool new_reading = (pos_read >= len_read);
 
-        const size_t mask = static_cast<size_t>(um.strand) - 1;
+            if (!new_reading || fp.read(s, file_id)) {
 
-        um.len = v_unitigs[um.pos_unitig]->getSeq().jump(s, pos, um.dist + ((k_ - 1) & mask), !um.strand) - k_ + 1;
-        um.dist = um.dist - ((um.len - 1) & mask);
-    }
+                nb_seq += new_reading;
 
-    return um;
-}
+                //pos_read = (new_reading ? 0 : pos_read);
+                pos_read &= static_cast<size_t>(new_reading) - 1;
 
-template<typename U, typename G>
-UnitigMap<U, G> CompactedDBG<U, G>::findUnitig(const char* s, const size_t pos, const size_t len) {
+                len_read = s.length();
+                s_str = s.c_str();
 
-    if ((len < k_) || (pos > len - k_)) return UnitigMap<U, G>();
+                if (len_read >= k_){
 
-    for (size_t i = pos; i != pos + k_; ++i){
+                    if ((thread_seq_buf_sz - seq_buf_sz - 1) < (len_read - pos_read)){
 
-        if (!isDNA(s[i])) return UnitigMap<U, G>();
-    }
+                        strncpy(&seq_buf[seq_buf_sz], &s_str[pos_read], thread_seq_buf_sz - seq_buf_sz - 1);
 
-    // need to check if we find it right away, need to treat this common case
-    UnitigMap<U, G> um = find(Kmer(s + pos));
+                        seq_buf[thread_seq_buf_sz - 1] = '\0';
 
-    if (!um.isEmpty && !um.isShort && !um.isAbundant){
+                        pos_read += sz_buf - seq_buf_sz;
+                        seq_buf_sz = thread_seq_buf_sz;
 
-        const size_t mask = static_cast<size_t>(um.strand) - 1;
+                        break;
+                    }
+                    else {
 
-        um.len = v_unitigs[um.pos_unitig]->getSeq().jump(s, pos, um.dist + ((k_ - 1) & mask), !um.strand) - k_ + 1;
-        um.dist = um.dist - ((um.len - 1) & mask);
-    }
+                        strcpy(&seq_buf[seq_buf_sz], &s_str[pos_read]);
 
-    return um;
-}
+                        seq_buf_sz += (len_read - pos_read) + 1;
+                        pos_read = len_read;
+                    }
+                }
+                else pos_read = len_read;
+            }
+            else return true;
+        }
 
-template<typename U, typename G>
-const_UnitigMap<U, G> CompactedDBG<U, G>::findUnitig(const char* s, const size_t pos, const size_t len) const {
+        return false;
+    };
 
-    if ((len < k_) || (pos > len - k_)) return const_UnitigMap<U, G>();
+    {
+        bool stop = false;
 
-    for (size_t i = pos; i != pos + k_; ++i){
+        vector<thread> workers; // need to keep track of threads so we can join them
 
-        if (!isDNA(s[i])) return const_UnitigMap<U, G>();
-    }
+        mutex mutex_file;
 
-    // need to check if we find it right away, need to treat this common case
-    const_UnitigMap<U, G> um = find(Kmer(s + pos));
+        for (size_t t = 0; t < opt.nb_threads; ++t){
 
-    if (!um.isEmpty && !um.isShort && !um.isAbundant){
+            workers.emplace_back(
 
-        const size_t mask = static_cast<size_t>(um.strand) - 1;
+                [&]{
 
-        um.len = v_unitigs[um.pos_unitig]->getSeq().jump(s, pos, um.dist + ((k_ - 1) & mask), !um.strand) - k_ + 1;
-        um.dist = um.dist - ((um.len - 1) & mask);
-    }
+                    char* buffer_seq = new char[thread_seq_buf_sz]();
 
-    return um;
-}
+                    size_t buffer_seq_sz = 0;
 
-template<typename U, typename G>
-UnitigMap<U, G> CompactedDBG<U, G>::findUnitig(const char* s, const size_t pos, const size_t len, const minHashIterator<RepHash>& it_min) {
+                    while (true) {
 
-    if ((len < k_) || (pos > len - k_)) return UnitigMap<U, G>();
+                        {
+                            unique_lock<mutex> lock(mutex_file);
 
-    for (size_t i = pos; i != pos + k_; ++i){
+                            if (stop) {
 
-        if (!isDNA(s[i])) return UnitigMap<U, G>();
-    }
+                                delete[] buffer_seq;
+                                return;
+                            }
 
-    // need to check if we find it right away, need to treat this common case
-    UnitigMap<U, G> um = find(s, pos, it_min);
+                            stop = reading_function(buffer_seq, buffer_seq_sz);
+                        }
 
-    if (!um.isEmpty && !um.isShort && !um.isAbundant){
+                        worker_function(buffer_seq, buffer_seq_sz);
+                    }
 
-        const size_t mask = static_cast<size_t>(um.strand) - 1;
+                    delete[] buffer_seq;
+                }
+            );
+        }
 
-        um.len = v_unitigs[um.pos_unitig]->getSeq().jump(s, pos, um.dist + ((k_ - 1) & mask), !um.strand) - k_ + 1;
-        um.dist = um.dist - ((um.len - 1) & mask);
+        for (auto& t : workers) t.join();
     }
 
-    return um;
-}
+    fp.close();
 
-template<typename U, typename G>
-const_UnitigMap<U, G> CompactedDBG<U, G>::findUnitig(const char* s, const size_t pos, const size_t len, const minHashIterator<RepHash>& it_min) const {
+    if (opt.verbose) {
 
-    if ((len < k_) || (pos > len - k_)) return const_UnitigMap<U, G>();
+        cout << "CompactedDBG::filter(): Closed all fasta/fastq files" << endl;
+        cout << "CompactedDBG::filter(): Processed " << num_kmers << " k-mers in " << nb_seq  << " reads" << endl;
+        cout << "CompactedDBG::filter(): Found " << num_ins << " unique k-mers" << endl;
+        cout << "CompactedDBG::filter(): Number of blocks in Bloom filter is " << bf.getNbBlocks() << endl;
+    }
 
-    for (size_t i = pos; i != pos + k_; ++i){
+    if (opt.useMercyKmers && !reference_mode){
 
-        if (!isDNA(s[i])) return const_UnitigMap<U, G>();
-    }
+        const string mbbf_uniq_filename(opt.prefixFilenameOut + "_uniq");
 
-    // need to check if we find it right away, need to treat this common case
-    const_UnitigMap<U, G> um = find(s, pos, it_min);
+        FILE* f_mbbf = fopen(mbbf_uniq_filename.c_str(), "wb");
 
-    if (!um.isEmpty && !um.isShort && !um.isAbundant){
+        if (f_mbbf == NULL){
 
-        const size_t mask = static_cast<size_t>(um.strand) - 1;
+            cerr << "CompactedDBG::filter(): Minimizer Blocked Bloom filter of unique k-mers cannot be written to disk" << endl;
+            return false;
+        }
 
-        um.len = v_unitigs[um.pos_unitig]->getSeq().jump(s, pos, um.dist + ((k_ - 1) & mask), !um.strand) - k_ + 1;
-        um.dist = um.dist - ((um.len - 1) & mask);
+        bf_tmp.WriteBloomFilter(f_mbbf);
+
+        fclose(f_mbbf);
     }
 
-    return um;
+    return true;
 }
 
 template<typename U, typename G>
-UnitigMap<U, G> CompactedDBG<U, G>::findUnitig(const Kmer& km, const char* s, const size_t pos, const preAllocMinHashIterator<RepHash>& it_min_h) {
+bool CompactedDBG<U, G>::construct(const CDBG_Build_opt& opt, const size_t nb_unique_minimizers, const size_t nb_non_unique_minimizers){
 
-    // need to check if we find it right away, need to treat this common case
-    UnitigMap<U, G> um = find(km, it_min_h);
+    if (invalid){
 
-    if (!um.isEmpty && !um.isShort && !um.isAbundant){
+        cerr << "CompactedDBG::construct(): Graph is invalid and cannot be built" << endl;
+        return false;
+    }
 
-        const size_t mask = static_cast<size_t>(um.strand) - 1;
+    const bool reference_mode = (opt.filename_ref_in.size() != 0);
 
-        um.len = v_unitigs[um.pos_unitig]->getSeq().jump(s, pos, um.dist + ((k_ - 1) & mask), !um.strand) - k_ + 1;
-        um.dist = um.dist - ((um.len - 1) & mask);
-    }
+    const vector<string>& filename_in = reference_mode ? opt.filename_ref_in : opt.filename_seq_in;
 
-    return um;
-}
+    FileParser fp(filename_in);
 
-template<typename U, typename G>
-bool CompactedDBG<U, G>::addUnitig(const string& str_unitig, const size_t id_unitig){
+    string s;
 
-    int pos;
+    size_t len_read = 0;
+    size_t pos_read = 0;
 
-    const size_t len = str_unitig.size();
-    size_t pos_id_unitig = id_unitig << 32;
+    //const size_t max_len_seq = 1024;
+    //const size_t thread_seq_buf_sz = 64 * max_len_seq;
+    const size_t max_len_seq = rndup(static_cast<size_t>(1024 + k_ - 1));
+    const size_t thread_seq_buf_sz = BUFFER_SIZE;
 
-    const size_t mask = MASK_CONTIG_ID | MASK_CONTIG_TYPE;
+    tiny_vector<Kmer, 2>* fp_candidate = nullptr;
 
-    bool isShort = false, isAbundant = false, isForbidden = false;
+    KmerHashTable<bool> ignored_km_tips;
 
-    const char* c_str = str_unitig.c_str();
+    const size_t nb_locks = opt.nb_threads * 1024;
 
-    char km_tmp[MAX_KMER_SIZE];
+    std::atomic_flag lock_ignored_km_tips = ATOMIC_FLAG_INIT;
 
-    Kmer km_rep;
+    vector<SpinLock> locks_fp;
 
-    if (len == k_){ // Unitig to add is short, maybe abundant as well
+    LockGraph lck_g(nb_locks);
 
-        isShort = true;
+    if (!reference_mode){
 
-        pos_id_unitig |= MASK_CONTIG_TYPE;
+        fp_candidate = new tiny_vector<Kmer, 2>[bf.getNbBlocks()];
+        locks_fp = vector<SpinLock>(nb_locks);
 
-        km_rep = Kmer(c_str).rep();
-        km_rep.toString(km_tmp);
-        c_str = km_tmp;
+        MinimizerIndex hmap_min_unitigs_tmp(nb_non_unique_minimizers * 1.05);
+
+        hmap_min_unitigs = std::move(hmap_min_unitigs_tmp);
+
+        initSparseSkipped(nb_non_unique_minimizers);
     }
+    else {
 
-    minHashIterator<RepHash> it_min(c_str, len, k_, g_, RepHash(), true), it_min_end;
-    minHashResult mhr, mhr_tmp;
+        MinimizerIndex hmap_min_unitigs_tmp(nb_unique_minimizers * 1.05);
 
-    for (int64_t last_pos_min = -1; it_min != it_min_end; ++it_min){
+        hmap_min_unitigs = std::move(hmap_min_unitigs_tmp);
 
-        //If current minimizer was not seen before
-        if ((last_pos_min < it_min.getPosition()) || isForbidden){
+        initSparseSkipped(nb_unique_minimizers);
+    }
 
-            minHashResultIterator<RepHash> it_it_min = *it_min, it_it_min_end;
-            isForbidden = false;
+    auto worker_function = [&](char* seq_buf, const size_t seq_buf_sz) {
 
-            while (it_it_min != it_it_min_end){
+        vector<Kmer> l_ignored_km_tips;
 
-                const minHashResult& min_h_res = *it_it_min;
-                Minimizer minz_rep = Minimizer(c_str + min_h_res.pos).rep(); //Get the minimizer to insert
-                std::pair<MinimizerIndex::iterator, bool> p = hmap_min_unitigs.insert(minz_rep, packed_tiny_vector(), 0);
-                packed_tiny_vector* pck_tinyv = &(p.first.getVector());
-                size_t flag = p.first.getVectorSize();
-                size_t v_sz = pck_tinyv->size(flag);
+        Kmer km;
+        MinimizerOrderHash rep;
 
-                pos = min_h_res.pos;
-                pos_id_unitig = (pos_id_unitig & mask) | ((size_t) pos);
+        char* str = seq_buf;
+        const char* str_end = &seq_buf[seq_buf_sz];
 
-                if (!isShort){
+        while (str < str_end) { // for each input
 
-                    mhr = min_h_res;
+            const int len = strlen(str);
 
-                    while ((v_sz >= max_abundance_lim) || ((v_sz > 0) && (((*pck_tinyv)(v_sz-1, flag) & mask) == mask))){
+            for (char* s = str; s != &str[len]; ++s) *s &= 0xDF;
 
-                        mhr_tmp = it_min.getNewMin(mhr);
-                        isForbidden = true;
+            for (size_t i = 0; i < len - k_ + 1; i += max_len_seq - k_ + 1){
 
-                        if (mhr_tmp.hash != mhr.hash){
+                const int curr_len = min(len - i, max_len_seq);
+                const char saved_char = str[i + curr_len];
+                const char* str_tmp = &str[i];
 
-                            if (((*pck_tinyv)(v_sz-1, flag) & mask) != mask){ // Minimizer was never signaled before as overcrowded
+                str[i + curr_len] = '\0';
 
-                                // If minimizer bin already contains abundant k-mer, just set flag for unitig overcrowding
-                                if (((*pck_tinyv)(v_sz-1, flag) & MASK_CONTIG_ID) == MASK_CONTIG_ID) (*pck_tinyv)(v_sz-1, flag) |= MASK_CONTIG_TYPE;
-                                else p.first.getVectorSize() = (flag = pck_tinyv->push_back(mask, flag));
-                            }
+                KmerHashIterator<RepHash> it_kmer_h(str_tmp, curr_len, k_), it_kmer_h_end;
+                minHashIterator<MinimizerOrderHash> it_min(str_tmp, curr_len, k_, g_, rep, true);
 
-                            mhr = mhr_tmp;
-                            minz_rep = Minimizer(c_str + mhr.pos).rep();
+                for (; it_kmer_h != it_kmer_h_end; ++it_kmer_h) {
 
-                            p = hmap_min_unitigs.insert(minz_rep, packed_tiny_vector(), 0);
-                            pck_tinyv = &(p.first.getVector());
-                            flag = p.first.getVectorSize();
-                            v_sz = pck_tinyv->size(flag);
-                        }
-                        else break;
-                    }
-                }
+                    const std::pair<uint64_t, int> p_ = *it_kmer_h; // <k-mer hash, k-mer position in sequence>
 
-                packed_tiny_vector& v = p.first.getVector();
-                uint8_t& flag_v = p.first.getVectorSize();
+                    it_min += (p_.second - it_min.getKmerPosition());
 
-                if (v_sz == 0) flag_v = v.push_back(pos_id_unitig, flag_v); //Newly created vector, just push unitig ID
-                else if (isShort && (v_sz >= min_abundance_lim)){ //The minimizer (is/might be) too abundant
+                    const uint64_t it_min_h = it_min.getHash();
+                    const int bid = bf.contains_bids(p_.first, it_min_h);
 
-                    isShort = false;
-                    isAbundant = true;
+                    if (bid != -1){
 
-                    it_min = it_min_end;
+                        km = Kmer(str_tmp + p_.second);
 
-                    break;
-                }
-                else if ((v(v_sz-1, flag_v) & MASK_CONTIG_ID) == MASK_CONTIG_ID){ //If minimizer is abundant or crowded
+                        lck_g.acquire_reader();
 
-                    if ((v_sz == 1) || (v(v_sz-2, flag_v) != pos_id_unitig)) flag_v = v.insert(pos_id_unitig, v_sz-1, flag_v);
-                }
-                else if (v(v_sz-1, flag_v) != pos_id_unitig) flag_v = v.push_back(pos_id_unitig, flag_v);
+                        const UnitigMap<U, G> um = findUnitig(km, str_tmp, p_.second);
 
-                last_pos_min = min_h_res.pos;
-                ++it_it_min;
-            }
-        }
-    }
+                        if (um.isEmpty) { // kmer did not map, push into queue for next unitig generation round
 
-    if (isAbundant){
+                            lck_g.release_reader();
 
-        if (id_unitig == km_unitigs.size()) km_unitigs.push_back(km_rep);
-        else km_unitigs.set(id_unitig, km_rep);
+                            string newseq;
 
-        deleteUnitig_<is_void<U>::value>(true, false, id_unitig, false);
+                            bool isIsolated = false;
 
-        if (id_unitig == km_unitigs.size() - 1) km_unitigs.resize(km_unitigs.size() - 1);
+                            const size_t pos_match = findUnitigSequenceBBF(km, newseq, isIsolated, l_ignored_km_tips); //Build unitig from Bloom filter
 
-        it_min = minHashIterator<RepHash>(c_str, len, k_, g_, RepHash(), true);
+                            if (!reference_mode && isIsolated){ // According to the BF, k-mer is isolated in the graph and is a potential false positive
 
-        for (int64_t last_pos_min = -1; it_min != it_min_end; ++it_min){
+                                const uint64_t id_lock = bid % nb_locks;
+                                const Kmer km_rep(km.rep());
 
-            if (last_pos_min < it_min.getPosition()){ //If current minimizer was not seen before
+                                tiny_vector<Kmer, 2>& v = fp_candidate[bid];
 
-                minHashResultIterator<RepHash> it_it_min = *it_min, it_it_min_end;
+                                size_t i = 0;
 
-                while (it_it_min != it_it_min_end){
+                                locks_fp[id_lock].acquire();
 
-                    const minHashResult& min_h_res = *it_it_min;
-                    Minimizer minz_rep = Minimizer(c_str + min_h_res.pos).rep(); //Get the minimizer to insert
-                    std::pair<MinimizerIndex::iterator, bool> p = hmap_min_unitigs.insert(minz_rep, packed_tiny_vector(), 0);
-                    packed_tiny_vector& v = p.first.getVector();
-                    uint8_t& flag_v = p.first.getVectorSize();
-                    const size_t v_sz = v.size(flag_v);
+                                for (; i < v.size(); ++i){ // Search list of fp candidate for k-mer
 
-                    if ((v_sz > 0) && ((v(v_sz-1, flag_v) & MASK_CONTIG_ID) == MASK_CONTIG_ID)) v(v_sz-1, flag_v)++;
-                    else flag_v = v.push_back(MASK_CONTIG_ID + 1, flag_v);
+                                    if (v[i] == km_rep) break;
+                                }
 
-                    last_pos_min = min_h_res.pos;
-                    ++it_it_min;
-                }
-            }
-        }
+                                if (i >= v.size()){
 
-        h_kmers_ccov.insert(km_rep, CompressedCoverage_t<U>(1));
-    }
-    else if (isShort){
+                                    v.push_back(km_rep);
 
-        if (id_unitig == km_unitigs.size()) km_unitigs.push_back(km_rep);
-        else km_unitigs.set(id_unitig, km_rep);
-    }
-    else if (id_unitig == v_unitigs.size()) v_unitigs.push_back(new Unitig<U>(c_str)); //Push unitig to list of unitigs
-    else v_unitigs[id_unitig] = new Unitig<U>(c_str);
+                                    locks_fp[id_lock].release();
+                                }
+                                else {
 
-    return isAbundant;
-}
+                                    v.remove(i);
 
-template<typename U, typename G>
-void CompactedDBG<U, G>::moveToAbundant() {
+                                    locks_fp[id_lock].release();
 
-    MinimizerIndex::iterator it = hmap_min_unitigs.begin();
-    MinimizerIndex::iterator it_end = hmap_min_unitigs.end();
+                                    addUnitigSequenceBBF(km, newseq, pos_match, 1, lck_g);
+                                    addUnitigSequenceBBF(km, newseq, pos_match, 1, lck_g);
+                                }
+                            }
+                            else {
 
-    vector<pair<size_t, string>> to_move;
+                                const size_t len_match_km = 1 + cstrMatch(&str_tmp[p_.second + k_], &(newseq.c_str()[pos_match + k_]));
 
-    char km_tmp[MAX_KMER_SIZE];
+                                addUnitigSequenceBBF(km, newseq, pos_match, len_match_km, lck_g);
 
-    Kmer km_rep;
+                                it_kmer_h += len_match_km - 1;
+                            }
+                        }
+                        else {
 
-    to_move.reserve(16);
+                            mapRead(um, lck_g);
 
-    while (it != it_end){
+                            lck_g.release_reader();
 
-        const packed_tiny_vector* pck_tinyv = &(it.getVector());
-        const size_t flag = it.getVectorSize();
-        const size_t v_sz = pck_tinyv->size(flag);
+                            it_kmer_h += um.len - 1;
+                        }
+                    }
+                }
 
-        if (v_sz >= min_abundance_lim){
+                str[i + curr_len] = saved_char;
+            }
 
-            for (size_t i = 0; i < v_sz; ++i){
+            str += len + 1;
+        }
 
-                if (static_cast<bool>((*pck_tinyv)(i, flag) | MASK_CONTIG_TYPE)){
+        while (lock_ignored_km_tips.test_and_set(std::memory_order_acquire));
 
-                    size_t unitig_id = (*pck_tinyv)(i, flag) >> 32;
-                    string unitig_str = km_unitigs.getKmer(unitig_id).toString();
+        for (const auto& km_tip : l_ignored_km_tips) ignored_km_tips.insert(km_tip, false);
 
-                    to_move.push_back({std::move(unitig_id), std::move(unitig_str)});
-                }
-            }
+        lock_ignored_km_tips.clear(std::memory_order_release);
+    };
 
-            if (min_abundance_lim > (v_sz - to_move.size())){
+    auto reading_function = [&](char* seq_buf, size_t& seq_buf_sz) {
 
-                for (const auto& p : to_move) deleteUnitig_(true, false, p.first, p.second);
+        size_t file_id = 0;
 
-                for (const auto& p : to_move){
+        const size_t sz_buf = thread_seq_buf_sz - k_;
 
-                    const char* c_str = p.second.c_str();
-                    const size_t len = p.second.length();
+        const char* s_str = s.c_str();
 
-                    km_rep = Kmer(c_str).rep();
-                    c_str = km_tmp;
+        seq_buf_sz = 0;
 
-                    km_rep.toString(km_tmp);
+        while (seq_buf_sz < sz_buf) {
 
-                    minHashIterator<RepHash> it_min = minHashIterator<RepHash>(c_str, len, k_, g_, RepHash(), true), it_min_end;
+            const bool new_reading = (pos_read >= len_read);
 
-                    for (int64_t last_pos_min = -1; it_min != it_min_end; ++it_min){
+            if (!new_reading || fp.read(s, file_id)) {
 
-                        if (last_pos_min < it_min.getPosition()){ //If current minimizer was not seen before
+                pos_read &= static_cast<size_t>(new_reading) - 1;
 
-                            minHashResultIterator<RepHash> it_it_min = *it_min, it_it_min_end;
+                len_read = s.length();
+                s_str = s.c_str();
 
-                            while (it_it_min != it_it_min_end){
+                if (len_read >= k_){
 
-                                const minHashResult& min_h_res = *it_it_min;
-                                Minimizer minz_rep = Minimizer(c_str + min_h_res.pos).rep(); //Get the minimizer to insert
+                    if ((thread_seq_buf_sz - seq_buf_sz - 1) < (len_read - pos_read)){
 
-                                std::pair<MinimizerIndex::iterator, bool> p = hmap_min_unitigs.insert(minz_rep, packed_tiny_vector(), 0);
-                                packed_tiny_vector& v = p.first.getVector();
-                                uint8_t& flag_v = p.first.getVectorSize();
-                                const size_t v_sz = v.size(flag_v);
+                        strncpy(&seq_buf[seq_buf_sz], &s_str[pos_read], thread_seq_buf_sz - seq_buf_sz - 1);
 
-                                if ((v_sz > 0) && ((v(v_sz-1, flag_v) & MASK_CONTIG_ID) == MASK_CONTIG_ID)) v(v_sz-1, flag_v)++;
-                                else flag_v = v.push_back(MASK_CONTIG_ID + 1, flag_v);
+                        seq_buf[thread_seq_buf_sz - 1] = '\0';
 
-                                last_pos_min = min_h_res.pos;
-                                ++it_it_min;
-                            }
-                        }
+                        pos_read += sz_buf - seq_buf_sz;
+                        seq_buf_sz = thread_seq_buf_sz;
+
+                        break;
                     }
+                    else {
 
-                    h_kmers_ccov.insert(km_rep, CompressedCoverage_t<U>(1));
+                        strcpy(&seq_buf[seq_buf_sz], &s_str[pos_read]);
+
+                        seq_buf_sz += (len_read - pos_read) + 1;
+                        pos_read = len_read;
+                    }
                 }
+                else pos_read = len_read;
             }
-
-            to_move.clear();
+            else return true;
         }
 
-        ++it;
-    }
-}
+        return false;
+    };
 
-template<typename U, typename G>
-bool CompactedDBG<U, G>::addUnitig(const string& str_unitig, const size_t id_unitig, SpinLock& lck_unitig, SpinLock& lck_kmer){
+    {
+        bool stop = false;
 
-    int pos;
+        vector<thread> workers; // need to keep track of threads so we can join them
 
-    const size_t len = str_unitig.size();
-    size_t pos_id_unitig = id_unitig << 32;
+        mutex mutex_file;
 
-    const size_t mask = MASK_CONTIG_ID | MASK_CONTIG_TYPE;
+        if (opt.verbose) cout << "CompactedDBG::construct(): Extract approximate unitigs" << endl;
 
-    bool isShort = false, isAbundant = false, isForbidden = false;
+        for (size_t t = 0; t < opt.nb_threads; ++t){
 
-    const char* c_str = str_unitig.c_str();
+            workers.emplace_back(
 
-    char km_tmp[MAX_KMER_SIZE];
+                [&]{
 
-    Kmer km_rep;
+                    char* buffer_seq = new char[thread_seq_buf_sz];
 
-    if (len == k_){ // Unitig to add is short, maybe abundant as well
+                    size_t buffer_seq_sz = 0;
 
-        isShort = true;
+                    while (true) {
 
-        pos_id_unitig |= MASK_CONTIG_TYPE;
+                        {
+                            unique_lock<mutex> lock(mutex_file);
 
-        km_rep = Kmer(c_str).rep();
-        km_rep.toString(km_tmp);
-        c_str = km_tmp;
-    }
+                            if (stop) {
 
-    minHashIterator<RepHash> it_min(c_str, len, k_, g_, RepHash(), true), it_min_end;
-    minHashResult mhr, mhr_tmp;
+                                delete[] buffer_seq;
+                                return;
+                            }
 
-    for (int64_t last_pos_min = -1; it_min != it_min_end; ++it_min){
+                            stop = reading_function(buffer_seq, buffer_seq_sz);
+                        }
 
-        //If current minimizer was not seen before
-        if ((last_pos_min < it_min.getPosition()) || isForbidden){
+                        worker_function(buffer_seq, buffer_seq_sz);
+                    }
 
-            minHashResultIterator<RepHash> it_it_min = *it_min, it_it_min_end;
-            isForbidden = false;
+                    delete[] buffer_seq;
+                }
+            );
+        }
 
-            while (it_it_min != it_it_min_end){
+        for (auto& t : workers) t.join();
+    }
 
-                const minHashResult& min_h_res = *it_it_min;
-                Minimizer minz_rep = Minimizer(c_str + min_h_res.pos).rep(); //Get the minimizer to insert
+    fp.close();
 
-                pos = min_h_res.pos;
-                pos_id_unitig = (pos_id_unitig & mask) | ((size_t) pos);
+    bf.clear();
+    lck_g.clear();
+    locks_fp.clear();
 
-                std::pair<MinimizerIndex::iterator, bool> p = hmap_min_unitigs.insert_p(minz_rep, packed_tiny_vector(), 0);
-                packed_tiny_vector* pck_tinyv = &(p.first.getVector());
-                size_t flag = p.first.getVectorSize();
-                size_t v_sz = pck_tinyv->size(flag);
+    if (fp_candidate != nullptr) delete[] fp_candidate;
 
-                if (!isShort){
+    if (opt.verbose) cout << "CompactedDBG::construct(): Closed all input files" << endl;
 
-                    mhr = min_h_res;
+    const size_t unitigsBefore = size();
 
-                    while ((v_sz >= max_abundance_lim) || ((v_sz > 0) && (((*pck_tinyv)(v_sz-1, flag) & mask) == mask))){
+    if (opt.verbose) cout << endl << "CompactedDBG::construct(): Splitting unitigs (1/2)" << endl;
 
-                        mhr_tmp = it_min.getNewMin(mhr);
-                        isForbidden = true;
+    pair<size_t, size_t> unitigSplit = extractAllUnitigs();
 
-                        if (mhr_tmp.hash != mhr.hash){
+    const int unitigsAfter1 = size();
 
-                            if (((*pck_tinyv)(v_sz-1, flag) & mask) != mask){ // Minimizer was never signaled before as overcrowded
+    if (opt.verbose) cout << endl << "CompactedDBG::construct(): Splitting unitigs (2/2)" << endl;
 
-                                // If minimizer bin already contains abundant k-mer, just set flag for unitig overcrowding
-                                if (((*pck_tinyv)(v_sz-1, flag) & MASK_CONTIG_ID) == MASK_CONTIG_ID) (*pck_tinyv)(v_sz-1, flag) |= MASK_CONTIG_TYPE;
-                                else p.first.getVectorSize() = (flag = pck_tinyv->push_back(mask, flag));
-                            }
+    check_fp_tips(ignored_km_tips);
+    ignored_km_tips.clear_tables();
 
-                            hmap_min_unitigs.release_p(p.first);
+    const int unitigsAfter2 = size();
 
-                            mhr = mhr_tmp;
-                            minz_rep = Minimizer(c_str + mhr.pos).rep();
+    if (opt.verbose) {
 
-                            p = hmap_min_unitigs.insert_p(minz_rep, packed_tiny_vector(), 0);
-                            pck_tinyv = &(p.first.getVector());
-                            flag = p.first.getVectorSize();
-                            v_sz = pck_tinyv->size(flag);
-                        }
-                        else break;
-                    }
-                }
+        cout << "CompactedDBG::construct(): Before split: " << unitigsBefore << " unitigs" << endl;
+        cout << "CompactedDBG::construct(): After split (1/" << (reference_mode ? "1" : "2" ) << "): " << unitigsAfter1 << " unitigs" <<  endl;
+        if (!reference_mode) cout << "CompactedDBG::construct(): After split (2/2): " << unitigsAfter2 << " unitigs" <<  endl;
+        cout << "CompactedDBG::construct(): Unitigs split: " << unitigSplit.first << endl;
+        cout << "CompactedDBG::construct(): Unitigs deleted: " << unitigSplit.second << endl;
 
-                packed_tiny_vector& v = p.first.getVector();
-                uint8_t& flag_v = p.first.getVectorSize();
+        cout << endl << "CompactedDBG::construct(): Joining unitigs" << endl;
+    }
 
-                if (v_sz == 0) flag_v = v.push_back(pos_id_unitig, flag_v); //Newly created vector, just push unitig ID
-                else if ((v(v_sz-1, flag_v) & MASK_CONTIG_ID) == MASK_CONTIG_ID){ //If minimizer is abundant or crowded
+    const size_t joined = joinUnitigs_<is_void<U>::value>(nullptr, opt.nb_threads);
 
-                    if ((v_sz == 1) || (v(v_sz-2, flag_v) != pos_id_unitig)) flag_v = v.insert(pos_id_unitig, v_sz-1, flag_v);
-                }
-                else if (v(v_sz-1, flag_v) != pos_id_unitig) flag_v = v.push_back(pos_id_unitig, flag_v);
+    const int unitigsAfter3 = size();
 
-                hmap_min_unitigs.release_p(p.first);
+    if (opt.verbose) {
 
-                last_pos_min = min_h_res.pos;
-                ++it_it_min;
-            }
-        }
+        cout << "CompactedDBG::construct(): After join: " << unitigsAfter3 << " unitigs" << endl;
+        cout << "CompactedDBG::construct(): Joined " << joined << " unitigs" << endl;
     }
 
-    if (isShort){
-
-        lck_kmer.acquire();
-
-        if (id_unitig >= km_unitigs.size()) km_unitigs.resize(id_unitig + 1);
-
-        km_unitigs.set(id_unitig, km_rep);
+    if (opt.useMercyKmers && !reference_mode){
 
-        lck_kmer.release();
-    }
-    else {
+        string filename_mbbf_uniq_km = opt.prefixFilenameOut + "_uniq";
 
-        lck_unitig.acquire();
+        joinTips(filename_mbbf_uniq_km, opt.nb_threads, opt.verbose);
 
-        if (id_unitig >= v_unitigs.size()) v_unitigs.resize(id_unitig + 1);
+        if (opt.verbose) cout << "CompactedDBG::construct(): After join tips using mercy k-mers: " << size() << " unitigs" << endl;
 
-        v_unitigs[id_unitig] = new Unitig<U>(c_str); //Push unitig to list of unitigs
+        if (std::remove(filename_mbbf_uniq_km.c_str()) != 0) {
 
-        lck_unitig.release();
+            cerr << "CompactedDBG::construct(): Minimizer Blocked Bloom filter file of unique k-mers cannot be removed from disk" << endl;
+        }
     }
 
-    return isAbundant;
+    return true;
 }
 
 template<typename U, typename G>
-bool CompactedDBG<U, G>::addUnitig(const string& str_unitig, const size_t id_unitig, const size_t id_unitig_r, const size_t is_short_r){
-
-    int pos;
-
-    const size_t pos_id_unitig_r = (id_unitig_r << 32) | (is_short_r ? MASK_CONTIG_TYPE : 0);
+bool CompactedDBG<U, G>::addUnitigSequenceBBF(const Kmer km, const string& seq, const size_t pos_match_km, const size_t len_match_km, LockGraph& lck_g) {
 
-    const size_t len = str_unitig.size();
-    const size_t mask = MASK_CONTIG_ID | MASK_CONTIG_TYPE;
+    bool isAbundant = false;
 
-    size_t pos_id_unitig = id_unitig << 32;
-    size_t i = 0;
+    const bool isShort = (seq.length() == k_);
 
-    bool isShort = false, isAbundant = false, isForbidden = false;
+    lck_g.acquire_writer();
 
-    const char* c_str = str_unitig.c_str();
+    const size_t id_unitig = isShort ? km_unitigs.size() : v_unitigs.size();
 
-    char km_tmp[MAX_KMER_SIZE];
+    UnitigMap<U, G> um = find(km); // Look if unitig was already inserted
 
-    Kmer km_rep;
+    if (um.isEmpty) isAbundant = addUnitig(seq, id_unitig); // If it wasn't already inserted, does it
 
-    if (len == k_){ // Unitig to add is short, maybe abundant as well
+    lck_g.release_writer();
+    lck_g.acquire_reader();
 
-        isShort = true;
+    um = find(km);
+    um.len = len_match_km; // Prepare read mapping
 
-        pos_id_unitig |= MASK_CONTIG_TYPE;
+    if (!um.isShort && !um.isAbundant && !um.strand) um.dist -= um.len - 1;
 
-        km_rep = Kmer(c_str).rep();
-        km_rep.toString(km_tmp);
-        c_str = km_tmp;
-    }
+    if (um.dist + um.len > um.size - k_){ // This is a self loop
 
-    minHashIterator<RepHash> it_min(c_str, len, k_, g_, RepHash(), true), it_min_end;
-    minHashResult mhr, mhr_tmp;
+        KmerIterator it(&(seq.c_str()[pos_match_km]));
 
-    for (int64_t last_pos_min = -1; it_min != it_min_end; ++it_min){
+        for (size_t i = 0; i != len_match_km; ++it, ++i){
 
-        //If current minimizer was not seen before
-        if ((last_pos_min < it_min.getPosition()) || isForbidden){
+            um = find(it->first);
 
-            minHashResultIterator<RepHash> it_it_min = *it_min, it_it_min_end;
+            mapRead(um, lck_g);
+        }
+    }
+    else mapRead(um, lck_g);
+
+    lck_g.release_reader();
+
+    return !um.isEmpty;
+}
+
+// use:  cm.findUnitigSequenceBBF(km, s, selfLoop)
+// pre:  km is in the bloom filter
+// post: s is the unitig containing the kmer km
+//       and the first k-mer in s is smaller (wrt. < operator)
+//       than the last kmer
+//       selfLoop is true of the unitig is a loop or hairpin
+template<typename U, typename G>
+size_t CompactedDBG<U, G>::findUnitigSequenceBBF(Kmer km, string& s, bool& isIsolated, vector<Kmer>& l_ignored_km_tip) {
+
+    string fw_s, bw_s;
+
+    Kmer end(km);
+    Kmer last(end);
+
+    const Kmer twin(km.twin());
+
+    char c;
+
+    size_t j = 0;
+
+    bool has_no_neighbor;
+    bool self_loop = false;
+
+    isIsolated = false;
+
+    while (fwStepBBF(end, end, c, has_no_neighbor, l_ignored_km_tip)) {
+
+        ++j;
+
+        self_loop = (end == km);
+
+        if (self_loop || (end == twin) || (end == last.twin())) break;
+
+        fw_s.push_back(c);
+        last = end;
+    }
+
+    if (!self_loop) {
+
+        Kmer front(km);
+        Kmer first(front);
+
+        isIsolated = (j == 0) && has_no_neighbor;
+        j = 0;
+
+        while (bwStepBBF(front, front, c, has_no_neighbor, l_ignored_km_tip)) {
+
+            ++j;
+
+            if ((front == km) || (front == twin) || (front == first.twin())) break;
+
+            bw_s.push_back(c);
+            first = front;
+        }
+
+        isIsolated = isIsolated && (j == 0) && has_no_neighbor;
+
+        reverse(bw_s.begin(), bw_s.end());
+    }
+
+    char tmp[MAX_KMER_SIZE];
+
+    km.toString(tmp);
+
+    s.reserve(k_ + fw_s.size() + bw_s.size());
+    s.append(bw_s);
+    s.append(tmp);
+    s.append(fw_s);
+
+    return bw_s.size();
+}
+
+template<typename U, typename G>
+bool CompactedDBG<U, G>::bwStepBBF(const Kmer km, Kmer& front, char& c, bool& has_no_neighbor, vector<Kmer>& l_ignored_km_tip, const bool check_fp_cand) const {
+
+    int found_fp_bw = 0;
+
+    bool neigh_bw[4] = {false, false, false, false};
+    uint64_t hashes_bw[4];
+
+    RepHash rep_h(k_), rep_h_cpy;
+
+    rep_h.initCodes([&](const size_t pos){ return front.getCode(pos); });
+
+    rep_h_cpy = rep_h;
+    rep_h_cpy.updateBWCodes(front.getCode(k_ - 1), 0);
+    hashes_bw[0] = rep_h_cpy.hash();
+
+    rep_h_cpy = rep_h;
+    rep_h_cpy.updateBWCodes(front.getCode(k_ - 1), 1);
+    hashes_bw[1] = rep_h_cpy.hash();
+
+    rep_h_cpy = rep_h;
+    rep_h_cpy.updateBWCodes(front.getCode(k_ - 1), 2);
+    hashes_bw[2] = rep_h_cpy.hash();
+
+    rep_h_cpy = rep_h;
+    rep_h_cpy.updateBWCodes(front.getCode(k_ - 1), 3);
+    hashes_bw[3] = rep_h_cpy.hash();
+
+    const uint64_t it_min_h_bw = minHashKmer<MinimizerOrderHash>::getBackwardNeighborHash(front, k_, g_);
+
+    size_t nb_neigh = bf.contains(hashes_bw, it_min_h_bw, neigh_bw, 2 * (static_cast<size_t>(check_fp_cand) + 1));
+    size_t j = static_cast<size_t>(neigh_bw[1]) + (2ULL & (static_cast<size_t>(!neigh_bw[2]) - 1)) + (3ULL & (static_cast<size_t>(!neigh_bw[3]) - 1));
+
+    if (check_fp_cand && (nb_neigh >= 2)){
+
+        size_t j_tmp = 0;
+
+        for (size_t i = 0; i < 4; ++i) {
+
+            if (neigh_bw[i]){
+
+                char dummy;
+                bool has_no_neighbor_tmp = false;
+
+                Kmer km_fp(front.backwardBase(alpha[i]));
+
+                bwStepBBF(km_fp, km_fp, dummy, has_no_neighbor_tmp, l_ignored_km_tip, false);
+
+                neigh_bw[i] = has_no_neighbor_tmp && fwStepBBF(km_fp, km_fp, dummy, has_no_neighbor_tmp, l_ignored_km_tip, false);
+                found_fp_bw += neigh_bw[i];
+                j_tmp += (i - j_tmp) & (static_cast<size_t>(neigh_bw[i]) - 1);
+            }
+        }
+
+        if (found_fp_bw != 0){
+
+            if ((nb_neigh - found_fp_bw) != 0){
+
+                j = j_tmp;
+                nb_neigh -= found_fp_bw;
+            }
+            else found_fp_bw = 0;
+        }
+    }
+
+    if (nb_neigh != 1) {
+
+        has_no_neighbor = (nb_neigh == 0);
+        return false;
+    }
+    else has_no_neighbor = false;
+
+    if (check_fp_cand){
+
+        int found_fp_fw = 0;
+
+        bool neigh_fw[4] = {false, false, false, false};
+        uint64_t hashes_fw[4];
+
+        const Kmer bw(front.backwardBase(alpha[j]));
+
+        rep_h.initCodes([&](const size_t pos){ return bw.getCode(pos); });
+
+        rep_h_cpy = rep_h;
+        rep_h_cpy.updateFWCodes(bw.getCode(0), 0);
+        hashes_fw[0] = rep_h_cpy.hash();
+
+        rep_h_cpy = rep_h;
+        rep_h_cpy.updateFWCodes(bw.getCode(0), 1);
+        hashes_fw[1] = rep_h_cpy.hash();
+
+        rep_h_cpy = rep_h;
+        rep_h_cpy.updateFWCodes(bw.getCode(0), 2);
+        hashes_fw[2] = rep_h_cpy.hash();
+
+        rep_h_cpy = rep_h;
+        rep_h_cpy.updateFWCodes(bw.getCode(0), 3);
+        hashes_fw[3] = rep_h_cpy.hash();
+
+        const uint64_t it_min_h_fw = minHashKmer<MinimizerOrderHash>::getForwardNeighborHash(bw, k_, g_);
+
+        nb_neigh = bf.contains(hashes_fw, it_min_h_fw, neigh_fw, 4);
+
+        if (nb_neigh >= 2){
+
+            for (size_t i = 0; i < 4; ++i) {
+
+                if (neigh_fw[i]){
+
+                    char dummy;
+                    bool has_no_neighbor_tmp = false;
+
+                    Kmer km_fp(bw.forwardBase(alpha[i]));
+
+                    fwStepBBF(km_fp, km_fp, dummy, has_no_neighbor_tmp, l_ignored_km_tip, false);
+
+                    neigh_fw[i] = has_no_neighbor_tmp && bwStepBBF(km_fp, km_fp, dummy, has_no_neighbor_tmp, l_ignored_km_tip, false);
+
+                    if (neigh_fw[i] && (km_fp == km)){
+
+                        found_fp_fw = 0;
+                        break;
+                    }
+                    else found_fp_fw += (neigh_fw[i] && (km_fp != km));
+                }
+            }
+
+            if (found_fp_fw){
+
+                if (nb_neigh - found_fp_fw) nb_neigh -= found_fp_fw;
+                else found_fp_fw = 0;
+            }
+        }
+
+        if (nb_neigh != 1) return false;
+
+        if (bw != km) {
+            // exactly one k-mer in bw, character used is c
+
+            for (size_t i = 0; (i < 4) && (found_fp_fw != 0); ++i) {
+
+                if (neigh_fw[i]){
+
+                    l_ignored_km_tip.push_back(bw.forwardBase(alpha[i]).rep());
+
+                    --found_fp_fw;
+                }
+            }
+
+             for (size_t i = 0; (i < 4) && (found_fp_bw != 0); ++i) {
+
+                if (neigh_bw[i]){
+
+                    l_ignored_km_tip.push_back(front.backwardBase(alpha[i]).rep());
+
+                    --found_fp_bw;
+                }
+            }
+
+            front = bw;
+            c = alpha[j];
+
+            return true;
+        }
+
+        return false;
+    }
+
+    return true;
+}
+
+template<typename U, typename G>
+bool CompactedDBG<U, G>::fwStepBBF(const Kmer km, Kmer& end, char& c, bool& has_no_neighbor, vector<Kmer>& l_ignored_km_tip, const bool check_fp_cand) const {
+
+    int found_fp_fw = 0;
+
+    bool neigh_fw[4] = {false, false, false, false};
+    uint64_t hashes_fw[4];
+
+    RepHash rep_h(k_), rep_h_cpy;
+
+    rep_h.initCodes([&](const size_t pos){ return end.getCode(pos); });
+
+    rep_h_cpy = rep_h;
+    rep_h_cpy.updateFWCodes(end.getCode(0), 0);
+    hashes_fw[0] = rep_h_cpy.hash();
+
+    rep_h_cpy = rep_h;
+    rep_h_cpy.updateFWCodes(end.getCode(0), 1);
+    hashes_fw[1] = rep_h_cpy.hash();
+
+    rep_h_cpy = rep_h;
+    rep_h_cpy.updateFWCodes(end.getCode(0), 2);
+    hashes_fw[2] = rep_h_cpy.hash();
+
+    rep_h_cpy = rep_h;
+    rep_h_cpy.updateFWCodes(end.getCode(0), 3);
+    hashes_fw[3] = rep_h_cpy.hash();
+
+    const uint64_t it_min_h_fw = minHashKmer<MinimizerOrderHash>::getForwardNeighborHash(end, k_, g_);
+
+    size_t nb_neigh = bf.contains(hashes_fw, it_min_h_fw, neigh_fw, 2 * (static_cast<size_t>(check_fp_cand) + 1));
+    size_t j = static_cast<size_t>(neigh_fw[1]) + (2ULL & (static_cast<size_t>(!neigh_fw[2]) - 1)) + (3ULL & (static_cast<size_t>(!neigh_fw[3]) - 1));
+
+    if (check_fp_cand && (nb_neigh >= 2)){
+
+        size_t j_tmp = 0;
+
+        for (size_t i = 0; i < 4; ++i) {
+
+            if (neigh_fw[i]){
+
+                char dummy;
+                bool has_no_neighbor_tmp = false;
+
+                Kmer km_fp(end.forwardBase(alpha[i]));
+
+                fwStepBBF(km_fp, km_fp, dummy, has_no_neighbor_tmp, l_ignored_km_tip, false);
+
+                neigh_fw[i] = has_no_neighbor_tmp && bwStepBBF(km_fp, km_fp, dummy, has_no_neighbor_tmp, l_ignored_km_tip, false);
+
+                found_fp_fw += neigh_fw[i];
+                j_tmp += (i - j_tmp) & (static_cast<size_t>(neigh_fw[i]) - 1);
+            }
+        }
+
+        if (found_fp_fw){
+
+            if (nb_neigh - found_fp_fw){
+
+                j = j_tmp;
+                nb_neigh -= found_fp_fw;
+            }
+            else found_fp_fw = 0;
+        }
+    }
+
+    if (nb_neigh != 1) {
+
+        has_no_neighbor = (nb_neigh == 0);
+        return false;
+    }
+    else has_no_neighbor = false;
+
+    if (check_fp_cand){
+
+        int found_fp_bw = 0;
+
+        bool neigh_bw[4] = {false, false, false, false};
+        uint64_t hashes_bw[4];
+
+        const Kmer fw(end.forwardBase(alpha[j]));
+
+        rep_h.initCodes([&](const size_t pos){ return fw.getCode(pos); });
+
+        rep_h_cpy = rep_h;
+        rep_h_cpy.updateBWCodes(fw.getCode(k_ - 1), 0);
+        hashes_bw[0] = rep_h_cpy.hash();
+
+        rep_h_cpy = rep_h;
+        rep_h_cpy.updateBWCodes(fw.getCode(k_ - 1), 1);
+        hashes_bw[1] = rep_h_cpy.hash();
+
+        rep_h_cpy = rep_h;
+        rep_h_cpy.updateBWCodes(fw.getCode(k_ - 1), 2);
+        hashes_bw[2] = rep_h_cpy.hash();
+
+        rep_h_cpy = rep_h;
+        rep_h_cpy.updateBWCodes(fw.getCode(k_ - 1), 3);
+        hashes_bw[3] = rep_h_cpy.hash();
+
+        const uint64_t it_min_h_bw = minHashKmer<MinimizerOrderHash>::getBackwardNeighborHash(fw, k_, g_);
+
+        nb_neigh = bf.contains(hashes_bw, it_min_h_bw, neigh_bw, 4);
+
+        if (nb_neigh >= 2){
+
+            for (size_t i = 0; i < 4; ++i) {
+
+                if (neigh_bw[i]){
+
+                    char dummy;
+                    bool has_no_neighbor_tmp = false;
+
+                    Kmer km_fp(fw.backwardBase(alpha[i]));
+
+                    bwStepBBF(km_fp, km_fp, dummy, has_no_neighbor_tmp, l_ignored_km_tip, false);
+
+                    neigh_bw[i] = has_no_neighbor_tmp && fwStepBBF(km_fp, km_fp, dummy, has_no_neighbor_tmp, l_ignored_km_tip, false);
+
+                    if (neigh_bw[i] && (km_fp == km)){
+
+                        found_fp_bw = 0;
+                        break;
+                    }
+                    else found_fp_bw += (neigh_bw[i] && (km_fp != km));
+                }
+            }
+
+            if (found_fp_bw){
+
+                if (nb_neigh - found_fp_bw) nb_neigh -= found_fp_bw;
+                else found_fp_bw = 0;
+            }
+        }
+
+        if (nb_neigh != 1) return false;
+
+        if (fw != km) {
+
+            for (size_t i = 0; (i < 4) && (found_fp_bw != 0); ++i) {
+
+                if (neigh_bw[i]){
+
+                    l_ignored_km_tip.push_back(fw.backwardBase(alpha[i]).rep());
+
+                    --found_fp_bw;
+                }
+            }
+
+            for (size_t i = 0; (i < 4) && (found_fp_fw != 0); ++i) {
+
+                if (neigh_fw[i]){
+
+                    l_ignored_km_tip.push_back(end.forwardBase(alpha[i]).rep());
+
+                    --found_fp_fw;
+                }
+            }
+
+            end = fw;
+            c = alpha[j];
+
+            return true;
+        }
+
+        return false;
+    }
+
+    return true;
+}
+
+// use:  cc = cm.findUnitig(km,s,pos)
+// pre:  s[pos,pos+k-1] is the kmer km
+// post: cc contains either the reference to the unitig position
+//       or empty if none found
+template<typename U, typename G>
+UnitigMap<U, G> CompactedDBG<U, G>::findUnitig(const Kmer& km, const char* s, const size_t pos) {
+
+    // need to check if we find it right away, need to treat this common case
+    UnitigMap<U, G> um = find(km);
+
+    if (!um.isEmpty && !um.isShort && !um.isAbundant){
+
+        const size_t mask = static_cast<size_t>(um.strand) - 1;
+
+        um.len = v_unitigs[um.pos_unitig]->getSeq().jump(s, pos, um.dist + ((k_ - 1) & mask), !um.strand) - k_ + 1;
+        um.dist = um.dist - ((um.len - 1) & mask);
+    }
+
+    return um;
+}
+
+template<typename U, typename G>
+UnitigMap<U, G> CompactedDBG<U, G>::findUnitig(const char* s, const size_t pos, const size_t len) {
+
+    if ((len < k_) || (pos > len - k_)) return UnitigMap<U, G>();
+
+    for (size_t i = pos; i != pos + k_; ++i){
+
+        if (!isDNA(s[i])) return UnitigMap<U, G>();
+    }
+
+    // need to check if we find it right away, need to treat this common case
+    UnitigMap<U, G> um = find(Kmer(s + pos));
+
+    if (!um.isEmpty && !um.isShort && !um.isAbundant){
+
+        const size_t mask = static_cast<size_t>(um.strand) - 1;
+
+        um.len = v_unitigs[um.pos_unitig]->getSeq().jump(s, pos, um.dist + ((k_ - 1) & mask), !um.strand) - k_ + 1;
+        um.dist = um.dist - ((um.len - 1) & mask);
+    }
+
+    return um;
+}
+
+template<typename U, typename G>
+const_UnitigMap<U, G> CompactedDBG<U, G>::findUnitig(const char* s, const size_t pos, const size_t len) const {
+
+    if ((len < k_) || (pos > len - k_)) return const_UnitigMap<U, G>();
+
+    for (size_t i = pos; i != pos + k_; ++i){
+
+        if (!isDNA(s[i])) return const_UnitigMap<U, G>();
+    }
+
+    // need to check if we find it right away, need to treat this common case
+    const_UnitigMap<U, G> um = find(Kmer(s + pos));
+
+    if (!um.isEmpty && !um.isShort && !um.isAbundant){
+
+        const size_t mask = static_cast<size_t>(um.strand) - 1;
+
+        um.len = v_unitigs[um.pos_unitig]->getSeq().jump(s, pos, um.dist + ((k_ - 1) & mask), !um.strand) - k_ + 1;
+        um.dist = um.dist - ((um.len - 1) & mask);
+    }
+
+    return um;
+}
+
+template<typename U, typename G>
+UnitigMap<U, G> CompactedDBG<U, G>::findUnitig(const char* s, const size_t pos, const size_t len, const minHashIterator<MinimizerOrderHash>& it_min) {
+
+    if ((len < k_) || (pos > len - k_)) return UnitigMap<U, G>();
+
+    for (size_t i = pos; i != pos + k_; ++i){
+
+        if (!isDNA(s[i])) return UnitigMap<U, G>();
+    }
+
+    // need to check if we find it right away, need to treat this common case
+    UnitigMap<U, G> um = find(s, pos, it_min);
+
+    if (!um.isEmpty && !um.isShort && !um.isAbundant){
+
+        const size_t mask = static_cast<size_t>(um.strand) - 1;
+
+        um.len = v_unitigs[um.pos_unitig]->getSeq().jump(s, pos, um.dist + ((k_ - 1) & mask), !um.strand) - k_ + 1;
+        um.dist = um.dist - ((um.len - 1) & mask);
+    }
+
+    return um;
+}
+
+template<typename U, typename G>
+const_UnitigMap<U, G> CompactedDBG<U, G>::findUnitig(const char* s, const size_t pos, const size_t len, const minHashIterator<MinimizerOrderHash>& it_min) const {
+
+    if ((len < k_) || (pos > len - k_)) return const_UnitigMap<U, G>();
+
+    for (size_t i = pos; i != pos + k_; ++i){
+
+        if (!isDNA(s[i])) return const_UnitigMap<U, G>();
+    }
+
+    // need to check if we find it right away, need to treat this common case
+    const_UnitigMap<U, G> um = find(s, pos, it_min);
+
+    if (!um.isEmpty && !um.isShort && !um.isAbundant){
+
+        const size_t mask = static_cast<size_t>(um.strand) - 1;
+
+        um.len = v_unitigs[um.pos_unitig]->getSeq().jump(s, pos, um.dist + ((k_ - 1) & mask), !um.strand) - k_ + 1;
+        um.dist = um.dist - ((um.len - 1) & mask);
+    }
+
+    return um;
+}
+
+template<typename U, typename G>
+UnitigMap<U, G> CompactedDBG<U, G>::findUnitig(const Kmer& km, const char* s, const size_t pos, const preAllocMinHashIterator<MinimizerOrderHash>& it_min_h) {
+
+    // need to check if we find it right away, need to treat this common case
+    UnitigMap<U, G> um = find(km, it_min_h);
+
+    if (!um.isEmpty && !um.isShort && !um.isAbundant){
+
+        const size_t mask = static_cast<size_t>(um.strand) - 1;
+
+        um.len = v_unitigs[um.pos_unitig]->getSeq().jump(s, pos, um.dist + ((k_ - 1) & mask), !um.strand) - k_ + 1;
+        um.dist = um.dist - ((um.len - 1) & mask);
+    }
+
+    return um;
+}
+
+template<typename U, typename G>
+bool CompactedDBG<U, G>::addUnitig(const string& str_unitig, const size_t id_unitig){
+
+    clearOvercrowdedKmers();
+    clearNeighbors();
+
+    int pos;
+
+    const size_t len = str_unitig.size();
+    size_t pos_id_unitig = id_unitig << 32;
+
+    const size_t mask = MASK_CONTIG_ID | MASK_CONTIG_TYPE;
+
+    bool isShort = false, isAbundant = false, isForbidden = false;
+
+    const char* c_str = str_unitig.c_str();
+
+    char km_tmp[MAX_KMER_SIZE];
+
+    Kmer km_rep;
+
+    if (len == k_){ // Unitig to add is short, maybe abundant as well
+
+        isShort = true;
+
+        pos_id_unitig |= MASK_CONTIG_TYPE;
+
+        km_rep = Kmer(c_str).rep();
+        km_rep.toString(km_tmp);
+        c_str = km_tmp;
+    }
+
+    minHashIterator<MinimizerOrderHash> it_min(c_str, len, k_, g_, MinimizerOrderHash(), true), it_min_end;
+    minHashResult mhr, mhr_tmp;
+
+    vector<minHashResult> v_min_skipped; // Sparse index: minimizers of the current run of k-mers sharing a minimizer
+
+    bool min_indexed = false;
+
+    for (int64_t last_pos_min = -1, last_pos_idx = -1, pos_min_run = -1; it_min != it_min_end; ++it_min){
+
+        // With a sparse index, a run of k-mers sharing a minimizer which was not indexed for this unitig is recorded
+        if (sparse_index && !isShort && (it_min.getPosition() != pos_min_run)){
+
+            if (!min_indexed) setSparseSkipped(c_str, v_min_skipped);
+
+            v_min_skipped.clear();
+
+            min_indexed = false;
+            pos_min_run = it_min.getPosition();
+        }
+
+        //If current minimizer was not seen before. With a sparse index, only the minimizers of the k-mers
+        //which do not contain an already indexed g-mer of the unitig are indexed, as well as the last k-mer of the unitig
+        if ((sparse_index && !isShort) ? ((last_pos_idx < it_min.getKmerPosition()) || (it_min.getKmerPosition() == len - k_)) :
+                                         ((last_pos_min < it_min.getPosition()) || isForbidden)){
+
+            minHashResultIterator<MinimizerOrderHash> it_it_min = *it_min, it_it_min_end;
+            isForbidden = false;
+
+            while (it_it_min != it_it_min_end){
+
+                const minHashResult& min_h_res = *it_it_min;
+                Minimizer minz_rep = Minimizer(c_str + min_h_res.pos).rep(); //Get the minimizer to insert
+                std::pair<MinimizerIndex::iterator, bool> p = hmap_min_unitigs.insert(minz_rep, packed_tiny_vector(), 0);
+                packed_tiny_vector* pck_tinyv = &(p.first.getVector());
+                size_t flag = p.first.getVectorSize();
+                size_t v_sz = pck_tinyv->size(flag);
+
+                pos = min_h_res.pos;
+                pos_id_unitig = (pos_id_unitig & mask) | ((size_t) pos);
+
+                if (!isShort){
+
+                    mhr = min_h_res;
+
+                    while ((v_sz >= max_abundance_lim) || ((v_sz > 0) && (((*pck_tinyv)(v_sz-1, flag) & mask) == mask))){
+
+                        mhr_tmp = it_min.getNewMin(mhr);
+                        isForbidden = true;
+
+                        if (mhr_tmp.hash != mhr.hash){
+
+                            if (((*pck_tinyv)(v_sz-1, flag) & mask) != mask){ // Minimizer was never signaled before as overcrowded
+
+                                // If minimizer bin already contains abundant k-mer, just set flag for unitig overcrowding
+                                if (((*pck_tinyv)(v_sz-1, flag) & MASK_CONTIG_ID) == MASK_CONTIG_ID) (*pck_tinyv)(v_sz-1, flag) |= MASK_CONTIG_TYPE;
+                                else p.first.getVectorSize() = (flag = pck_tinyv->push_back(mask, flag));
+                            }
+
+                            mhr = mhr_tmp;
+                            minz_rep = Minimizer(c_str + mhr.pos).rep();
+
+                            // A sparse index records the position of the g-mer actually indexed
+                            if (sparse_index) pos_id_unitig = (pos_id_unitig & mask) | static_cast<size_t>(mhr.pos);
+
+                            p = hmap_min_unitigs.insert(minz_rep, packed_tiny_vector(), 0);
+                            pck_tinyv = &(p.first.getVector());
+                            flag = p.first.getVectorSize();
+                            v_sz = pck_tinyv->size(flag);
+                        }
+                        else break;
+                    }
+                }
+
+                packed_tiny_vector& v = p.first.getVector();
+                uint8_t& flag_v = p.first.getVectorSize();
+
+                if (v_sz == 0) flag_v = v.push_back(pos_id_unitig, flag_v); //Newly created vector, just push unitig ID
+                else if (isShort && (v_sz >= min_abundance_lim)){ //The minimizer (is/might be) too abundant
+
+                    isShort = false;
+                    isAbundant = true;
+
+                    it_min = it_min_end;
+
+                    break;
+                }
+                else if ((v(v_sz-1, flag_v) & MASK_CONTIG_ID) == MASK_CONTIG_ID){ //If minimizer is abundant or crowded
+
+                    if ((v_sz == 1) || (v(v_sz-2, flag_v) != pos_id_unitig)) flag_v = v.insert(pos_id_unitig, v_sz-1, flag_v);
+                }
+                else if (v(v_sz-1, flag_v) != pos_id_unitig) flag_v = v.push_back(pos_id_unitig, flag_v);
+
+                last_pos_min = min_h_res.pos;
+                last_pos_idx = max(last_pos_idx, static_cast<int64_t>(pos_id_unitig & MASK_CONTIG_POS));
+                ++it_it_min;
+            }
+
+            min_indexed = min_indexed || !isForbidden; // Minimizer indexed, without replacement of an overcrowded one
+        }
+        else if (sparse_index && !isShort && !min_indexed){
+
+            v_min_skipped.clear();
+
+            for (minHashResultIterator<MinimizerOrderHash> it_it_min = *it_min, it_it_min_end; it_it_min != it_it_min_end; ++it_it_min){
+
+                v_min_skipped.push_back(*it_it_min);
+            }
+        }
+    }
+
+    if (sparse_index && !isShort && !min_indexed) setSparseSkipped(c_str, v_min_skipped);
+
+    if (isAbundant){
+
+        if (id_unitig == km_unitigs.size()) km_unitigs.push_back(km_rep);
+        else km_unitigs.set(id_unitig, km_rep);
+
+        deleteUnitig_<is_void<U>::value>(true, false, id_unitig, false);
+
+        if (id_unitig == km_unitigs.size() - 1) km_unitigs.resize(km_unitigs.size() - 1);
+
+        it_min = minHashIterator<MinimizerOrderHash>(c_str, len, k_, g_, MinimizerOrderHash(), true);
+
+        for (int64_t last_pos_min = -1; it_min != it_min_end; ++it_min){
+
+            if (last_pos_min < it_min.getPosition()){ //If current minimizer was not seen before
+
+                minHashResultIterator<MinimizerOrderHash> it_it_min = *it_min, it_it_min_end;
+
+                while (it_it_min != it_it_min_end){
+
+                    const minHashResult& min_h_res = *it_it_min;
+                    Minimizer minz_rep = Minimizer(c_str + min_h_res.pos).rep(); //Get the minimizer to insert
+                    std::pair<MinimizerIndex::iterator, bool> p = hmap_min_unitigs.insert(minz_rep, packed_tiny_vector(), 0);
+                    packed_tiny_vector& v = p.first.getVector();
+                    uint8_t& flag_v = p.first.getVectorSize();
+                    const size_t v_sz = v.size(flag_v);
+
+                    if ((v_sz > 0) && ((v(v_sz-1, flag_v) & MASK_CONTIG_ID) == MASK_CONTIG_ID)) v(v_sz-1, flag_v)++;
+                    else flag_v = v.push_back(MASK_CONTIG_ID + 1, flag_v);
+
+                    last_pos_min = min_h_res.pos;
+                    ++it_it_min;
+                }
+            }
+        }
+
+        h_kmers_ccov.insert(km_rep, CompressedCoverage_t<U>(1));
+    }
+    else if (isShort){
+
+        if (id_unitig == km_unitigs.size()) km_unitigs.push_back(km_rep);
+        else km_unitigs.set(id_unitig, km_rep);
+    }
+    else if (id_unitig == v_unitigs.size()) v_unitigs.push_back(new Unitig<U>(c_str)); //Push unitig to list of unitigs
+    else v_unitigs[id_unitig] = new Unitig<U>(c_str);
+
+    return isAbundant;
+}
+
+template<typename U, typename G>
+void CompactedDBG<U, G>::moveToAbundant() {
+
+    MinimizerIndex::iterator it = hmap_min_unitigs.begin();
+    MinimizerIndex::iterator it_end = hmap_min_unitigs.end();
+
+    vector<pair<size_t, string>> to_move;
+
+    char km_tmp[MAX_KMER_SIZE];
+
+    Kmer km_rep;
+
+    to_move.reserve(16);
+
+    while (it != it_end){
+
+        const packed_tiny_vector* pck_tinyv = &(it.getVector());
+        const size_t flag = it.getVectorSize();
+        const size_t v_sz = pck_tinyv->size(flag);
+
+        if (v_sz >= min_abundance_lim){
+
+            for (size_t i = 0; i < v_sz; ++i){
+
+                if (static_cast<bool>((*pck_tinyv)(i, flag) & MASK_CONTIG_TYPE)){
+
+                    size_t unitig_id = (*pck_tinyv)(i, flag) >> 32;
+                    string unitig_str = km_unitigs.getKmer(unitig_id).toString();
+
+                    to_move.push_back({std::move(unitig_id), std::move(unitig_str)});
+                }
+            }
+
+            if (min_abundance_lim > (v_sz - to_move.size())){
+
+                for (const auto& p : to_move) deleteUnitig_(true, false, p.first, p.second);
+
+                for (const auto& p : to_move){
+
+                    const char* c_str = p.second.c_str();
+                    const size_t len = p.second.length();
+
+                    km_rep = Kmer(c_str).rep();
+                    c_str = km_tmp;
+
+                    km_rep.toString(km_tmp);
+
+                    minHashIterator<MinimizerOrderHash> it_min = minHashIterator<MinimizerOrderHash>(c_str, len, k_, g_, MinimizerOrderHash(), true), it_min_end;
+
+                    for (int64_t last_pos_min = -1; it_min != it_min_end; ++it_min){
+
+                        if (last_pos_min < it_min.getPosition()){ //If current minimizer was not seen before
+
+                            minHashResultIterator<MinimizerOrderHash> it_it_min = *it_min, it_it_min_end;
+
+                            while (it_it_min != it_it_min_end){
+
+                                const minHashResult& min_h_res = *it_it_min;
+                                Minimizer minz_rep = Minimizer(c_str + min_h_res.pos).rep(); //Get the minimizer to insert
+
+                                std::pair<MinimizerIndex::iterator, bool> p = hmap_min_unitigs.insert(minz_rep, packed_tiny_vector(), 0);
+                                packed_tiny_vector& v = p.first.getVector();
+                                uint8_t& flag_v = p.first.getVectorSize();
+                                const size_t v_sz = v.size(flag_v);
+
+                                if ((v_sz > 0) && ((v(v_sz-1, flag_v) & MASK_CONTIG_ID) == MASK_CONTIG_ID)) v(v_sz-1, flag_v)++;
+                                else flag_v = v.push_back(MASK_CONTIG_ID + 1, flag_v);
+
+                                last_pos_min = min_h_res.pos;
+                                ++it_it_min;
+                            }
+                        }
+                    }
+
+                    h_kmers_ccov.insert(km_rep, CompressedCoverage_t<U>(1));
+                }
+            }
+
+            to_move.clear();
+        }
+
+        ++it;
+    }
+}
+
+template<typename U, typename G>
+bool CompactedDBG<U, G>::addUnitig(const string& str_unitig, const size_t id_unitig, SpinLock& lck_unitig, SpinLock& lck_kmer){
+
+    int pos;
+
+    const size_t len = str_unitig.size();
+    size_t pos_id_unitig = id_unitig << 32;
+
+    const size_t mask = MASK_CONTIG_ID | MASK_CONTIG_TYPE;
+
+    bool isShort = false, isAbundant = false, isForbidden = false;
+
+    const char* c_str = str_unitig.c_str();
+
+    char km_tmp[MAX_KMER_SIZE];
+
+    Kmer km_rep;
+
+    if (len == k_){ // Unitig to add is short, maybe abundant as well
+
+        isShort = true;
+
+        pos_id_unitig |= MASK_CONTIG_TYPE;
+
+        km_rep = Kmer(c_str).rep();
+        km_rep.toString(km_tmp);
+        c_str = km_tmp;
+    }
+
+    minHashIterator<MinimizerOrderHash> it_min(c_str, len, k_, g_, MinimizerOrderHash(), true), it_min_end;
+    minHashResult mhr, mhr_tmp;
+
+    vector<minHashResult> v_min_skipped; // Sparse index: minimizers of the current run of k-mers sharing a minimizer
+
+    bool min_indexed = false;
+
+    for (int64_t last_pos_min = -1, last_pos_idx = -1, pos_min_run = -1; it_min != it_min_end; ++it_min){
+
+        // With a sparse index, a run of k-mers sharing a minimizer which was not indexed for this unitig is recorded
+        if (sparse_index && !isShort && (it_min.getPosition() != pos_min_run)){
+
+            if (!min_indexed) setSparseSkipped(c_str, v_min_skipped, true);
+
+            v_min_skipped.clear();
+
+            min_indexed = false;
+            pos_min_run = it_min.getPosition();
+        }
+
+        //If current minimizer was not seen before. With a sparse index, only the minimizers of the k-mers
+        //which do not contain an already indexed g-mer of the unitig are indexed, as well as the last k-mer of the unitig
+        if ((sparse_index && !isShort) ? ((last_pos_idx < it_min.getKmerPosition()) || (it_min.getKmerPosition() == len - k_)) :
+                                         ((last_pos_min < it_min.getPosition()) || isForbidden)){
+
+            minHashResultIterator<MinimizerOrderHash> it_it_min = *it_min, it_it_min_end;
+            isForbidden = false;
+
+            while (it_it_min != it_it_min_end){
+
+                const minHashResult& min_h_res = *it_it_min;
+                Minimizer minz_rep = Minimizer(c_str + min_h_res.pos).rep(); //Get the minimizer to insert
+
+                pos = min_h_res.pos;
+                pos_id_unitig = (pos_id_unitig & mask) | ((size_t) pos);
+
+                std::pair<MinimizerIndex::iterator, bool> p = hmap_min_unitigs.insert_p(minz_rep, packed_tiny_vector(), 0);
+                packed_tiny_vector* pck_tinyv = &(p.first.getVector());
+                size_t flag = p.first.getVectorSize();
+                size_t v_sz = pck_tinyv->size(flag);
+
+                if (!isShort){
+
+                    mhr = min_h_res;
+
+                    while ((v_sz >= max_abundance_lim) || ((v_sz > 0) && (((*pck_tinyv)(v_sz-1, flag) & mask) == mask))){
+
+                        mhr_tmp = it_min.getNewMin(mhr);
+                        isForbidden = true;
+
+                        if (mhr_tmp.hash != mhr.hash){
+
+                            if (((*pck_tinyv)(v_sz-1, flag) & mask) != mask){ // Minimizer was never signaled before as overcrowded
+
+                                // If minimizer bin already contains abundant k-mer, just set flag for unitig overcrowding
+                                if (((*pck_tinyv)(v_sz-1, flag) & MASK_CONTIG_ID) == MASK_CONTIG_ID) (*pck_tinyv)(v_sz-1, flag) |= MASK_CONTIG_TYPE;
+                                else p.first.getVectorSize() = (flag = pck_tinyv->push_back(mask, flag));
+                            }
+
+                            hmap_min_unitigs.release_p(p.first);
+
+                            mhr = mhr_tmp;
+                            minz_rep = Minimizer(c_str + mhr.pos).rep();
+
+                            // A sparse index records the position of the g-mer actually indexed
+                            if (sparse_index) pos_id_unitig = (pos_id_unitig & mask) | static_cast<size_t>(mhr.pos);
+
+                            p = hmap_min_unitigs.insert_p(minz_rep, packed_tiny_vector(), 0);
+                            pck_tinyv = &(p.first.getVector());
+                            flag = p.first.getVectorSize();
+                            v_sz = pck_tinyv->size(flag);
+                        }
+                        else break;
+                    }
+                }
+
+                packed_tiny_vector& v = p.first.getVector();
+                uint8_t& flag_v = p.first.getVectorSize();
+
+                if (v_sz == 0) flag_v = v.push_back(pos_id_unitig, flag_v); //Newly created vector, just push unitig ID
+                else if ((v(v_sz-1, flag_v) & MASK_CONTIG_ID) == MASK_CONTIG_ID){ //If minimizer is abundant or crowded
+
+                    if ((v_sz == 1) || (v(v_sz-2, flag_v) != pos_id_unitig)) flag_v = v.insert(pos_id_unitig, v_sz-1, flag_v);
+                }
+                else if (v(v_sz-1, flag_v) != pos_id_unitig) flag_v = v.push_back(pos_id_unitig, flag_v);
+
+                hmap_min_unitigs.release_p(p.first);
+
+                last_pos_min = min_h_res.pos;
+                last_pos_idx = max(last_pos_idx, static_cast<int64_t>(pos_id_unitig & MASK_CONTIG_POS));
+                ++it_it_min;
+            }
+
+            min_indexed = min_indexed || !isForbidden; // Minimizer indexed, without replacement of an overcrowded one
+        }
+        else if (sparse_index && !isShort && !min_indexed){
+
+            v_min_skipped.clear();
+
+            for (minHashResultIterator<MinimizerOrderHash> it_it_min = *it_min, it_it_min_end; it_it_min != it_it_min_end; ++it_it_min){
+
+                v_min_skipped.push_back(*it_it_min);
+            }
+        }
+    }
+
+    if (sparse_index && !isShort && !min_indexed) setSparseSkipped(c_str, v_min_skipped, true);
+
+    if (isShort){
+
+        lck_kmer.acquire();
+
+        if (id_unitig >= km_unitigs.size()) km_unitigs.resize(id_unitig + 1);
+
+        km_unitigs.set(id_unitig, km_rep);
+
+        lck_kmer.release();
+    }
+    else {
+
+        lck_unitig.acquire();
+
+        if (id_unitig >= v_unitigs.size()) v_unitigs.resize(id_unitig + 1);
+
+        v_unitigs[id_unitig] = new Unitig<U>(c_str); //Push unitig to list of unitigs
+
+        lck_unitig.release();
+    }
+
+    return isAbundant;
+}
+
+template<typename U, typename G>
+bool CompactedDBG<U, G>::addUnitig(const string& str_unitig, const size_t id_unitig, const size_t id_unitig_r, const size_t is_short_r){
+
+    clearOvercrowdedKmers();
+    clearNeighbors();
+
+    int pos;
+
+    const size_t pos_id_unitig_r = (id_unitig_r << 32) | (is_short_r ? MASK_CONTIG_TYPE : 0);
+
+    const size_t len = str_unitig.size();
+    const size_t mask = MASK_CONTIG_ID | MASK_CONTIG_TYPE;
+
+    size_t pos_id_unitig = id_unitig << 32;
+    size_t i = 0;
+
+    bool isShort = false, isAbundant = false, isForbidden = false;
+
+    const char* c_str = str_unitig.c_str();
+
+    char km_tmp[MAX_KMER_SIZE];
+
+    Kmer km_rep;
+
+    if (len == k_){ // Unitig to add is short, maybe abundant as well
+
+        isShort = true;
+
+        pos_id_unitig |= MASK_CONTIG_TYPE;
+
+        km_rep = Kmer(c_str).rep();
+        km_rep.toString(km_tmp);
+        c_str = km_tmp;
+    }
+
+    minHashIterator<MinimizerOrderHash> it_min(c_str, len, k_, g_, MinimizerOrderHash(), true), it_min_end;
+    minHashResult mhr, mhr_tmp;
+
+    vector<minHashResult> v_min_skipped; // Sparse index: minimizers of the current run of k-mers sharing a minimizer
+
+    bool min_indexed = false;
+
+    for (int64_t last_pos_min = -1, last_pos_idx = -1, pos_min_run = -1; it_min != it_min_end; ++it_min){
+
+        // With a sparse index, a run of k-mers sharing a minimizer which was not indexed for this unitig is recorded
+        if (sparse_index && !isShort && (it_min.getPosition() != pos_min_run)){
+
+            if (!min_indexed) setSparseSkipped(c_str, v_min_skipped);
+
+            v_min_skipped.clear();
+
+            min_indexed = false;
+            pos_min_run = it_min.getPosition();
+        }
+
+        //If current minimizer was not seen before. With a sparse index, only the minimizers of the k-mers
+        //which do not contain an already indexed g-mer of the unitig are indexed, as well as the last k-mer of the unitig
+        if ((sparse_index && !isShort) ? ((last_pos_idx < it_min.getKmerPosition()) || (it_min.getKmerPosition() == len - k_)) :
+                                         ((last_pos_min < it_min.getPosition()) || isForbidden)){
+
+            minHashResultIterator<MinimizerOrderHash> it_it_min = *it_min, it_it_min_end;
+            isForbidden = false;
+
+            while (it_it_min != it_it_min_end){
+
+                const minHashResult& min_h_res = *it_it_min;
+                Minimizer minz_rep = Minimizer(c_str + min_h_res.pos).rep(); //Get the minimizer to insert
+                std::pair<MinimizerIndex::iterator, bool> p = hmap_min_unitigs.insert(minz_rep, packed_tiny_vector(), 0);
+                packed_tiny_vector* pck_tinyv = &(p.first.getVector());
+                size_t flag = p.first.getVectorSize();
+                size_t v_sz = pck_tinyv->size(flag);
+
+                pos = min_h_res.pos;
+                pos_id_unitig = (pos_id_unitig & mask) | ((size_t) pos);
+
+                for (i = 0; i < v_sz; ++i){
+
+                    if (((*pck_tinyv)(i, flag) & mask) == pos_id_unitig_r){
+
+                        (*pck_tinyv)(i, flag) = pos_id_unitig;
+                        break;
+                    }
+                }
+
+                if (!isShort){
+
+                    mhr = min_h_res;
+
+                    while ((i == v_sz) && ((v_sz >= max_abundance_lim) || ((v_sz > 0) && (((*pck_tinyv)(v_sz-1, flag) & mask) == mask)))){
+
+                        mhr_tmp = it_min.getNewMin(mhr);
+                        isForbidden = true;
+
+                        if (mhr_tmp.hash != mhr.hash){
+
+                            if (((*pck_tinyv)(v_sz-1, flag) & mask) != mask){ // Minimizer was never signaled before as overcrowded
+
+                                // If minimizer bin already contains abundant k-mer, just set flag for unitig overcrowding
+                                if (((*pck_tinyv)(v_sz-1, flag) & MASK_CONTIG_ID) == MASK_CONTIG_ID) (*pck_tinyv)(v_sz-1, flag) |= MASK_CONTIG_TYPE;
+                                else p.first.getVectorSize() = (flag = pck_tinyv->push_back(mask, flag));
+                            }
+
+                            mhr = mhr_tmp;
+                            minz_rep = Minimizer(c_str + mhr.pos).rep();
+
+                            // A sparse index records the position of the g-mer actually indexed
+                            if (sparse_index) pos_id_unitig = (pos_id_unitig & mask) | static_cast<size_t>(mhr.pos);
+
+                            p = hmap_min_unitigs.insert(minz_rep, packed_tiny_vector(), 0);
+                            pck_tinyv = &(p.first.getVector());
+                            flag = p.first.getVectorSize();
+                            v_sz = pck_tinyv->size(flag);
+
+                            for (i = 0; i < v_sz; ++i){
+
+                                if (((*pck_tinyv)(i, flag) & mask) == pos_id_unitig_r){
+
+                                    (*pck_tinyv)(i, flag) = pos_id_unitig;
+                                    break;
+                                }
+                            }
+                        }
+                        else {
+
+                            i = v_sz;
+                            break;
+                        }
+                    }
+                }
+
+                if (i == v_sz){
+
+                    packed_tiny_vector& v = p.first.getVector();
+                    uint8_t& flag_v = p.first.getVectorSize();
+
+                    if (v_sz == 0) flag_v = v.push_back(pos_id_unitig, flag_v); //Newly created vector, just push unitig ID
+                    else if (isShort && (v_sz >= min_abundance_lim)){ //The minimizer (is/might be) too abundant
+
+                        isShort = false;
+                        isAbundant = true;
+
+                        it_min = it_min_end;
+
+                        break;
+                    }
+                    else if ((v(v_sz-1, flag_v) & MASK_CONTIG_ID) == MASK_CONTIG_ID){ //If minimizer is abundant or crowded
+
+                        if ((v_sz == 1) || (v(v_sz-2, flag_v) != pos_id_unitig)) flag_v = v.insert(pos_id_unitig, v_sz-1, flag_v);
+                    }
+                    else if (v(v_sz-1, flag_v) != pos_id_unitig) flag_v = v.push_back(pos_id_unitig, flag_v);
+                }
+
+                last_pos_min = min_h_res.pos;
+                last_pos_idx = max(last_pos_idx, static_cast<int64_t>(pos_id_unitig & MASK_CONTIG_POS));
+                ++it_it_min;
+            }
+
+            min_indexed = min_indexed || !isForbidden; // Minimizer indexed, without replacement of an overcrowded one
+        }
+        else if (sparse_index && !isShort && !min_indexed){
+
+            v_min_skipped.clear();
+
+            for (minHashResultIterator<MinimizerOrderHash> it_it_min = *it_min, it_it_min_end; it_it_min != it_it_min_end; ++it_it_min){
+
+                v_min_skipped.push_back(*it_it_min);
+            }
+        }
+    }
+
+    if (sparse_index && !isShort && !min_indexed) setSparseSkipped(c_str, v_min_skipped);
+
+    if (isAbundant){
+
+        if (id_unitig == km_unitigs.size()) km_unitigs.push_back(km_rep);
+        else km_unitigs.set(id_unitig, km_rep);
+
+        deleteUnitig_<is_void<U>::value>(true, false, id_unitig, false);
+
+        if (id_unitig == km_unitigs.size() - 1) km_unitigs.resize(km_unitigs.size() - 1);
+
+        it_min = minHashIterator<MinimizerOrderHash>(c_str, len, k_, g_, MinimizerOrderHash(), true);
+
+        for (int64_t last_pos_min = -1; it_min != it_min_end; ++it_min){
+
+            if (last_pos_min < it_min.getPosition()){ //If current minimizer was not seen before
+
+                minHashResultIterator<MinimizerOrderHash> it_it_min = *it_min, it_it_min_end;
+
+                while (it_it_min != it_it_min_end){
+
+                    const minHashResult& min_h_res = *it_it_min;
+                    Minimizer minz_rep = Minimizer(c_str + min_h_res.pos).rep(); //Get the minimizer to insert
+                    std::pair<MinimizerIndex::iterator, bool> p = hmap_min_unitigs.insert(minz_rep, packed_tiny_vector(), 0);
+                    packed_tiny_vector& v = p.first.getVector();
+                    uint8_t& flag_v = p.first.getVectorSize();
+                    const size_t v_sz = v.size(flag_v);
+
+                    if ((v_sz > 0) && ((v(v_sz-1, flag_v) & MASK_CONTIG_ID) == MASK_CONTIG_ID)) v(v_sz-1, flag_v)++;
+                    else flag_v = v.push_back(MASK_CONTIG_ID + 1, flag_v);
+
+                    last_pos_min = min_h_res.pos;
+                    ++it_it_min;
+                }
+            }
+        }
+
+        h_kmers_ccov.insert(km_rep, CompressedCoverage_t<U>(1));
+    }
+    else if (isShort){
+
+        if (id_unitig == km_unitigs.size()) km_unitigs.push_back(km_rep);
+        else km_unitigs.set(id_unitig, km_rep);
+    }
+    else if (id_unitig == v_unitigs.size()) v_unitigs.push_back(new Unitig<U>(c_str)); //Push unitig to list of unitigs
+    else v_unitigs[id_unitig] = new Unitig<U>(c_str);
+
+    return isAbundant;
+}
+
+template<typename U, typename G>
+void CompactedDBG<U, G>::swapUnitigs(const bool isShort, const size_t id_a, const size_t id_b){
+
+    clearOvercrowdedKmers();
+    clearNeighbors();
+
+    size_t shift_id_unitig_a = id_a << 32;
+    size_t shift_id_unitig_b = id_b << 32;
+
+    const size_t mask = MASK_CONTIG_ID | MASK_CONTIG_TYPE;
+
+    string str;
+
+    size_t h_sz = 0;
+
+    // Swap the unitig pointers in v_unitigs
+    if (isShort){
+
+        km_unitigs.swap(id_a, id_b);
+
+        shift_id_unitig_a |= MASK_CONTIG_TYPE;
+        shift_id_unitig_b |= MASK_CONTIG_TYPE;
+
+        str = km_unitigs.getKmer(id_a).toString();
+        h_sz = 4;
+    }
+    else {
+
+        std::swap(v_unitigs[id_a], v_unitigs[id_b]);
+
+        str = v_unitigs[id_a]->getSeq().toString();
+        h_sz = (v_unitigs[id_a]->length() / 4) + (v_unitigs[id_b]->length() / 4);
+    }
+
+    MinimizerHashTable<uint8_t> minimizers(h_sz);
+
+    bool isForbidden = false;
+
+    // Swap the unitig IDs in the minimizer hash table
+    const char* s = str.c_str();
+
+    size_t len = str.size();
+
+    minHashIterator<MinimizerOrderHash> it_min(s, len, k_, g_, MinimizerOrderHash(), true), it_min_end;
+    minHashResult mhr, mhr_tmp;
+
+    for (int64_t last_pos_min = -1; it_min != it_min_end; ++it_min){ // Iterate over minimizers of unitig
+
+        if ((last_pos_min < it_min.getPosition()) || isForbidden){ // If a new minimizer is found in unitig
+
+            minHashResultIterator<MinimizerOrderHash> it_it_min(*it_min), it_it_min_end;
+            isForbidden = false;
+
+            while (it_it_min != it_it_min_end){ // Iterate over minimizers of current k-mer in unitig
+
+                const minHashResult& min_h_res = *it_it_min;
+                Minimizer minz_rep = Minimizer(s + min_h_res.pos).rep();
+                MinimizerIndex::iterator it_h = hmap_min_unitigs.find(minz_rep);
+
+                if (it_h != hmap_min_unitigs.end()){
+
+                    if (minimizers.find(minz_rep) == minimizers.end()){
+
+                        minimizers.insert(minz_rep, 0);
+
+                        packed_tiny_vector& v = it_h.getVector();
+                        const uint8_t flag_v = it_h.getVectorSize();
+                        const size_t v_sz = v.size(flag_v);
+
+                        for (size_t i = 0; i < v_sz; ++i){
+
+                             // Swap the unitig ids but do not change positions;
+                            if ((v(i, flag_v) & mask) == shift_id_unitig_b) v(i, flag_v) = shift_id_unitig_a | (v(i, flag_v) & MASK_CONTIG_POS);
+                            else if ((v(i, flag_v) & mask) == shift_id_unitig_a) v(i, flag_v) = shift_id_unitig_b | (v(i, flag_v) & MASK_CONTIG_POS);
+                        }
+                    }
+
+                    packed_tiny_vector* v = &(it_h.getVector());
+                    uint8_t flag_v = it_h.getVectorSize();
+                    size_t v_sz = v->size(flag_v);
+
+                    mhr = min_h_res;
+
+                    while (((*v)(v_sz-1, flag_v) & mask) == mask){
+
+                        mhr_tmp = it_min.getNewMin(mhr); //Recompute a new (different) minimizer for current k-mer
+                        isForbidden = true;
+
+                        if (mhr_tmp.hash != mhr.hash){
+
+                            minz_rep = Minimizer(s + mhr_tmp.pos).rep();
+                            it_h = hmap_min_unitigs.find(minz_rep);
+
+                            if (it_h == hmap_min_unitigs.end()) break;
+
+                            if (minimizers.find(minz_rep) == minimizers.end()){
+
+                                minimizers.insert(minz_rep, 0);
+
+                                packed_tiny_vector& v_tmp = it_h.getVector();
+                                const uint8_t flag_v_tmp = it_h.getVectorSize();
+                                const size_t v_sz_tmp = v_tmp.size(flag_v_tmp);
+
+                                for (size_t i = 0; i < v_sz_tmp; ++i){
+
+                                     // Swap the unitig ids but do not change positions;
+                                    if ((v_tmp(i, flag_v_tmp) & mask) == shift_id_unitig_b){
+
+                                        v_tmp(i, flag_v_tmp) = shift_id_unitig_a | (v_tmp(i, flag_v_tmp) & MASK_CONTIG_POS);
+                                    }
+                                    else if ((v_tmp(i, flag_v_tmp) & mask) == shift_id_unitig_a){
+
+                                        v_tmp(i, flag_v_tmp) = shift_id_unitig_b | (v_tmp(i, flag_v_tmp) & MASK_CONTIG_POS);
+                                    }
+                                }
+                            }
+
+                            mhr = mhr_tmp;
+                            v = &(it_h.getVector());
+                            flag_v = it_h.getVectorSize();
+                            v_sz = v->size(flag_v);
+                        }
+                        else break;
+                    }
+                }
+
+                last_pos_min = min_h_res.pos;
+                ++it_it_min;
+            }
+        }
+    }
+
+    str = isShort ? km_unitigs.getKmer(id_b).toString() : v_unitigs[id_b]->getSeq().toString();
+    s = str.c_str();
+    len = str.size();
+
+    isForbidden = false;
+
+    minHashIterator<MinimizerOrderHash> it_min2(s, len, k_, g_, MinimizerOrderHash(), true);
+
+    for (int64_t last_pos_min = -1; it_min2 != it_min_end; ++it_min2){ // Iterate over minimizers of unitig
+
+        if ((last_pos_min < it_min2.getPosition()) || isForbidden){ // If a new minimizer is found in unitig
+
+            minHashResultIterator<MinimizerOrderHash> it_it_min(*it_min2), it_it_min_end;
             isForbidden = false;
 
-            while (it_it_min != it_it_min_end){
+            while (it_it_min != it_it_min_end){ // Iterate over minimizers of current k-mer in unitig
+
+                const minHashResult& min_h_res = *it_it_min;
+                Minimizer minz_rep = Minimizer(s + min_h_res.pos).rep();
+                MinimizerIndex::iterator it_h = hmap_min_unitigs.find(minz_rep);
+
+                if (it_h != hmap_min_unitigs.end()){
+
+                    if (minimizers.find(minz_rep) == minimizers.end()){
+
+                        minimizers.insert(minz_rep, 0);
+
+                        packed_tiny_vector& v = it_h.getVector();
+                        const uint8_t flag_v = it_h.getVectorSize();
+                        const size_t v_sz = v.size(flag_v);
+
+                        for (size_t i = 0; i < v_sz; ++i){
+
+                            if ((v(i, flag_v) & mask) == shift_id_unitig_a) v(i, flag_v) = shift_id_unitig_b | (v(i, flag_v) & MASK_CONTIG_POS);
+                        }
+                    }
+
+                    packed_tiny_vector* v = &(it_h.getVector());
+                    uint8_t flag_v = it_h.getVectorSize();
+                    size_t v_sz = v->size(flag_v);
+
+                    mhr = min_h_res;
+
+                    while (((*v)(v_sz-1, flag_v) & mask) == mask){
+
+                        mhr_tmp = it_min2.getNewMin(mhr); //Recompute a new (different) minimizer for current k-mer
+                        isForbidden = true;
+
+                        if (mhr_tmp.hash != mhr.hash){
+
+                            minz_rep = Minimizer(s + mhr_tmp.pos).rep();
+                            it_h = hmap_min_unitigs.find(minz_rep);
+
+                            if (it_h == hmap_min_unitigs.end()) break;
+
+                            if (minimizers.find(minz_rep) == minimizers.end()){
+
+                                minimizers.insert(minz_rep, 0);
+
+                                packed_tiny_vector& v_tmp = it_h.getVector();
+                                const uint8_t flag_v_tmp = it_h.getVectorSize();
+                                const size_t v_sz_tmp = v_tmp.size(flag_v_tmp);
+
+                                for (size_t i = 0; i < v_sz_tmp; ++i){
+
+                                    if ((v_tmp(i, flag_v_tmp) & mask) == shift_id_unitig_a) {
+
+                                        v_tmp(i, flag_v_tmp) = shift_id_unitig_b | (v_tmp(i, flag_v_tmp) & MASK_CONTIG_POS);
+                                    }
+                                }
+                            }
+
+                            mhr = mhr_tmp;
+                            v = &(it_h.getVector());
+                            flag_v = it_h.getVectorSize();
+                            v_sz = v->size(flag_v);
+                        }
+                        else break;
+                    }
+                }
+
+                last_pos_min = min_h_res.pos;
+                ++it_it_min;
+            }
+        }
+    }
+}
+
+// Input sequence must not contain duplicated k-mers
+// If it does, use CompactedDBG<U, G>::add().
+template<typename U, typename G>
+bool CompactedDBG<U, G>::mergeUnitig(const string& seq, const bool verbose){
+
+    if (invalid){
+
+        cerr << "CompactedDBG::mergeUnitig(): Graph is invalid and no sequence can be added to it" << endl;
+        return false;
+    }
+
+    if (seq.length() < k_){
+
+        cerr << "CompactedDBG::mergeUnitig(): Input sequence length cannot be less than k = " << k_ << endl;
+        return false;
+    }
+
+    size_t nxt_pos_insert_v_unitigs = v_unitigs.size();
+    size_t v_unitigs_sz = v_unitigs.size();
+    size_t v_kmers_sz = km_unitigs.size();
+
+    size_t nb_curr_pred = 0;
+    size_t nb_curr_succ = 0;
+    size_t nb_prev_pred = 0xFFFFFFFFFFFFFFFF;
+    size_t nb_prev_succ = 0xFFFFFFFFFFFFFFFF;
+
+    size_t added = 0;
+    size_t split_before = 0, split_after = 0;
+
+    bool prev_found = true;
+
+    string curr_unitig;
+
+    vector<Kmer> v_joins;
+
+    KmerHashTable<vector<size_t>> kht;
+
+    const char* str_seq = seq.c_str();
+
+    const size_t str_seq_len = seq.length();
+
+    auto add_graph_function = [&](const string& unitig){
+
+        const char* str_unitig = unitig.c_str();
+        const size_t len_unitig = unitig.length();
+
+        if (len_unitig == k_){
+
+            if (!addUnitig(str_unitig, v_kmers_sz)){
+
+                km_unitigs.setFull(v_kmers_sz);
+
+                ++v_kmers_sz;
+                ++added;
+            }
+            else h_kmers_ccov.find(Kmer(str_unitig).rep())->ccov.setFull();
+        }
+        else {
+
+            addUnitig(str_unitig, nxt_pos_insert_v_unitigs);
+
+            v_unitigs[nxt_pos_insert_v_unitigs]->getCov().setFull();
+
+            ++nxt_pos_insert_v_unitigs;
+            ++added;
+
+            v_joins.push_back(Kmer(str_unitig + len_unitig - k_));
+        }
+
+        v_joins.push_back(Kmer(str_unitig));
+    };
+
+    auto add_split_function = [&](){
+
+        KmerHashTable<vector<size_t>>::iterator it(kht.begin());
+        const KmerHashTable<vector<size_t>>::iterator it_end(kht.end());
+
+        vector<pair<int,int>> sp;
+
+        while (it != it_end){
+
+            ++split_before;
+            ++split_after;
+
+            const_UnitigMap<U, G> um(find(it.getKey(), true));
+
+            vector<size_t>& split_v = *it;
+
+            sort(split_v.begin(), split_v.end());
+
+            size_t prev_split_pos = 0;
+
+            for (const auto pos : split_v){
+
+                if (pos != prev_split_pos){
+
+                    sp.push_back({prev_split_pos, pos});
+
+                    v_joins.push_back(um.getUnitigKmer(prev_split_pos));
+                    if (prev_split_pos != pos - 1) v_joins.push_back(um.getUnitigKmer(pos - 1));
+
+                    prev_split_pos = pos;
+
+                    ++split_after;
+                }
+            }
+
+            sp.push_back({prev_split_pos, um.size - k_ + 1});
+
+            v_joins.push_back(um.getUnitigKmer(prev_split_pos));
+            if (prev_split_pos != um.size - k_) v_joins.push_back(um.getUnitigKmer(um.size - k_));
+
+            extractUnitig_<is_void<U>::value>(um.pos_unitig, nxt_pos_insert_v_unitigs, v_unitigs_sz, v_kmers_sz, sp);
+
+            sp.clear();
+            split_v.clear();
+
+            ++it;
+        }
+
+        kht.clear();
+    };
+
+    for (KmerIterator it_km(str_seq), it_km_end; it_km != it_km_end;) { //non-ACGT char. are discarded
+
+        const std::pair<Kmer, int>& p = *it_km;
+
+        UnitigMap<U, G> cm = findUnitig(p.first, str_seq, p.second);
+
+        if (cm.isEmpty){
+
+            vector<UnitigMap<U, G>> um_bw(findPredecessors(p.first));
+            vector<UnitigMap<U, G>> um_fw(findSuccessors(p.first));
+
+            nb_curr_pred = 0;
+            nb_curr_succ = 0;
+
+            for (auto& um : um_bw){
+
+                if (!um.isEmpty){
+
+                    ++nb_curr_pred;
+
+                    if (!um.isAbundant && !um.isShort){
+
+                        um.dist += um.strand;
+                        if ((um.dist != 0) && (um.dist != um.size - k_ + 1)) kht.insert(um.getUnitigHead(), vector<size_t>()).first->push_back(um.dist);
+                    }
+                }
+            }
+
+            for (auto& um : um_fw){
+
+                if (!um.isEmpty){
+
+                    ++nb_curr_succ;
+
+                    if (!um.isAbundant && !um.isShort){
+
+                        um.dist += !um.strand;
+                        if ((um.dist != 0) && (um.dist != um.size - k_ + 1)) kht.insert(um.getUnitigHead(), vector<size_t>()).first->push_back(um.dist);
+                    }
+                }
+            }
+
+            if (prev_found){ // Previous k-mer was found in the graph => current k-mer (not found in the graph) starts a new unitig
+
+                prev_found = false;
+                curr_unitig = p.first.toString();
+            }
+            else if ((nb_prev_succ == 0) && (nb_curr_pred == 0)) curr_unitig.push_back(str_seq[p.second + k_ - 1]);
+            else {
 
-                const minHashResult& min_h_res = *it_it_min;
-                Minimizer minz_rep = Minimizer(c_str + min_h_res.pos).rep(); //Get the minimizer to insert
-                std::pair<MinimizerIndex::iterator, bool> p = hmap_min_unitigs.insert(minz_rep, packed_tiny_vector(), 0);
-                packed_tiny_vector* pck_tinyv = &(p.first.getVector());
-                size_t flag = p.first.getVectorSize();
-                size_t v_sz = pck_tinyv->size(flag);
+                add_graph_function(curr_unitig);
 
-                pos = min_h_res.pos;
-                pos_id_unitig = (pos_id_unitig & mask) | ((size_t) pos);
+                curr_unitig = p.first.toString();
+            }
 
-                for (i = 0; i < v_sz; ++i){
+            nb_prev_succ = nb_curr_succ;
+            nb_prev_pred = nb_curr_pred;
 
-                    if (((*pck_tinyv)(i, flag) & mask) == pos_id_unitig_r){
+            ++it_km;
+        }
+        else {
 
-                        (*pck_tinyv)(i, flag) = pos_id_unitig;
-                        break;
+            if ((p.second == 0) && !cm.isAbundant && !cm.isShort){
+
+                if ((cm.dist != 0) && (cm.dist != cm.size - k_ + 1)) kht.insert(cm.getUnitigHead(), vector<size_t>()).first->push_back(cm.dist);
+            }
+            else if ((p.second + cm.len == str_seq_len - k_ + 1) && !cm.isAbundant && !cm.isShort){
+
+                cm.dist += cm.len;
+
+                if ((cm.dist != 0) && (cm.dist != cm.size - k_ + 1)) kht.insert(cm.getUnitigHead(), vector<size_t>()).first->push_back(cm.dist);
+            }
+
+            it_km += cm.len;
+
+            if (!prev_found){
+
+                add_graph_function(curr_unitig);
+
+                prev_found = true;
+            }
+        }
+    }
+
+    add_split_function();
+
+    if (!prev_found) add_graph_function(curr_unitig);
+
+    if (nxt_pos_insert_v_unitigs < v_unitigs.size()) v_unitigs.resize(nxt_pos_insert_v_unitigs);
+    if (v_kmers_sz < km_unitigs.size()) km_unitigs.resize(v_kmers_sz);
+
+    const size_t joined = joinUnitigs_<is_void<U>::value>(&v_joins);
+
+    if (verbose){
+
+        cout << "CompactedDBG::mergeUnitig(): Added " << added << " new unitigs to the graph." << endl;
+        cout << "CompactedDBG::mergeUnitig(): Split " << split_before << " unitigs into " << split_after << " new unitigs." << endl;
+        cout << "CompactedDBG::mergeUnitig(): Joined " << joined << " unitigs from the graph." << endl;
+    }
+
+    return true;
+}
+
+template<typename U, typename G>
+bool CompactedDBG<U, G>::annotateSplitUnitig(const string& seq, const bool verbose){
+
+    if (invalid){
+
+        cerr << "CompactedDBG::annotateSplitUnitig(): Graph is invalid and no sequence can be added to it" << endl;
+        return false;
+    }
+
+    if (seq.length() < k_){
+
+        cerr << "CompactedDBG::annotateSplitUnitig(): Input sequence length cannot be less than k = " << k_ << endl;
+        return false;
+    }
+
+    size_t nxt_pos_insert_v_unitigs = v_unitigs.size();
+    size_t v_kmers_sz = km_unitigs.size();
+
+    size_t nb_curr_pred = 0;
+    size_t nb_curr_succ = 0;
+    size_t nb_prev_pred = 0xFFFFFFFFFFFFFFFF;
+    size_t nb_prev_succ = 0xFFFFFFFFFFFFFFFF;
+
+    bool prev_found = true;
+
+    string curr_unitig;
+
+    const char* str_seq = seq.c_str();
+
+    const size_t str_seq_len = seq.length();
+
+    auto add_graph_function = [&](const string& unitig){
+
+        const char* str_unitig = unitig.c_str();
+        const size_t len_unitig = unitig.length();
+
+        if (len_unitig == k_){
+
+            if (!addUnitig(str_unitig, v_kmers_sz)) km_unitigs.setFull(v_kmers_sz++);
+            else h_kmers_ccov.find(Kmer(str_unitig).rep())->ccov.setFull();
+        }
+        else {
+
+            addUnitig(str_unitig, nxt_pos_insert_v_unitigs);
+
+            v_unitigs[nxt_pos_insert_v_unitigs++]->getCov().setFull();
+        }
+    };
+
+    for (KmerIterator it_km(str_seq), it_km_end; it_km != it_km_end;) { //non-ACGT char. are discarded
+
+        const std::pair<Kmer, int>& p = *it_km;
+
+        UnitigMap<U, G> cm = findUnitig(p.first, str_seq, p.second);
+
+        if (cm.isEmpty){
+
+            vector<UnitigMap<U, G>> um_bw(findPredecessors(p.first));
+            vector<UnitigMap<U, G>> um_fw(findSuccessors(p.first));
+
+            nb_curr_pred = 0;
+            nb_curr_succ = 0;
+
+            for (auto& um : um_bw){
+
+                if (!um.isEmpty){
+
+                    ++nb_curr_pred;
+
+                    if (!um.isAbundant && !um.isShort){
+
+                        um.dist += um.strand;
+
+                        if ((um.dist != 0) && (um.dist != um.size - k_ + 1)) unmapRead(um);
                     }
                 }
+            }
 
-                if (!isShort){
+            for (auto& um : um_fw){
 
-                    mhr = min_h_res;
+                if (!um.isEmpty){
 
-                    while ((i == v_sz) && ((v_sz >= max_abundance_lim) || ((v_sz > 0) && (((*pck_tinyv)(v_sz-1, flag) & mask) == mask)))){
+                    ++nb_curr_succ;
 
-                        mhr_tmp = it_min.getNewMin(mhr);
-                        isForbidden = true;
+                    if (!um.isAbundant && !um.isShort){
 
-                        if (mhr_tmp.hash != mhr.hash){
+                        um.dist += !um.strand;
 
-                            if (((*pck_tinyv)(v_sz-1, flag) & mask) != mask){ // Minimizer was never signaled before as overcrowded
+                        if ((um.dist != 0) && (um.dist != um.size - k_ + 1)) unmapRead(um);
+                    }
+                }
+            }
 
-                                // If minimizer bin already contains abundant k-mer, just set flag for unitig overcrowding
-                                if (((*pck_tinyv)(v_sz-1, flag) & MASK_CONTIG_ID) == MASK_CONTIG_ID) (*pck_tinyv)(v_sz-1, flag) |= MASK_CONTIG_TYPE;
-                                else p.first.getVectorSize() = (flag = pck_tinyv->push_back(mask, flag));
-                            }
+            if (prev_found){ // Previous k-mer was found in the graph => current k-mer (not found in the graph) starts a new unitig
 
-                            mhr = mhr_tmp;
-                            minz_rep = Minimizer(c_str + mhr.pos).rep();
+                prev_found = false;
+                curr_unitig = p.first.toString();
+            }
+            else if (((nb_prev_succ == 0) && (nb_curr_pred == 0))) curr_unitig.push_back(str_seq[p.second + k_ - 1]);
+            else {
 
-                            p = hmap_min_unitigs.insert(minz_rep, packed_tiny_vector(), 0);
-                            pck_tinyv = &(p.first.getVector());
-                            flag = p.first.getVectorSize();
-                            v_sz = pck_tinyv->size(flag);
+                add_graph_function(curr_unitig);
 
-                            for (i = 0; i < v_sz; ++i){
+                curr_unitig = p.first.toString();
+            }
 
-                                if (((*pck_tinyv)(i, flag) & mask) == pos_id_unitig_r){
+            nb_prev_succ = nb_curr_succ;
+            nb_prev_pred = nb_curr_pred;
 
-                                    (*pck_tinyv)(i, flag) = pos_id_unitig;
-                                    break;
-                                }
-                            }
-                        }
-                        else {
+            ++it_km;
+        }
+        else {
 
-                            i = v_sz;
-                            break;
-                        }
-                    }
+            if ((p.second == 0) && !cm.isAbundant && !cm.isShort){
+
+                if ((cm.dist != 0) && (cm.dist != cm.size - k_ + 1)){
+
+                    const size_t len = cm.len;
+
+                    cm.len = 1;
+                    unmapRead(cm);
+                    cm.len = len;
+                }
+            }
+            else if ((p.second + cm.len == str_seq_len - k_ + 1) && !cm.isAbundant && !cm.isShort){
+
+                cm.dist += cm.len;
+
+                if ((cm.dist != 0) && (cm.dist != cm.size - k_ + 1)){
+
+                    const size_t len = cm.len;
+
+                    cm.len = 1;
+                    unmapRead(cm);
+                    cm.len = len;
                 }
+            }
+
+            it_km += cm.len;
+
+            if (!prev_found){
+
+                add_graph_function(curr_unitig);
+
+                prev_found = true;
+            }
+        }
+    }
+
+    if (!prev_found) add_graph_function(curr_unitig);
+
+    return true;
+}
+
+template<typename U, typename G>
+bool CompactedDBG<U, G>::annotateSplitUnitig(const string& seq, LockGraph& lck_g, const bool verbose){
+
+    if (invalid){
+
+        cerr << "CompactedDBG::annotateSplitUnitig(): Graph is invalid and no sequence can be added to it" << endl;
+        return false;
+    }
+
+    if (seq.length() < k_){
+
+        cerr << "CompactedDBG::annotateSplitUnitig(): Input sequence length cannot be less than k = " << k_ << endl;
+        return false;
+    }
+
+    size_t nb_curr_pred = 0;
+    size_t nb_curr_succ = 0;
+    size_t nb_prev_pred = 0xFFFFFFFFFFFFFFFF;
+    size_t nb_prev_succ = 0xFFFFFFFFFFFFFFFF;
+
+    bool prev_found = true;
+
+    string curr_unitig;
 
-                if (i == v_sz){
+    const char* str_seq = seq.c_str();
 
-                    packed_tiny_vector& v = p.first.getVector();
-                    uint8_t& flag_v = p.first.getVectorSize();
+    const size_t str_seq_len = seq.length();
 
-                    if (v_sz == 0) flag_v = v.push_back(pos_id_unitig, flag_v); //Newly created vector, just push unitig ID
-                    else if (isShort && (v_sz >= min_abundance_lim)){ //The minimizer (is/might be) too abundant
+    auto add_graph_function = [&](const string& unitig){
 
-                        isShort = false;
-                        isAbundant = true;
+        const char* str_unitig = unitig.c_str();
+        const size_t len_unitig = unitig.length();
 
-                        it_min = it_min_end;
+        lck_g.acquire_writer();
 
-                        break;
-                    }
-                    else if ((v(v_sz-1, flag_v) & MASK_CONTIG_ID) == MASK_CONTIG_ID){ //If minimizer is abundant or crowded
+        if (len_unitig == k_){
 
-                        if ((v_sz == 1) || (v(v_sz-2, flag_v) != pos_id_unitig)) flag_v = v.insert(pos_id_unitig, v_sz-1, flag_v);
-                    }
-                    else if (v(v_sz-1, flag_v) != pos_id_unitig) flag_v = v.push_back(pos_id_unitig, flag_v);
-                }
+            if (!addUnitig(str_unitig, km_unitigs.size())) km_unitigs.setFull(km_unitigs.size() - 1);
+            else h_kmers_ccov.find(Kmer(str_unitig).rep())->ccov.setFull();
+        }
+        else {
 
-                last_pos_min = min_h_res.pos;
-                ++it_it_min;
-            }
+            addUnitig(str_unitig, v_unitigs.size());
+
+            v_unitigs[v_unitigs.size() - 1]->getCov().setFull();
         }
-    }
 
-    if (isAbundant){
+        lck_g.release_writer();
+    };
 
-        if (id_unitig == km_unitigs.size()) km_unitigs.push_back(km_rep);
-        else km_unitigs.set(id_unitig, km_rep);
+    for (KmerIterator it_km(str_seq), it_km_end; it_km != it_km_end;) { //non-ACGT char. are discarded
 
-        deleteUnitig_<is_void<U>::value>(true, false, id_unitig, false);
+        const std::pair<Kmer, int>& p = *it_km;
 
-        if (id_unitig == km_unitigs.size() - 1) km_unitigs.resize(km_unitigs.size() - 1);
+        lck_g.acquire_reader();
 
-        it_min = minHashIterator<RepHash>(c_str, len, k_, g_, RepHash(), true);
+        UnitigMap<U, G> cm = findUnitig(p.first, str_seq, p.second);
 
-        for (int64_t last_pos_min = -1; it_min != it_min_end; ++it_min){
+        if (cm.isEmpty){
 
-            if (last_pos_min < it_min.getPosition()){ //If current minimizer was not seen before
+            vector<UnitigMap<U, G>> um_bw(findPredecessors(p.first));
+            vector<UnitigMap<U, G>> um_fw(findSuccessors(p.first));
 
-                minHashResultIterator<RepHash> it_it_min = *it_min, it_it_min_end;
+            nb_curr_pred = 0;
+            nb_curr_succ = 0;
 
-                while (it_it_min != it_it_min_end){
+            for (auto& um : um_bw){
 
-                    const minHashResult& min_h_res = *it_it_min;
-                    Minimizer minz_rep = Minimizer(c_str + min_h_res.pos).rep(); //Get the minimizer to insert
-                    std::pair<MinimizerIndex::iterator, bool> p = hmap_min_unitigs.insert(minz_rep, packed_tiny_vector(), 0);
-                    packed_tiny_vector& v = p.first.getVector();
-                    uint8_t& flag_v = p.first.getVectorSize();
-                    const size_t v_sz = v.size(flag_v);
+                if (!um.isEmpty){
 
-                    if ((v_sz > 0) && ((v(v_sz-1, flag_v) & MASK_CONTIG_ID) == MASK_CONTIG_ID)) v(v_sz-1, flag_v)++;
-                    else flag_v = v.push_back(MASK_CONTIG_ID + 1, flag_v);
+                    ++nb_curr_pred;
 
-                    last_pos_min = min_h_res.pos;
-                    ++it_it_min;
+                    if (!um.isAbundant && !um.isShort){
+
+                        um.dist += um.strand;
+
+                        if ((um.dist != 0) && (um.dist != um.size - k_ + 1)) unmapRead(um, lck_g);
+                    }
                 }
             }
-        }
 
-        h_kmers_ccov.insert(km_rep, CompressedCoverage_t<U>(1));
-    }
-    else if (isShort){
+            for (auto& um : um_fw){
 
-        if (id_unitig == km_unitigs.size()) km_unitigs.push_back(km_rep);
-        else km_unitigs.set(id_unitig, km_rep);
-    }
-    else if (id_unitig == v_unitigs.size()) v_unitigs.push_back(new Unitig<U>(c_str)); //Push unitig to list of unitigs
-    else v_unitigs[id_unitig] = new Unitig<U>(c_str);
+                if (!um.isEmpty){
 
-    return isAbundant;
-}
+                    ++nb_curr_succ;
 
-template<typename U, typename G>
-void CompactedDBG<U, G>::swapUnitigs(const bool isShort, const size_t id_a, const size_t id_b){
+                    if (!um.isAbundant && !um.isShort){
 
-    size_t shift_id_unitig_a = id_a << 32;
-    size_t shift_id_unitig_b = id_b << 32;
+                        um.dist += !um.strand;
 
-    const size_t mask = MASK_CONTIG_ID | MASK_CONTIG_TYPE;
+                        if ((um.dist != 0) && (um.dist != um.size - k_ + 1)) unmapRead(um, lck_g);
+                    }
+                }
+            }
 
-    string str;
+            lck_g.release_reader();
 
-    size_t h_sz = 0;
+            if (prev_found){ // Previous k-mer was found in the graph => current k-mer (not found in the graph) starts a new unitig
 
-    // Swap the unitig pointers in v_unitigs
-    if (isShort){
+                prev_found = false;
+                curr_unitig = p.first.toString();
+            }
+            else if (((nb_prev_succ == 0) && (nb_curr_pred == 0))) curr_unitig.push_back(str_seq[p.second + k_ - 1]);
+            else {
 
-        km_unitigs.swap(id_a, id_b);
+                add_graph_function(curr_unitig);
 
-        shift_id_unitig_a |= MASK_CONTIG_TYPE;
-        shift_id_unitig_b |= MASK_CONTIG_TYPE;
+                curr_unitig = p.first.toString();
+            }
 
-        str = km_unitigs.getKmer(id_a).toString();
-        h_sz = 4;
-    }
-    else {
+            nb_prev_succ = nb_curr_succ;
+            nb_prev_pred = nb_curr_pred;
 
-        std::swap(v_unitigs[id_a], v_unitigs[id_b]);
+            ++it_km;
+        }
+        else {
 
-        str = v_unitigs[id_a]->getSeq().toString();
-        h_sz = (v_unitigs[id_a]->length() / 4) + (v_unitigs[id_b]->length() / 4);
-    }
+            if ((p.second == 0) && !cm.isAbundant && !cm.isShort){
 
-    MinimizerHashTable<uint8_t> minimizers(h_sz);
+                if ((cm.dist != 0) && (cm.dist != cm.size - k_ + 1)){
 
-    bool isForbidden = false;
+                    const size_t len = cm.len;
 
-    // Swap the unitig IDs in the minimizer hash table
-    const char* s = str.c_str();
+                    cm.len = 1;
+                    unmapRead(cm, lck_g);
+                    cm.len = len;
+                }
+            }
+            else if ((p.second + cm.len == str_seq_len - k_ + 1) && !cm.isAbundant && !cm.isShort){
 
-    size_t len = str.size();
+                cm.dist += cm.len;
 
-    minHashIterator<RepHash> it_min(s, len, k_, g_, RepHash(), true), it_min_end;
-    minHashResult mhr, mhr_tmp;
+                if ((cm.dist != 0) && (cm.dist != cm.size - k_ + 1)){
 
-    for (int64_t last_pos_min = -1; it_min != it_min_end; ++it_min){ // Iterate over minimizers of unitig
+                    const size_t len = cm.len;
 
-        if ((last_pos_min < it_min.getPosition()) || isForbidden){ // If a new minimizer is found in unitig
+                    cm.len = 1;
+                    unmapRead(cm, lck_g);
+                    cm.len = len;
+                }
+            }
 
-            minHashResultIterator<RepHash> it_it_min(*it_min), it_it_min_end;
-            isForbidden = false;
+            lck_g.release_reader();
 
-            while (it_it_min != it_it_min_end){ // Iterate over minimizers of current k-mer in unitig
+            it_km += cm.len;
 
-                const minHashResult& min_h_res = *it_it_min;
-                Minimizer minz_rep = Minimizer(s + min_h_res.pos).rep();
-                MinimizerIndex::iterator it_h = hmap_min_unitigs.find(minz_rep);
+            if (!prev_found){
 
-                if (it_h != hmap_min_unitigs.end()){
+                add_graph_function(curr_unitig);
 
-                    if (minimizers.find(minz_rep) == minimizers.end()){
+                prev_found = true;
+            }
+        }
+    }
 
-                        minimizers.insert(minz_rep, 0);
+    if (!prev_found) add_graph_function(curr_unitig);
 
-                        packed_tiny_vector& v = it_h.getVector();
-                        const uint8_t flag_v = it_h.getVectorSize();
-                        const size_t v_sz = v.size(flag_v);
+    return true;
+}
 
-                        for (size_t i = 0; i < v_sz; ++i){
+template<typename U, typename G>
+template<bool is_void>
+typename std::enable_if<!is_void, void>::type CompactedDBG<U, G>::deleteUnitig_(const bool isShort, const bool isAbundant,
+                                                                                const size_t id_unitig, const bool delete_data){
 
-                             // Swap the unitig ids but do not change positions;
-                            if ((v(i, flag_v) & mask) == shift_id_unitig_b) v(i, flag_v) = shift_id_unitig_a | (v(i, flag_v) & MASK_CONTIG_POS);
-                            else if ((v(i, flag_v) & mask) == shift_id_unitig_a) v(i, flag_v) = shift_id_unitig_b | (v(i, flag_v) & MASK_CONTIG_POS);
-                        }
-                    }
+    clearOvercrowdedKmers();
+    clearNeighbors();
 
-                    packed_tiny_vector* v = &(it_h.getVector());
-                    uint8_t flag_v = it_h.getVectorSize();
-                    size_t v_sz = v->size(flag_v);
+    if (isAbundant){
 
-                    mhr = min_h_res;
+        char km_str[MAX_KMER_SIZE];
 
-                    while (((*v)(v_sz-1, flag_v) & mask) == mask){
+        typename h_kmers_ccov_t::iterator it_h = h_kmers_ccov.find(id_unitig);
 
-                        mhr_tmp = it_min.getNewMin(mhr); //Recompute a new (different) minimizer for current k-mer
-                        isForbidden = true;
+        const Kmer km = it_h.getKey();
 
-                        if (mhr_tmp.hash != mhr.hash){
+        km.toString(km_str);
 
-                            minz_rep = Minimizer(s + mhr_tmp.pos).rep();
-                            it_h = hmap_min_unitigs.find(minz_rep);
+        minHashIterator<MinimizerOrderHash> it_min(km_str, k_, k_, g_, MinimizerOrderHash(), true), it_min_end;
 
-                            if (it_h == hmap_min_unitigs.end()) break;
+        if (delete_data) it_h->getData()->clear(UnitigMap<U, G>(id_unitig, 0, 1, k_, isShort, isAbundant, true, this));
 
-                            if (minimizers.find(minz_rep) == minimizers.end()){
+        it_h->ccov.clear();
+        h_kmers_ccov.erase(it_h);
 
-                                minimizers.insert(minz_rep, 0);
+        for (int64_t last_pos_min = -1; it_min != it_min_end; ++it_min){ // Iterate over minimizers of unitig to delete
 
-                                packed_tiny_vector& v_tmp = it_h.getVector();
-                                const uint8_t flag_v_tmp = it_h.getVectorSize();
-                                const size_t v_sz_tmp = v_tmp.size(flag_v_tmp);
+            if (last_pos_min < it_min.getPosition()){ // If a new minimizer hash is found in unitig to delete
 
-                                for (size_t i = 0; i < v_sz_tmp; ++i){
+                minHashResultIterator<MinimizerOrderHash> it_it_min = *it_min, it_it_min_end;
 
-                                     // Swap the unitig ids but do not change positions;
-                                    if ((v_tmp(i, flag_v_tmp) & mask) == shift_id_unitig_b){
+                while (it_it_min != it_it_min_end){ // Iterate over minimizers of current k-mer in unitig to delete
 
-                                        v_tmp(i, flag_v_tmp) = shift_id_unitig_a | (v_tmp(i, flag_v_tmp) & MASK_CONTIG_POS);
-                                    }
-                                    else if ((v_tmp(i, flag_v_tmp) & mask) == shift_id_unitig_a){
+                    const minHashResult& min_h_res = *it_it_min;
+                    Minimizer minz_rep = Minimizer(km_str + min_h_res.pos).rep(); // Get canonical minimizer
+                    MinimizerIndex::iterator it_h = hmap_min_unitigs.find(minz_rep);
 
-                                        v_tmp(i, flag_v_tmp) = shift_id_unitig_b | (v_tmp(i, flag_v_tmp) & MASK_CONTIG_POS);
-                                    }
-                                }
-                            }
+                    if (it_h != hmap_min_unitigs.end()){ // If the minimizer is found
 
-                            mhr = mhr_tmp;
-                            v = &(it_h.getVector());
-                            flag_v = it_h.getVectorSize();
-                            v_sz = v->size(flag_v);
+                        packed_tiny_vector& v = it_h.getVector();
+                        uint8_t& flag_v = it_h.getVectorSize();
+
+                        const size_t last_pos_v = v.size(flag_v) - 1;
+
+                        v(last_pos_v, flag_v)--;
+
+                        if (((v(last_pos_v, flag_v) & RESERVED_ID) == 0) && ((v(last_pos_v, flag_v) & MASK_CONTIG_TYPE) != MASK_CONTIG_TYPE)){
+
+                            if (last_pos_v == 0) hmap_min_unitigs.erase(minz_rep);
+                            else flag_v = v.remove(v.size(flag_v) - 1, flag_v);
                         }
-                        else break;
                     }
+
+                    last_pos_min = min_h_res.pos;
+                    ++it_it_min;
                 }
+            }
+        }
+    }
+    else {
+
+        bool isForbidden = false;
+
+        size_t pos_id_unitig = id_unitig << 32;
+        const size_t mask = MASK_CONTIG_ID | MASK_CONTIG_TYPE;
+
+        string str;
+
+        if (isShort){
 
-                last_pos_min = min_h_res.pos;
-                ++it_it_min;
-            }
+            str = km_unitigs.getKmer(id_unitig).toString();
+            pos_id_unitig |= MASK_CONTIG_TYPE;
         }
-    }
+        else str = v_unitigs[id_unitig]->getSeq().toString();
 
-    str = isShort ? km_unitigs.getKmer(id_b).toString() : v_unitigs[id_b]->getSeq().toString();
-    s = str.c_str();
-    len = str.size();
+        const char* s = str.c_str();
 
-    isForbidden = false;
+        const size_t len = str.size();
 
-    minHashIterator<RepHash> it_min2(s, len, k_, g_, RepHash(), true);
+        minHashIterator<MinimizerOrderHash> it_min(s, len, k_, g_, MinimizerOrderHash(), true), it_min_end;
+        minHashResult mhr, mhr_tmp;
 
-    for (int64_t last_pos_min = -1; it_min2 != it_min_end; ++it_min2){ // Iterate over minimizers of unitig
+        // The unitig is deleted but its space in the unitig vector is not because:
+        // 1 - It would change indices in the minimizer hash table
+        if (isShort){
 
-        if ((last_pos_min < it_min2.getPosition()) || isForbidden){ // If a new minimizer is found in unitig
+            if (delete_data) km_unitigs.getData(id_unitig)->clear(UnitigMap<U, G>(id_unitig, 0, 1, len, isShort, isAbundant, true, this));
 
-            minHashResultIterator<RepHash> it_it_min(*it_min2), it_it_min_end;
-            isForbidden = false;
+            Kmer empty_km;
 
-            while (it_it_min != it_it_min_end){ // Iterate over minimizers of current k-mer in unitig
+            empty_km.set_deleted();
 
-                const minHashResult& min_h_res = *it_it_min;
-                Minimizer minz_rep = Minimizer(s + min_h_res.pos).rep();
-                MinimizerIndex::iterator it_h = hmap_min_unitigs.find(minz_rep);
+            km_unitigs.set(id_unitig, empty_km, 0);
+        }
+        else {
 
-                if (it_h != hmap_min_unitigs.end()){
+            if (delete_data) v_unitigs[id_unitig]->getData()->clear(UnitigMap<U, G>(id_unitig, 0, len - k_ + 1, len, isShort, isAbundant, true, this));
 
-                    if (minimizers.find(minz_rep) == minimizers.end()){
+            delete v_unitigs[id_unitig];
+            v_unitigs[id_unitig] = nullptr;
+        }
 
-                        minimizers.insert(minz_rep, 0);
+        for (int64_t last_pos_min = -1; it_min != it_min_end; ++it_min){ // Iterate over minimizers of unitig to delete
 
-                        packed_tiny_vector& v = it_h.getVector();
-                        const uint8_t flag_v = it_h.getVectorSize();
-                        const size_t v_sz = v.size(flag_v);
+            if ((last_pos_min < it_min.getPosition()) || isForbidden){ // If a new minimizer hash is found in unitig to delete
 
-                        for (size_t i = 0; i < v_sz; ++i){
+                minHashResultIterator<MinimizerOrderHash> it_it_min = *it_min, it_it_min_end;
+                isForbidden = false;
 
-                            if ((v(i, flag_v) & mask) == shift_id_unitig_a) v(i, flag_v) = shift_id_unitig_b | (v(i, flag_v) & MASK_CONTIG_POS);
-                        }
-                    }
+                while (it_it_min != it_it_min_end){ // Iterate over minimizers of current k-mer in unitig to delete
 
-                    packed_tiny_vector* v = &(it_h.getVector());
-                    uint8_t flag_v = it_h.getVectorSize();
-                    size_t v_sz = v->size(flag_v);
+                    const minHashResult& min_h_res = *it_it_min;
+                    Minimizer minz_rep = Minimizer(s + min_h_res.pos).rep(); // Get canonical minimizer
+                    MinimizerIndex::iterator it_h = hmap_min_unitigs.find(minz_rep);
 
                     mhr = min_h_res;
 
-                    while (((*v)(v_sz-1, flag_v) & mask) == mask){
+                    while (it_h != hmap_min_unitigs.end()){ // If the minimizer is found
 
-                        mhr_tmp = it_min2.getNewMin(mhr); //Recompute a new (different) minimizer for current k-mer
-                        isForbidden = true;
+                        packed_tiny_vector& v = it_h.getVector();
+                        uint8_t& flag_v = it_h.getVectorSize();
+                        size_t i = 0, v_sz = v.size(flag_v);
 
-                        if (mhr_tmp.hash != mhr.hash){
+                        while (i < v_sz){
 
-                            minz_rep = Minimizer(s + mhr_tmp.pos).rep();
-                            it_h = hmap_min_unitigs.find(minz_rep);
+                            if ((v(i, flag_v) & mask) == pos_id_unitig){
 
-                            if (it_h == hmap_min_unitigs.end()) break;
+                                flag_v = v.remove(i, flag_v);
+                                --v_sz;
+                            }
+                            else ++i;
+                        }
 
-                            if (minimizers.find(minz_rep) == minimizers.end()){
+                        it_h = hmap_min_unitigs.end();
 
-                                minimizers.insert(minz_rep, 0);
+                        if (v.size(flag_v) == 0) hmap_min_unitigs.erase(minz_rep);
+                        else if (!isShort && ((v(v_sz-1, flag_v) & mask) == mask)){ //Minimizer bin is overcrowded
 
-                                packed_tiny_vector& v_tmp = it_h.getVector();
-                                const uint8_t flag_v_tmp = it_h.getVectorSize();
-                                const size_t v_sz_tmp = v_tmp.size(flag_v_tmp);
 
-                                for (size_t i = 0; i < v_sz_tmp; ++i){
+                            mhr_tmp = it_min.getNewMin(mhr); //Recompute a new (different) minimizer for current k-mer
+                            isForbidden = true;
 
-                                    if ((v_tmp(i, flag_v_tmp) & mask) == shift_id_unitig_a) {
+                            if (mhr_tmp.hash != mhr.hash){
 
-                                        v_tmp(i, flag_v_tmp) = shift_id_unitig_b | (v_tmp(i, flag_v_tmp) & MASK_CONTIG_POS);
-                                    }
-                                }
+                                mhr = mhr_tmp;
+                                minz_rep = Minimizer(s + mhr.pos).rep();
+                                it_h = hmap_min_unitigs.find(minz_rep);
                             }
-
-                            mhr = mhr_tmp;
-                            v = &(it_h.getVector());
-                            flag_v = it_h.getVectorSize();
-                            v_sz = v->size(flag_v);
+                            else break;
                         }
-                        else break;
                     }
-                }
 
-                last_pos_min = min_h_res.pos;
-                ++it_it_min;
+                    last_pos_min = min_h_res.pos;
+                    ++it_it_min;
+                }
             }
         }
     }
 }
 
-// Input sequence must not contain duplicated k-mers
-// If it does, use CompactedDBG<U, G>::add().
 template<typename U, typename G>
-bool CompactedDBG<U, G>::mergeUnitig(const string& seq, const bool verbose){
-
-    if (invalid){
-
-        cerr << "CompactedDBG::mergeUnitig(): Graph is invalid and no sequence can be added to it" << endl;
-        return false;
-    }
-
-    if (seq.length() < k_){
+template<bool is_void>
+typename std::enable_if<is_void, void>::type CompactedDBG<U, G>::deleteUnitig_( const bool isShort, const bool isAbundant,
+                                                                                const size_t id_unitig, const bool delete_data){
 
-        cerr << "CompactedDBG::mergeUnitig(): Input sequence length cannot be less than k = " << k_ << endl;
-        return false;
-    }
+    clearOvercrowdedKmers();
+    clearNeighbors();
 
-    size_t nxt_pos_insert_v_unitigs = v_unitigs.size();
-    size_t v_unitigs_sz = v_unitigs.size();
-    size_t v_kmers_sz = km_unitigs.size();
+    if (isAbundant){
 
-    size_t nb_curr_pred = 0;
-    size_t nb_curr_succ = 0;
-    size_t nb_prev_pred = 0xFFFFFFFFFFFFFFFF;
-    size_t nb_prev_succ = 0xFFFFFFFFFFFFFFFF;
+        char km_str[MAX_KMER_SIZE];
 
-    size_t added = 0;
-    size_t split_before = 0, split_after = 0;
+        typename h_kmers_ccov_t::iterator it_h = h_kmers_ccov.find(id_unitig);
 
-    bool prev_found = true;
+        const Kmer km = it_h.getKey();
 
-    string curr_unitig;
+        km.toString(km_str);
 
-    vector<Kmer> v_joins;
+        minHashIterator<MinimizerOrderHash> it_min(km_str, k_, k_, g_, MinimizerOrderHash(), true), it_min_end;
 
-    KmerHashTable<vector<size_t>> kht;
+        it_h->ccov.clear();
+        h_kmers_ccov.erase(it_h);
 
-    const char* str_seq = seq.c_str();
+        for (int64_t last_pos_min = -1; it_min != it_min_end; ++it_min){ // Iterate over minimizers of unitig to delete
 
-    const size_t str_seq_len = seq.length();
+            if (last_pos_min < it_min.getPosition()){ // If a new minimizer hash is found in unitig to delete
 
-    auto add_graph_function = [&](const string& unitig){
+                minHashResultIterator<MinimizerOrderHash> it_it_min = *it_min, it_it_min_end;
 
-        const char* str_unitig = unitig.c_str();
-        const size_t len_unitig = unitig.length();
+                while (it_it_min != it_it_min_end){ // Iterate over minimizers of current k-mer in unitig to delete
 
-        if (len_unitig == k_){
+                    const minHashResult& min_h_res = *it_it_min;
+                    Minimizer minz_rep = Minimizer(km_str + min_h_res.pos).rep(); // Get canonical minimizer
+                    MinimizerIndex::iterator it_h = hmap_min_unitigs.find(minz_rep);
 
-            if (!addUnitig(str_unitig, v_kmers_sz)){
+                    if (it_h != hmap_min_unitigs.end()){ // If the minimizer is found
 
-                km_unitigs.setFull(v_kmers_sz);
+                        packed_tiny_vector& v = it_h.getVector();
+                        uint8_t& flag_v = it_h.getVectorSize();
 
-                ++v_kmers_sz;
-                ++added;
-            }
-            else h_kmers_ccov.find(Kmer(str_unitig).rep())->ccov.setFull();
-        }
-        else {
+                        const size_t last_pos_v = v.size(flag_v) - 1;
 
-            addUnitig(str_unitig, nxt_pos_insert_v_unitigs);
+                        v(last_pos_v, flag_v)--;
 
-            v_unitigs[nxt_pos_insert_v_unitigs]->getCov().setFull();
+                        if (((v(last_pos_v, flag_v) & RESERVED_ID) == 0) && ((v(last_pos_v, flag_v) & MASK_CONTIG_TYPE) != MASK_CONTIG_TYPE)){
 
-            ++nxt_pos_insert_v_unitigs;
-            ++added;
+                            if (last_pos_v == 0) hmap_min_unitigs.erase(minz_rep);
+                            else flag_v = v.remove(v.size(flag_v) - 1, flag_v);
+                        }
+                    }
 
-            v_joins.push_back(Kmer(str_unitig + len_unitig - k_));
+                    last_pos_min = min_h_res.pos;
+                    ++it_it_min;
+                }
+            }
         }
+    }
+    else {
 
-        v_joins.push_back(Kmer(str_unitig));
-    };
-
-    auto add_split_function = [&](){
-
-        KmerHashTable<vector<size_t>>::iterator it(kht.begin());
-        const KmerHashTable<vector<size_t>>::iterator it_end(kht.end());
-
-        vector<pair<int,int>> sp;
-
-        while (it != it_end){
+        bool isForbidden = false;
 
-            ++split_before;
-            ++split_after;
+        size_t pos_id_unitig = id_unitig << 32;
+        const size_t mask = MASK_CONTIG_ID | MASK_CONTIG_TYPE;
 
-            const_UnitigMap<U, G> um(find(it.getKey(), true));
+        string str;
 
-            vector<size_t>& split_v = *it;
+        if (isShort){
 
-            sort(split_v.begin(), split_v.end());
+            str = km_unitigs.getKmer(id_unitig).toString();
+            pos_id_unitig |= MASK_CONTIG_TYPE;
+        }
+        else str = v_unitigs[id_unitig]->getSeq().toString();
 
-            size_t prev_split_pos = 0;
+        const char* s = str.c_str();
 
-            for (const auto pos : split_v){
+        const size_t len = str.size();
 
-                if (pos != prev_split_pos){
+        minHashIterator<MinimizerOrderHash> it_min(s, len, k_, g_, MinimizerOrderHash(), true), it_min_end;
+        minHashResult mhr, mhr_tmp;
 
-                    sp.push_back({prev_split_pos, pos});
+        // The unitig is deleted but its space in the unitig vector is not because:
+        // 1 - It would change indices in the minimizer hash table
+        if (isShort){
 
-                    v_joins.push_back(um.getUnitigKmer(prev_split_pos));
-                    if (prev_split_pos != pos - 1) v_joins.push_back(um.getUnitigKmer(pos - 1));
+            Kmer empty_km;
 
-                    prev_split_pos = pos;
+            empty_km.set_deleted();
+            km_unitigs.set(id_unitig, empty_km, 0);
+        }
+        else {
 
-                    ++split_after;
-                }
-            }
+            delete v_unitigs[id_unitig];
+            v_unitigs[id_unitig] = nullptr;
+        }
 
-            sp.push_back({prev_split_pos, um.size - k_ + 1});
+        for (int64_t last_pos_min = -1; it_min != it_min_end; ++it_min){ // Iterate over minimizers of unitig to delete
 
-            v_joins.push_back(um.getUnitigKmer(prev_split_pos));
-            if (prev_split_pos != um.size - k_) v_joins.push_back(um.getUnitigKmer(um.size - k_));
+            if ((last_pos_min < it_min.getPosition()) || isForbidden){ // If a new minimizer hash is found in unitig to delete
 
-            extractUnitig_<is_void<U>::value>(um.pos_unitig, nxt_pos_insert_v_unitigs, v_unitigs_sz, v_kmers_sz, sp);
+                minHashResultIterator<MinimizerOrderHash> it_it_min = *it_min, it_it_min_end;
+                isForbidden = false;
 
-            sp.clear();
-            split_v.clear();
+                while (it_it_min != it_it_min_end){ // Iterate over minimizers of current k-mer in unitig to delete
 
-            ++it;
-        }
+                    const minHashResult& min_h_res = *it_it_min;
+                    Minimizer minz_rep = Minimizer(s + min_h_res.pos).rep(); // Get canonical minimizer
+                    MinimizerIndex::iterator it_h = hmap_min_unitigs.find(minz_rep);
 
-        kht.clear();
-    };
+                    mhr = min_h_res;
 
-    for (KmerIterator it_km(str_seq), it_km_end; it_km != it_km_end;) { //non-ACGT char. are discarded
+                    while (it_h != hmap_min_unitigs.end()){ // If the minimizer is found
 
-        const std::pair<Kmer, int>& p = *it_km;
+                        packed_tiny_vector& v = it_h.getVector();
+                        uint8_t& flag_v = it_h.getVectorSize();
+                        size_t i = 0, v_sz = v.size(flag_v);
 
-        UnitigMap<U, G> cm = findUnitig(p.first, str_seq, p.second);
+                        while (i < v_sz){
 
-        if (cm.isEmpty){
+                            if ((v(i, flag_v) & mask) == pos_id_unitig){
 
-            vector<UnitigMap<U, G>> um_bw(findPredecessors(p.first));
-            vector<UnitigMap<U, G>> um_fw(findSuccessors(p.first));
+                                flag_v = v.remove(i, flag_v);
+                                --v_sz;
+                            }
+                            else ++i;
+                        }
 
-            nb_curr_pred = 0;
-            nb_curr_succ = 0;
+                        it_h = hmap_min_unitigs.end();
 
-            for (auto& um : um_bw){
+                        if (v.size(flag_v) == 0) hmap_min_unitigs.erase(minz_rep);
+                        else if (!isShort && ((v(v_sz-1, flag_v) & mask) == mask)){ //Minimizer bin is overcrowded
 
-                if (!um.isEmpty){
 
-                    ++nb_curr_pred;
+                            mhr_tmp = it_min.getNewMin(mhr); //Recompute a new (different) minimizer for current k-mer
+                            isForbidden = true;
 
-                    if (!um.isAbundant && !um.isShort){
+                            if (mhr_tmp.hash != mhr.hash){
 
-                        um.dist += um.strand;
-                        if ((um.dist != 0) && (um.dist != um.size - k_ + 1)) kht.insert(um.getUnitigHead(), vector<size_t>()).first->push_back(um.dist);
+                                mhr = mhr_tmp;
+                                minz_rep = Minimizer(s + mhr.pos).rep();
+                                it_h = hmap_min_unitigs.find(minz_rep);
+                            }
+                            else break;
+                        }
                     }
+
+                    last_pos_min = min_h_res.pos;
+                    ++it_it_min;
                 }
             }
+        }
+    }
+}
 
-            for (auto& um : um_fw){
-
-                if (!um.isEmpty){
-
-                    ++nb_curr_succ;
+template<typename U, typename G>
+void CompactedDBG<U, G>::deleteUnitig_(const bool isShort, const bool isAbundant, const size_t id_unitig, const string& str){
 
-                    if (!um.isAbundant && !um.isShort){
+    clearOvercrowdedKmers();
+    clearNeighbors();
 
-                        um.dist += !um.strand;
-                        if ((um.dist != 0) && (um.dist != um.size - k_ + 1)) kht.insert(um.getUnitigHead(), vector<size_t>()).first->push_back(um.dist);
-                    }
-                }
-            }
+    const char* s = str.c_str();
+    const size_t len = str.size();
 
-            if (prev_found){ // Previous k-mer was found in the graph => current k-mer (not found in the graph) starts a new unitig
+    if (isAbundant){
 
-                prev_found = false;
-                curr_unitig = p.first.toString();
-            }
-            else if ((nb_prev_succ == 0) && (nb_curr_pred == 0)) curr_unitig.push_back(str_seq[p.second + k_ - 1]);
-            else {
+        minHashIterator<MinimizerOrderHash> it_min(s, k_, k_, g_, MinimizerOrderHash(), true), it_min_end;
 
-                add_graph_function(curr_unitig);
+        for (int64_t last_pos_min = -1; it_min != it_min_end; ++it_min){ // Iterate over minimizers of unitig to delete
 
-                curr_unitig = p.first.toString();
-            }
+            if (last_pos_min < it_min.getPosition()){ // If a new minimizer hash is found in unitig to delete
 
-            nb_prev_succ = nb_curr_succ;
-            nb_prev_pred = nb_curr_pred;
+                minHashResultIterator<MinimizerOrderHash> it_it_min = *it_min, it_it_min_end;
 
-            ++it_km;
-        }
-        else {
+                while (it_it_min != it_it_min_end){ // Iterate over minimizers of current k-mer in unitig to delete
 
-            if ((p.second == 0) && !cm.isAbundant && !cm.isShort){
+                    const minHashResult& min_h_res = *it_it_min;
+                    Minimizer minz_rep = Minimizer(s + min_h_res.pos).rep(); // Get canonical minimizer
+                    MinimizerIndex::iterator it_h = hmap_min_unitigs.find(minz_rep);
 
-                if ((cm.dist != 0) && (cm.dist != cm.size - k_ + 1)) kht.insert(cm.getUnitigHead(), vector<size_t>()).first->push_back(cm.dist);
-            }
-            else if ((p.second + cm.len == str_seq_len - k_ + 1) && !cm.isAbundant && !cm.isShort){
+                    if (it_h != hmap_min_unitigs.end()){ // If the minimizer is found
 
-                cm.dist += cm.len;
+                        packed_tiny_vector& v = it_h.getVector();
+                        uint8_t& flag_v = it_h.getVectorSize();
 
-                if ((cm.dist != 0) && (cm.dist != cm.size - k_ + 1)) kht.insert(cm.getUnitigHead(), vector<size_t>()).first->push_back(cm.dist);
-            }
+                        const size_t last_pos_v = v.size(flag_v) - 1;
 
-            it_km += cm.len;
+                        v(last_pos_v, flag_v)--;
 
-            if (!prev_found){
+                        if (((v(last_pos_v, flag_v) & RESERVED_ID) == 0) && ((v(last_pos_v, flag_v) & MASK_CONTIG_TYPE) != MASK_CONTIG_TYPE)){
 
-                add_graph_function(curr_unitig);
+                            if (last_pos_v == 0) hmap_min_unitigs.erase(it_h);
+                            else flag_v = v.remove(v.size(flag_v) - 1, flag_v);
+                        }
+                    }
 
-                prev_found = true;
+                    last_pos_min = min_h_res.pos;
+                    ++it_it_min;
+                }
             }
         }
     }
+    else {
 
-    add_split_function();
-
-    if (!prev_found) add_graph_function(curr_unitig);
+        bool isForbidden = false;
 
-    if (nxt_pos_insert_v_unitigs < v_unitigs.size()) v_unitigs.resize(nxt_pos_insert_v_unitigs);
-    if (v_kmers_sz < km_unitigs.size()) km_unitigs.resize(v_kmers_sz);
+        size_t pos_id_unitig = id_unitig << 32;
+        const size_t mask = MASK_CONTIG_ID | MASK_CONTIG_TYPE;
 
-    const size_t joined = joinUnitigs_<is_void<U>::value>(&v_joins);
+        if (isShort) pos_id_unitig |= MASK_CONTIG_TYPE;
 
-    if (verbose){
+        minHashIterator<MinimizerOrderHash> it_min(s, len, k_, g_, MinimizerOrderHash(), true), it_min_end;
+        minHashResult mhr, mhr_tmp;
 
-        cout << "CompactedDBG::mergeUnitig(): Added " << added << " new unitigs to the graph." << endl;
-        cout << "CompactedDBG::mergeUnitig(): Split " << split_before << " unitigs into " << split_after << " new unitigs." << endl;
-        cout << "CompactedDBG::mergeUnitig(): Joined " << joined << " unitigs from the graph." << endl;
-    }
+        for (int64_t last_pos_min = -1; it_min != it_min_end; ++it_min){ // Iterate over minimizers of unitig to delete
 
-    return true;
-}
+            if ((last_pos_min < it_min.getPosition()) || isForbidden){ // If a new minimizer hash is found in unitig to delete
 
-template<typename U, typename G>
-bool CompactedDBG<U, G>::annotateSplitUnitig(const string& seq, const bool verbose){
+                minHashResultIterator<MinimizerOrderHash> it_it_min = *it_min, it_it_min_end;
+                isForbidden = false;
 
-    if (invalid){
+                while (it_it_min != it_it_min_end){ // Iterate over minimizers of current k-mer in unitig to delete
 
-        cerr << "CompactedDBG::annotateSplitUnitig(): Graph is invalid and no sequence can be added to it" << endl;
-        return false;
-    }
+                    const minHashResult& min_h_res = *it_it_min;
+                    Minimizer minz_rep = Minimizer(s + min_h_res.pos).rep(); // Get canonical minimizer
+                    MinimizerIndex::iterator it_h = hmap_min_unitigs.find(minz_rep);
 
-    if (seq.length() < k_){
+                    mhr = min_h_res;
 
-        cerr << "CompactedDBG::annotateSplitUnitig(): Input sequence length cannot be less than k = " << k_ << endl;
-        return false;
-    }
+                    while (it_h != hmap_min_unitigs.end()){ // If the minimizer is found
 
-    size_t nxt_pos_insert_v_unitigs = v_unitigs.size();
-    size_t v_kmers_sz = km_unitigs.size();
+                        packed_tiny_vector& v = it_h.getVector();
+                        uint8_t& flag_v = it_h.getVectorSize();
+                        size_t i = 0, v_sz = v.size(flag_v);
 
-    size_t nb_curr_pred = 0;
-    size_t nb_curr_succ = 0;
-    size_t nb_prev_pred = 0xFFFFFFFFFFFFFFFF;
-    size_t nb_prev_succ = 0xFFFFFFFFFFFFFFFF;
+                        while (i < v_sz){
 
-    bool prev_found = true;
+                            if ((v(i, flag_v) & mask) == pos_id_unitig){
 
-    string curr_unitig;
+                                flag_v = v.remove(i, flag_v);
+                                --v_sz;
+                            }
+                            else ++i;
+                        }
 
-    const char* str_seq = seq.c_str();
+                        if (v.size(flag_v) == 0) it_h = hmap_min_unitigs.end();
+                        else if (!isShort && ((v(v_sz-1, flag_v) & mask) == mask)){ //Minimizer bin is overcrowded
 
-    const size_t str_seq_len = seq.length();
+                            mhr_tmp = it_min.getNewMin(mhr); //Recompute a new (different) minimizer for current k-mer
+                            isForbidden = true;
 
-    auto add_graph_function = [&](const string& unitig){
+                            if (mhr_tmp.hash != mhr.hash){
 
-        const char* str_unitig = unitig.c_str();
-        const size_t len_unitig = unitig.length();
+                                mhr = mhr_tmp;
+                                minz_rep = Minimizer(s + mhr.pos).rep();
+                                it_h = hmap_min_unitigs.find(minz_rep);
+                            }
+                            else {
 
-        if (len_unitig == k_){
+                                it_h = hmap_min_unitigs.end();
+                                break;
+                            }
+                        }
+                        else it_h = hmap_min_unitigs.end();
+                    }
 
-            if (!addUnitig(str_unitig, v_kmers_sz)) km_unitigs.setFull(v_kmers_sz++);
-            else h_kmers_ccov.find(Kmer(str_unitig).rep())->ccov.setFull();
+                    last_pos_min = min_h_res.pos;
+                    ++it_it_min;
+                }
+            }
         }
-        else {
+    }
+}
 
-            addUnitig(str_unitig, nxt_pos_insert_v_unitigs);
+template<typename U, typename G>
+template<bool is_void>
+typename std::enable_if<!is_void, bool>::type CompactedDBG<U, G>::extractUnitig_(size_t& pos_v_unitigs, size_t& nxt_pos_insert_v_unitigs,
+                                                                               size_t& v_unitigs_sz, size_t& v_kmers_sz, const vector<pair<int,int>>& sp){
 
-            v_unitigs[nxt_pos_insert_v_unitigs++]->getCov().setFull();
-        }
-    };
+    bool deleted = true;
 
-    for (KmerIterator it_km(str_seq), it_km_end; it_km != it_km_end;) { //non-ACGT char. are discarded
+    if (!sp.empty()){
 
-        const std::pair<Kmer, int>& p = *it_km;
+        const Unitig<U>* unitig = v_unitigs[pos_v_unitigs];
 
-        UnitigMap<U, G> cm = findUnitig(p.first, str_seq, p.second);
+        //const pair<size_t, size_t> lowpair = unitig->ccov.lowCoverageInfo();
 
-        if (cm.isEmpty){
+        //const size_t totalcoverage = unitig->coveragesum - lowpair.second;
+        //const size_t ccov_size = unitig->ccov.size();
 
-            vector<UnitigMap<U, G>> um_bw(findPredecessors(p.first));
-            vector<UnitigMap<U, G>> um_fw(findSuccessors(p.first));
+        const string str = unitig->getSeq().toString();
 
-            nb_curr_pred = 0;
-            nb_curr_succ = 0;
+        size_t i = 0;
 
-            for (auto& um : um_bw){
+        UnitigMap<U, G> um(pos_v_unitigs, 0, 0, unitig->length(), false, false, true, this);
 
-                if (!um.isEmpty){
+        vector<Unitig<U>> v_data(sp.size());
 
-                    ++nb_curr_pred;
+        deleted = false;
 
-                    if (!um.isAbundant && !um.isShort){
+        for (vector<pair<int,int>>::const_iterator sit = sp.begin(); sit != sp.end(); ++sit, ++i) { //Iterate over created split unitigs
 
-                        um.dist += um.strand;
+            um.dist = sit->first;
+            um.len = sit->second - um.dist;
 
-                        if ((um.dist != 0) && (um.dist != um.size - k_ + 1)) unmapRead(um);
-                    }
-                }
-            }
+            if (um.len == 1){
 
-            for (auto& um : um_fw){
+                const string split_str = str.substr(um.dist, um.len + k_ - 1);
 
-                if (!um.isEmpty){
+                um.strand = (split_str <= reverse_complement(split_str));
+            }
+            else um.strand = true;
 
-                    ++nb_curr_succ;
+            v_data[i] = std::move(um.splitData(sit+1 == sp.end()));
+        }
 
-                    if (!um.isAbundant && !um.isShort){
+        i = 0;
 
-                        um.dist += !um.strand;
+        for (vector<pair<int,int>>::const_iterator sit = sp.begin(); sit != sp.end(); ++sit, ++i) { //Iterate over created split unitigs
 
-                        if ((um.dist != 0) && (um.dist != um.size - k_ + 1)) unmapRead(um);
-                    }
-                }
-            }
+            const size_t len = sit->second - sit->first;
+            //const uint64_t cov_tmp = (totalcoverage * len) / (ccov_size - lowpair.first); // Split unitig coverage
+            const uint64_t cov_tmp = len * CompressedCoverage::getFullCoverage();
 
-            if (prev_found){ // Previous k-mer was found in the graph => current k-mer (not found in the graph) starts a new unitig
+            string split_str = str.substr(sit->first, len + k_ - 1); // Split unitig sequence
 
-                prev_found = false;
-                curr_unitig = p.first.toString();
-            }
-            else if (((nb_prev_succ == 0) && (nb_curr_pred == 0))) curr_unitig.push_back(str_seq[p.second + k_ - 1]);
-            else {
+            if (len == 1){
 
-                add_graph_function(curr_unitig);
+                const string split_str_rev = reverse_complement(split_str);
+
+                if (split_str > split_str_rev) split_str = split_str_rev;
 
-                curr_unitig = p.first.toString();
-            }
+                if (addUnitig(split_str, v_kmers_sz)){
 
-            nb_prev_succ = nb_curr_succ;
-            nb_prev_pred = nb_curr_pred;
+                    CompressedCoverage_t<U>& cc_t = *h_kmers_ccov.find(Kmer(split_str.c_str()).rep());
 
-            ++it_km;
-        }
-        else {
+                    cc_t.ccov.setFull();
 
-            if ((p.second == 0) && !cm.isAbundant && !cm.isShort){
+                    *(cc_t.getData()) = std::move(*(v_data[i].getData()));
+                }
+                else {
 
-                if ((cm.dist != 0) && (cm.dist != cm.size - k_ + 1)){
+                    km_unitigs.setFull(v_kmers_sz); // We don't care about the coverage per k-mer anymore
 
-                    const size_t len = cm.len;
+                    *(km_unitigs.getData(v_kmers_sz)) = std::move(*(v_data[i].getData()));
 
-                    cm.len = 1;
-                    unmapRead(cm);
-                    cm.len = len;
+                    ++v_kmers_sz;
                 }
             }
-            else if ((p.second + cm.len == str_seq_len - k_ + 1) && !cm.isAbundant && !cm.isShort){
+            else {
 
-                cm.dist += cm.len;
+                addUnitig(split_str, nxt_pos_insert_v_unitigs);
 
-                if ((cm.dist != 0) && (cm.dist != cm.size - k_ + 1)){
+                //v_unitigs[nxt_pos_insert_v_unitigs]->initializeCoverage(true); //We don't care about the coverage per k-mer anymore
+                v_unitigs[nxt_pos_insert_v_unitigs]->getCov() = CompressedCoverage(v_unitigs[nxt_pos_insert_v_unitigs]->getSeq().size() - k_ + 1, true);
+                //v_unitigs[nxt_pos_insert_v_unitigs]->coveragesum = cov_tmp;
 
-                    const size_t len = cm.len;
+                *(v_unitigs[nxt_pos_insert_v_unitigs]->getData()) = std::move(*(v_data[i].getData()));
 
-                    cm.len = 1;
-                    unmapRead(cm);
-                    cm.len = len;
-                }
+                ++nxt_pos_insert_v_unitigs;
             }
+        }
+    }
 
-            it_km += cm.len;
+    --nxt_pos_insert_v_unitigs; //Position of the last unitig in the vector which is not NULL
 
-            if (!prev_found){
+    if (pos_v_unitigs != nxt_pos_insert_v_unitigs){ // Do not proceed to swap if swap positions are the same
 
-                add_graph_function(curr_unitig);
+        swapUnitigs(false, pos_v_unitigs, nxt_pos_insert_v_unitigs); // Swap unitigs
 
-                prev_found = true;
-            }
-        }
+        // If the swapped unitig, previously in position nxt_pos_insert, was a split unitig
+        // created in this method, do not try to split it again
+        if (nxt_pos_insert_v_unitigs >= v_unitigs_sz) ++pos_v_unitigs;
+        else --v_unitigs_sz;
     }
+    else --v_unitigs_sz;
 
-    if (!prev_found) add_graph_function(curr_unitig);
+    deleteUnitig_<false>(false, false, nxt_pos_insert_v_unitigs);
 
-    return true;
+    return deleted;
 }
 
 template<typename U, typename G>
-bool CompactedDBG<U, G>::annotateSplitUnitig(const string& seq, LockGraph& lck_g, const bool verbose){
+template<bool is_void>
+typename std::enable_if<is_void, bool>::type CompactedDBG<U, G>::extractUnitig_(size_t& pos_v_unitigs, size_t& nxt_pos_insert_v_unitigs,
+                                                                              size_t& v_unitigs_sz, size_t& v_kmers_sz, const vector<pair<int,int>>& sp){
 
-    if (invalid){
+    bool deleted = true;
 
-        cerr << "CompactedDBG::annotateSplitUnitig(): Graph is invalid and no sequence can be added to it" << endl;
-        return false;
-    }
+    if (!sp.empty()){
 
-    if (seq.length() < k_){
+        const Unitig<U>* unitig = v_unitigs[pos_v_unitigs];
 
-        cerr << "CompactedDBG::annotateSplitUnitig(): Input sequence length cannot be less than k = " << k_ << endl;
-        return false;
-    }
+        //const pair<size_t, size_t> lowpair = unitig->ccov.lowCoverageInfo();
 
-    size_t nb_curr_pred = 0;
-    size_t nb_curr_succ = 0;
-    size_t nb_prev_pred = 0xFFFFFFFFFFFFFFFF;
-    size_t nb_prev_succ = 0xFFFFFFFFFFFFFFFF;
+        //const size_t totalcoverage = unitig->coveragesum - lowpair.second;
+        //const size_t ccov_size = unitig->ccov.size();
 
-    bool prev_found = true;
+        const string str = unitig->getSeq().toString();
 
-    string curr_unitig;
+        deleted = false;
 
-    const char* str_seq = seq.c_str();
+        for (vector<pair<int,int>>::const_iterator sit = sp.begin(); sit != sp.end(); ++sit) { //Iterate over created split unitigs
 
-    const size_t str_seq_len = seq.length();
+            const size_t len = sit->second - sit->first;
+            //const uint64_t cov_tmp = (totalcoverage * len) / (ccov_size - lowpair.first); // Split unitig coverage
+            const uint64_t cov_tmp = len * CompressedCoverage::getFullCoverage();
+            const string split_str = str.substr(sit->first, len + k_ - 1); // Split unitig sequence
 
-    auto add_graph_function = [&](const string& unitig){
+            if (len == 1){
 
-        const char* str_unitig = unitig.c_str();
-        const size_t len_unitig = unitig.length();
+                if (addUnitig(split_str, v_kmers_sz, pos_v_unitigs, false)) h_kmers_ccov.find(Kmer(split_str.c_str()).rep())->ccov.setFull();
+                else km_unitigs.setFull(v_kmers_sz++); // We don't care about the coverage per k-mer anymore}
+            }
+            else {
 
-        lck_g.acquire_writer();
+                addUnitig(split_str, nxt_pos_insert_v_unitigs, pos_v_unitigs, false);
 
-        if (len_unitig == k_){
+                //v_unitigs[nxt_pos_insert_v_unitigs]->initializeCoverage(true); //We don't care about the coverage per k-mer anymore
+                v_unitigs[nxt_pos_insert_v_unitigs]->getCov() = CompressedCoverage(v_unitigs[nxt_pos_insert_v_unitigs]->getSeq().size() - k_ + 1, true);
+                //v_unitigs[nxt_pos_insert_v_unitigs]->coveragesum = cov_tmp;
 
-            if (!addUnitig(str_unitig, km_unitigs.size())) km_unitigs.setFull(km_unitigs.size() - 1);
-            else h_kmers_ccov.find(Kmer(str_unitig).rep())->ccov.setFull();
+                ++nxt_pos_insert_v_unitigs;
+            }
         }
-        else {
-
-            addUnitig(str_unitig, v_unitigs.size());
+    }
 
-            v_unitigs[v_unitigs.size() - 1]->getCov().setFull();
-        }
+    --nxt_pos_insert_v_unitigs; //Position of the last unitig in the vector which is not NULL
 
-        lck_g.release_writer();
-    };
+    if (pos_v_unitigs != nxt_pos_insert_v_unitigs){ // Do not proceed to swap if swap positions are the same
 
-    for (KmerIterator it_km(str_seq), it_km_end; it_km != it_km_end;) { //non-ACGT char. are discarded
+        swapUnitigs(false, pos_v_unitigs, nxt_pos_insert_v_unitigs); // Swap unitigs
 
-        const std::pair<Kmer, int>& p = *it_km;
+        // If the swapped unitig, previously in position nxt_pos_insert, was a split unitig
+        // created in this method, do not try to split it again
+        if (nxt_pos_insert_v_unitigs >= v_unitigs_sz) ++pos_v_unitigs;
+        else --v_unitigs_sz;
+    }
+    else --v_unitigs_sz;
 
-        lck_g.acquire_reader();
+    deleteUnitig_<true>(false, false, nxt_pos_insert_v_unitigs);
 
-        UnitigMap<U, G> cm = findUnitig(p.first, str_seq, p.second);
+    return deleted;
+}
 
-        if (cm.isEmpty){
+template<typename U, typename G>
+UnitigMap<U, G> CompactedDBG<U, G>::find(const Kmer& km, const preAllocMinHashIterator<MinimizerOrderHash>& it_min_h) {
 
-            vector<UnitigMap<U, G>> um_bw(findPredecessors(p.first));
-            vector<UnitigMap<U, G>> um_fw(findSuccessors(p.first));
+    const Kmer km_twin = km.twin();
+    const Kmer& km_rep = km < km_twin ? km : km_twin;
 
-            nb_curr_pred = 0;
-            nb_curr_succ = 0;
+    bool isShort;
 
-            for (auto& um : um_bw){
+    size_t unitig_id, unitig_id_pos_tmp, len;
 
-                if (!um.isEmpty){
+    int64_t pos_match;
 
-                    ++nb_curr_pred;
+    const int diff = k_ - g_;
 
-                    if (!um.isAbundant && !um.isShort){
+    preAllocMinHashIterator<MinimizerOrderHash> it_min(it_min_h, k_);
+    preAllocMinHashResultIterator<MinimizerOrderHash> it_it_min = *it_min, it_it_min_end;
 
-                        um.dist += um.strand;
+    minHashResult mhr, mhr_tmp;
 
-                        if ((um.dist != 0) && (um.dist != um.size - k_ + 1)) unmapRead(um, lck_g);
-                    }
-                }
-            }
+    while (it_it_min != it_it_min_end){
 
-            for (auto& um : um_fw){
+        const minHashResult& min_h_res = *it_it_min;
+        Minimizer minz = Minimizer(it_min.s + min_h_res.pos).rep();
+        MinimizerIndex::const_iterator it = hmap_min_unitigs.find(minz);
 
-                if (!um.isEmpty){
+        mhr = min_h_res;
 
-                    ++nb_curr_succ;
+        while (it != hmap_min_unitigs.end()){ // If the minimizer is found
 
-                    if (!um.isAbundant && !um.isShort){
+            const packed_tiny_vector& v = it.getVector();
+            const uint8_t flag_v = it.getVectorSize();
+            const int v_sz = v.size(flag_v);
 
-                        um.dist += !um.strand;
+            it = hmap_min_unitigs.end();
 
-                        if ((um.dist != 0) && (um.dist != um.size - k_ + 1)) unmapRead(um, lck_g);
-                    }
-                }
-            }
+            for (size_t i = 0; i < v_sz; ++i){
 
-            lck_g.release_reader();
+                unitig_id = v(i, flag_v) >> 32;
 
-            if (prev_found){ // Previous k-mer was found in the graph => current k-mer (not found in the graph) starts a new unitig
+                if (unitig_id == RESERVED_ID){
 
-                prev_found = false;
-                curr_unitig = p.first.toString();
-            }
-            else if (((nb_prev_succ == 0) && (nb_curr_pred == 0))) curr_unitig.push_back(str_seq[p.second + k_ - 1]);
-            else {
+                    if ((v(i, flag_v) & RESERVED_ID) != 0){ //This minimizer has abundant k-mers
 
-                add_graph_function(curr_unitig);
+                        typename h_kmers_ccov_t::const_iterator it_km = h_kmers_ccov.find(km_rep);
 
-                curr_unitig = p.first.toString();
-            }
+                        if (it_km != h_kmers_ccov.end()){
 
-            nb_prev_succ = nb_curr_succ;
-            nb_prev_pred = nb_curr_pred;
+                            return UnitigMap<U, G>(it_km.getHash(), 0, 1, k_, false, true, km == km_rep, this);
+                        }
+                    }
 
-            ++it_km;
-        }
-        else {
+                    if ((v(i, flag_v) & MASK_CONTIG_TYPE) == MASK_CONTIG_TYPE){ //This minimizer is unitig overcrowded
 
-            if ((p.second == 0) && !cm.isAbundant && !cm.isShort){
+                        if (overcrowded_kmers_indexed) return findOvercrowded(km, false);
 
-                if ((cm.dist != 0) && (cm.dist != cm.size - k_ + 1)){
+                        mhr_tmp = it_min.getNewMin(mhr);
 
-                    const size_t len = cm.len;
+                        if (mhr_tmp.hash != mhr.hash){
 
-                    cm.len = 1;
-                    unmapRead(cm, lck_g);
-                    cm.len = len;
+                            mhr = mhr_tmp;
+                            minz = Minimizer(it_min.s + mhr.pos).rep();
+                            it = hmap_min_unitigs.find(minz);
+                        }
+                    }
                 }
-            }
-            else if ((p.second + cm.len == str_seq_len - k_ + 1) && !cm.isAbundant && !cm.isShort){
+                else {
 
-                cm.dist += cm.len;
+                    isShort = (v(i, flag_v) & MASK_CONTIG_TYPE) != 0;
+                    unitig_id_pos_tmp = v(i, flag_v) & MASK_CONTIG_POS;
 
-                if ((cm.dist != 0) && (cm.dist != cm.size - k_ + 1)){
+                    if (isShort){
 
-                    const size_t len = cm.len;
+                        const Kmer km_unitig = km_unitigs.getKmer(unitig_id);
 
-                    cm.len = 1;
-                    unmapRead(cm, lck_g);
-                    cm.len = len;
-                }
-            }
+                        if (min_h_res.pos == unitig_id_pos_tmp){
 
-            lck_g.release_reader();
+                            if (km_unitig == km_rep){
 
-            it_km += cm.len;
+                                return UnitigMap<U, G>(unitig_id, 0, 1, k_, true, false, true, this);
+                            }
+                        }
+                        else if ((min_h_res.pos == diff - unitig_id_pos_tmp) && (km_unitig == km_rep)){
 
-            if (!prev_found){
+                            return UnitigMap<U, G>(unitig_id, 0, 1, k_, true, false, false, this);
+                        }
+                    }
+                    else {
 
-                add_graph_function(curr_unitig);
+                        pos_match = unitig_id_pos_tmp - min_h_res.pos;
+                        len = v_unitigs[unitig_id]->length() - k_;
 
-                prev_found = true;
+                        if ((pos_match >= 0) && (pos_match <= len) && v_unitigs[unitig_id]->getSeq().compareKmer(pos_match, k_, km)){
+
+                            return UnitigMap<U, G>(unitig_id, pos_match, 1, len + k_, false, false, true, this);
+                        }
+
+                        pos_match = unitig_id_pos_tmp - diff + min_h_res.pos;
+
+                        if ((pos_match >= 0) && (pos_match <= len) && v_unitigs[unitig_id]->getSeq().compareKmer(pos_match, k_, km_twin)){
+
+                            return UnitigMap<U, G>(unitig_id, pos_match, 1, len + k_, false, false, false, this);
+                        }
+                    }
+                }
             }
         }
-    }
 
-    if (!prev_found) add_graph_function(curr_unitig);
+        ++it_it_min;
+    }
 
-    return true;
+    return (sparse_index && isSparseSkipped(Minimizer(it_min.s + it_min.getPosition()), it_min.getHash())) ? findSparse(km, false) : UnitigMap<U, G>();
 }
 
+// pre: Some k-mers in the unitigs might have a coverage which is less than CompressedCoverage::getFullCoverage()
+//      Those k-mers must be deleted from the unitigs.
+// post: All unitigs have a per k-mer coverage of CompressedCoverage::getFullCoverage(). The graph is not
+//       necessarily compacted after calling this function.
 template<typename U, typename G>
-template<bool is_void>
-typename std::enable_if<!is_void, void>::type CompactedDBG<U, G>::deleteUnitig_(const bool isShort, const bool isAbundant,
-                                                                                const size_t id_unitig, const bool delete_data){
-
-    if (isAbundant){
-
-        char km_str[MAX_KMER_SIZE];
-
-        typename h_kmers_ccov_t::iterator it_h = h_kmers_ccov.find(id_unitig);
-
-        const Kmer km = it_h.getKey();
+pair<size_t, size_t> CompactedDBG<U, G>::extractAllUnitigs() {
 
-        km.toString(km_str);
+    size_t i;
+    size_t split = 0, deleted = 0;
+    size_t v_kmers_sz = km_unitigs.size();
+    size_t v_unitigs_sz = v_unitigs.size();
+    size_t nxt_pos_insert = v_unitigs.size();
 
-        minHashIterator<RepHash> it_min(km_str, k_, k_, g_, RepHash(), true), it_min_end;
+	size_t delete1 = 0, delete2 = 0, delete3 = 0;
 
-        if (delete_data) it_h->getData()->clear(UnitigMap<U, G>(id_unitig, 0, 1, k_, isShort, isAbundant, true, this));
+    for (typename h_kmers_ccov_t::iterator it(h_kmers_ccov.begin()); it != h_kmers_ccov.end(); ++it) {
 
-        it_h->ccov.clear();
-        h_kmers_ccov.erase(it_h);
+        if (!it->ccov.isFull()){
 
-        for (int64_t last_pos_min = -1; it_min != it_min_end; ++it_min){ // Iterate over minimizers of unitig to delete
+            deleteUnitig_<is_void<U>::value>(false, true, it.getHash());
+            ++deleted;
+        }
+    }
 
-            if (last_pos_min < it_min.getPosition()){ // If a new minimizer hash is found in unitig to delete
+    for (i = 0; i < v_kmers_sz;) {
 
-                minHashResultIterator<RepHash> it_it_min = *it_min, it_it_min_end;
+        if (!km_unitigs.isFull(i)) {
 
-                while (it_it_min != it_it_min_end){ // Iterate over minimizers of current k-mer in unitig to delete
+            --v_kmers_sz;
 
-                    const minHashResult& min_h_res = *it_it_min;
-                    Minimizer minz_rep = Minimizer(km_str + min_h_res.pos).rep(); // Get canonical minimizer
-                    MinimizerIndex::iterator it_h = hmap_min_unitigs.find(minz_rep);
+            if (i != v_kmers_sz) swapUnitigs(true, i, v_kmers_sz);
 
-                    if (it_h != hmap_min_unitigs.end()){ // If the minimizer is found
+            deleteUnitig_<is_void<U>::value>(true, false, v_kmers_sz);
 
-                        packed_tiny_vector& v = it_h.getVector();
-                        uint8_t& flag_v = it_h.getVectorSize();
+            ++deleted;
+        }
+        else ++i;
+    }
 
-                        const size_t last_pos_v = v.size(flag_v) - 1;
+    for (i = 0; i < v_unitigs_sz;) { // Iterate over unitigs created so far
 
-                        v(last_pos_v, flag_v)--;
+        if (!v_unitigs[i]->getCov().isFull()) { //Coverage not full, unitig must be splitted
 
-                        if (((v(last_pos_v, flag_v) & RESERVED_ID) == 0) && ((v(last_pos_v, flag_v) & MASK_CONTIG_TYPE) != MASK_CONTIG_TYPE)){
+            vector<pair<int,int>> sp = v_unitigs[i]->getCov().splittingVector();
 
-                            if (last_pos_v == 0) hmap_min_unitigs.erase(minz_rep);
-                            else flag_v = v.remove(v.size(flag_v) - 1, flag_v);
-                        }
-                    }
+            if (extractUnitig_<is_void<U>::value>(i, nxt_pos_insert, v_unitigs_sz, v_kmers_sz, sp)) ++deleted;
+            else {
 
-                    last_pos_min = min_h_res.pos;
-                    ++it_it_min;
-                }
+                ++split;
+                sp.clear();
             }
         }
+        else ++i;
     }
-    else {
-
-        bool isForbidden = false;
 
-        size_t pos_id_unitig = id_unitig << 32;
-        const size_t mask = MASK_CONTIG_ID | MASK_CONTIG_TYPE;
-
-        string str;
+    if (nxt_pos_insert < v_unitigs.size()) v_unitigs.resize(nxt_pos_insert);
+    if (v_kmers_sz < km_unitigs.size()) km_unitigs.resize(v_kmers_sz);
 
-        if (isShort){
+    return {split, deleted};
+}
 
-            str = km_unitigs.getKmer(id_unitig).toString();
-            pos_id_unitig |= MASK_CONTIG_TYPE;
-        }
-        else str = v_unitigs[id_unitig]->getSeq().toString();
+// pre: Some k-mers in the unitigs might have a coverage which is less than CompressedCoverage::getFullCoverage().
+//      Unitigs must be split at the positions matching those low-coverage k-mers (not deleted).
+// post: All unitigs have a per k-mer coverage of CompressedCoverage::getFullCoverage(). The graph is not
+//       necessarily compacted after calling this function.
+template<typename U, typename G>
+pair<size_t, size_t> CompactedDBG<U, G>::splitAllUnitigs() {
 
-        const char* s = str.c_str();
+    pair<size_t, size_t> p = {0, 0};
 
-        const size_t len = str.size();
+    size_t v_kmers_sz = km_unitigs.size();
+    size_t v_unitigs_sz = v_unitigs.size();
+    size_t nxt_pos_insert = v_unitigs.size();
 
-        minHashIterator<RepHash> it_min(s, len, k_, g_, RepHash(), true), it_min_end;
-        minHashResult mhr, mhr_tmp;
+    const size_t cov_full = CompressedCoverage::getFullCoverage();
 
-        // The unitig is deleted but its space in the unitig vector is not because:
-        // 1 - It would change indices in the minimizer hash table
-        if (isShort){
+    for (size_t i = 0; i < v_unitigs_sz;) { // Iterate over unitigs created so far
 
-            if (delete_data) km_unitigs.getData(id_unitig)->clear(UnitigMap<U, G>(id_unitig, 0, 1, len, isShort, isAbundant, true, this));
+        const CompressedCoverage& ccov = v_unitigs[i]->getCov();
 
-            Kmer empty_km;
+        if (!ccov.isFull()) { //Coverage not full, unitig must be splitted
 
-            empty_km.set_deleted();
+            size_t prev_split_pos = 0;
 
-            km_unitigs.set(id_unitig, empty_km, 0);
-        }
-        else {
+            vector<pair<int,int>> sp;
 
-            if (delete_data) v_unitigs[id_unitig]->getData()->clear(UnitigMap<U, G>(id_unitig, 0, len - k_ + 1, len, isShort, isAbundant, true, this));
+            for (size_t pos = 0; pos < ccov.size(); ++pos){
 
-            delete v_unitigs[id_unitig];
-            v_unitigs[id_unitig] = nullptr;
-        }
+                if ((ccov.covAt(pos) != cov_full) && (pos != prev_split_pos)){
 
-        for (int64_t last_pos_min = -1; it_min != it_min_end; ++it_min){ // Iterate over minimizers of unitig to delete
+                    sp.push_back({prev_split_pos, pos});
+                    ++(p.second);
 
-            if ((last_pos_min < it_min.getPosition()) || isForbidden){ // If a new minimizer hash is found in unitig to delete
+                    prev_split_pos = pos;
+                }
+            }
 
-                minHashResultIterator<RepHash> it_it_min = *it_min, it_it_min_end;
-                isForbidden = false;
+            sp.push_back({prev_split_pos, ccov.size()});
 
-                while (it_it_min != it_it_min_end){ // Iterate over minimizers of current k-mer in unitig to delete
+            ++(p.second);
+            ++(p.first);
 
-                    const minHashResult& min_h_res = *it_it_min;
-                    Minimizer minz_rep = Minimizer(s + min_h_res.pos).rep(); // Get canonical minimizer
-                    MinimizerIndex::iterator it_h = hmap_min_unitigs.find(minz_rep);
+            extractUnitig_<is_void<U>::value>(i, nxt_pos_insert, v_unitigs_sz, v_kmers_sz, sp);
+        }
+        else ++i;
+    }
 
-                    mhr = min_h_res;
+    if (nxt_pos_insert < v_unitigs.size()) v_unitigs.resize(nxt_pos_insert);
+    if (v_kmers_sz < km_unitigs.size()) km_unitigs.resize(v_kmers_sz);
 
-                    while (it_h != hmap_min_unitigs.end()){ // If the minimizer is found
+    return p;
+}
 
-                        packed_tiny_vector& v = it_h.getVector();
-                        uint8_t& flag_v = it_h.getVectorSize();
-                        size_t i = 0, v_sz = v.size(flag_v);
+template<typename U, typename G>
+pair<size_t, size_t> CompactedDBG<U, G>::getSplitInfoAllUnitigs() const {
 
-                        while (i < v_sz){
+    pair<size_t, size_t> p = {0, 0};
 
-                            if ((v(i, flag_v) & mask) == pos_id_unitig){
+    const size_t cov_full = CompressedCoverage::getFullCoverage();
 
-                                flag_v = v.remove(i, flag_v);
-                                --v_sz;
-                            }
-                            else ++i;
-                        }
+    for (size_t i = 0; i < v_unitigs.size(); ++i) { // Iterate over unitigs created so far
 
-                        it_h = hmap_min_unitigs.end();
+        const CompressedCoverage& ccov = v_unitigs[i]->getCov();
 
-                        if (v.size(flag_v) == 0) hmap_min_unitigs.erase(minz_rep);
-                        else if (!isShort && ((v(v_sz-1, flag_v) & mask) == mask)){ //Minimizer bin is overcrowded
+        if (!ccov.isFull()) { //Coverage not full, unitig must be splitted
 
+            size_t prev_split_pos = 0;
 
-                            mhr_tmp = it_min.getNewMin(mhr); //Recompute a new (different) minimizer for current k-mer
-                            isForbidden = true;
+            for (size_t pos = 0; pos < ccov.size(); ++pos){
 
-                            if (mhr_tmp.hash != mhr.hash){
+                if ((ccov.covAt(pos) != cov_full) && (pos != prev_split_pos)){
 
-                                mhr = mhr_tmp;
-                                minz_rep = Minimizer(s + mhr.pos).rep();
-                                it_h = hmap_min_unitigs.find(minz_rep);
-                            }
-                            else break;
-                        }
-                    }
+                    ++(p.second);
 
-                    last_pos_min = min_h_res.pos;
-                    ++it_it_min;
+                    prev_split_pos = pos;
                 }
             }
+
+            ++(p.first);
+            ++(p.second);
         }
     }
+
+    return p;
 }
 
 template<typename U, typename G>
-template<bool is_void>
-typename std::enable_if<is_void, void>::type CompactedDBG<U, G>::deleteUnitig_( const bool isShort, const bool isAbundant,
-                                                                                const size_t id_unitig, const bool delete_data){
-
-    if (isAbundant){
-
-        char km_str[MAX_KMER_SIZE];
-
-        typename h_kmers_ccov_t::iterator it_h = h_kmers_ccov.find(id_unitig);
-
-        const Kmer km = it_h.getKey();
-
-        km.toString(km_str);
-
-        minHashIterator<RepHash> it_min(km_str, k_, k_, g_, RepHash(), true), it_min_end;
+void CompactedDBG<U, G>::createJoinHT(vector<Kmer>* v_joins, KmerHashTable<Kmer>& joins, const size_t nb_threads) const {
 
-        it_h->ccov.clear();
-        h_kmers_ccov.erase(it_h);
+    const size_t v_unitigs_size = v_unitigs.size();
+    const size_t v_kmers_size = km_unitigs.size();
+    const size_t chunk = 1024;
 
-        for (int64_t last_pos_min = -1; it_min != it_min_end; ++it_min){ // Iterate over minimizers of unitig to delete
+    if (v_joins == nullptr){
 
-            if (last_pos_min < it_min.getPosition()){ // If a new minimizer hash is found in unitig to delete
+        if (nb_threads == 1){
 
-                minHashResultIterator<RepHash> it_it_min = *it_min, it_it_min_end;
+            for (typename h_kmers_ccov_t::const_iterator it_ccov(h_kmers_ccov.begin()); it_ccov != h_kmers_ccov.end(); ++it_ccov) {
 
-                while (it_it_min != it_it_min_end){ // Iterate over minimizers of current k-mer in unitig to delete
+                const Kmer tail(it_ccov.getKey());
+                const Kmer head_twin(tail.twin());
 
-                    const minHashResult& min_h_res = *it_it_min;
-                    Minimizer minz_rep = Minimizer(km_str + min_h_res.pos).rep(); // Get canonical minimizer
-                    MinimizerIndex::iterator it_h = hmap_min_unitigs.find(minz_rep);
+                Kmer fw, bw;
 
-                    if (it_h != hmap_min_unitigs.end()){ // If the minimizer is found
+                const const_UnitigMap<U, G> cm(it_ccov.getHash(), 0, 1, k_, false, true, true, this);
 
-                        packed_tiny_vector& v = it_h.getVector();
-                        uint8_t& flag_v = it_h.getVectorSize();
+                if ((joins.find(tail) == joins.end()) && checkJoin(tail, cm, fw)) joins.insert(fw.twin(), tail);
+                if ((joins.find(head_twin) == joins.end()) && checkJoin(head_twin, cm, bw)) joins.insert(bw.twin(), head_twin);
+            }
 
-                        const size_t last_pos_v = v.size(flag_v) - 1;
+            for (size_t i = 0; i != v_kmers_size; ++i) {
 
-                        v(last_pos_v, flag_v)--;
+                const Kmer tail = km_unitigs.getKmer(i);
+                const Kmer head_twin = tail.twin();
 
-                        if (((v(last_pos_v, flag_v) & RESERVED_ID) == 0) && ((v(last_pos_v, flag_v) & MASK_CONTIG_TYPE) != MASK_CONTIG_TYPE)){
+                Kmer fw, bw;
 
-                            if (last_pos_v == 0) hmap_min_unitigs.erase(minz_rep);
-                            else flag_v = v.remove(v.size(flag_v) - 1, flag_v);
-                        }
-                    }
+                const const_UnitigMap<U, G> cm(i, 0, 1, k_, true, false, true, this);
 
-                    last_pos_min = min_h_res.pos;
-                    ++it_it_min;
-                }
+                if ((joins.find(tail) == joins.end()) && checkJoin(tail, cm, fw)) joins.insert(fw.twin(), tail);
+                if ((joins.find(head_twin) == joins.end()) && checkJoin(head_twin, cm, bw)) joins.insert(bw.twin(), head_twin);
             }
-        }
-    }
-    else {
 
-        bool isForbidden = false;
+            for (size_t i = 0; i != v_unitigs_size; ++i) {
 
-        size_t pos_id_unitig = id_unitig << 32;
-        const size_t mask = MASK_CONTIG_ID | MASK_CONTIG_TYPE;
+                const CompressedSequence& seq = v_unitigs[i]->getSeq();
+
+                const Kmer head_twin(seq.getKmer(0).twin());
+                const Kmer tail(seq.getKmer(seq.size() - k_));
 
-        string str;
+                Kmer fw, bw;
 
-        if (isShort){
+                const const_UnitigMap<U, G> cm(i, 0, 1, seq.size(), false, false, true, this);
 
-            str = km_unitigs.getKmer(id_unitig).toString();
-            pos_id_unitig |= MASK_CONTIG_TYPE;
+                if ((joins.find(tail) == joins.end()) && checkJoin(tail, cm, fw)) joins.insert(fw.twin(), tail);
+                if ((joins.find(head_twin) == joins.end()) && checkJoin(head_twin, cm, bw)) joins.insert(bw.twin(), head_twin);
+            }
         }
-        else str = v_unitigs[id_unitig]->getSeq().toString();
+        else {
 
-        const char* s = str.c_str();
+            //Hybrid_SpinLockRW_MCS<> lck(nb_threads);
+            SpinLockRW lck;
 
-        const size_t len = str.size();
+            auto worker_v_abundant = [chunk, &joins, &lck, this](typename h_kmers_ccov_t::const_iterator* l_it_ccov){
 
-        minHashIterator<RepHash> it_min(s, len, k_, g_, RepHash(), true), it_min_end;
-        minHashResult mhr, mhr_tmp;
+                typename h_kmers_ccov_t::const_iterator& it_ccov = *l_it_ccov;
 
-        // The unitig is deleted but its space in the unitig vector is not because:
-        // 1 - It would change indices in the minimizer hash table
-        if (isShort){
+                // We need to deal with the tail of long unitigs
+                for (size_t i = 0; (it_ccov != h_kmers_ccov.end()) && (i < chunk); ++i, ++it_ccov) {
 
-            Kmer empty_km;
+                    const Kmer tail(it_ccov.getKey());
+                    const Kmer head_twin(tail.twin());
 
-            empty_km.set_deleted();
-            km_unitigs.set(id_unitig, empty_km, 0);
-        }
-        else {
+                    Kmer fw, bw;
 
-            delete v_unitigs[id_unitig];
-            v_unitigs[id_unitig] = nullptr;
-        }
+                    const const_UnitigMap<U, G> cm(it_ccov.getHash(), 0, 1, k_, false, true, true, this);
 
-        for (int64_t last_pos_min = -1; it_min != it_min_end; ++it_min){ // Iterate over minimizers of unitig to delete
+                    lck.acquire_reader();
 
-            if ((last_pos_min < it_min.getPosition()) || isForbidden){ // If a new minimizer hash is found in unitig to delete
+                    const bool joins_tail = (joins.find(tail) == joins.end());
+                    const bool joins_head = (joins.find(head_twin) == joins.end());
 
-                minHashResultIterator<RepHash> it_it_min = *it_min, it_it_min_end;
-                isForbidden = false;
+                    lck.release_reader();
 
-                while (it_it_min != it_it_min_end){ // Iterate over minimizers of current k-mer in unitig to delete
+                    if (joins_tail && checkJoin(tail, cm, fw)){
 
-                    const minHashResult& min_h_res = *it_it_min;
-                    Minimizer minz_rep = Minimizer(s + min_h_res.pos).rep(); // Get canonical minimizer
-                    MinimizerIndex::iterator it_h = hmap_min_unitigs.find(minz_rep);
+                        lck.acquire_writer();
+                        joins.insert(fw.twin(), tail);
+                        lck.release_writer();
+                    }
 
-                    mhr = min_h_res;
+                    if (joins_head && checkJoin(head_twin, cm, bw)){
 
-                    while (it_h != hmap_min_unitigs.end()){ // If the minimizer is found
+                        lck.acquire_writer();
+                        joins.insert(bw.twin(), head_twin);
+                        lck.release_writer();
+                    }
+                }
+            };
 
-                        packed_tiny_vector& v = it_h.getVector();
-                        uint8_t& flag_v = it_h.getVectorSize();
-                        size_t i = 0, v_sz = v.size(flag_v);
+            auto worker_v_kmers = [&joins, &lck, this](const size_t idx_a, const size_t idx_b){
 
-                        while (i < v_sz){
+                for (size_t i = idx_a; i != idx_b; ++i) {
 
-                            if ((v(i, flag_v) & mask) == pos_id_unitig){
+                    Kmer fw, bw;
 
-                                flag_v = v.remove(i, flag_v);
-                                --v_sz;
-                            }
-                            else ++i;
-                        }
+                    const Kmer tail = km_unitigs.getKmer(i);
+                    const Kmer head_twin = tail.twin();
 
-                        it_h = hmap_min_unitigs.end();
+                    const const_UnitigMap<U, G> cm(i, 0, 1, k_, true, false, true, this);
 
-                        if (v.size(flag_v) == 0) hmap_min_unitigs.erase(minz_rep);
-                        else if (!isShort && ((v(v_sz-1, flag_v) & mask) == mask)){ //Minimizer bin is overcrowded
+                    lck.acquire_reader();
 
+                    const bool joins_tail = (joins.find(tail) == joins.end());
+                    const bool joins_head = (joins.find(head_twin) == joins.end());
 
-                            mhr_tmp = it_min.getNewMin(mhr); //Recompute a new (different) minimizer for current k-mer
-                            isForbidden = true;
+                    lck.release_reader();
 
-                            if (mhr_tmp.hash != mhr.hash){
+                    if (joins_tail && checkJoin(tail, cm, fw)){
 
-                                mhr = mhr_tmp;
-                                minz_rep = Minimizer(s + mhr.pos).rep();
-                                it_h = hmap_min_unitigs.find(minz_rep);
-                            }
-                            else break;
-                        }
+                        lck.acquire_writer();
+                        joins.insert(fw.twin(), tail);
+                        lck.release_writer();
                     }
 
-                    last_pos_min = min_h_res.pos;
-                    ++it_it_min;
-                }
-            }
-        }
-    }
-}
-
-template<typename U, typename G>
-void CompactedDBG<U, G>::deleteUnitig_(const bool isShort, const bool isAbundant, const size_t id_unitig, const string& str){
+                    if (joins_head && checkJoin(head_twin, cm, bw)){
 
-    const char* s = str.c_str();
-    const size_t len = str.size();
+                        lck.acquire_writer();
+                        joins.insert(bw.twin(), head_twin);
+                        lck.release_writer();
+                    }
+                }
+            };
 
-    if (isAbundant){
+            auto worker_v_unitigs = [&joins, &lck, this](   typename vector<Unitig<U>*>::const_iterator a,
+                                                            typename vector<Unitig<U>*>::const_iterator b){
 
-        minHashIterator<RepHash> it_min(s, k_, k_, g_, RepHash(), true), it_min_end;
+                for (size_t i = a - v_unitigs.begin(), end = b - v_unitigs.begin(); i != end; ++i) {
 
-        for (int64_t last_pos_min = -1; it_min != it_min_end; ++it_min){ // Iterate over minimizers of unitig to delete
+                    const CompressedSequence& seq = v_unitigs[i]->getSeq();
 
-            if (last_pos_min < it_min.getPosition()){ // If a new minimizer hash is found in unitig to delete
+                    const const_UnitigMap<U, G> cm(i, 0, 1, seq.size(), false, false, true, this);
 
-                minHashResultIterator<RepHash> it_it_min = *it_min, it_it_min_end;
+                    const Kmer head_twin(seq.getKmer(0).twin());
+                    const Kmer tail(seq.getKmer(seq.size() - k_));
 
-                while (it_it_min != it_it_min_end){ // Iterate over minimizers of current k-mer in unitig to delete
+                    Kmer fw, bw;
 
-                    const minHashResult& min_h_res = *it_it_min;
-                    Minimizer minz_rep = Minimizer(s + min_h_res.pos).rep(); // Get canonical minimizer
-                    MinimizerIndex::iterator it_h = hmap_min_unitigs.find(minz_rep);
+                    lck.acquire_reader();
 
-                    if (it_h != hmap_min_unitigs.end()){ // If the minimizer is found
+                    const bool joins_tail = (joins.find(tail) == joins.end());
+                    const bool joins_head = (joins.find(head_twin) == joins.end());
 
-                        packed_tiny_vector& v = it_h.getVector();
-                        uint8_t& flag_v = it_h.getVectorSize();
+                    lck.release_reader();
 
-                        const size_t last_pos_v = v.size(flag_v) - 1;
+                    if (joins_tail && checkJoin(tail, cm, fw)){
 
-                        v(last_pos_v, flag_v)--;
+                        lck.acquire_writer();
+                        joins.insert(fw.twin(), tail);
+                        lck.release_writer();
+                    }
 
-                        if (((v(last_pos_v, flag_v) & RESERVED_ID) == 0) && ((v(last_pos_v, flag_v) & MASK_CONTIG_TYPE) != MASK_CONTIG_TYPE)){
+                    if (joins_head && checkJoin(head_twin, cm, bw)){
 
-                            if (last_pos_v == 0) hmap_min_unitigs.erase(it_h);
-                            else flag_v = v.remove(v.size(flag_v) - 1, flag_v);
-                        }
+                        lck.acquire_writer();
+                        joins.insert(bw.twin(), head_twin);
+                        lck.release_writer();
                     }
-
-                    last_pos_min = min_h_res.pos;
-                    ++it_it_min;
                 }
-            }
-        }
-    }
-    else {
-
-        bool isForbidden = false;
+            };
 
-        size_t pos_id_unitig = id_unitig << 32;
-        const size_t mask = MASK_CONTIG_ID | MASK_CONTIG_TYPE;
+            {
+                typename h_kmers_ccov_t::const_iterator it = h_kmers_ccov.begin(), it_end = h_kmers_ccov.end();
 
-        if (isShort) pos_id_unitig |= MASK_CONTIG_TYPE;
+                vector<thread> workers; // need to keep track of threads so we can join them
 
-        minHashIterator<RepHash> it_min(s, len, k_, g_, RepHash(), true), it_min_end;
-        minHashResult mhr, mhr_tmp;
+                mutex mutex_it;
 
-        for (int64_t last_pos_min = -1; it_min != it_min_end; ++it_min){ // Iterate over minimizers of unitig to delete
+                for (size_t t = 0; t < nb_threads; ++t){
 
-            if ((last_pos_min < it_min.getPosition()) || isForbidden){ // If a new minimizer hash is found in unitig to delete
+                    workers.emplace_back(
 
-                minHashResultIterator<RepHash> it_it_min = *it_min, it_it_min_end;
-                isForbidden = false;
+                        [&]{
 
-                while (it_it_min != it_it_min_end){ // Iterate over minimizers of current k-mer in unitig to delete
+                            typename h_kmers_ccov_t::const_iterator l_it;
 
-                    const minHashResult& min_h_res = *it_it_min;
-                    Minimizer minz_rep = Minimizer(s + min_h_res.pos).rep(); // Get canonical minimizer
-                    MinimizerIndex::iterator it_h = hmap_min_unitigs.find(minz_rep);
+                            bool stop;
 
-                    mhr = min_h_res;
+                            while (true) {
 
-                    while (it_h != hmap_min_unitigs.end()){ // If the minimizer is found
+                                {
+                                    unique_lock<mutex> lock(mutex_it);
 
-                        packed_tiny_vector& v = it_h.getVector();
-                        uint8_t& flag_v = it_h.getVectorSize();
-                        size_t i = 0, v_sz = v.size(flag_v);
+                                    l_it = it;
 
-                        while (i < v_sz){
+                                    for (size_t i = 0; (it != it_end) && (i < chunk); ++i, ++it){}
 
-                            if ((v(i, flag_v) & mask) == pos_id_unitig){
+                                    stop = (l_it == it_end) && (it == it_end);
+                                }
 
-                                flag_v = v.remove(i, flag_v);
-                                --v_sz;
+                                if (!stop) worker_v_abundant(&l_it);
+                                else return;
                             }
-                            else ++i;
                         }
+                    );
+                }
 
-                        if (v.size(flag_v) == 0) it_h = hmap_min_unitigs.end();
-                        else if (!isShort && ((v(v_sz-1, flag_v) & mask) == mask)){ //Minimizer bin is overcrowded
+                for (auto& t : workers) t.join();
+            }
 
-                            mhr_tmp = it_min.getNewMin(mhr); //Recompute a new (different) minimizer for current k-mer
-                            isForbidden = true;
+            {
 
-                            if (mhr_tmp.hash != mhr.hash){
+                size_t it_km = 0, it_km_end = km_unitigs.size();
 
-                                mhr = mhr_tmp;
-                                minz_rep = Minimizer(s + mhr.pos).rep();
-                                it_h = hmap_min_unitigs.find(minz_rep);
-                            }
-                            else {
+                vector<thread> workers; // need to keep track of threads so we can join them
 
-                                it_h = hmap_min_unitigs.end();
-                                break;
-                            }
-                        }
-                        else it_h = hmap_min_unitigs.end();
-                    }
+                mutex mutex_it_km;
 
-                    last_pos_min = min_h_res.pos;
-                    ++it_it_min;
-                }
-            }
-        }
-    }
-}
+                for (size_t t = 0; t < nb_threads; ++t){
 
-template<typename U, typename G>
-template<bool is_void>
-typename std::enable_if<!is_void, bool>::type CompactedDBG<U, G>::extractUnitig_(size_t& pos_v_unitigs, size_t& nxt_pos_insert_v_unitigs,
-                                                                               size_t& v_unitigs_sz, size_t& v_kmers_sz, const vector<pair<int,int>>& sp){
+                    workers.emplace_back(
 
-    bool deleted = true;
+                        [&]{
 
-    if (!sp.empty()){
+                            size_t l_it_km, l_it_km_end;
 
-        const Unitig<U>* unitig = v_unitigs[pos_v_unitigs];
+                            while (true) {
+
+                                {
+                                    unique_lock<mutex> lock(mutex_it_km);
+
+                                    if (it_km == it_km_end) return;
+
+                                    l_it_km = it_km;
+                                    it_km = min(it_km + chunk, it_km_end);
+                                    l_it_km_end = it_km;
+                                }
+
+                                worker_v_kmers(l_it_km, l_it_km_end);
+                            }
+                        }
+                    );
+                }
 
-        //const pair<size_t, size_t> lowpair = unitig->ccov.lowCoverageInfo();
+                for (auto& t : workers) t.join();
+            }
 
-        //const size_t totalcoverage = unitig->coveragesum - lowpair.second;
-        //const size_t ccov_size = unitig->ccov.size();
+            {
+                auto it_unitig = v_unitigs.begin();
+                auto it_unitig_end = v_unitigs.end();
 
-        const string str = unitig->getSeq().toString();
+                vector<thread> workers; // need to keep track of threads so we can join them
 
-        size_t i = 0;
+                mutex mutex_it_unitig;
 
-        UnitigMap<U, G> um(pos_v_unitigs, 0, 0, unitig->length(), false, false, true, this);
+                for (size_t t = 0; t < nb_threads; ++t){
 
-        vector<Unitig<U>> v_data(sp.size());
+                    workers.emplace_back(
 
-        deleted = false;
+                        [&]{
 
-        for (vector<pair<int,int>>::const_iterator sit = sp.begin(); sit != sp.end(); ++sit, ++i) { //Iterate over created split unitigs
+                            auto l_it_unitig = v_unitigs.begin();
+                            auto l_it_unitig_end = v_unitigs.end();
 
-            um.dist = sit->first;
-            um.len = sit->second - um.dist;
+                            while (true) {
 
-            if (um.len == 1){
+                                {
+                                    unique_lock<mutex> lock(mutex_it_unitig);
 
-                const string split_str = str.substr(um.dist, um.len + k_ - 1);
+                                    if (it_unitig == it_unitig_end) return;
 
-                um.strand = (split_str <= reverse_complement(split_str));
-            }
-            else um.strand = true;
+                                    l_it_unitig = it_unitig;
+                                    l_it_unitig_end = it_unitig;
 
-            v_data[i] = std::move(um.splitData(sit+1 == sp.end()));
-        }
+                                    if (distance(l_it_unitig, it_unitig_end) >= chunk){
 
-        i = 0;
+                                        advance(l_it_unitig_end, chunk);
 
-        for (vector<pair<int,int>>::const_iterator sit = sp.begin(); sit != sp.end(); ++sit, ++i) { //Iterate over created split unitigs
+                                        it_unitig = l_it_unitig_end;
+                                    }
+                                    else {
 
-            const size_t len = sit->second - sit->first;
-            //const uint64_t cov_tmp = (totalcoverage * len) / (ccov_size - lowpair.first); // Split unitig coverage
-            const uint64_t cov_tmp = len * CompressedCoverage::getFullCoverage();
+                                        it_unitig = it_unitig_end;
+                                        l_it_unitig_end = it_unitig_end;
+                                    }
+                                }
 
-            string split_str = str.substr(sit->first, len + k_ - 1); // Split unitig sequence
+                                worker_v_unitigs(l_it_unitig, l_it_unitig_end);
+                            }
+                        }
+                    );
+                }
 
-            if (len == 1){
+                for (auto& t : workers) t.join();
+            }
+        }
+    }
+    else {
 
-                const string split_str_rev = reverse_complement(split_str);
+        Kmer fw;
 
-                if (split_str > split_str_rev) split_str = split_str_rev;
+        for (auto km : *v_joins){
 
-                if (addUnitig(split_str, v_kmers_sz)){
+            const const_UnitigMap<U, G> cm = find(km, true);
 
-                    CompressedCoverage_t<U>& cc_t = *h_kmers_ccov.find(Kmer(split_str.c_str()).rep());
+            if (!cm.isEmpty){
 
-                    cc_t.ccov.setFull();
+                if (!cm.isShort && !cm.isAbundant){
 
-                    *(cc_t.getData()) = std::move(*(v_data[i].getData()));
+                    if ((cm.dist == 0 && cm.strand) || (cm.dist != 0 && !cm.strand)) km = km.twin();
+                    if (checkJoin(km, cm, fw)) joins.insert(fw.twin(), km);
                 }
                 else {
 
-                    km_unitigs.setFull(v_kmers_sz); // We don't care about the coverage per k-mer anymore
+                    if (checkJoin(km, cm, fw)) joins.insert(fw.twin(), km);
 
-                    *(km_unitigs.getData(v_kmers_sz)) = std::move(*(v_data[i].getData()));
+                    km = km.twin();
 
-                    ++v_kmers_sz;
+                    if (checkJoin(km, cm, fw)) joins.insert(fw.twin(), km);
                 }
             }
-            else {
-
-                addUnitig(split_str, nxt_pos_insert_v_unitigs);
-
-                //v_unitigs[nxt_pos_insert_v_unitigs]->initializeCoverage(true); //We don't care about the coverage per k-mer anymore
-                v_unitigs[nxt_pos_insert_v_unitigs]->getCov() = CompressedCoverage(v_unitigs[nxt_pos_insert_v_unitigs]->getSeq().size() - k_ + 1, true);
-                //v_unitigs[nxt_pos_insert_v_unitigs]->coveragesum = cov_tmp;
-
-                *(v_unitigs[nxt_pos_insert_v_unitigs]->getData()) = std::move(*(v_data[i].getData()));
-
-                ++nxt_pos_insert_v_unitigs;
-            }
         }
     }
+}
 
-    --nxt_pos_insert_v_unitigs; //Position of the last unitig in the vector which is not NULL
+template<typename U, typename G>
+void CompactedDBG<U, G>::createJoinHT(vector<Kmer>* v_joins, KmerHashTable<char>& joins, const size_t nb_threads) const {
 
-    if (pos_v_unitigs != nxt_pos_insert_v_unitigs){ // Do not proceed to swap if swap positions are the same
+    const size_t v_unitigs_size = v_unitigs.size();
+    const size_t v_kmers_size = km_unitigs.size();
 
-        swapUnitigs(false, pos_v_unitigs, nxt_pos_insert_v_unitigs); // Swap unitigs
+    const size_t chunk = 1024;
 
-        // If the swapped unitig, previously in position nxt_pos_insert, was a split unitig
-        // created in this method, do not try to split it again
-        if (nxt_pos_insert_v_unitigs >= v_unitigs_sz) ++pos_v_unitigs;
-        else --v_unitigs_sz;
-    }
-    else --v_unitigs_sz;
+    if (v_joins == nullptr){
 
-    deleteUnitig_<false>(false, false, nxt_pos_insert_v_unitigs);
+        if (nb_threads == 1){
 
-    return deleted;
-}
+            for (typename h_kmers_ccov_t::const_iterator it_ccov(h_kmers_ccov.begin()); it_ccov != h_kmers_ccov.end(); ++it_ccov) {
 
-template<typename U, typename G>
-template<bool is_void>
-typename std::enable_if<is_void, bool>::type CompactedDBG<U, G>::extractUnitig_(size_t& pos_v_unitigs, size_t& nxt_pos_insert_v_unitigs,
-                                                                              size_t& v_unitigs_sz, size_t& v_kmers_sz, const vector<pair<int,int>>& sp){
+                const Kmer tail(it_ccov.getKey());
+                const Kmer head_twin(tail.twin());
 
-    bool deleted = true;
+                Kmer fw, bw;
 
-    if (!sp.empty()){
+                const const_UnitigMap<U, G> cm(it_ccov.getHash(), 0, 1, k_, false, true, true, this);
 
-        const Unitig<U>* unitig = v_unitigs[pos_v_unitigs];
+                if ((joins.find(tail) == joins.end()) && checkJoin(tail, cm, fw)) joins.insert(fw.twin(), tail.getChar(0));
+                if ((joins.find(head_twin) == joins.end()) && checkJoin(head_twin, cm, bw)) joins.insert(bw.twin(), head_twin.getChar(0));
+            }
 
-        //const pair<size_t, size_t> lowpair = unitig->ccov.lowCoverageInfo();
+            for (size_t i = 0; i != v_kmers_size; ++i) {
 
-        //const size_t totalcoverage = unitig->coveragesum - lowpair.second;
-        //const size_t ccov_size = unitig->ccov.size();
+                const Kmer tail = km_unitigs.getKmer(i);
+                const Kmer head_twin = tail.twin();
 
-        const string str = unitig->getSeq().toString();
+                Kmer fw, bw;
 
-        deleted = false;
+                const const_UnitigMap<U, G> cm(i, 0, 1, k_, true, false, true, this);
 
-        for (vector<pair<int,int>>::const_iterator sit = sp.begin(); sit != sp.end(); ++sit) { //Iterate over created split unitigs
+                if ((joins.find(tail) == joins.end()) && checkJoin(tail, cm, fw)) joins.insert(fw.twin(), tail.getChar(0));
+                if ((joins.find(head_twin) == joins.end()) && checkJoin(head_twin, cm, bw)) joins.insert(bw.twin(), head_twin.getChar(0));
+            }
 
-            const size_t len = sit->second - sit->first;
-            //const uint64_t cov_tmp = (totalcoverage * len) / (ccov_size - lowpair.first); // Split unitig coverage
-            const uint64_t cov_tmp = len * CompressedCoverage::getFullCoverage();
-            const string split_str = str.substr(sit->first, len + k_ - 1); // Split unitig sequence
+            for (size_t i = 0; i != v_unitigs_size; ++i) {
 
-            if (len == 1){
+                const CompressedSequence& seq = v_unitigs[i]->getSeq();
 
-                if (addUnitig(split_str, v_kmers_sz, pos_v_unitigs, false)) h_kmers_ccov.find(Kmer(split_str.c_str()).rep())->ccov.setFull();
-                else km_unitigs.setFull(v_kmers_sz++); // We don't care about the coverage per k-mer anymore}
-            }
-            else {
+                const Kmer head_twin(seq.getKmer(0).twin());
+                const Kmer tail(seq.getKmer(seq.size() - k_));
 
-                addUnitig(split_str, nxt_pos_insert_v_unitigs, pos_v_unitigs, false);
+                Kmer fw, bw;
 
-                //v_unitigs[nxt_pos_insert_v_unitigs]->initializeCoverage(true); //We don't care about the coverage per k-mer anymore
-                v_unitigs[nxt_pos_insert_v_unitigs]->getCov() = CompressedCoverage(v_unitigs[nxt_pos_insert_v_unitigs]->getSeq().size() - k_ + 1, true);
-                //v_unitigs[nxt_pos_insert_v_unitigs]->coveragesum = cov_tmp;
+                const const_UnitigMap<U, G> cm(i, 0, 1, seq.size(), false, false, true, this);
 
-                ++nxt_pos_insert_v_unitigs;
+                if ((joins.find(tail) == joins.end()) && checkJoin(tail, cm, fw)) joins.insert(fw.twin(), tail.getChar(0));
+                if ((joins.find(head_twin) == joins.end()) && checkJoin(head_twin, cm, bw)) joins.insert(bw.twin(), head_twin.getChar(0));
             }
         }
-    }
+        else {
 
-    --nxt_pos_insert_v_unitigs; //Position of the last unitig in the vector which is not NULL
+            //Hybrid_SpinLockRW_MCS<> lck(nb_threads);
+            SpinLockRW lck;
 
-    if (pos_v_unitigs != nxt_pos_insert_v_unitigs){ // Do not proceed to swap if swap positions are the same
+            auto worker_v_abundant = [chunk, &joins, &lck, this](typename h_kmers_ccov_t::const_iterator* l_it_ccov){
 
-        swapUnitigs(false, pos_v_unitigs, nxt_pos_insert_v_unitigs); // Swap unitigs
+                typename h_kmers_ccov_t::const_iterator& it_ccov = *l_it_ccov;
 
-        // If the swapped unitig, previously in position nxt_pos_insert, was a split unitig
-        // created in this method, do not try to split it again
-        if (nxt_pos_insert_v_unitigs >= v_unitigs_sz) ++pos_v_unitigs;
-        else --v_unitigs_sz;
-    }
-    else --v_unitigs_sz;
+                // We need to deal with the tail of long unitigs
+                for (size_t i = 0; (it_ccov != h_kmers_ccov.end()) && (i < chunk); ++i, ++it_ccov) {
 
-    deleteUnitig_<true>(false, false, nxt_pos_insert_v_unitigs);
+                    const Kmer tail(it_ccov.getKey());
+                    const Kmer head_twin(tail.twin());
 
-    return deleted;
-}
+                    Kmer fw, bw;
 
-template<typename U, typename G>
-UnitigMap<U, G> CompactedDBG<U, G>::find(const Kmer& km, const preAllocMinHashIterator<RepHash>& it_min_h) {
+                    const const_UnitigMap<U, G> cm(it_ccov.getHash(), 0, 1, k_, false, true, true, this);
 
-    const Kmer km_twin = km.twin();
-    const Kmer& km_rep = km < km_twin ? km : km_twin;
+                    lck.acquire_reader();
 
-    bool isShort;
+                    const bool joins_tail = (joins.find(tail) == joins.end());
+                    const bool joins_head = (joins.find(head_twin) == joins.end());
 
-    size_t unitig_id, unitig_id_pos_tmp, len;
+                    lck.release_reader();
 
-    int64_t pos_match;
+                    if (joins_tail && checkJoin(tail, cm, fw)){
 
-    const int diff = k_ - g_;
+                        lck.acquire_writer();
+                        joins.insert(fw.twin(), tail.getChar(0));
+                        lck.release_writer();
+                    }
 
-    preAllocMinHashIterator<RepHash> it_min(it_min_h, k_);
-    preAllocMinHashResultIterator<RepHash> it_it_min = *it_min, it_it_min_end;
+                    if (joins_head && checkJoin(head_twin, cm, bw)){
 
-    minHashResult mhr, mhr_tmp;
+                        lck.acquire_writer();
+                        joins.insert(bw.twin(), head_twin.getChar(0));
+                        lck.release_writer();
+                    }
+                }
+            };
 
-    while (it_it_min != it_it_min_end){
+            auto worker_v_kmers = [&joins, &lck, this](const size_t idx_a, const size_t idx_b){
 
-        const minHashResult& min_h_res = *it_it_min;
-        Minimizer minz = Minimizer(it_min.s + min_h_res.pos).rep();
-        MinimizerIndex::const_iterator it = hmap_min_unitigs.find(minz);
+                for (size_t i = idx_a; i != idx_b; ++i) {
 
-        mhr = min_h_res;
+                    Kmer fw, bw;
 
-        while (it != hmap_min_unitigs.end()){ // If the minimizer is found
+                    const Kmer tail = km_unitigs.getKmer(i);
+                    const Kmer head_twin = tail.twin();
 
-            const packed_tiny_vector& v = it.getVector();
-            const uint8_t flag_v = it.getVectorSize();
-            const int v_sz = v.size(flag_v);
+                    const const_UnitigMap<U, G> cm(i, 0, 1, k_, true, false, true, this);
+
+                    lck.acquire_reader();
+
+                    const bool joins_tail = (joins.find(tail) == joins.end());
+                    const bool joins_head = (joins.find(head_twin) == joins.end());
+
+                    lck.release_reader();
+
+                    if (joins_tail && checkJoin(tail, cm, fw)){
+
+                        lck.acquire_writer();
+                        joins.insert(fw.twin(), tail.getChar(0));
+                        lck.release_writer();
+                    }
+
+                    if (joins_head && checkJoin(head_twin, cm, bw)){
+
+                        lck.acquire_writer();
+                        joins.insert(bw.twin(), head_twin.getChar(0));
+                        lck.release_writer();
+                    }
+                }
+            };
+
+            auto worker_v_unitigs = [&joins, &lck, this](   typename vector<Unitig<U>*>::const_iterator a,
+                                                            typename vector<Unitig<U>*>::const_iterator b){
 
-            it = hmap_min_unitigs.end();
+                for (size_t i = a - v_unitigs.begin(), end = b - v_unitigs.begin(); i != end; ++i) {
 
-            for (size_t i = 0; i < v_sz; ++i){
+                    const CompressedSequence& seq = v_unitigs[i]->getSeq();
 
-                unitig_id = v(i, flag_v) >> 32;
+                    const const_UnitigMap<U, G> cm(i, 0, 1, seq.size(), false, false, true, this);
 
-                if (unitig_id == RESERVED_ID){
+                    const Kmer head_twin(seq.getKmer(0).twin());
+                    const Kmer tail(seq.getKmer(seq.size() - k_));
 
-                    if ((v(i, flag_v) & RESERVED_ID) != 0){ //This minimizer has abundant k-mers
+                    Kmer fw, bw;
 
-                        typename h_kmers_ccov_t::const_iterator it_km = h_kmers_ccov.find(km_rep);
+                    lck.acquire_reader();
 
-                        if (it_km != h_kmers_ccov.end()){
+                    const bool joins_tail = (joins.find(tail) == joins.end());
+                    const bool joins_head = (joins.find(head_twin) == joins.end());
 
-                            return UnitigMap<U, G>(it_km.getHash(), 0, 1, k_, false, true, km == km_rep, this);
-                        }
-                    }
+                    lck.release_reader();
 
-                    if ((v(i, flag_v) & MASK_CONTIG_TYPE) == MASK_CONTIG_TYPE){ //This minimizer is unitig overcrowded
+                    if (joins_tail && checkJoin(tail, cm, fw)){
 
-                        mhr_tmp = it_min.getNewMin(mhr);
+                        lck.acquire_writer();
+                        joins.insert(fw.twin(), tail.getChar(0));
+                        lck.release_writer();
+                    }
 
-                        if (mhr_tmp.hash != mhr.hash){
+                    if (joins_head && checkJoin(head_twin, cm, bw)){
 
-                            mhr = mhr_tmp;
-                            minz = Minimizer(it_min.s + mhr.pos).rep();
-                            it = hmap_min_unitigs.find(minz);
-                        }
+                        lck.acquire_writer();
+                        joins.insert(bw.twin(), head_twin.getChar(0));
+                        lck.release_writer();
                     }
                 }
-                else {
+            };
 
-                    isShort = (v(i, flag_v) & MASK_CONTIG_TYPE) != 0;
-                    unitig_id_pos_tmp = v(i, flag_v) & MASK_CONTIG_POS;
+            {
+                typename h_kmers_ccov_t::const_iterator it = h_kmers_ccov.begin(), it_end = h_kmers_ccov.end();
 
-                    if (isShort){
+                vector<thread> workers; // need to keep track of threads so we can join them
 
-                        const Kmer km_unitig = km_unitigs.getKmer(unitig_id);
+                mutex mutex_it;
 
-                        if (min_h_res.pos == unitig_id_pos_tmp){
+                for (size_t t = 0; t < nb_threads; ++t){
 
-                            if (km_unitig == km_rep){
+                    workers.emplace_back(
 
-                                return UnitigMap<U, G>(unitig_id, 0, 1, k_, true, false, true, this);
-                            }
-                        }
-                        else if ((min_h_res.pos == diff - unitig_id_pos_tmp) && (km_unitig == km_rep)){
+                        [&]{
 
-                            return UnitigMap<U, G>(unitig_id, 0, 1, k_, true, false, false, this);
-                        }
-                    }
-                    else {
+                            typename h_kmers_ccov_t::const_iterator l_it;
 
-                        pos_match = unitig_id_pos_tmp - min_h_res.pos;
-                        len = v_unitigs[unitig_id]->length() - k_;
+                            bool stop;
 
-                        if ((pos_match >= 0) && (pos_match <= len) && v_unitigs[unitig_id]->getSeq().compareKmer(pos_match, k_, km)){
+                            while (true) {
 
-                            return UnitigMap<U, G>(unitig_id, pos_match, 1, len + k_, false, false, true, this);
-                        }
+                                {
+                                    unique_lock<mutex> lock(mutex_it);
 
-                        pos_match = unitig_id_pos_tmp - diff + min_h_res.pos;
+                                    l_it = it;
 
-                        if ((pos_match >= 0) && (pos_match <= len) && v_unitigs[unitig_id]->getSeq().compareKmer(pos_match, k_, km_twin)){
+                                    for (size_t i = 0; (it != it_end) && (i < chunk); ++i, ++it){}
 
-                            return UnitigMap<U, G>(unitig_id, pos_match, 1, len + k_, false, false, false, this);
+                                    stop = (l_it == it_end) && (it == it_end);
+                                }
+
+                                if (!stop) worker_v_abundant(&l_it);
+                                else return;
+                            }
                         }
-                    }
+                    );
                 }
-            }
-        }
-
-        ++it_it_min;
-    }
-
-    return UnitigMap<U, G>();
-}
-
-// pre: Some k-mers in the unitigs might have a coverage which is less than CompressedCoverage::getFullCoverage()
-//      Those k-mers must be deleted from the unitigs.
-// post: All unitigs have a per k-mer coverage of CompressedCoverage::getFullCoverage(). The graph is not
-//       necessarily compacted after calling this function.
-template<typename U, typename G>
-pair<size_t, size_t> CompactedDBG<U, G>::extractAllUnitigs() {
-
-    size_t i;
-    size_t split = 0, deleted = 0;
-    size_t v_kmers_sz = km_unitigs.size();
-    size_t v_unitigs_sz = v_unitigs.size();
-    size_t nxt_pos_insert = v_unitigs.size();
 
-	size_t delete1 = 0, delete2 = 0, delete3 = 0;
+                for (auto& t : workers) t.join();
+            }
 
-    for (typename h_kmers_ccov_t::iterator it(h_kmers_ccov.begin()); it != h_kmers_ccov.end(); ++it) {
+            {
 
-        if (!it->ccov.isFull()){
+                size_t it_km = 0, it_km_end = km_unitigs.size();
 
-            deleteUnitig_<is_void<U>::value>(false, true, it.getHash());
-            ++deleted;
-        }
-    }
+                vector<thread> workers; // need to keep track of threads so we can join them
 
-    for (i = 0; i < v_kmers_sz;) {
+                mutex mutex_it_km;
 
-        if (!km_unitigs.isFull(i)) {
+                for (size_t t = 0; t < nb_threads; ++t){
 
-            --v_kmers_sz;
+                    workers.emplace_back(
 
-            if (i != v_kmers_sz) swapUnitigs(true, i, v_kmers_sz);
+                        [&]{
 
-            deleteUnitig_<is_void<U>::value>(true, false, v_kmers_sz);
+                            size_t l_it_km, l_it_km_end;
 
-            ++deleted;
-        }
-        else ++i;
-    }
+                            while (true) {
 
-    for (i = 0; i < v_unitigs_sz;) { // Iterate over unitigs created so far
+                                {
+                                    unique_lock<mutex> lock(mutex_it_km);
 
-        if (!v_unitigs[i]->getCov().isFull()) { //Coverage not full, unitig must be splitted
+                                    if (it_km == it_km_end) return;
 
-            vector<pair<int,int>> sp = v_unitigs[i]->getCov().splittingVector();
+                                    l_it_km = it_km;
+                                    it_km = min(it_km + chunk, it_km_end);
+                                    l_it_km_end = it_km;
+                                }
 
-            if (extractUnitig_<is_void<U>::value>(i, nxt_pos_insert, v_unitigs_sz, v_kmers_sz, sp)) ++deleted;
-            else {
+                                worker_v_kmers(l_it_km, l_it_km_end);
+                            }
+                        }
+                    );
+                }
 
-                ++split;
-                sp.clear();
+                for (auto& t : workers) t.join();
             }
-        }
-        else ++i;
-    }
-
-    if (nxt_pos_insert < v_unitigs.size()) v_unitigs.resize(nxt_pos_insert);
-    if (v_kmers_sz < km_unitigs.size()) km_unitigs.resize(v_kmers_sz);
 
-    return {split, deleted};
-}
+            {
+                auto it_unitig = v_unitigs.begin();
+                auto it_unitig_end = v_unitigs.end();
 
-// pre: Some k-mers in the unitigs might have a coverage which is less than CompressedCoverage::getFullCoverage().
-//      Unitigs must be split at the positions matching those low-coverage k-mers (not deleted).
-// post: All unitigs have a per k-mer coverage of CompressedCoverage::getFullCoverage(). The graph is not
-//       necessarily compacted after calling this function.
-template<typename U, typename G>
-pair<size_t, size_t> CompactedDBG<U, G>::splitAllUnitigs() {
+                vector<thread> workers; // need to keep track of threads so we can join them
 
-    pair<size_t, size_t> p = {0, 0};
+                mutex mutex_it_unitig;
 
-    size_t v_kmers_sz = km_unitigs.size();
-    size_t v_unitigs_sz = v_unitigs.size();
-    size_t nxt_pos_insert = v_unitigs.size();
+                for (size_t t = 0; t < nb_threads; ++t){
 
-    const size_t cov_full = CompressedCoverage::getFullCoverage();
+                    workers.emplace_back(
 
-    for (size_t i = 0; i < v_unitigs_sz;) { // Iterate over unitigs created so far
+                        [&]{
 
-        const CompressedCoverage& ccov = v_unitigs[i]->getCov();
+                            auto l_it_unitig = v_unitigs.begin();
+                            auto l_it_unitig_end = v_unitigs.end();
 
-        if (!ccov.isFull()) { //Coverage not full, unitig must be splitted
+                            while (true) {
 
-            size_t prev_split_pos = 0;
+                                {
+                                    unique_lock<mutex> lock(mutex_it_unitig);
 
-            vector<pair<int,int>> sp;
+                                    if (it_unitig == it_unitig_end) return;
 
-            for (size_t pos = 0; pos < ccov.size(); ++pos){
+                                    l_it_unitig = it_unitig;
+                                    l_it_unitig_end = it_unitig;
 
-                if ((ccov.covAt(pos) != cov_full) && (pos != prev_split_pos)){
+                                    if (distance(l_it_unitig, it_unitig_end) >= chunk){
 
-                    sp.push_back({prev_split_pos, pos});
-                    ++(p.second);
+                                        advance(l_it_unitig_end, chunk);
 
-                    prev_split_pos = pos;
-                }
-            }
+                                        it_unitig = l_it_unitig_end;
+                                    }
+                                    else {
 
-            sp.push_back({prev_split_pos, ccov.size()});
+                                        it_unitig = it_unitig_end;
+                                        l_it_unitig_end = it_unitig_end;
+                                    }
+                                }
 
-            ++(p.second);
-            ++(p.first);
+                                worker_v_unitigs(l_it_unitig, l_it_unitig_end);
+                            }
+                        }
+                    );
+                }
 
-            extractUnitig_<is_void<U>::value>(i, nxt_pos_insert, v_unitigs_sz, v_kmers_sz, sp);
+                for (auto& t : workers) t.join();
+            }
         }
-        else ++i;
     }
+    else {
 
-    if (nxt_pos_insert < v_unitigs.size()) v_unitigs.resize(nxt_pos_insert);
-    if (v_kmers_sz < km_unitigs.size()) km_unitigs.resize(v_kmers_sz);
-
-    return p;
-}
-
-template<typename U, typename G>
-pair<size_t, size_t> CompactedDBG<U, G>::getSplitInfoAllUnitigs() const {
-
-    pair<size_t, size_t> p = {0, 0};
-
-    const size_t cov_full = CompressedCoverage::getFullCoverage();
+        Kmer fw;
 
-    for (size_t i = 0; i < v_unitigs.size(); ++i) { // Iterate over unitigs created so far
+        for (auto km : *v_joins){
 
-        const CompressedCoverage& ccov = v_unitigs[i]->getCov();
+            const const_UnitigMap<U, G> cm = find(km, true);
 
-        if (!ccov.isFull()) { //Coverage not full, unitig must be splitted
+            if (!cm.isEmpty){
 
-            size_t prev_split_pos = 0;
+                if (!cm.isShort && !cm.isAbundant){
 
-            for (size_t pos = 0; pos < ccov.size(); ++pos){
+                    if ((cm.dist == 0 && cm.strand) || (cm.dist != 0 && !cm.strand)) km = km.twin();
+                    if (checkJoin(km, cm, fw)) joins.insert(fw.twin(), km.getChar(0));
+                }
+                else {
 
-                if ((ccov.covAt(pos) != cov_full) && (pos != prev_split_pos)){
+                    if (checkJoin(km, cm, fw)) joins.insert(fw.twin(), km.getChar(0));
 
-                    ++(p.second);
+                    km = km.twin();
 
-                    prev_split_pos = pos;
+                    if (checkJoin(km, cm, fw)) joins.insert(fw.twin(), km.getChar(0));
                 }
-            }
-
-            ++(p.first);
-            ++(p.second);
+            }
         }
     }
-
-    return p;
 }
 
+// use:  joined = mapper.joinUnitigs()
+// pre:  no short unitigs exist in sUnitigs.
+// post: all unitigs that could be connected have been connected
+//       joined is the number of joined unitigs
 template<typename U, typename G>
-void CompactedDBG<U, G>::createJoinHT(vector<Kmer>* v_joins, KmerHashTable<Kmer>& joins, const size_t nb_threads) const {
-
-    const size_t v_unitigs_size = v_unitigs.size();
-    const size_t v_kmers_size = km_unitigs.size();
-    const size_t chunk = 1024;
-
-    if (v_joins == nullptr){
-
-        if (nb_threads == 1){
+template<bool is_void>
+typename std::enable_if<!is_void, size_t>::type CompactedDBG<U, G>::joinUnitigs_(vector<Kmer>* v_joins, const size_t nb_threads) {
 
-            for (typename h_kmers_ccov_t::const_iterator it_ccov(h_kmers_ccov.begin()); it_ccov != h_kmers_ccov.end(); ++it_ccov) {
+    size_t joined = 0;
+    size_t cov_full = CompressedCoverage::getFullCoverage();
+    size_t v_unitigs_size = v_unitigs.size();
+    size_t v_kmers_size = km_unitigs.size();
 
-                const Kmer tail(it_ccov.getKey());
-                const Kmer head_twin(tail.twin());
+    // a and b are candidates for joining
+    /*KmerHashTable<Kmer> joins;
 
-                Kmer fw, bw;
+    createJoinHT(v_joins, joins, nb_threads);
 
-                const const_UnitigMap<U, G> cm(it_ccov.getHash(), 0, 1, k_, false, true, true, this);
+    if (v_joins != nullptr) v_joins->clear();
 
-                if ((joins.find(tail) == joins.end()) && checkJoin(tail, cm, fw)) joins.insert(fw.twin(), tail);
-                if ((joins.find(head_twin) == joins.end()) && checkJoin(head_twin, cm, bw)) joins.insert(bw.twin(), head_twin);
-            }
+    for (KmerHashTable<Kmer>::iterator it(joins.begin()); it != joins.end(); ++it) {
 
-            for (size_t i = 0; i != v_kmers_size; ++i) {
+        const Kmer head(*it);
+        const Kmer tail(it.getKey().twin());*/
 
-                const Kmer tail = km_unitigs.getKmer(i);
-                const Kmer head_twin = tail.twin();
+    //-------------------------------------------------------------------------------
+    KmerHashTable<char> joins;
 
-                Kmer fw, bw;
+    createJoinHT(v_joins, joins, nb_threads);
 
-                const const_UnitigMap<U, G> cm(i, 0, 1, k_, true, false, true, this);
+    if (v_joins != nullptr) v_joins->clear();
 
-                if ((joins.find(tail) == joins.end()) && checkJoin(tail, cm, fw)) joins.insert(fw.twin(), tail);
-                if ((joins.find(head_twin) == joins.end()) && checkJoin(head_twin, cm, bw)) joins.insert(bw.twin(), head_twin);
-            }
+    for (KmerHashTable<char>::iterator it(joins.begin()); it != joins.end(); ++it) {
 
-            for (size_t i = 0; i != v_unitigs_size; ++i) {
+        const Kmer tail(it.getKey().twin());
+        const Kmer head(tail.backwardBase(*it));
+    //-------------------------------------------------------------------------------
 
-                const CompressedSequence& seq = v_unitigs[i]->getSeq();
+        UnitigMap<U, G> cmHead(find(head, true));
+        UnitigMap<U, G> cmTail(find(tail, true));
 
-                const Kmer head_twin(seq.getKmer(0).twin());
-                const Kmer tail(seq.getKmer(seq.size() - k_));
+        if (!cmHead.isEmpty && !cmTail.isEmpty) {
 
-                Kmer fw, bw;
+            Kmer cmHead_head, cmTail_head;
 
-                const const_UnitigMap<U, G> cm(i, 0, 1, seq.size(), false, false, true, this);
+            if (cmHead.isShort) cmHead_head = km_unitigs.getKmer(cmHead.pos_unitig);
+            else if (cmHead.isAbundant) cmHead_head = h_kmers_ccov.find(cmHead.pos_unitig).getKey();
+            else cmHead_head = v_unitigs[cmHead.pos_unitig]->getSeq().getKmer(0);
 
-                if ((joins.find(tail) == joins.end()) && checkJoin(tail, cm, fw)) joins.insert(fw.twin(), tail);
-                if ((joins.find(head_twin) == joins.end()) && checkJoin(head_twin, cm, bw)) joins.insert(bw.twin(), head_twin);
-            }
-        }
-        else {
+            if (cmTail.isShort) cmTail_head = km_unitigs.getKmer(cmTail.pos_unitig);
+            else if (cmTail.isAbundant) cmTail_head = h_kmers_ccov.find(cmTail.pos_unitig).getKey();
+            else cmTail_head = v_unitigs[cmTail.pos_unitig]->getSeq().getKmer(0);
 
-            //Hybrid_SpinLockRW_MCS<> lck(nb_threads);
-            SpinLockRW lck;
+            if (cmHead_head != cmTail_head) { // can't join a sequence with itself, either hairPin, loop or mobius loop
 
-            auto worker_v_abundant = [chunk, &joins, &lck, this](typename h_kmers_ccov_t::const_iterator* l_it_ccov){
+                // both kmers are still end-kmers
+                bool headDir;
+                bool len_k_head = cmHead.isShort || cmHead.isAbundant;
 
-                typename h_kmers_ccov_t::const_iterator& it_ccov = *l_it_ccov;
+                if (len_k_head && (head == cmHead_head)) headDir = true;
+                else if (!len_k_head && (head == v_unitigs[cmHead.pos_unitig]->getSeq().getKmer(v_unitigs[cmHead.pos_unitig]->numKmers()-1))) headDir = true;
+                else if (head.twin() == cmHead_head) headDir = false;
+                else continue;
 
-                // We need to deal with the tail of long unitigs
-                for (size_t i = 0; (it_ccov != h_kmers_ccov.end()) && (i < chunk); ++i, ++it_ccov) {
+                bool tailDir;
+                bool len_k_tail = cmTail.isShort || cmTail.isAbundant;
 
-                    const Kmer tail(it_ccov.getKey());
-                    const Kmer head_twin(tail.twin());
+                if (tail == cmTail_head) tailDir = true;
+                else if (len_k_tail){
+                    if (tail.twin() == cmTail_head) tailDir = false;
+                    else continue;
+                }
+                else if (tail.twin() == v_unitigs[cmTail.pos_unitig]->getSeq().getKmer(v_unitigs[cmTail.pos_unitig]->numKmers()-1)) tailDir = false;
+                else continue;
 
-                    Kmer fw, bw;
+                //Compute join sequence
+                string joinSeq;
 
-                    const const_UnitigMap<U, G> cm(it_ccov.getHash(), 0, 1, k_, false, true, true, this);
+                joinSeq.reserve((len_k_head ? k_ : cmHead.size) + (len_k_tail ? k_ : cmTail.size) - k_ + 1);
 
-                    lck.acquire_reader();
+                if (headDir) joinSeq = len_k_head ? cmHead_head.toString() : v_unitigs[cmHead.pos_unitig]->getSeq().toString();
+                else joinSeq = len_k_head ? cmHead_head.twin().toString() : v_unitigs[cmHead.pos_unitig]->getSeq().rev().toString();
 
-                    const bool joins_tail = (joins.find(tail) == joins.end());
-                    const bool joins_head = (joins.find(head_twin) == joins.end());
+                if (tailDir) joinSeq.append(len_k_tail ? cmTail_head.toString() : v_unitigs[cmTail.pos_unitig]->getSeq().toString(), k_ - 1, string::npos);
+                else joinSeq.append(len_k_tail ? cmTail_head.twin().toString() : v_unitigs[cmTail.pos_unitig]->getSeq().rev().toString(), k_ - 1, string::npos);
 
-                    lck.release_reader();
+                //Compute new coverage
+                /*uint64_t covsum;
 
-                    if (joins_tail && checkJoin(tail, cm, fw)){
+                if (len_k_head){
 
-                        lck.acquire_writer();
-                        joins.insert(fw.twin(), tail);
-                        lck.release_writer();
-                    }
+                    CompressedCoverage& ccov = cmHead.isShort ? v_kmers[cmHead.pos_unitig].second.ccov : h_kmers_ccov.find(cmHead.pos_unitig)->ccov;
+                    covsum = ccov.covAt(0);
+                }
+                else covsum = v_unitigs[cmHead.pos_unitig]->coveragesum;
 
-                    if (joins_head && checkJoin(head_twin, cm, bw)){
+                if (len_k_tail){
 
-                        lck.acquire_writer();
-                        joins.insert(bw.twin(), head_twin);
-                        lck.release_writer();
-                    }
+                    CompressedCoverage& ccov = cmTail.isShort ? v_kmers[cmTail.pos_unitig].second.ccov : h_kmers_ccov.find(cmTail.pos_unitig)->ccov;
+                    covsum += ccov.covAt(0);
                 }
-            };
+                else covsum += v_unitigs[cmTail.pos_unitig]->coveragesum;*/
 
-            auto worker_v_kmers = [&joins, &lck, this](const size_t idx_a, const size_t idx_b){
+                Unitig<U> data_tmp; //Store temporarily the new merged data
+                Unitig<U>* unitig; //New unitig
 
-                for (size_t i = idx_a; i != idx_b; ++i) {
+                cmHead.strand = headDir;
+                cmHead.dist = 0;
+                cmHead.len = cmHead.size - k_ + 1;
 
-                    Kmer fw, bw;
+                cmTail.strand = tailDir;
+                cmTail.dist = 0;
+                cmTail.len = cmTail.size - k_ + 1;
 
-                    const Kmer tail = km_unitigs.getKmer(i);
-                    const Kmer head_twin = tail.twin();
+                data_tmp.getData()->concat(cmHead, cmTail);
 
-                    const const_UnitigMap<U, G> cm(i, 0, 1, k_, true, false, true, this);
+                cmHead.getData()->clear(cmHead);
+                cmTail.getData()->clear(cmTail);
 
-                    lck.acquire_reader();
+                if (cmHead.isShort || cmHead.isAbundant){
 
-                    const bool joins_tail = (joins.find(tail) == joins.end());
-                    const bool joins_head = (joins.find(head_twin) == joins.end());
+                    if (cmHead.isShort){ //If head is a short unitig, swap and delete it
 
-                    lck.release_reader();
+                        --v_kmers_size;
 
-                    if (joins_tail && checkJoin(tail, cm, fw)){
+                        if (cmHead.pos_unitig != v_kmers_size){
 
-                        lck.acquire_writer();
-                        joins.insert(fw.twin(), tail);
-                        lck.release_writer();
-                    }
+                            swapUnitigs(true, cmHead.pos_unitig, v_kmers_size);
 
-                    if (joins_head && checkJoin(head_twin, cm, bw)){
+                            // If the last unitig of the vector used for the swap was the tail
+                            if (cmTail.isShort && (v_kmers_size == cmTail.pos_unitig)) cmTail.pos_unitig = cmHead.pos_unitig;
+                        }
 
-                        lck.acquire_writer();
-                        joins.insert(bw.twin(), head_twin);
-                        lck.release_writer();
+                        deleteUnitig_<false>(true, false, v_kmers_size);
                     }
+                    else if (cmHead.isAbundant) deleteUnitig_<false>(false, true, cmHead.pos_unitig);
                 }
-            };
 
-            auto worker_v_unitigs = [&joins, &lck, this](   typename vector<Unitig<U>*>::const_iterator a,
-                                                            typename vector<Unitig<U>*>::const_iterator b){
+                if (cmTail.isShort || cmTail.isAbundant){
 
-                for (size_t i = a - v_unitigs.begin(), end = b - v_unitigs.begin(); i != end; ++i) {
+                    if (cmTail.isShort){ //If tail is a short unitig, swap and delete it
 
-                    const CompressedSequence& seq = v_unitigs[i]->getSeq();
+                        --v_kmers_size;
 
-                    const const_UnitigMap<U, G> cm(i, 0, 1, seq.size(), false, false, true, this);
+                        if (cmTail.pos_unitig != v_kmers_size){
 
-                    const Kmer head_twin(seq.getKmer(0).twin());
-                    const Kmer tail(seq.getKmer(seq.size() - k_));
+                            swapUnitigs(true, cmTail.pos_unitig, v_kmers_size);
 
-                    Kmer fw, bw;
+                            if (cmHead.isShort && (v_kmers_size == cmHead.pos_unitig)) cmHead.pos_unitig = cmTail.pos_unitig;
+                        }
 
-                    lck.acquire_reader();
+                        deleteUnitig_<false>(true, false, v_kmers_size);
+                    }
+                    else if (cmTail.isAbundant) deleteUnitig_<false>(false, true, cmTail.pos_unitig);
+                }
 
-                    const bool joins_tail = (joins.find(tail) == joins.end());
-                    const bool joins_head = (joins.find(head_twin) == joins.end());
+                if (len_k_head && len_k_tail){
 
-                    lck.release_reader();
+                    addUnitig(joinSeq, v_unitigs_size);
+                    unitig = v_unitigs[v_unitigs_size];
+                    ++v_unitigs_size;
+                }
+                else if (len_k_head){
 
-                    if (joins_tail && checkJoin(tail, cm, fw)){
+                    deleteUnitig_<false>(false, false, cmTail.pos_unitig);
+                    addUnitig(joinSeq, cmTail.pos_unitig);
+                    unitig = v_unitigs[cmTail.pos_unitig];
+                }
+                else {
 
-                        lck.acquire_writer();
-                        joins.insert(fw.twin(), tail);
-                        lck.release_writer();
-                    }
+                    if (!len_k_tail){
 
-                    if (joins_head && checkJoin(head_twin, cm, bw)){
+                        --v_unitigs_size;
 
-                        lck.acquire_writer();
-                        joins.insert(bw.twin(), head_twin);
-                        lck.release_writer();
+                        if (cmTail.pos_unitig != v_unitigs_size){
+
+                            swapUnitigs(false, cmTail.pos_unitig, v_unitigs_size);
+
+                            if (v_unitigs_size == cmHead.pos_unitig) cmHead.pos_unitig = cmTail.pos_unitig;
+                        }
+
+                        deleteUnitig_<false>(false, false, v_unitigs_size);
                     }
-                }
-            };
 
-            {
-                typename h_kmers_ccov_t::const_iterator it = h_kmers_ccov.begin(), it_end = h_kmers_ccov.end();
+                    deleteUnitig_<false>(false, false, cmHead.pos_unitig);
+                    addUnitig(joinSeq, cmHead.pos_unitig);
+                    unitig = v_unitigs[cmHead.pos_unitig];
+                }
 
-                vector<thread> workers; // need to keep track of threads so we can join them
+                //unitig->coveragesum = covsum;
+                //if (covsum >= cov_full * unitig->numKmers()) unitig->ccov.setFull();
+                unitig->getCov().setFull();
 
-                mutex mutex_it;
+                *(unitig->getData()) = std::move(*(data_tmp.getData()));
 
-                for (size_t t = 0; t < nb_threads; ++t){
+                ++joined;
+            }
+        }
+    }
 
-                    workers.emplace_back(
+    if (v_unitigs_size < v_unitigs.size()) v_unitigs.resize(v_unitigs_size);
+    if (v_kmers_size < km_unitigs.size()) km_unitigs.resize(v_kmers_size);
 
-                        [&]{
+    return joined;
+}
 
-                            typename h_kmers_ccov_t::const_iterator l_it;
+template<typename U, typename G>
+template<bool is_void>
+typename std::enable_if<is_void, size_t>::type CompactedDBG<U, G>::joinUnitigs_(vector<Kmer>* v_joins, const size_t nb_threads) {
 
-                            bool stop;
+    size_t joined = 0;
+    size_t cov_full = CompressedCoverage::getFullCoverage();
+    size_t v_unitigs_size = v_unitigs.size();
+    size_t v_kmers_size = km_unitigs.size();
 
-                            while (true) {
+    // a and b are candidates for joining
+    /*KmerHashTable<Kmer> joins;
 
-                                {
-                                    unique_lock<mutex> lock(mutex_it);
+    createJoinHT(v_joins, joins, nb_threads);
 
-                                    l_it = it;
+    if (v_joins != nullptr) v_joins->clear();
 
-                                    for (size_t i = 0; (it != it_end) && (i < chunk); ++i, ++it){}
+    for (KmerHashTable<Kmer>::iterator it = joins.begin(); it != joins.end(); ++it) {
 
-                                    stop = (l_it == it_end) && (it == it_end);
-                                }
+        const Kmer head = *it;
+        const Kmer tail = it.getKey().twin();*/
 
-                                if (!stop) worker_v_abundant(&l_it);
-                                else return;
-                            }
-                        }
-                    );
-                }
+    //-------------------------------------------------------------------------------
+    KmerHashTable<char> joins;
 
-                for (auto& t : workers) t.join();
-            }
+    createJoinHT(v_joins, joins, nb_threads);
 
-            {
+    if (v_joins != nullptr) v_joins->clear();
 
-                size_t it_km = 0, it_km_end = km_unitigs.size();
+    for (KmerHashTable<char>::iterator it(joins.begin()); it != joins.end(); ++it) {
 
-                vector<thread> workers; // need to keep track of threads so we can join them
+        const Kmer tail(it.getKey().twin());
+        const Kmer head(tail.backwardBase(*it));
+    //-------------------------------------------------------------------------------
 
-                mutex mutex_it_km;
+        UnitigMap<U, G> cmHead = find(head, true);
+        UnitigMap<U, G> cmTail = find(tail, true);
 
-                for (size_t t = 0; t < nb_threads; ++t){
+        if (!cmHead.isEmpty && !cmTail.isEmpty) {
 
-                    workers.emplace_back(
+            Kmer cmHead_head, cmTail_head;
 
-                        [&]{
+            if (cmHead.isShort) cmHead_head = km_unitigs.getKmer(cmHead.pos_unitig);
+            else if (cmHead.isAbundant) cmHead_head = h_kmers_ccov.find(cmHead.pos_unitig).getKey();
+            else cmHead_head = v_unitigs[cmHead.pos_unitig]->getSeq().getKmer(0);
 
-                            size_t l_it_km, l_it_km_end;
+            if (cmTail.isShort) cmTail_head = km_unitigs.getKmer(cmTail.pos_unitig);
+            else if (cmTail.isAbundant) cmTail_head = h_kmers_ccov.find(cmTail.pos_unitig).getKey();
+            else cmTail_head = v_unitigs[cmTail.pos_unitig]->getSeq().getKmer(0);
 
-                            while (true) {
+            if (cmHead_head != cmTail_head) { // can't join a sequence with itself, either hairPin, loop or mobius loop
 
-                                {
-                                    unique_lock<mutex> lock(mutex_it_km);
+                // both kmers are still end-kmers
+                bool headDir;
+                bool len_k_head = cmHead.isShort || cmHead.isAbundant;
 
-                                    if (it_km == it_km_end) return;
+                if (len_k_head && (head == cmHead_head)) headDir = true;
+                else if (!len_k_head && (head == v_unitigs[cmHead.pos_unitig]->getSeq().getKmer(v_unitigs[cmHead.pos_unitig]->numKmers()-1))) headDir = true;
+                else if (head.twin() == cmHead_head) headDir = false;
+                else continue;
 
-                                    l_it_km = it_km;
-                                    it_km = min(it_km + chunk, it_km_end);
-                                    l_it_km_end = it_km;
-                                }
+                bool tailDir;
+                bool len_k_tail = cmTail.isShort || cmTail.isAbundant;
 
-                                worker_v_kmers(l_it_km, l_it_km_end);
-                            }
-                        }
-                    );
+                if (tail == cmTail_head) tailDir = true;
+                else if (len_k_tail){
+                    if (tail.twin() == cmTail_head) tailDir = false;
+                    else continue;
                 }
+                else if (tail.twin() == v_unitigs[cmTail.pos_unitig]->getSeq().getKmer(v_unitigs[cmTail.pos_unitig]->numKmers()-1)) tailDir = false;
+                else continue;
 
-                for (auto& t : workers) t.join();
-            }
+                //Compute join sequence
+                string joinSeq;
 
-            {
-                auto it_unitig = v_unitigs.begin();
-                auto it_unitig_end = v_unitigs.end();
+                joinSeq.reserve((len_k_head ? k_ : cmHead.size) + (len_k_tail ? k_ : cmTail.size) - k_ + 1);
 
-                vector<thread> workers; // need to keep track of threads so we can join them
+                if (headDir) joinSeq = len_k_head ? cmHead_head.toString() : v_unitigs[cmHead.pos_unitig]->getSeq().toString();
+                else joinSeq = len_k_head ? cmHead_head.twin().toString() : v_unitigs[cmHead.pos_unitig]->getSeq().rev().toString();
 
-                mutex mutex_it_unitig;
+                if (tailDir) joinSeq.append(len_k_tail ? cmTail_head.toString() : v_unitigs[cmTail.pos_unitig]->getSeq().toString(), k_ - 1, string::npos);
+                else joinSeq.append(len_k_tail ? cmTail_head.twin().toString() : v_unitigs[cmTail.pos_unitig]->getSeq().rev().toString(), k_ - 1, string::npos);
 
-                for (size_t t = 0; t < nb_threads; ++t){
+                //Compute new coverage
+                /*uint64_t covsum;
 
-                    workers.emplace_back(
+                if (len_k_head){
 
-                        [&]{
+                    CompressedCoverage& ccov = cmHead.isShort ? v_kmers[cmHead.pos_unitig].second.ccov : h_kmers_ccov.find(cmHead.pos_unitig)->ccov;
+                    covsum = ccov.covAt(0);
+                }
+                else covsum = v_unitigs[cmHead.pos_unitig]->coveragesum;
 
-                            auto l_it_unitig = v_unitigs.begin();
-                            auto l_it_unitig_end = v_unitigs.end();
+                if (len_k_tail){
 
-                            while (true) {
+                    CompressedCoverage& ccov = cmTail.isShort ? v_kmers[cmTail.pos_unitig].second.ccov : h_kmers_ccov.find(cmTail.pos_unitig)->ccov;
+                    covsum += ccov.covAt(0);
+                }
+                else covsum += v_unitigs[cmTail.pos_unitig]->coveragesum;*/
 
-                                {
-                                    unique_lock<mutex> lock(mutex_it_unitig);
+                Unitig<U>* unitig; //New unitig
 
-                                    if (it_unitig == it_unitig_end) return;
+                cmTail.strand = tailDir;
+                cmHead.strand = headDir;
 
-                                    l_it_unitig = it_unitig;
-                                    l_it_unitig_end = it_unitig;
+                if (cmHead.isShort || cmHead.isAbundant){
 
-                                    if (distance(l_it_unitig, it_unitig_end) >= chunk){
+                    if (cmHead.isShort){ //If head is a short unitig, swap and delete it
 
-                                        advance(l_it_unitig_end, chunk);
+                        --v_kmers_size;
 
-                                        it_unitig = l_it_unitig_end;
-                                    }
-                                    else {
+                        if (cmHead.pos_unitig != v_kmers_size){
 
-                                        it_unitig = it_unitig_end;
-                                        l_it_unitig_end = it_unitig_end;
-                                    }
-                                }
+                            swapUnitigs(true, cmHead.pos_unitig, v_kmers_size);
 
-                                worker_v_unitigs(l_it_unitig, l_it_unitig_end);
-                            }
+                            // If the last unitig of the vector used for the swap was the tail
+                            if (cmTail.isShort && (v_kmers_size == cmTail.pos_unitig)) cmTail.pos_unitig = cmHead.pos_unitig;
                         }
-                    );
+
+                        deleteUnitig_<true>(true, false, v_kmers_size);
+                    }
+                    else if (cmHead.isAbundant) deleteUnitig_<true>(false, true, cmHead.pos_unitig);
                 }
 
-                for (auto& t : workers) t.join();
-            }
-        }
-    }
-    else {
+                if (cmTail.isShort || cmTail.isAbundant){
 
-        Kmer fw;
+                    if (cmTail.isShort){ //If tail is a short unitig, swap and delete it
 
-        for (auto km : *v_joins){
+                        --v_kmers_size;
 
-            const const_UnitigMap<U, G> cm = find(km, true);
+                        if (cmTail.pos_unitig != v_kmers_size){
 
-            if (!cm.isEmpty){
+                            swapUnitigs(true, cmTail.pos_unitig, v_kmers_size);
 
-                if (!cm.isShort && !cm.isAbundant){
+                            if (cmHead.isShort && (v_kmers_size == cmHead.pos_unitig)) cmHead.pos_unitig = cmTail.pos_unitig;
+                        }
 
-                    if ((cm.dist == 0 && cm.strand) || (cm.dist != 0 && !cm.strand)) km = km.twin();
-                    if (checkJoin(km, cm, fw)) joins.insert(fw.twin(), km);
+                        deleteUnitig_<true>(true, false, v_kmers_size);
+                    }
+                    else if (cmTail.isAbundant) deleteUnitig_<true>(false, true, cmTail.pos_unitig);
                 }
-                else {
 
-                    if (checkJoin(km, cm, fw)) joins.insert(fw.twin(), km);
-
-                    km = km.twin();
+                if (len_k_head && len_k_tail){
 
-                    if (checkJoin(km, cm, fw)) joins.insert(fw.twin(), km);
+                    addUnitig(joinSeq, v_unitigs_size);
+                    unitig = v_unitigs[v_unitigs_size];
+                    ++v_unitigs_size;
                 }
-            }
-        }
-    }
-}
+                else if (len_k_head){
 
-template<typename U, typename G>
-void CompactedDBG<U, G>::createJoinHT(vector<Kmer>* v_joins, KmerHashTable<char>& joins, const size_t nb_threads) const {
+                    deleteUnitig_<true>(false, false, cmTail.pos_unitig);
+                    addUnitig(joinSeq, cmTail.pos_unitig);
+                    unitig = v_unitigs[cmTail.pos_unitig];
+                }
+                else {
 
-    const size_t v_unitigs_size = v_unitigs.size();
-    const size_t v_kmers_size = km_unitigs.size();
+                    if (!len_k_tail){
 
-    const size_t chunk = 1024;
+                        --v_unitigs_size;
 
-    if (v_joins == nullptr){
+                        if (cmTail.pos_unitig != v_unitigs_size){
 
-        if (nb_threads == 1){
+                            swapUnitigs(false, cmTail.pos_unitig, v_unitigs_size);
 
-            for (typename h_kmers_ccov_t::const_iterator it_ccov(h_kmers_ccov.begin()); it_ccov != h_kmers_ccov.end(); ++it_ccov) {
+                            if (v_unitigs_size == cmHead.pos_unitig) cmHead.pos_unitig = cmTail.pos_unitig;
+                        }
 
-                const Kmer tail(it_ccov.getKey());
-                const Kmer head_twin(tail.twin());
+                        deleteUnitig_<true>(false, false, v_unitigs_size);
+                    }
 
-                Kmer fw, bw;
+                    deleteUnitig_<true>(false, false, cmHead.pos_unitig);
+                    addUnitig(joinSeq, cmHead.pos_unitig);
+                    unitig = v_unitigs[cmHead.pos_unitig];
+                }
 
-                const const_UnitigMap<U, G> cm(it_ccov.getHash(), 0, 1, k_, false, true, true, this);
+                //unitig->coveragesum = covsum;
+                //if (covsum >= cov_full * unitig->numKmers()) unitig->ccov.setFull();
+                unitig->getCov().setFull();
 
-                if ((joins.find(tail) == joins.end()) && checkJoin(tail, cm, fw)) joins.insert(fw.twin(), tail.getChar(0));
-                if ((joins.find(head_twin) == joins.end()) && checkJoin(head_twin, cm, bw)) joins.insert(bw.twin(), head_twin.getChar(0));
+                ++joined;
             }
+        }
+    }
 
-            for (size_t i = 0; i != v_kmers_size; ++i) {
+    if (v_unitigs_size < v_unitigs.size()) v_unitigs.resize(v_unitigs_size);
+    if (v_kmers_size < km_unitigs.size()) km_unitigs.resize(v_kmers_size);
 
-                const Kmer tail = km_unitigs.getKmer(i);
-                const Kmer head_twin = tail.twin();
+    return joined;
+}
 
-                Kmer fw, bw;
+template<typename U, typename G>
+bool CompactedDBG<U, G>::checkJoin(const Kmer& a, const const_UnitigMap<U, G>& cm_a, Kmer& b) const {
 
-                const const_UnitigMap<U, G> cm(i, 0, 1, k_, true, false, true, this);
+    size_t i, j, count_succ;
 
-                if ((joins.find(tail) == joins.end()) && checkJoin(tail, cm, fw)) joins.insert(fw.twin(), tail.getChar(0));
-                if ((joins.find(head_twin) == joins.end()) && checkJoin(head_twin, cm, bw)) joins.insert(bw.twin(), head_twin.getChar(0));
-            }
+    vector<const_UnitigMap<U, G>> v_um(findSuccessors(a, 2, true));
 
-            for (size_t i = 0; i != v_unitigs_size; ++i) {
+    for (i = 0, count_succ = 0; i != 4; ++i){
 
-                const CompressedSequence& seq = v_unitigs[i]->getSeq();
+        if (!v_um[i].isEmpty){
 
-                const Kmer head_twin(seq.getKmer(0).twin());
-                const Kmer tail(seq.getKmer(seq.size() - k_));
+            ++count_succ;
+            j = i;
+        }
+    }
 
-                Kmer fw, bw;
+    if (count_succ == 1) {
 
-                const const_UnitigMap<U, G> cm(i, 0, 1, seq.size(), false, false, true, this);
+        Kmer cand_head, ac_head;
 
-                if ((joins.find(tail) == joins.end()) && checkJoin(tail, cm, fw)) joins.insert(fw.twin(), tail.getChar(0));
-                if ((joins.find(head_twin) == joins.end()) && checkJoin(head_twin, cm, bw)) joins.insert(bw.twin(), head_twin.getChar(0));
-            }
-        }
-        else {
+        const Kmer fw_cand(a.forwardBase(alpha[j]));
+
+        const const_UnitigMap<U, G> cm_cand(v_um[j]);
 
-            //Hybrid_SpinLockRW_MCS<> lck(nb_threads);
-            SpinLockRW lck;
+        if (cm_cand.isShort) cand_head = km_unitigs.getKmer(cm_cand.pos_unitig);
+        else if (cm_cand.isAbundant) cand_head = h_kmers_ccov.find(cm_cand.pos_unitig).getKey();
+        else cand_head = v_unitigs[cm_cand.pos_unitig]->getSeq().getKmer(0);
 
-            auto worker_v_abundant = [chunk, &joins, &lck, this](typename h_kmers_ccov_t::const_iterator* l_it_ccov){
+        if (cm_a.isShort) ac_head = km_unitigs.getKmer(cm_a.pos_unitig);
+        else if (cm_a.isAbundant) ac_head = h_kmers_ccov.find(cm_a.pos_unitig).getKey();
+        else ac_head = v_unitigs[cm_a.pos_unitig]->getSeq().getKmer(0);
 
-                typename h_kmers_ccov_t::const_iterator& it_ccov = *l_it_ccov;
+        if (cand_head != ac_head) {
 
-                // We need to deal with the tail of long unitigs
-                for (size_t i = 0; (it_ccov != h_kmers_ccov.end()) && (i < chunk); ++i, ++it_ccov) {
+            v_um = findSuccessors(fw_cand.twin(), 2, true);
 
-                    const Kmer tail(it_ccov.getKey());
-                    const Kmer head_twin(tail.twin());
+            for (i = 0, count_succ = 0; i != 4; ++i) count_succ += !v_um[i].isEmpty;
 
-                    Kmer fw, bw;
+            if (count_succ == 1) {
 
-                    const const_UnitigMap<U, G> cm(it_ccov.getHash(), 0, 1, k_, false, true, true, this);
+                b = fw_cand;
+                return true;
+            }
+        }
+    }
 
-                    lck.acquire_reader();
+    return false;
+}
 
-                    const bool joins_tail = (joins.find(tail) == joins.end());
-                    const bool joins_head = (joins.find(head_twin) == joins.end());
+template<typename U, typename G>
+void CompactedDBG<U, G>::check_fp_tips(KmerHashTable<bool>& ignored_km_tips){
 
-                    lck.release_reader();
+    uint64_t nb_real_short_tips = 0;
 
-                    if (joins_tail && checkJoin(tail, cm, fw)){
+    size_t nxt_pos_insert_v_unitigs = v_unitigs.size();
+    size_t v_unitigs_sz = v_unitigs.size();
+    size_t v_kmers_sz = km_unitigs.size();
 
-                        lck.acquire_writer();
-                        joins.insert(fw.twin(), tail.getChar(0));
-                        lck.release_writer();
-                    }
+    vector<pair<int,int>> sp;
 
-                    if (joins_head && checkJoin(head_twin, cm, bw)){
+    for (KmerHashTable<bool>::iterator it(ignored_km_tips.begin()); it != ignored_km_tips.end(); ++it) {
 
-                        lck.acquire_writer();
-                        joins.insert(bw.twin(), head_twin.getChar(0));
-                        lck.release_writer();
-                    }
-                }
-            };
+        Kmer km(it.getKey());
 
-            auto worker_v_kmers = [&joins, &lck, this](const size_t idx_a, const size_t idx_b){
+        UnitigMap<U, G> cm(find(km, true)); // Check if the (short) tip actually exists
 
-                for (size_t i = idx_a; i != idx_b; ++i) {
+        if (!cm.isEmpty){ // IF the tip exists
 
-                    Kmer fw, bw;
+            ++nb_real_short_tips;
 
-                    const Kmer tail = km_unitigs.getKmer(i);
-                    const Kmer head_twin = tail.twin();
+            bool not_found = true;
 
-                    const const_UnitigMap<U, G> cm(i, 0, 1, k_, true, false, true, this);
+            for (size_t i = 0; (i < 4) && not_found; ++i) {
 
-                    lck.acquire_reader();
+                UnitigMap<U, G> cm_bw(find(km.backwardBase(alpha[i])));
 
-                    const bool joins_tail = (joins.find(tail) == joins.end());
-                    const bool joins_head = (joins.find(head_twin) == joins.end());
+                if (!cm_bw.isEmpty && !cm_bw.isAbundant && !cm_bw.isShort){
 
-                    lck.release_reader();
+                    //if (cm_bw.strand) ++cm_bw.dist;
+                    cm_bw.dist += cm_bw.strand;
 
-                    if (joins_tail && checkJoin(tail, cm, fw)){
+                    if ((cm_bw.dist != 0) && (cm_bw.dist != cm_bw.size - k_ + 1)){
 
-                        lck.acquire_writer();
-                        joins.insert(fw.twin(), tail.getChar(0));
-                        lck.release_writer();
-                    }
+                        sp.push_back(make_pair(0, cm_bw.dist));
+                        sp.push_back(make_pair(cm_bw.dist, cm_bw.size - k_ + 1));
 
-                    if (joins_head && checkJoin(head_twin, cm, bw)){
+                        extractUnitig_<is_void<U>::value>(cm_bw.pos_unitig, nxt_pos_insert_v_unitigs, v_unitigs_sz, v_kmers_sz, sp);
 
-                        lck.acquire_writer();
-                        joins.insert(bw.twin(), head_twin.getChar(0));
-                        lck.release_writer();
+                        sp.clear();
                     }
+
+                    not_found = false;
                 }
-            };
+            }
 
-            auto worker_v_unitigs = [&joins, &lck, this](   typename vector<Unitig<U>*>::const_iterator a,
-                                                            typename vector<Unitig<U>*>::const_iterator b){
+            for (size_t i = 0; (i < 4) && not_found; ++i) {
 
-                for (size_t i = a - v_unitigs.begin(), end = b - v_unitigs.begin(); i != end; ++i) {
+                UnitigMap<U, G> cm_fw(find(km.forwardBase(alpha[i])));
 
-                    const CompressedSequence& seq = v_unitigs[i]->getSeq();
+                if (!cm_fw.isEmpty && !cm_fw.isAbundant && !cm_fw.isShort){
 
-                    const const_UnitigMap<U, G> cm(i, 0, 1, seq.size(), false, false, true, this);
+                    //if (!cm_fw.strand) ++cm_fw.dist;
+                    cm_fw.dist += !cm_fw.strand;
 
-                    const Kmer head_twin(seq.getKmer(0).twin());
-                    const Kmer tail(seq.getKmer(seq.size() - k_));
+                    if ((cm_fw.dist != 0) && (cm_fw.dist != cm_fw.size - k_ + 1)){
 
-                    Kmer fw, bw;
+                        sp.push_back(make_pair(0, cm_fw.dist));
+                        sp.push_back(make_pair(cm_fw.dist, cm_fw.size - k_ + 1));
 
-                    lck.acquire_reader();
+                        extractUnitig_<is_void<U>::value>(cm_fw.pos_unitig, nxt_pos_insert_v_unitigs, v_unitigs_sz, v_kmers_sz, sp);
 
-                    const bool joins_tail = (joins.find(tail) == joins.end());
-                    const bool joins_head = (joins.find(head_twin) == joins.end());
+                        sp.clear();
+                    }
 
-                    lck.release_reader();
+                    not_found = false;
+                }
+            }
+        }
+    }
 
-                    if (joins_tail && checkJoin(tail, cm, fw)){
+    if (nxt_pos_insert_v_unitigs < v_unitigs.size()) v_unitigs.resize(nxt_pos_insert_v_unitigs);
+    if (v_kmers_sz < km_unitigs.size()) km_unitigs.resize(v_kmers_sz);
+}
 
-                        lck.acquire_writer();
-                        joins.insert(fw.twin(), tail.getChar(0));
-                        lck.release_writer();
-                    }
+template<typename U, typename G>
+size_t CompactedDBG<U, G>::removeUnitigs(bool rmIsolated, bool clipTips, vector<Kmer>& v){
 
-                    if (joins_head && checkJoin(head_twin, cm, bw)){
+    if (!rmIsolated && !clipTips) return 0;
 
-                        lck.acquire_writer();
-                        joins.insert(bw.twin(), head_twin.getChar(0));
-                        lck.release_writer();
-                    }
-                }
-            };
+    const bool rm_and_clip = rmIsolated && clipTips;
 
-            {
-                typename h_kmers_ccov_t::const_iterator it = h_kmers_ccov.begin(), it_end = h_kmers_ccov.end();
+    size_t v_unitigs_sz = v_unitigs.size();
+    size_t v_kmers_sz = km_unitigs.size();
+    size_t removed = 0;
+    size_t i;
 
-                vector<thread> workers; // need to keep track of threads so we can join them
+    int64_t j;
 
-                mutex mutex_it;
+    const int lim = (clipTips ? 1 : 0);
 
-                for (size_t t = 0; t < nb_threads; ++t){
+    int nb_pred, nb_succ;
 
-                    workers.emplace_back(
+    Kmer km;
 
-                        [&]{
+    Unitig<U>* unitig = nullptr;
 
-                            typename h_kmers_ccov_t::const_iterator l_it;
+    for (j = 0; j < v_unitigs_sz; ++j) {
 
-                            bool stop;
+        unitig = v_unitigs[j];
 
-                            while (true) {
+        if (unitig->numKmers() < k_){
 
-                                {
-                                    unique_lock<mutex> lock(mutex_it);
+            const Kmer head(unitig->getSeq().getKmer(0));
 
-                                    l_it = it;
+            nb_pred = 0;
 
-                                    for (size_t i = 0; (it != it_end) && (i < chunk); ++i, ++it){}
+            for (i = 0; (i != 4) && (nb_pred <= lim); ++i) {
 
-                                    stop = (l_it == it_end) && (it == it_end);
-                                }
+                if (!find(head.backwardBase(alpha[i]), true).isEmpty){
 
-                                if (!stop) worker_v_abundant(&l_it);
-                                else return;
-                            }
-                        }
-                    );
+                    ++nb_pred;
+                    if (clipTips) km = head.backwardBase(alpha[i]);
                 }
-
-                for (auto& t : workers) t.join();
             }
 
-            {
-
-                size_t it_km = 0, it_km_end = km_unitigs.size();
-
-                vector<thread> workers; // need to keep track of threads so we can join them
+            if (nb_pred <= lim){
 
-                mutex mutex_it_km;
+                const Kmer tail(unitig->getSeq().getKmer(unitig->length() - k_));
 
-                for (size_t t = 0; t < nb_threads; ++t){
+                nb_succ = 0;
 
-                    workers.emplace_back(
+                for (i = 0; (i != 4) && (nb_succ <= lim); ++i) {
 
-                        [&]{
+                    if (!find(tail.forwardBase(alpha[i]), true).isEmpty){
 
-                            size_t l_it_km, l_it_km_end;
+                        ++nb_succ;
+                        if (clipTips) km = tail.forwardBase(alpha[i]);
+                    }
+                }
 
-                            while (true) {
+                if ((rm_and_clip && ((nb_pred + nb_succ) <= lim)) || (!rm_and_clip && ((nb_pred + nb_succ) == lim))) { //Unitig is isolated
 
-                                {
-                                    unique_lock<mutex> lock(mutex_it_km);
+                    ++removed;
+                    --v_unitigs_sz;
 
-                                    if (it_km == it_km_end) return;
+                    if (j != v_unitigs_sz){
 
-                                    l_it_km = it_km;
-                                    it_km = min(it_km + chunk, it_km_end);
-                                    l_it_km_end = it_km;
-                                }
+                        swapUnitigs(false, j, v_unitigs_sz),
+                        --j;
+                    }
 
-                                worker_v_kmers(l_it_km, l_it_km_end);
-                            }
-                        }
-                    );
+                    if (clipTips && ((nb_pred + nb_succ) == lim)) v.push_back(km);
                 }
-
-                for (auto& t : workers) t.join();
             }
+        }
+    }
 
-            {
-                auto it_unitig = v_unitigs.begin();
-                auto it_unitig_end = v_unitigs.end();
+    for (j = 0; j < v_kmers_sz; ++j) {
 
-                vector<thread> workers; // need to keep track of threads so we can join them
+        const Kmer km_unitig = km_unitigs.getKmer(j);
 
-                mutex mutex_it_unitig;
+        nb_pred = 0;
 
-                for (size_t t = 0; t < nb_threads; ++t){
+        for (i = 0; (i != 4) && (nb_pred <= lim); ++i) {
 
-                    workers.emplace_back(
+            if (!find(km_unitig.backwardBase(alpha[i]), true).isEmpty){
 
-                        [&]{
+                ++nb_pred;
 
-                            auto l_it_unitig = v_unitigs.begin();
-                            auto l_it_unitig_end = v_unitigs.end();
+                if (clipTips) km = km_unitig.backwardBase(alpha[i]);
+            }
+        }
 
-                            while (true) {
+        if (nb_pred <= lim){
 
-                                {
-                                    unique_lock<mutex> lock(mutex_it_unitig);
+            nb_succ = 0;
 
-                                    if (it_unitig == it_unitig_end) return;
+            for (i = 0; (i != 4) && (nb_succ <= lim); ++i) {
 
-                                    l_it_unitig = it_unitig;
-                                    l_it_unitig_end = it_unitig;
+                if (!find(km_unitig.forwardBase(alpha[i]), true).isEmpty){
 
-                                    if (distance(l_it_unitig, it_unitig_end) >= chunk){
+                    ++nb_succ;
 
-                                        advance(l_it_unitig_end, chunk);
+                    if (clipTips) km = km_unitig.forwardBase(alpha[i]);
+                }
+            }
+
+            if ((rm_and_clip && ((nb_pred + nb_succ) <= lim)) || (!rm_and_clip && ((nb_pred + nb_succ) == lim))) { //Unitig is isolated
 
-                                        it_unitig = l_it_unitig_end;
-                                    }
-                                    else {
+                ++removed;
+                --v_kmers_sz;
 
-                                        it_unitig = it_unitig_end;
-                                        l_it_unitig_end = it_unitig_end;
-                                    }
-                                }
+                if (j != v_kmers_sz){
 
-                                worker_v_unitigs(l_it_unitig, l_it_unitig_end);
-                            }
-                        }
-                    );
+                    swapUnitigs(true, j, v_kmers_sz),
+                    --j;
                 }
 
-                for (auto& t : workers) t.join();
+                if (clipTips && ((nb_pred + nb_succ) == lim)) v.push_back(km);
             }
         }
     }
-    else {
 
-        Kmer fw;
+    for (typename h_kmers_ccov_t::iterator it = h_kmers_ccov.begin(); it != h_kmers_ccov.end(); ++it) {
 
-        for (auto km : *v_joins){
+        nb_pred = 0;
 
-            const const_UnitigMap<U, G> cm = find(km, true);
+        for (i = 0; (i != 4) && (nb_pred <= lim); ++i) {
 
-            if (!cm.isEmpty){
+            if (!find(it.getKey().backwardBase(alpha[i]), true).isEmpty){
 
-                if (!cm.isShort && !cm.isAbundant){
+                ++nb_pred;
+                if (clipTips) km = it.getKey().backwardBase(alpha[i]);
+            }
+        }
 
-                    if ((cm.dist == 0 && cm.strand) || (cm.dist != 0 && !cm.strand)) km = km.twin();
-                    if (checkJoin(km, cm, fw)) joins.insert(fw.twin(), km.getChar(0));
-                }
-                else {
+        if (nb_pred <= lim){
 
-                    if (checkJoin(km, cm, fw)) joins.insert(fw.twin(), km.getChar(0));
+            nb_succ = 0;
 
-                    km = km.twin();
+            for (i = 0; (i != 4) && (nb_succ <= lim); ++i) {
 
-                    if (checkJoin(km, cm, fw)) joins.insert(fw.twin(), km.getChar(0));
+                if (!find(it.getKey().forwardBase(alpha[i]), true).isEmpty){
+
+                    ++nb_succ;
+                    if (clipTips) km = it.getKey().forwardBase(alpha[i]);
                 }
             }
+
+            if ((rm_and_clip && ((nb_pred + nb_succ) <= lim)) || (!rm_and_clip && ((nb_pred + nb_succ) == lim))){
+
+                ++removed;
+
+                *it = CompressedCoverage_t<U>();
+
+                if (clipTips && ((nb_pred + nb_succ) == lim)) v.push_back(km);
+            }
         }
     }
-}
 
-// use:  joined = mapper.joinUnitigs()
-// pre:  no short unitigs exist in sUnitigs.
-// post: all unitigs that could be connected have been connected
-//       joined is the number of joined unitigs
-template<typename U, typename G>
-template<bool is_void>
-typename std::enable_if<!is_void, size_t>::type CompactedDBG<U, G>::joinUnitigs_(vector<Kmer>* v_joins, const size_t nb_threads) {
+    for (j = v_unitigs_sz; j < v_unitigs.size(); ++j) deleteUnitig_<is_void<U>::value>(false, false, j);
+    v_unitigs.resize(v_unitigs_sz);
 
-    size_t joined = 0;
-    size_t cov_full = CompressedCoverage::getFullCoverage();
-    size_t v_unitigs_size = v_unitigs.size();
-    size_t v_kmers_size = km_unitigs.size();
+    for (j = v_kmers_sz; j < km_unitigs.size(); ++j) deleteUnitig_<is_void<U>::value>(true, false, j);
+    km_unitigs.resize(v_kmers_sz);
 
-    // a and b are candidates for joining
-    /*KmerHashTable<Kmer> joins;
+    for (typename h_kmers_ccov_t::iterator it = h_kmers_ccov.begin(); it != h_kmers_ccov.end(); ++it){
 
-    createJoinHT(v_joins, joins, nb_threads);
+        if (it->ccov.size() == 0) deleteUnitig_<is_void<U>::value>(false, true, it.getHash());
+    }
 
-    if (v_joins != nullptr) v_joins->clear();
+    return removed;
+}
 
-    for (KmerHashTable<Kmer>::iterator it(joins.begin()); it != joins.end(); ++it) {
+template<typename U, typename G>
+void CompactedDBG<U, G>::writeFASTA(const string& graphfilename) const {
 
-        const Kmer head(*it);
-        const Kmer tail(it.getKey().twin());*/
+    const size_t v_unitigs_sz = v_unitigs.size();
+    const size_t v_kmers_sz = km_unitigs.size();
 
-    //-------------------------------------------------------------------------------
-    KmerHashTable<char> joins;
+    size_t i = 0;
 
-    createJoinHT(v_joins, joins, nb_threads);
+    ofstream graphfile;
+    ostream graph(0);
 
-    if (v_joins != nullptr) v_joins->clear();
+    graphfile.open(graphfilename.c_str());
+    graph.rdbuf(graphfile.rdbuf());
+    //graph.sync_with_stdio(false);
 
-    for (KmerHashTable<char>::iterator it(joins.begin()); it != joins.end(); ++it) {
+    assert(!graphfile.fail());
 
-        const Kmer tail(it.getKey().twin());
-        const Kmer head(tail.backwardBase(*it));
-    //-------------------------------------------------------------------------------
+    for (size_t j = 0; j < v_unitigs_sz; ++j, ++i) graph << ">" << i << "\n" << v_unitigs[j]->getSeq().toString() << "\n";
+    for (size_t j = 0; j < v_kmers_sz; ++j, ++i) graph << ">" << i << "\n" << km_unitigs.getKmer(j).toString() << "\n";
 
-        UnitigMap<U, G> cmHead(find(head, true));
-        UnitigMap<U, G> cmTail(find(tail, true));
+    for (typename h_kmers_ccov_t::const_iterator it = h_kmers_ccov.begin(); it != h_kmers_ccov.end(); ++it, ++i) {
 
-        if (!cmHead.isEmpty && !cmTail.isEmpty) {
+        graph << ">" << i << "\n" << it.getKey().toString() << "\n";
+    }
 
-            Kmer cmHead_head, cmTail_head;
+    graphfile.close();
+}
 
-            if (cmHead.isShort) cmHead_head = km_unitigs.getKmer(cmHead.pos_unitig);
-            else if (cmHead.isAbundant) cmHead_head = h_kmers_ccov.find(cmHead.pos_unitig).getKey();
-            else cmHead_head = v_unitigs[cmHead.pos_unitig]->getSeq().getKmer(0);
+template<typename U, typename G>
+template<bool is_void>
+typename std::enable_if<!is_void, void>::type CompactedDBG<U, G>::writeGFA_sequence_(GFA_Parser& graph, KmerHashTable<size_t>& idmap) const {
 
-            if (cmTail.isShort) cmTail_head = km_unitigs.getKmer(cmTail.pos_unitig);
-            else if (cmTail.isAbundant) cmTail_head = h_kmers_ccov.find(cmTail.pos_unitig).getKey();
-            else cmTail_head = v_unitigs[cmTail.pos_unitig]->getSeq().getKmer(0);
+    size_t labelA = 1;
 
-            if (cmHead_head != cmTail_head) { // can't join a sequence with itself, either hairPin, loop or mobius loop
+    for (const auto& unitig : *this){
 
-                // both kmers are still end-kmers
-                bool headDir;
-                bool len_k_head = cmHead.isShort || cmHead.isAbundant;
+        const string seq(unitig.referenceUnitigToString());
 
-                if (len_k_head && (head == cmHead_head)) headDir = true;
-                else if (!len_k_head && (head == v_unitigs[cmHead.pos_unitig]->getSeq().getKmer(v_unitigs[cmHead.pos_unitig]->numKmers()-1))) headDir = true;
-                else if (head.twin() == cmHead_head) headDir = false;
-                else continue;
+        graph.write_sequence(std::to_string(labelA), seq.size(), seq, unitig.getData()->serialize(unitig));
 
-                bool tailDir;
-                bool len_k_tail = cmTail.isShort || cmTail.isAbundant;
+        if (unitig.isAbundant) idmap.insert(Kmer(unitig.referenceUnitigToString().c_str()), labelA);
 
-                if (tail == cmTail_head) tailDir = true;
-                else if (len_k_tail){
-                    if (tail.twin() == cmTail_head) tailDir = false;
-                    else continue;
-                }
-                else if (tail.twin() == v_unitigs[cmTail.pos_unitig]->getSeq().getKmer(v_unitigs[cmTail.pos_unitig]->numKmers()-1)) tailDir = false;
-                else continue;
+        ++labelA;
+    }
+}
 
-                //Compute join sequence
-                string joinSeq;
+template<typename U, typename G>
+template<bool is_void>
+typename std::enable_if<is_void, void>::type CompactedDBG<U, G>::writeGFA_sequence_(GFA_Parser& graph, KmerHashTable<size_t>& idmap) const {
 
-                joinSeq.reserve((len_k_head ? k_ : cmHead.size) + (len_k_tail ? k_ : cmTail.size) - k_ + 1);
+    size_t labelA = 1;
 
-                if (headDir) joinSeq = len_k_head ? cmHead_head.toString() : v_unitigs[cmHead.pos_unitig]->getSeq().toString();
-                else joinSeq = len_k_head ? cmHead_head.twin().toString() : v_unitigs[cmHead.pos_unitig]->getSeq().rev().toString();
+    for (const auto& unitig : *this){
 
-                if (tailDir) joinSeq.append(len_k_tail ? cmTail_head.toString() : v_unitigs[cmTail.pos_unitig]->getSeq().toString(), k_ - 1, string::npos);
-                else joinSeq.append(len_k_tail ? cmTail_head.twin().toString() : v_unitigs[cmTail.pos_unitig]->getSeq().rev().toString(), k_ - 1, string::npos);
+        const string seq(unitig.referenceUnitigToString());
 
-                //Compute new coverage
-                /*uint64_t covsum;
+        graph.write_sequence(std::to_string(labelA), seq.size(), seq, "");
 
-                if (len_k_head){
+        if (unitig.isAbundant) idmap.insert(Kmer(unitig.referenceUnitigToString().c_str()), labelA);
 
-                    CompressedCoverage& ccov = cmHead.isShort ? v_kmers[cmHead.pos_unitig].second.ccov : h_kmers_ccov.find(cmHead.pos_unitig)->ccov;
-                    covsum = ccov.covAt(0);
-                }
-                else covsum = v_unitigs[cmHead.pos_unitig]->coveragesum;
+        ++labelA;
+    }
+}
 
-                if (len_k_tail){
+template<typename U, typename G>
+void CompactedDBG<U, G>::writeGFA(const string& graphfilename, const size_t nb_threads) const {
 
-                    CompressedCoverage& ccov = cmTail.isShort ? v_kmers[cmTail.pos_unitig].second.ccov : h_kmers_ccov.find(cmTail.pos_unitig)->ccov;
-                    covsum += ccov.covAt(0);
-                }
-                else covsum += v_unitigs[cmTail.pos_unitig]->coveragesum;*/
+    const size_t v_unitigs_sz = v_unitigs.size();
+    const size_t v_kmers_sz = km_unitigs.size();
 
-                Unitig<U> data_tmp; //Store temporarily the new merged data
-                Unitig<U>* unitig; //New unitig
+    size_t labelA, labelB, id = v_unitigs_sz + v_kmers_sz + 1;
 
-                cmHead.strand = headDir;
-                cmHead.dist = 0;
-                cmHead.len = cmHead.size - k_ + 1;
+    const string header_tag("BV:Z:" + string(BFG_VERSION) + "\t" + "KL:Z:" + to_string(k_) + "\t" + "ML:Z:" + to_string(g_) + "\t" + "MO:Z:" + string(MINIMIZER_ORDER_NAME));
 
-                cmTail.strand = tailDir;
-                cmTail.dist = 0;
-                cmTail.len = cmTail.size - k_ + 1;
+    KmerHashTable<size_t> idmap(h_kmers_ccov.size());
 
-                data_tmp.getData()->concat(cmHead, cmTail);
+    GFA_Parser graph(graphfilename);
 
-                cmHead.getData()->clear(cmHead);
-                cmTail.getData()->clear(cmTail);
+    graph.open_write(1, header_tag);
 
-                if (cmHead.isShort || cmHead.isAbundant){
+    writeGFA_sequence_<is_void<U>::value>(graph, idmap);
 
-                    if (cmHead.isShort){ //If head is a short unitig, swap and delete it
+    if (nb_threads == 1){
 
-                        --v_kmers_size;
+        for (labelA = 1; labelA <= v_unitigs_sz; labelA++) {
 
-                        if (cmHead.pos_unitig != v_kmers_size){
+            const Unitig<U>* unitig = v_unitigs[labelA - 1];
+            const Kmer head = unitig->getSeq().getKmer(0);
+            const Kmer tail = unitig->getSeq().getKmer(unitig->length() - k_);
 
-                            swapUnitigs(true, cmHead.pos_unitig, v_kmers_size);
+            const vector<const_UnitigMap<U, G>> pred = findPredecessors(head, true);
+            const vector<const_UnitigMap<U, G>> succ = findSuccessors(tail, 4, true);
 
-                            // If the last unitig of the vector used for the swap was the tail
-                            if (cmTail.isShort && (v_kmers_size == cmTail.pos_unitig)) cmTail.pos_unitig = cmHead.pos_unitig;
-                        }
+            for (const auto& unitig : pred){
 
-                        deleteUnitig_<false>(true, false, v_kmers_size);
-                    }
-                    else if (cmHead.isAbundant) deleteUnitig_<false>(false, true, cmHead.pos_unitig);
-                }
+                if (!unitig.isEmpty){
 
-                if (cmTail.isShort || cmTail.isAbundant){
+                    if (unitig.isAbundant) labelB = *(idmap.find(unitig.getUnitigHead().rep()));
+                    else labelB = unitig.pos_unitig + 1 + ((static_cast<size_t>(!unitig.isShort) - 1) & v_unitigs_sz);
 
-                    if (cmTail.isShort){ //If tail is a short unitig, swap and delete it
+                    const string slabelA = std::to_string(labelA);
+                    const string slabelB = std::to_string(labelB);
 
-                        --v_kmers_size;
+                    const size_t pos = (static_cast<size_t>(unitig.strand) - 1) & (unitig.size - k_ + 1);
 
-                        if (cmTail.pos_unitig != v_kmers_size){
+                    graph.write_edge(slabelA, 0, k_-1, false, slabelB, pos, pos + k_ - 1, !unitig.strand);
+                }
+            }
 
-                            swapUnitigs(true, cmTail.pos_unitig, v_kmers_size);
+            for (const auto& unitig : succ){
 
-                            if (cmHead.isShort && (v_kmers_size == cmHead.pos_unitig)) cmHead.pos_unitig = cmTail.pos_unitig;
-                        }
+                if (!unitig.isEmpty){
 
-                        deleteUnitig_<false>(true, false, v_kmers_size);
-                    }
-                    else if (cmTail.isAbundant) deleteUnitig_<false>(false, true, cmTail.pos_unitig);
-                }
+                    if (unitig.isAbundant) labelB = *(idmap.find(unitig.getUnitigHead().rep()));
+                    else labelB = unitig.pos_unitig + 1 + ((static_cast<size_t>(!unitig.isShort) - 1) & v_unitigs_sz);
 
-                if (len_k_head && len_k_tail){
+                    const string slabelA = std::to_string(labelA);
+                    const string slabelB = std::to_string(labelB);
 
-                    addUnitig(joinSeq, v_unitigs_size);
-                    unitig = v_unitigs[v_unitigs_size];
-                    ++v_unitigs_size;
+                    const size_t pos = (static_cast<size_t>(unitig.strand) - 1) & (unitig.size - k_ + 1);
+
+                    graph.write_edge(slabelA, unitig.size - k_ + 1, unitig.size, true, slabelB, pos, pos + k_ - 1, unitig.strand);
                 }
-                else if (len_k_head){
+            }
+        }
+
+        for (labelA = v_unitigs_sz + 1; labelA <= v_kmers_sz + v_unitigs_sz; labelA++) {
 
-                    deleteUnitig_<false>(false, false, cmTail.pos_unitig);
-                    addUnitig(joinSeq, cmTail.pos_unitig);
-                    unitig = v_unitigs[cmTail.pos_unitig];
-                }
-                else {
+            const Kmer km_unitig = km_unitigs.getKmer(labelA - v_unitigs_sz - 1);
 
-                    if (!len_k_tail){
+            const vector<const_UnitigMap<U, G>> pred = findPredecessors(km_unitig, true);
+            const vector<const_UnitigMap<U, G>> succ = findSuccessors(km_unitig, 4, true);
 
-                        --v_unitigs_size;
+            for (const auto& unitig : pred){
 
-                        if (cmTail.pos_unitig != v_unitigs_size){
+                if (!unitig.isEmpty){
 
-                            swapUnitigs(false, cmTail.pos_unitig, v_unitigs_size);
+                    if (unitig.isAbundant) labelB = *(idmap.find(unitig.getUnitigHead().rep()));
+                    else labelB = unitig.pos_unitig + 1 + ((static_cast<size_t>(!unitig.isShort) - 1) & v_unitigs_sz);
 
-                            if (v_unitigs_size == cmHead.pos_unitig) cmHead.pos_unitig = cmTail.pos_unitig;
-                        }
+                    const string slabelA = std::to_string(labelA);
+                    const string slabelB = std::to_string(labelB);
 
-                        deleteUnitig_<false>(false, false, v_unitigs_size);
-                    }
+                    const size_t pos = (static_cast<size_t>(unitig.strand) - 1) & (unitig.size - k_ + 1);
 
-                    deleteUnitig_<false>(false, false, cmHead.pos_unitig);
-                    addUnitig(joinSeq, cmHead.pos_unitig);
-                    unitig = v_unitigs[cmHead.pos_unitig];
+                    graph.write_edge(slabelA, 0, k_-1, false, slabelB, pos, pos + k_ - 1, !unitig.strand);
                 }
+            }
 
-                //unitig->coveragesum = covsum;
-                //if (covsum >= cov_full * unitig->numKmers()) unitig->ccov.setFull();
-                unitig->getCov().setFull();
+            for (const auto& unitig : succ){
 
-                *(unitig->getData()) = std::move(*(data_tmp.getData()));
+                if (!unitig.isEmpty){
 
-                ++joined;
-            }
-        }
-    }
+                    if (unitig.isAbundant) labelB = *(idmap.find(unitig.getUnitigHead().rep()));
+                    else labelB = unitig.pos_unitig + 1 + ((static_cast<size_t>(!unitig.isShort) - 1) & v_unitigs_sz);
 
-    if (v_unitigs_size < v_unitigs.size()) v_unitigs.resize(v_unitigs_size);
-    if (v_kmers_size < km_unitigs.size()) km_unitigs.resize(v_kmers_size);
+                    const string slabelA = std::to_string(labelA);
+                    const string slabelB = std::to_string(labelB);
 
-    return joined;
-}
+                    const size_t pos = (static_cast<size_t>(unitig.strand) - 1) & (unitig.size - k_ + 1);
 
-template<typename U, typename G>
-template<bool is_void>
-typename std::enable_if<is_void, size_t>::type CompactedDBG<U, G>::joinUnitigs_(vector<Kmer>* v_joins, const size_t nb_threads) {
+                    graph.write_edge(slabelA, unitig.size - k_ + 1, unitig.size, true, slabelB, pos, pos + k_ - 1, unitig.strand);
+                }
+            }
+        }
 
-    size_t joined = 0;
-    size_t cov_full = CompressedCoverage::getFullCoverage();
-    size_t v_unitigs_size = v_unitigs.size();
-    size_t v_kmers_size = km_unitigs.size();
+        for (KmerHashTable<size_t>::iterator it = idmap.begin(); it != idmap.end(); it++) {
 
-    // a and b are candidates for joining
-    /*KmerHashTable<Kmer> joins;
+            labelA = *it;
 
-    createJoinHT(v_joins, joins, nb_threads);
+            const vector<const_UnitigMap<U, G>> pred = findPredecessors(it.getKey(), true);
+            const vector<const_UnitigMap<U, G>> succ = findSuccessors(it.getKey(), 4, true);
 
-    if (v_joins != nullptr) v_joins->clear();
+            for (const auto& unitig : pred){
 
-    for (KmerHashTable<Kmer>::iterator it = joins.begin(); it != joins.end(); ++it) {
+                if (!unitig.isEmpty){
 
-        const Kmer head = *it;
-        const Kmer tail = it.getKey().twin();*/
+                    if (unitig.isAbundant) labelB = *(idmap.find(unitig.getUnitigHead().rep()));
+                    else labelB = unitig.pos_unitig + 1 + ((static_cast<size_t>(!unitig.isShort) - 1) & v_unitigs_sz);
 
-    //-------------------------------------------------------------------------------
-    KmerHashTable<char> joins;
+                    const string slabelA = std::to_string(labelA);
+                    const string slabelB = std::to_string(labelB);
 
-    createJoinHT(v_joins, joins, nb_threads);
+                    const size_t pos = (static_cast<size_t>(unitig.strand) - 1) & (unitig.size - k_ + 1);
 
-    if (v_joins != nullptr) v_joins->clear();
+                    graph.write_edge(slabelA, 0, k_-1, false, slabelB, pos, pos + k_ - 1, !unitig.strand);
+                }
+            }
 
-    for (KmerHashTable<char>::iterator it(joins.begin()); it != joins.end(); ++it) {
+            for (const auto& unitig : succ){
 
-        const Kmer tail(it.getKey().twin());
-        const Kmer head(tail.backwardBase(*it));
-    //-------------------------------------------------------------------------------
+                if (!unitig.isEmpty){
 
-        UnitigMap<U, G> cmHead = find(head, true);
-        UnitigMap<U, G> cmTail = find(tail, true);
+                    if (unitig.isAbundant) labelB = *(idmap.find(unitig.getUnitigHead().rep()));
+                    else labelB = unitig.pos_unitig + 1 + ((static_cast<size_t>(!unitig.isShort) - 1) & v_unitigs_sz);
 
-        if (!cmHead.isEmpty && !cmTail.isEmpty) {
+                    const string slabelA = std::to_string(labelA);
+                    const string slabelB = std::to_string(labelB);
 
-            Kmer cmHead_head, cmTail_head;
+                    const size_t pos = (static_cast<size_t>(unitig.strand) - 1) & (unitig.size - k_ + 1);
 
-            if (cmHead.isShort) cmHead_head = km_unitigs.getKmer(cmHead.pos_unitig);
-            else if (cmHead.isAbundant) cmHead_head = h_kmers_ccov.find(cmHead.pos_unitig).getKey();
-            else cmHead_head = v_unitigs[cmHead.pos_unitig]->getSeq().getKmer(0);
+                    graph.write_edge(slabelA, unitig.size - k_ + 1, unitig.size, true, slabelB, pos, pos + k_ - 1, unitig.strand);
+                }
+            }
+        }
+    }
+    else {
 
-            if (cmTail.isShort) cmTail_head = km_unitigs.getKmer(cmTail.pos_unitig);
-            else if (cmTail.isAbundant) cmTail_head = h_kmers_ccov.find(cmTail.pos_unitig).getKey();
-            else cmTail_head = v_unitigs[cmTail.pos_unitig]->getSeq().getKmer(0);
+        const size_t chunk_size = 1024;
 
-            if (cmHead_head != cmTail_head) { // can't join a sequence with itself, either hairPin, loop or mobius loop
+        auto worker_v_unitigs = [v_unitigs_sz, &idmap, this](const size_t labelA_start, const size_t labelA_end,
+                                                             vector<pair<pair<size_t, bool>, pair<size_t, bool>>>* v_out){
 
-                // both kmers are still end-kmers
-                bool headDir;
-                bool len_k_head = cmHead.isShort || cmHead.isAbundant;
+            // We need to deal with the tail of long unitigs
+            for (size_t labelA = labelA_start; labelA < labelA_end; ++labelA) {
 
-                if (len_k_head && (head == cmHead_head)) headDir = true;
-                else if (!len_k_head && (head == v_unitigs[cmHead.pos_unitig]->getSeq().getKmer(v_unitigs[cmHead.pos_unitig]->numKmers()-1))) headDir = true;
-                else if (head.twin() == cmHead_head) headDir = false;
-                else continue;
+                const Unitig<U>* unitig = v_unitigs[labelA - 1];
 
-                bool tailDir;
-                bool len_k_tail = cmTail.isShort || cmTail.isAbundant;
+                const Kmer head = unitig->getSeq().getKmer(0);
+                const Kmer tail = unitig->getSeq().getKmer(unitig->length() - k_);
 
-                if (tail == cmTail_head) tailDir = true;
-                else if (len_k_tail){
-                    if (tail.twin() == cmTail_head) tailDir = false;
-                    else continue;
-                }
-                else if (tail.twin() == v_unitigs[cmTail.pos_unitig]->getSeq().getKmer(v_unitigs[cmTail.pos_unitig]->numKmers()-1)) tailDir = false;
-                else continue;
+                const vector<const_UnitigMap<U, G>> pred = this->findPredecessors(head, true);
+                const vector<const_UnitigMap<U, G>> succ = this->findSuccessors(tail, 4, true);
 
-                //Compute join sequence
-                string joinSeq;
+                for (const auto& um : pred) {
 
-                joinSeq.reserve((len_k_head ? k_ : cmHead.size) + (len_k_tail ? k_ : cmTail.size) - k_ + 1);
+                    if (!um.isEmpty){
 
-                if (headDir) joinSeq = len_k_head ? cmHead_head.toString() : v_unitigs[cmHead.pos_unitig]->getSeq().toString();
-                else joinSeq = len_k_head ? cmHead_head.twin().toString() : v_unitigs[cmHead.pos_unitig]->getSeq().rev().toString();
+                        const size_t labelB = (um.isAbundant ?  *(idmap.find(um.getUnitigHead().rep())) :
+                                                                um.pos_unitig + 1 + ((static_cast<size_t>(!um.isShort) - 1) & v_unitigs_sz));
 
-                if (tailDir) joinSeq.append(len_k_tail ? cmTail_head.toString() : v_unitigs[cmTail.pos_unitig]->getSeq().toString(), k_ - 1, string::npos);
-                else joinSeq.append(len_k_tail ? cmTail_head.twin().toString() : v_unitigs[cmTail.pos_unitig]->getSeq().rev().toString(), k_ - 1, string::npos);
+                        v_out->push_back(make_pair(make_pair(labelA, false), make_pair(labelB, !um.strand)));
+                    }
+                }
 
-                //Compute new coverage
-                /*uint64_t covsum;
+                for (const auto& um : succ) {
 
-                if (len_k_head){
+                    if (!um.isEmpty){
 
-                    CompressedCoverage& ccov = cmHead.isShort ? v_kmers[cmHead.pos_unitig].second.ccov : h_kmers_ccov.find(cmHead.pos_unitig)->ccov;
-                    covsum = ccov.covAt(0);
+                        const size_t labelB = (um.isAbundant ?  *(idmap.find(um.getUnitigHead().rep())) :
+                                                                um.pos_unitig + 1 + ((static_cast<size_t>(!um.isShort) - 1) & v_unitigs_sz));
+
+                        v_out->push_back(make_pair(make_pair(labelA, true), make_pair(labelB, um.strand)));
+                    }
                 }
-                else covsum = v_unitigs[cmHead.pos_unitig]->coveragesum;
+            }
+        };
 
-                if (len_k_tail){
+        auto worker_v_kmers = [v_unitigs_sz, &idmap, this](const size_t labelA_start, const size_t labelA_end,
+                                                             vector<pair<pair<size_t, bool>, pair<size_t, bool>>>* v_out){
 
-                    CompressedCoverage& ccov = cmTail.isShort ? v_kmers[cmTail.pos_unitig].second.ccov : h_kmers_ccov.find(cmTail.pos_unitig)->ccov;
-                    covsum += ccov.covAt(0);
-                }
-                else covsum += v_unitigs[cmTail.pos_unitig]->coveragesum;*/
+            // We need to deal with the tail of long unitigs
+            for (size_t labelA = labelA_start; labelA < labelA_end; ++labelA) {
 
-                Unitig<U>* unitig; //New unitig
+                const Kmer km_unitig = km_unitigs.getKmer(labelA - v_unitigs_sz - 1);
 
-                cmTail.strand = tailDir;
-                cmHead.strand = headDir;
+                const vector<const_UnitigMap<U, G>> pred = this->findPredecessors(km_unitig, true);
+                const vector<const_UnitigMap<U, G>> succ = this->findSuccessors(km_unitig, 4, true);
 
-                if (cmHead.isShort || cmHead.isAbundant){
+                for (const auto& um : pred) {
 
-                    if (cmHead.isShort){ //If head is a short unitig, swap and delete it
+                    if (!um.isEmpty){
 
-                        --v_kmers_size;
+                        const size_t labelB = (um.isAbundant ?  *(idmap.find(um.getUnitigHead().rep())) :
+                                                                um.pos_unitig + 1 + ((static_cast<size_t>(!um.isShort) - 1) & v_unitigs_sz));
 
-                        if (cmHead.pos_unitig != v_kmers_size){
+                        v_out->push_back(make_pair(make_pair(labelA, false), make_pair(labelB, !um.strand)));
+                    }
+                }
 
-                            swapUnitigs(true, cmHead.pos_unitig, v_kmers_size);
+                for (const auto& um : succ) {
 
-                            // If the last unitig of the vector used for the swap was the tail
-                            if (cmTail.isShort && (v_kmers_size == cmTail.pos_unitig)) cmTail.pos_unitig = cmHead.pos_unitig;
-                        }
+                    if (!um.isEmpty){
 
-                        deleteUnitig_<true>(true, false, v_kmers_size);
+                        const size_t labelB = (um.isAbundant ?  *(idmap.find(um.getUnitigHead().rep())) :
+                                                                um.pos_unitig + 1 + ((static_cast<size_t>(!um.isShort) - 1) & v_unitigs_sz));
+
+                        v_out->push_back(make_pair(make_pair(labelA, true), make_pair(labelB, um.strand)));
                     }
-                    else if (cmHead.isAbundant) deleteUnitig_<true>(false, true, cmHead.pos_unitig);
                 }
+            }
+        };
 
-                if (cmTail.isShort || cmTail.isAbundant){
-
-                    if (cmTail.isShort){ //If tail is a short unitig, swap and delete it
+        auto worker_v_abundant = [v_unitigs_sz, chunk_size, &idmap, this](  KmerHashTable<size_t>::iterator* l_it,
+                                                                            vector<pair<pair<size_t, bool>, pair<size_t, bool>>>* v_out){
 
-                        --v_kmers_size;
+            KmerHashTable<size_t>::iterator& it = *l_it;
 
-                        if (cmTail.pos_unitig != v_kmers_size){
+            // We need to deal with the tail of long unitigs
+            for (size_t i = 0; (it != idmap.end()) && (i < chunk_size); ++i, ++it) {
 
-                            swapUnitigs(true, cmTail.pos_unitig, v_kmers_size);
+                const vector<const_UnitigMap<U, G>> pred = this->findPredecessors(it.getKey(), true);
+                const vector<const_UnitigMap<U, G>> succ = this->findSuccessors(it.getKey(), 4, true);
 
-                            if (cmHead.isShort && (v_kmers_size == cmHead.pos_unitig)) cmHead.pos_unitig = cmTail.pos_unitig;
-                        }
+                for (const auto& um : pred) {
 
-                        deleteUnitig_<true>(true, false, v_kmers_size);
-                    }
-                    else if (cmTail.isAbundant) deleteUnitig_<true>(false, true, cmTail.pos_unitig);
-                }
+                    if (!um.isEmpty){
 
-                if (len_k_head && len_k_tail){
+                        const size_t labelB = (um.isAbundant ?  *(idmap.find(um.getUnitigHead().rep())) :
+                                                                um.pos_unitig + 1 + ((static_cast<size_t>(!um.isShort) - 1) & v_unitigs_sz));
 
-                    addUnitig(joinSeq, v_unitigs_size);
-                    unitig = v_unitigs[v_unitigs_size];
-                    ++v_unitigs_size;
+                        v_out->push_back(make_pair(make_pair(*it, false), make_pair(labelB, !um.strand)));
+                    }
                 }
-                else if (len_k_head){
 
-                    deleteUnitig_<true>(false, false, cmTail.pos_unitig);
-                    addUnitig(joinSeq, cmTail.pos_unitig);
-                    unitig = v_unitigs[cmTail.pos_unitig];
-                }
-                else {
+                for (const auto& um : succ) {
 
-                    if (!len_k_tail){
+                    if (!um.isEmpty){
 
-                        --v_unitigs_size;
+                        const size_t labelB = (um.isAbundant ?  *(idmap.find(um.getUnitigHead().rep())) :
+                                                                um.pos_unitig + 1 + ((static_cast<size_t>(!um.isShort) - 1) & v_unitigs_sz));
 
-                        if (cmTail.pos_unitig != v_unitigs_size){
+                        v_out->push_back(make_pair(make_pair(*it, true), make_pair(labelB, um.strand)));
+                    }
+                }
+            }
+        };
 
-                            swapUnitigs(false, cmTail.pos_unitig, v_unitigs_size);
+        {
+            atomic<size_t> label(1);
 
-                            if (v_unitigs_size == cmHead.pos_unitig) cmHead.pos_unitig = cmTail.pos_unitig;
-                        }
+            vector<vector<pair<pair<size_t, bool>, pair<size_t, bool>>>> v_out(nb_threads);
+            vector<thread> workers; // need to keep track of threads so we can join them
 
-                        deleteUnitig_<true>(false, false, v_unitigs_size);
-                    }
+            mutex mutex_file;
 
-                    deleteUnitig_<true>(false, false, cmHead.pos_unitig);
-                    addUnitig(joinSeq, cmHead.pos_unitig);
-                    unitig = v_unitigs[cmHead.pos_unitig];
-                }
+            for (size_t t = 0; t < nb_threads; ++t){
 
-                //unitig->coveragesum = covsum;
-                //if (covsum >= cov_full * unitig->numKmers()) unitig->ccov.setFull();
-                unitig->getCov().setFull();
+                workers.emplace_back(
 
-                ++joined;
-            }
-        }
-    }
+                    [&, t]{
 
-    if (v_unitigs_size < v_unitigs.size()) v_unitigs.resize(v_unitigs_size);
-    if (v_kmers_size < km_unitigs.size()) km_unitigs.resize(v_kmers_size);
+                        while (true) {
 
-    return joined;
-}
+                            const size_t old_labelA = label.fetch_add(chunk_size);
 
-template<typename U, typename G>
-bool CompactedDBG<U, G>::checkJoin(const Kmer& a, const const_UnitigMap<U, G>& cm_a, Kmer& b) const {
+                            if (old_labelA <= v_unitigs_sz){
 
-    size_t i, j, count_succ;
+                                if (old_labelA + chunk_size <= v_unitigs_sz) worker_v_unitigs(old_labelA, old_labelA + chunk_size, &v_out[t]);
+                                else worker_v_unitigs(old_labelA, v_unitigs_sz + 1, &v_out[t]);
 
-    vector<const_UnitigMap<U, G>> v_um(findSuccessors(a, 2, true));
+                                {
+                                    unique_lock<mutex> lock(mutex_file);
 
-    for (i = 0, count_succ = 0; i != 4; ++i){
+                                    for (const auto& p : v_out[t]){
 
-        if (!v_um[i].isEmpty){
+                                        const string slabelA = std::to_string(p.first.first);
+                                        const string slabelB = std::to_string(p.second.first);
 
-            ++count_succ;
-            j = i;
-        }
-    }
+                                        graph.write_edge(slabelA, 0, k_-1, p.first.second, slabelB, 0, k_-1, p.second.second);
+                                    }
+                                }
 
-    if (count_succ == 1) {
+                                v_out[t].clear();
+                            }
+                            else return;
+                        }
+                    }
+                );
+            }
 
-        Kmer cand_head, ac_head;
+            for (auto& t : workers) t.join();
+        }
 
-        const Kmer fw_cand(a.forwardBase(alpha[j]));
+        {
+            const size_t v_kmers_unitigs_sz = v_kmers_sz + v_unitigs_sz;
 
-        const const_UnitigMap<U, G> cm_cand(v_um[j]);
+            atomic<size_t> label(v_unitigs_sz + 1);
 
-        if (cm_cand.isShort) cand_head = km_unitigs.getKmer(cm_cand.pos_unitig);
-        else if (cm_cand.isAbundant) cand_head = h_kmers_ccov.find(cm_cand.pos_unitig).getKey();
-        else cand_head = v_unitigs[cm_cand.pos_unitig]->getSeq().getKmer(0);
+            vector<vector<pair<pair<size_t, bool>, pair<size_t, bool>>>> v_out(nb_threads);
+            vector<thread> workers; // need to keep track of threads so we can join them
 
-        if (cm_a.isShort) ac_head = km_unitigs.getKmer(cm_a.pos_unitig);
-        else if (cm_a.isAbundant) ac_head = h_kmers_ccov.find(cm_a.pos_unitig).getKey();
-        else ac_head = v_unitigs[cm_a.pos_unitig]->getSeq().getKmer(0);
+            mutex mutex_file;
 
-        if (cand_head != ac_head) {
+            for (size_t t = 0; t < nb_threads; ++t){
 
-            v_um = findSuccessors(fw_cand.twin(), 2, true);
+                workers.emplace_back(
 
-            for (i = 0, count_succ = 0; i != 4; ++i) count_succ += !v_um[i].isEmpty;
+                    [&, t]{
 
-            if (count_succ == 1) {
+                        while (true) {
 
-                b = fw_cand;
-                return true;
-            }
-        }
-    }
+                            const size_t old_labelA = label.fetch_add(chunk_size);
 
-    return false;
-}
+                            if (old_labelA <= v_kmers_unitigs_sz){
 
-template<typename U, typename G>
-void CompactedDBG<U, G>::check_fp_tips(KmerHashTable<bool>& ignored_km_tips){
+                                if (old_labelA + chunk_size <= v_kmers_unitigs_sz) worker_v_kmers(old_labelA, old_labelA + chunk_size, &v_out[t]);
+                                else worker_v_kmers(old_labelA, v_kmers_unitigs_sz + 1, &v_out[t]);
 
-    uint64_t nb_real_short_tips = 0;
+                                {
+                                    unique_lock<mutex> lock(mutex_file);
 
-    size_t nxt_pos_insert_v_unitigs = v_unitigs.size();
-    size_t v_unitigs_sz = v_unitigs.size();
-    size_t v_kmers_sz = km_unitigs.size();
+                                    for (const auto& p : v_out[t]){
 
-    vector<pair<int,int>> sp;
+                                        const string slabelA = std::to_string(p.first.first);
+                                        const string slabelB = std::to_string(p.second.first);
 
-    for (KmerHashTable<bool>::iterator it(ignored_km_tips.begin()); it != ignored_km_tips.end(); ++it) {
+                                        graph.write_edge(slabelA, 0, k_-1, p.first.second, slabelB, 0, k_-1, p.second.second);
+                                    }
+                                }
 
-        Kmer km(it.getKey());
+                                v_out[t].clear();
+                            }
+                            else return;
+                        }
+                    }
+                );
+            }
 
-        UnitigMap<U, G> cm(find(km, true)); // Check if the (short) tip actually exists
+            for (auto& t : workers) t.join();
+        }
 
-        if (!cm.isEmpty){ // IF the tip exists
+        {
+            KmerHashTable<size_t>::iterator it = idmap.begin(), it_end = idmap.end();
 
-            ++nb_real_short_tips;
+            vector<vector<pair<pair<size_t, bool>, pair<size_t, bool>>>> v_out(nb_threads);
+            vector<thread> workers; // need to keep track of threads so we can join them
 
-            bool not_found = true;
+            mutex mutex_file, mutex_it;
 
-            for (size_t i = 0; (i < 4) && not_found; ++i) {
+            for (size_t t = 0; t < nb_threads; ++t){
 
-                UnitigMap<U, G> cm_bw(find(km.backwardBase(alpha[i])));
+                workers.emplace_back(
 
-                if (!cm_bw.isEmpty && !cm_bw.isAbundant && !cm_bw.isShort){
+                    [&, t]{
 
-                    //if (cm_bw.strand) ++cm_bw.dist;
-                    cm_bw.dist += cm_bw.strand;
+                        KmerHashTable<size_t>::iterator l_it;
 
-                    if ((cm_bw.dist != 0) && (cm_bw.dist != cm_bw.size - k_ + 1)){
+                        bool stop;
 
-                        sp.push_back(make_pair(0, cm_bw.dist));
-                        sp.push_back(make_pair(cm_bw.dist, cm_bw.size - k_ + 1));
+                        while (true) {
 
-                        extractUnitig_<is_void<U>::value>(cm_bw.pos_unitig, nxt_pos_insert_v_unitigs, v_unitigs_sz, v_kmers_sz, sp);
+                            {
+                                unique_lock<mutex> lock(mutex_it);
 
-                        sp.clear();
-                    }
+                                l_it = it;
 
-                    not_found = false;
-                }
-            }
+                                for (size_t i = 0; (it != it_end) && (i < chunk_size); ++i, ++it){}
 
-            for (size_t i = 0; (i < 4) && not_found; ++i) {
+                                stop = (l_it == it_end) && (it == it_end);
+                            }
 
-                UnitigMap<U, G> cm_fw(find(km.forwardBase(alpha[i])));
+                            if (!stop){
 
-                if (!cm_fw.isEmpty && !cm_fw.isAbundant && !cm_fw.isShort){
+                                worker_v_abundant(&l_it, &v_out[t]);
 
-                    //if (!cm_fw.strand) ++cm_fw.dist;
-                    cm_fw.dist += !cm_fw.strand;
+                                {
+                                    unique_lock<mutex> lock(mutex_file);
 
-                    if ((cm_fw.dist != 0) && (cm_fw.dist != cm_fw.size - k_ + 1)){
+                                    for (const auto& p : v_out[t]){
 
-                        sp.push_back(make_pair(0, cm_fw.dist));
-                        sp.push_back(make_pair(cm_fw.dist, cm_fw.size - k_ + 1));
+                                        const string slabelA = std::to_string(p.first.first);
+                                        const string slabelB = std::to_string(p.second.first);
 
-                        extractUnitig_<is_void<U>::value>(cm_fw.pos_unitig, nxt_pos_insert_v_unitigs, v_unitigs_sz, v_kmers_sz, sp);
+                                        graph.write_edge(slabelA, 0, k_-1, p.first.second, slabelB, 0, k_-1, p.second.second);
+                                    }
+                                }
 
-                        sp.clear();
+                                v_out[t].clear();
+                            }
+                            else return;
+                        }
                     }
-
-                    not_found = false;
-                }
+                );
             }
+
+            for (auto& t : workers) t.join();
         }
     }
 
-    if (nxt_pos_insert_v_unitigs < v_unitigs.size()) v_unitigs.resize(nxt_pos_insert_v_unitigs);
-    if (v_kmers_sz < km_unitigs.size()) km_unitigs.resize(v_kmers_sz);
+    graph.close();
 }
 
 template<typename U, typename G>
-size_t CompactedDBG<U, G>::removeUnitigs(bool rmIsolated, bool clipTips, vector<Kmer>& v){
+void CompactedDBG<U, G>::readGFA(const string& graphfilename, const size_t nb_threads) {
 
-    if (!rmIsolated && !clipTips) return 0;
+    size_t graph_file_id = 0;
 
-    const bool rm_and_clip = rmIsolated && clipTips;
+    bool new_file_opened = false;
 
-    size_t v_unitigs_sz = v_unitigs.size();
-    size_t v_kmers_sz = km_unitigs.size();
-    size_t removed = 0;
-    size_t i;
+    GFA_Parser graph(graphfilename);
 
-    int64_t j;
+    graph.open_read();
 
-    const int lim = (clipTips ? 1 : 0);
+    GFA_Parser::GFA_line r = graph.read(graph_file_id, new_file_opened, true);
 
-    int nb_pred, nb_succ;
+    if (nb_threads == 1){
 
-    Kmer km;
+        while ((r.first != nullptr) || (r.second != nullptr)){
 
-    Unitig<U>* unitig = nullptr;
+            if (r.first != nullptr) addUnitig(r.first->seq, (r.first->seq.length() == k_) ? km_unitigs.size() : v_unitigs.size());
 
-    for (j = 0; j < v_unitigs_sz; ++j) {
+            r = graph.read(graph_file_id, new_file_opened, true);
+        }
+    }
+    else {
 
-        unitig = v_unitigs[j];
+        const size_t block_sz = 1024;
 
-        if (unitig->numKmers() < k_){
+        std::atomic<size_t> v_kmers_sz;
+        std::atomic<size_t> v_unitigs_sz;
 
-            const Kmer head(unitig->getSeq().getKmer(0));
+        bool is_first = true;
+        bool stop = false;
 
-            nb_pred = 0;
+        SpinLock lck_unitig, lck_kmer;
 
-            for (i = 0; (i != 4) && (nb_pred <= lim); ++i) {
+        vector<thread> workers; // need to keep track of threads so we can join them
 
-                if (!find(head.backwardBase(alpha[i]), true).isEmpty){
+        mutex mutex_file;
 
-                    ++nb_pred;
-                    if (clipTips) km = head.backwardBase(alpha[i]);
-                }
-            }
+        v_kmers_sz = 0;
+        v_unitigs_sz = 0;
 
-            if (nb_pred <= lim){
+        hmap_min_unitigs.init_threads();
 
-                const Kmer tail(unitig->getSeq().getKmer(unitig->length() - k_));
+        for (size_t t = 0; t < nb_threads; ++t){
 
-                nb_succ = 0;
+            workers.emplace_back(
 
-                for (i = 0; (i != 4) && (nb_succ <= lim); ++i) {
+                [&]{
 
-                    if (!find(tail.forwardBase(alpha[i]), true).isEmpty){
+                    vector<string> seq;
 
-                        ++nb_succ;
-                        if (clipTips) km = tail.forwardBase(alpha[i]);
-                    }
-                }
+                    while (true) {
 
-                if ((rm_and_clip && ((nb_pred + nb_succ) <= lim)) || (!rm_and_clip && ((nb_pred + nb_succ) == lim))) { //Unitig is isolated
+                        {
+                            unique_lock<mutex> lock(mutex_file);
+
+                            if (stop) return;
+
+                            seq.clear();
+
+                            for (size_t i = 0; (i < block_sz) && !stop; ++i){
 
-                    ++removed;
-                    --v_unitigs_sz;
+                                if (!is_first) r = graph.read(graph_file_id, new_file_opened, true);
+                                if (r.first != nullptr) seq.push_back(r.first->seq);
 
-                    if (j != v_unitigs_sz){
+                                stop = ((r.first == nullptr) && (r.second == nullptr));
+                                is_first = false;
+                            }
+                        }
 
-                        swapUnitigs(false, j, v_unitigs_sz),
-                        --j;
+                        for (const auto& s : seq) addUnitig(s, (s.length() == k_) ? v_kmers_sz++ : v_unitigs_sz++, lck_unitig, lck_kmer);
                     }
-
-                    if (clipTips && ((nb_pred + nb_succ) == lim)) v.push_back(km);
                 }
-            }
+            );
         }
-    }
 
-    for (j = 0; j < v_kmers_sz; ++j) {
+        for (auto& t : workers) t.join();
 
-        const Kmer km_unitig = km_unitigs.getKmer(j);
+        hmap_min_unitigs.release_threads();
+        moveToAbundant();
+    }
+}
 
-        nb_pred = 0;
+template<typename U, typename G>
+void CompactedDBG<U, G>::readFASTA(const string& graphfilename, const size_t nb_threads) {
 
-        for (i = 0; (i != 4) && (nb_pred <= lim); ++i) {
+    size_t graph_file_id = 0;
 
-            if (!find(km_unitig.backwardBase(alpha[i]), true).isEmpty){
+    FastqFile ff(vector<string>(1, graphfilename));
 
-                ++nb_pred;
+    string seq;
 
-                if (clipTips) km = km_unitig.backwardBase(alpha[i]);
-            }
-        }
+    if (nb_threads == 1){
 
-        if (nb_pred <= lim){
+        while (ff.read_next(seq, graph_file_id) != -1) addUnitig(seq, (seq.length() == k_) ? km_unitigs.size() : v_unitigs.size());
+    }
+    else {
 
-            nb_succ = 0;
+        const size_t block_sz = 1024;
 
-            for (i = 0; (i != 4) && (nb_succ <= lim); ++i) {
+        bool stop = false;
 
-                if (!find(km_unitig.forwardBase(alpha[i]), true).isEmpty){
+        std::atomic<size_t> v_kmers_sz;
+        std::atomic<size_t> v_unitigs_sz;
 
-                    ++nb_succ;
+        SpinLock lck_unitig, lck_kmer;
 
-                    if (clipTips) km = km_unitig.forwardBase(alpha[i]);
-                }
-            }
+        vector<thread> workers; // need to keep track of threads so we can join them
 
-            if ((rm_and_clip && ((nb_pred + nb_succ) <= lim)) || (!rm_and_clip && ((nb_pred + nb_succ) == lim))) { //Unitig is isolated
+        mutex mutex_file;
 
-                ++removed;
-                --v_kmers_sz;
+        v_kmers_sz = 0;
+        v_unitigs_sz = 0;
 
-                if (j != v_kmers_sz){
+        hmap_min_unitigs.init_threads();
 
-                    swapUnitigs(true, j, v_kmers_sz),
-                    --j;
-                }
+        for (size_t t = 0; t < nb_threads; ++t){
 
-                if (clipTips && ((nb_pred + nb_succ) == lim)) v.push_back(km);
-            }
-        }
-    }
+            workers.emplace_back(
 
-    for (typename h_kmers_ccov_t::iterator it = h_kmers_ccov.begin(); it != h_kmers_ccov.end(); ++it) {
+                [&]{
 
-        nb_pred = 0;
+                    vector<string> v_seq;
 
-        for (i = 0; (i != 4) && (nb_pred <= lim); ++i) {
+                    while (true) {
 
-            if (!find(it.getKey().backwardBase(alpha[i]), true).isEmpty){
+                        {
+                            unique_lock<mutex> lock(mutex_file);
 
-                ++nb_pred;
-                if (clipTips) km = it.getKey().backwardBase(alpha[i]);
-            }
-        }
+                            if (stop) return;
 
-        if (nb_pred <= lim){
+                            v_seq.clear();
 
-            nb_succ = 0;
+                            for (size_t i = 0; (i < block_sz) && !stop; ++i){
 
-            for (i = 0; (i != 4) && (nb_succ <= lim); ++i) {
+                                stop = (ff.read_next(seq, graph_file_id) == -1);
 
-                if (!find(it.getKey().forwardBase(alpha[i]), true).isEmpty){
+                                if (!stop && !seq.empty()) v_seq.push_back(seq);
+                            }
+                        }
 
-                    ++nb_succ;
-                    if (clipTips) km = it.getKey().forwardBase(alpha[i]);
+                        for (const auto& s : v_seq) addUnitig(s, (s.length() == k_) ? v_kmers_sz++ : v_unitigs_sz++, lck_unitig, lck_kmer);
+                    }
                 }
-            }
-
-            if ((rm_and_clip && ((nb_pred + nb_succ) <= lim)) || (!rm_and_clip && ((nb_pred + nb_succ) == lim))){
-
-                ++removed;
-
-                *it = CompressedCoverage_t<U>();
-
-                if (clipTips && ((nb_pred + nb_succ) == lim)) v.push_back(km);
-            }
+            );
         }
-    }
 
-    for (j = v_unitigs_sz; j < v_unitigs.size(); ++j) deleteUnitig_<is_void<U>::value>(false, false, j);
-    v_unitigs.resize(v_unitigs_sz);
+        for (auto& t : workers) t.join();
 
-    for (j = v_kmers_sz; j < km_unitigs.size(); ++j) deleteUnitig_<is_void<U>::value>(true, false, j);
-    km_unitigs.resize(v_kmers_sz);
+        hmap_min_unitigs.release_threads();
+        moveToAbundant();
+    }
+}
 
-    for (typename h_kmers_ccov_t::iterator it = h_kmers_ccov.begin(); it != h_kmers_ccov.end(); ++it){
+template<typename U, typename G>
+void CompactedDBG<U, G>::mapRead(const const_UnitigMap<U, G>& um) {
 
-        if (it->ccov.size() == 0) deleteUnitig_<is_void<U>::value>(false, true, it.getHash());
-    }
+    if (um.isEmpty) return; // nothing maps, move on
 
-    return removed;
+    if (um.isShort) km_unitigs.cover(um.pos_unitig);
+    else if (um.isAbundant) h_kmers_ccov.find(um.pos_unitig)->ccov.cover(um.dist, um.dist + um.len - 1);
+    else v_unitigs[um.pos_unitig]->getCov().cover(um.dist, um.dist + um.len - 1);
 }
 
 template<typename U, typename G>
-void CompactedDBG<U, G>::writeFASTA(const string& graphfilename) const {
-
-    const size_t v_unitigs_sz = v_unitigs.size();
-    const size_t v_kmers_sz = km_unitigs.size();
+void CompactedDBG<U, G>::mapRead(const const_UnitigMap<U, G>& um, LockGraph& lck_g) {
 
-    size_t i = 0;
+    if (um.isEmpty) return; // nothing maps, move on
 
-    ofstream graphfile;
-    ostream graph(0);
+    if (um.isShort) km_unitigs.cover_thread_safe(um.pos_unitig);
+    else {
 
-    graphfile.open(graphfilename.c_str());
-    graph.rdbuf(graphfile.rdbuf());
-    //graph.sync_with_stdio(false);
+        size_t lock_unitig_id = um.pos_unitig;
 
-    assert(!graphfile.fail());
+        lock_unitig_id += v_unitigs.size() & (static_cast<size_t>(!um.isShort) - 1);
+        lock_unitig_id += (v_unitigs.size() + km_unitigs.size()) & (static_cast<size_t>(!um.isAbundant) - 1);
 
-    for (size_t j = 0; j < v_unitigs_sz; ++j, ++i) graph << ">" << i << "\n" << v_unitigs[j]->getSeq().toString() << "\n";
-    for (size_t j = 0; j < v_kmers_sz; ++j, ++i) graph << ">" << i << "\n" << km_unitigs.getKmer(j).toString() << "\n";
+        lck_g.lock_unitig(lock_unitig_id);
 
-    for (typename h_kmers_ccov_t::const_iterator it = h_kmers_ccov.begin(); it != h_kmers_ccov.end(); ++it, ++i) {
+        if (um.isAbundant) h_kmers_ccov.find(um.pos_unitig)->ccov.cover(um.dist, um.dist + um.len - 1);
+        else v_unitigs[um.pos_unitig]->getCov().cover(um.dist, um.dist + um.len - 1);
 
-        graph << ">" << i << "\n" << it.getKey().toString() << "\n";
+        lck_g.unlock_unitig(lock_unitig_id);
     }
+}
 
-    graphfile.close();
+template<typename U, typename G>
+void CompactedDBG<U, G>::unmapRead(const const_UnitigMap<U, G>& um) {
+
+    if (um.isEmpty) return; // nothing maps, move on
+
+    if (um.isShort) km_unitigs.uncover(um.pos_unitig);
+    else if (um.isAbundant) h_kmers_ccov.find(um.pos_unitig)->ccov.uncover(um.dist, um.dist + um.len - 1);
+    else v_unitigs[um.pos_unitig]->getCov().uncover(um.dist, um.dist + um.len - 1);
 }
 
 template<typename U, typename G>
-template<bool is_void>
-typename std::enable_if<!is_void, void>::type CompactedDBG<U, G>::writeGFA_sequence_(GFA_Parser& graph, KmerHashTable<size_t>& idmap) const {
+void CompactedDBG<U, G>::unmapRead(const const_UnitigMap<U, G>& um, LockGraph& lck_g) {
 
-    size_t labelA = 1;
+    if (um.isEmpty) return; // nothing maps, move on
 
-    for (const auto& unitig : *this){
+    if (um.isShort) km_unitigs.uncover_thread_safe(um.pos_unitig);
+    else {
 
-        const string seq(unitig.referenceUnitigToString());
+        size_t lock_unitig_id = um.pos_unitig;
 
-        graph.write_sequence(std::to_string(labelA), seq.size(), seq, unitig.getData()->serialize(unitig));
+        lock_unitig_id += v_unitigs.size() & (static_cast<size_t>(!um.isShort) - 1);
+        lock_unitig_id += (v_unitigs.size() + km_unitigs.size()) & (static_cast<size_t>(!um.isAbundant) - 1);
 
-        if (unitig.isAbundant) idmap.insert(Kmer(unitig.referenceUnitigToString().c_str()), labelA);
+        lck_g.lock_unitig(lock_unitig_id);
 
-        ++labelA;
+        if (um.isAbundant) h_kmers_ccov.find(um.pos_unitig)->ccov.uncover(um.dist, um.dist + um.len - 1);
+        else v_unitigs[um.pos_unitig]->getCov().uncover(um.dist, um.dist + um.len - 1);
+
+        lck_g.unlock_unitig(lock_unitig_id);
     }
 }
 
 template<typename U, typename G>
-template<bool is_void>
-typename std::enable_if<is_void, void>::type CompactedDBG<U, G>::writeGFA_sequence_(GFA_Parser& graph, KmerHashTable<size_t>& idmap) const {
+vector<Kmer> CompactedDBG<U, G>::extractMercyKmers(BlockedBloomFilter& bf_uniq_km, const size_t nb_threads, const bool verbose) {
 
-    size_t labelA = 1;
+    const size_t v_unitigs_sz = v_unitigs.size();
+    const size_t v_kmers_sz = km_unitigs.size();
 
-    for (const auto& unitig : *this){
+    size_t i, j;
 
-        const string seq(unitig.referenceUnitigToString());
+    KmerHashTable<uint8_t> tips;
 
-        graph.write_sequence(std::to_string(labelA), seq.size(), seq, "");
+    vector<Kmer> v_out;
 
-        if (unitig.isAbundant) idmap.insert(Kmer(unitig.referenceUnitigToString().c_str()), labelA);
+    for (typename h_kmers_ccov_t::iterator it_ccov = h_kmers_ccov.begin(); it_ccov != h_kmers_ccov.end(); ++it_ccov) {
 
-        ++labelA;
-    }
-}
+        const Kmer km = it_ccov.getKey().rep();
 
-template<typename U, typename G>
-void CompactedDBG<U, G>::writeGFA(const string& graphfilename, const size_t nb_threads) const {
+        vector<UnitigMap<U, G>> v_um = findPredecessors(km, true);
 
-    const size_t v_unitigs_sz = v_unitigs.size();
-    const size_t v_kmers_sz = km_unitigs.size();
+        for (i = 0; (i != 4) && v_um[i].isEmpty; ++i){}
 
-    size_t labelA, labelB, id = v_unitigs_sz + v_kmers_sz + 1;
+        v_um = findSuccessors(km, true);
 
-    const string header_tag("BV:Z:" + string(BFG_VERSION) + "\t" + "KL:Z:" + to_string(k_) + "\t" + "ML:Z:" + to_string(g_));
+        for (j = 0; (j != 4) && v_um[j].isEmpty; ++j){}
 
-    KmerHashTable<size_t> idmap(h_kmers_ccov.size());
+        if ((i == 4) && (j == 4)) tips.insert(km, 3);
+        else if (j == 4) tips.insert(km, 2);
+        else if (i == 4) tips.insert(km, 1);
+    }
 
-    GFA_Parser graph(graphfilename);
+    for (size_t it_v_km = 0; it_v_km != v_kmers_sz; ++it_v_km) {
 
-    graph.open_write(1, header_tag);
+        const Kmer km = km_unitigs.getKmer(it_v_km).rep();
 
-    writeGFA_sequence_<is_void<U>::value>(graph, idmap);
+        vector<UnitigMap<U, G>> v_um = findPredecessors(km, true);
 
-    if (nb_threads == 1){
+        for (i = 0; (i != 4) && v_um[i].isEmpty; ++i){}
 
-        for (labelA = 1; labelA <= v_unitigs_sz; labelA++) {
+        v_um = findSuccessors(km, true);
 
-            const Unitig<U>* unitig = v_unitigs[labelA - 1];
-            const Kmer head = unitig->getSeq().getKmer(0);
-            const Kmer tail = unitig->getSeq().getKmer(unitig->length() - k_);
+        for (j = 0; (j != 4) && v_um[j].isEmpty; ++j){}
 
-            const vector<const_UnitigMap<U, G>> pred = findPredecessors(head, true);
-            const vector<const_UnitigMap<U, G>> succ = findSuccessors(tail, 4, true);
+        if ((i == 4) && (j == 4)) tips.insert(km, 3);
+        else if (j == 4) tips.insert(km, 2);
+        else if (i == 4) tips.insert(km, 1);
+    }
 
-            for (const auto& unitig : pred){
+    for (size_t it_v_unitig = 0; it_v_unitig != v_unitigs_sz; ++it_v_unitig) {
 
-                if (!unitig.isEmpty){
+        const CompressedSequence& seq = v_unitigs[it_v_unitig]->getSeq();
 
-                    if (unitig.isAbundant) labelB = *(idmap.find(unitig.getUnitigHead().rep()));
-                    else labelB = unitig.pos_unitig + 1 + ((static_cast<size_t>(!unitig.isShort) - 1) & v_unitigs_sz);
+        const Kmer head = seq.getKmer(0);
+        const Kmer tail = seq.getKmer(seq.size() - k_);
 
-                    const string slabelA = std::to_string(labelA);
-                    const string slabelB = std::to_string(labelB);
+        vector<UnitigMap<U, G>> v_um = findPredecessors(head, true);
 
-                    const size_t pos = (static_cast<size_t>(unitig.strand) - 1) & (unitig.size - k_ + 1);
+        for (i = 0; (i != 4) && v_um[i].isEmpty; ++i){}
 
-                    graph.write_edge(slabelA, 0, k_-1, false, slabelB, pos, pos + k_ - 1, !unitig.strand);
-                }
-            }
+        if (i == 4){
+
+            const Kmer head_rep = head.rep();
 
-            for (const auto& unitig : succ){
+            if (head == head_rep) tips.insert(head, 1);
+            else tips.insert(head_rep, 2);
+        }
 
-                if (!unitig.isEmpty){
+        v_um = findSuccessors(tail, true);
 
-                    if (unitig.isAbundant) labelB = *(idmap.find(unitig.getUnitigHead().rep()));
-                    else labelB = unitig.pos_unitig + 1 + ((static_cast<size_t>(!unitig.isShort) - 1) & v_unitigs_sz);
+        for (i = 0; (i != 4) && v_um[i].isEmpty; ++i){}
 
-                    const string slabelA = std::to_string(labelA);
-                    const string slabelB = std::to_string(labelB);
+        if (i == 4){
 
-                    const size_t pos = (static_cast<size_t>(unitig.strand) - 1) & (unitig.size - k_ + 1);
+            const Kmer tail_rep = tail.rep();
 
-                    graph.write_edge(slabelA, unitig.size - k_ + 1, unitig.size, true, slabelB, pos, pos + k_ - 1, unitig.strand);
-                }
-            }
+            if (tail == tail_rep) tips.insert(tail, 2);
+            else tips.insert(tail_rep, 1);
         }
+    }
 
-        for (labelA = v_unitigs_sz + 1; labelA <= v_kmers_sz + v_unitigs_sz; labelA++) {
+    for (typename KmerHashTable<uint8_t>::iterator it_a = tips.begin(); it_a != tips.end(); ++it_a) {
 
-            const Kmer km_unitig = km_unitigs.getKmer(labelA - v_unitigs_sz - 1);
+        if ((*it_a == 1) || (*it_a == 3)){ // Corresponding k-mer has no predecessor in the graph
 
-            const vector<const_UnitigMap<U, G>> pred = findPredecessors(km_unitig, true);
-            const vector<const_UnitigMap<U, G>> succ = findSuccessors(km_unitig, 4, true);
+            bool pres_neigh_bw[4] = {false, false, false, false};
+            uint64_t hashes_bw[4];
 
-            for (const auto& unitig : pred){
+            const Kmer km_a = it_a.getKey();
 
-                if (!unitig.isEmpty){
+            RepHash rep_h(k_), rep_h_cpy;
 
-                    if (unitig.isAbundant) labelB = *(idmap.find(unitig.getUnitigHead().rep()));
-                    else labelB = unitig.pos_unitig + 1 + ((static_cast<size_t>(!unitig.isShort) - 1) & v_unitigs_sz);
+            rep_h.initCodes([&](const size_t pos){ return km_a.getCode(pos); });
 
-                    const string slabelA = std::to_string(labelA);
-                    const string slabelB = std::to_string(labelB);
+            for (i = 0; i != 4; ++i) {
 
-                    const size_t pos = (static_cast<size_t>(unitig.strand) - 1) & (unitig.size - k_ + 1);
+                rep_h_cpy = rep_h;
+                rep_h_cpy.updateBWCodes(km_a.getCode(k_ - 1), i);
 
-                    graph.write_edge(slabelA, 0, k_-1, false, slabelB, pos, pos + k_ - 1, !unitig.strand);
-                }
+                hashes_bw[i] = rep_h_cpy.hash(); // Prepare the hash of its predecessor
             }
 
-            for (const auto& unitig : succ){
-
-                if (!unitig.isEmpty){
-
-                    if (unitig.isAbundant) labelB = *(idmap.find(unitig.getUnitigHead().rep()));
-                    else labelB = unitig.pos_unitig + 1 + ((static_cast<size_t>(!unitig.isShort) - 1) & v_unitigs_sz);
+            // Query the MBBF for all possible predecessors
+            bf_uniq_km.contains(hashes_bw, minHashKmer<MinimizerOrderHash>::getBackwardNeighborHash(km_a, k_, g_), pres_neigh_bw, 4);
 
-                    const string slabelA = std::to_string(labelA);
-                    const string slabelB = std::to_string(labelB);
+            for (i = 0; i != 4; ++i) {
 
-                    const size_t pos = (static_cast<size_t>(unitig.strand) - 1) & (unitig.size - k_ + 1);
+                if (pres_neigh_bw[i]){ // A potential mercy k-mer has been found
 
-                    graph.write_edge(slabelA, unitig.size - k_ + 1, unitig.size, true, slabelB, pos, pos + k_ - 1, unitig.strand);
-                }
-            }
-        }
+                    const Kmer km_mercy = km_a.backwardBase(alpha[i]);
 
-        for (KmerHashTable<size_t>::iterator it = idmap.begin(); it != idmap.end(); it++) {
+                    for (j = 0; j != 4; ++j) {
 
-            labelA = *it;
+                        const Kmer km_b = km_mercy.backwardBase(alpha[j]); // Possible predecessor of this mercy k-mer
+                        const Kmer km_b_rep = km_b.rep();
 
-            const vector<const_UnitigMap<U, G>> pred = findPredecessors(it.getKey(), true);
-            const vector<const_UnitigMap<U, G>> succ = findSuccessors(it.getKey(), 4, true);
+                        typename KmerHashTable<uint8_t>::iterator it_b = tips.find(km_b_rep); // Query the tips with predecessor
 
-            for (const auto& unitig : pred){
+                        if (it_b != tips.end()){ // Possible predecessor of this mercy k-mer exists
 
-                if (!unitig.isEmpty){
+                            if ((km_b == km_b_rep) && ((*it_b == 2) || (*it_b == 3))){
 
-                    if (unitig.isAbundant) labelB = *(idmap.find(unitig.getUnitigHead().rep()));
-                    else labelB = unitig.pos_unitig + 1 + ((static_cast<size_t>(!unitig.isShort) - 1) & v_unitigs_sz);
+                                // Those tips can't be use anymore in these directions
+                                *it_b = (*it_b == 2 ? 0 : 1);
+                                *it_a = (*it_a == 1 ? 0 : 2);
+                                i = 3; j = 3; // Break the loops
 
-                    const string slabelA = std::to_string(labelA);
-                    const string slabelB = std::to_string(labelB);
+                                v_out.push_back(km_mercy); //Push the mercy k-mer found
+                            }
+                            else if ((km_b != km_b_rep) && ((*it_b == 1) || (*it_b == 3))){
 
-                    const size_t pos = (static_cast<size_t>(unitig.strand) - 1) & (unitig.size - k_ + 1);
+                                // Those tips can't be use anymore in these directions
+                                *it_b = (*it_b == 1 ? 0 : 2);
+                                *it_a = (*it_a == 1 ? 0 : 2);
+                                i = 3; j = 3; // Break the loops
 
-                    graph.write_edge(slabelA, 0, k_-1, false, slabelB, pos, pos + k_ - 1, !unitig.strand);
+                                v_out.push_back(km_mercy);  //Push the mercy k-mer found
+                            }
+                        }
+                    }
                 }
             }
+        }
 
-            for (const auto& unitig : succ){
+        if ((*it_a == 2) || (*it_a == 3)){ // Corresponding k-mer has no successor in the graph
 
-                if (!unitig.isEmpty){
+            bool pres_neigh_fw[4] = {false, false, false, false};
+            uint64_t hashes_fw[4];
 
-                    if (unitig.isAbundant) labelB = *(idmap.find(unitig.getUnitigHead().rep()));
-                    else labelB = unitig.pos_unitig + 1 + ((static_cast<size_t>(!unitig.isShort) - 1) & v_unitigs_sz);
+            const Kmer km_a = it_a.getKey();
 
-                    const string slabelA = std::to_string(labelA);
-                    const string slabelB = std::to_string(labelB);
+            RepHash rep_h(k_), rep_h_cpy; // Prepare its hash
 
-                    const size_t pos = (static_cast<size_t>(unitig.strand) - 1) & (unitig.size - k_ + 1);
+            rep_h.initCodes([&](const size_t pos){ return km_a.getCode(pos); });
 
-                    graph.write_edge(slabelA, unitig.size - k_ + 1, unitig.size, true, slabelB, pos, pos + k_ - 1, unitig.strand);
-                }
-            }
-        }
-    }
-    else {
+            for (i = 0; i != 4; ++i) {
 
-        const size_t chunk_size = 1024;
+                rep_h_cpy = rep_h;
+                rep_h_cpy.updateFWCodes(km_a.getCode(0), i);
 
-        auto worker_v_unitigs = [v_unitigs_sz, &idmap, this](const size_t labelA_start, const size_t labelA_end,
-                                                             vector<pair<pair<size_t, bool>, pair<size_t, bool>>>* v_out){
+                hashes_fw[i] = rep_h_cpy.hash(); // Prepare the hash of its successor
+            }
 
-            // We need to deal with the tail of long unitigs
-            for (size_t labelA = labelA_start; labelA < labelA_end; ++labelA) {
+            // Query the MBBF for all possible predecessors
+            bf_uniq_km.contains(hashes_fw, minHashKmer<MinimizerOrderHash>::getForwardNeighborHash(km_a, k_, g_), pres_neigh_fw, 4);
 
-                const Unitig<U>* unitig = v_unitigs[labelA - 1];
+            for (i = 0; i != 4; ++i) {
 
-                const Kmer head = unitig->getSeq().getKmer(0);
-                const Kmer tail = unitig->getSeq().getKmer(unitig->length() - k_);
+                if (pres_neigh_fw[i]){ // A potential mercy k-mer has been found
 
-                const vector<const_UnitigMap<U, G>> pred = this->findPredecessors(head, true);
-                const vector<const_UnitigMap<U, G>> succ = this->findSuccessors(tail, 4, true);
+                    const Kmer km_mercy = km_a.forwardBase(alpha[i]);
 
-                for (const auto& um : pred) {
+                    for (j = 0; j != 4; ++j) {
 
-                    if (!um.isEmpty){
+                        const Kmer km_b = km_mercy.forwardBase(alpha[j]); // Possible successor of this mercy k-mer
+                        const Kmer km_b_rep = km_b.rep();
 
-                        const size_t labelB = (um.isAbundant ?  *(idmap.find(um.getUnitigHead().rep())) :
-                                                                um.pos_unitig + 1 + ((static_cast<size_t>(!um.isShort) - 1) & v_unitigs_sz));
+                        typename KmerHashTable<uint8_t>::iterator it_b = tips.find(km_b_rep); // Query the tips with successor
 
-                        v_out->push_back(make_pair(make_pair(labelA, false), make_pair(labelB, !um.strand)));
-                    }
-                }
+                        if (it_b != tips.end()){ // Possible successor of this mercy k-mer exists
 
-                for (const auto& um : succ) {
+                            if ((km_b == km_b_rep) && ((*it_b == 1) || (*it_b == 3))){
 
-                    if (!um.isEmpty){
+                                // Those tips can't be use anymore in these directions
+                                *it_b = (*it_b == 1 ? 0 : 2);
+                                *it_a = (*it_a == 2 ? 0 : 1);
+                                i = 3; j = 3; // Break the loops
 
-                        const size_t labelB = (um.isAbundant ?  *(idmap.find(um.getUnitigHead().rep())) :
-                                                                um.pos_unitig + 1 + ((static_cast<size_t>(!um.isShort) - 1) & v_unitigs_sz));
+                                v_out.push_back(km_mercy); //Push the mercy k-mer found
+                            }
+                            else if ((km_b != km_b_rep) && ((*it_b == 2) || (*it_b == 3))){
 
-                        v_out->push_back(make_pair(make_pair(labelA, true), make_pair(labelB, um.strand)));
+                                // Those tips can't be use anymore in these directions
+                                *it_b = (*it_b == 2 ? 0 : 1);
+                                *it_a = (*it_a == 2 ? 0 : 1);
+                                i = 3; j = 3; // Break the loops
+
+                                v_out.push_back(km_mercy);  //Push the mercy k-mer found
+                            }
+                        }
                     }
                 }
             }
-        };
-
-        auto worker_v_kmers = [v_unitigs_sz, &idmap, this](const size_t labelA_start, const size_t labelA_end,
-                                                             vector<pair<pair<size_t, bool>, pair<size_t, bool>>>* v_out){
-
-            // We need to deal with the tail of long unitigs
-            for (size_t labelA = labelA_start; labelA < labelA_end; ++labelA) {
-
-                const Kmer km_unitig = km_unitigs.getKmer(labelA - v_unitigs_sz - 1);
-
-                const vector<const_UnitigMap<U, G>> pred = this->findPredecessors(km_unitig, true);
-                const vector<const_UnitigMap<U, G>> succ = this->findSuccessors(km_unitig, 4, true);
+        }
+    }
 
-                for (const auto& um : pred) {
+    if (verbose) cout << "CompactedDBG::extractMercyKmers(): " << v_out.size() << " k-mers extracted" << endl;
 
-                    if (!um.isEmpty){
+    return v_out;
+}
 
-                        const size_t labelB = (um.isAbundant ?  *(idmap.find(um.getUnitigHead().rep())) :
-                                                                um.pos_unitig + 1 + ((static_cast<size_t>(!um.isShort) - 1) & v_unitigs_sz));
+template<typename U, typename G>
+size_t CompactedDBG<U, G>::joinTips(string filename_MBBF_uniq_kmers, const size_t nb_threads, const bool verbose) {
 
-                        v_out->push_back(make_pair(make_pair(labelA, false), make_pair(labelB, !um.strand)));
-                    }
-                }
+    if (invalid){
 
-                for (const auto& um : succ) {
+        cerr << "CompactedDBG::joinTips(): Graph is invalid and tips cannot be joined" << endl;
+        return 0;
+    }
 
-                    if (!um.isEmpty){
+    BlockedBloomFilter mbbf;
 
-                        const size_t labelB = (um.isAbundant ?  *(idmap.find(um.getUnitigHead().rep())) :
-                                                                um.pos_unitig + 1 + ((static_cast<size_t>(!um.isShort) - 1) & v_unitigs_sz));
+    FILE* f_mbbf;
 
-                        v_out->push_back(make_pair(make_pair(labelA, true), make_pair(labelB, um.strand)));
-                    }
-                }
-            }
-        };
+    if ((f_mbbf = fopen(filename_MBBF_uniq_kmers.c_str(), "rb")) == NULL){
 
-        auto worker_v_abundant = [v_unitigs_sz, chunk_size, &idmap, this](  KmerHashTable<size_t>::iterator* l_it,
-                                                                            vector<pair<pair<size_t, bool>, pair<size_t, bool>>>* v_out){
+        cerr << "CompactedDBG::joinTips(): Minimizer Blocked Bloom filter file of unique k-mers cannot be opened" << endl;
+        return 0;
+    }
 
-            KmerHashTable<size_t>::iterator& it = *l_it;
+    mbbf.ReadBloomFilter(f_mbbf);
+    fclose(f_mbbf);
 
-            // We need to deal with the tail of long unitigs
-            for (size_t i = 0; (it != idmap.end()) && (i < chunk_size); ++i, ++it) {
+    return joinTips(mbbf, nb_threads, verbose);
+}
 
-                const vector<const_UnitigMap<U, G>> pred = this->findPredecessors(it.getKey(), true);
-                const vector<const_UnitigMap<U, G>> succ = this->findSuccessors(it.getKey(), 4, true);
+// Insert the mercy k-mers found with the Blocked Bloom filter of unique k-mers bf_uniq_km (see CompactedDBG::extractMercyKmers())
+// and join the tips they connect
+template<typename U, typename G>
+size_t CompactedDBG<U, G>::joinTips(BlockedBloomFilter& bf_uniq_km, const size_t nb_threads, const bool verbose) {
 
-                for (const auto& um : pred) {
+    vector<Kmer> v_mercy_km = extractMercyKmers(bf_uniq_km, nb_threads, verbose);
 
-                    if (!um.isEmpty){
+    for (const auto& km_mercy : v_mercy_km) addUnitig(km_mercy.rep().toString(), km_unitigs.size());
 
-                        const size_t labelB = (um.isAbundant ?  *(idmap.find(um.getUnitigHead().rep())) :
-                                                                um.pos_unitig + 1 + ((static_cast<size_t>(!um.isShort) - 1) & v_unitigs_sz));
+    size_t nb_join = joinUnitigs_<is_void<U>::value>(&v_mercy_km, nb_threads);
 
-                        v_out->push_back(make_pair(make_pair(*it, false), make_pair(labelB, !um.strand)));
-                    }
-                }
+    if (verbose) cout << "CompactedDBG<U, G>::joinTips(): " << nb_join << " unitigs have been joined using mercy k-mers" << endl;
 
-                for (const auto& um : succ) {
+    return nb_join;
+}
 
-                    if (!um.isEmpty){
+template<typename U, typename G>
+void CompactedDBG<U, G>::setKmerGmerLength(const int kmer_length, const int minimizer_length){
 
-                        const size_t labelB = (um.isAbundant ?  *(idmap.find(um.getUnitigHead().rep())) :
-                                                                um.pos_unitig + 1 + ((static_cast<size_t>(!um.isShort) - 1) & v_unitigs_sz));
+    invalid = false;
 
-                        v_out->push_back(make_pair(make_pair(*it, true), make_pair(labelB, um.strand)));
-                    }
-                }
-            }
-        };
+    if (kmer_length <= 2){
 
-        {
-            atomic<size_t> label(1);
+        cerr << "CompactedDBG::CompactedDBG(): Length k of k-mers cannot be less than 3" << endl;
+        invalid = true;
+    }
 
-            vector<vector<pair<pair<size_t, bool>, pair<size_t, bool>>>> v_out(nb_threads);
-            vector<thread> workers; // need to keep track of threads so we can join them
+    if (kmer_length >= MAX_KMER_SIZE){
 
-            mutex mutex_file;
+        cerr << "CompactedDBG::CompactedDBG(): Length k of k-mers cannot exceed or be equal to " << MAX_KMER_SIZE << endl;
+        invalid = true;
+    }
 
-            for (size_t t = 0; t < nb_threads; ++t){
+    if (minimizer_length == 0){
 
-                workers.emplace_back(
+        cerr << "CompactedDBG::CompactedDBG(): Length g of minimizers cannot be equal to 0" << endl;
+        invalid = true;
+    }
 
-                    [&, t]{
+    if (minimizer_length >= MAX_GMER_SIZE){
 
-                        while (true) {
+        cerr << "CompactedDBG::CompactedDBG(): Length g of minimizers cannot exceed or be equal to " << MAX_KMER_SIZE << endl;
+        invalid = true;
+    }
 
-                            const size_t old_labelA = label.fetch_add(chunk_size);
+    if ((minimizer_length > 0) && (minimizer_length > kmer_length - 2)){
 
-                            if (old_labelA <= v_unitigs_sz){
+        cerr << "CompactedDBG::CompactedDBG(): Length g of minimizers cannot exceed k - 2" << endl;
+        invalid = true;
+    }
 
-                                if (old_labelA + chunk_size <= v_unitigs_sz) worker_v_unitigs(old_labelA, old_labelA + chunk_size, &v_out[t]);
-                                else worker_v_unitigs(old_labelA, v_unitigs_sz + 1, &v_out[t]);
+    if (!invalid){
 
-                                {
-                                    unique_lock<mutex> lock(mutex_file);
+        k_ = kmer_length;
 
-                                    for (const auto& p : v_out[t]){
+        if (minimizer_length >= 0) g_ = minimizer_length;
+        else if (kmer_length >= 15) g_ = k_ - DEFAULT_G_DEC1;
+        else if (kmer_length >= 7) g_ = k_ - DEFAULT_G_DEC2;
+        else g_ = k_ - 2;
 
-                                        const string slabelA = std::to_string(p.first.first);
-                                        const string slabelB = std::to_string(p.second.first);
+        Kmer::set_k(k_);
+        Minimizer::set_g(g_);
+    }
+}
 
-                                        graph.write_edge(slabelA, 0, k_-1, p.first.second, slabelB, 0, k_-1, p.second.second);
-                                    }
-                                }
+template<typename U, typename G>
+bool CompactedDBG<U, G>::setSparseIndex(const bool sparse){
 
-                                v_out[t].clear();
-                            }
-                            else return;
-                        }
-                    }
-                );
-            }
+    if (size() != 0){
 
-            for (auto& t : workers) t.join();
-        }
+        cerr << "CompactedDBG::setSparseIndex(): The minimizer index mode cannot be changed once the graph contains unitigs" << endl;
+        return false;
+    }
 
-        {
-            const size_t v_kmers_unitigs_sz = v_kmers_sz + v_unitigs_sz;
+    sparse_index = sparse;
 
-            atomic<size_t> label(v_unitigs_sz + 1);
+    return true;
+}
 
-            vector<vector<pair<pair<size_t, bool>, pair<size_t, bool>>>> v_out(nb_threads);
-            vector<thread> workers; // need to keep track of threads so we can join them
+template<typename U, typename G>
+void CompactedDBG<U, G>::indexOvercrowdedKmers(const size_t nb_threads){
 
-            mutex mutex_file;
+    clearOvercrowdedKmers();
 
-            for (size_t t = 0; t < nb_threads; ++t){
+    if (invalid){
 
-                workers.emplace_back(
+        cerr << "CompactedDBG::indexOvercrowdedKmers(): Graph is invalid, its k-mers cannot be indexed" << endl;
+        return;
+    }
 
-                    [&, t]{
+    if (nb_threads == 0){
 
-                        while (true) {
+        cerr << "CompactedDBG::indexOvercrowdedKmers(): Number of threads cannot be less than or equal to 0" << endl;
+        return;
+    }
 
-                            const size_t old_labelA = label.fetch_add(chunk_size);
+    const size_t mask = MASK_CONTIG_ID | MASK_CONTIG_TYPE;
 
-                            if (old_labelA <= v_kmers_unitigs_sz){
+    const MinimizerIndex& hmap_min = hmap_min_unitigs;
 
-                                if (old_labelA + chunk_size <= v_kmers_unitigs_sz) worker_v_kmers(old_labelA, old_labelA + chunk_size, &v_out[t]);
-                                else worker_v_kmers(old_labelA, v_kmers_unitigs_sz + 1, &v_out[t]);
+    auto isOvercrowded = [&](const MinimizerIndex::const_iterator& it) {
 
-                                {
-                                    unique_lock<mutex> lock(mutex_file);
+        const packed_tiny_vector& v = it.getVector();
+        const uint8_t flag_v = it.getVectorSize();
+        const size_t v_sz = v.size(flag_v);
 
-                                    for (const auto& p : v_out[t]){
+        return (v_sz != 0) && ((v(v_sz - 1, flag_v) & mask) == mask);
+    };
 
-                                        const string slabelA = std::to_string(p.first.first);
-                                        const string slabelB = std::to_string(p.second.first);
+    bool has_overcrowded = false;
 
-                                        graph.write_edge(slabelA, 0, k_-1, p.first.second, slabelB, 0, k_-1, p.second.second);
-                                    }
-                                }
+    for (MinimizerIndex::const_iterator it = hmap_min.begin(), it_end = hmap_min.end(); !has_overcrowded && (it != it_end); ++it){
 
-                                v_out[t].clear();
-                            }
-                            else return;
-                        }
-                    }
-                );
-            }
+        has_overcrowded = isOvercrowded(it);
+    }
 
-            for (auto& t : workers) t.join();
-        }
+    if (has_overcrowded){
 
-        {
-            KmerHashTable<size_t>::iterator it = idmap.begin(), it_end = idmap.end();
+        vector<vector<pair<Kmer, uint64_t>>> v_km(nb_threads);
 
-            vector<vector<pair<pair<size_t, bool>, pair<size_t, bool>>>> v_out(nb_threads);
-            vector<thread> workers; // need to keep track of threads so we can join them
+        auto worker_function = [&](const size_t t){
 
-            mutex mutex_file, mutex_it;
+            for (size_t i = t; i < v_unitigs.size(); i += nb_threads){
 
-            for (size_t t = 0; t < nb_threads; ++t){
+                if (v_unitigs[i] == nullptr) continue;
 
-                workers.emplace_back(
+                const string str = v_unitigs[i]->getSeq().toString();
+                const char* s = str.c_str();
 
-                    [&, t]{
+                minHashIterator<MinimizerOrderHash> it_min(s, str.length(), k_, g_, MinimizerOrderHash(), true), it_min_end;
 
-                        KmerHashTable<size_t>::iterator l_it;
+                bool overcrowded = false;
 
-                        bool stop;
+                int pos_min = -1, nb_min = 0;
 
-                        while (true) {
+                for (; it_min != it_min_end; ++it_min){
 
-                            {
-                                unique_lock<mutex> lock(mutex_it);
+                    int nb = 0;
 
-                                l_it = it;
+                    for (minHashResultIterator<MinimizerOrderHash> it_it_min = *it_min, it_it_min_end; it_it_min != it_it_min_end; ++it_it_min) ++nb;
 
-                                for (size_t i = 0; (it != it_end) && (i < chunk_size); ++i, ++it){}
+                    // Minimizers leave the window from the leftmost one: same leftmost minimizer and count means same minimizers
+                    if ((it_min.getPosition() != pos_min) || (nb != nb_min)){
 
-                                stop = (l_it == it_end) && (it == it_end);
-                            }
+                        overcrowded = false;
+                        pos_min = it_min.getPosition();
+                        nb_min = nb;
 
-                            if (!stop){
+                        for (minHashResultIterator<MinimizerOrderHash> it_it_min = *it_min, it_it_min_end; !overcrowded && (it_it_min != it_it_min_end); ++it_it_min){
 
-                                worker_v_abundant(&l_it, &v_out[t]);
+                            const MinimizerIndex::const_iterator it = hmap_min.find(Minimizer(s + (*it_it_min).pos).rep());
 
-                                {
-                                    unique_lock<mutex> lock(mutex_file);
+                            overcrowded = (it != hmap_min.end()) && isOvercrowded(it);
+                        }
+                    }
 
-                                    for (const auto& p : v_out[t]){
+                    if (overcrowded){
 
-                                        const string slabelA = std::to_string(p.first.first);
-                                        const string slabelB = std::to_string(p.second.first);
+                        const size_t pos = it_min.getKmerPosition();
 
-                                        graph.write_edge(slabelA, 0, k_-1, p.first.second, slabelB, 0, k_-1, p.second.second);
-                                    }
-                                }
+                        const Kmer km(s + pos);
+                        const Kmer km_twin = km.twin();
 
-                                v_out[t].clear();
-                            }
-                            else return;
-                        }
+                        if (km_twin < km) v_km[t].push_back({km_twin, (i << 32) | MASK_CONTIG_TYPE | pos});
+                        else v_km[t].push_back({km, (i << 32) | pos});
                     }
-                );
+                }
             }
+        };
 
+        if (nb_threads == 1) worker_function(0);
+        else {
+
+            vector<thread> workers;
+
+            for (size_t t = 0; t < nb_threads; ++t) workers.emplace_back(worker_function, t);
             for (auto& t : workers) t.join();
         }
-    }
 
-    graph.close();
-}
+        size_t nb_km = 0;
 
-template<typename U, typename G>
-void CompactedDBG<U, G>::readGFA(const string& graphfilename, const size_t nb_threads) {
+        for (const auto& v : v_km) nb_km += v.size();
 
-    size_t graph_file_id = 0;
+        h_kmers_overcrowded = KmerHashTable<uint64_t>(nb_km);
 
-    bool new_file_opened = false;
+        for (auto& v : v_km){
 
-    GFA_Parser graph(graphfilename);
+            for (const auto& p : v) h_kmers_overcrowded.insert(p.first, p.second);
 
-    graph.open_read();
+            vector<pair<Kmer, uint64_t>>().swap(v);
+        }
+    }
+    else h_kmers_overcrowded = KmerHashTable<uint64_t>(0);
 
-    GFA_Parser::GFA_line r = graph.read(graph_file_id, new_file_opened, true);
+    overcrowded_kmers_indexed = true;
+}
 
-    if (nb_threads == 1){
+template<typename U, typename G>
+void CompactedDBG<U, G>::indexNeighbors(const size_t nb_threads){
 
-        while ((r.first != nullptr) || (r.second != nullptr)){
+    clearNeighbors();
 
-            if (r.first != nullptr) addUnitig(r.first->seq, (r.first->seq.length() == k_) ? km_unitigs.size() : v_unitigs.size());
+    if (invalid){
 
-            r = graph.read(graph_file_id, new_file_opened, true);
-        }
+        cerr << "CompactedDBG::indexNeighbors(): Graph is invalid, its neighbors cannot be indexed" << endl;
+        return;
     }
-    else {
 
-        const size_t block_sz = 1024;
+    if (nb_threads == 0){
 
-        std::atomic<size_t> v_kmers_sz;
-        std::atomic<size_t> v_unitigs_sz;
+        cerr << "CompactedDBG::indexNeighbors(): Number of threads cannot be less than or equal to 0" << endl;
+        return;
+    }
 
-        bool is_first = true;
-        bool stop = false;
+    const CompactedDBG<U, G>& cdbg = *this;
 
-        SpinLock lck_unitig, lck_kmer;
+    const size_t nb_long = v_unitigs.size();
+    const size_t nb_short = km_unitigs.size();
 
-        vector<thread> workers; // need to keep track of threads so we can join them
+    const size_t nb_rows = getNbNeighborRows();
 
-        mutex mutex_file;
+    v_neighbors_id = vector<uint32_t>(nb_rows * 8, 0);
+    v_neighbors_info = vector<uint32_t>(nb_rows, 0);
 
-        v_kmers_sz = 0;
-        v_unitigs_sz = 0;
+    auto worker_function = [&](const size_t t){
 
-        hmap_min_unitigs.init_threads();
+        for (size_t row = t; row < nb_rows; row += nb_threads){
 
-        for (size_t t = 0; t < nb_threads; ++t){
+            Kmer head, tail;
 
-            workers.emplace_back(
+            if (row < nb_long){
 
-                [&]{
+                if (v_unitigs[row] == nullptr) continue;
 
-                    vector<string> seq;
+                const CompressedSequence& seq = v_unitigs[row]->getSeq();
 
-                    while (true) {
+                head = seq.getKmer(0);
+                tail = seq.getKmer(seq.size() - k_);
+            }
+            else if (row < nb_long + nb_short) head = tail = km_unitigs.getKmer(row - nb_long);
+            else {
 
-                        {
-                            unique_lock<mutex> lock(mutex_file);
+                const typename h_kmers_ccov_t::const_iterator it = h_kmers_ccov.find(row - nb_long - nb_short);
 
-                            if (stop) return;
+                if (it == h_kmers_ccov.end()) continue;
 
-                            seq.clear();
+                head = tail = it.getKey();
+            }
 
-                            for (size_t i = 0; (i < block_sz) && !stop; ++i){
+            uint32_t info = 0;
 
-                                if (!is_first) r = graph.read(graph_file_id, new_file_opened, true);
-                                if (r.first != nullptr) seq.push_back(r.first->seq);
+            for (size_t i = 0; i < 8; ++i){
 
-                                stop = ((r.first == nullptr) && (r.second == nullptr));
-                                is_first = false;
-                            }
-                        }
+                const const_UnitigMap<U, G> um = cdbg.find((i < 4) ? head.backwardBase(alpha[i]) : tail.forwardBase(alpha[i - 4]), true);
 
-                        for (const auto& s : seq) addUnitig(s, (s.length() == k_) ? v_kmers_sz++ : v_unitigs_sz++, lck_unitig, lck_kmer);
-                    }
+                if (!um.isEmpty){
+
+                    const uint32_t type = um.isShort ? 2 : (um.isAbundant ? 3 : 1);
+
+                    v_neighbors_id[row * 8 + i] = um.pos_unitig;
+                    info |= (type | (static_cast<uint32_t>(um.strand) << 2)) << (i * 3);
                 }
-            );
+            }
+
+            v_neighbors_info[row] = info;
         }
+    };
 
-        for (auto& t : workers) t.join();
+    if (nb_threads == 1) worker_function(0);
+    else {
 
-        hmap_min_unitigs.release_threads();
-        moveToAbundant();
+        vector<thread> workers;
+
+        for (size_t t = 0; t < nb_threads; ++t) workers.emplace_back(worker_function, t);
+        for (auto& t : workers) t.join();
     }
+
+    neighbors_indexed = true;
 }
 
 template<typename U, typename G>
-void CompactedDBG<U, G>::readFASTA(const string& graphfilename, const size_t nb_threads) {
-
-    size_t graph_file_id = 0;
+const_UnitigMap<U, G> CompactedDBG<U, G>::getIndexedNeighbor(const size_t row, const bool strand, const bool is_forward, const int i) const {
 
-    FastqFile ff(vector<string>(1, graphfilename));
+    // On the reverse-complement of a unitig, the successors are the reverse-complemented predecessors and conversely
+    const size_t slot = strand ? (is_forward ? 4 + i : i) : (is_forward ? 3 - i : 7 - i);
+    const uint32_t info = (v_neighbors_info[row] >> (slot * 3)) & 0x7;
+    const uint32_t type = info & 0x3;
 
-    string seq;
+    if (type == 0) return const_UnitigMap<U, G>();
 
-    if (nb_threads == 1){
+    const size_t pos_unitig = v_neighbors_id[row * 8 + slot];
+    const size_t sz = (type == 1) ? v_unitigs[pos_unitig]->length() : k_;
 
-        while (ff.read_next(seq, graph_file_id) != -1) addUnitig(seq, (seq.length() == k_) ? km_unitigs.size() : v_unitigs.size());
-    }
-    else {
+    return const_UnitigMap<U, G>(pos_unitig, 0, sz - k_ + 1, sz, type == 2, type == 3, static_cast<bool>(info >> 2) == strand, this);
+}
 
-        const size_t block_sz = 1024;
+template<typename U, typename G>
+bool CompactedDBG<U, G>::getStats(CDBG_Stats& stats, const size_t nb_threads) const {
 
-        bool stop = false;
+    stats = CDBG_Stats();
 
-        std::atomic<size_t> v_kmers_sz;
-        std::atomic<size_t> v_unitigs_sz;
+    if (invalid){
 
-        SpinLock lck_unitig, lck_kmer;
+        cerr << "CompactedDBG::getStats(): Graph is invalid, statistics cannot be computed" << endl;
+        return false;
+    }
 
-        vector<thread> workers; // need to keep track of threads so we can join them
+    if (nb_threads == 0){
 
-        mutex mutex_file;
+        cerr << "CompactedDBG::getStats(): Number of threads cannot be less than or equal to 0" << endl;
+        return false;
+    }
 
-        v_kmers_sz = 0;
-        v_unitigs_sz = 0;
+    struct StatsAccumulator {
 
-        hmap_min_unitigs.init_threads();
+        size_t nb_unitigs, nb_kmers, total_length, min_length, max_length;
+        size_t nb_components, nb_isolated, nb_tips;
+        size_t degree_hist[5];
 
-        for (size_t t = 0; t < nb_threads; ++t){
+        unordered_map<size_t, size_t> length_count;
+        vector<pair<uint64_t, uint64_t>> bubble_keys; // (predecessor, successor) of unitigs with one predecessor and one successor
 
-            workers.emplace_back(
+        StatsAccumulator() :    nb_unitigs(0), nb_kmers(0), total_length(0), min_length(0xffffffffffffffffULL), max_length(0),
+                                nb_components(0), nb_isolated(0), nb_tips(0), degree_hist{0, 0, 0, 0, 0} {}
+    };
 
-                [&]{
+    const size_t nb_rows = getNbNeighborRows();
+    const vector<const_range> v_r = getUnitigRange().split(nb_threads * 16);
 
-                    vector<string> v_seq;
+    vector<StatsAccumulator> v_acc(nb_threads);
 
-                    while (true) {
+    // Union-find over the rows of the unitigs (see getNeighborRow()): parent[x] == x if x is a root
+    atomic<size_t>* parent = new atomic<size_t>[nb_rows];
 
-                        {
-                            unique_lock<mutex> lock(mutex_file);
+    for (size_t i = 0; i < nb_rows; ++i) parent[i] = i;
 
-                            if (stop) return;
+    auto findRoot = [&](size_t x){
 
-                            v_seq.clear();
+        size_t p = parent[x].load();
 
-                            for (size_t i = 0; (i < block_sz) && !stop; ++i){
+        while (p != x){
 
-                                stop = (ff.read_next(seq, graph_file_id) == -1);
+            const size_t gp = parent[p].load();
 
-                                if (!stop && !seq.empty()) v_seq.push_back(seq);
-                            }
-                        }
+            if (gp != p) parent[x].compare_exchange_weak(p, gp); // Path halving, fails harmlessly if another thread relinked x
 
-                        for (const auto& s : v_seq) addUnitig(s, (s.length() == k_) ? v_kmers_sz++ : v_unitigs_sz++, lck_unitig, lck_kmer);
-                    }
-                }
-            );
+            x = gp;
+            p = parent[x].load();
         }
 
-        for (auto& t : workers) t.join();
+        return x;
+    };
 
-        hmap_min_unitigs.release_threads();
-        moveToAbundant();
-    }
-}
+    auto unite = [&](size_t a, size_t b){
 
-template<typename U, typename G>
-void CompactedDBG<U, G>::mapRead(const const_UnitigMap<U, G>& um) {
+        while (true) {
+
+            a = findRoot(a);
+            b = findRoot(b);
+
+            if (a == b) return;
+            if (a < b) std::swap(a, b);
+
+            size_t expected = a;
 
-    if (um.isEmpty) return; // nothing maps, move on
+            // Link the larger root to the smaller one, retry if a is no longer a root
+            if (parent[a].compare_exchange_strong(expected, b)) return;
+        }
+    };
 
-    if (um.isShort) km_unitigs.cover(um.pos_unitig);
-    else if (um.isAbundant) h_kmers_ccov.find(um.pos_unitig)->ccov.cover(um.dist, um.dist + um.len - 1);
-    else v_unitigs[um.pos_unitig]->getCov().cover(um.dist, um.dist + um.len - 1);
-}
+    auto run = [&](const std::function<void(const const_UnitigMap<U, G>&, StatsAccumulator&)>& f){
 
-template<typename U, typename G>
-void CompactedDBG<U, G>::mapRead(const const_UnitigMap<U, G>& um, LockGraph& lck_g) {
+        atomic<size_t> next_r(0);
 
-    if (um.isEmpty) return; // nothing maps, move on
+        auto worker_function = [&](const size_t t){
 
-    if (um.isShort) km_unitigs.cover_thread_safe(um.pos_unitig);
-    else {
+            for (size_t i = next_r++; i < v_r.size(); i = next_r++){
 
-        size_t lock_unitig_id = um.pos_unitig;
+                for (const auto& um : v_r[i]) f(um, v_acc[t]);
+            }
+        };
 
-        lock_unitig_id += v_unitigs.size() & (static_cast<size_t>(!um.isShort) - 1);
-        lock_unitig_id += (v_unitigs.size() + km_unitigs.size()) & (static_cast<size_t>(!um.isAbundant) - 1);
+        if (nb_threads == 1) worker_function(0);
+        else {
 
-        lck_g.lock_unitig(lock_unitig_id);
+            vector<thread> workers;
 
-        if (um.isAbundant) h_kmers_ccov.find(um.pos_unitig)->ccov.cover(um.dist, um.dist + um.len - 1);
-        else v_unitigs[um.pos_unitig]->getCov().cover(um.dist, um.dist + um.len - 1);
+            for (size_t t = 0; t < nb_threads; ++t) workers.emplace_back(worker_function, t);
+            for (auto& t : workers) t.join();
+        }
+    };
 
-        lck_g.unlock_unitig(lock_unitig_id);
-    }
-}
+    // First pass: lengths and degrees, union of each unitig with its neighbors
+    run([&](const const_UnitigMap<U, G>& um, StatsAccumulator& acc){
 
-template<typename U, typename G>
-void CompactedDBG<U, G>::unmapRead(const const_UnitigMap<U, G>& um) {
+        const size_t row = getNeighborRow(um.pos_unitig, um.isShort, um.isAbundant);
+        const size_t nb_km = um.size - k_ + 1;
 
-    if (um.isEmpty) return; // nothing maps, move on
+        uint64_t pred = 0, succ = 0;
+        size_t nb_pred = 0, nb_succ = 0;
 
-    if (um.isShort) km_unitigs.uncover(um.pos_unitig);
-    else if (um.isAbundant) h_kmers_ccov.find(um.pos_unitig)->ccov.uncover(um.dist, um.dist + um.len - 1);
-    else v_unitigs[um.pos_unitig]->getCov().uncover(um.dist, um.dist + um.len - 1);
-}
+        for (const auto& um_pred : um.getPredecessors()){
 
-template<typename U, typename G>
-void CompactedDBG<U, G>::unmapRead(const const_UnitigMap<U, G>& um, LockGraph& lck_g) {
+            const size_t row_pred = getNeighborRow(um_pred.pos_unitig, um_pred.isShort, um_pred.isAbundant);
 
-    if (um.isEmpty) return; // nothing maps, move on
+            pred = (static_cast<uint64_t>(row_pred) << 1) | static_cast<uint64_t>(um_pred.strand);
 
-    if (um.isShort) km_unitigs.uncover_thread_safe(um.pos_unitig);
-    else {
+            unite(row, row_pred);
+            ++nb_pred;
+        }
 
-        size_t lock_unitig_id = um.pos_unitig;
+        for (const auto& um_succ : um.getSuccessors()){
 
-        lock_unitig_id += v_unitigs.size() & (static_cast<size_t>(!um.isShort) - 1);
-        lock_unitig_id += (v_unitigs.size() + km_unitigs.size()) & (static_cast<size_t>(!um.isAbundant) - 1);
+            const size_t row_succ = getNeighborRow(um_succ.pos_unitig, um_succ.isShort, um_succ.isAbundant);
 
-        lck_g.lock_unitig(lock_unitig_id);
+            succ = (static_cast<uint64_t>(row_succ) << 1) | static_cast<uint64_t>(um_succ.strand);
 
-        if (um.isAbundant) h_kmers_ccov.find(um.pos_unitig)->ccov.uncover(um.dist, um.dist + um.len - 1);
-        else v_unitigs[um.pos_unitig]->getCov().uncover(um.dist, um.dist + um.len - 1);
+            unite(row, row_succ);
+            ++nb_succ;
+        }
 
-        lck_g.unlock_unitig(lock_unitig_id);
-    }
-}
+        ++acc.nb_unitigs;
+        ++acc.degree_hist[nb_pred];
+        ++acc.degree_hist[nb_succ];
+        ++acc.length_count[um.size];
 
-template<typename U, typename G>
-vector<Kmer> CompactedDBG<U, G>::extractMercyKmers(BlockedBloomFilter& bf_uniq_km, const size_t nb_threads, const bool verbose) {
+        acc.nb_kmers += nb_km;
+        acc.total_length += um.size;
+        acc.min_length = min(acc.min_length, um.size);
+        acc.max_length = max(acc.max_length, um.size);
 
-    const size_t v_unitigs_sz = v_unitigs.size();
-    const size_t v_kmers_sz = km_unitigs.size();
+        if ((nb_pred == 0) && (nb_succ == 0)) ++acc.nb_isolated;
+        else if (((nb_pred == 0) || (nb_succ == 0)) && (nb_km < static_cast<size_t>(k_))) ++acc.nb_tips;
+        else if ((nb_pred == 1) && (nb_succ == 1)){
 
-    size_t i, j;
+            // On the reverse-complement of the unitig, the predecessor is the reverse-complemented successor and conversely
+            const pair<uint64_t, uint64_t> p_fw(pred, succ), p_rev(succ ^ 0x1, pred ^ 0x1);
 
-    char km_tmp[MAX_KMER_SIZE];
+            acc.bubble_keys.push_back(min(p_fw, p_rev));
+        }
+    });
 
-    KmerHashTable<uint8_t> tips;
+    atomic<size_t>* comp_nb_unitigs = new atomic<size_t>[nb_rows];
+    atomic<size_t>* comp_nb_kmers = new atomic<size_t>[nb_rows];
 
-    vector<Kmer> v_out;
+    for (size_t i = 0; i < nb_rows; ++i){
 
-    for (typename h_kmers_ccov_t::iterator it_ccov = h_kmers_ccov.begin(); it_ccov != h_kmers_ccov.end(); ++it_ccov) {
+        comp_nb_unitigs[i] = 0;
+        comp_nb_kmers[i] = 0;
+    }
 
-        const Kmer km = it_ccov.getKey().rep();
+    // Second pass: size of the connected components, accumulated on their root
+    run([&](const const_UnitigMap<U, G>& um, StatsAccumulator& acc){
 
-        vector<UnitigMap<U, G>> v_um = findPredecessors(km, true);
+        const size_t row = getNeighborRow(um.pos_unitig, um.isShort, um.isAbundant);
+        const size_t root = findRoot(row);
 
-        for (i = 0; (i != 4) && v_um[i].isEmpty; ++i){}
+        if (root == row) ++acc.nb_components;
 
-        v_um = findSuccessors(km, true);
+        ++comp_nb_unitigs[root];
+        comp_nb_kmers[root] += um.size - k_ + 1;
+    });
 
-        for (j = 0; (j != 4) && v_um[j].isEmpty; ++j){}
+    for (size_t i = 0; i < nb_rows; ++i){
 
-        if ((i == 4) && (j == 4)) tips.insert(km, 3);
-        else if (j == 4) tips.insert(km, 2);
-        else if (i == 4) tips.insert(km, 1);
+        if (comp_nb_kmers[i] > stats.max_component_nb_kmers){
+
+            stats.max_component_nb_kmers = comp_nb_kmers[i];
+            stats.max_component_nb_unitigs = comp_nb_unitigs[i];
+        }
     }
 
-    for (size_t it_v_km = 0; it_v_km != v_kmers_sz; ++it_v_km) {
+    delete[] parent;
+    delete[] comp_nb_unitigs;
+    delete[] comp_nb_kmers;
 
-        const Kmer km = km_unitigs.getKmer(it_v_km).rep();
+    map<size_t, size_t> length_count;
+    vector<pair<uint64_t, uint64_t>> bubble_keys;
 
-        vector<UnitigMap<U, G>> v_um = findPredecessors(km, true);
+    stats.min_length = 0xffffffffffffffffULL;
 
-        for (i = 0; (i != 4) && v_um[i].isEmpty; ++i){}
+    for (const auto& acc : v_acc){
 
-        v_um = findSuccessors(km, true);
+        stats.nb_unitigs += acc.nb_unitigs;
+        stats.nb_kmers += acc.nb_kmers;
+        stats.total_length += acc.total_length;
+        stats.min_length = min(stats.min_length, acc.min_length);
+        stats.max_length = max(stats.max_length, acc.max_length);
+        stats.nb_components += acc.nb_components;
+        stats.nb_isolated += acc.nb_isolated;
+        stats.nb_tips += acc.nb_tips;
 
-        for (j = 0; (j != 4) && v_um[j].isEmpty; ++j){}
+        for (size_t i = 0; i < 5; ++i) stats.degree_hist[i] += acc.degree_hist[i];
+        for (const auto& p : acc.length_count) length_count[p.first] += p.second;
 
-        if ((i == 4) && (j == 4)) tips.insert(km, 3);
-        else if (j == 4) tips.insert(km, 2);
-        else if (i == 4) tips.insert(km, 1);
+        bubble_keys.insert(bubble_keys.end(), acc.bubble_keys.begin(), acc.bubble_keys.end());
     }
 
-    for (size_t it_v_unitig = 0; it_v_unitig != v_unitigs_sz; ++it_v_unitig) {
-
-        const CompressedSequence& seq = v_unitigs[it_v_unitig]->getSeq();
+    if (stats.nb_unitigs == 0) stats.min_length = 0;
+    else {
 
-        const Kmer head = seq.getKmer(0);
-        const Kmer tail = seq.getKmer(seq.size() - k_);
+        size_t sum_length = 0;
 
-        vector<UnitigMap<U, G>> v_um = findPredecessors(head, true);
+        stats.mean_length = static_cast<double>(stats.total_length) / stats.nb_unitigs;
 
-        for (i = 0; (i != 4) && v_um[i].isEmpty; ++i){}
+        for (auto it = length_count.rbegin(); it != length_count.rend(); ++it){
 
-        if (i == 4){
+            sum_length += it->first * it->second;
 
-            const Kmer head_rep = head.rep();
+            if (2 * sum_length >= stats.total_length){
 
-            if (head == head_rep) tips.insert(head, 1);
-            else tips.insert(head_rep, 2);
+                stats.n50 = it->first;
+                break;
+            }
         }
 
-        v_um = findSuccessors(tail, true);
-
-        for (i = 0; (i != 4) && v_um[i].isEmpty; ++i){}
+        for (const auto& p : length_count){
 
-        if (i == 4){
+            size_t bin = 0;
 
-            const Kmer tail_rep = tail.rep();
+            while ((p.first >> (bin + 1)) != 0) ++bin;
+            if (bin >= stats.length_hist.size()) stats.length_hist.resize(bin + 1, 0);
 
-            if (tail == tail_rep) tips.insert(tail, 2);
-            else tips.insert(tail_rep, 1);
+            stats.length_hist[bin] += p.second;
         }
     }
 
-    for (typename KmerHashTable<uint8_t>::iterator it_a = tips.begin(); it_a != tips.end(); ++it_a) {
+    sort(bubble_keys.begin(), bubble_keys.end());
 
-        if ((*it_a == 1) || (*it_a == 3)){ // Corresponding k-mer has no predecessor in the graph
+    for (size_t i = 0, j = 0; i < bubble_keys.size(); i = j){
 
-            bool pres_neigh_bw[4] = {false, false, false, false};
-            uint64_t hashes_bw[4];
+        while ((j < bubble_keys.size()) && (bubble_keys[j] == bubble_keys[i])) ++j;
 
-            const Kmer km_a = it_a.getKey();
+        stats.nb_bubbles += static_cast<size_t>(j - i >= 2);
+    }
 
-            km_a.toString(km_tmp); // Get the k-mer
-            RepHash rep_h(k_), rep_h_cpy;
+    return true;
+}
 
-            rep_h.init(km_tmp);
+template<typename U, typename G>
+int CompactedDBG<U, G>::estimateMinimizerLength(const vector<string>& input_filenames, const size_t nb_threads, const bool verbose) const {
 
-            for (i = 0; i != 4; ++i) {
+    if (invalid){
 
-                rep_h_cpy = rep_h;
-                rep_h_cpy.updateBW(km_tmp[k_ - 1], alpha[i]);
+        cerr << "CompactedDBG::estimateMinimizerLength(): Graph is invalid, length k of k-mers is not set" << endl;
+        return -1;
+    }
 
-                hashes_bw[i] = rep_h_cpy.hash(); // Prepare the hash of its predecessor
-            }
+    if (nb_threads == 0){
 
-            std::memmove(km_tmp + 1, km_tmp, (k_ - 1) * sizeof(char));
+        cerr << "CompactedDBG::estimateMinimizerLength(): Number of threads cannot be less than or equal to 0" << endl;
+        return -1;
+    }
 
-            // Query the MBBF for all possible predecessors
-            bf_uniq_km.contains(hashes_bw, minHashKmer<RepHash>(km_tmp, k_, g_, RepHash(), true).getHash(), pres_neigh_bw, 4);
+    if (input_filenames.size() == 0){
 
-            for (i = 0; i != 4; ++i) {
+        cerr << "CompactedDBG::estimateMinimizerLength(): Missing input files" << endl;
+        return -1;
+    }
 
-                if (pres_neigh_bw[i]){ // A potential mercy k-mer has been found
+    vector<string> v_seq;
 
-                    const Kmer km_mercy = km_a.backwardBase(alpha[i]);
+    size_t nb_bases_sample = 0;
 
-                    for (j = 0; j != 4; ++j) {
+    double nb_bytes_per_base = 1.0;
+    double nb_bases_input = 0.0;
 
-                        const Kmer km_b = km_mercy.backwardBase(alpha[j]); // Possible predecessor of this mercy k-mer
-                        const Kmer km_b_rep = km_b.rep();
+    {
+        vector<size_t> v_nb_bytes(input_filenames.size(), 0);
+        vector<size_t> v_nb_bases(input_filenames.size(), 0);
 
-                        typename KmerHashTable<uint8_t>::iterator it_b = tips.find(km_b_rep); // Query the tips with predecessor
+        vector<bool> v_quality(input_filenames.size(), false);
 
-                        if (it_b != tips.end()){ // Possible predecessor of this mercy k-mer exists
+        FileParser fp(input_filenames);
 
-                            if ((km_b == km_b_rep) && ((*it_b == 2) || (*it_b == 3))){
+        string seq;
 
-                                // Those tips can't be use anymore in these directions
-                                *it_b = (*it_b == 2 ? 0 : 1);
-                                *it_a = (*it_a == 1 ? 0 : 2);
-                                i = 3; j = 3; // Break the loops
+        size_t file_id = 0;
 
-                                v_out.push_back(km_mercy); //Push the mercy k-mer found
-                            }
-                            else if ((km_b != km_b_rep) && ((*it_b == 1) || (*it_b == 3))){
+        bool sample_full = false;
 
-                                // Those tips can't be use anymore in these directions
-                                *it_b = (*it_b == 1 ? 0 : 2);
-                                *it_a = (*it_a == 1 ? 0 : 2);
-                                i = 3; j = 3; // Break the loops
+        while (fp.read(seq, file_id)){
 
-                                v_out.push_back(km_mercy);  //Push the mercy k-mer found
-                            }
-                        }
-                    }
-                }
-            }
-        }
+            const char* qual = fp.getQualityScoreString();
 
-        if ((*it_a == 2) || (*it_a == 3)){ // Corresponding k-mer has no successor in the graph
+            v_quality[file_id] = (qual != nullptr) && (qual[0] != '\0');
 
-            bool pres_neigh_fw[4] = {false, false, false, false};
-            uint64_t hashes_fw[4];
+            if (nb_bases_sample >= DEFAULT_G_SAMPLE_NB_BASES){
 
-            const Kmer km_a = it_a.getKey();
+                sample_full = true;
+                break;
+            }
 
-            km_a.toString(km_tmp); // Get the k-mer
-            RepHash rep_h(k_), rep_h_cpy; // Prepare its hash
+            if (seq.length() >= k_){
 
-            rep_h.init(km_tmp);
+                seq.resize(min(seq.length(), max(DEFAULT_G_SAMPLE_NB_BASES - nb_bases_sample, static_cast<size_t>(k_))));
 
-            for (i = 0; i != 4; ++i) {
+                std::transform(seq.begin(), seq.end(), seq.begin(), ::toupper);
 
-                rep_h_cpy = rep_h;
-                rep_h_cpy.updateFW(km_tmp[0], alpha[i]);
+                nb_bases_sample += seq.length();
+                v_nb_bases[file_id] += seq.length();
 
-                hashes_fw[i] = rep_h_cpy.hash(); // Prepare the hash of its successor
+                v_seq.push_back(seq);
             }
+        }
 
-            std::memmove(km_tmp, km_tmp + 1, (k_ - 1) * sizeof(char));
+        fp.close();
 
-            // Query the MBBF for all possible predecessors
-            bf_uniq_km.contains(hashes_fw, minHashKmer<RepHash>(km_tmp, k_, g_, RepHash(), true).getHash(), pres_neigh_fw, 4);
+        if (v_seq.empty()){
 
-            for (i = 0; i != 4; ++i) {
+            cerr << "CompactedDBG::estimateMinimizerLength(): No sequence of length at least k in the input files" << endl;
+            return -1;
+        }
 
-                if (pres_neigh_fw[i]){ // A potential mercy k-mer has been found
+        if (sample_full){
 
-                    const Kmer km_mercy = km_a.forwardBase(alpha[i]);
+            // Files before the current one are fully sampled: they give the number of bytes per base of the input
+            size_t nb_bytes_full = 0, nb_bases_full = 0;
 
-                    for (j = 0; j != 4; ++j) {
+            for (size_t i = 0; i < input_filenames.size(); ++i){
 
-                        const Kmer km_b = km_mercy.forwardBase(alpha[j]); // Possible successor of this mercy k-mer
-                        const Kmer km_b_rep = km_b.rep();
+                struct stat stFileInfo;
 
-                        typename KmerHashTable<uint8_t>::iterator it_b = tips.find(km_b_rep); // Query the tips with successor
+                if (stat(input_filenames[i].c_str(), &stFileInfo) == 0) v_nb_bytes[i] = stFileInfo.st_size;
 
-                        if (it_b != tips.end()){ // Possible successor of this mercy k-mer exists
+                if (i < file_id){
 
-                            if ((km_b == km_b_rep) && ((*it_b == 1) || (*it_b == 3))){
+                    nb_bytes_full += v_nb_bytes[i];
+                    nb_bases_full += v_nb_bases[i];
+                }
+            }
 
-                                // Those tips can't be use anymore in these directions
-                                *it_b = (*it_b == 1 ? 0 : 2);
-                                *it_a = (*it_a == 2 ? 0 : 1);
-                                i = 3; j = 3; // Break the loops
+            if ((nb_bytes_full != 0) && (nb_bases_full != 0)) nb_bytes_per_base = static_cast<double>(nb_bytes_full) / nb_bases_full;
+            else {
 
-                                v_out.push_back(km_mercy); //Push the mercy k-mer found
-                            }
-                            else if ((km_b != km_b_rep) && ((*it_b == 2) || (*it_b == 3))){
+                // Rough guess: 1 byte per base in FASTA/GFA, 2 bytes per base in FASTQ, about 4 times less if compressed
+                const string& fn = input_filenames[file_id];
 
-                                // Those tips can't be use anymore in these directions
-                                *it_b = (*it_b == 2 ? 0 : 1);
-                                *it_a = (*it_a == 2 ? 0 : 1);
-                                i = 3; j = 3; // Break the loops
+                nb_bytes_per_base = v_quality[file_id] ? 2.0 : 1.0;
 
-                                v_out.push_back(km_mercy);  //Push the mercy k-mer found
-                            }
-                        }
-                    }
-                }
+                if ((fn.length() >= 3) && (fn.substr(fn.length() - 3) == ".gz")) nb_bytes_per_base /= 4.0;
             }
+
+            for (const auto nb_bytes : v_nb_bytes) nb_bases_input += nb_bytes / nb_bytes_per_base;
         }
+
+        nb_bases_input = max(nb_bases_input, static_cast<double>(nb_bases_sample));
     }
 
-    if (verbose) cout << "CompactedDBG::extractMercyKmers(): " << v_out.size() << " k-mers extracted" << endl;
+    const double ratio_input_sample = nb_bases_input / nb_bases_sample;
 
-    return v_out;
-}
+    vector<int> v_g;
 
-template<typename U, typename G>
-size_t CompactedDBG<U, G>::joinTips(string filename_MBBF_uniq_kmers, const size_t nb_threads, const bool verbose) {
+    for (int g = min(k_ - 2, MAX_GMER_SIZE - 1); (g > 0) && (g >= k_ / 2); g -= 2) v_g.push_back(g);
 
-    if (invalid){
+    if (v_g.empty()) return g_;
 
-        cerr << "CompactedDBG::joinTips(): Graph is invalid and tips cannot be joined" << endl;
-        return 0;
-    }
+    vector<double> v_score(v_g.size(), 0.0);
 
-    BlockedBloomFilter mbbf;
+    // Number of distinct values drawn when drawing nb_draws times in a universe of nb_vals values: nb_vals * (1 - exp(-nb_draws / nb_vals))
+    auto nbDistinct = [](const double nb_draws, const double nb_vals) {
 
-    FILE* f_mbbf;
+        return nb_vals * (-expm1(-nb_draws / nb_vals));
+    };
 
-    if ((f_mbbf = fopen(filename_MBBF_uniq_kmers.c_str(), "rb")) == NULL){
+    auto worker_function = [&](const size_t t){
 
-        cerr << "CompactedDBG::joinTips(): Minimizer Blocked Bloom filter file of unique k-mers cannot be opened" << endl;
-        return 0;
-    }
+        for (size_t i = t; i < v_g.size(); i += nb_threads){
 
-    mbbf.ReadBloomFilter(f_mbbf);
-    fclose(f_mbbf);
+            const int g = v_g[i];
 
-    vector<Kmer> v_mercy_km = extractMercyKmers(mbbf, nb_threads, verbose);
+            ReadHasherMinimizer rh(0.01);
 
-    for (const auto& km_mercy : v_mercy_km) addUnitig(km_mercy.rep().toString(), km_unitigs.size());
+            rh.setK(k_);
+            rh.setG(g);
 
-    size_t nb_join = joinUnitigs_<is_void<U>::value>(&v_mercy_km, nb_threads);
+            for (const auto& seq : v_seq) rh.update(seq.c_str(), seq.length());
 
-    if (verbose) cout << "CompactedDBG<U, G>::joinTips(): " << nb_join << " unitigs have been joined using mercy k-mers" << endl;
+            const double nb_km_sample = max(static_cast<size_t>(1), rh.KmerF0());
+            const double nb_min_sample = max(static_cast<size_t>(1), rh.MinimizerF0());
+            const double nb_superkm_per_km = static_cast<double>(rh.MinimizerF1()) / max(static_cast<size_t>(1), rh.KmerF1());
+            const double nb_entries_sample = max(nb_min_sample, nb_km_sample * nb_superkm_per_km);
 
-    return nb_join;
-}
+            // Size of the universe of minimizers which explains the number of distinct minimizers in the sample
+            double u_min = nb_min_sample, u_max = ldexp(1.0, 2 * g - 1);
 
-template<typename U, typename G>
-void CompactedDBG<U, G>::setKmerGmerLength(const int kmer_length, const int minimizer_length){
+            if (nbDistinct(nb_entries_sample, u_max) <= nb_min_sample) u_min = u_max;
+            else {
 
-    invalid = false;
+                for (size_t j = 0; j < 64; ++j){
 
-    if (kmer_length <= 2){
+                    const double u_mid = sqrt(u_min * u_max);
 
-        cerr << "CompactedDBG::CompactedDBG(): Length k of k-mers cannot be less than 3" << endl;
-        invalid = true;
-    }
+                    if (nbDistinct(nb_entries_sample, u_mid) < nb_min_sample) u_min = u_mid;
+                    else u_max = u_mid;
+                }
+            }
 
-    if (kmer_length >= MAX_KMER_SIZE){
+            const double nb_entries = nb_entries_sample * ratio_input_sample;
+            const double nb_min = max(1.0, nbDistinct(nb_entries, u_min));
 
-        cerr << "CompactedDBG::CompactedDBG(): Length k of k-mers cannot exceed or be equal to " << MAX_KMER_SIZE << endl;
-        invalid = true;
-    }
+            const double mem = nb_min * 1.05 * (sizeof(Minimizer) + sizeof(packed_tiny_vector) + sizeof(uint8_t)) + nb_entries * sizeof(uint64_t);
+            const double probe_cost = 1.0 + nb_entries / nb_min;
 
-    if (minimizer_length == 0){
+            v_score[i] = mem * probe_cost;
+        }
+    };
 
-        cerr << "CompactedDBG::CompactedDBG(): Length g of minimizers cannot be equal to 0" << endl;
-        invalid = true;
-    }
+    if (nb_threads == 1) worker_function(0);
+    else {
 
-    if (minimizer_length >= MAX_GMER_SIZE){
+        vector<thread> workers;
 
-        cerr << "CompactedDBG::CompactedDBG(): Length g of minimizers cannot exceed or be equal to " << MAX_KMER_SIZE << endl;
-        invalid = true;
+        for (size_t t = 0; t < min(nb_threads, v_g.size()); ++t) workers.emplace_back(worker_function, t);
+        for (auto& t : workers) t.join();
     }
 
-    if ((minimizer_length > 0) && (minimizer_length > kmer_length - 2)){
-
-        cerr << "CompactedDBG::CompactedDBG(): Length g of minimizers cannot exceed k - 2" << endl;
-        invalid = true;
-    }
+    size_t best = 0;
 
-    if (!invalid){
+    for (size_t i = 0; i < v_g.size(); ++i){
 
-        k_ = kmer_length;
+        if (verbose){
 
-        if (minimizer_length >= 0) g_ = minimizer_length;
-        else if (kmer_length >= 15) g_ = k_ - DEFAULT_G_DEC1;
-        else if (kmer_length >= 7) g_ = k_ - DEFAULT_G_DEC2;
-        else g_ = k_ - 2;
+            cout << "CompactedDBG::estimateMinimizerLength(): g = " << v_g[i] << ", predicted index memory x probe cost = " << v_score[i] << endl;
+        }
 
-        Kmer::set_k(k_);
-        Minimizer::set_g(g_);
+        if (v_score[i] < v_score[best]) best = i;
     }
+
+    if (verbose) cout << "CompactedDBG::estimateMinimizerLength(): Estimated length of minimizers is " << v_g[best] << endl;
+
+    return v_g[best];
 }
 
 template<typename U, typename G>
@@ -1,8 +1,119 @@
+#include <atomic>
 #include <iostream>
+#include <new>
 
 #include "Common.hpp"
 #include "CompressedSequence.hpp"
 #include "Kmer.hpp"
+#include "PackedDNA.hpp"
+
+// The functions below work on words of 32 bases in the order of a CompressedSequence (see PackedDNA.hpp). Bytes of
+// a CompressedSequence are loaded and stored as little-endian words.
+
+// Mask selecting the first len (<= 32) bases of a word
+static BFG_INLINE uint64_t mask_word(const size_t len) {
+
+    return (len >= 32) ? 0xFFFFFFFFFFFFFFFFULL : ((1ULL << (len << 1)) - 1);
+}
+
+// Get the word of the 32 bases starting at base pos of an array of nbytes bytes. Bases past the end of the array are 0s.
+static BFG_INLINE uint64_t get_word(const unsigned char* data, const size_t nbytes, const size_t pos) {
+
+    const size_t b = pos >> 2;
+    const size_t shift = (pos & 0x3) << 1;
+
+    uint64_t w = 0;
+
+    if (b + 8 <= nbytes) memcpy(&w, data + b, 8);
+    else if (b < nbytes) memcpy(&w, data + b, nbytes - b);
+
+    w >>= shift;
+
+    if ((shift != 0) && (b + 8 < nbytes)) w |= static_cast<uint64_t>(data[b + 8]) << (64 - shift);
+
+    return w;
+}
+
+// Set the len (<= 32) bases starting at base pos of an array with the first len bases of a word
+static BFG_INLINE void set_word(unsigned char* data, const size_t pos, const uint64_t w, const size_t len) {
+
+    const size_t b = pos >> 2;
+    const size_t shift = (pos & 0x3) << 1;
+    const size_t nbytes = ((pos + len + 3) >> 2) - b; // Number of bytes to update (<= 9)
+    const size_t nbytes_lo = (nbytes < 8) ? nbytes : 8;
+
+    const uint64_t m = mask_word(len);
+
+    uint64_t lo = 0;
+
+    memcpy(&lo, data + b, nbytes_lo);
+
+    lo = (lo & ~(m << shift)) | ((w & m) << shift);
+
+    memcpy(data + b, &lo, nbytes_lo);
+
+    if (nbytes == 9) data[b + 8] = (data[b + 8] & ~static_cast<uint8_t>(m >> (64 - shift))) | static_cast<uint8_t>((w & m) >> (64 - shift));
+}
+
+// Pack the first characters of s (at most len) in a word. Packing stops at the first character which is not 'A', 'C',
+// 'G' or 'T' (including the null-terminating character). Returns the number of characters packed. If is_safe_32 is true,
+// the 32 first characters of s can be read at once.
+static BFG_INLINE size_t pack_word(const char* s, const size_t len, const bool is_safe_32, uint64_t& w) {
+
+    if (is_safe_32) {
+
+        uint32_t non_acgt;
+
+        w = encodeWord(s, 32, non_acgt);
+
+        const size_t nb_acgt = (non_acgt == 0) ? 32 : __builtin_ctz(non_acgt);
+
+        return (nb_acgt < len) ? nb_acgt : len;
+    }
+
+    const size_t end = (len < 32) ? len : 32;
+
+    size_t i = 0;
+
+    w = 0;
+
+    for (; i < end; ++i) {
+
+        const char c = s[i];
+
+        if ((c != 'A') && (c != 'C') && (c != 'G') && (c != 'T')) break;
+
+        const uint64_t x = (c & 4) >> 1;
+
+        w |= (x + ((x ^ (c & 2)) >> 1)) << (i << 1);
+    }
+
+    return i;
+}
+
+// The bases of a long sequence are stored in a buffer shared by the copies of the sequence until one of them is modified
+// (copy-on-write): copying a sequence is O(1) and memory grows only with the sequences modified. The buffer starts with a
+// reference counter, the bases start header_sz bytes after.
+static const size_t header_sz = 8;
+
+static BFG_INLINE std::atomic<uint32_t>* get_refs(unsigned char* data) {
+
+    return reinterpret_cast<std::atomic<uint32_t>*>(data - header_sz);
+}
+
+static BFG_INLINE unsigned char* alloc_data(const size_t cap) {
+
+    unsigned char* buffer = new unsigned char[header_sz + cap];
+
+    new (buffer) std::atomic<uint32_t>(1);
+
+    return buffer + header_sz;
+}
+
+static BFG_INLINE void release_data(unsigned char* data) {
+
+    if (get_refs(data)->fetch_sub(1) == 1) delete[] (data - header_sz);
+}
 
 CompressedSequence::CompressedSequence() {
 
@@ -24,7 +135,7 @@ CompressedSequence::CompressedSequence(const CompressedSequence& o) {
         asBits._size = o.asBits._size;
         memcpy(asBits._arr, o.asBits._arr, 31);
     }
-    else setSequence(o, 0, o.size()); // copy sequence and pointers etc.
+    else shareData(o); // Bases are copied only when one of the two sequences is modified
 }
 
 CompressedSequence::CompressedSequence(CompressedSequence&& o) {
@@ -49,14 +160,16 @@ CompressedSequence::CompressedSequence(CompressedSequence&& o) {
 // post: the DNA string in _cs is the same as in cs
 CompressedSequence& CompressedSequence::operator=(const CompressedSequence& o) {
 
-    if (this != &o){
+    if ((this != &o) && (isShort() || o.isShort() || (asPointer._data != o.asPointer._data))){
+
+        clear();
 
         if (o.isShort()) {
 
             asBits._size = o.asBits._size;
             memcpy(asBits._arr, o.asBits._arr,31); // plain vanilla copy
         }
-        else setSequence(o, 0, o.size()); // copy sequence and pointers etc.
+        else shareData(o); // Bases are copied only when one of the two sequences is modified
     }
 
     return *this;
@@ -66,6 +179,8 @@ CompressedSequence& CompressedSequence::operator=(CompressedSequence&& o) {
 
     if (this != &o) {
 
+        clear();
+
         if (o.isShort()) {
 
             asBits._size = o.asBits._size;
@@ -73,8 +188,6 @@ CompressedSequence& CompressedSequence::operator=(CompressedSequence&& o) {
         }
         else {
 
-            clear();
-
             asPointer._length = o.asPointer._length;
             asPointer._capacity = o.asPointer._capacity;
             asPointer._data = o.asPointer._data;
@@ -129,8 +242,8 @@ void CompressedSequence::setSequence(const CompressedSequence& o, const size_t s
 
     if (round_to_bytes(length+offset) > capacity()) _resize_and_copy(round_to_bytes(length+offset),size());
 
-    unsigned char* data = const_cast<unsigned char*>(getPointer());
-    const unsigned char *odata = o.getPointer();
+    const unsigned char *odata = o.getPointer(); // Before getWritePointer(): o might be this sequence, sharing its bases
+    unsigned char* data = getWritePointer();
 
     size_t w_index = offset;
     size_t wi, wj, r_index;
@@ -175,7 +288,7 @@ void CompressedSequence::_resize_and_copy(const size_t new_cap, const size_t cop
 
     if (new_cap <= capacity()) return;
 
-    unsigned char* new_data = new unsigned char[new_cap]; // allocate new storage
+    unsigned char* new_data = alloc_data(new_cap); // allocate new storage
     size_t bytes = round_to_bytes(copy_limit);
 
     memcpy(new_data, getPointer(), bytes); // copy old data
@@ -193,13 +306,42 @@ void CompressedSequence::_resize_and_copy(const size_t new_cap, const size_t cop
     }
     else {
 
-        delete[] asPointer._data;
+        release_data(asPointer._data);
 
         asPointer._data = new_data;
         asPointer._capacity = new_cap;
     }
 }
 
+// Share the bases of long sequence o
+void CompressedSequence::shareData(const CompressedSequence& o) {
+
+    asPointer._length = o.asPointer._length;
+    asPointer._capacity = o.asPointer._capacity;
+    asPointer._data = o.asPointer._data;
+
+    get_refs(asPointer._data)->fetch_add(1, std::memory_order_relaxed);
+}
+
+// Get the bases for writing: if they are shared with other sequences, this sequence gets its own copy first
+unsigned char* CompressedSequence::getWritePointer() {
+
+    if (isShort()) return &(asBits._arr[0]);
+
+    if (get_refs(asPointer._data)->load() != 1) {
+
+        unsigned char* new_data = alloc_data(asPointer._capacity);
+
+        memcpy(new_data, asPointer._data, round_to_bytes(size()));
+
+        release_data(asPointer._data);
+
+        asPointer._data = new_data;
+    }
+
+    return asPointer._data;
+}
+
 
 // use:  a.setSequence(s, length, offset, reversed);
 // pre:  length <= strlen(s), offset <= a._length
@@ -212,31 +354,27 @@ void CompressedSequence::setSequence(const char *s, const size_t length, const s
 
     if (round_to_bytes(len) > capacity()) _resize_and_copy(round_to_bytes(length + offset), size());
 
-    unsigned char* data = const_cast<unsigned char*>(getPointer());
+    unsigned char* data = getWritePointer();
 
-    if (reversed) {
-
-        for (size_t index = offset; index < len; ++index) {
+    for (size_t i = 0; i < length; i += 32) { // Encode and copy 32 characters at a time
 
-            const size_t i = index >> 2;
-            const size_t j = (index & 0x3) << 1;
-            const uint8_t c = bases[0x03-bits[(uint8_t)*(s+len-index-1)]];
+        const size_t l = (length - i < 32) ? length - i : 32;
+        const char* s_tmp = reversed ? s + length - i - l : s + i;
 
-            data[i] &= ~(0x03 << j); // set bits to 0, default
-            data[i] |= (bits[c] << j);
-        }
-    }
-    else {
+        uint32_t non_acgt;
+        uint64_t w = encodeWord(s_tmp, l, non_acgt);
 
-        for (size_t index = offset; index < len; ++index) {
+        while (non_acgt != 0) { // Characters other than A, C, G, T are encoded with the bits[] table
 
-            const size_t i = index >> 2;
-            const size_t j = (index & 0x3) << 1;
-            const uint8_t c = *(s+index-offset);
+            const size_t j = __builtin_ctz(non_acgt);
 
-            data[i] &= ~(0x03 << j); // set bits to 0, default
-            data[i] |= (bits[c] << j);
+            w = (w & ~(0x3ULL << (j << 1))) | (static_cast<uint64_t>(bits[(uint8_t) s_tmp[j]]) << (j << 1));
+            non_acgt &= non_acgt - 1;
         }
+
+        if (reversed) w = twinWord(w) >> ((32 - l) << 1);
+
+        set_word(data, offset + i, w, l);
     }
 
     if (len > size()) setSize(len);
@@ -262,10 +400,25 @@ void CompressedSequence::setSequence(const string& s, const size_t length, const
 //         reverse complement of the DNA string in km
 void CompressedSequence::setSequence(const Kmer& km, const size_t length, const size_t offset, const bool reversed) {
 
-    char s[Kmer::MAX_K + 1];
+    if (reversed) {
+
+        char s[Kmer::MAX_K + 1];
 
-    km.toString(s);
-    setSequence(s, length, offset, reversed);
+        km.toString(s);
+        setSequence(s, length, offset, reversed);
+    }
+    else { // Copy the k-mer words directly
+
+        const size_t len = offset + length;
+
+        if (round_to_bytes(len) > capacity()) _resize_and_copy(round_to_bytes(len), size());
+
+        unsigned char* data = getWritePointer();
+
+        for (size_t i = 0; i < length; i += 32) set_word(data, offset + i, reverseWord(km.longs[i >> 5]), (length - i < 32) ? length - i : 32);
+
+        if (len > size()) setSize(len);
+    }
 }
 
 
@@ -274,14 +427,9 @@ void CompressedSequence::setSequence(const Kmer& km, const size_t length, const
 // post: s is the DNA string from c[offset,...,offset+length-1]
 string CompressedSequence::toString(const size_t offset, const size_t length) const {
 
-    const unsigned char* data = getPointer();
-
     string s(length, 0);
 
-    for (size_t index = offset; index < offset+length; ++index) {
-
-        s[index-offset] = bases[(data[index >> 2] >> ((index & 0x3) << 1)) & 0x03];
-    }
+    if (length != 0) toString(&s[0], offset, length);
 
     return s;
 }
@@ -294,11 +442,9 @@ string CompressedSequence::toString(const size_t offset, const size_t length) co
 void CompressedSequence::toString(char *s, const size_t offset, const size_t length) const {
 
     const unsigned char* data = getPointer();
+    const size_t nbytes = round_to_bytes(size());
 
-    for (size_t index = offset; index < offset+length; ++index) {
-
-        s[index-offset] = bases[(data[index >> 2] >> ((index & 0x3) << 1)) & 0x03];
-    }
+    for (size_t i = 0; i < length; i += 32) decodeWord(get_word(data, nbytes, offset + i), s + i, (length - i < 32) ? length - i : 32);
 
     s[length] = 0; // 0-terminated string
 }
@@ -314,42 +460,12 @@ Kmer CompressedSequence::getKmer(const size_t offset) const {
 
     const unsigned char* data = getPointer();
 
-    const size_t len = offset + Kmer::k;
-
-    if ((offset & 0x3) == 0){ // Extraction byte to byte is possible
-
-        const size_t nbytes = (Kmer::k + 3) / 4;
-
-        size_t i = offset >> 2, j = 0;
-
-        for (; j < nbytes - 1; ++i, ++j) km.bytes[(7 - (j & 0x7)) + ((j >> 3) << 3)] = revBits[data[i]];
-
-        unsigned char tmp_km = 0;
-        unsigned char tmp_data = data[i];
-
-        for (i <<= 2; i < len; ++i, tmp_data >>= 2) tmp_km = (tmp_km << 2) | (tmp_data & 0x3);
-
-        tmp_km <<= ((4 - (Kmer::k & 0x3)) << 1) & 0x7;
-        km.bytes[(7 - (j & 0x7)) + ((j >> 3) << 3)] = tmp_km;
-    }
-    else { // Extraction 2 bits per 2 bits
-
-        const size_t nlongs = (Kmer::k + 31) / 32;
-
-        size_t j = 0;
-
-        for (size_t i = offset; j < nlongs; ++j){
-
-            uint64_t tmp_km = 0;
-            const size_t end = len < i + 32 ? len : i + 32;
+    const size_t nbytes = round_to_bytes(size());
+    const size_t nlongs = (Kmer::k + 31) / 32;
 
-            for (; i != end; ++i) tmp_km = (tmp_km << 2) | ((data[i >> 2] >> ((i & 0x3) << 1)) & 0x3);
+    for (size_t i = 0; i < nlongs; ++i) km.longs[i] = reverseWord(get_word(data, nbytes, offset + (i << 5)));
 
-            km.longs[j] = tmp_km;
-        }
-
-        km.longs[j-1] <<= (32 - (Kmer::k & 0x1f)) << 1;
-    }
+    if ((Kmer::k & 0x1f) != 0) km.longs[nlongs - 1] &= 0xFFFFFFFFFFFFFFFFULL << ((32 - (Kmer::k & 0x1f)) << 1); // Clear bases past k
 
     return km;
 }
@@ -360,40 +476,18 @@ bool CompressedSequence::compareKmer(const size_t offset, const size_t length, c
 
     if ((length > Kmer::k) || ((offset + length) > size()) || km.isEmpty() || km.isDeleted()) return false;
 
-    if ((offset & 0x3) == 0){ // Comparison byte to byte is possible
+    const size_t nbytes = round_to_bytes(size());
 
-        const size_t nbytes = (length + 3) / 4;
+    uint64_t diff = 0;
 
-        size_t i = offset >> 2, j = 0;
+    for (size_t i = 0; i < length; i += 32) {
 
-        while (j < nbytes - 1){ // Check full bytes (bytes containing 4 characters to compare)
-
-            j += ((static_cast<size_t>(data[i] == revBits[km.bytes[(7 - (j & 0x7)) + ((j >> 3) << 3)]]) - 1) & nbytes) + 1;
-            ++i;
-        }
+        const uint64_t w = get_word(data, nbytes, offset + i);
 
-        if (j != nbytes - 1) return false;
-        if ((length & 0x3) == 0) return (data[i] == revBits[km.bytes[(7 - (j & 0x7)) + ((j >> 3) << 3)]]); // Last byte is also a full byte
-
-        const char mask = (0x1ULL << ((length & 0x3) << 1)) - 1;
-
-        return (data[i] & mask) == (revBits[km.bytes[(7 - (j & 0x7)) + ((j >> 3) << 3)]] & mask);
+        diff |= (w ^ reverseWord(km.longs[i >> 5])) & mask_word(length - i);
     }
-    else { //Comparison 2 bits per 2 bits
-
-        size_t iu = offset, ik = 0;
-
-        while (ik < length){
 
-            const size_t cu = (data[iu >> 2] >> ((iu & 0x3) << 1)) & 0x3;
-            const size_t ck = (km.longs[ik >> 5] >> (62 - ((ik & 0x1F) << 1))) & 0x3;
-
-            ik += ((static_cast<size_t>(cu == ck) - 1) & length) + 1;
-            ++iu;
-        }
-
-        return (ik == length);
-    }
+    return (diff == 0);
 }
 
 int64_t CompressedSequence::findKmer(const Kmer& km) const {
@@ -496,27 +590,60 @@ CompressedSequence CompressedSequence::rev() const {
 
 size_t CompressedSequence::jump(const char *s, const size_t i, int pos, const bool reversed) const {
 
+    return jump(s, i, pos, reversed, 0);
+}
+
+// Same as jump(s, i, pos, reversed) but len_s is the length of s (0 if unknown). Knowing the length of s allows
+// to read 32 characters of s at once.
+size_t CompressedSequence::jump(const char *s, const size_t i, int pos, const bool reversed, const size_t len_s) const {
+
     const unsigned char* data = getPointer();
     const char* s_tmp = &s[i];
 
-    if (reversed){
+    const size_t cs_size = size();
+    const size_t nbytes = round_to_bytes(cs_size);
 
-        for (; (*s_tmp != '\0') && (pos != -1); --pos, ++s_tmp) {
+    size_t nb_match = 0;
 
-            if (*s_tmp != bases[3 - ((data[pos >> 2] >> ((pos & 0x3) << 1)) & 0x03)]) break;
+    while (true) {
+
+        size_t len; // Number of bases of the sequence to compare
+        uint64_t w_cs; // Bases of the sequence to compare, in the order in which they are compared to s
+
+        if (reversed) {
+
+            if (pos < 0) break;
+
+            const size_t start = (pos >= 32) ? pos - 31 : 0;
+
+            len = pos - start + 1;
+            w_cs = reverseWord(~get_word(data, nbytes, start)) >> ((32 - len) << 1); // Reverse-complement
+
+            pos -= len;
         }
-    }
-    else {
+        else {
 
-        const size_t cs_size = size();
+            if (static_cast<size_t>(pos) >= cs_size) break;
 
-        for (; (*s_tmp != '\0') && (pos < cs_size); ++pos, ++s_tmp) {
+            len = (cs_size - pos < 32) ? cs_size - pos : 32;
+            w_cs = get_word(data, nbytes, pos);
 
-            if (*s_tmp != bases[(data[pos >> 2] >> ((pos & 0x3) << 1)) & 0x3]) break;
+            pos += len;
         }
+
+        uint64_t w_s;
+
+        const size_t nb_packed = pack_word(s_tmp + nb_match, len, (len_s != 0) && (i + nb_match + 32 <= len_s), w_s);
+        const uint64_t diff = (w_s ^ w_cs) & mask_word(nb_packed);
+
+        if (diff != 0) return nb_match + (__builtin_ctzll(diff) >> 1);
+
+        nb_match += nb_packed;
+
+        if (nb_packed != 32) break;
     }
 
-    return s_tmp - &s[i];
+    return nb_match;
 }
 
 /*size_t CompressedSequence::bw_jump(const char *s, const size_t i, int pos, const bool reversed) const {
@@ -567,12 +694,9 @@ size_t CompressedSequence::jump(const char *s, const size_t i, int pos, const bo
 
 void CompressedSequence::clear() {
 
-    if (!isShort() && (asPointer._capacity > 0) && (asPointer._data != NULL)) {
-
-        delete[] asPointer._data;
+    if (!isShort() && (asPointer._capacity > 0) && (asPointer._data != NULL)) release_data(asPointer._data);
 
-        asPointer._data = NULL;
-    }
+    initShort();
 }
 
 const char CompressedSequence::bases[256] = {
@@ -14,6 +14,7 @@
  *  - Get kmers from a sequence
  *  - Get length of a sequence
  *  - Easily get length of matching substring from a given string
+ *  - Copies of a long sequence share its bases until one of them is modified (copy-on-write)
  * */
 class CompressedSequence {
 
@@ -63,6 +64,7 @@ class CompressedSequence {
         CompressedSequence rev() const;
 
         size_t jump(const char *s, const size_t i, int pos, const bool reversed) const;
+        size_t jump(const char *s, const size_t i, int pos, const bool reversed, const size_t len_s) const;
         //size_t bw_jump(const char *s, const size_t i, int pos, const bool reversed) const;
 
         int64_t findKmer(const Kmer& km) const;
@@ -93,6 +95,9 @@ class CompressedSequence {
 
         void _resize_and_copy(const size_t new_cap, const size_t copy_limit);
 
+        void shareData(const CompressedSequence& o);
+        unsigned char* getWritePointer();
+
         BFG_INLINE void initShort() {
 
             asBits._size = 1; // short and size 0
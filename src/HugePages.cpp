@@ -0,0 +1,76 @@
+#include <cstdlib>
+#include <cstdint>
+
+#include <sys/mman.h>
+
+#include "HugePages.hpp"
+
+#if !defined(MAP_ANONYMOUS) && defined(MAP_ANON)
+#define MAP_ANONYMOUS MAP_ANON
+#endif
+
+// Memory blocks of at least HUGE_PAGE_SZ bytes are mapped, rounded up to a multiple of HUGE_PAGE_SZ. The backing of a block
+// only depends on its size so freeHugePages() releases it the same way it was allocated.
+static inline bool isMapped(const size_t sz) {
+
+    #if defined(BFG_NO_HUGE_PAGES)
+    return false;
+    #else
+    return (sz >= HUGE_PAGE_SZ);
+    #endif
+}
+
+static inline size_t roundUpHugePage(const size_t sz) {
+
+    return (sz + HUGE_PAGE_SZ - 1) & ~static_cast<size_t>(HUGE_PAGE_SZ - 1);
+}
+
+void* allocHugePages(const size_t sz) {
+
+    if (!isMapped(sz)){
+
+        void* ptr = nullptr;
+
+        // posix_memalign() might return a null pointer for a size of 0
+        if (posix_memalign(&ptr, 64, (sz == 0) ? 1 : sz) != 0) return nullptr;
+
+        return ptr;
+    }
+
+    const size_t map_sz = roundUpHugePage(sz);
+
+    #if defined(BFG_HUGE_PAGES_HUGETLBFS) && defined(MAP_HUGETLB)
+    {
+        void* ptr = mmap(nullptr, map_sz, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+
+        if (ptr != MAP_FAILED) return ptr; // Pages of the hugetlbfs pool are aligned on their size
+    }
+    #endif
+
+    // Map one more huge page to align the block on a huge page boundary, then unmap what is not used on each side
+    char* ptr = static_cast<char*>(mmap(nullptr, map_sz + HUGE_PAGE_SZ, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+
+    if (ptr == MAP_FAILED) return nullptr;
+
+    char* ptr_aligned = reinterpret_cast<char*>(roundUpHugePage(reinterpret_cast<uintptr_t>(ptr)));
+
+    const size_t sz_before = ptr_aligned - ptr;
+    const size_t sz_after = HUGE_PAGE_SZ - sz_before;
+
+    if (sz_before != 0) munmap(ptr, sz_before);
+    if (sz_after != 0) munmap(ptr_aligned + map_sz, sz_after);
+
+    #if defined(MADV_HUGEPAGE)
+    madvise(ptr_aligned, map_sz, MADV_HUGEPAGE); // Advisory only: the block is usable even if it fails
+    #endif
+
+    return ptr_aligned;
+}
+
+void freeHugePages(void* ptr, const size_t sz) {
+
+    if (ptr == nullptr) return;
+
+    if (isMapped(sz)) munmap(ptr, roundUpHugePage(sz));
+    else free(ptr);
+}
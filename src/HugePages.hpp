@@ -0,0 +1,68 @@
+#ifndef BIFROST_HUGE_PAGES_HPP
+#define BIFROST_HUGE_PAGES_HPP
+
+#include <cstddef>
+#include <new>
+
+/*
+* Allocation of the large tables probed at random (Blocked Bloom filter, minimizer index, k-mer hash tables). Tables of
+* HUGE_PAGE_SZ bytes or more are mapped on boundaries of 2 MB and backed by huge pages so each TLB entry covers 2 MB instead
+* of 4 kB. Smaller tables are allocated on the heap. The backing is selected when Bifrost is compiled (HUGE_PAGES option):
+* - transparent (default): pages are mapped anonymously and the kernel is advised to use transparent huge pages.
+* - hugetlbfs: pages are taken from the pool of huge pages reserved by the system administrator (vm.nr_hugepages). If the
+*   pool is too small, transparent huge pages are used instead.
+* - OFF: all tables are allocated on the heap.
+*/
+
+#define HUGE_PAGE_SZ (0x200000ULL)
+
+/**
+* Allocate a memory block backed by huge pages if it is large enough.
+* @param sz is the size of the memory block in bytes.
+* @return a pointer to the memory block (aligned on 2 MB if it is backed by huge pages, on 64 bytes otherwise) or a null
+* pointer if the block could not be allocated. The block must be released with freeHugePages() and the same size.
+*/
+void* allocHugePages(const size_t sz);
+
+/**
+* Release a memory block allocated with allocHugePages().
+* @param ptr is a pointer to the memory block. Nothing is done if it is a null pointer.
+* @param sz is the size of the memory block in bytes, as given to allocHugePages().
+*/
+void freeHugePages(void* ptr, const size_t sz);
+
+/**
+* Allocate an array possibly backed by huge pages and default-initialize its elements (as new T[n] does).
+* Throws std::bad_alloc if the array could not be allocated.
+* @param n is the number of elements in the array.
+* @return a pointer to the array, which must be released with deleteHugePagesArray() and the same number of elements.
+*/
+template<typename T>
+T* newHugePagesArray(const size_t n) {
+
+    T* arr = static_cast<T*>(allocHugePages(n * sizeof(T)));
+
+    if (arr == nullptr) throw std::bad_alloc();
+
+    for (size_t i = 0; i < n; ++i) new (&arr[i]) T;
+
+    return arr;
+}
+
+/**
+* Destruct the elements of an array allocated with newHugePagesArray() and release the array.
+* @param arr is a pointer to the array. Nothing is done if it is a null pointer.
+* @param n is the number of elements in the array, as given to newHugePagesArray().
+*/
+template<typename T>
+void deleteHugePagesArray(T* arr, const size_t n) {
+
+    if (arr != nullptr){
+
+        for (size_t i = 0; i < n; ++i) arr[i].~T();
+
+        freeHugePages(arr, n * sizeof(T));
+    }
+}
+
+#endif
@@ -1,41 +1,77 @@
 #include "Kmer.hpp"
+#include "PackedDNA.hpp"
 
 using namespace std;
 
-static const uint64_t twin_table[256] = {
-  0xFF, 0xBF, 0x7F, 0x3F, 0xEF, 0xAF, 0x6F, 0x2F,
-  0xDF, 0x9F, 0x5F, 0x1F, 0xCF, 0x8F, 0x4F, 0x0F,
-  0xFB, 0xBB, 0x7B, 0x3B, 0xEB, 0xAB, 0x6B, 0x2B,
-  0xDB, 0x9B, 0x5B, 0x1B, 0xCB, 0x8B, 0x4B, 0x0B,
-  0xF7, 0xB7, 0x77, 0x37, 0xE7, 0xA7, 0x67, 0x27,
-  0xD7, 0x97, 0x57, 0x17, 0xC7, 0x87, 0x47, 0x07,
-  0xF3, 0xB3, 0x73, 0x33, 0xE3, 0xA3, 0x63, 0x23,
-  0xD3, 0x93, 0x53, 0x13, 0xC3, 0x83, 0x43, 0x03,
-  0xFE, 0xBE, 0x7E, 0x3E, 0xEE, 0xAE, 0x6E, 0x2E,
-  0xDE, 0x9E, 0x5E, 0x1E, 0xCE, 0x8E, 0x4E, 0x0E,
-  0xFA, 0xBA, 0x7A, 0x3A, 0xEA, 0xAA, 0x6A, 0x2A,
-  0xDA, 0x9A, 0x5A, 0x1A, 0xCA, 0x8A, 0x4A, 0x0A,
-  0xF6, 0xB6, 0x76, 0x36, 0xE6, 0xA6, 0x66, 0x26,
-  0xD6, 0x96, 0x56, 0x16, 0xC6, 0x86, 0x46, 0x06,
-  0xF2, 0xB2, 0x72, 0x32, 0xE2, 0xA2, 0x62, 0x22,
-  0xD2, 0x92, 0x52, 0x12, 0xC2, 0x82, 0x42, 0x02,
-  0xFD, 0xBD, 0x7D, 0x3D, 0xED, 0xAD, 0x6D, 0x2D,
-  0xDD, 0x9D, 0x5D, 0x1D, 0xCD, 0x8D, 0x4D, 0x0D,
-  0xF9, 0xB9, 0x79, 0x39, 0xE9, 0xA9, 0x69, 0x29,
-  0xD9, 0x99, 0x59, 0x19, 0xC9, 0x89, 0x49, 0x09,
-  0xF5, 0xB5, 0x75, 0x35, 0xE5, 0xA5, 0x65, 0x25,
-  0xD5, 0x95, 0x55, 0x15, 0xC5, 0x85, 0x45, 0x05,
-  0xF1, 0xB1, 0x71, 0x31, 0xE1, 0xA1, 0x61, 0x21,
-  0xD1, 0x91, 0x51, 0x11, 0xC1, 0x81, 0x41, 0x01,
-  0xFC, 0xBC, 0x7C, 0x3C, 0xEC, 0xAC, 0x6C, 0x2C,
-  0xDC, 0x9C, 0x5C, 0x1C, 0xCC, 0x8C, 0x4C, 0x0C,
-  0xF8, 0xB8, 0x78, 0x38, 0xE8, 0xA8, 0x68, 0x28,
-  0xD8, 0x98, 0x58, 0x18, 0xC8, 0x88, 0x48, 0x08,
-  0xF4, 0xB4, 0x74, 0x34, 0xE4, 0xA4, 0x64, 0x24,
-  0xD4, 0x94, 0x54, 0x14, 0xC4, 0x84, 0x44, 0x04,
-  0xF0, 0xB0, 0x70, 0x30, 0xE0, 0xA0, 0x60, 0x20,
-  0xD0, 0x90, 0x50, 0x10, 0xC0, 0x80, 0x40, 0x00
-};
+#if defined(__AVX2__) || defined(__SSSE3__)
+#include <immintrin.h>
+#endif
+
+// Reverse-complement each of the nlongs words of in into out (the order of the words is not reversed).
+// The SIMD versions look up the reverse-complement of the low and high nibble of each byte with pshufb
+// and reverse the bytes of each 64 bits word with a second pshufb.
+static BFG_INLINE void twin_words(const uint64_t* in, uint64_t* out, const size_t nlongs) {
+
+    size_t i = 0;
+
+    #if defined(__AVX2__)
+    {
+        const __m256i rc_lo = _mm256_setr_epi8( // Reverse-complement of low nibble, moved to high nibble
+            0xF0, 0xB0, 0x70, 0x30, 0xE0, 0xA0, 0x60, 0x20, 0xD0, 0x90, 0x50, 0x10, 0xC0, 0x80, 0x40, 0x00,
+            0xF0, 0xB0, 0x70, 0x30, 0xE0, 0xA0, 0x60, 0x20, 0xD0, 0x90, 0x50, 0x10, 0xC0, 0x80, 0x40, 0x00
+        );
+
+        const __m256i rc_hi = _mm256_setr_epi8( // Reverse-complement of high nibble, moved to low nibble
+            0x0F, 0x0B, 0x07, 0x03, 0x0E, 0x0A, 0x06, 0x02, 0x0D, 0x09, 0x05, 0x01, 0x0C, 0x08, 0x04, 0x00,
+            0x0F, 0x0B, 0x07, 0x03, 0x0E, 0x0A, 0x06, 0x02, 0x0D, 0x09, 0x05, 0x01, 0x0C, 0x08, 0x04, 0x00
+        );
+
+        const __m256i bswap = _mm256_setr_epi8(
+            7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8,
+            7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8
+        );
+
+        const __m256i mask_nibble = _mm256_set1_epi8(0x0F);
+
+        for (; i + 4 <= nlongs; i += 4) {
+
+            const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+            const __m256i lo = _mm256_and_si256(v, mask_nibble);
+            const __m256i hi = _mm256_and_si256(_mm256_srli_epi16(v, 4), mask_nibble);
+            const __m256i rc = _mm256_or_si256(_mm256_shuffle_epi8(rc_lo, lo), _mm256_shuffle_epi8(rc_hi, hi));
+
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), _mm256_shuffle_epi8(rc, bswap));
+        }
+    }
+    #endif
+
+    #if defined(__SSSE3__)
+    {
+        const __m128i rc_lo = _mm_setr_epi8(
+            0xF0, 0xB0, 0x70, 0x30, 0xE0, 0xA0, 0x60, 0x20, 0xD0, 0x90, 0x50, 0x10, 0xC0, 0x80, 0x40, 0x00
+        );
+
+        const __m128i rc_hi = _mm_setr_epi8(
+            0x0F, 0x0B, 0x07, 0x03, 0x0E, 0x0A, 0x06, 0x02, 0x0D, 0x09, 0x05, 0x01, 0x0C, 0x08, 0x04, 0x00
+        );
+
+        const __m128i bswap = _mm_setr_epi8(7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8);
+        const __m128i mask_nibble = _mm_set1_epi8(0x0F);
+
+        for (; i + 2 <= nlongs; i += 2) {
+
+            const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+            const __m128i lo = _mm_and_si128(v, mask_nibble);
+            const __m128i hi = _mm_and_si128(_mm_srli_epi16(v, 4), mask_nibble);
+            const __m128i rc = _mm_or_si128(_mm_shuffle_epi8(rc_lo, lo), _mm_shuffle_epi8(rc_hi, hi));
+
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_shuffle_epi8(rc, bswap));
+        }
+    }
+    #endif
+
+    for (; i < nlongs; ++i) out[i] = twinWord(in[i]);
+}
 
 Kmer::Kmer() {
 
@@ -91,18 +127,15 @@ bool Kmer::operator!=(const Kmer& o) const {
 
 void Kmer::set_kmer(const char* s)  {
 
-    for (size_t i = 0; i < MAX_K/32; ++i) longs[i] = 0;
-
-    for (size_t i = 0, j, l; i < k; ++i) {
+    uint32_t non_acgt;
 
-        j = 62 - ((i & 0x1F) << 1);
-        l = i >> 5;
+    for (size_t i = 0; i < MAX_K/32; ++i) longs[i] = 0;
 
-        const size_t x = ((*s) & 4) >> 1;
+    for (size_t i = 0; i < k; i += 32) {
 
-        longs[l] |= ((x + ((x ^ (*s & 2)) >> 1)) << j);
+        const size_t len = (k - i < 32) ? k - i : 32;
 
-        ++s;
+        longs[i >> 5] = reverseWord(encodeWord(s + i, len, non_acgt));
     }
 }
 
@@ -119,19 +152,14 @@ Kmer Kmer::twin() const {
 
     const size_t nlongs = (k+31)/32;
 
-    for (size_t i = 0; i < nlongs; ++i) {
+    if (nlongs == 1) km.longs[0] = twinWord(longs[0]);
+    else {
 
-        const uint64_t v = longs[i];
+        uint64_t tw[MAX_K/32];
 
-        km.longs[nlongs-1-i] =
-          (twin_table[v & 0xFF] << 56) |
-          (twin_table[(v>>8) & 0xFF] << 48) |
-          (twin_table[(v>>16) & 0xFF] << 40) |
-          (twin_table[(v>>24) & 0xFF] << 32) |
-          (twin_table[(v>>32) & 0xFF] << 24) |
-          (twin_table[(v>>40) & 0xFF] << 16) |
-          (twin_table[(v>>48) & 0xFF] << 8)  |
-          (twin_table[(v>>56)]);
+        twin_words(longs, tw, nlongs);
+
+        for (size_t i = 0; i < nlongs; ++i) km.longs[nlongs-1-i] = tw[i];
     }
 
     const size_t mod = (k & 0x1f) << 1; // (k % 32) * 2
@@ -225,6 +253,23 @@ Kmer Kmer::backwardBase(const char b) const {
     return km;
 }
 
+void Kmer::selfBackwardBase(const char b) {
+
+    const size_t nlongs = (k+31)/32 - 1;
+
+    longs[nlongs] >>= 2;
+    longs[nlongs] &= (k & 0x1f) ? (((1ULL << ((k & 0x1f) << 1)) - 1) << ((32-(k & 0x1f)) << 1)) : ~0ULL;
+
+    for (size_t i = 1; i < nlongs + 1; ++i) {
+
+        longs[nlongs-i+1] |= (longs[nlongs-i] & 3ULL) << 62;
+        longs[nlongs-i] >>= 2;
+    }
+
+    const uint64_t x = (b & 4) >> 1;
+
+    longs[0] |= (x + ((x ^ (b & 2)) >> 1)) << 62;
+}
 
 // use:  km.printBinary();
 // pre:
@@ -252,21 +297,9 @@ std::string Kmer::getBinary() const {
 // post: s[0,...,k-1] is the DNA string for the Kmer km and s[k] = '\0'
 void Kmer::toString(char *s) const {
 
-    const size_t nlongs = (k + 31) / 32;
-
-    for (size_t i = 0, j = 0; j < nlongs; ++j) {
-
-        uint64_t tmp = longs[j];
-        const size_t end = k < i + 32 ? k : i + 32;
-
-        for (; i < end; ++i, ++s, tmp <<= 2){
-
-            const char v = tmp >> 62;
-            *s = 0x40 | (v + 1) | (0x1 << ((v - 1) << 1));
-        }
-    }
+    for (size_t i = 0; i < k; i += 32) decodeWord(reverseWord(longs[i >> 5]), s + i, (k - i < 32) ? k - i : 32);
 
-    *s = '\0';
+    s[k] = '\0';
 }
 
 char Kmer::getChar(const size_t offset) const {
@@ -351,6 +384,25 @@ Minimizer::Minimizer(const char *s) {
     set_minimizer(s);
 }
 
+Minimizer::Minimizer(const Kmer& km, const size_t offset) {
+
+    const size_t w = offset >> 5;
+    const size_t shift = (offset & 0x1f) << 1;
+
+    for (size_t i = 0; i < MAX_G/32; ++i) {
+
+        const size_t j = w + i;
+
+        uint64_t v = (j < Kmer::MAX_K/32) ? (km.longs[j] << shift) : 0;
+
+        if ((shift != 0) && (j + 1 < Kmer::MAX_K/32)) v |= km.longs[j + 1] >> (64 - shift);
+
+        const size_t nb_bases = (g > (i << 5)) ? std::min(g - (i << 5), static_cast<size_t>(32)) : 0; // Bases of the minimizer in word i
+
+        longs[i] = (nb_bases == 0) ? 0 : (v & (0xffffffffffffffffULL << (64 - (nb_bases << 1))));
+    }
+}
+
 Minimizer& Minimizer::operator=(const Minimizer& o) {
 
     if (this != &o) {
@@ -395,18 +447,15 @@ bool Minimizer::operator!=(const Minimizer& o) const {
 
 void Minimizer::set_minimizer(const char *s)  {
 
-    for (size_t i = 0; i < MAX_G/32; ++i) longs[i] = 0;
-
-    for (size_t i = 0, j, l; i < g; ++i) {
+    uint32_t non_acgt;
 
-        j = 62 - ((i & 0x1f) << 1);
-        l = i >> 5;
+    for (size_t i = 0; i < MAX_G/32; ++i) longs[i] = 0;
 
-        const size_t x = ((*s) & 4) >> 1;
+    for (size_t i = 0; i < g; i += 32) {
 
-        longs[l] |= ((x + ((x ^ (*s & 2)) >> 1)) << j);
+        const size_t len = (g - i < 32) ? g - i : 32;
 
-        s++;
+        longs[i >> 5] = reverseWord(encodeWord(s + i, len, non_acgt));
     }
 }
 
@@ -423,14 +472,14 @@ Minimizer Minimizer::twin() const {
 
     Minimizer minz(*this);
 
-    for (size_t i = 0; i < nlongs; ++i) {
+    if (nlongs == 1) minz.longs[0] = twinWord(longs[0]);
+    else {
+
+        uint64_t tw[MAX_G/32];
 
-        const uint64_t v = longs[i];
+        twin_words(longs, tw, nlongs);
 
-        minz.longs[nlongs-1-i] = (twin_table[v & 0xFF] << 56) | (twin_table[(v>>8) & 0xFF] << 48) |
-                                    (twin_table[(v>>16) & 0xFF] << 40) | (twin_table[(v>>24) & 0xFF] << 32) |
-                                    (twin_table[(v>>32) & 0xFF] << 24) | (twin_table[(v>>40) & 0xFF] << 16) |
-                                    (twin_table[(v>>48) & 0xFF] << 8)  | (twin_table[(v>>56)]);
+        for (size_t i = 0; i < nlongs; ++i) minz.longs[nlongs-1-i] = tw[i];
     }
 
     const size_t mod = (g & 0x1f) << 1; // (g % 32) * 2
@@ -527,23 +576,9 @@ std::string Minimizer::getBinary() const {
 
 void Minimizer::toString(char *s) const {
 
-    const size_t nlongs = (g + 31) / 32;
-
-    for (size_t i = 0, j = 0; j < nlongs; ++j) {
-
-        uint64_t tmp = longs[j];
-
-        const size_t end = g < i + 32 ? g : i + 32;
-
-        for (; i < end; ++i, ++s, tmp <<= 2){
-
-            const char v = tmp >> 62;
-
-            *s = 0x40 | (v + 1) | (0x1 << ((v - 1) << 1));
-        }
-    }
+    for (size_t i = 0; i < g; i += 32) decodeWord(reverseWord(longs[i >> 5]), s + i, (g - i < 32) ? g - i : 32);
 
-    *s = '\0';
+    s[g] = '\0';
 }
 
 std::string Minimizer::toString() const {
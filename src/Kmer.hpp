@@ -39,9 +39,12 @@ class CompressedSequence;
 * Keep in mind that increasing MAX_KMER_SIZE increases memory usage (k=31 uses 8 bytes of memory per k-mer
 * while k=63 uses 16 bytes of memory per k-mer).
 */
+class Minimizer;
+
 class Kmer {
 
     friend class CompressedSequence;
+    friend class Minimizer;
 
     public:
 
@@ -154,12 +157,27 @@ class Kmer {
         */
         void selfForwardBase(const char b);
 
+        /** Shift the current k-mer of one base on the right with one new character on the left.
+        * @param b is a new character to add on the left (as a first character) after shifting the current
+        * k-mer. It must be either 'A', 'C', 'G' or 'T'.
+        */
+        void selfBackwardBase(const char b);
+
         /** Get the character at a given position in a k-mer.
         * @param offset is the position of the character to get in the k-mer.
         * @return the character to get in the k-mer
         */
         char getChar(const size_t offset) const;
 
+        /** Get the 2-bit code of the character at a given position in a k-mer (A=0, C=1, G=2, T=3).
+        * @param offset is the position of the character to get in the k-mer.
+        * @return the 2-bit code of the character.
+        */
+        BFG_INLINE uint8_t getCode(const size_t offset) const {
+
+            return static_cast<uint8_t>((longs[offset >> 5] >> (62 - ((offset & 0x1f) << 1))) & 0x3);
+        }
+
        /** Set a character at a given position in a k-mer.
         * @param offset is the position of the character to set in the k-mer.
         * @param b is the character to set. It must be either 'A', 'C', 'G' or 'T'.
@@ -236,6 +254,7 @@ class Minimizer {
         Minimizer();
         Minimizer(const Minimizer& o);
         explicit Minimizer(const char *s);
+        Minimizer(const Kmer& km, const size_t offset); // Minimizer starting at position offset of a k-mer
 
         Minimizer& operator=(const Minimizer& o);
 
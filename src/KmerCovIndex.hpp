@@ -8,6 +8,10 @@
 #include "Kmer.hpp"
 #include "rw_spin_lock.h"
 
+// Copies of an index share its blocks until one of them is modified (copy-on-write): copying an index is O(number of blocks)
+// and a block is duplicated by the first modification of one of its k-mers in a copy (including the access to its data through
+// a non-constant pointer). The locks of the blocks belong to the index and not to the blocks, so a thread holding the lock of a
+// block can duplicate it while other threads modify other blocks.
 template<typename T = void>
 class KmerCovIndex {
 
@@ -69,23 +73,21 @@ class KmerCovIndex {
 
         BFG_INLINE void lock(const size_t idx) {
 
-            if (idx < sz) v_blocks[idx >> shift_div]->lck.acquire();
+            if (idx < sz) v_lck[(idx >> shift_div) & (nb_locks - 1)].acquire();
         }
 
         BFG_INLINE void unlock(const size_t idx) {
 
-            if (idx < sz) v_blocks[idx >> shift_div]->lck.release();
+            if (idx < sz) v_lck[(idx >> shift_div) & (nb_locks - 1)].release();
         }
 
         BFG_INLINE void cover_thread_safe(const size_t idx) {
 
             if (idx < sz){
 
-                v_blocks[idx >> shift_div]->lck.acquire();
-
+                lock(idx);
                 cover(idx);
-
-                v_blocks[idx >> shift_div]->lck.release();
+                unlock(idx);
             }
         }
 
@@ -93,11 +95,9 @@ class KmerCovIndex {
 
             if (idx < sz){
 
-                v_blocks[idx >> shift_div]->lck.acquire();
-
+                lock(idx);
                 uncover(idx);
-
-                v_blocks[idx >> shift_div]->lck.release();
+                unlock(idx);
             }
         }
 
@@ -106,17 +106,44 @@ class KmerCovIndex {
     private:
 
         static const size_t block_sz = 1024; // Always a power of 2
+        static const size_t nb_locks = 256; // Always a power of 2
 
         template<typename U>
         struct Block {
 
+            Block() : refs(1) {}
+
+            Block(const Block& o) : bc_cov(o.bc_cov), refs(1) {
+
+                std::copy(o.km_block, o.km_block + block_sz, km_block);
+                std::copy(o.data_block, o.data_block + block_sz, data_block);
+            }
+
             Kmer km_block[block_sz];
             U data_block[block_sz];
 
-            SpinLock lck;
             BitContainer bc_cov;
+
+            atomic<size_t> refs; // Number of indexes sharing the block
         };
 
+        static void release(Block<T>* block);
+
+        // Duplicate block id_block if it is shared with another index
+        BFG_INLINE void unshare(const size_t id_block) {
+
+            Block<T>*& block = v_blocks[id_block];
+
+            if (block->refs.load() != 1) {
+
+                Block<T>* new_block = new Block<T>(*block);
+
+                release(block);
+
+                block = new_block;
+            }
+        }
+
         static size_t cov_full;
 
         size_t shift_div;
@@ -124,6 +151,8 @@ class KmerCovIndex {
         size_t sz;
 
         vector<Block<T>*> v_blocks;
+
+        vector<SpinLock> v_lck;
 };
 
 // Declare template specializations for type void
@@ -134,16 +163,22 @@ template<>
 template<>
 struct KmerCovIndex<void>::Block<void> {
 
+    Block() : refs(1) {}
+
+    Block(const Block& o) : bc_cov(o.bc_cov), refs(1) {
+
+        std::copy(o.km_block, o.km_block + block_sz, km_block);
+    }
+
     Kmer km_block[block_sz];
 
-    SpinLock lck;
     BitContainer bc_cov;
+
+    atomic<size_t> refs; // Number of indexes sharing the block
 };
 
 template<typename T> size_t KmerCovIndex<T>::cov_full = 2;
 
-template<> inline KmerCovIndex<void>::KmerCovIndex(const KmerCovIndex& o);
-template<> inline KmerCovIndex<void>& KmerCovIndex<void>::operator=(const KmerCovIndex<void>& o);
 template<> inline bool KmerCovIndex<void>::swap(const size_t idx1, const size_t idx2);
 template<> inline void KmerCovIndex<void>::remove(const size_t idx1);
 template<> inline void KmerCovIndex<void>::resize(const size_t new_sz);
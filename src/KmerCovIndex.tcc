@@ -1,37 +1,14 @@
 template<typename T>
-KmerCovIndex<T>::KmerCovIndex() : sz(0), shift_div(__builtin_ffsll(block_sz) - 1), mask_mod(block_sz - 1) {}
+KmerCovIndex<T>::KmerCovIndex() : sz(0), shift_div(__builtin_ffsll(block_sz) - 1), mask_mod(block_sz - 1), v_lck(nb_locks) {}
 
 template<typename T>
-KmerCovIndex<T>::KmerCovIndex(const KmerCovIndex& o) : sz(o.sz), shift_div(o.shift_div), mask_mod(o.mask_mod) {
+KmerCovIndex<T>::KmerCovIndex(const KmerCovIndex& o) : sz(o.sz), shift_div(o.shift_div), mask_mod(o.mask_mod), v_blocks(o.v_blocks), v_lck(nb_locks) {
 
-    v_blocks = vector<Block<T>*>(o.v_blocks.size());
-
-    for (size_t i = 0; i < v_blocks.size(); ++i) {
-
-        v_blocks[i] = new Block<T>;
-        v_blocks[i]->bc_cov = o.v_blocks[i]->bc_cov;
-
-        std::copy(o.v_blocks[i]->km_block, o.v_blocks[i]->km_block + block_sz, v_blocks[i]->km_block);
-        std::copy(o.v_blocks[i]->data_block, o.v_blocks[i]->data_block + block_sz, v_blocks[i]->data_block);
-    }
-}
-
-template<>
-inline KmerCovIndex<void>::KmerCovIndex(const KmerCovIndex& o) : sz(o.sz), shift_div(o.shift_div), mask_mod(o.mask_mod) {
-
-    v_blocks = vector<Block<void>*>(o.v_blocks.size());
-
-    for (size_t i = 0; i < v_blocks.size(); ++i) {
-
-        v_blocks[i] = new Block<void>;
-        v_blocks[i]->bc_cov = o.v_blocks[i]->bc_cov;
-
-        std::copy(o.v_blocks[i]->km_block, o.v_blocks[i]->km_block + block_sz, v_blocks[i]->km_block);
-    }
+    for (auto block : v_blocks) block->refs.fetch_add(1);
 }
 
 template<typename T>
-KmerCovIndex<T>::KmerCovIndex(KmerCovIndex&& o) :  sz(o.sz), shift_div(o.shift_div), mask_mod(o.mask_mod), v_blocks(move(o.v_blocks)) {
+KmerCovIndex<T>::KmerCovIndex(KmerCovIndex&& o) :  sz(o.sz), shift_div(o.shift_div), mask_mod(o.mask_mod), v_blocks(move(o.v_blocks)), v_lck(nb_locks) {
 
     o.clear();
 }
@@ -53,16 +30,9 @@ KmerCovIndex<T>& KmerCovIndex<T>::operator=(const KmerCovIndex<T>& o) {
         shift_div = o.shift_div;
         mask_mod = o.mask_mod;
 
-        v_blocks = vector<Block<T>*>(o.v_blocks.size());
+        v_blocks = o.v_blocks;
 
-        for (size_t i = 0; i < v_blocks.size(); ++i) {
-
-            v_blocks[i] = new Block<T>;
-            v_blocks[i]->bc_cov = o.v_blocks[i]->bc_cov;
-
-            std::copy(o.v_blocks[i]->km_block, o.v_blocks[i]->km_block + block_sz, v_blocks[i]->km_block);
-            std::copy(o.v_blocks[i]->data_block, o.v_blocks[i]->data_block + block_sz, v_blocks[i]->data_block);
-        }
+        for (auto block : v_blocks) block->refs.fetch_add(1);
     }
 
     return *this;
@@ -82,11 +52,14 @@ KmerCovIndex<T>& KmerCovIndex<T>::toData(KmerCovIndex<void>&& o, const size_t nb
         for (size_t i = start; i < end; ++i) {
 
             v_blocks[i] = new Block<T>;
-            v_blocks[i]->bc_cov = move(o.v_blocks[i]->bc_cov);
+
+            // Coverage of a block shared with another index is copied, not moved
+            if (o.v_blocks[i]->refs.load() == 1) v_blocks[i]->bc_cov = move(o.v_blocks[i]->bc_cov);
+            else v_blocks[i]->bc_cov = o.v_blocks[i]->bc_cov;
 
             std::copy(o.v_blocks[i]->km_block, o.v_blocks[i]->km_block + block_sz, v_blocks[i]->km_block);
 
-            delete o.v_blocks[i];
+            KmerCovIndex<void>::release(o.v_blocks[i]);
 
             o.v_blocks[i] = nullptr;
         }
@@ -121,31 +94,6 @@ KmerCovIndex<T>& KmerCovIndex<T>::toData(KmerCovIndex<void>&& o, const size_t nb
     return *this;
 }
 
-template<>
-inline KmerCovIndex<void>& KmerCovIndex<void>::operator=(const KmerCovIndex<void>& o) {
-
-    if (this != &o) {
-
-        clear();
-
-        sz = o.sz;
-        shift_div = o.shift_div;
-        mask_mod = o.mask_mod;
-
-        v_blocks = vector<Block<void>*>(o.v_blocks.size());
-
-        for (size_t i = 0; i < v_blocks.size(); ++i) {
-
-            v_blocks[i] = new Block<void>;
-            v_blocks[i]->bc_cov = o.v_blocks[i]->bc_cov;
-
-            std::copy(o.v_blocks[i]->km_block, o.v_blocks[i]->km_block + block_sz, v_blocks[i]->km_block);
-        }
-    }
-
-    return *this;
-}
-
 template<typename T>
 KmerCovIndex<T>& KmerCovIndex<T>::operator=(KmerCovIndex<T>&& o) {
 
@@ -172,12 +120,19 @@ void KmerCovIndex<T>::clear() {
 
     for (auto block : v_blocks) {
 
-        if (block != nullptr) delete block;
+        if (block != nullptr) release(block);
     }
 
     v_blocks.clear();
 }
 
+// Release a block used by one index less. A block used by no index is deleted.
+template<typename T>
+void KmerCovIndex<T>::release(Block<T>* block) {
+
+    if (block->refs.fetch_sub(1) == 1) delete block;
+}
+
 template<typename T>
 void KmerCovIndex<T>::push_back(const Kmer& km) {
 
@@ -188,6 +143,7 @@ void KmerCovIndex<T>::push_back(const Kmer& km) {
         v_blocks.push_back(nullptr);
         v_blocks.back() = new Block<T>;
     }
+    else unshare(sz >> shift_div);
 
     v_blocks[sz >> shift_div]->km_block[mod] = km;
 
@@ -203,6 +159,8 @@ bool KmerCovIndex<T>::set(const size_t idx, const Kmer& km) {
 
     const size_t idx_mod = idx & mask_mod;
 
+    unshare(idx >> shift_div);
+
     Block<T>* block = v_blocks[idx >> shift_div];
 
     block->km_block[idx_mod] = km;
@@ -225,6 +183,8 @@ bool KmerCovIndex<T>::set(const size_t idx, const Kmer& km, const size_t cov) {
 
     const size_t idx_mod = idx & mask_mod;
 
+    unshare(idx >> shift_div);
+
     Block<T>* block = v_blocks[idx >> shift_div];
 
     block->km_block[idx_mod] = km;
@@ -245,6 +205,8 @@ void KmerCovIndex<T>::setFull(const size_t idx) {
 
     if (idx < sz){
 
+        unshare(idx >> shift_div);
+
         Block<T>* block = v_blocks[idx >> shift_div];
 
         const size_t idx_mod = idx & mask_mod;
@@ -289,6 +251,8 @@ void KmerCovIndex<T>::cover(const size_t idx) {
 
         if (cov != cov_full){
 
+            unshare(idx >> shift_div);
+
             Block<T>* block = v_blocks[idx >> shift_div];
 
             const size_t idx_mod = idx & mask_mod;
@@ -310,6 +274,8 @@ void KmerCovIndex<T>::uncover(const size_t idx) {
 
         if (cov != 0){
 
+            unshare(idx >> shift_div);
+
             Block<T>* block = v_blocks[idx >> shift_div];
 
             const size_t idx_mod = idx & mask_mod;
@@ -335,6 +301,9 @@ bool KmerCovIndex<T>::swap(const size_t idx1, const size_t idx2) {
             const size_t idx1_mod = idx1 & mask_mod;
             const size_t idx2_mod = idx2 & mask_mod;
 
+            unshare(idx1 >> shift_div);
+            unshare(idx2 >> shift_div);
+
             Block<T>* block1 = v_blocks[idx1 >> shift_div];
             Block<T>* block2 = v_blocks[idx2 >> shift_div];
 
@@ -372,6 +341,9 @@ inline bool KmerCovIndex<void>::swap(const size_t idx1, const size_t idx2) {
             const size_t idx1_mod = idx1 & mask_mod;
             const size_t idx2_mod = idx2 & mask_mod;
 
+            unshare(idx1 >> shift_div);
+            unshare(idx2 >> shift_div);
+
             Block<void>* block1 = v_blocks[idx1 >> shift_div];
             Block<void>* block2 = v_blocks[idx2 >> shift_div];
 
@@ -410,11 +382,13 @@ void KmerCovIndex<T>::resize(const size_t new_sz) {
 
         for (size_t i = new_v_block_sz; i < v_blocks.size(); ++i) {
 
-            if (v_blocks[i] != nullptr) delete v_blocks[i];
+            if (v_blocks[i] != nullptr) release(v_blocks[i]);
         }
 
         v_blocks.resize(new_v_block_sz);
 
+        unshare(v_blocks.size() - 1);
+
         Block<T>* block = v_blocks.back();
 
         if (nb_last_block != 0){
@@ -445,6 +419,8 @@ void KmerCovIndex<T>::resize(const size_t new_sz) {
 
         if (nb_last_block != 0) {
 
+            unshare(v_blocks.size() - 1);
+
             Block<T>* block = v_blocks.back();
 
             std::fill(block->km_block + nb_last_block, block->km_block + block_sz, km_empty);
@@ -478,11 +454,13 @@ inline void KmerCovIndex<void>::resize(const size_t new_sz) {
 
         for (size_t i = new_v_block_sz; i < v_blocks.size(); ++i) {
 
-            if (v_blocks[i] != nullptr) delete v_blocks[i];
+            if (v_blocks[i] != nullptr) release(v_blocks[i]);
         }
 
         v_blocks.resize(new_v_block_sz);
 
+        unshare(v_blocks.size() - 1);
+
         Block<void>* block = v_blocks.back();
 
         for (size_t i = new_sz; i < rounded_sz; ++i) {
@@ -506,7 +484,12 @@ inline void KmerCovIndex<void>::resize(const size_t new_sz) {
 
         km_empty.set_empty();
 
-        if (nb_last_block != 0) std::fill(v_blocks.back()->km_block + nb_last_block, v_blocks.back()->km_block + block_sz, km_empty);
+        if (nb_last_block != 0) {
+
+            unshare(v_blocks.size() - 1);
+
+            std::fill(v_blocks.back()->km_block + nb_last_block, v_blocks.back()->km_block + block_sz, km_empty);
+        }
 
         v_blocks.resize(new_v_block_sz);
 
@@ -538,7 +521,12 @@ inline const void* KmerCovIndex<void>::getData(const size_t idx) const {
 template<typename T>
 T* KmerCovIndex<T>::getData(const size_t idx) {
 
-    if (idx < sz) return &(v_blocks[idx >> shift_div]->data_block[idx & mask_mod]);
+    if (idx < sz) {
+
+        unshare(idx >> shift_div);
+
+        return &(v_blocks[idx >> shift_div]->data_block[idx & mask_mod]);
+    }
 
     return nullptr;
 }
@@ -568,6 +556,8 @@ void KmerCovIndex<T>::remove(const size_t idx) {
 
         const size_t idx_mod = idx & mask_mod;
 
+        unshare(idx >> shift_div);
+
         Block<T>* block = v_blocks[idx >> shift_div];
 
         block->km_block[idx_mod].set_deleted();
@@ -590,6 +580,8 @@ inline void KmerCovIndex<void>::remove(const size_t idx) {
 
         const size_t idx_mod = idx & mask_mod;
 
+        unshare(idx >> shift_div);
+
         Block<void>* block = v_blocks[idx >> shift_div];
 
         block->km_block[idx_mod].set_deleted();
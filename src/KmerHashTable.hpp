@@ -6,6 +6,7 @@
 #include <iterator>
 #include <algorithm>
 
+#include "HugePages.hpp"
 #include "Kmer.hpp"
 
 template<typename T>
@@ -101,8 +102,8 @@ struct KmerHashTable {
 
     KmerHashTable(const KmerHashTable& o) : size_(o.size_), pop(o.pop), num_empty(o.num_empty) {
 
-        table_keys = new Kmer[size_];
-        table_values = new T[size_];
+        table_keys = newHugePagesArray<Kmer>(size_);
+        table_values = newHugePagesArray<T>(size_);
 
         std::copy(o.table_keys, o.table_keys + size_, table_keys);
         std::copy(o.table_values, o.table_values + size_, table_values);
@@ -131,8 +132,8 @@ struct KmerHashTable {
         pop = o.pop;
         num_empty = o.num_empty;
 
-        table_keys = new Kmer[size_];
-        table_values = new T[size_];
+        table_keys = newHugePagesArray<Kmer>(size_);
+        table_values = newHugePagesArray<T>(size_);
 
         std::copy(o.table_keys, o.table_keys + size_, table_keys);
         std::copy(o.table_values, o.table_values + size_, table_values);
@@ -193,13 +194,13 @@ struct KmerHashTable {
 
         if (table_keys != nullptr) {
 
-            delete[] table_keys;
+            deleteHugePagesArray(table_keys, size_);
             table_keys = nullptr;
         }
 
         if (table_values != nullptr) {
 
-            delete[] table_values;
+            deleteHugePagesArray(table_values, size_);
             table_values = nullptr;
         }
 
@@ -214,8 +215,8 @@ struct KmerHashTable {
 
         size_ = rndup(sz);
 
-        table_keys = new Kmer[size_];
-        table_values = new T[size_];
+        table_keys = newHugePagesArray<Kmer>(size_);
+        table_values = newHugePagesArray<T>(size_);
 
         clear();
     }
@@ -235,8 +236,8 @@ struct KmerHashTable {
         pop = 0;
         num_empty = size_;
 
-        table_keys = new Kmer[size_];
-        table_values = new T[size_];
+        table_keys = newHugePagesArray<Kmer>(size_);
+        table_values = newHugePagesArray<T>(size_);
 
         empty_key.set_empty();
 
@@ -250,8 +251,8 @@ struct KmerHashTable {
             }
         }
 
-        delete[] old_table_keys;
-        delete[] old_table_values;
+        deleteHugePagesArray(old_table_keys, old_size_);
+        deleteHugePagesArray(old_table_values, old_size_);
     }
 
     iterator find(const Kmer& key) {
@@ -500,8 +501,8 @@ struct MinimizerHashTable {
 
     MinimizerHashTable(const MinimizerHashTable& o) :   size_(o.size_), pop(o.pop), num_empty(o.num_empty) {
 
-        table_keys = new Minimizer[size_];
-        table_values = new T[size_];
+        table_keys = newHugePagesArray<Minimizer>(size_);
+        table_values = newHugePagesArray<T>(size_);
 
         std::copy(o.table_keys, o.table_keys + size_, table_keys);
         std::copy(o.table_values, o.table_values + size_, table_values);
@@ -530,8 +531,8 @@ struct MinimizerHashTable {
         pop = o.pop;
         num_empty = o.num_empty;
 
-        table_keys = new Minimizer[size_];
-        table_values = new T[size_];
+        table_keys = newHugePagesArray<Minimizer>(size_);
+        table_values = newHugePagesArray<T>(size_);
 
         std::copy(o.table_keys, o.table_keys + size_, table_keys);
         std::copy(o.table_values, o.table_values + size_, table_values);
@@ -592,13 +593,13 @@ struct MinimizerHashTable {
 
         if (table_keys != nullptr) {
 
-            delete[] table_keys;
+            deleteHugePagesArray(table_keys, size_);
             table_keys = nullptr;
         }
 
         if (table_values != nullptr) {
 
-            delete[] table_values;
+            deleteHugePagesArray(table_values, size_);
             table_values = nullptr;
         }
 
@@ -613,8 +614,8 @@ struct MinimizerHashTable {
 
         size_ = rndup(sz);
 
-        table_keys = new Minimizer[size_];
-        table_values = new T[size_];
+        table_keys = newHugePagesArray<Minimizer>(size_);
+        table_values = newHugePagesArray<T>(size_);
 
         clear();
     }
@@ -634,8 +635,8 @@ struct MinimizerHashTable {
         pop = 0;
         num_empty = size_;
 
-        table_keys = new Minimizer[size_];
-        table_values = new T[size_];
+        table_keys = newHugePagesArray<Minimizer>(size_);
+        table_values = newHugePagesArray<T>(size_);
 
         empty_key.set_empty();
 
@@ -649,8 +650,8 @@ struct MinimizerHashTable {
             }
         }
 
-        delete[] old_table_keys;
-        delete[] old_table_values;
+        deleteHugePagesArray(old_table_keys, old_size_);
+        deleteHugePagesArray(old_table_values, old_size_);
     }
 
     iterator find(const Minimizer& key) {
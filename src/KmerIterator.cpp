@@ -61,3 +61,46 @@ KmerIterator& KmerIterator::operator+=(const int len){
 
     return *this;
 }
+
+KmerRepIterator& KmerRepIterator::operator++() {
+
+    if (!invalid) {
+
+        while (str[pos_e] != '\0') {
+
+            const char c = str[pos_e] & 0xDF; // mask lowercase bit
+
+            if (isDNA(c)) {
+
+                if (pos_s + Kmer::k - 1 == pos_e){
+
+                    if (pos_s == p.second + 1 && !km_fw.isEmpty()) {
+
+                        km_fw.selfForwardBase(c);
+                        km_tw.selfBackwardBase(reverse_complement(c));
+                    }
+                    else {
+
+                        km_fw = Kmer(str + pos_s);
+                        km_tw = km_fw.twin();
+                    }
+
+                    p.first = (km_tw < km_fw) ? km_tw : km_fw;
+                    p.second = pos_s;
+
+                    ++pos_s;
+                    ++pos_e;
+
+                    return *this;
+                }
+            }
+            else pos_s = pos_e + 1;
+
+            ++pos_e;
+        }
+
+        invalid = true;
+    }
+
+    return *this;
+}
@@ -70,6 +70,92 @@ class KmerIterator : public std::iterator<std::input_iterator_tag, std::pair<Kme
         int pos_s, pos_e;
 };
 
+/* Short description:
+ *  - Same as KmerIterator but iterates through the canonical k-mers of a read
+ *  - The forward k-mer and its reverse-complement are both shifted by one base per
+ *    iteration so the canonical k-mer is obtained without computing a twin per k-mer
+ *  - iter->first gives the canonical kmer, iter->second gives the position within the reads
+ * */
+class KmerRepIterator : public std::iterator<std::input_iterator_tag, std::pair<Kmer, int>, int> {
+
+    public:
+
+        KmerRepIterator() : str(nullptr), invalid(true), pos_s(0), pos_e(0) {
+            p.first.set_empty();
+            p.second = 0;
+            km_fw.set_empty();
+            km_tw.set_empty();
+        }
+
+        KmerRepIterator(const char* s) : str(s), invalid(false), pos_s(0), pos_e(0) {
+            p.first.set_empty();
+            p.second = 0;
+            km_fw.set_empty();
+            km_tw.set_empty();
+
+            operator++();
+        }
+
+        KmerRepIterator& operator++();
+
+        BFG_INLINE KmerRepIterator operator++(int) {
+
+            const KmerRepIterator tmp(*this);
+
+            operator++();
+
+            return tmp;
+        }
+
+        BFG_INLINE bool operator==(const KmerRepIterator& o) const {
+
+            if (invalid || o.invalid) return invalid && o.invalid;
+
+            return (str == o.str) && (p == o.p);
+        }
+
+        BFG_INLINE bool operator!=(const KmerRepIterator& o) const {
+
+            return !operator==(o);
+        }
+
+        BFG_INLINE const pair<Kmer, int>& operator*() const {
+
+            return p;
+        }
+
+        BFG_INLINE const pair<Kmer, int>* operator->() const {
+
+            return &p;
+        }
+
+        // K-mer as it appears in the read
+        BFG_INLINE const Kmer& getForward() const {
+
+            return km_fw;
+        }
+
+        // Reverse-complement of the k-mer as it appears in the read
+        BFG_INLINE const Kmer& getTwin() const {
+
+            return km_tw;
+        }
+
+        // True if the canonical k-mer is the k-mer as it appears in the read
+        BFG_INLINE bool isForward() const {
+
+            return !(km_tw < km_fw);
+        }
+
+    private:
+
+        const char* str;
+        bool invalid;
+        pair<Kmer, int> p;
+        Kmer km_fw, km_tw;
+        int pos_s, pos_e;
+};
+
 template<class HF>
 class KmerHashIterator {
 
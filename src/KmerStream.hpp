@@ -17,6 +17,7 @@
 
 #include "minHashIterator.hpp"
 #include "File_Parser.hpp"
+#include "MinimizerOrder.hpp"
 #include "RepHash.hpp"
 #include "StreamCounter.hpp"
 
@@ -71,7 +72,7 @@ class ReadHasherMinimizer {
             size_t i = 0, j = 0, prev_pos_min = 0xffffffffffffffffULL;
             bool last_valid = false;
 
-            minHashIterator<RepHash> min_it = minHashIterator<RepHash>(s, l, k, g, RepHash(), true);
+            minHashIterator<MinimizerOrderHash> min_it = minHashIterator<MinimizerOrderHash>(s, l, k, g, MinimizerOrderHash(), true);
 
             RepHash hf;
 
@@ -138,7 +139,7 @@ class ReadHasherMinimizer {
 
                     bool last_valid = false;
 
-                    minHashIterator<RepHash> min_it = minHashIterator<RepHash>(str, sl, k, g, RepHash(), true);
+                    minHashIterator<MinimizerOrderHash> min_it = minHashIterator<MinimizerOrderHash>(str, sl, k, g, MinimizerOrderHash(), true);
 
                     RepHash hf;
 
@@ -200,7 +201,7 @@ class ReadHasherMinimizer {
             size_t i = 0, j = 0, prev_pos_min = 0xffffffffffffffffULL;
             bool last_valid = false;
 
-            minHashIterator<RepHash> min_it = minHashIterator<RepHash>(s, l, k, g, RepHash(), true);
+            minHashIterator<MinimizerOrderHash> min_it = minHashIterator<MinimizerOrderHash>(s, l, k, g, MinimizerOrderHash(), true);
 
             RepHash hf;
 
@@ -267,7 +268,7 @@ class ReadHasherMinimizer {
 
                     bool last_valid = false;
 
-                    minHashIterator<RepHash> min_it = minHashIterator<RepHash>(str, sl, k, g, RepHash(), true);
+                    minHashIterator<MinimizerOrderHash> min_it = minHashIterator<MinimizerOrderHash>(str, sl, k, g, MinimizerOrderHash(), true);
 
                     RepHash hf;
 
@@ -400,7 +401,7 @@ class ReadQualityHasherMinimizer {
 
             const char q_base_cut = (char) (q_base + q_cutoff);
 
-            minHashIterator<RepHash> min_it = minHashIterator<RepHash>(s, l, k, g, RepHash(), true);
+            minHashIterator<MinimizerOrderHash> min_it = minHashIterator<MinimizerOrderHash>(s, l, k, g, MinimizerOrderHash(), true);
 
             RepHash hf;
 
@@ -468,7 +469,7 @@ class ReadQualityHasherMinimizer {
 
                     bool last_valid = false;
 
-                    minHashIterator<RepHash> min_it = minHashIterator<RepHash>(str, sl, k, g, RepHash(), true);
+                    minHashIterator<MinimizerOrderHash> min_it = minHashIterator<MinimizerOrderHash>(str, sl, k, g, MinimizerOrderHash(), true);
 
                     RepHash hf;
 
@@ -531,7 +532,7 @@ class ReadQualityHasherMinimizer {
 
             const char q_base_cut = (char) (q_base + q_cutoff);
 
-            minHashIterator<RepHash> min_it = minHashIterator<RepHash>(s, l, k, g, RepHash(), true);
+            minHashIterator<MinimizerOrderHash> min_it = minHashIterator<MinimizerOrderHash>(s, l, k, g, MinimizerOrderHash(), true);
 
             RepHash hf;
 
@@ -598,7 +599,7 @@ class ReadQualityHasherMinimizer {
 
                     bool last_valid = false;
 
-                    minHashIterator<RepHash> min_it = minHashIterator<RepHash>(str, sl, k, g, RepHash(), true);
+                    minHashIterator<MinimizerOrderHash> min_it = minHashIterator<MinimizerOrderHash>(str, sl, k, g, MinimizerOrderHash(), true);
 
                     RepHash hf;
 
@@ -5,7 +5,7 @@
 
 #include "rw_spin_lock.h"
 
-class LockGraph : public SpinLockRW {
+class LockGraph : public SpinLockRW_Distributed {
 
     public:
 
@@ -1,13 +1,38 @@
 #include "MinimizerIndex.hpp"
 
-MinimizerIndex::MinimizerIndex() :  table_keys(nullptr), table_tinyv(nullptr), table_tinyv_sz(nullptr),
-                                    size_(0), pop(0), num_empty(0)  {
+MinimizerIndex::Segment::Segment() : refs(1), slab(nullptr) {
+
+    Minimizer empty_key;
+
+    empty_key.set_empty();
+
+    std::fill(keys, keys + lck_block_sz, empty_key);
+
+    memset(tinyv_sz, packed_tiny_vector::FLAG_EMPTY, lck_block_sz * sizeof(uint8_t));
+}
+
+MinimizerIndex::Segment::Segment(const Segment& o) : refs(1), slab(nullptr) {
+
+    std::copy(o.keys, o.keys + lck_block_sz, keys);
+
+    for (size_t i = 0; i < lck_block_sz; ++i){
+
+        tinyv_sz[i] = packed_tiny_vector::FLAG_EMPTY;
+        tinyv[i].copy(tinyv_sz[i], o.tinyv[i], o.tinyv_sz[i]);
+    }
+}
+
+MinimizerIndex::Slab::Slab(const size_t nb_segs_) : segs(newHugePagesArray<Segment>(nb_segs_)), nb_segs(nb_segs_), nb_used_segs(nb_segs_) {
+
+    for (size_t i = 0; i < nb_segs; ++i) segs[i].slab = this;
+}
+
+MinimizerIndex::MinimizerIndex() :  table_segs(nullptr), size_(0), pop(0), num_empty(0)  {
 
     init_tables(max(static_cast<size_t>(1024), lck_block_sz));
 }
 
-MinimizerIndex::MinimizerIndex(const size_t sz) :   table_keys(nullptr), table_tinyv(nullptr), table_tinyv_sz(nullptr),
-                                                    size_(0), pop(0), num_empty(0) {
+MinimizerIndex::MinimizerIndex(const size_t sz) :   table_segs(nullptr), size_(0), pop(0), num_empty(0) {
 
     if (sz == 0) init_tables(lck_block_sz);
     else {
@@ -22,21 +47,9 @@ MinimizerIndex::MinimizerIndex(const size_t sz) :   table_keys(nullptr), table_t
     }
 }
 
-MinimizerIndex::MinimizerIndex(const MinimizerIndex& o) :   size_(o.size_), pop(o.pop), num_empty(o.num_empty) {
-
-    table_keys = new Minimizer[size_];
-    table_tinyv = new packed_tiny_vector[size_];
-    table_tinyv_sz = new uint8_t[size_];
-
-    lck_min = vector<SpinLock>(o.lck_min.size());
-
-    std::copy(o.table_keys, o.table_keys + size_, table_keys);
-
-    for (size_t i = 0; i < size_; ++i){
+MinimizerIndex::MinimizerIndex(const MinimizerIndex& o) :   table_segs(nullptr), size_(0), pop(0), num_empty(0) {
 
-        table_tinyv_sz[i] = packed_tiny_vector::FLAG_EMPTY;
-        table_tinyv[i].copy(table_tinyv_sz[i], o.table_tinyv[i], o.table_tinyv_sz[i]);
-    }
+    share(o);
 }
 
 MinimizerIndex::MinimizerIndex(MinimizerIndex&& o){
@@ -45,15 +58,11 @@ MinimizerIndex::MinimizerIndex(MinimizerIndex&& o){
     pop = o.pop;
     num_empty = o.num_empty;
 
-    table_keys = o.table_keys;
-    table_tinyv = o.table_tinyv;
-    table_tinyv_sz = o.table_tinyv_sz;
+    table_segs = o.table_segs;
 
     lck_min = vector<SpinLock>(o.lck_min.size());
 
-    o.table_keys = nullptr;
-    o.table_tinyv = nullptr;
-    o.table_tinyv_sz = nullptr;
+    o.table_segs = nullptr;
 
     o.clear();
 }
@@ -63,24 +72,7 @@ MinimizerIndex& MinimizerIndex::operator=(const MinimizerIndex& o) {
     if (this != &o) {
 
         clear();
-
-        size_ = o.size_;
-        pop = o.pop;
-        num_empty = o.num_empty;
-
-        table_keys = new Minimizer[size_];
-        table_tinyv = new packed_tiny_vector[size_];
-        table_tinyv_sz = new uint8_t[size_];
-
-        lck_min = vector<SpinLock>(o.lck_min.size());
-
-        std::copy(o.table_keys, o.table_keys + size_, table_keys);
-
-        for (size_t i = 0; i < size_; ++i){
-
-            table_tinyv_sz[i] = packed_tiny_vector::FLAG_EMPTY;
-            table_tinyv[i].copy(table_tinyv_sz[i], o.table_tinyv[i], o.table_tinyv_sz[i]);
-        }
+        share(o);
     }
 
     return *this;
@@ -96,15 +88,11 @@ MinimizerIndex& MinimizerIndex::operator=(MinimizerIndex&& o){
         pop = o.pop;
         num_empty = o.num_empty;
 
-        table_keys = o.table_keys;
-        table_tinyv = o.table_tinyv;
-        table_tinyv_sz = o.table_tinyv_sz;
+        table_segs = o.table_segs;
 
         lck_min = vector<SpinLock>(o.lck_min.size());
 
-        o.table_keys = nullptr;
-        o.table_tinyv = nullptr;
-        o.table_tinyv_sz = nullptr;
+        o.table_segs = nullptr;
 
         o.clear();
     }
@@ -119,17 +107,54 @@ MinimizerIndex::~MinimizerIndex() {
 
 void MinimizerIndex::clear() {
 
-    if (table_tinyv != nullptr){
-
-        for (size_t i = 0; i < size_; ++i) table_tinyv[i].destruct(table_tinyv_sz[i]);
-    }
-
     clear_tables();
 
     lck_min.clear();
     lck_edit_table.release_all();
 }
 
+// Share the segments of o
+void MinimizerIndex::share(const MinimizerIndex& o) {
+
+    const size_t nb_segs = o.size_ >> lck_block_div_shift;
+
+    size_ = o.size_;
+    pop = o.pop;
+    num_empty = o.num_empty;
+
+    if (o.table_segs != nullptr) {
+
+        table_segs = new Segment*[nb_segs];
+
+        for (size_t i = 0; i < nb_segs; ++i){
+
+            table_segs[i] = o.table_segs[i];
+            table_segs[i]->refs.fetch_add(1);
+        }
+    }
+
+    lck_min = vector<SpinLock>(o.lck_min.size());
+}
+
+// Release a segment used by one index less. A segment used by no index is destructed and so is its slab if it was the last
+// segment of the slab used by an index.
+void MinimizerIndex::release_segment(Segment* seg) {
+
+    if (seg->refs.fetch_sub(1) == 1) {
+
+        Slab* slab = seg->slab;
+
+        for (size_t i = 0; i < lck_block_sz; ++i) seg->tinyv[i].destruct(seg->tinyv_sz[i]);
+
+        if (slab == nullptr) delete seg;
+        else if (slab->nb_used_segs.fetch_sub(1) == 1) {
+
+            deleteHugePagesArray(slab->segs, slab->nb_segs);
+            delete slab;
+        }
+    }
+}
+
 MinimizerIndex::iterator MinimizerIndex::find(const Minimizer& key) {
 
     const size_t end_table = size_-1;
@@ -139,13 +164,13 @@ MinimizerIndex::iterator MinimizerIndex::find(const Minimizer& key) {
 
     while (i != size_) {
 
-        if (table_keys[h].isEmpty() || (table_keys[h] == key)) break;
+        if (slot_key(h).isEmpty() || (slot_key(h) == key)) break;
 
         h = (h+1) & end_table;
         ++i;
     }
 
-    if ((i != size_) && (table_keys[h] == key)) return iterator(this, h);
+    if ((i != size_) && (slot_key(h) == key)) return iterator(this, h);
 
     return iterator(this);
 }
@@ -159,27 +184,27 @@ MinimizerIndex::const_iterator MinimizerIndex::find(const Minimizer& key) const
 
     while (i != size_) {
 
-        if (table_keys[h].isEmpty() || (table_keys[h] == key)) break;
+        if (slot_key(h).isEmpty() || (slot_key(h) == key)) break;
 
         h = (h+1) & end_table;
         ++i;
     }
 
-    if ((i != size_) && (table_keys[h] == key)) return const_iterator(this, h);
+    if ((i != size_) && (slot_key(h) == key)) return const_iterator(this, h);
 
     return const_iterator(this);
 }
 
 MinimizerIndex::iterator MinimizerIndex::find(const size_t h) {
 
-    if ((h < size_) && !table_keys[h].isEmpty() && !table_keys[h].isDeleted()) return iterator(this, h);
+    if ((h < size_) && !slot_key(h).isEmpty() && !slot_key(h).isDeleted()) return iterator(this, h);
 
     return iterator(this);
 }
 
 MinimizerIndex::const_iterator MinimizerIndex::find(const size_t h) const {
 
-    if ((h < size_) && !table_keys[h].isEmpty() && !table_keys[h].isDeleted()) return const_iterator(this, h);
+    if ((h < size_) && !slot_key(h).isEmpty() && !slot_key(h).isDeleted()) return const_iterator(this, h);
 
     return const_iterator(this);
 }
@@ -188,9 +213,11 @@ MinimizerIndex::iterator MinimizerIndex::erase(const_iterator it) {
 
     if (it == end()) return end();
 
-    table_keys[it.h].set_deleted();
-    table_tinyv[it.h].destruct(table_tinyv_sz[it.h]);
-    table_tinyv_sz[it.h] = packed_tiny_vector::FLAG_EMPTY;
+    unshare(it.h);
+
+    slot_key(it.h).set_deleted();
+    slot_tinyv(it.h).destruct(slot_tinyv_sz(it.h));
+    slot_tinyv_sz(it.h) = packed_tiny_vector::FLAG_EMPTY;
 
     --pop;
 
@@ -207,17 +234,19 @@ size_t MinimizerIndex::erase(const Minimizer& minz) {
 
     while (i != size_) {
 
-        if (table_keys[h].isEmpty() || (table_keys[h] == minz)) break;
+        if (slot_key(h).isEmpty() || (slot_key(h) == minz)) break;
 
         h = (h+1) & end_table;
         ++i;
     }
 
-    if ((i != size_) && (table_keys[h] == minz)){
+    if ((i != size_) && (slot_key(h) == minz)){
+
+        unshare(h);
 
-        table_keys[h].set_deleted();
-        table_tinyv[h].destruct(table_tinyv_sz[h]);
-        table_tinyv_sz[h] = packed_tiny_vector::FLAG_EMPTY;
+        slot_key(h).set_deleted();
+        slot_tinyv(h).destruct(slot_tinyv_sz(h));
+        slot_tinyv_sz(h) = packed_tiny_vector::FLAG_EMPTY;
 
         --pop;
     }
@@ -249,21 +278,21 @@ pair<MinimizerIndex::iterator, bool> MinimizerIndex::insert(const Minimizer& key
 
     while (true) {
 
-        if (table_keys[h].isEmpty()) {
+        if (slot_key(h).isEmpty()) {
 
             if (has_rich_psl) {
 
                 h = h_rich_psl;
 
                 // Swap keys
-                swap(table_keys[h], l_key);
+                swap(slot_key(h), l_key);
 
                 // Swap values
                 packed_tiny_vector l_ptv_swap;
                 uint8_t l_flag_swap;
 
-                l_ptv_swap.move(l_flag_swap, move(table_tinyv[h]), move(table_tinyv_sz[h]));
-                table_tinyv[h].move(table_tinyv_sz[h], move(l_ptv), move(l_flag));
+                l_ptv_swap.move(l_flag_swap, move(slot_tinyv(h)), move(slot_tinyv_sz(h)));
+                slot_tinyv(h).move(slot_tinyv_sz(h), move(l_ptv), move(l_flag));
                 l_ptv.move(l_flag, move(l_ptv_swap), move(l_flag_swap));
 
                 psl_ins_key = psl_rich_key;
@@ -271,18 +300,18 @@ pair<MinimizerIndex::iterator, bool> MinimizerIndex::insert(const Minimizer& key
                 is_deleted = false;
                 has_rich_psl = false;
 
-                if (table_keys[h] == key) it_ret = {iterator(this, h), true};
+                if (slot_key(h) == key) it_ret = {iterator(this, h), true};
             }
             else {
 
                 h = ((static_cast<size_t>(is_deleted) - 1) & h) + ((static_cast<size_t>(!is_deleted) - 1) & h_del);
                 num_empty -= static_cast<size_t>(!is_deleted);
 
-                table_keys[h] = l_key;
-                table_tinyv_sz[h] = packed_tiny_vector::FLAG_EMPTY;
-                table_tinyv[h].move(table_tinyv_sz[h], move(l_ptv), move(l_flag));
+                slot_key(h) = l_key;
+                slot_tinyv_sz(h) = packed_tiny_vector::FLAG_EMPTY;
+                slot_tinyv(h).move(slot_tinyv_sz(h), move(l_ptv), move(l_flag));
 
-                if (table_keys[h] == key) {
+                if (slot_key(h) == key) {
 
                     ++pop;
                     it_ret = {iterator(this, h), true};
@@ -291,15 +320,15 @@ pair<MinimizerIndex::iterator, bool> MinimizerIndex::insert(const Minimizer& key
                 return it_ret;
             }
         }
-        else if (table_keys[h] == l_key) return {iterator(this, h), false}; // Can only happen when inserting the input key
-        else if (table_keys[h].isDeleted()) {
+        else if (slot_key(h) == l_key) return {iterator(this, h), false}; // Can only happen when inserting the input key
+        else if (slot_key(h).isDeleted()) {
 
             h_del = ((static_cast<size_t>(!is_deleted) - 1) & h_del) + ((static_cast<size_t>(is_deleted) - 1) & h);
             is_deleted = true;
         }
         else if (!is_deleted && !has_rich_psl) {
 
-            const size_t h_curr = table_keys[h].hash() & end_table;
+            const size_t h_curr = slot_key(h).hash() & end_table;
             const size_t psl_curr_key = (h < h_curr) ? (size_ - h_curr + h) : (h - h_curr);
 
             if (psl_ins_key > psl_curr_key) {
@@ -327,22 +356,24 @@ pair<MinimizerIndex::iterator, bool> MinimizerIndex::insert(const Minimizer& key
 
     while (true) {
 
-        if (table_keys[h].isEmpty()) {
+        if (slot_key(h).isEmpty()) {
 
             h = ((static_cast<size_t>(is_deleted) - 1) & h) + ((static_cast<size_t>(!is_deleted) - 1) & h_del);
             num_empty -= static_cast<size_t>(!is_deleted);
 
-            table_keys[h] = key;
-            table_tinyv_sz[h] = packed_tiny_vector::FLAG_EMPTY;
+            unshare(h);
+
+            slot_key(h) = key;
+            slot_tinyv_sz(h) = packed_tiny_vector::FLAG_EMPTY;
 
-            table_tinyv[h].copy(table_tinyv_sz[h], ptv, flag);
+            slot_tinyv(h).copy(slot_tinyv_sz(h), ptv, flag);
 
             ++pop;
 
             return {iterator(this, h), true};
         }
-        else if (table_keys[h] == key) return {iterator(this, h), false};
-        else if (table_keys[h].isDeleted()) {
+        else if (slot_key(h) == key) return {iterator(this, h), false};
+        else if (slot_key(h).isDeleted()) {
 
             h_del = ((static_cast<size_t>(!is_deleted) - 1) & h_del) + ((static_cast<size_t>(is_deleted) - 1) & h);
             is_deleted = true;
@@ -390,14 +421,14 @@ MinimizerIndex::iterator MinimizerIndex::find_p(const Minimizer& key) {
             lck_min[id_block].acquire();
         }
 
-        if (table_keys[h].isEmpty()){
+        if (slot_key(h).isEmpty()){
 
             lck_min[id_block].release();
             lck_edit_table.release_reader();
 
             iterator(this);
         }
-        else if (table_keys[h] == key) return iterator(this, h);
+        else if (slot_key(h) == key) return iterator(this, h);
 
         h = (h+1) & end_table;
         ++i;
@@ -430,14 +461,14 @@ MinimizerIndex::const_iterator MinimizerIndex::find_p(const Minimizer& key) cons
             lck_min[id_block].acquire();
         }
 
-        if (table_keys[h].isEmpty()){
+        if (slot_key(h).isEmpty()){
 
             lck_min[id_block].release();
             lck_edit_table.release_reader();
 
             const_iterator(this);
         }
-        else if (table_keys[h] == key) return const_iterator(this, h);
+        else if (slot_key(h) == key) return const_iterator(this, h);
 
         h = (h+1) & end_table;
         ++i;
@@ -459,7 +490,7 @@ MinimizerIndex::iterator MinimizerIndex::find_p(const size_t h) {
 
         lck_min[id_block].acquire();
 
-        if (!table_keys[h].isEmpty() && !table_keys[h].isDeleted()) return iterator(this, h);
+        if (!slot_key(h).isEmpty() && !slot_key(h).isDeleted()) return iterator(this, h);
 
         lck_min[id_block].release();
     }
@@ -479,7 +510,7 @@ MinimizerIndex::const_iterator MinimizerIndex::find_p(const size_t h) const {
 
         lck_min[id_block].acquire();
 
-        if (!table_keys[h].isEmpty() && !table_keys[h].isDeleted()) return const_iterator(this, h);
+        if (!slot_key(h).isEmpty() && !slot_key(h).isDeleted()) return const_iterator(this, h);
 
         lck_min[id_block].release();
     }
@@ -529,24 +560,26 @@ size_t MinimizerIndex::erase_p(const Minimizer& minz) {
             lck_min[id_block].acquire();
         }
 
-        if (table_keys[h].isEmpty()){
+        if (slot_key(h).isEmpty()){
 
             lck_min[id_block].release();
             lck_edit_table.release_reader();
 
             return 0;
         }
-        else if (table_keys[h] == minz) break;
+        else if (slot_key(h) == minz) break;
 
         h = (h+1) & end_table;
         ++i;
     }
 
-    if ((i != size_) && (table_keys[h] == minz)){
+    if ((i != size_) && (slot_key(h) == minz)){
 
-        table_keys[h].set_deleted();
-        table_tinyv[h].destruct(table_tinyv_sz[h]);
-        table_tinyv_sz[h] = packed_tiny_vector::FLAG_EMPTY;
+        unshare(h); // Lock of the block is held: no other thread accesses the segment
+
+        slot_key(h).set_deleted();
+        slot_tinyv(h).destruct(slot_tinyv_sz(h));
+        slot_tinyv_sz(h) = packed_tiny_vector::FLAG_EMPTY;
 
         lck_min[id_block].release();
 
@@ -598,7 +631,7 @@ pair<MinimizerIndex::iterator, bool> MinimizerIndex::insert_p(const Minimizer& k
             lck_min[id_block].acquire();
         }
 
-        if (table_keys[h1].isEmpty()) {
+        if (slot_key(h1).isEmpty()) {
 
             if (is_deleted){
 
@@ -609,7 +642,7 @@ pair<MinimizerIndex::iterator, bool> MinimizerIndex::insert_p(const Minimizer& k
 
                     lck_min[id_block2].acquire();
 
-                    if (table_keys[h2].isDeleted()){
+                    if (slot_key(h2).isDeleted()){
 
                         lck_min[id_block].release();
                         h1 = h2;
@@ -623,20 +656,22 @@ pair<MinimizerIndex::iterator, bool> MinimizerIndex::insert_p(const Minimizer& k
             }
             else --num_empty_p;
 
-            table_keys[h1] = key;
-            table_tinyv_sz[h1] = packed_tiny_vector::FLAG_EMPTY;
+            unshare(h1); // Lock of the block is held: no other thread accesses the segment
+
+            slot_key(h1) = key;
+            slot_tinyv_sz(h1) = packed_tiny_vector::FLAG_EMPTY;
 
-            table_tinyv[h1].copy(table_tinyv_sz[h1], v, flag);
+            slot_tinyv(h1).copy(slot_tinyv_sz(h1), v, flag);
 
             ++pop_p;
 
             return {iterator(this, h1), true};
         }
-        else if (table_keys[h1] == key){
+        else if (slot_key(h1) == key){
 
             return {iterator(this, h1), false};
         }
-        else if (!is_deleted && table_keys[h1].isDeleted()) {
+        else if (!is_deleted && slot_key(h1).isDeleted()) {
 
             is_deleted = true;
             h2 = h1;
@@ -651,15 +686,21 @@ pair<MinimizerIndex::iterator, bool> MinimizerIndex::insert_p(const Minimizer& k
 
 MinimizerIndex::iterator MinimizerIndex::begin() {
 
-    iterator it(this);
-    it.operator++();
+    iterator it(this, 0);
+
+    // Skip to the first used slot if the first slot is not used
+    if ((size_ != 0) && (slot_key(0).isEmpty() || slot_key(0).isDeleted())) it.operator++();
+
     return it;
 }
 
 MinimizerIndex::const_iterator MinimizerIndex::begin() const {
 
-    const_iterator it(this);
-    it.operator++();
+    const_iterator it(this, 0);
+
+    // Skip to the first used slot if the first slot is not used
+    if ((size_ != 0) && (slot_key(0).isEmpty() || slot_key(0).isDeleted())) it.operator++();
+
     return it;
 }
 
@@ -675,22 +716,14 @@ MinimizerIndex::const_iterator MinimizerIndex::end() const {
 
 void MinimizerIndex::clear_tables() {
 
-    if (table_keys != nullptr) {
+    if (table_segs != nullptr) {
 
-        delete[] table_keys;
-        table_keys = nullptr;
-    }
+        const size_t nb_segs = size_ >> lck_block_div_shift;
 
-    if (table_tinyv != nullptr) {
+        for (size_t i = 0; i < nb_segs; ++i) release_segment(table_segs[i]);
 
-        delete[] table_tinyv;
-        table_tinyv = nullptr;
-    }
-
-    if (table_tinyv_sz != nullptr) {
-
-        delete[] table_tinyv_sz;
-        table_tinyv_sz = nullptr;
+        delete[] table_segs;
+        table_segs = nullptr;
     }
 
     size_ = 0;
@@ -702,21 +735,17 @@ void MinimizerIndex::init_tables(const size_t sz) {
 
     clear_tables();
 
-    Minimizer empty_key;
-
     pop = 0;
     size_ = rndup(sz);
     num_empty = size_;
 
-    table_keys = new Minimizer[size_];
-    table_tinyv = new packed_tiny_vector[size_];
-    table_tinyv_sz = new uint8_t[size_];
+    const size_t nb_segs = size_ >> lck_block_div_shift;
 
-    empty_key.set_empty();
+    Slab* slab = new Slab(nb_segs);
 
-    std::fill(table_keys, table_keys + size_, empty_key);
+    table_segs = new Segment*[nb_segs];
 
-    memset(table_tinyv_sz, packed_tiny_vector::FLAG_EMPTY, size_ * sizeof(uint8_t));
+    for (size_t i = 0; i < nb_segs; ++i) table_segs[i] = &(slab->segs[i]);
 }
 
 void MinimizerIndex::reserve(const size_t sz) {
@@ -724,43 +753,30 @@ void MinimizerIndex::reserve(const size_t sz) {
     if (sz <= size_) return;
 
     const size_t old_size_ = size_;
+    const size_t old_nb_segs = old_size_ >> lck_block_div_shift;
 
-    Minimizer empty_key;
-
-    Minimizer* old_table_keys = table_keys;
-    packed_tiny_vector* old_table_tinyv = table_tinyv;
-    uint8_t* old_table_tinyv_sz = table_tinyv_sz;
-
-    size_ = rndup(sz);
-    pop = 0;
-    num_empty = size_;
+    Segment** old_table_segs = table_segs;
 
-    table_keys = new Minimizer[size_];
-    table_tinyv = new packed_tiny_vector[size_];
-    table_tinyv_sz = new uint8_t[size_];
+    table_segs = nullptr; // Old segments are released once their content is inserted in the new table
 
-    empty_key.set_empty();
+    init_tables(sz);
 
     if (!lck_min.empty()) lck_min = vector<SpinLock>((size_ + lck_block_sz - 1) / lck_block_sz);
 
-    std::fill(table_keys, table_keys + size_, empty_key);
-
-    memset(table_tinyv_sz, packed_tiny_vector::FLAG_EMPTY, size_ * sizeof(uint8_t));
+    for (size_t i = 0; i < old_nb_segs; ++i) {
 
-    for (size_t i = 0; i < old_size_; ++i) {
+        Segment* old_seg = old_table_segs[i];
 
-        if (!old_table_keys[i].isEmpty() && !old_table_keys[i].isDeleted()){
+        for (size_t j = 0; j < lck_block_sz; ++j) {
 
-            insert(old_table_keys[i], old_table_tinyv[i], old_table_tinyv_sz[i]);
-
-            old_table_tinyv[i].destruct(old_table_tinyv_sz[i]);
+            if (!old_seg->keys[j].isEmpty() && !old_seg->keys[j].isDeleted()) insert(old_seg->keys[j], old_seg->tinyv[j], old_seg->tinyv_sz[j]);
         }
+
+        release_segment(old_seg);
     }
 
-    delete[] old_table_keys;
-    delete[] old_table_tinyv;
-    delete[] old_table_tinyv_sz;
+    delete[] old_table_segs;
 }
 
-const size_t MinimizerIndex::lck_block_sz = 64;
-const size_t MinimizerIndex::lck_block_div_shift = 6;
+const size_t MinimizerIndex::lck_block_sz;
+const size_t MinimizerIndex::lck_block_div_shift;
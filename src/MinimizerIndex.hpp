@@ -6,10 +6,17 @@
 #include <iterator>
 #include <algorithm>
 
+#include "HugePages.hpp"
 #include "Kmer.hpp"
 #include "Lock.hpp"
 #include "TinyVector.hpp"
 
+// The table of an index is split into segments of lck_block_sz slots and copies of an index share the segments until one of
+// them is modified (copy-on-write): copying an index is O(number of segments) and a segment is duplicated by the first
+// modification of one of its slots in a copy (insertion, deletion or access to a vector through a non-constant iterator).
+// A segment is also the block of slots locked by the concurrent functions (*_p), so a thread holding the lock of a block can
+// duplicate its segment while other threads modify other segments. Memory of a copy hence grows with the number of segments
+// it modifies, not with the size of the index. Resizing the table (more than 80% full) duplicates all of it.
 class MinimizerIndex {
 
     template<bool is_const = true>
@@ -31,7 +38,7 @@ class MinimizerIndex {
 
             BFG_INLINE Minimizer getKey() const {
 
-                return ht->table_keys[h];
+                return ht->slot_key(h);
             }
 
             BFG_INLINE size_t getHash() const {
@@ -39,24 +46,34 @@ class MinimizerIndex {
                 return h;
             }
 
+            // Non-const accessors can be used to modify the vectors: tables shared with a copy of the index are duplicated first
+
             BFG_INLINE MI_tinyv_sz_ref_t getVectorSize() const {
 
-                return ht->table_tinyv_sz[h];
+                unshare(ht, h);
+
+                return ht->slot_tinyv_sz(h);
             }
 
             BFG_INLINE MI_tinyv_ref_t getVector() const {
 
-                return ht->table_tinyv[h];
+                unshare(ht, h);
+
+                return ht->slot_tinyv(h);
             }
 
             MI_tinyv_ref_t operator*() const {
 
-                return ht->table_tinyv[h];
+                unshare(ht, h);
+
+                return ht->slot_tinyv(h);
             }
 
             MI_tinyv_ptr_t operator->() const {
 
-                return &(ht->table_tinyv[h]);
+                unshare(ht, h);
+
+                return &(ht->slot_tinyv(h));
             }
 
             iterator_ operator++(int) {
@@ -74,7 +91,7 @@ class MinimizerIndex {
 
                 for (; h < ht->size_; ++h) {
 
-                    if (!ht->table_keys[h].isEmpty() && !ht->table_keys[h].isDeleted()) break;
+                    if (!ht->slot_key(h).isEmpty() && !ht->slot_key(h).isDeleted()) break;
                 }
 
                 return *this;
@@ -92,6 +109,9 @@ class MinimizerIndex {
 
             friend class iterator_<true>;
 
+            static BFG_INLINE void unshare(const MinimizerIndex* mi, const size_t h) {}
+            static BFG_INLINE void unshare(MinimizerIndex* mi, const size_t h) { mi->unshare(h); }
+
         //private:
 
             MI_ptr_t ht;
@@ -163,25 +183,85 @@ class MinimizerIndex {
 
     private:
 
+        // For future myself: lck_block_sz must be a poswer of 2. If you change it, change lck_block_div_shift accordingly.
+        // I could automate this in a much better looking implementation but I'm way too tired today.
+        static const size_t lck_block_sz = 64;
+        static const size_t lck_block_div_shift = 6;
+
+        struct Slab;
+
+        struct Segment {
+
+            Segment();
+            Segment(const Segment& o);
+
+            Minimizer keys[lck_block_sz];
+            packed_tiny_vector tinyv[lck_block_sz];
+            uint8_t tinyv_sz[lck_block_sz];
+
+            atomic<size_t> refs; // Number of indexes sharing the segment
+
+            Slab* slab; // Slab of the segment or nullptr if the segment was allocated on its own
+        };
+
+        // Segments allocated at once by init_tables() or reserve()
+        struct Slab {
+
+            Slab(const size_t nb_segs_);
+
+            Segment* segs;
+
+            const size_t nb_segs;
+
+            atomic<size_t> nb_used_segs; // The slab is released with its last segment still used by an index
+        };
+
         void clear_tables();
         void init_tables(const size_t sz);
         void reserve(const size_t sz);
 
+        void share(const MinimizerIndex& o);
+
+        static void release_segment(Segment* seg);
+
+        // Duplicate the segment of slot h if it is shared with another index
+        BFG_INLINE void unshare(const size_t h) {
+
+            Segment*& seg = table_segs[h >> lck_block_div_shift];
+
+            if (seg->refs.load() != 1) {
+
+                Segment* new_seg = new Segment(*seg);
+
+                release_segment(seg);
+
+                seg = new_seg;
+            }
+        }
+
+        BFG_INLINE Minimizer& slot_key(const size_t h) const {
+
+            return table_segs[h >> lck_block_div_shift]->keys[h & (lck_block_sz - 1)];
+        }
+
+        BFG_INLINE packed_tiny_vector& slot_tinyv(const size_t h) const {
+
+            return table_segs[h >> lck_block_div_shift]->tinyv[h & (lck_block_sz - 1)];
+        }
+
+        BFG_INLINE uint8_t& slot_tinyv_sz(const size_t h) const {
+
+            return table_segs[h >> lck_block_div_shift]->tinyv_sz[h & (lck_block_sz - 1)];
+        }
+
         size_t size_, pop, num_empty;
 
-        Minimizer* table_keys;
-        packed_tiny_vector* table_tinyv;
-        uint8_t* table_tinyv_sz;
+        Segment** table_segs; // Segment of each block of lck_block_sz slots
 
         mutable vector<SpinLock> lck_min;
         mutable SpinLockRW lck_edit_table;
 
         atomic<size_t> pop_p, num_empty_p;
-
-        // For future myself: lck_block_sz must be a poswer of 2. If you change it, change lck_block_div_shift accordingly.
-        // I could automate this in a much better looking implementation but I'm way too tired today.
-        static const size_t lck_block_sz;
-        static const size_t lck_block_div_shift;
 };
 
 #endif
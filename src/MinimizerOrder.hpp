@@ -0,0 +1,156 @@
+#ifndef BIFROST_MINIMIZER_ORDER_HPP
+#define BIFROST_MINIMIZER_ORDER_HPP
+
+#include <stdint.h>
+
+#include "Common.hpp"
+#include "RepHash.hpp"
+
+/* Short description:
+ *  - Rolling hash functions defining the order of g-mers used to select minimizers. They are the HF
+ *    template parameter of minHashIterator, preAllocMinHashIterator, minHashKmer and minHashBatch
+ *  - RepHash: random order, the minimizer is the g-mer with the smallest RepHash
+ *  - SyncmerRepHash: g-mers which are closed syncmers come first in the order, then the other g-mers.
+ *    Within each group, the order is random. A g-mer is a closed syncmer if its smallest s-mer (s = g - 6)
+ *    is its first or last one. With the default g = k - 8, a window of g-mers has as many g-mers as a
+ *    g-mer has s-mers, which minimizes the density of the selected minimizers.
+ *  - Prioritized g-mers are sampled more evenly than random minimizers so fewer distinct minimizers are
+ *    selected, which reduces the size of the minimizer index and the number of overcrowded minimizers
+ *  - All orders are on canonical g-mers: a g-mer and its reverse-complement have the same hash
+ *  - MinimizerOrderHash is the order used by the graph, selected at compilation with MINIMIZER_ORDER
+ * */
+
+// 2-bit code (A=0, C=1, G=2, T=3) of a character, from its bits 1 and 2 as Kmer::set_kmer() does
+BFG_INLINE uint8_t charToCode(const unsigned char c) {
+
+    const uint8_t x = (c & 4) >> 1;
+
+    return x + ((x ^ (c & 2)) >> 1);
+}
+
+class SyncmerRepHash {
+
+    public:
+
+        SyncmerRepHash(const size_t _k = 0) {
+
+            setK(_k);
+        }
+
+        inline void setK(const size_t _k) {
+
+            k = _k;
+            s = (k > s_diff) ? k - s_diff : 1;
+            nb_smers = k - s + 1;
+
+            head = 0;
+            smer_head = 0;
+
+            hf_k.setK(k);
+            hf_s.setK(s);
+        }
+
+        void init(const char* _s) {
+
+            initCodes([&](const size_t pos){ return charToCode(_s[pos]); });
+        }
+
+        // Same as init() for a sequence whose base i has the 2-bit code code(i) (A=0, C=1, G=2, T=3)
+        template<typename F>
+        void initCodes(const F& code) {
+
+            for (size_t i = 0; i < k; ++i) codes[i] = code(i);
+
+            head = 0;
+            smer_head = 0;
+
+            hf_k.initCodes([&](const size_t pos){ return codes[pos]; });
+            hf_s.initCodes([&](const size_t pos){ return codes[pos]; });
+
+            smer_h[0] = hf_s.hash();
+
+            for (size_t i = 1; i < nb_smers; ++i) {
+
+                hf_s.updateFWCodes(codes[i - 1], codes[i + s - 1]);
+                smer_h[i] = hf_s.hash();
+            }
+        }
+
+        inline void update(const unsigned char out, const unsigned char in) {
+
+            updateFWCodes(charToCode(out), charToCode(in));
+        }
+
+        // Same as update() for bases given by their 2-bit codes
+        inline void updateFWCodes(const uint8_t out, const uint8_t in) {
+
+            const size_t pos_s_out = head + k - s; // First base of the last s-mer of the window
+            const uint8_t s_out = codes[(pos_s_out >= k) ? pos_s_out - k : pos_s_out];
+
+            hf_k.updateFWCodes(out, in);
+            hf_s.updateFWCodes(s_out, in);
+
+            codes[head] = in;
+            head = (head + 1 == k) ? 0 : head + 1;
+
+            smer_h[smer_head] = hf_s.hash();
+            smer_head = (smer_head + 1 == nb_smers) ? 0 : smer_head + 1;
+        }
+
+        inline uint64_t hash() const {
+
+            // smer_h[smer_head] is the hash of the first s-mer of the window, the last s-mer precedes it
+            const uint64_t h_first = smer_h[smer_head];
+            const uint64_t h_last = smer_h[(smer_head == 0) ? nb_smers - 1 : smer_head - 1];
+
+            uint64_t h_min = h_first;
+
+            for (size_t i = 0; i < nb_smers; ++i) h_min = std::min(h_min, smer_h[i]);
+
+            const bool is_syncmer = (h_min == h_first) || (h_min == h_last);
+
+            return (hf_k.hash() >> 1) | (static_cast<uint64_t>(!is_syncmer) << 63);
+        }
+
+        // Compute in hashes[i] the hash of the k-mer starting at s[i], for 0 <= i < nb
+        void hashes(const char* _s, const size_t nb, uint64_t* hashes) const {
+
+            if (nb == 0) return;
+
+            SyncmerRepHash hf(k);
+
+            hf.init(_s);
+
+            hashes[0] = hf.hash();
+
+            for (size_t i = 1; i < nb; ++i) {
+
+                hf.update(_s[i-1], _s[i+k-1]);
+
+                hashes[i] = hf.hash();
+            }
+        }
+
+    private:
+
+        static const size_t s_diff = 6; // Length difference between the g-mers and their s-mers
+
+        size_t k, s;
+        size_t nb_smers; // Nb s-mers in a g-mer
+        size_t head, smer_head; // Position of the first base and first s-mer hash of the window in the buffers
+
+        RepHash hf_k, hf_s;
+
+        uint64_t smer_h[s_diff + 1];
+        uint8_t codes[MAX_GMER_SIZE];
+};
+
+#if defined(MINIMIZER_ORDER_SYNCMER)
+typedef SyncmerRepHash MinimizerOrderHash;
+#define MINIMIZER_ORDER_NAME "syncmer"
+#else
+typedef RepHash MinimizerOrderHash;
+#define MINIMIZER_ORDER_NAME "random"
+#endif
+
+#endif
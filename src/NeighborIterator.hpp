@@ -94,6 +94,9 @@ class neighborIterator : public std::iterator<std::input_iterator_tag, UnitigMap
         int i;
 
         bool is_fw;
+        bool strand;
+
+        size_t row; // Row of the reference unitig in the neighbor index of the graph
 
         Kmer km_head;
         Kmer km_tail;
@@ -5,21 +5,25 @@
 #include "UnitigMap.hpp"
 
 template<typename U, typename G, bool is_const>
-neighborIterator<U, G, is_const>::neighborIterator() : i(4), is_fw(true), cdbg(nullptr) {}
+neighborIterator<U, G, is_const>::neighborIterator() : i(4), is_fw(true), strand(true), row(0), cdbg(nullptr) {}
 
 template<typename U, typename G, bool is_const>
-neighborIterator<U, G, is_const>::neighborIterator(const UnitigMap<U, G, is_const>& um_, const bool is_forward_) : i(-1), is_fw(is_forward_), cdbg(um_.getGraph()) {
+neighborIterator<U, G, is_const>::neighborIterator(const UnitigMap<U, G, is_const>& um_, const bool is_forward_) :  i(-1), is_fw(is_forward_), strand(um_.strand),
+                                                                                                                    row(0), cdbg(um_.getGraph()) {
 
     if (um_.isEmpty || (cdbg == nullptr) || cdbg->invalid) i = 4;
     else {
 
+        row = cdbg->getNeighborRow(um_.pos_unitig, um_.isShort, um_.isAbundant);
+
         km_head = um_.strand ? um_.getUnitigHead() : um_.getUnitigTail().twin();
         km_tail = um_.strand ? um_.getUnitigTail() : um_.getUnitigHead().twin();
     }
 }
 
 template<typename U, typename G, bool is_const>
-neighborIterator<U, G, is_const>::neighborIterator(const neighborIterator& o) : i(o.i), is_fw(o.is_fw), um(o.um), km_head(o.km_head), km_tail(o.km_tail), cdbg(o.cdbg) {}
+neighborIterator<U, G, is_const>::neighborIterator(const neighborIterator& o) :  i(o.i), is_fw(o.is_fw), strand(o.strand), row(o.row), um(o.um),
+                                                                                km_head(o.km_head), km_tail(o.km_tail), cdbg(o.cdbg) {}
 
 template<typename U, typename G, bool is_const>
 neighborIterator<U, G, is_const>& neighborIterator<U, G, is_const>::operator++() {
@@ -28,6 +32,25 @@ neighborIterator<U, G, is_const>& neighborIterator<U, G, is_const>::operator++()
 
     ++i;
 
+    if (cdbg->neighbors_indexed){
+
+        while (i < 4){
+
+            const UnitigMap<U, G, true> cum = cdbg->getIndexedNeighbor(row, strand, is_fw, i);
+
+            if (!cum.isEmpty){
+
+                um = UnitigMap<U, G, is_const>(cum.pos_unitig, cum.dist, cum.len, cum.size, cum.isShort, cum.isAbundant, cum.strand, cdbg);
+
+                break;
+            }
+
+            ++i;
+        }
+
+        return *this;
+    }
+
     while (i < 4){
 
         um = cdbg->find(is_fw ? km_tail.forwardBase(alpha[i]) : km_head.backwardBase(alpha[i]), true);
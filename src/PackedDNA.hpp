@@ -0,0 +1,113 @@
+#ifndef BIFROST_PACKED_DNA_HPP
+#define BIFROST_PACKED_DNA_HPP
+
+#include <stdint.h>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#include "Common.hpp"
+
+/* Short description:
+ *  - Convert between DNA strings and words of 32 bases packed with 2 bits per base (A=0, C=1, G=2, T=3)
+ *  - Base i of a word is stored in bits [2i, 2i+1], which is the order of a CompressedSequence
+ *  - Kmer and Minimizer words store base i in bits [62-2i, 63-2i]: use reverseWord() to go from one order to the other
+ *  - Use AVX2 (pshufb lookups and pmaddubsw packing) when available
+ * */
+
+// Reverse the order of the 32 bases of a word
+BFG_INLINE uint64_t reverseWord(uint64_t v) {
+
+    v = __builtin_bswap64(v);
+    v = ((v >> 4) & 0x0F0F0F0F0F0F0F0FULL) | ((v & 0x0F0F0F0F0F0F0F0FULL) << 4);
+
+    return ((v >> 2) & 0x3333333333333333ULL) | ((v & 0x3333333333333333ULL) << 2);
+}
+
+// Reverse-complement the 32 bases of a word (with the 2-bit encoding, complementing a base is a bitwise NOT)
+BFG_INLINE uint64_t twinWord(const uint64_t v) {
+
+    return reverseWord(~v);
+}
+
+// Encode the first len (<= 32) characters of s in a word. Lower case characters are encoded as upper case ones.
+// Characters other than A, C, G, T are encoded from their bits 1 and 2 as Kmer::set_kmer() does. Each bit i of
+// the returned mask non_acgt is set if s[i] is not 'A', 'C', 'G' or 'T' (upper case). Exactly len characters
+// of s are read, at once if len is 32.
+BFG_INLINE uint64_t encodeWord(const char* s, const size_t len, uint32_t& non_acgt) {
+
+    #if defined(__AVX2__)
+    if (len == 32) {
+
+        const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s));
+
+        const __m256i is_acgt = _mm256_or_si256(
+            _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('A')), _mm256_cmpeq_epi8(v, _mm256_set1_epi8('C'))),
+            _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('G')), _mm256_cmpeq_epi8(v, _mm256_set1_epi8('T')))
+        );
+
+        // Code from the low nibble: 'A' = 0x41, 'C' = 0x43, 'G' = 0x47 and 'T' = 0x54
+        const __m256i lut = _mm256_setr_epi8(0, 0, 1, 1, 3, 3, 2, 2, 0, 0, 1, 1, 3, 3, 2, 2,
+                                             0, 0, 1, 1, 3, 3, 2, 2, 0, 0, 1, 1, 3, 3, 2, 2);
+
+        const __m256i codes = _mm256_shuffle_epi8(lut, _mm256_and_si256(v, _mm256_set1_epi8(0x0F)));
+        const __m256i pairs = _mm256_maddubs_epi16(codes, _mm256_set1_epi16(0x0401)); // c0 + 4*c1 in 16 bits
+        const __m256i quads = _mm256_madd_epi16(pairs, _mm256_set1_epi32(0x00100001)); // p0 + 16*p1 in 32 bits
+        const __m256i bytes = _mm256_shuffle_epi8(quads, _mm256_setr_epi8(0, 4, 8, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+                                                                          0, 4, 8, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1));
+
+        non_acgt = ~static_cast<uint32_t>(_mm256_movemask_epi8(is_acgt));
+
+        return static_cast<uint64_t>(static_cast<uint32_t>(_mm256_extract_epi32(bytes, 0))) |
+                (static_cast<uint64_t>(static_cast<uint32_t>(_mm256_extract_epi32(bytes, 4))) << 32);
+    }
+    #endif
+
+    uint64_t w = 0;
+
+    non_acgt = 0;
+
+    for (size_t i = 0; i < len; ++i) {
+
+        const char c = s[i];
+        const uint64_t x = (c & 4) >> 1;
+
+        w |= (x + ((x ^ (c & 2)) >> 1)) << (i << 1);
+        non_acgt |= static_cast<uint32_t>((c != 'A') && (c != 'C') && (c != 'G') && (c != 'T')) << i;
+    }
+
+    return w;
+}
+
+// Decode the first len (<= 32) bases of a word into s. Exactly len characters are written, at once if len is 32.
+BFG_INLINE void decodeWord(const uint64_t w, char* s, const size_t len) {
+
+    #if defined(__AVX2__)
+    if (len == 32) {
+
+        // Byte j of the vector gets the byte of the word containing base j
+        const __m256i v = _mm256_shuffle_epi8(_mm256_set1_epi64x(w), _mm256_setr_epi8(0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3,
+                                                                                        4, 4, 4, 4, 5, 5, 5, 5, 6, 6, 6, 6, 7, 7, 7, 7));
+
+        const __m256i bit_lo = _mm256_set1_epi32(0x40100401); // Low bit of base j in byte j
+        const __m256i bit_hi = _mm256_set1_epi32(0x80200802); // High bit of base j in byte j
+
+        const __m256i code = _mm256_or_si256(_mm256_and_si256(_mm256_cmpeq_epi8(_mm256_and_si256(v, bit_lo), bit_lo), _mm256_set1_epi8(1)),
+                                             _mm256_and_si256(_mm256_cmpeq_epi8(_mm256_and_si256(v, bit_hi), bit_hi), _mm256_set1_epi8(2)));
+
+        const __m256i lut = _mm256_setr_epi8('A', 'C', 'G', 'T', 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+                                             'A', 'C', 'G', 'T', 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0);
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(s), _mm256_shuffle_epi8(lut, code));
+
+        return;
+    }
+    #endif
+
+    uint64_t tmp = w;
+
+    for (size_t i = 0; i < len; ++i, tmp >>= 2) s[i] = "ACGT"[tmp & 0x3];
+}
+
+#endif
@@ -6,6 +6,10 @@
 
 #include "wyhash.h"
 
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
 static const unsigned char twin[32] = {
     0, 20, 2, 7, 4, 5, 6, 3,
     8,  9, 10, 11, 12, 13, 14, 15,
@@ -89,16 +93,166 @@ class RepHash {
             updateFW(out, in);
         }
 
-        inline uint64_t hash() const {
+        // Same as init() for a sequence whose base i has the 2-bit code code(i) (A=0, C=1, G=2, T=3)
+        template<typename F>
+        void initCodes(const F& code) {
 
-            uint64_t hashes[2] = {h, ht};
+            h = 0;
+            ht = 0;
 
-            if (hashes[1] < hashes[0]) swap(hashes[0], hashes[1]);
+            for (size_t i = 0; i < k; ++i) {
 
-            return wyhash(hashes, sizeof(uint64_t) + sizeof(uint64_t), 0, _wyp);
+                fastleftshift1(h);
+                fastleftshift1(ht);
+
+                h ^= hvals[codemask(code(i))];
+                ht ^= hvals[codemask(code(k-1-i)) ^ 0x2];
+            }
+        }
+
+        // Same as updateFW() for bases given by their 2-bit codes
+        inline void updateFWCodes(const uint8_t out, const uint8_t in) {
+
+            uint64_t z(hvals[codemask(out)]);
+            uint64_t zt(hvals[codemask(in) ^ 0x2]);
+
+            fastleftshiftk(z);
+            fastleftshiftk(zt);
+
+            fastleftshift1(h);
+
+            h ^= z;
+            h ^= hvals[codemask(in)];
+
+            ht ^= zt;
+            ht ^= hvals[codemask(out) ^ 0x2];
+
+            fastrightshift1(ht);
+        }
+
+        // Same as updateBW() for bases given by their 2-bit codes
+        inline void updateBWCodes(const uint8_t out, const uint8_t in) {
+
+            uint64_t z(hvals[codemask(out) ^ 0x2]);
+            uint64_t zt(hvals[codemask(in)]);
+
+            fastleftshiftk(z);
+            fastleftshiftk(zt);
+
+            fastleftshift1(ht);
+
+            ht ^= z;
+            ht ^= hvals[codemask(in) ^ 0x2];
+
+            h ^= zt;
+            h ^= hvals[codemask(out)];
+
+            fastrightshift1(h);
+        }
+
+        inline uint64_t hash() const {
+
+            return finalize(h, ht);
             //return (h ^ ht);
         }
 
+        // Compute in hashes[i] the hash of the k-mer starting at s[i], for 0 <= i < nb. Exactly nb+k-1 characters
+        // of s are read. Same values as init(s) followed by nb-1 calls to update() but the state is not modified.
+        // With AVX2, the sequence is cut into 4 segments whose rolling states are updated in the 4 lanes of a vector.
+        void hashes(const char* _s, const size_t nb, uint64_t* hashes) const {
+
+            if (nb == 0) return;
+
+            const unsigned char* s = (const unsigned char*) _s;
+
+            #if defined(__AVX2__)
+            if (nb >= 64) {
+
+                const size_t l = (nb + 3) / 4; // Nb k-mers per segment, last segment overlaps the previous one
+                const size_t start[4] = {0, l, 2 * l, nb - l};
+
+                uint64_t hvals_k[4];
+
+                for (size_t i = 0; i < 4; ++i) {
+
+                    hvals_k[i] = hvals[i];
+                    fastleftshiftk(hvals_k[i]);
+                }
+
+                const __m256i lut = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(hvals));
+                const __m256i lut_k = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(hvals_k));
+                const __m256i twin_code = _mm256_set1_epi64x(2); // twinmask(x) == charmask(x) ^ 2
+                const __m256i odd = _mm256_set1_epi64x(1ULL << 32);
+
+                // Select in each 64 bits lane the entry of a 4 x 64 bits table given by the code in that lane
+                auto lookup = [&](const __m256i& table, const __m256i& code) {
+
+                    const __m256i idx = _mm256_slli_epi64(code, 1);
+
+                    return _mm256_permutevar8x32_epi32(table, _mm256_add_epi64(_mm256_or_si256(idx, _mm256_slli_epi64(idx, 32)), odd));
+                };
+
+                uint64_t h_l[4] __attribute__((aligned(32)));
+                uint64_t ht_l[4] __attribute__((aligned(32)));
+
+                for (size_t i = 0; i < 4; ++i) {
+
+                    RepHash hf(k);
+
+                    hf.init(_s + start[i]);
+
+                    h_l[i] = hf.h;
+                    ht_l[i] = hf.ht;
+                    hashes[start[i]] = finalize(h_l[i], ht_l[i]);
+                }
+
+                __m256i v_h = _mm256_load_si256(reinterpret_cast<const __m256i*>(h_l));
+                __m256i v_ht = _mm256_load_si256(reinterpret_cast<const __m256i*>(ht_l));
+
+                for (size_t j = 1; j < l; ++j) {
+
+                    const unsigned char* s_out = s + j - 1;
+                    const unsigned char* s_in = s + j + k - 1;
+
+                    const __m256i code_out = _mm256_set_epi64x(charmask(s_out[start[3]]), charmask(s_out[start[2]]),
+                                                               charmask(s_out[start[1]]), charmask(s_out[start[0]]));
+                    const __m256i code_in = _mm256_set_epi64x(charmask(s_in[start[3]]), charmask(s_in[start[2]]),
+                                                              charmask(s_in[start[1]]), charmask(s_in[start[0]]));
+
+                    v_h = _mm256_or_si256(_mm256_slli_epi64(v_h, 1), _mm256_srli_epi64(v_h, 63));
+                    v_h = _mm256_xor_si256(v_h, _mm256_xor_si256(lookup(lut_k, code_out), lookup(lut, code_in)));
+
+                    v_ht = _mm256_xor_si256(v_ht, _mm256_xor_si256(lookup(lut_k, _mm256_xor_si256(code_in, twin_code)),
+                                                                   lookup(lut, _mm256_xor_si256(code_out, twin_code))));
+                    v_ht = _mm256_or_si256(_mm256_srli_epi64(v_ht, 1), _mm256_slli_epi64(v_ht, 63));
+
+                    _mm256_store_si256(reinterpret_cast<__m256i*>(h_l), v_h);
+                    _mm256_store_si256(reinterpret_cast<__m256i*>(ht_l), v_ht);
+
+                    hashes[start[0] + j] = finalize(h_l[0], ht_l[0]);
+                    hashes[start[1] + j] = finalize(h_l[1], ht_l[1]);
+                    hashes[start[2] + j] = finalize(h_l[2], ht_l[2]);
+                    hashes[start[3] + j] = finalize(h_l[3], ht_l[3]);
+                }
+
+                return;
+            }
+            #endif
+
+            RepHash hf(k);
+
+            hf.init(_s);
+
+            hashes[0] = hf.hash();
+
+            for (size_t i = 1; i < nb; ++i) {
+
+                hf.updateFW(s[i-1], s[i+k-1]);
+
+                hashes[i] = hf.hash();
+            }
+        }
+
         inline void setK(const size_t _k) {
 
             k = _k;
@@ -108,6 +262,13 @@ class RepHash {
 
     private:
 
+        static inline uint64_t finalize(const uint64_t h_fw, const uint64_t h_bw) {
+
+            const uint64_t hashes[2] = {min(h_fw, h_bw), max(h_fw, h_bw)};
+
+            return wyhash(hashes, sizeof(uint64_t) + sizeof(uint64_t), 0, _wyp);
+        }
+
         inline uint64_t charmask (const unsigned char x) const {
 
             return (x & 6) >> 1;
@@ -118,6 +279,12 @@ class RepHash {
             return ((x ^ 4) & 6) >> 1;
         }
 
+        // Index in hvals of a 2-bit code (A=0, C=1, G=2, T=3), same as charmask() of the corresponding character
+        inline uint64_t codemask (const uint8_t c) const {
+
+            return c ^ (c >> 1);
+        }
+
         inline void fastleftshiftk(uint64_t& x) const {
 
             x = (x << k) | (x >> (64-k));
@@ -163,6 +330,8 @@ struct rep_state_t {
     rep_state_t(const uint64_t hi_, const uint64_t lo_) : hi(hi_), lo(lo_) {}
 };
 
+static const unsigned char code2char[4] = {'A' & 31, 'C' & 31, 'G' & 31, 'T' & 31}; // Index in hvals of a 2-bit code
+
 static const rep_state_t hvals[32] = {
     rep_state_t(0x498bf4da68e4a5d2ULL, 0xcd18b2ed2719ae49ULL), rep_state_t(0x87613b9d792b27bfULL, 0x5a9f31e9650d3ac6ULL),
     rep_state_t(0x4395a1a049fa76a2ULL, 0x10e4b5bf779adbc8ULL), rep_state_t(0x7544bc518bb54d90ULL, 0x41f3e8de1fe48d6eULL),
@@ -210,6 +379,28 @@ class RepHash {
             //return (h.lo ^ ht.lo);
         }
 
+        // Compute in hashes[i] the hash of the k-mer starting at s[i], for 0 <= i < nb. Exactly nb+k-1 characters
+        // of s are read. Same values as init(s) followed by nb-1 calls to update() but the state is not modified.
+        void hashes(const char* _s, const size_t nb, uint64_t* hashes) const {
+
+            if (nb == 0) return;
+
+            const unsigned char* s = (const unsigned char*) _s;
+
+            RepHash hf(full_k);
+
+            hf.init(_s);
+
+            hashes[0] = hf.hash();
+
+            for (size_t i = 1; i < nb; ++i) {
+
+                hf.updateFW(s[i-1], s[i+full_k-1]);
+
+                hashes[i] = hf.hash();
+            }
+        }
+
         void init(const char *_s) {
 
             h = rep_state_t();
@@ -268,6 +459,35 @@ class RepHash {
             updateFW(out, in);
         }
 
+        // Same as init() for a sequence whose base i has the 2-bit code code(i) (A=0, C=1, G=2, T=3)
+        template<typename F>
+        void initCodes(const F& code) {
+
+            h = rep_state_t();
+            ht = rep_state_t();
+
+            for (size_t i = 0; i < full_k; ++i) {
+
+                fastleftshift1(h);
+                fastleftshift1(ht);
+
+                h ^= hvals[code2char[code(i)]];
+                ht ^= hvals[code2char[0x3 - code(full_k-1-i)]];
+            }
+        }
+
+        // Same as updateFW() for bases given by their 2-bit codes
+        inline void updateFWCodes(const uint8_t out, const uint8_t in) {
+
+            updateFW(code2char[out], code2char[in]);
+        }
+
+        // Same as updateBW() for bases given by their 2-bit codes
+        inline void updateBWCodes(const uint8_t out, const uint8_t in) {
+
+            updateBW(code2char[out], code2char[in]);
+        }
+
     private:
 
         inline void fastleftshiftk(rep_state_t& x) const {
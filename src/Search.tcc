@@ -103,9 +103,9 @@ vector<pair<size_t, UnitigMap<U, G>>> CompactedDBG<U, G>::searchSequence( const
             } 
 
             KmerIterator ki_s(s_inexact_str), ki_e;
-            minHashIterator<RepHash> mhi = minHashIterator<RepHash>(s_inexact_str, s_inexact_len, k_, g_, RepHash(), true);
+            minHashIterator<MinimizerOrderHash> mhi = minHashIterator<MinimizerOrderHash>(s_inexact_str, s_inexact_len, k_, g_, MinimizerOrderHash(), true);
 
-            minHashResultIterator<RepHash> it_min, it_min_end;
+            minHashResultIterator<MinimizerOrderHash> it_min, it_min_end;
             minHashResult mhr;
 
             Minimizer minz;
@@ -128,7 +128,7 @@ vector<pair<size_t, UnitigMap<U, G>>> CompactedDBG<U, G>::searchSequence( const
                     if (mhr.pos != minz_pres.first){
 
                         minz = Minimizer(s_inexact_str + mhr.pos).rep();
-                        minz_pres = {mhr.pos, hmap_min_unitigs.find(minz) != hmap_min_unitigs.end()};
+                        minz_pres = {mhr.pos, sparse_index || (hmap_min_unitigs.find(minz) != hmap_min_unitigs.end())};
 
                         for (++it_min; !minz_pres.second && (it_min != it_min_end); ++it_min){
 
@@ -371,9 +371,9 @@ vector<pair<size_t, UnitigMap<U, G>>> CompactedDBG<U, G>::searchSequence(   cons
             } 
 
             KmerIterator ki_s(s_inexact_str), ki_e;
-            minHashIterator<RepHash> mhi = minHashIterator<RepHash>(s_inexact_str, s_inexact_len, k_, g_, RepHash(), true);
+            minHashIterator<MinimizerOrderHash> mhi = minHashIterator<MinimizerOrderHash>(s_inexact_str, s_inexact_len, k_, g_, MinimizerOrderHash(), true);
 
-            minHashResultIterator<RepHash> it_min, it_min_end;
+            minHashResultIterator<MinimizerOrderHash> it_min, it_min_end;
             minHashResult mhr;
 
             Minimizer minz;
@@ -396,7 +396,7 @@ vector<pair<size_t, UnitigMap<U, G>>> CompactedDBG<U, G>::searchSequence(   cons
                     if (mhr.pos != minz_pres.first){
 
                         minz = Minimizer(s_inexact_str + mhr.pos).rep();
-                        minz_pres = {mhr.pos, hmap_min_unitigs.find(minz) != hmap_min_unitigs.end()};
+                        minz_pres = {mhr.pos, sparse_index || (hmap_min_unitigs.find(minz) != hmap_min_unitigs.end())};
 
                         for (++it_min; !minz_pres.second && (it_min != it_min_end); ++it_min){
 
@@ -622,9 +622,9 @@ vector<pair<size_t, const_UnitigMap<U, G>>> CompactedDBG<U, G>::searchSequence(
             } 
 
             KmerIterator ki_s(s_inexact_str), ki_e;
-            minHashIterator<RepHash> mhi = minHashIterator<RepHash>(s_inexact_str, s_inexact_len, k_, g_, RepHash(), true);
+            minHashIterator<MinimizerOrderHash> mhi = minHashIterator<MinimizerOrderHash>(s_inexact_str, s_inexact_len, k_, g_, MinimizerOrderHash(), true);
 
-            minHashResultIterator<RepHash> it_min, it_min_end;
+            minHashResultIterator<MinimizerOrderHash> it_min, it_min_end;
             minHashResult mhr;
 
             Minimizer minz;
@@ -647,7 +647,7 @@ vector<pair<size_t, const_UnitigMap<U, G>>> CompactedDBG<U, G>::searchSequence(
                     if (mhr.pos != minz_pres.first){
 
                         minz = Minimizer(s_inexact_str + mhr.pos).rep();
-                        minz_pres = {mhr.pos, hmap_min_unitigs.find(minz) != hmap_min_unitigs.end()};
+                        minz_pres = {mhr.pos, sparse_index || (hmap_min_unitigs.find(minz) != hmap_min_unitigs.end())};
 
                         for (++it_min; !minz_pres.second && (it_min != it_min_end); ++it_min){
 
@@ -890,9 +890,9 @@ vector<pair<size_t, const_UnitigMap<U, G>>> CompactedDBG<U, G>::searchSequence(
             } 
 
             KmerIterator ki_s(s_inexact_str), ki_e;
-            minHashIterator<RepHash> mhi = minHashIterator<RepHash>(s_inexact_str, s_inexact_len, k_, g_, RepHash(), true);
+            minHashIterator<MinimizerOrderHash> mhi = minHashIterator<MinimizerOrderHash>(s_inexact_str, s_inexact_len, k_, g_, MinimizerOrderHash(), true);
 
-            minHashResultIterator<RepHash> it_min, it_min_end;
+            minHashResultIterator<MinimizerOrderHash> it_min, it_min_end;
             minHashResult mhr;
 
             Minimizer minz;
@@ -915,7 +915,7 @@ vector<pair<size_t, const_UnitigMap<U, G>>> CompactedDBG<U, G>::searchSequence(
                     if (mhr.pos != minz_pres.first){
 
                         minz = Minimizer(s_inexact_str + mhr.pos).rep();
-                        minz_pres = {mhr.pos, hmap_min_unitigs.find(minz) != hmap_min_unitigs.end()};
+                        minz_pres = {mhr.pos, sparse_index || (hmap_min_unitigs.find(minz) != hmap_min_unitigs.end())};
 
                         for (++it_min; !minz_pres.second && (it_min != it_min_end); ++it_min){
 
@@ -1,16 +1,22 @@
 #ifndef BIFROST_UNITIG_ITERATOR_HPP
 #define BIFROST_UNITIG_ITERATOR_HPP
 
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
 #include "UnitigMap.hpp"
 #include "KmerHashTable.hpp"
 #include "CompressedCoverage.hpp"
 
 /** @file src/UnitigIterator.hpp
-* The unitigIterator type interface.
+* The unitigIterator and unitigRange type interfaces.
 * Code snippets using this interface are provided in snippets/test.cpp.
 */
 
 template<typename U, typename G> class CompactedDBG;
+template<typename U, typename G, bool is_const> class unitigRange;
 
 /** @class unitigIterator
 * @brief Iterator for the unitigs of a Compacted de Bruijn graph.
@@ -93,6 +99,11 @@ class unitigIterator : public std::iterator<std::input_iterator_tag, UnitigMap<U
 
     private:
 
+        template<typename X, typename Y, bool C> friend class unitigRange;
+
+        // Iterate over the unitigs [start, end) of the graph: the first abundant unitig of the range is in slot slot_start of h_kmers_ccov
+        unitigIterator(CompactedDBG_ptr_t cdbg_, const size_t start, const size_t end, const size_t slot_start);
+
         size_t i;
 
         size_t v_unitigs_sz;
@@ -109,6 +120,114 @@ class unitigIterator : public std::iterator<std::input_iterator_tag, UnitigMap<U
         CompactedDBG_ptr_t cdbg;
 };
 
+/** @class unitigRange
+* @brief Splittable range of unitigs of a Compacted de Bruijn graph, to process the unitigs in parallel.
+* A unitigRange object has 3 template parameters: the type of data associated with the unitigs of the graph, the type of
+* data associated with the graph and a boolean indicating if this is a constant range or not. The unitigs of a range are
+* the unitigs of the graph in the order of CompactedDBG::iterator. A range can be split in two ranges containing about the
+* same number of k-mers, independently of how the unitigs are stored in the graph (unitigs of length k or longer). You are
+* supposed to obtain a unitigRange from CompactedDBG::getUnitigRange() or to use CompactedDBG::parallel_for_each().
+* The graph must not be modified while a range exists.
+* \code{.cpp}
+* CompactedDBG<> cdbg;
+* ... // Some more code, cdbg construction
+* CompactedDBG<>::const_range r1 = cdbg.getUnitigRange();
+* CompactedDBG<>::const_range r2 = r1.split(); // r1 and r2 have about the same number of k-mers
+* thread t1([&]{ for (const auto& unitig : r1) cout << unitig.toString() << endl; });
+* thread t2([&]{ for (const auto& unitig : r2) cout << unitig.toString() << endl; });
+* \endcode
+*/
+template<typename Unitig_data_t = void, typename Graph_data_t = void, bool is_const = true>
+class unitigRange {
+
+    typedef Unitig_data_t U;
+    typedef Graph_data_t G;
+
+    public:
+
+        typedef typename std::conditional<is_const, const CompactedDBG<U, G>*, CompactedDBG<U, G>*>::type CompactedDBG_ptr_t;
+
+        /** Constructor.
+        * @return an empty unitigRange.
+        */
+        unitigRange();
+
+        /** Constructor.
+        * @param cdbg_ is a pointer to a Compacted de Bruijn graph. The range contains all the unitigs of this graph.
+        * @return a unitigRange.
+        */
+        unitigRange(CompactedDBG_ptr_t cdbg_);
+
+        /** Copy constructor.
+        * @return a copy of a unitigRange.
+        */
+        unitigRange(const unitigRange& o);
+
+        /** Check if the range contains no unitig.
+        * @return a boolean indicating if the range is empty.
+        */
+        bool empty() const;
+
+        /** Return the number of unitigs in the range.
+        * @return the number of unitigs in the range.
+        */
+        size_t size() const;
+
+        /** Return the number of k-mers in the unitigs of the range.
+        * @return the number of k-mers in the unitigs of the range.
+        */
+        size_t nbKmers() const;
+
+        /** Check if the range can be split, i.e, if it contains at least 2 unitigs.
+        * @return a boolean indicating if the range can be split.
+        */
+        bool isDivisible() const;
+
+        /** Split the range in two ranges with about the same number of k-mers. This range keeps the first unitigs,
+        * the returned range contains the other unitigs. If the range cannot be split, the returned range is empty.
+        * @return a range containing the second part of the unitigs of this range.
+        */
+        unitigRange split();
+
+        /** Split the range in at most nb_ranges ranges with about the same number of k-mers.
+        * @param nb_ranges is the maximum number of ranges to create.
+        * @return a vector of ranges, the union of which is this range.
+        */
+        vector<unitigRange> split(const size_t nb_ranges) const;
+
+        /** Create an iterator to the first unitig of the range.
+        * @return an iterator to the first unitig of the range.
+        */
+        unitigIterator<U, G, is_const> begin() const;
+
+        /** Create an iterator to the "past-the-last" unitig of the range.
+        * @return an iterator to the "past-the-last" unitig of the range.
+        */
+        unitigIterator<U, G, is_const> end() const;
+
+        /** Call a function on each unitig of the range, in parallel. The range is split into chunks with about the same
+        * number of k-mers which are processed by the threads as they become available. The function is called as f(um)
+        * where um is a UnitigMap (constant if the range is constant) of a unitig. The function can be called concurrently
+        * on different unitigs so it must be thread-safe, but the data of each unitig can be modified safely from um.
+        * @param nb_threads is the number of threads to use.
+        * @param f is the function to call on each unitig.
+        */
+        template<typename F>
+        void parallel_for_each(const size_t nb_threads, F f) const;
+
+    private:
+
+        unitigRange(const unitigRange& o, const size_t start, const size_t end);
+
+        size_t b; // First unitig of the range
+        size_t e; // Past-the-last unitig of the range
+
+        std::shared_ptr<const vector<size_t>> cum_km; // Number of k-mers in the unitigs preceding each unitig
+        std::shared_ptr<const vector<size_t>> slots_h; // Slot in h_kmers_ccov of each abundant unitig
+
+        CompactedDBG_ptr_t cdbg;
+};
+
 #include "UnitigIterator.tcc"
 
 #endif
@@ -23,6 +23,25 @@ unitigIterator<U, G, is_const>::unitigIterator(CompactedDBG_ptr_t cdbg_) :
     }
 }
 
+template<typename U, typename G, bool is_const>
+unitigIterator<U, G, is_const>::unitigIterator(CompactedDBG_ptr_t cdbg_, const size_t start, const size_t end, const size_t slot_start) :
+                i(start), v_unitigs_sz(0), v_kmers_sz(0), h_kmers_ccov_sz(0), sz(0), invalid(true), cdbg(cdbg_) {
+
+    if ((cdbg != nullptr) && !cdbg->invalid && (start < end)){
+
+        invalid = false;
+
+        v_unitigs_sz = cdbg->v_unitigs.size();
+        v_kmers_sz = cdbg->km_unitigs.size();
+        h_kmers_ccov_sz = cdbg->h_kmers_ccov.size();
+
+        sz = min(end, v_unitigs_sz + v_kmers_sz + h_kmers_ccov_sz);
+
+        if (start < v_unitigs_sz + v_kmers_sz) it_h_kmers_ccov = cdbg->h_kmers_ccov.begin();
+        else it_h_kmers_ccov = typename KmerHashTable<CompressedCoverage_t<U>>::const_iterator(&(cdbg->h_kmers_ccov), slot_start);
+    }
+}
+
 template<typename U, typename G, bool is_const>
 unitigIterator<U, G, is_const>::unitigIterator(const unitigIterator& o) :   i(o.i), v_unitigs_sz(o.v_unitigs_sz), v_kmers_sz(o.v_kmers_sz),
                                                                             it_h_kmers_ccov(o.it_h_kmers_ccov), h_kmers_ccov_sz(o.h_kmers_ccov_sz),
@@ -87,4 +106,153 @@ const UnitigMap<U, G, is_const>& unitigIterator<U, G, is_const>::operator*() con
 template<typename U, typename G, bool is_const>
 const UnitigMap<U, G, is_const>* unitigIterator<U, G, is_const>::operator->() const { return &um; }
 
+template<typename U, typename G, bool is_const>
+unitigRange<U, G, is_const>::unitigRange() : b(0), e(0), cdbg(nullptr) {}
+
+template<typename U, typename G, bool is_const>
+unitigRange<U, G, is_const>::unitigRange(CompactedDBG_ptr_t cdbg_) : b(0), e(0), cdbg(cdbg_) {
+
+    if ((cdbg != nullptr) && !cdbg->invalid){
+
+        const size_t k = cdbg->getK();
+        const size_t v_unitigs_sz = cdbg->v_unitigs.size();
+        const size_t v_kmers_sz = cdbg->km_unitigs.size();
+
+        vector<size_t>* cum = new vector<size_t>(1, 0);
+        vector<size_t>* slots = new vector<size_t>();
+
+        cum->reserve(v_unitigs_sz + v_kmers_sz + cdbg->h_kmers_ccov.size() + 1);
+        slots->reserve(cdbg->h_kmers_ccov.size());
+
+        for (size_t i = 0; i < v_unitigs_sz; ++i) cum->push_back(cum->back() + cdbg->v_unitigs[i]->getSeq().size() - k + 1);
+        for (size_t i = 0; i < v_kmers_sz; ++i) cum->push_back(cum->back() + 1);
+
+        for (typename KmerHashTable<CompressedCoverage_t<U>>::const_iterator it = cdbg->h_kmers_ccov.begin(); it != cdbg->h_kmers_ccov.end(); ++it){
+
+            cum->push_back(cum->back() + 1);
+            slots->push_back(it.getHash());
+        }
+
+        e = cum->size() - 1;
+
+        cum_km = std::shared_ptr<const vector<size_t>>(cum);
+        slots_h = std::shared_ptr<const vector<size_t>>(slots);
+    }
+}
+
+template<typename U, typename G, bool is_const>
+unitigRange<U, G, is_const>::unitigRange(const unitigRange& o) : b(o.b), e(o.e), cum_km(o.cum_km), slots_h(o.slots_h), cdbg(o.cdbg) {}
+
+template<typename U, typename G, bool is_const>
+unitigRange<U, G, is_const>::unitigRange(const unitigRange& o, const size_t start, const size_t end) :  b(start), e(end), cum_km(o.cum_km),
+                                                                                                        slots_h(o.slots_h), cdbg(o.cdbg) {}
+
+template<typename U, typename G, bool is_const>
+bool unitigRange<U, G, is_const>::empty() const { return (b >= e); }
+
+template<typename U, typename G, bool is_const>
+size_t unitigRange<U, G, is_const>::size() const { return (b >= e) ? 0 : e - b; }
+
+template<typename U, typename G, bool is_const>
+size_t unitigRange<U, G, is_const>::nbKmers() const { return (b >= e) ? 0 : (*cum_km)[e] - (*cum_km)[b]; }
+
+template<typename U, typename G, bool is_const>
+bool unitigRange<U, G, is_const>::isDivisible() const { return (size() >= 2); }
+
+template<typename U, typename G, bool is_const>
+unitigRange<U, G, is_const> unitigRange<U, G, is_const>::split() {
+
+    if (!isDivisible()) return unitigRange(*this, e, e);
+
+    const vector<size_t>& cum = *cum_km;
+
+    // Split after the first unitig reaching half of the k-mers of the range
+    const size_t half = cum[b] + (cum[e] - cum[b]) / 2;
+    const size_t mid = min(static_cast<size_t>(lower_bound(cum.begin() + b + 1, cum.begin() + e, half) - cum.begin()), e - 1);
+
+    const unitigRange r(*this, mid, e);
+
+    e = mid;
+
+    return r;
+}
+
+template<typename U, typename G, bool is_const>
+vector<unitigRange<U, G, is_const>> unitigRange<U, G, is_const>::split(const size_t nb_ranges) const {
+
+    vector<unitigRange> v_r;
+
+    if (empty() || (nb_ranges == 0)) return v_r;
+
+    const vector<size_t>& cum = *cum_km;
+
+    const size_t nb_km = nbKmers();
+
+    size_t start = b;
+
+    for (size_t i = 1; (i < nb_ranges) && (start < e); ++i){
+
+        // Split after the first unitig reaching i/nb_ranges of the k-mers of the range
+        const size_t lim = cum[b] + (nb_km * i) / nb_ranges;
+        const size_t end = lower_bound(cum.begin() + start + 1, cum.begin() + e, lim) - cum.begin();
+
+        v_r.push_back(unitigRange(*this, start, end));
+
+        start = end;
+    }
+
+    if (start < e) v_r.push_back(unitigRange(*this, start, e));
+
+    return v_r;
+}
+
+template<typename U, typename G, bool is_const>
+unitigIterator<U, G, is_const> unitigRange<U, G, is_const>::begin() const {
+
+    if (empty() || (cdbg == nullptr) || cdbg->invalid) return unitigIterator<U, G, is_const>();
+
+    const size_t nb_not_abundant = cdbg->v_unitigs.size() + cdbg->km_unitigs.size();
+
+    unitigIterator<U, G, is_const> it(cdbg, b, e, (b < nb_not_abundant) ? 0 : (*slots_h)[b - nb_not_abundant]);
+
+    ++it;
+
+    return it;
+}
+
+template<typename U, typename G, bool is_const>
+unitigIterator<U, G, is_const> unitigRange<U, G, is_const>::end() const { return unitigIterator<U, G, is_const>(); }
+
+template<typename U, typename G, bool is_const>
+template<typename F>
+void unitigRange<U, G, is_const>::parallel_for_each(const size_t nb_threads, F f) const {
+
+    if (empty()) return;
+
+    if (nb_threads <= 1){
+
+        for (const auto& um : *this) f(um);
+
+        return;
+    }
+
+    // More chunks than threads so threads finishing early can take over the remaining chunks
+    const vector<unitigRange> v_r = split(nb_threads * 16);
+
+    std::atomic<size_t> next_r(0);
+
+    auto worker_function = [&](){
+
+        for (size_t i = next_r++; i < v_r.size(); i = next_r++){
+
+            for (const auto& um : v_r[i]) f(um);
+        }
+    };
+
+    vector<thread> workers;
+
+    for (size_t t = 0; t < nb_threads; ++t) workers.emplace_back(worker_function);
+    for (auto& t : workers) t.join();
+}
+
 #endif
@@ -99,6 +99,7 @@ class UnitigMap : public UnitigMapBase {
     template<typename U, typename G, bool C> friend class ForwardCDBG;
     template<typename U, typename G, bool C> friend class unitigIterator;
     template<typename U, typename G, bool C> friend class UnitigMap;
+    template<typename U, typename G, bool C> friend class neighborIterator;
 
     typedef typename std::conditional<is_const, const CompactedDBG<U, G>*, CompactedDBG<U, G>*>::type CompactedDBG_ptr_t;
     typedef typename std::conditional<is_const, const U*, U*>::type Unitig_data_ptr_t;
@@ -67,7 +67,9 @@ string UnitigMap<U, G, is_const>::referenceUnitigToString() const {
 template<typename U, typename G, bool is_const>
 size_t UnitigMap<U, G, is_const>::lcp(const char* s, const size_t pos_s, const size_t pos_um_seq, const bool um_reversed) const {
 
-    if (isEmpty || (pos_s >= strlen(s))) return 0;
+    const size_t len_s = strlen(s);
+
+    if (isEmpty || (pos_s >= len_s)) return 0;
 
     if (isShort || isAbundant){
 
@@ -84,7 +86,7 @@ size_t UnitigMap<U, G, is_const>::lcp(const char* s, const size_t pos_s, const s
 
     if (pos_um_seq >= cdbg->v_unitigs[pos_unitig]->length()) return 0;
 
-    return cdbg->v_unitigs[pos_unitig]->getSeq().jump(s, pos_s, pos_um_seq, um_reversed);
+    return cdbg->v_unitigs[pos_unitig]->getSeq().jump(s, pos_s, pos_um_seq, um_reversed, len_s);
 }
 
 template<typename U, typename G, bool is_const>
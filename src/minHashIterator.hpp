@@ -9,6 +9,10 @@
 
 #include "Kmer.hpp"
 
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
 using namespace std;
 
 struct minHashResult {
@@ -583,10 +587,10 @@ struct minHashKmer {
 
     public:
 
-        minHashKmer(const char* _s, const int _k, const int _g, const HF _h, const bool neighbor_hash) :
-                    s(_s), k(_k), g(_g), hf(_h), h(0), i(0), p(0), invalid(true), nh(neighbor_hash) {
+        minHashKmer(const Kmer& _km, const int _k, const int _g, const HF _h, const bool neighbor_hash) :
+                    km(_km), k(_k), g(_g), hf(_h), h(0), i(0), p(0), invalid(true), nh(neighbor_hash) {
 
-            if ((s != nullptr) && ((n = strlen(s)) >= k) && (k >= g) && (k <= MAX_KMER_SIZE)){
+            if ((k >= g) && (k <= MAX_KMER_SIZE)){
 
                 invalid = false;
 
@@ -594,7 +598,7 @@ struct minHashKmer {
             }
         }
 
-        minHashKmer() : s(nullptr), n(0), k(0), g(0), hf(HF(0)), h(0), i(0), p(0), invalid(true), nh(false) {}
+        minHashKmer() : k(0), g(0), hf(HF(0)), h(0), i(0), p(0), invalid(true), nh(false) {}
 
         minHashKmer& operator++() {
 
@@ -614,8 +618,7 @@ struct minHashKmer {
 
         minHashKmer& operator=(const minHashKmer &o){
 
-            s = o.s;
-            n = o.n;
+            km = o.km;
             k = o.k;
             g = o.g;
             h = o.h;
@@ -634,7 +637,7 @@ struct minHashKmer {
 
             if (invalid || o.invalid) return (invalid && o.invalid);
 
-            return  (s == o.s) && (n == o.n) && (g == o.g) && (k == o.k) && (nh == o.nh) &&
+            return  (km == o.km) && (g == o.g) && (k == o.k) && (nh == o.nh) &&
                     (p == o.p) && (memcmp(pos, o.pos, p * sizeof(uint16_t)) == 0);
         }
 
@@ -654,8 +657,39 @@ struct minHashKmer {
             compute_min(prev_h);
         }
 
+        // With neighbor hashing, the window of g-mers of a predecessor km.backwardBase(b) (resp. successor
+        // km.forwardBase(b)) is made of the g-mers of km starting at positions 0 to k-g-1 (resp. 2 to k-g) so its
+        // minimizer hash is the same for any base b. It is computed from km without building the neighbor.
+        static uint64_t getBackwardNeighborHash(const Kmer& km, const int k, const int g) {
+
+            return getMinHash(km, g, 0, k - g - 2);
+        }
+
+        static uint64_t getForwardNeighborHash(const Kmer& km, const int k, const int g) {
+
+            return getMinHash(km, g, 2, k - g);
+        }
+
     private:
 
+        // Smallest hash of the g-mers of km starting at positions start to end
+        static uint64_t getMinHash(const Kmer& km, const int g, const int start, const int end) {
+
+            HF hf_g(g);
+
+            hf_g.initCodes([&](const size_t j){ return km.getCode(start + j); });
+
+            uint64_t min_h = hf_g.hash();
+
+            for (int j = start; j < end; ++j) {
+
+                hf_g.updateFWCodes(km.getCode(j), km.getCode(j+g));
+                min_h = min(min_h, hf_g.hash());
+            }
+
+            return min_h;
+        }
+
         void compute_min(){
 
             if (invalid) return;
@@ -663,7 +697,7 @@ struct minHashKmer {
             const int shift = static_cast<int>(nh);
 
             hf.setK(g);
-            hf.init(&s[shift]);
+            hf.initCodes([&](const size_t j){ return km.getCode(shift + j); });
 
             p = 1;
             i = 0;
@@ -672,7 +706,7 @@ struct minHashKmer {
 
             for (int j = shift; j < k-g-shift; ++j) {
 
-                hf.update(s[j], s[j+g]);
+                hf.updateFWCodes(km.getCode(j), km.getCode(j+g));
 
                 const uint64_t h_v = hf.hash();
 
@@ -697,7 +731,7 @@ struct minHashKmer {
             const int shift = static_cast<int>(nh);
 
             hf.setK(g);
-            hf.init(&s[shift]);
+            hf.initCodes([&](const size_t j){ return km.getCode(shift + j); });
 
             i = 0;
             p = 0;
@@ -711,13 +745,13 @@ struct minHashKmer {
 
             for (int j = shift; j < k-g-shift; ++j) {
 
-                hf.update(s[j], s[j+g]);
+                hf.updateFWCodes(km.getCode(j), km.getCode(j+g));
 
                 const uint64_t h_v = hf.hash();
 
                 if (h_v > min_v){
 
-                    if ((p == 0) || (h_v < h) || ((h_v == h) && (Minimizer(s + j + 1).rep() < Minimizer(s + pos[0]).rep()))){
+                    if ((p == 0) || (h_v < h) || ((h_v == h) && (Minimizer(km, j + 1).rep() < Minimizer(km, pos[0]).rep()))){
 
                         h = h_v;
                         p = 1;
@@ -729,10 +763,9 @@ struct minHashKmer {
             invalid = (p == 0);
         }
 
-        const char* s;
+        Kmer km;
         HF hf;
         uint64_t h;
-        int n;
         int k;
         int g;
         int p;
@@ -742,4 +775,138 @@ struct minHashKmer {
         bool nh;
 };
 
+/* Short description:
+ *  - Compute at once the hashes of all k-mers of a sequence and the hashes of their minimizers
+ *  - Gives the same <k-mer hash, position> pairs as a KmerHashIterator (k-mers with a non-ACGT character
+ *    are skipped) and the same minimizer hashes as a minHashIterator moved to each of these positions
+ *  - K-mer hashes are computed by KF::hashes() and g-mer hashes by HF::hashes(). The minimum of each window of g-mer hashes is
+ *    obtained with the van Herk/Gil-Werman algorithm: prefix and suffix minimums over blocks of one window
+ *    length, then one minimum per window which is computed for 4 windows at a time with AVX2
+ * */
+template<class HF, class KF = HF>
+class minHashBatch {
+
+    public:
+
+        minHashBatch(const int _k, const int _g, const bool _nh) : k(_k), g(_g), nh(_nh), nb_km(0), hf_k(KF(_k)), hf_g(HF(_g)) {}
+
+        // Compute the hashes of the k-mers of s (of length n) and the hashes of their minimizers
+        void compute(const char* s, const int n) {
+
+            nb_km = 0;
+
+            if ((n < k) || (k < g)) return;
+
+            km_h.resize(n - k + 1);
+            min_h.resize(n - k + 1);
+            km_pos.resize(n - k + 1);
+
+            gm_h.resize(n - g + 1);
+            pre_min.resize(n - g + 1);
+            suf_min.resize(n - g + 1);
+
+            int run_s = 0;
+
+            while (run_s <= n - k) { // For each run of A, C, G, T characters
+
+                int run_e = run_s;
+
+                while ((run_e < n) && isDNA(s[run_e] & 0xDF)) ++run_e; // mask lowercase bit
+
+                if (run_e - run_s >= k) computeRun(s + run_s, run_s, run_e - run_s);
+
+                run_s = run_e + 1;
+            }
+        }
+
+        // Number of k-mers found by the last call to compute()
+        BFG_INLINE size_t size() const {
+
+            return nb_km;
+        }
+
+        BFG_INLINE const uint64_t* getKmerHashes() const {
+
+            return km_h.data();
+        }
+
+        BFG_INLINE const uint64_t* getMinHashes() const {
+
+            return min_h.data();
+        }
+
+        BFG_INLINE const int* getKmerPositions() const {
+
+            return km_pos.data();
+        }
+
+    private:
+
+        // Compute the hashes of the k-mers of s (of length len >= k, A, C, G, T only) which starts at position pos
+        void computeRun(const char* s, const int pos, const int len) {
+
+            const int shift = static_cast<int>(nh);
+            const int w = k - g + 1 - 2 * shift; // Nb g-mers in the window of a k-mer
+            const int nb_k = len - k + 1;
+            const int nb_g = nb_k + w - 1;
+
+            uint64_t* l_km_h = &km_h[nb_km];
+            uint64_t* l_min_h = &min_h[nb_km];
+            int* l_km_pos = &km_pos[nb_km];
+
+            hf_k.hashes(s, nb_k, l_km_h);
+            hf_g.hashes(s + shift, nb_g, gm_h.data()); // gm_h[i] is the hash of the g-mer at position i + shift
+
+            for (int i = 0; i < nb_k; ++i) l_km_pos[i] = pos + i;
+
+            for (int i = 0; i < nb_g; i += w) {
+
+                const int end = min(i + w, nb_g);
+
+                pre_min[i] = gm_h[i];
+                suf_min[end - 1] = gm_h[end - 1];
+
+                for (int j = i + 1; j < end; ++j) pre_min[j] = min(pre_min[j - 1], gm_h[j]);
+                for (int j = end - 2; j >= i; --j) suf_min[j] = min(suf_min[j + 1], gm_h[j]);
+            }
+
+            // Minimum of window [i, i + w - 1] is min(suf_min[i], pre_min[i + w - 1])
+            const uint64_t* l_suf_min = suf_min.data();
+            const uint64_t* l_pre_min = pre_min.data() + w - 1;
+
+            int i = 0;
+
+            #if defined(__AVX2__)
+            const __m256i sign = _mm256_set1_epi64x(0x8000000000000000ULL);
+
+            for (; i + 4 <= nb_k; i += 4) {
+
+                const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(l_suf_min + i));
+                const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(l_pre_min + i));
+                const __m256i a_gt_b = _mm256_cmpgt_epi64(_mm256_xor_si256(a, sign), _mm256_xor_si256(b, sign)); // Unsigned comparison
+
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(l_min_h + i), _mm256_blendv_epi8(a, b, a_gt_b));
+            }
+            #endif
+
+            for (; i < nb_k; ++i) l_min_h[i] = min(l_suf_min[i], l_pre_min[i]);
+
+            nb_km += nb_k;
+        }
+
+        int k; // Length of k-mers
+        int g; // Length of minimizers
+        bool nh; // If true, minimizer of k-mers km cannot start at position 0 or k-g
+
+        size_t nb_km; // Nb k-mers computed
+
+        KF hf_k; // Rolling hash function of k-mers
+        HF hf_g; // Rolling hash function of g-mers
+
+        vector<uint64_t> km_h, min_h; // Hashes of k-mers and minimizers
+        vector<int> km_pos; // Positions of k-mers in the sequence
+
+        vector<uint64_t> gm_h, pre_min, suf_min; // Hashes of g-mers, prefix and suffix minimums of blocks
+};
+
 #endif // MINHASHITERATOR_H
@@ -0,0 +1,95 @@
+#ifndef BIFROST_NUMA_POLICY_HPP
+#define BIFROST_NUMA_POLICY_HPP
+
+/*
+ * NUMA memory placement without dependency to libnuma (Linux only).
+ *
+ * The large tables of a graph (Blocked Bloom filter, minimizer index, k-mer blocks, color sets) are allocated and first
+ * touched by a single thread, so all their pages end up on the NUMA node of that thread. On a multi-socket machine, the
+ * threads of the other sockets then only probe remote memory and all threads share the memory bandwidth of one node.
+ * Interleaving the pages over all the nodes balances the random probes of the threads over the nodes.
+ */
+
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#if defined(__linux__) || defined(__linux) || defined(linux) || defined(__gnu_linux__)
+#include <unistd.h>
+#include <sys/syscall.h>
+
+#if defined(SYS_set_mempolicy)
+#define BFG_HAS_NUMA_POLICY
+#endif
+#endif
+
+#define BFG_NUMA_MPOL_INTERLEAVE 3
+#define BFG_NUMA_MAX_NODES 1024
+
+/**
+* Get the NUMA nodes of the machine which are online.
+* @param mask is a bit mask of BFG_NUMA_MAX_NODES bits in which bit i is set if node i is online.
+* @return the number of online NUMA nodes, 0 if it could not be determined.
+*/
+static inline size_t getOnlineNodesNUMA(unsigned long (&mask)[BFG_NUMA_MAX_NODES / (8 * sizeof(unsigned long))]) {
+
+    size_t nb_nodes = 0;
+
+    memset(mask, 0, sizeof(mask));
+
+    #if defined(BFG_HAS_NUMA_POLICY)
+    const size_t bits_word = 8 * sizeof(unsigned long);
+
+    char buffer[4096];
+
+    FILE* fp = fopen("/sys/devices/system/node/online", "r"); // List of ranges, such as "0-1,4"
+
+    if (fp == nullptr) return 0;
+
+    const bool has_line = (fgets(buffer, sizeof(buffer), fp) != nullptr);
+
+    fclose(fp);
+
+    if (!has_line) return 0;
+
+    char* s = buffer;
+
+    while ((*s >= '0') && (*s <= '9')) {
+
+        const size_t start = strtoul(s, &s, 10);
+
+        size_t end = start;
+
+        if (*s == '-') end = strtoul(s + 1, &s, 10);
+        if (*s == ',') ++s;
+
+        for (size_t i = start; (i <= end) && (i < BFG_NUMA_MAX_NODES); ++i, ++nb_nodes) mask[i / bits_word] |= 1UL << (i % bits_word);
+    }
+    #endif
+
+    return nb_nodes;
+}
+
+/**
+* Interleave the pages of all the memory allocated from now on by the calling thread and by the threads it creates
+* afterwards over all the online NUMA nodes. It must be called before allocating the tables of a graph and before
+* starting the threads using them. Memory allocated before the call is not moved.
+* @return a boolean indicating if the memory policy was changed. It is not changed if the system has only one NUMA node
+* or does not support memory policies.
+*/
+static inline bool setInterleavedNUMA() {
+
+    #if defined(BFG_HAS_NUMA_POLICY)
+    unsigned long mask[BFG_NUMA_MAX_NODES / (8 * sizeof(unsigned long))];
+
+    if (getOnlineNodesNUMA(mask) <= 1) return false;
+
+    // The kernel reads maxnode - 1 bits from the mask
+    return (syscall(SYS_set_mempolicy, BFG_NUMA_MPOL_INTERLEAVE, mask, static_cast<unsigned long>(BFG_NUMA_MAX_NODES + 1)) == 0);
+    #else
+    return false;
+    #endif
+}
+
+#endif
@@ -1,6 +1,8 @@
 #ifndef BIFROST_RW_SPINLOCK_HPP
 #define BIFROST_RW_SPINLOCK_HPP
 
+#include <cstdlib>
+#include <new>
 #include <thread>
 #include <atomic>
 
@@ -152,6 +154,124 @@ class SpinLockRW {
         const int padding[15];
 };
 
+// Reader-writer spinlock with one reader counter per thread slot, each counter on its own cache line. A reader only touches
+// the counter of its slot and reads the writer flag (shared by all readers as long as no writer comes), so readers do not
+// contend on a single word. A writer sets the writer flag, which holds back new readers, and waits for the counter of
+// every slot to be 0. Lock and unlock of a reader must be done by the same thread.
+class SpinLockRW_Distributed {
+
+    public:
+
+        SpinLockRW_Distributed(const size_t nb_readers = std::thread::hardware_concurrency()) :
+                                mask_slots(rndup(std::max(nb_readers, static_cast<size_t>(1))) - 1), slots(nullptr),
+                                writer(nullptr) {
+
+            // One slot per reader counter plus one for the writer flag. The slots are over-aligned and operator new[]
+            // does not guarantee such alignment before C++17. The lock object itself is not over-aligned, so it can be a
+            // member of objects allocated with new or stored in containers.
+            const int aligned_alloc = posix_memalign(reinterpret_cast<void**>(&slots), alignof(Slot), (mask_slots + 2) * sizeof(Slot));
+
+            if (aligned_alloc != 0){
+
+                cerr << "SpinLockRW_Distributed::SpinLockRW_Distributed(): Aligned memory could not be allocated with error " << aligned_alloc << endl;
+                exit(1);
+            }
+
+            for (size_t i = 0; i <= mask_slots + 1; ++i) new (slots + i) Slot();
+
+            writer = &(slots[mask_slots + 1].count);
+        }
+
+        SpinLockRW_Distributed(const SpinLockRW_Distributed& o) = delete;
+        SpinLockRW_Distributed& operator=(const SpinLockRW_Distributed& o) = delete;
+
+        ~SpinLockRW_Distributed() {
+
+            for (size_t i = 0; i <= mask_slots + 1; ++i) slots[i].~Slot();
+
+            free(slots);
+        }
+
+        BFG_INLINE void acquire_reader() {
+
+            int retry = 0;
+
+            std::atomic<size_t>& readers = slots[getThreadSlot() & mask_slots].count;
+
+            while (true) {
+
+                if (writer->load() == 0) {
+
+                    readers.fetch_add(1);
+
+                    // Writer flag must be read after the counter is incremented: a writer sets its flag before reading counters
+                    if (writer->load() == 0) return;
+
+                    readers.fetch_sub(1);
+                }
+
+                if (++retry > RETRY_THRESHOLD) this_thread::yield();
+            }
+        }
+
+        BFG_INLINE void release_reader() {
+
+            slots[getThreadSlot() & mask_slots].count.fetch_sub(1, std::memory_order_release);
+        }
+
+        BFG_INLINE void acquire_writer() {
+
+            int retry = 0;
+
+            while ((writer->load(std::memory_order_relaxed) != 0) || (writer->exchange(1) != 0)) {
+
+                if (++retry > RETRY_THRESHOLD) this_thread::yield();
+            }
+
+            for (size_t i = 0; i <= mask_slots; ++i) {
+
+                while (slots[i].count.load() != 0) {
+
+                    if (++retry > RETRY_THRESHOLD) this_thread::yield();
+                }
+            }
+        }
+
+        BFG_INLINE void release_writer() {
+
+            writer->store(0, std::memory_order_release);
+        }
+
+        BFG_INLINE void release_writer_acquire_reader() {
+
+            slots[getThreadSlot() & mask_slots].count.fetch_add(1);
+            writer->store(0, std::memory_order_release);
+        }
+
+    private:
+
+        // Number of readers holding the lock through the slot, or 1 if a writer holds the lock for the writer slot
+        struct alignas(64) Slot {
+
+            std::atomic<size_t> count;
+
+            Slot() : count(0) {}
+        };
+
+        // Threads get consecutive ids on their first lock, so threads started together use different slots
+        static BFG_INLINE size_t getThreadSlot() {
+
+            static std::atomic<size_t> next_thread_id(0);
+            static thread_local const size_t thread_id = next_thread_id.fetch_add(1);
+
+            return thread_id;
+        }
+
+        const size_t mask_slots;
+        Slot* slots;
+        std::atomic<size_t>* writer; // Counter of the last slot
+};
+
 class SpinLockRW_MCS {
 
     public: